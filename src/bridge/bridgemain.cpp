@@ -7,15 +7,43 @@
 #include "_global.h"
 #include "bridgemain.h"
 #include <stdio.h>
+#include <atomic>
+#include <memory>
 #include "Utf8Ini.h"
 
 static HINSTANCE hInst;
 static Utf8Ini settings;
+
+/**
+\brief Immutable settings snapshot so readers do not contend on csIni. Writers
+invalidate it under the critical section and the next reader rebuilds it.
+*/
+static std::shared_ptr<const Utf8Ini> settingsSnapshot;
+
 static wchar_t szIniFile[MAX_PATH] = L"";
 static CRITICAL_SECTION csIni;
 static CRITICAL_SECTION csTranslate;
 static bool bDisableGUIUpdate;
 
+static std::shared_ptr<const Utf8Ini> settingsGetSnapshot()
+{
+    auto snapshot = std::atomic_load(&settingsSnapshot);
+    if(!snapshot)
+    {
+        EnterCriticalSection(&csIni);
+        snapshot = std::make_shared<Utf8Ini>(settings);
+        std::atomic_store(&settingsSnapshot, snapshot);
+        LeaveCriticalSection(&csIni);
+    }
+    return snapshot;
+}
+
+static void settingsInvalidateSnapshot()
+{
+    //the caller holds csIni
+    std::atomic_store(&settingsSnapshot, std::shared_ptr<const Utf8Ini>());
+}
+
 #define CHECK_GUI_UPDATE_DISABLED \
     if (bDisableGUIUpdate) \
         return;
@@ -133,12 +161,11 @@ BRIDGE_IMPEXP bool BridgeSettingGet(const char* section, const char* key, char*
 {
     if(!section || !key || !value)
         return false;
-    EnterCriticalSection(&csIni);
-    auto foundValue = settings.GetValue(section, key);
+    auto snapshot = settingsGetSnapshot();
+    auto foundValue = snapshot->GetValue(section, key);
     bool result = foundValue.length() > 0;
     if(result)
         strcpy_s(value, MAX_SETTING_SIZE, foundValue.c_str());
-    LeaveCriticalSection(&csIni);
     return result;
 }
 
@@ -171,6 +198,7 @@ BRIDGE_IMPEXP bool BridgeSettingSet(const char* section, const char* key, const
             success = settings.SetValue(section, key, "");
         else
             success = settings.SetValue(section, key, value);
+        settingsInvalidateSnapshot();
         LeaveCriticalSection(&csIni);
     }
     return success;
@@ -241,6 +269,7 @@ BRIDGE_IMPEXP bool BridgeSettingRead(int* errorLine)
         success = settings.Deserialize(iniData, errline);
         if(errorLine)
             *errorLine = errline;
+        settingsInvalidateSnapshot();
         LeaveCriticalSection(&csIni);
     }
     return success;
@@ -287,6 +316,13 @@ BRIDGE_IMPEXP bool DbgMemRead(duint va, void* dest, duint size)
     return true;
 }
 
+BRIDGE_IMPEXP bool DbgMemReadScatter(MEMREADRANGE* ranges, duint count)
+{
+    if(!ranges || !count)
+        return false;
+    return !!_dbg_sendmessage(DBG_MEMREAD_SCATTER, ranges, (void*)count);
+}
+
 BRIDGE_IMPEXP bool DbgMemWrite(duint va, const void* src, duint size)
 {
 #ifdef _DEBUG
@@ -513,6 +549,15 @@ BRIDGE_IMPEXP bool DbgGetRegDumpEx(REGDUMP* regdump, size_t size)
     return true;
 }
 
+// Fill only the general purpose part of the dump (GP registers, flags,
+// segments, debug registers, last error/status); the x87/SSE/AVX fields are
+// zeroed instead of captured, which skips the extended-state retrieval. Use
+// this when the caller only reads the instruction pointer or GP registers.
+BRIDGE_IMPEXP bool DbgGetRegDumpBasic(REGDUMP* regdump)
+{
+    return !!_dbg_sendmessage(DBG_GETREGDUMP_BASIC, regdump, nullptr);
+}
+
 // FIXME all
 BRIDGE_IMPEXP bool DbgValToString(const char* string, duint value)
 {
@@ -1316,6 +1361,11 @@ BRIDGE_IMPEXP void GuiReferenceSetCellContent(int row, int col, const char* str)
     _gui_sendmessage(GUI_REF_SETCELLCONTENT, &info, 0);
 }
 
+BRIDGE_IMPEXP void GuiReferenceAddRows(const REFROWBATCH* batch)
+{
+    _gui_sendmessage(GUI_REF_ADDROWS, (void*)batch, 0);
+}
+
 BRIDGE_IMPEXP char* GuiReferenceGetCellContent(int row, int col)
 {
     return (char*)_gui_sendmessage(GUI_REF_GETCELLCONTENT, (void*)(duint)row, (void*)(duint)col);
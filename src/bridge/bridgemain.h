@@ -320,6 +320,8 @@ typedef enum
     DBG_MENU_PREPARE,               // param1=int hMenu,                 param2=unused
     DBG_GET_SYMBOL_INFO,            // param1=void* symbol,              param2=SYMBOLINFO* info
     DBG_GET_DEBUG_ENGINE,           // param1=unused,                    param2-unused
+    DBG_MEMREAD_SCATTER,            // param1=MEMREADRANGE* ranges,      param2=duint count
+    DBG_GETREGDUMP_BASIC,           // param1=REGDUMP* regdump,          param2=unused
 } DBGMSG;
 
 typedef enum
@@ -930,10 +932,19 @@ typedef struct SYMBOLPTR_
     const void* symbol;
 } SYMBOLPTR;
 
+typedef struct
+{
+    duint addr;          //base address of the range to read
+    unsigned char* dest; //destination buffer, zeroed on failure
+    duint size;          //amount of bytes to read
+    bool success;        //whether the full range was read
+} MEMREADRANGE;
+
 //Debugger functions
 BRIDGE_IMPEXP const char* DbgInit();
 BRIDGE_IMPEXP void DbgExit();
 BRIDGE_IMPEXP bool DbgMemRead(duint va, void* dest, duint size);
+BRIDGE_IMPEXP bool DbgMemReadScatter(MEMREADRANGE* ranges, duint count);
 BRIDGE_IMPEXP bool DbgMemWrite(duint va, const void* src, duint size);
 BRIDGE_IMPEXP duint DbgMemGetPageSize(duint base);
 BRIDGE_IMPEXP duint DbgMemFindBaseAddr(duint addr, duint* size);
@@ -975,6 +986,7 @@ BRIDGE_IMPEXP bool DbgGetModuleAt(duint addr, char* text);
 BRIDGE_IMPEXP BPXTYPE DbgGetBpxTypeAt(duint addr);
 BRIDGE_IMPEXP duint DbgValFromString(const char* string);
 BRIDGE_IMPEXP bool DbgGetRegDumpEx(REGDUMP* regdump, size_t size);
+BRIDGE_IMPEXP bool DbgGetRegDumpBasic(REGDUMP* regdump);
 BRIDGE_IMPEXP bool DbgValToString(const char* string, duint value);
 BRIDGE_IMPEXP bool DbgMemIsValidReadPtr(duint addr);
 BRIDGE_IMPEXP int DbgGetBpList(BPXTYPE type, BPMAP* list);
@@ -1197,6 +1209,7 @@ typedef enum
     GUI_INVALIDATE_SYMBOL_SOURCE,   // param1=duint base,           param2=unused
     GUI_GET_CURRENT_GRAPH,          // param1=BridgeCFGraphList*,   param2=unused
     GUI_SHOW_REF,                   // param1=unused,               param2=unused
+    GUI_REF_ADDROWS,                // param1=(REFROWBATCH*)batch,  param2=unused
 } GUIMSG;
 
 //GUI Typedefs
@@ -1216,6 +1229,13 @@ typedef struct
     const char* str;
 } CELLINFO;
 
+typedef struct
+{
+    int count;          //number of rows in the batch
+    int cols;           //number of cells per row
+    const char** cells; //utf8 cell contents, row-major (count * cols entries)
+} REFROWBATCH;
+
 typedef struct
 {
     duint start;
@@ -1293,6 +1313,7 @@ BRIDGE_IMPEXP int GuiReferenceSearchGetRowCount();
 BRIDGE_IMPEXP void GuiReferenceDeleteAllColumns();
 BRIDGE_IMPEXP void GuiReferenceInitialize(const char* name);
 BRIDGE_IMPEXP void GuiReferenceSetCellContent(int row, int col, const char* str);
+BRIDGE_IMPEXP void GuiReferenceAddRows(const REFROWBATCH* batch);
 BRIDGE_IMPEXP char* GuiReferenceGetCellContent(int row, int col);
 BRIDGE_IMPEXP char* GuiReferenceSearchGetCellContent(int row, int col);
 BRIDGE_IMPEXP void GuiReferenceReloadData();
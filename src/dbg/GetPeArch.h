@@ -13,6 +13,117 @@ enum class PeArch
     DotnetAnyCpuPrefer32
 };
 
+// Find out which flavor of dotnet we're dealing with. Specifically,
+// "Any CPU" can be compiled with two flavors, "Prefer 32 bit" or not.
+// Without the 32bit preferred flag, the loader will load the .NET
+// environment based on the current platforms bitness (x86 or x64)
+// Class libraries (DLLs) cannot specify the "Prefer 32 bit".
+// https://mega.nz/#!vx5nVILR!jLafWGWhhsC0Qo5fE-3oEIc-uHBcRpraOo8L_KlUeXI
+// Binaries that do not have COMIMAGE_FLAGS_ILONLY appear to be executed
+// in a process that matches their native type.
+// https://github.com/x64dbg/x64dbg/issues/1758
+static PeArch GetPeArchDotnet(bool isFile86, bool isDll, DWORD flags)
+{
+#define test(x) (flags & x) == x
+#define MY_COMIMAGE_FLAGS_32BITPREFERRED 0x00020000
+    if(isFile86) // x86
+    {
+        if(test(COMIMAGE_FLAGS_32BITREQUIRED))
+            return !isDll && test(MY_COMIMAGE_FLAGS_32BITPREFERRED) ? PeArch::DotnetAnyCpuPrefer32 : PeArch::Dotnet86;
+        else if(test(COMIMAGE_FLAGS_ILONLY))
+            return PeArch::DotnetAnyCpu;
+        else
+            return PeArch::Dotnet86;
+    }
+    else // x64
+        return PeArch::Dotnet64;
+#undef MY_COMIMAGE_FLAGS_32BITPREFERRED
+#undef test
+}
+
+// Fast path: almost every PE keeps the DOS header, NT headers and section
+// table in the first page, which decides the architecture with one small read
+// (plus one targeted read for the COM descriptor of .NET files) instead of a
+// SEC_IMAGE mapping of the whole image. Returns false when the headers do not
+// fit the buffer, so the caller falls back to the mapping path.
+static bool GetPeArchQuick(HANDLE hFile, PeArch & result)
+{
+    unsigned char buffer[0x1000];
+    DWORD read = 0;
+    if(!ReadFile(hFile, buffer, sizeof(buffer), &read, nullptr) || read < sizeof(IMAGE_DOS_HEADER))
+        return false;
+    auto pidh = PIMAGE_DOS_HEADER(buffer);
+    if(pidh->e_magic != IMAGE_DOS_SIGNATURE)
+        return true; //not a PE file, no point in mapping it either
+    if(pidh->e_lfanew < 0)
+        return true;
+    auto ntOffset = DWORD(pidh->e_lfanew);
+    if(ntOffset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER) > read)
+        return false;
+    auto pnth = PIMAGE_NT_HEADERS(buffer + ntOffset);
+    if(pnth->Signature != IMAGE_NT_SIGNATURE)
+        return true;
+    auto Machine = pnth->FileHeader.Machine;
+    if(Machine != IMAGE_FILE_MACHINE_I386 && Machine != IMAGE_FILE_MACHINE_AMD64)
+        return true;
+    auto isDll = (pnth->FileHeader.Characteristics & IMAGE_FILE_DLL) == IMAGE_FILE_DLL;
+    auto isFile86 = Machine == IMAGE_FILE_MACHINE_I386;
+
+    // Get the address and size of the COM (.NET) directory.
+    ULONGLONG comAddr = 0, comSize = 0;
+    if(isFile86) // x86
+    {
+        if(pnth->FileHeader.SizeOfOptionalHeader < sizeof(IMAGE_OPTIONAL_HEADER32) || ntOffset + sizeof(IMAGE_NT_HEADERS32) > read)
+            return false;
+        auto pnth32 = PIMAGE_NT_HEADERS32(pnth);
+        comAddr = pnth32->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR].VirtualAddress;
+        comSize = pnth32->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR].Size;
+    }
+    else // x64
+    {
+        if(pnth->FileHeader.SizeOfOptionalHeader < sizeof(IMAGE_OPTIONAL_HEADER64) || ntOffset + sizeof(IMAGE_NT_HEADERS64) > read)
+            return false;
+        auto pnth64 = PIMAGE_NT_HEADERS64(pnth);
+        comAddr = pnth64->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR].VirtualAddress;
+        comSize = pnth64->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR].Size;
+    }
+
+    // The native architecture of the PE file (to still have something to show for if the COM directory is invalid).
+    result = isFile86 ? PeArch::Native86 : PeArch::Native64;
+    if(!comAddr || comSize < sizeof(IMAGE_COR20_HEADER))
+        return true;
+
+    // Convert the COM directory RVA to a file offset with the section table.
+    auto sectionOffset = ntOffset + sizeof(DWORD) + sizeof(IMAGE_FILE_HEADER) + pnth->FileHeader.SizeOfOptionalHeader;
+    auto sectionCount = DWORD(pnth->FileHeader.NumberOfSections);
+    if(sectionOffset + sectionCount * sizeof(IMAGE_SECTION_HEADER) > read)
+        return false;
+    auto sections = PIMAGE_SECTION_HEADER(buffer + sectionOffset);
+    ULONGLONG comOffset = 0;
+    for(DWORD i = 0; i < sectionCount; i++)
+    {
+        ULONGLONG va = sections[i].VirtualAddress;
+        if(comAddr >= va && comAddr - va + comSize <= sections[i].SizeOfRawData)
+        {
+            comOffset = comAddr - va + sections[i].PointerToRawData;
+            break;
+        }
+    }
+    if(!comOffset)
+        return false; //unusual layout, let the loader sort it out
+
+    IMAGE_COR20_HEADER corh;
+    LARGE_INTEGER liOffset;
+    liOffset.QuadPart = LONGLONG(comOffset);
+    if(!SetFilePointerEx(hFile, liOffset, nullptr, FILE_BEGIN))
+        return false;
+    if(!ReadFile(hFile, &corh, sizeof(corh), &read, nullptr) || read != sizeof(corh))
+        return false;
+    if(corh.cb == sizeof(IMAGE_COR20_HEADER))
+        result = GetPeArchDotnet(isFile86, isDll, corh.Flags);
+    return true;
+}
+
 // Thanks to blaquee for the investigative work!
 static PeArch GetPeArch(const wchar_t* szFileName)
 {
@@ -20,6 +131,12 @@ static PeArch GetPeArch(const wchar_t* szFileName)
     auto hFile = CreateFileW(szFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
     if(hFile != INVALID_HANDLE_VALUE)
     {
+        if(GetPeArchQuick(hFile, result))
+        {
+            CloseHandle(hFile);
+            return result;
+        }
+
         // SEC_IMAGE will load the file like the Windows loader would, saving us RVA -> File offset conversion crap.
         auto hMappedFile = CreateFileMappingW(hFile, nullptr, PAGE_READONLY | SEC_IMAGE, 0, 0, nullptr);
         if(hMappedFile)
@@ -62,36 +179,9 @@ static PeArch GetPeArch(const wchar_t* szFileName)
                                 // Check if the file has a (valid) COM (.NET) directory.
                                 if(comAddr && comSize >= sizeof(IMAGE_COR20_HEADER))
                                 {
-                                    // Find out which flavor of dotnet we're dealing with. Specifically,
-                                    // "Any CPU" can be compiled with two flavors, "Prefer 32 bit" or not.
-                                    // Without the 32bit preferred flag, the loader will load the .NET
-                                    // environment based on the current platforms bitness (x86 or x64)
-                                    // Class libraries (DLLs) cannot specify the "Prefer 32 bit".
-                                    // https://mega.nz/#!vx5nVILR!jLafWGWhhsC0Qo5fE-3oEIc-uHBcRpraOo8L_KlUeXI
-                                    // Binaries that do not have COMIMAGE_FLAGS_ILONLY appear to be executed
-                                    // in a process that matches their native type.
-                                    // https://github.com/x64dbg/x64dbg/issues/1758
-
                                     auto pcorh = PIMAGE_COR20_HEADER(ULONG_PTR(fileMap) + comAddr);
                                     if(pcorh->cb == sizeof(IMAGE_COR20_HEADER))
-                                    {
-                                        auto flags = pcorh->Flags;
-#define test(x) (flags & x) == x
-#define MY_COMIMAGE_FLAGS_32BITPREFERRED 0x00020000
-                                        if(isFile86) // x86
-                                        {
-                                            if(test(COMIMAGE_FLAGS_32BITREQUIRED))
-                                                result = !isDll && test(MY_COMIMAGE_FLAGS_32BITPREFERRED) ? PeArch::DotnetAnyCpuPrefer32 : PeArch::Dotnet86;
-                                            else if(test(COMIMAGE_FLAGS_ILONLY))
-                                                result = PeArch::DotnetAnyCpu;
-                                            else
-                                                result = PeArch::Dotnet86;
-                                        }
-                                        else // x64
-                                            result = PeArch::Dotnet64;
-#undef MY_COMIMAGE_FLAGS_32BITPREFERRED
-#undef test
-                                    }
+                                        result = GetPeArchDotnet(isFile86, isDll, pcorh->Flags);
                                 }
                             }
                         }
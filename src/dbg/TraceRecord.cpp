@@ -13,21 +13,118 @@
 
 TraceRecordManager TraceRecord;
 
+// Shared zero block served for reads of storage that was never written,
+// sized for the largest chunk (word pages: 8192 / PageChunkCount bytes)
+static const unsigned char traceRecordZeroChunk[4096 * 2 / TraceRecordManager::PageChunkCount] = { 0 };
+
+duint TraceRecordManager::getPageStorageSize(TraceRecordType type)
+{
+    switch(type)
+    {
+    case TraceRecordType::TraceRecordBitExec:
+        return 4096 / 8;
+    case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
+        return 4096;
+    case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
+        return 4096 * 2;
+    default:
+        return 0;
+    }
+}
+
+unsigned char* TraceRecordManager::getPageStorage(TraceRecordPage & pageInfo, duint storageOffset, bool write)
+{
+    if(pageInfo.rawPtr) //hot tier: flat array
+        return (unsigned char*)pageInfo.rawPtr + storageOffset;
+
+    auto storageSize = getPageStorageSize(pageInfo.dataType);
+    auto chunkSize = storageSize / PageChunkCount;
+    auto chunkIndex = storageOffset / chunkSize;
+    auto chunkOffset = storageOffset % chunkSize;
+
+    if(!pageInfo.chunks[chunkIndex])
+    {
+        // Untouched storage reads as zero without allocating anything. The
+        // zero block is never written through (write == false paths only).
+        if(!write)
+            return const_cast<unsigned char*>(traceRecordZeroChunk) + chunkOffset;
+
+        pageInfo.chunks[chunkIndex] = emalloc(chunkSize, "TraceRecordManager");
+        memset(pageInfo.chunks[chunkIndex], 0, chunkSize);
+        pageInfo.allocatedChunks++;
+
+        // Hot page: collapse into a flat array so further hits skip the chunk translation
+        if(pageInfo.allocatedChunks >= PageChunkCount * 3 / 4)
+        {
+            auto flatPtr = emalloc(storageSize, "TraceRecordManager");
+            copyPageStorage(pageInfo, (unsigned char*)flatPtr);
+            for(unsigned int i = 0; i < PageChunkCount; i++)
+            {
+                if(pageInfo.chunks[i])
+                    efree(pageInfo.chunks[i], "TraceRecordManager");
+                pageInfo.chunks[i] = nullptr;
+            }
+            pageInfo.allocatedChunks = 0;
+            pageInfo.rawPtr = flatPtr;
+            return (unsigned char*)flatPtr + storageOffset;
+        }
+    }
+    return (unsigned char*)pageInfo.chunks[chunkIndex] + chunkOffset;
+}
+
+void TraceRecordManager::copyPageStorage(const TraceRecordPage & pageInfo, unsigned char* buffer)
+{
+    auto storageSize = getPageStorageSize(pageInfo.dataType);
+    if(pageInfo.rawPtr)
+    {
+        memcpy(buffer, pageInfo.rawPtr, storageSize);
+        return;
+    }
+    auto chunkSize = storageSize / PageChunkCount;
+    for(unsigned int i = 0; i < PageChunkCount; i++)
+    {
+        if(pageInfo.chunks[i])
+            memcpy(buffer + i * chunkSize, pageInfo.chunks[i], chunkSize);
+        else
+            memset(buffer + i * chunkSize, 0, chunkSize);
+    }
+}
+
+void TraceRecordManager::freePageStorage(TraceRecordPage & pageInfo)
+{
+    if(pageInfo.rawPtr)
+    {
+        efree(pageInfo.rawPtr, "TraceRecordManager");
+        pageInfo.rawPtr = nullptr;
+    }
+    for(unsigned int i = 0; i < PageChunkCount; i++)
+    {
+        if(pageInfo.chunks[i])
+        {
+            efree(pageInfo.chunks[i], "TraceRecordManager");
+            pageInfo.chunks[i] = nullptr;
+        }
+    }
+    pageInfo.allocatedChunks = 0;
+}
+
 TraceRecordManager::TraceRecordManager()
 {
     ModuleNames.emplace_back("");
+    InitializeCriticalSection(&rtBlockCs);
 }
 
 TraceRecordManager::~TraceRecordManager()
 {
     clear();
+    DeleteCriticalSection(&rtBlockCs);
 }
 
 void TraceRecordManager::clear()
 {
     EXCLUSIVE_ACQUIRE(LockTraceRecord);
     for(auto i = TraceRecord.begin(); i != TraceRecord.end(); ++i)
-        efree(i->second.rawPtr, "TraceRecordManager");
+        freePageStorage(i->second);
     TraceRecord.clear();
     ModuleNames.clear();
     ModuleNames.emplace_back("");
@@ -44,23 +141,12 @@ bool TraceRecordManager::setTraceRecordType(duint pageAddress, TraceRecordType t
         {
             TraceRecordPage newPage;
             char modName[MAX_MODULE_SIZE];
-            switch(type)
-            {
-            case TraceRecordBitExec:
-                newPage.rawPtr = emalloc(4096 / 8, "TraceRecordManager");
-                memset(newPage.rawPtr, 0, 4096 / 8);
-                break;
-            case TraceRecordByteWithExecTypeAndCounter:
-                newPage.rawPtr = emalloc(4096, "TraceRecordManager");
-                memset(newPage.rawPtr, 0, 4096);
-                break;
-            case TraceRecordWordWithExecTypeAndCounter:
-                newPage.rawPtr = emalloc(4096 * 2, "TraceRecordManager");
-                memset(newPage.rawPtr, 0, 4096 * 2);
-                break;
-            default:
+            if(!getPageStorageSize(type))
                 return false;
-            }
+            // Nothing is allocated until the page is actually hit
+            newPage.rawPtr = nullptr;
+            memset(newPage.chunks, 0, sizeof(newPage.chunks));
+            newPage.allocatedChunks = 0;
             newPage.dataType = type;
             if(ModNameFromAddr(pageAddress, modName, true))
             {
@@ -72,10 +158,7 @@ bool TraceRecordManager::setTraceRecordType(duint pageAddress, TraceRecordType t
 
             auto inserted = TraceRecord.insert(std::make_pair(ModHashFromAddr(pageAddress), newPage));
             if(inserted.second == false) // we failed to insert new page into the map
-            {
-                efree(newPage.rawPtr);
                 return false;
-            }
             return true;
         }
         else
@@ -87,7 +170,7 @@ bool TraceRecordManager::setTraceRecordType(duint pageAddress, TraceRecordType t
         {
             if(pageInfo != TraceRecord.end())
             {
-                efree(pageInfo->second.rawPtr, "TraceRecordManager");
+                freePageStorage(pageInfo->second);
                 TraceRecord.erase(pageInfo);
             }
             return true;
@@ -117,8 +200,7 @@ void TraceRecordManager::TraceExecute(duint address, duint size)
     auto pageInfoIterator = TraceRecord.find(ModHashFromAddr(base));
     if(pageInfoIterator == TraceRecord.end())
         return;
-    TraceRecordPage pageInfo;
-    pageInfo = pageInfoIterator->second;
+    TraceRecordPage & pageInfo = pageInfoIterator->second;
     duint offset = address - base;
     bool isMixed;
     if((offset + size) > 4096) // execution crossed page boundary, splitting into 2 sub calls. Noting that byte type may be mislabelled.
@@ -133,7 +215,7 @@ void TraceRecordManager::TraceExecute(duint address, duint size)
     {
     case TraceRecordType::TraceRecordBitExec:
         for(unsigned char i = 0; i < size; i++)
-            *((char*)pageInfo.rawPtr + (i + offset) / 8) |= 1 << ((i + offset) % 8);
+            *getPageStorage(pageInfo, (i + offset) / 8, true) |= 1 << ((i + offset) % 8);
         break;
 
     case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
@@ -149,7 +231,7 @@ void TraceRecordManager::TraceExecute(duint address, duint size)
             else
                 currentByteType = TraceRecordByteType_2bit::_InstructionBody;
 
-            char* data = (char*)pageInfo.rawPtr + offset + i;
+            char* data = (char*)getPageStorage(pageInfo, offset + i, true);
             if(*data == 0)
             {
                 *data = (char)currentByteType << 6 | 1;
@@ -162,7 +244,7 @@ void TraceRecordManager::TraceExecute(duint address, duint size)
         }
         if(isMixed)
             for(unsigned char i = 0; i < size; i++)
-                *((char*)pageInfo.rawPtr + i + offset) |= 0xC0;
+                *getPageStorage(pageInfo, i + offset, true) |= 0xC0;
         break;
 
     case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
@@ -178,7 +260,7 @@ void TraceRecordManager::TraceExecute(duint address, duint size)
             else
                 currentByteType = TraceRecordByteType_2bit::_InstructionBody;
 
-            short* data = (short*)pageInfo.rawPtr + offset + i;
+            short* data = (short*)getPageStorage(pageInfo, (offset + i) * 2, true);
             if(*data == 0)
             {
                 *data = (char)currentByteType << 14 | 1;
@@ -191,7 +273,7 @@ void TraceRecordManager::TraceExecute(duint address, duint size)
         }
         if(isMixed)
             for(unsigned char i = 0; i < size; i++)
-                *((short*)pageInfo.rawPtr + i + offset) |= 0xC000;
+                *(short*)getPageStorage(pageInfo, (i + offset) * 2, true) |= 0xC000;
         break;
 
     default:
@@ -322,18 +404,21 @@ void TraceRecordManager::TraceExecuteRecord(const Zydis & newInstruction)
         //Delta compress registers
         //Data layout is Structure of Arrays to gather the same type of data in continuous memory to improve RLE compression performance.
         //1byte:block type,1byte:reg changed count,1byte:memory accessed count,1byte:flags,4byte/none:threadid,string:opcode,1byte[]:position,ptrbyte[]:regvalue,1byte[]:flags,ptrbyte[]:address,ptrbyte[]:oldmem,ptrbyte[]:newmem
+        //ver 3 replaces ptrbyte[]:regvalue with 4bit[]:length,byte[]:delta - the significant bytes of value XOR previous written value
 
         //Always record state of LAST INSTRUCTION! (NOT current instruction)
+        //A full register dump resyncs the reader, forced periodically and after an out-of-scope gap
+        //rtRecordedInstructions - 1 hack: always record full registers dump at first instruction (recorded at 2nd instruction execution time)
+        //prints ASCII table in run trace at first instruction :)
+        const bool fullDump = rtNeedFullDump || ((rtRecordedInstructions - 1) % MAX_INSTRUCTIONS_TRACED_FULL_REG_DUMP == 0);
         unsigned char changed = 0;
         for(unsigned char i = 0; i < _countof(rtOldContext.regword); i++)
         {
-            //rtRecordedInstructions - 1 hack: always record full registers dump at first instruction (recorded at 2nd instruction execution time)
-            //prints ASCII table in run trace at first instruction :)
-            if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || ((rtRecordedInstructions - 1) % MAX_INSTRUCTIONS_TRACED_FULL_REG_DUMP == 0))
+            if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || fullDump)
                 changed++;
         }
         unsigned char blockFlags = 0;
-        if(newThreadId != rtOldThreadId || ((rtRecordedInstructions - 1) % MAX_INSTRUCTIONS_TRACED_FULL_REG_DUMP == 0))
+        if(newThreadId != rtOldThreadId || fullDump)
             blockFlags = 0x80;
         blockFlags |= rtOldOpcodeSize;
 
@@ -342,7 +427,7 @@ void TraceRecordManager::TraceExecuteRecord(const Zydis & newInstruction)
         WriteBufferPtr[2] = rtOldMemoryArrayCount; //1byte: memory accesses count
         WriteBufferPtr[3] = blockFlags; //1byte: flags and opcode size
         WriteBufferPtr += 4;
-        if(newThreadId != rtOldThreadId || rtNeedThreadId || ((rtRecordedInstructions - 1) % MAX_INSTRUCTIONS_TRACED_FULL_REG_DUMP == 0))
+        if(newThreadId != rtOldThreadId || rtNeedThreadId || fullDump)
         {
             memcpy(WriteBufferPtr, &rtOldThreadId, sizeof(rtOldThreadId));
             WriteBufferPtr += sizeof(rtOldThreadId);
@@ -353,22 +438,50 @@ void TraceRecordManager::TraceExecuteRecord(const Zydis & newInstruction)
         int lastChangedPosition = -1; //-1
         for(int i = 0; i < _countof(rtOldContext.regword); i++) //1byte: position
         {
-            if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || ((rtRecordedInstructions - 1) % MAX_INSTRUCTIONS_TRACED_FULL_REG_DUMP == 0))
+            if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || fullDump)
             {
                 WriteBufferPtr[0] = (unsigned char)(i - lastChangedPosition - 1);
                 WriteBufferPtr++;
                 lastChangedPosition = i;
             }
         }
-        for(unsigned char i = 0; i < _countof(rtOldContext.regword); i++) //ptrbyte: newvalue
+        if(rtXorDelta) //4bit: delta length, byte[]: significant bytes of value XOR previous written value
         {
-            if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || ((rtRecordedInstructions - 1) % MAX_INSTRUCTIONS_TRACED_FULL_REG_DUMP == 0))
+            //Full register dumps are the page boundaries of the GUI reader and
+            //must stay self-contained, so the delta base restarts at zero there
+            if(changed == _countof(rtOldContext.regword))
+                memset(&rtWrittenContext, 0, sizeof(rtWrittenContext));
+            unsigned char* lengthNibbles = WriteBufferPtr;
+            memset(lengthNibbles, 0, (changed + 1) / 2);
+            WriteBufferPtr += (changed + 1) / 2;
+            unsigned char changedIndex = 0;
+            for(unsigned char i = 0; i < _countof(rtOldContext.regword); i++)
             {
-                memcpy(WriteBufferPtr, &rtOldContext.regword[i], sizeof(duint));
-                WriteBufferPtr += sizeof(duint);
+                if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || fullDump)
+                {
+                    duint delta = rtOldContext.regword[i] ^ rtWrittenContext.regword[i];
+                    rtWrittenContext.regword[i] = rtOldContext.regword[i];
+                    unsigned char deltaSize = 0;
+                    for(duint remaining = delta; remaining != 0; remaining >>= 8)
+                        deltaSize++;
+                    lengthNibbles[changedIndex / 2] |= (unsigned char)(deltaSize << ((changedIndex % 2) * 4));
+                    memcpy(WriteBufferPtr, &delta, deltaSize);
+                    WriteBufferPtr += deltaSize;
+                    changedIndex++;
+                }
+                rtOldContextChanged[i] = (rtOldContext.regword[i] != newContext.regword[i]);
             }
-            rtOldContextChanged[i] = (rtOldContext.regword[i] != newContext.regword[i]);
         }
+        else
+            for(unsigned char i = 0; i < _countof(rtOldContext.regword); i++) //ptrbyte: newvalue
+            {
+                if(rtOldContext.regword[i] != newContext.regword[i] || rtOldContextChanged[i] || fullDump)
+                {
+                    memcpy(WriteBufferPtr, &rtOldContext.regword[i], sizeof(duint));
+                    WriteBufferPtr += sizeof(duint);
+                }
+                rtOldContextChanged[i] = (rtOldContext.regword[i] != newContext.regword[i]);
+            }
         for(unsigned char i = 0; i < rtOldMemoryArrayCount; i++) //1byte: flags
         {
             unsigned char memoryOperandFlags = 0;
@@ -396,6 +509,11 @@ void TraceRecordManager::TraceExecuteRecord(const Zydis & newInstruction)
                 WriteBufferPtr += sizeof(duint);
             }
         }
+        //Full register dump records are the page boundaries of the GUI reader,
+        //remember where they start for the footer index
+        if(rtIndexEnabled && changed == _countof(rtOldContext.regword))
+            rtPageIndex.emplace_back(rtIndexBase + rtRecordedInstructions - 1, rtFileOffset);
+        rtNeedFullDump = false;
     }
     //Switch context buffers
     rtOldThreadId = newThreadId;
@@ -411,13 +529,13 @@ void TraceRecordManager::TraceExecuteRecord(const Zydis & newInstruction)
     {
         if(WriteBufferPtr - WriteBuffer <= sizeof(WriteBuffer))
         {
-            DWORD written;
-            WriteFile(rtFile, WriteBuffer, WriteBufferPtr - WriteBuffer, &written, NULL);
-            if(written < DWORD(WriteBufferPtr - WriteBuffer)) //Disk full?
+            rtAppend(WriteBuffer, WriteBufferPtr - WriteBuffer);
+            rtFileOffset += WriteBufferPtr - WriteBuffer;
+            if(rtWriterFailed) //Disk full?
             {
-                CloseHandle(rtFile);
-                String error = stringformatinline(StringUtils::sprintf("{winerror@%d}", GetLastError()));
+                String error = stringformatinline(StringUtils::sprintf("{winerror@%d}", rtWriterError));
                 dprintf(QT_TRANSLATE_NOOP("DBG", "Run trace has stopped unexpectedly because WriteFile() failed. GetLastError() = %s.\r\n"), error.c_str());
+                rtStopWriter();
                 rtEnabled = false;
             }
         }
@@ -439,16 +557,16 @@ unsigned int TraceRecordManager::getHitCount(duint address)
         return 0;
     else
     {
-        TraceRecordPage pageInfo = pageInfoIterator->second;
+        TraceRecordPage & pageInfo = pageInfoIterator->second;
         duint offset = address - base;
         switch(pageInfo.dataType)
         {
         case TraceRecordType::TraceRecordBitExec:
-            return ((char*)pageInfo.rawPtr)[offset / 8] & (1 << (offset % 8)) ? 1 : 0;
+            return *getPageStorage(pageInfo, offset / 8, false) & (1 << (offset % 8)) ? 1 : 0;
         case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
-            return ((char*)pageInfo.rawPtr)[offset] & 0x3F;
+            return *(char*)getPageStorage(pageInfo, offset, false) & 0x3F;
         case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
-            return ((short*)pageInfo.rawPtr)[offset] & 0x3FFF;
+            return *(short*)getPageStorage(pageInfo, offset * 2, false) & 0x3FFF;
         default:
             return 0;
         }
@@ -464,7 +582,7 @@ TraceRecordManager::TraceRecordByteType TraceRecordManager::getByteType(duint ad
         return TraceRecordByteType::InstructionHeading;
     else
     {
-        TraceRecordPage pageInfo = pageInfoIterator->second;
+        TraceRecordPage & pageInfo = pageInfoIterator->second;
         duint offset = address - base;
         switch(pageInfo.dataType)
         {
@@ -472,13 +590,190 @@ TraceRecordManager::TraceRecordByteType TraceRecordManager::getByteType(duint ad
         default:
             return TraceRecordByteType::InstructionHeading;
         case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
-            return (TraceRecordByteType)((((char*)pageInfo.rawPtr)[offset] & 0xC0) >> 6);
+            return (TraceRecordByteType)((*(char*)getPageStorage(pageInfo, offset, false) & 0xC0) >> 6);
         case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
-            return (TraceRecordByteType)((((short*)pageInfo.rawPtr)[offset] & 0xC000) >> 14);
+            return (TraceRecordByteType)((*(short*)getPageStorage(pageInfo, offset * 2, false) & 0xC000) >> 14);
         }
     }
 }
 
+// Fill counts with the hit count of every byte in [address, address + size),
+// with one lock acquisition and one page lookup per page instead of one per byte
+void TraceRecordManager::getHitCounts(duint address, duint size, unsigned int* counts)
+{
+    SHARED_ACQUIRE(LockTraceRecord);
+    duint filled = 0;
+    while(filled < size)
+    {
+        duint base = (address + filled) & ~((duint)4096 - 1);
+        duint offset = address + filled - base;
+        duint count = min(4096 - offset, size - filled);
+        auto pageInfoIterator = TraceRecord.find(ModHashFromAddr(base));
+        if(pageInfoIterator == TraceRecord.end())
+            memset(counts + filled, 0, count * sizeof(unsigned int));
+        else
+        {
+            TraceRecordPage & pageInfo = pageInfoIterator->second;
+            auto storageSize = getPageStorageSize(pageInfo.dataType);
+            auto chunkSize = storageSize / PageChunkCount;
+            // Resolve the storage tier once per contiguous stretch and fill
+            // from the raw pointer, instead of redoing the chunk math and
+            // tier selection for every single byte
+            duint i = 0;
+            while(i < count)
+            {
+                duint span = count - i;
+                switch(pageInfo.dataType)
+                {
+                case TraceRecordType::TraceRecordBitExec:
+                {
+                    duint bit = offset + i;
+                    duint storageOffset = bit / 8;
+                    auto storage = getPageStorage(pageInfo, storageOffset, false);
+                    duint storageLeft = pageInfo.rawPtr ? storageSize - storageOffset : chunkSize - storageOffset % chunkSize;
+                    span = min(span, storageLeft * 8 - bit % 8);
+                    for(duint j = 0; j < span; j++, bit++)
+                        counts[filled + i + j] = storage[bit / 8 - storageOffset] & (1 << (bit % 8)) ? 1 : 0;
+                    break;
+                }
+                case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
+                {
+                    duint storageOffset = offset + i;
+                    auto storage = (const char*)getPageStorage(pageInfo, storageOffset, false);
+                    duint storageLeft = pageInfo.rawPtr ? storageSize - storageOffset : chunkSize - storageOffset % chunkSize;
+                    span = min(span, storageLeft);
+                    for(duint j = 0; j < span; j++)
+                        counts[filled + i + j] = storage[j] & 0x3F;
+                    break;
+                }
+                case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
+                {
+                    duint storageOffset = (offset + i) * 2;
+                    auto storage = (const short*)getPageStorage(pageInfo, storageOffset, false);
+                    duint storageLeft = pageInfo.rawPtr ? storageSize - storageOffset : chunkSize - storageOffset % chunkSize;
+                    span = min(span, storageLeft / 2);
+                    for(duint j = 0; j < span; j++)
+                        counts[filled + i + j] = storage[j] & 0x3FFF;
+                    break;
+                }
+                default:
+                    memset(counts + filled + i, 0, span * sizeof(unsigned int));
+                    break;
+                }
+                i += span;
+            }
+        }
+        filled += count;
+    }
+}
+
+// Export the executed bytes as a DRCOV-compatible coverage file, aggregated
+// per module in one pass over the page map. Pages outside any module and
+// pages of unloaded modules cannot be rebased and are skipped.
+bool TraceRecordManager::saveCoverage(const char* fileName)
+{
+    struct CoverageModule
+    {
+        duint base;
+        duint size;
+        char path[MAX_PATH];
+    };
+#pragma pack(push, 1)
+    struct CoverageBlock //drcov bb_entry_t
+    {
+        unsigned int start; //module-relative offset
+        unsigned short size;
+        unsigned short moduleId;
+    };
+#pragma pack(pop)
+    std::vector<CoverageModule> modules;
+    std::unordered_map<unsigned int, unsigned short> moduleIds; //moduleIndex -> drcov module id
+    std::vector<CoverageBlock> blocks;
+
+    SHARED_ACQUIRE(LockTraceRecord);
+    for(auto & itr : TraceRecord)
+    {
+        TraceRecordPage & pageInfo = itr.second;
+        if(pageInfo.moduleIndex == ~0)
+            continue;
+        unsigned short moduleId;
+        auto found = moduleIds.find(pageInfo.moduleIndex);
+        if(found != moduleIds.end())
+            moduleId = found->second;
+        else
+        {
+            duint base = ModBaseFromName(ModuleNames[pageInfo.moduleIndex].c_str());
+            if(!base) //module not loaded anymore
+                continue;
+            CoverageModule module;
+            module.base = base;
+            module.size = ModSizeFromAddr(base);
+            *module.path = '\0';
+            ModPathFromAddr(base, module.path, MAX_PATH);
+            moduleId = (unsigned short)modules.size();
+            modules.push_back(module);
+            moduleIds.emplace(pageInfo.moduleIndex, moduleId);
+        }
+
+        //aggregate contiguous executed runs in this page into blocks
+        duint runStart = 0;
+        bool inRun = false;
+        for(duint offset = 0; offset < 4096; offset++)
+        {
+            bool hit = false;
+            switch(pageInfo.dataType)
+            {
+            case TraceRecordType::TraceRecordBitExec:
+                hit = (*getPageStorage(pageInfo, offset / 8, false) & (1 << (offset % 8))) != 0;
+                break;
+            case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
+                hit = *getPageStorage(pageInfo, offset, false) != 0;
+                break;
+            case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
+                hit = *(short*)getPageStorage(pageInfo, offset * 2, false) != 0;
+                break;
+            default:
+                break;
+            }
+            if(hit && !inRun)
+            {
+                runStart = offset;
+                inRun = true;
+            }
+            else if(!hit && inRun)
+            {
+                blocks.push_back(CoverageBlock { (unsigned int)(pageInfo.rva + runStart), (unsigned short)(offset - runStart), moduleId });
+                inRun = false;
+            }
+        }
+        if(inRun)
+            blocks.push_back(CoverageBlock { (unsigned int)(pageInfo.rva + runStart), (unsigned short)(4096 - runStart), moduleId });
+    }
+    SHARED_RELEASE();
+
+    auto hFile = CreateFileW(StringUtils::Utf8ToUtf16(fileName).c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return false;
+    String header = "DRCOV VERSION: 2\nDRCOV FLAVOR: x64dbg\n";
+    header += StringUtils::sprintf("Module Table: version 2, count %u\n", (unsigned int)modules.size());
+    header += "Columns: id, base, end, entry, checksum, timestamp, path\n";
+    for(size_t i = 0; i < modules.size(); i++)
+        header += StringUtils::sprintf("%u, 0x%llx, 0x%llx, 0x0, 0x0, 0x0, %s\n",
+                                       (unsigned int)i,
+                                       (unsigned long long)modules[i].base,
+                                       (unsigned long long)(modules[i].base + modules[i].size),
+                                       modules[i].path);
+    header += StringUtils::sprintf("BB Table: %u bbs\n", (unsigned int)blocks.size());
+    DWORD written;
+    bool success = !!WriteFile(hFile, header.c_str(), (DWORD)header.size(), &written, nullptr);
+    if(success && !blocks.empty())
+        success = !!WriteFile(hFile, blocks.data(), (DWORD)(blocks.size() * sizeof(CoverageBlock)), &written, nullptr);
+    CloseHandle(hFile);
+    if(success)
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Coverage written: %u blocks in %u modules to %s\n"), (unsigned int)blocks.size(), (unsigned int)modules.size(), fileName);
+    return success;
+}
+
 void TraceRecordManager::increaseInstructionCounter()
 {
     InterlockedIncrement((volatile long*)&instructionCounter);
@@ -492,7 +787,7 @@ bool TraceRecordManager::enableRunTrace(bool enabled, const char* fileName)
             enableRunTrace(false, NULL); //re-enable run trace
         if(!DbgIsDebugging())
             return false;
-        rtFile = CreateFileW(StringUtils::Utf8ToUtf16(fileName).c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        rtFile = CreateFileW(StringUtils::Utf8ToUtf16(fileName).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
         if(rtFile != INVALID_HANDLE_VALUE)
         {
             LARGE_INTEGER size;
@@ -500,13 +795,21 @@ bool TraceRecordManager::enableRunTrace(bool enabled, const char* fileName)
             {
                 if(size.QuadPart != 0)
                 {
-                    SetFilePointer(rtFile, 0, 0, FILE_END);
+                    //Resuming an existing trace: the register encoding must match
+                    //the records already in the file
+                    rtXorDelta = rtReadFileVersion() >= 3;
+                    //Reuse and drop its footer index if present, new records are
+                    //appended in its place. Without a footer the GUI falls back to
+                    //walking the whole file.
+                    rtIndexEnabled = rtLoadIndexFooter(size.QuadPart);
+                    if(!rtIndexEnabled)
+                        SetFilePointer(rtFile, 0, 0, FILE_END);
                 }
                 else //file is empty, write some file header
                 {
                     //TRAC, SIZE, JSON header
                     json_t* root = json_object();
-                    json_object_set_new(root, "ver", json_integer(1));
+                    json_object_set_new(root, "ver", json_integer(3)); //ver 2: footer page index, ver 3: XOR register deltas
                     json_object_set_new(root, "arch", json_string(ArchValue("x86", "x64")));
                     json_object_set_new(root, "hashAlgorithm", json_string("murmurhash"));
                     json_object_set_new(root, "hash", json_hex(dbgfunctionsget()->DbGetHash()));
@@ -539,8 +842,14 @@ bool TraceRecordManager::enableRunTrace(bool enabled, const char* fileName)
                         dputs(QT_TRANSLATE_NOOP("DBG", "Run trace failed to start because file header cannot be written."));
                         return false;
                     }
+                    rtPageIndex.clear();
+                    rtIndexBase = 0;
+                    rtFileOffset = 8 + headerinfosize;
+                    rtIndexEnabled = true;
+                    rtXorDelta = true;
                 }
             }
+            rtStartWriter();
             rtPrevInstAvailable = false;
             rtEnabled = true;
             rtRecordedInstructions = 0;
@@ -570,7 +879,7 @@ bool TraceRecordManager::enableRunTrace(bool enabled, const char* fileName)
     {
         if(rtEnabled)
         {
-            CloseHandle(rtFile);
+            rtStopWriter();
             rtPrevInstAvailable = false;
             rtEnabled = false;
             dputs(QT_TRANSLATE_NOOP("DBG", "Run trace stopped."));
@@ -579,6 +888,231 @@ bool TraceRecordManager::enableRunTrace(bool enabled, const char* fileName)
     }
 }
 
+// Append one record to the block the debug thread is currently filling. When
+// the record does not fit anymore the block is handed over to the writer
+// thread and the next one in the ring is started.
+void TraceRecordManager::rtAppend(const unsigned char* data, duint size)
+{
+    EnterCriticalSection(&rtBlockCs);
+    auto block = &rtBlocks[rtBlockHead % rtBlockCount];
+    if(block->used + size > rtBlockSize)
+    {
+        rtPublishBlockLocked();
+        block = &rtBlocks[rtBlockHead % rtBlockCount];
+    }
+    memcpy(block->data + block->used, data, size);
+    block->used += DWORD(size);
+    LeaveCriticalSection(&rtBlockCs);
+}
+
+void TraceRecordManager::rtPublishBlockLocked()
+{
+    //Backpressure: only stall the debug thread when every block in the ring awaits flushing
+    while(rtBlockHead - rtBlockTail >= rtBlockCount - 1 && !rtWriterFailed)
+    {
+        LeaveCriticalSection(&rtBlockCs);
+        WaitForSingleObject(rtSpaceAvailable, 100);
+        EnterCriticalSection(&rtBlockCs);
+    }
+    rtBlockHead++;
+    rtBlocks[rtBlockHead % rtBlockCount].used = 0;
+    SetEvent(rtBlockReady);
+}
+
+void TraceRecordManager::rtStartWriter()
+{
+    rtBlocks = new RunTraceBlock[rtBlockCount];
+    for(LONG i = 0; i < rtBlockCount; i++)
+        rtBlocks[i].used = 0;
+    rtBlockHead = 0;
+    rtBlockTail = 0;
+    rtWriterFailed = false;
+    rtWriterError = 0;
+    rtBlockReady = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    rtSpaceAvailable = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    rtWriterStop = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    rtWriterThread = CreateThread(nullptr, 0, rtWriterThreadProc, this, 0, nullptr);
+}
+
+void TraceRecordManager::rtStopWriter()
+{
+    SetEvent(rtWriterStop);
+    WaitForSingleObject(rtWriterThread, INFINITE);
+    CloseHandle(rtWriterThread);
+    CloseHandle(rtWriterStop);
+    CloseHandle(rtSpaceAvailable);
+    CloseHandle(rtBlockReady);
+    rtWriterThread = rtWriterStop = rtSpaceAvailable = rtBlockReady = nullptr;
+    delete[] rtBlocks;
+    rtBlocks = nullptr;
+    rtWriteIndexFooter();
+    CloseHandle(rtFile);
+}
+
+// Read the footer page index of an existing trace file and truncate it off,
+// so new records are appended in its place and the footer is rewritten when
+// the trace is stopped. Returns false when the file has no (valid) footer.
+// Read the format version from the JSON header of an existing trace file,
+// 0 when the header cannot be parsed
+unsigned int TraceRecordManager::rtReadFileVersion()
+{
+    unsigned int version = 0;
+    LARGE_INTEGER pos;
+    pos.QuadPart = 0;
+    if(!SetFilePointerEx(rtFile, pos, nullptr, FILE_BEGIN))
+        return 0;
+    DWORD header[2]; //TRAC, SIZE
+    DWORD read = 0;
+    if(ReadFile(rtFile, header, 8, &read, nullptr) && read == 8 && header[0] == MAKEFOURCC('T', 'R', 'A', 'C') && header[1] <= 16384)
+    {
+        std::vector<char> headerinfo(header[1] + 1, 0);
+        if(ReadFile(rtFile, headerinfo.data(), header[1], &read, nullptr) && read == header[1])
+        {
+            auto root = json_loads(headerinfo.data(), 0, nullptr);
+            if(root)
+            {
+                version = (unsigned int)json_integer_value(json_object_get(root, "ver"));
+                json_decref(root);
+            }
+        }
+    }
+    return version;
+}
+
+bool TraceRecordManager::rtLoadIndexFooter(unsigned long long fileSize)
+{
+    rtPageIndex.clear();
+    rtIndexBase = 0;
+    if(fileSize < 8 + 1 + 16 + 12) //header, empty footer, trailer
+        return false;
+    LARGE_INTEGER pos;
+    pos.QuadPart = fileSize - 12;
+    if(!SetFilePointerEx(rtFile, pos, nullptr, FILE_BEGIN))
+        return false;
+    unsigned long long footerStart;
+    DWORD magic = 0;
+    DWORD read = 0;
+    if(!ReadFile(rtFile, &footerStart, 8, &read, nullptr) || read != 8)
+        return false;
+    if(!ReadFile(rtFile, &magic, 4, &read, nullptr) || read != 4)
+        return false;
+    if(magic != MAKEFOURCC('I', 'D', 'X', '1') || footerStart >= fileSize - 12)
+        return false;
+    pos.QuadPart = footerStart;
+    if(!SetFilePointerEx(rtFile, pos, nullptr, FILE_BEGIN))
+        return false;
+    unsigned char blockType = 0;
+    unsigned long long count;
+    unsigned long long total;
+    if(!ReadFile(rtFile, &blockType, 1, &read, nullptr) || read != 1 || blockType != 1)
+        return false;
+    if(!ReadFile(rtFile, &count, 8, &read, nullptr) || read != 8)
+        return false;
+    if(!ReadFile(rtFile, &total, 8, &read, nullptr) || read != 8)
+        return false;
+    if(footerStart + 1 + 16 + count * 16 + 12 != fileSize) //truncated or corrupted footer?
+        return false;
+    rtPageIndex.resize(size_t(count));
+    auto indexBytes = DWORD(count * 16);
+    if(count && (!ReadFile(rtFile, rtPageIndex.data(), indexBytes, &read, nullptr) || read != indexBytes))
+    {
+        rtPageIndex.clear();
+        return false;
+    }
+    rtIndexBase = total;
+    rtFileOffset = footerStart;
+    pos.QuadPart = footerStart;
+    SetFilePointerEx(rtFile, pos, nullptr, FILE_BEGIN);
+    SetEndOfFile(rtFile);
+    return true;
+}
+
+// Append the footer page index so the GUI can rebuild its page index without
+// walking every record. Layout: 1byte:block type(1), 8byte:entry count,
+// 8byte:total instructions, 16byte[]:instruction index + file offset per full
+// register dump record, 8byte:footer offset, 4byte:'IDX1'
+void TraceRecordManager::rtWriteIndexFooter()
+{
+    if(!rtIndexEnabled || rtWriterFailed)
+    {
+        rtPageIndex.clear();
+        return;
+    }
+    //The record of the last instruction is never written because it requires the state after it
+    unsigned long long total = rtIndexBase + (rtRecordedInstructions ? rtRecordedInstructions - 1 : 0);
+    unsigned long long count = rtPageIndex.size();
+    unsigned char blockType = 1;
+    DWORD written;
+    WriteFile(rtFile, &blockType, 1, &written, nullptr);
+    WriteFile(rtFile, &count, 8, &written, nullptr);
+    WriteFile(rtFile, &total, 8, &written, nullptr);
+    if(count)
+        WriteFile(rtFile, rtPageIndex.data(), DWORD(count * 16), &written, nullptr);
+    WriteFile(rtFile, &rtFileOffset, 8, &written, nullptr);
+    DWORD magic = MAKEFOURCC('I', 'D', 'X', '1');
+    WriteFile(rtFile, &magic, 4, &written, nullptr);
+    rtPageIndex.clear();
+}
+
+void TraceRecordManager::rtWriterLoop()
+{
+    HANDLE events[2] = { rtBlockReady, rtWriterStop };
+    auto stopping = false;
+    for(;;)
+    {
+        auto wait = WaitForMultipleObjects(_countof(events), events, FALSE, 200);
+        if(wait == WAIT_OBJECT_0 + 1)
+            stopping = true;
+
+        for(;;)
+        {
+            RunTraceBlock* block = nullptr;
+            EnterCriticalSection(&rtBlockCs);
+            if(rtBlockTail == rtBlockHead && (wait == WAIT_TIMEOUT || stopping))
+            {
+                //Nothing published, but records may be sitting in the current block
+                //(e.g. the debuggee is paused): flush the partial block so the file
+                //stays current, without giving up batching while tracing is hot
+                if(rtBlocks[rtBlockHead % rtBlockCount].used > 0)
+                {
+                    rtBlockHead++; //the ring is empty here, no backpressure needed
+                    rtBlocks[rtBlockHead % rtBlockCount].used = 0;
+                }
+                wait = WAIT_OBJECT_0; //only flush one partial block per wakeup
+            }
+            if(rtBlockTail != rtBlockHead)
+                block = &rtBlocks[rtBlockTail % rtBlockCount];
+            LeaveCriticalSection(&rtBlockCs);
+
+            if(!block)
+                break;
+
+            if(!rtWriterFailed && block->used > 0)
+            {
+                DWORD written = 0;
+                if(!WriteFile(rtFile, block->data, block->used, &written, nullptr) || written < block->used) //Disk full?
+                {
+                    //Remember the failure for the debug thread and keep draining
+                    //without writing, so the trace can be torn down cleanly
+                    rtWriterError = GetLastError();
+                    rtWriterFailed = true;
+                }
+            }
+            InterlockedIncrement(&rtBlockTail);
+            SetEvent(rtSpaceAvailable);
+        }
+
+        if(stopping)
+            break;
+    }
+}
+
+DWORD WINAPI TraceRecordManager::rtWriterThreadProc(LPVOID self)
+{
+    ((TraceRecordManager*)self)->rtWriterLoop();
+    return 0;
+}
+
 void TraceRecordManager::saveToDb(JSON root)
 {
     EXCLUSIVE_ACQUIRE(LockTraceRecord);
@@ -598,23 +1132,13 @@ void TraceRecordManager::saveToDb(JSON root)
             json_object_set_new(jsonObj, "rva", json_hex(i.first));
         }
         json_object_set_new(jsonObj, "type", json_hex((duint)i.second.dataType));
-        auto ptr = (unsigned char*)i.second.rawPtr;
-        duint size = 0;
-        switch(i.second.dataType)
-        {
-        case TraceRecordType::TraceRecordBitExec:
-            size = 4096 / 8;
-            break;
-        case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
-            size = 4096;
-            break;
-        case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
-            size = 4096 * 2;
-            break;
-        default:
+        duint size = getPageStorageSize(i.second.dataType);
+        if(!size)
             __debugbreak(); // We have encountered an error condition.
-        }
-        auto hex = StringUtils::ToCompressedHex(ptr, size);
+        // Materialize the tiered storage into a flat buffer for serialization
+        Memory<unsigned char*> flat(size, "TraceRecordManager");
+        copyPageStorage(i.second, flat());
+        auto hex = StringUtils::ToCompressedHex(flat(), size);
         json_object_set_new(jsonObj, "data", json_string(hex.c_str()));
         json_array_append_new(jsonTraceRecords, jsonObj);
     }
@@ -640,24 +1164,11 @@ void TraceRecordManager::loadFromDb(JSON root)
     json_array_foreach(tracerecord, i, value)
     {
         TraceRecordPage currentPage;
-        size_t size;
         currentPage.dataType = (TraceRecordType)json_hex_value(json_object_get(value, "type"));
         currentPage.rva = (duint)json_hex_value(json_object_get(value, "rva"));
-        switch(currentPage.dataType)
-        {
-        case TraceRecordType::TraceRecordBitExec:
-            size = 4096 / 8;
-            break;
-        case TraceRecordType::TraceRecordByteWithExecTypeAndCounter:
-            size = 4096;
-            break;
-        case TraceRecordType::TraceRecordWordWithExecTypeAndCounter:
-            size = 4096 * 2;
-            break;
-        default:
-            size = 0;
-            break;
-        }
+        memset(currentPage.chunks, 0, sizeof(currentPage.chunks));
+        currentPage.allocatedChunks = 0;
+        size_t size = getPageStorageSize(currentPage.dataType);
         if(size != 0)
         {
             currentPage.rawPtr = emalloc(size, "TraceRecordManager");
@@ -703,11 +1214,106 @@ bool TraceRecordManager::isRunTraceEnabled()
     return rtEnabled;
 }
 
+bool TraceRecordManager::isInScope(duint address)
+{
+    if(!scopeActive)
+        return true;
+    SHARED_ACQUIRE(LockTraceRecord);
+    bool marked = false;
+    auto region = scopeBitmap.find(address & ~(ScopeRegionSize - 1));
+    if(region != scopeBitmap.end())
+    {
+        duint page = (address & (ScopeRegionSize - 1)) >> 12;
+        marked = (region->second.pageBits[page / 8] & (1 << (page % 8))) != 0;
+    }
+    return scopeDefaultIn ? !marked : marked;
+}
+
+void TraceRecordManager::scopeMarkRange(duint start, duint size, bool set)
+{
+    for(duint page = start & ~((duint)4096 - 1); page < start + size; page += 4096)
+    {
+        auto & region = scopeBitmap[page & ~(ScopeRegionSize - 1)];
+        duint index = (page & (ScopeRegionSize - 1)) >> 12;
+        if(set)
+            region.pageBits[index / 8] |= 1 << (index % 8);
+        else
+            region.pageBits[index / 8] &= ~(1 << (index % 8));
+    }
+}
+
+void TraceRecordManager::scopeRebuild()
+{
+    scopeBitmap.clear();
+    scopeDefaultIn = scopeIncludes.empty();
+    if(scopeDefaultIn) //everything is in scope, excludes mark pages out
+    {
+        for(const auto & range : scopeExcludes)
+            scopeMarkRange(range.first, range.second, true);
+    }
+    else //includes mark pages in, excludes carve holes back out
+    {
+        for(const auto & range : scopeIncludes)
+            scopeMarkRange(range.first, range.second, true);
+        for(const auto & range : scopeExcludes)
+            scopeMarkRange(range.first, range.second, false);
+    }
+    scopeActive = !scopeIncludes.empty() || !scopeExcludes.empty();
+}
+
+bool TraceRecordManager::scopeAddRange(duint start, duint size, bool exclude)
+{
+    if(!size || start + size < start)
+        return false;
+    EXCLUSIVE_ACQUIRE(LockTraceRecord);
+    auto & ranges = exclude ? scopeExcludes : scopeIncludes;
+    ranges.emplace_back(start, size);
+    scopeRebuild();
+    return true;
+}
+
+void TraceRecordManager::scopeClear()
+{
+    EXCLUSIVE_ACQUIRE(LockTraceRecord);
+    scopeIncludes.clear();
+    scopeExcludes.clear();
+    scopeBitmap.clear();
+    scopeDefaultIn = true;
+    scopeActive = false;
+}
+
+void TraceRecordManager::scopeGet(std::vector<std::pair<duint, duint>> & includes, std::vector<std::pair<duint, duint>> & excludes)
+{
+    SHARED_ACQUIRE(LockTraceRecord);
+    includes = scopeIncludes;
+    excludes = scopeExcludes;
+}
+
+//Called for instructions outside the recording scope: nothing is recorded
+//(the pending record of the last in-scope instruction is dropped) and the
+//next in-scope record is written as a full register dump so the reader
+//resynchronizes after the gap
+void TraceRecordManager::TraceExecuteRecordBreak()
+{
+    if(!rtEnabled || !rtPrevInstAvailable)
+        return;
+    rtPrevInstAvailable = false;
+    rtNeedFullDump = true;
+}
+
 void _dbg_dbgtraceexecute(duint CIP)
 {
+    if(!TraceRecord.isInScope(CIP))
+    {
+        //out-of-scope instructions are counted but never recorded, and the
+        //run trace register capture pauses until execution re-enters scope
+        TraceRecord.TraceExecuteRecordBreak();
+        TraceRecord.increaseInstructionCounter();
+        return;
+    }
     if(TraceRecord.getTraceRecordType(CIP) != TraceRecordManager::TraceRecordType::TraceRecordNone)
     {
-        Zydis instruction;
+        auto & instruction = Zydis::ThreadLocal();
         unsigned char data[MAX_DISASM_BUFFER];
         if(MemRead(CIP, data, MAX_DISASM_BUFFER))
         {
@@ -727,7 +1333,7 @@ void _dbg_dbgtraceexecute(duint CIP)
     {
         if(TraceRecord.isRunTraceEnabled())
         {
-            Zydis instruction;
+            auto & instruction = Zydis::ThreadLocal();
             unsigned char data[MAX_DISASM_BUFFER];
             if(MemRead(CIP, data, MAX_DISASM_BUFFER))
             {
@@ -744,6 +1350,11 @@ unsigned int _dbg_dbggetTraceRecordHitCount(duint address)
     return TraceRecord.getHitCount(address);
 }
 
+void _dbg_dbggetTraceRecordHitCounts(duint address, duint size, unsigned int* counts)
+{
+    TraceRecord.getHitCounts(address, size, counts);
+}
+
 TRACERECORDBYTETYPE _dbg_dbggetTraceRecordByteType(duint address)
 {
     return (TRACERECORDBYTETYPE)TraceRecord.getByteType(address);
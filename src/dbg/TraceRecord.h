@@ -57,12 +57,23 @@ public:
     void TraceExecuteRecord(const Zydis & newInstruction);
 
     unsigned int getHitCount(duint address);
+    void getHitCounts(duint address, duint size, unsigned int* counts);
+    bool saveCoverage(const char* fileName);
     TraceRecordByteType getByteType(duint address);
     void increaseInstructionCounter();
 
     bool isRunTraceEnabled();
     bool enableRunTrace(bool enabled, const char* fileName);
 
+    //Recording scope: once any include/exclude range is set, instructions on
+    //pages outside the scope skip all recording work, trace record pages and
+    //run trace register capture alike
+    bool isInScope(duint address);
+    bool scopeAddRange(duint start, duint size, bool exclude);
+    void scopeClear();
+    void scopeGet(std::vector<std::pair<duint, duint>> & includes, std::vector<std::pair<duint, duint>> & excludes);
+    void TraceExecuteRecordBreak();
+
     void saveToDb(JSON root);
     void loadFromDb(JSON root);
 private:
@@ -74,9 +85,17 @@ private:
         _InstructionOverlapped = 3
     };
 
+    // Storage for a trace record page is tiered: untouched pages own no memory
+    // at all (reads are served from a shared zero block), sparsely-hit pages
+    // allocate 1/16th-page chunks on first write, and pages with most chunks
+    // live are collapsed into a flat array (also used for pages loaded from db)
+    static const unsigned int PageChunkCount = 16;
+
     struct TraceRecordPage
     {
-        void* rawPtr;
+        void* rawPtr; //flat storage (hot tier), nullptr while the page is untouched or sparse
+        void* chunks[PageChunkCount]; //sparse tier, allocated on first touch
+        unsigned char allocatedChunks;
         duint rva;
         TraceRecordType dataType;
         unsigned int moduleIndex;
@@ -90,6 +109,11 @@ private:
         duint regword[(FIELD_OFFSET(REGDUMP, lastError) + sizeof(DWORD)) / sizeof(duint)];
     } REGDUMPWORD;
 
+    static duint getPageStorageSize(TraceRecordType type);
+    static unsigned char* getPageStorage(TraceRecordPage & pageInfo, duint storageOffset, bool write);
+    static void copyPageStorage(const TraceRecordPage & pageInfo, unsigned char* buffer);
+    static void freePageStorage(TraceRecordPage & pageInfo);
+
     //Key := page base, value := trace record raw data
     std::unordered_map<duint, TraceRecordPage> TraceRecord;
     std::vector<std::string> ModuleNames;
@@ -98,9 +122,73 @@ private:
 
     bool rtEnabled = false;
     bool rtPrevInstAvailable = false;
+    bool rtNeedFullDump = false; //write the next record as a full register dump, resyncing the reader after an out-of-scope gap
     HANDLE rtFile = nullptr;
 
+    //Two-level scope filter: level one hashes the 2MB region, level two is a
+    //bit per 4KB page. A set bit means the page verdict differs from the
+    //default (everything is in scope until the first include range is added).
+    static const duint ScopeRegionSize = 0x200000;
+    struct ScopeRegion
+    {
+        unsigned char pageBits[ScopeRegionSize / 4096 / 8] {};
+    };
+    std::unordered_map<duint, ScopeRegion> scopeBitmap;
+    std::vector<std::pair<duint, duint>> scopeIncludes; //start, size
+    std::vector<std::pair<duint, duint>> scopeExcludes;
+    bool scopeDefaultIn = true;
+    volatile bool scopeActive = false; //checked locklessly on the trace hot path
+
+    void scopeRebuild(); //rebuild the bitmap from the range lists, caller holds the exclusive lock
+    void scopeMarkRange(duint start, duint size, bool set);
+
+    //Asynchronous run trace writer: the debug thread appends records to a
+    //ring of fixed-size blocks and a background thread does the large
+    //sequential WriteFile calls, so tracing no longer waits for the disk
+    //on every instruction. The debug thread only blocks when the whole
+    //ring awaits flushing.
+    static const DWORD rtBlockSize = 0x10000;
+    static const LONG rtBlockCount = 16;
+
+    struct RunTraceBlock
+    {
+        DWORD used;
+        unsigned char data[rtBlockSize];
+    };
+
+    RunTraceBlock* rtBlocks = nullptr; //ring, only allocated while run trace is enabled
+    volatile LONG rtBlockHead = 0; //block the debug thread fills, blocks [tail, head) await flushing
+    volatile LONG rtBlockTail = 0; //next block the writer thread flushes
+    CRITICAL_SECTION rtBlockCs;
+    HANDLE rtBlockReady = nullptr; //signalled when a block is published
+    HANDLE rtSpaceAvailable = nullptr; //signalled when a block was flushed
+    HANDLE rtWriterStop = nullptr; //signalled to drain and exit
+    HANDLE rtWriterThread = nullptr;
+    volatile bool rtWriterFailed = false;
+    DWORD rtWriterError = 0;
+
+    void rtAppend(const unsigned char* data, duint size);
+    void rtPublishBlockLocked();
+    void rtStartWriter();
+    void rtStopWriter();
+    void rtWriterLoop();
+    static DWORD WINAPI rtWriterThreadProc(LPVOID self);
+
+    //Footer page index (ver 2 traces): remembers where every full register
+    //dump record starts so the GUI can rebuild its page index without
+    //walking the whole file on open
+    std::vector<std::pair<unsigned long long, unsigned long long>> rtPageIndex; //instruction index -> file offset
+    unsigned long long rtFileOffset = 0; //file offset of the next record
+    unsigned long long rtIndexBase = 0; //instructions already in the file when resuming a trace
+    bool rtIndexEnabled = false;
+
+    bool rtLoadIndexFooter(unsigned long long fileSize);
+    void rtWriteIndexFooter();
+    unsigned int rtReadFileVersion();
+
     REGDUMPWORD rtOldContext;
+    REGDUMPWORD rtWrittenContext; //register values as last written to the file, the XOR delta base (ver 3)
+    bool rtXorDelta = false; //ver 3 file: register values are stored as truncated XOR deltas
     bool rtOldContextChanged[(FIELD_OFFSET(REGDUMP, lastError) + sizeof(DWORD)) / sizeof(duint)];
     DWORD rtOldThreadId;
     bool rtNeedThreadId;
@@ -117,6 +205,7 @@ void _dbg_dbgtraceexecute(duint CIP);
 
 //exported to bridge
 unsigned int _dbg_dbggetTraceRecordHitCount(duint address);
+void _dbg_dbggetTraceRecordHitCounts(duint address, duint size, unsigned int* counts);
 TRACERECORDBYTETYPE _dbg_dbggetTraceRecordByteType(duint address);
 bool _dbg_dbgsetTraceRecordType(duint pageAddress, TRACERECORDTYPE type);
 TRACERECORDTYPE _dbg_dbggetTraceRecordType(duint pageAddress);
@@ -22,7 +22,8 @@ downslib_error downslib_download(const char* url,
                                  const char* useragent,
                                  unsigned int timeout,
                                  downslib_cb cb,
-                                 void* userdata)
+                                 void* userdata,
+                                 bool resume)
 {
     HINTERNET hInternet = nullptr;
     HINTERNET hUrl = nullptr;
@@ -35,9 +36,15 @@ downslib_error downslib_download(const char* url,
         {
             bool doDelete = false;
             LARGE_INTEGER fileSize;
-            if(dwLastError != ERROR_SUCCESS || (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart == 0))
+            if(GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart == 0)
             {
-                // an error occurred and now there is an empty or incomplete file that didn't exist before we came in
+                // there is an empty file that didn't exist before we came in
+                doDelete = true;
+            }
+            else if(dwLastError != ERROR_SUCCESS && !resume)
+            {
+                // an error occurred and now there is an incomplete file that
+                // cannot be continued later
                 doDelete = true;
             }
             CloseHandle(hFile);
@@ -51,10 +58,19 @@ downslib_error downslib_download(const char* url,
         SetLastError(dwLastError);
     });
 
-    hFile = CreateFileW(filename, GENERIC_WRITE | FILE_READ_ATTRIBUTES, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    hFile = CreateFileW(filename, GENERIC_WRITE | FILE_READ_ATTRIBUTES, 0, NULL, resume ? OPEN_ALWAYS : CREATE_ALWAYS, 0, NULL);
     if(hFile == INVALID_HANDLE_VALUE)
         return downslib_error::createfile;
 
+    // When resuming, continue the transfer after what is already on disk
+    unsigned long long existing_bytes = 0;
+    if(resume)
+    {
+        LARGE_INTEGER fileSize;
+        if(GetFileSizeEx(hFile, &fileSize))
+            existing_bytes = fileSize.QuadPart;
+    }
+
     hInternet = InternetOpenA(useragent,
                               INTERNET_OPEN_TYPE_PRECONFIG,
                               NULL,
@@ -73,7 +89,15 @@ downslib_error downslib_download(const char* url,
     if(strncmp(url, "https://", 8) == 0)
         dwFlags |= INTERNET_FLAG_SECURE;
 
-    hUrl = InternetOpenUrlA(hInternet, url, NULL, 0, dwFlags, 0);
+    char headers[64] = "";
+    DWORD dwHeaders = 0;
+    if(existing_bytes > 0)
+    {
+        sprintf_s(headers, "Range: bytes=%llu-", existing_bytes);
+        dwHeaders = (DWORD)strlen(headers);
+    }
+
+    hUrl = InternetOpenUrlA(hInternet, url, dwHeaders ? headers : NULL, dwHeaders, dwFlags, 0);
     if(!hUrl)
         return downslib_error::openurl;
 
@@ -95,7 +119,31 @@ downslib_error downslib_download(const char* url,
         int status_code = 0;
         if(sscanf_s(buffer, "%d", &status_code) != 1)
             status_code = 500;
-        if(status_code != 200)
+        if(existing_bytes > 0 && status_code == 206)
+        {
+            // The server honored the range request, append to the partial file
+            LARGE_INTEGER offset;
+            offset.QuadPart = existing_bytes;
+            SetFilePointerEx(hFile, offset, nullptr, FILE_BEGIN);
+            if(total_bytes > 0)
+                total_bytes += existing_bytes;
+        }
+        else if(existing_bytes > 0 && status_code == 416)
+        {
+            // Requested range not satisfiable: the partial file already
+            // contains the complete content
+            SetLastError(ERROR_SUCCESS);
+            return downslib_error::ok;
+        }
+        else if(status_code == 200)
+        {
+            // Full content (the server ignored the range request if there
+            // was one), start over from the beginning
+            existing_bytes = 0;
+            SetFilePointer(hFile, 0, nullptr, FILE_BEGIN);
+            SetEndOfFile(hFile);
+        }
+        else
         {
             SetLastError(status_code);
             return downslib_error::statuscode;
@@ -104,7 +152,7 @@ downslib_error downslib_download(const char* url,
 
     DWORD dwRead = 0;
     DWORD dwWritten = 0;
-    unsigned long long read_bytes = 0;
+    unsigned long long read_bytes = existing_bytes;
     while(InternetReadFile(hUrl, buffer, sizeof(buffer), &dwRead))
     {
         read_bytes += dwRead;
@@ -18,9 +18,13 @@ enum class downslib_error
 
 typedef bool (*downslib_cb)(void* userdata, unsigned long long read_bytes, unsigned long long total_bytes);
 
+/* When resume is set an existing file is continued with an HTTP range
+request instead of being re-downloaded, and a partial file is kept on
+failure so the next attempt can pick up where this one stopped. */
 downslib_error downslib_download(const char* url,
                                  const wchar_t* filename,
                                  const char* useragent = "downslib",
                                  unsigned int timeout = 3000,
                                  downslib_cb cb = nullptr,
-                                 void* userdata = nullptr);
+                                 void* userdata = nullptr,
+                                 bool resume = false);
@@ -31,6 +31,9 @@
 #include "exception.h"
 #include "database.h"
 #include "dbghelp_safe.h"
+#include "function.h"
+#include "argument.h"
+#include "_exports.h"
 
 static DBGFUNCTIONS _dbgfunctions;
 
@@ -110,7 +113,7 @@ static void _getcallstack(DBGCALLSTACK* callstack)
 static void _getsehchain(DBGSEHCHAIN* sehchain)
 {
     std::vector<duint> SEHList;
-    ExHandlerGetSEH(SEHList);
+    ExHandlerGetInfo(EX_HANDLER_SEH, SEHList); //served from the chain cache while the target is paused
     sehchain->total = SEHList.size();
     if(sehchain->total > 0)
     {
@@ -457,6 +460,79 @@ static void _refreshmodulelist()
     SymUpdateModuleList();
 }
 
+static FUNCTYPE _functiontypeat(duint addr)
+{
+    duint start, end, instrcount;
+    if(!FunctionGet(addr, &start, &end, &instrcount))
+        return FUNC_NONE;
+    if(start == end || instrcount == 1)
+        return FUNC_SINGLE;
+    else if(addr == start)
+        return FUNC_BEGIN;
+    else if(addr == end)
+        return FUNC_END;
+    return FUNC_MIDDLE;
+}
+
+static ARGTYPE _argumenttypeat(duint addr)
+{
+    duint start, end, instrcount;
+    if(!ArgumentGet(addr, &start, &end, &instrcount))
+        return ARG_NONE;
+    if(start == end || instrcount == 1)
+        return ARG_SINGLE;
+    else if(addr == start)
+        return ARG_BEGIN;
+    else if(addr == end)
+        return ARG_END;
+    return ARG_MIDDLE;
+}
+
+static void _getannotations(const duint* addresses, const int* instructionSizes, duint count, DBGANNOTATIONS* annotations)
+{
+    if(!addresses || !instructionSizes || !annotations)
+        return;
+    memset(annotations, 0, count * sizeof(DBGANNOTATIONS));
+    if(!DbgIsDebugging())
+        return;
+    for(duint i = 0; i < count; i++)
+    {
+        auto & annotation = annotations[i];
+        auto addr = addresses[i];
+        auto lastAddr = instructionSizes[i] > 1 ? addr + instructionSizes[i] - 1 : addr;
+
+        BRIDGE_ADDRINFO info;
+        memset(&info, 0, sizeof(info));
+        info.flags = flaglabel | flagNoFuncOffset | flagcomment | flagbookmark;
+        _dbg_addrinfoget(addr, SEG_DEFAULT, &info);
+        if(!*info.label && !*info.comment)
+        {
+            //DbgGetLabelAt compatibility: fall back to the label behind the pointer
+            //at addr. Only rows without a comment paint the label, so skip the
+            //memory read everywhere else.
+            duint ptr = 0;
+            BRIDGE_ADDRINFO ptrinfo;
+            memset(&ptrinfo, 0, sizeof(ptrinfo));
+            ptrinfo.flags = flaglabel | flagNoFuncOffset;
+            if(MemRead(addr, &ptr, sizeof(ptr)) && _dbg_addrinfoget(ptr, SEG_DEFAULT, &ptrinfo) && *ptrinfo.label)
+                _snprintf_s(info.label, _TRUNCATE, "&%s", ptrinfo.label);
+        }
+        strcpy_s(annotation.comment, info.comment);
+        strcpy_s(annotation.label, info.label);
+        annotation.bookmark = info.isbookmark;
+
+        annotation.functionFirst = _functiontypeat(addr);
+        annotation.functionLast = lastAddr != addr ? _functiontypeat(lastAddr) : annotation.functionFirst;
+        annotation.argumentFirst = _argumenttypeat(addr);
+        annotation.argumentLast = lastAddr != addr ? _argumenttypeat(lastAddr) : annotation.argumentFirst;
+    }
+}
+
+static int _getthreadcyclehistory(DWORD tid, unsigned long long* deltas, int maxCount)
+{
+    return ThreadGetCycleHistory(tid, deltas, maxCount);
+}
+
 void dbgfunctionsinit()
 {
     _dbgfunctions.AssembleAtEx = _assembleatex;
@@ -532,4 +608,7 @@ void dbgfunctionsinit()
     _dbgfunctions.RefreshModuleList = _refreshmodulelist;
     _dbgfunctions.GetAddrFromLineEx = _getaddrfromlineex;
     _dbgfunctions.ModSymbolStatus = _modsymbolstatus;
+    _dbgfunctions.GetTraceRecordHitCounts = _dbg_dbggetTraceRecordHitCounts;
+    _dbgfunctions.GetAnnotations = _getannotations;
+    _dbgfunctions.GetThreadCycleHistory = _getthreadcyclehistory;
 }
@@ -207,6 +207,24 @@ typedef int(*SYMAUTOCOMPLETE)(const char* Search, char** Buffer, int MaxSymbols)
 typedef void(*REFRESHMODULELIST)();
 typedef duint(*GETADDRFROMLINEEX)(duint mod, const char* szSourceFile, int line);
 typedef MODULESYMBOLSTATUS(*MODSYMBOLSTATUS)(duint mod);
+typedef void(*GETTRACERECORDHITCOUNTS)(duint address, duint size, unsigned int* counts);
+typedef int(*GETTHREADCYCLEHISTORY)(DWORD tid, unsigned long long* deltas, int maxCount);
+
+//All the annotations the disassembly view paints per row, fetched for a
+//whole viewport in one call instead of one bridge round trip per annotation
+//per row.
+typedef struct
+{
+    char comment[MAX_COMMENT_SIZE];
+    char label[MAX_LABEL_SIZE];
+    bool bookmark;
+    FUNCTYPE functionFirst; //function type at the first byte of the instruction
+    FUNCTYPE functionLast; //function type at the last byte of the instruction
+    ARGTYPE argumentFirst; //argument type at the first byte of the instruction
+    ARGTYPE argumentLast; //argument type at the last byte of the instruction
+} DBGANNOTATIONS;
+
+typedef void(*GETANNOTATIONS)(const duint* addresses, const int* instructionSizes, duint count, DBGANNOTATIONS* annotations);
 
 //The list of all the DbgFunctions() return value.
 //WARNING: This list is append only. Do not insert things in the middle or plugins would break.
@@ -285,6 +303,9 @@ typedef struct DBGFUNCTIONS_
     REFRESHMODULELIST RefreshModuleList;
     GETADDRFROMLINEEX GetAddrFromLineEx;
     MODSYMBOLSTATUS ModSymbolStatus;
+    GETTRACERECORDHITCOUNTS GetTraceRecordHitCounts;
+    GETANNOTATIONS GetAnnotations;
+    GETTHREADCYCLEHISTORY GetThreadCycleHistory;
 } DBGFUNCTIONS;
 
 #ifdef BUILD_DBG
@@ -81,7 +81,9 @@ extern "C" DLL_EXPORT bool _dbg_memmap(MEMMAP* memmap)
 
 extern "C" DLL_EXPORT bool _dbg_memisvalidreadptr(duint addr)
 {
-    return MemIsValidReadPtr(addr, true);
+    //served from the lock-free snapshot: the GUI calls this once per visible
+    //cell per repaint to decide pointer styling
+    return MemIsValidReadPtrFast(addr);
 }
 
 extern "C" DLL_EXPORT bool _dbg_valfromstring(const char* string, duint* value)
@@ -102,7 +104,7 @@ extern "C" DLL_EXPORT bool _dbg_isjumpgoingtoexecute(duint addr)
     unsigned char data[16];
     if(MemRead(addr, data, sizeof(data), nullptr, true))
     {
-        Zydis cp;
+        auto & cp = Zydis::ThreadLocal();
         if(cp.Disassemble(addr, data))
         {
             CONTEXT ctx;
@@ -712,6 +714,85 @@ extern "C" DLL_EXPORT bool _dbg_getregdump(REGDUMP* regdump)
     return true;
 }
 
+// GP-only variant of _dbg_getregdump: one GetThreadContext without the
+// extended x87/SSE/AVX state, which is the expensive part of the capture.
+// Callers that only consume cip/flags/GP registers (side bar, local vars)
+// reach this through DbgGetRegDumpBasic; the SIMD fields stay zeroed.
+static bool dbggetregdumpbasic(REGDUMP* regdump)
+{
+    memset(regdump, 0, sizeof(REGDUMP));
+    if(!DbgIsDebugging())
+        return true;
+
+    CONTEXT ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.ContextFlags = CONTEXT_CONTROL | CONTEXT_INTEGER | CONTEXT_SEGMENTS | CONTEXT_DEBUG_REGISTERS;
+    if(!GetThreadContext(hActiveThread, &ctx))
+        return false;
+
+    auto & rc = regdump->regcontext;
+#ifdef _WIN64
+    rc.cax = ctx.Rax;
+    rc.ccx = ctx.Rcx;
+    rc.cdx = ctx.Rdx;
+    rc.cbx = ctx.Rbx;
+    rc.csp = ctx.Rsp;
+    rc.cbp = ctx.Rbp;
+    rc.csi = ctx.Rsi;
+    rc.cdi = ctx.Rdi;
+    rc.r8 = ctx.R8;
+    rc.r9 = ctx.R9;
+    rc.r10 = ctx.R10;
+    rc.r11 = ctx.R11;
+    rc.r12 = ctx.R12;
+    rc.r13 = ctx.R13;
+    rc.r14 = ctx.R14;
+    rc.r15 = ctx.R15;
+    rc.cip = ctx.Rip;
+#else
+    rc.cax = ctx.Eax;
+    rc.ccx = ctx.Ecx;
+    rc.cdx = ctx.Edx;
+    rc.cbx = ctx.Ebx;
+    rc.csp = ctx.Esp;
+    rc.cbp = ctx.Ebp;
+    rc.csi = ctx.Esi;
+    rc.cdi = ctx.Edi;
+    rc.cip = ctx.Eip;
+#endif //_WIN64
+    rc.eflags = ctx.EFlags;
+    rc.gs = (unsigned short)ctx.SegGs;
+    rc.fs = (unsigned short)ctx.SegFs;
+    rc.es = (unsigned short)ctx.SegEs;
+    rc.ds = (unsigned short)ctx.SegDs;
+    rc.cs = (unsigned short)ctx.SegCs;
+    rc.ss = (unsigned short)ctx.SegSs;
+    rc.dr0 = duint(ctx.Dr0);
+    rc.dr1 = duint(ctx.Dr1);
+    rc.dr2 = duint(ctx.Dr2);
+    rc.dr3 = duint(ctx.Dr3);
+    rc.dr6 = duint(ctx.Dr6);
+    rc.dr7 = duint(ctx.Dr7);
+
+    duint cflags = rc.eflags;
+    regdump->flags.c = (cflags & (1 << 0)) != 0;
+    regdump->flags.p = (cflags & (1 << 2)) != 0;
+    regdump->flags.a = (cflags & (1 << 4)) != 0;
+    regdump->flags.z = (cflags & (1 << 6)) != 0;
+    regdump->flags.s = (cflags & (1 << 7)) != 0;
+    regdump->flags.t = (cflags & (1 << 8)) != 0;
+    regdump->flags.i = (cflags & (1 << 9)) != 0;
+    regdump->flags.d = (cflags & (1 << 10)) != 0;
+    regdump->flags.o = (cflags & (1 << 11)) != 0;
+
+    regdump->lastError.code = ThreadGetLastError(ThreadGetId(hActiveThread));
+    strncpy_s(regdump->lastError.name, ErrorCodeToName(regdump->lastError.code).c_str(), _TRUNCATE);
+    regdump->lastStatus.code = ThreadGetLastStatus(ThreadGetId(hActiveThread));
+    strncpy_s(regdump->lastStatus.name, NtStatusCodeToName(regdump->lastStatus.code).c_str(), _TRUNCATE);
+
+    return true;
+}
+
 extern "C" DLL_EXPORT bool _dbg_valtostring(const char* string, duint value)
 {
     return valtostring(string, value, true);
@@ -782,7 +863,7 @@ extern "C" DLL_EXPORT duint _dbg_getbranchdestination(duint addr)
     unsigned char data[MAX_DISASM_BUFFER];
     if(!MemIsValidReadPtr(addr, true) || !MemRead(addr, data, sizeof(data)))
         return 0;
-    Zydis cp;
+    auto & cp = Zydis::ThreadLocal();
     if(!cp.Disassemble(addr, data))
         return 0;
     if(cp.IsBranchType(Zydis::BTJmp | Zydis::BTCall | Zydis::BTLoop | Zydis::BTXbegin))
@@ -1029,6 +1110,12 @@ extern "C" DLL_EXPORT duint _dbg_sendmessage(DBGMSG type, void* param1, void* pa
         bNoWow64SingleStepWorkaround = settingboolget("Engine", "NoWow64SingleStepWorkaround");
         bQueryWorkingSet = settingboolget("Misc", "QueryWorkingSet");
         bForceLoadSymbols = settingboolget("Misc", "ForceLoadSymbols");
+        duint memoryReadCacheSetting = 1; //enabled unless explicitly turned off
+        BridgeSettingGetUint("Engine", "MemoryReadCache", &memoryReadCacheSetting);
+        auto cacheEnabled = !!memoryReadCacheSetting;
+        if(bCacheMemoryReads && !cacheEnabled)
+            MemCacheFlush();
+        bCacheMemoryReads = cacheEnabled;
         stackupdatesettings();
 
         duint setting;
@@ -1521,6 +1608,18 @@ extern "C" DLL_EXPORT duint _dbg_sendmessage(DBGMSG type, void* param1, void* pa
         return debugEngine;
     }
     break;
+
+    case DBG_MEMREAD_SCATTER:
+    {
+        return MemReadScatter((MEMREADRANGE*)param1, duint(param2));
+    }
+    break;
+
+    case DBG_GETREGDUMP_BASIC:
+    {
+        return dbggetregdumpbasic((REGDUMP*)param1);
+    }
+    break;
     }
     return 0;
 }
@@ -187,3 +187,18 @@ PLUG_IMPEXP bool _plugin_unregisterformatfunction(int pluginHandle, const char*
 {
     return pluginformatfuncunregister(pluginHandle, type);
 }
+
+PLUG_IMPEXP int _plugin_regdumpcachecreate()
+{
+    return pluginregdumpcachecreate();
+}
+
+PLUG_IMPEXP bool _plugin_regdumpcacheget(int hCache, REGDUMP* regdump)
+{
+    return pluginregdumpcacheget(hCache, regdump);
+}
+
+PLUG_IMPEXP bool _plugin_regdumpcachefree(int hCache)
+{
+    return pluginregdumpcachefree(hCache);
+}
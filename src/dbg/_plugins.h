@@ -322,6 +322,9 @@ PLUG_IMPEXP bool _plugin_load(const char* pluginName);
 PLUG_IMPEXP duint _plugin_hash(const void* data, duint size);
 PLUG_IMPEXP bool _plugin_registerformatfunction(int pluginHandle, const char* type, CBPLUGINFORMATFUNCTION cbFunction, void* userdata);
 PLUG_IMPEXP bool _plugin_unregisterformatfunction(int pluginHandle, const char* type);
+PLUG_IMPEXP int _plugin_regdumpcachecreate(); //subscribe to a register dump cache invalidated on step/pause/resume
+PLUG_IMPEXP bool _plugin_regdumpcacheget(int hCache, REGDUMP* regdump);
+PLUG_IMPEXP bool _plugin_regdumpcachefree(int hCache);
 
 #ifdef __cplusplus
 }
@@ -19,4 +19,8 @@ SCRIPT_EXPORT bool Script::Assembler::AssembleMem(duint addr, const char* instru
 SCRIPT_EXPORT bool Script::Assembler::AssembleMemEx(duint addr, const char* instruction, int* size, char* error, bool fillnop)
 {
     return assembleat(addr, instruction, size, error, fillnop);
-}
\ No newline at end of file
+}
+SCRIPT_EXPORT bool Script::Assembler::AssembleMemBatch(duint addr, const char* listing, int* size, char* error, bool fillnop)
+{
+    return assembleatbatch(addr, listing, size, error, fillnop);
+}
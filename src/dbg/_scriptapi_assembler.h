@@ -11,6 +11,7 @@ namespace Script
         SCRIPT_EXPORT bool AssembleEx(duint addr, unsigned char* dest, int* size, const char* instruction, char* error); //dest[16], error[MAX_ERROR_SIZE]
         SCRIPT_EXPORT bool AssembleMem(duint addr, const char* instruction);
         SCRIPT_EXPORT bool AssembleMemEx(duint addr, const char* instruction, int* size, char* error, bool fillnop); //error[MAX_ERROR_SIZE]
+        SCRIPT_EXPORT bool AssembleMemBatch(duint addr, const char* listing, int* size, char* error, bool fillnop); //listing lines separated by \n, error[MAX_ERROR_SIZE]
     }; //Assembler
 }; //Script
 
@@ -75,4 +75,13 @@ SCRIPT_EXPORT bool Script::Debug::DeleteHardwareBreakpoint(duint address)
     char command[128] = "";
     sprintf_s(command, "bphwc %p", address);
     return DbgCmdExecDirect(command);
-}
\ No newline at end of file
+}
+SCRIPT_EXPORT void Script::Debug::BreakpointBatchBegin()
+{
+    DbgCmdExecDirect("bpbatch begin");
+}
+
+SCRIPT_EXPORT void Script::Debug::BreakpointBatchCommit()
+{
+    DbgCmdExecDirect("bpbatch commit");
+}
@@ -26,6 +26,8 @@ namespace Script
         SCRIPT_EXPORT bool DisableBreakpoint(duint address);
         SCRIPT_EXPORT bool SetHardwareBreakpoint(duint address, HardwareType type = HardwareExecute);
         SCRIPT_EXPORT bool DeleteHardwareBreakpoint(duint address);
+        SCRIPT_EXPORT void BreakpointBatchBegin(); //defer GUI/index/journal updates of breakpoint changes
+        SCRIPT_EXPORT void BreakpointBatchCommit(); //publish all deferred breakpoint changes at once
     }; //Debug
 }; //Script
 
@@ -7,6 +7,13 @@ SCRIPT_EXPORT bool Script::Memory::Read(duint addr, void* data, duint size, duin
     return MemRead(addr, data, size, sizeRead);
 }
 
+SCRIPT_EXPORT bool Script::Memory::ReadVector(MEMREADRANGE* ranges, duint count)
+{
+    //serves all ranges in a single call, so plugin loops over many small reads
+    //pay for one DLL transition instead of one per range
+    return MemReadScatter(ranges, count);
+}
+
 SCRIPT_EXPORT bool Script::Memory::Write(duint addr, const void* data, duint size, duint* sizeWritten)
 {
     return MemWrite(addr, data, size, sizeWritten);
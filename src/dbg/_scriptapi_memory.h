@@ -8,6 +8,7 @@ namespace Script
     namespace Memory
     {
         SCRIPT_EXPORT bool Read(duint addr, void* data, duint size, duint* sizeRead);
+        SCRIPT_EXPORT bool ReadVector(MEMREADRANGE* ranges, duint count); //batch variant of Read, one call for many ranges
         SCRIPT_EXPORT bool Write(duint addr, const void* data, duint size, duint* sizeWritten);
         SCRIPT_EXPORT bool IsValidPtr(duint addr);
         SCRIPT_EXPORT duint RemoteAlloc(duint addr, duint size);
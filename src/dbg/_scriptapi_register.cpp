@@ -2,6 +2,8 @@
 #include "value.h"
 #include "debugger.h"
 #include "TraceRecord.h"
+#include "plugin_loader.h"
+#include "_exports.h"
 
 static const char* regTable[] =
 {
@@ -103,9 +105,16 @@ SCRIPT_EXPORT duint Script::Register::Get(Script::Register::RegisterEnum reg)
     return getregister(nullptr, regTable[reg]);
 }
 
+SCRIPT_EXPORT bool Script::Register::GetAll(REGDUMP* regdump)
+{
+    //one call instead of one Get per register, for plugins that walk the whole context
+    return regdump && _dbg_getregdump(regdump);
+}
+
 SCRIPT_EXPORT bool Script::Register::Set(Script::Register::RegisterEnum reg, duint value)
 {
     auto result = setregister(regTable[reg], value);
+    pluginregdumpcacheinvalidate(); //cached register snapshots are stale now
 
     if(reg == ArchValue(EIP, RIP) || reg == CIP)
     {
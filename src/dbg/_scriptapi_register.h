@@ -103,6 +103,7 @@ namespace Script
         }; //RegisterEnum
 
         SCRIPT_EXPORT duint Get(RegisterEnum reg);
+        SCRIPT_EXPORT bool GetAll(REGDUMP* regdump); //snapshot of the full register dump in one call
         SCRIPT_EXPORT bool Set(RegisterEnum reg, duint value);
         SCRIPT_EXPORT int Size(); //gets architecture register size in bytes
 
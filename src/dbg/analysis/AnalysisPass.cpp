@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <thread>
 #include "AnalysisPass.h"
+#include "AnalysisScheduler.h"
 #include "memory.h"
 
 AnalysisPass::AnalysisPass(duint VirtualStart, duint VirtualEnd, BBlockArray & MainBlocks) : m_MainBlocks(MainBlocks)
@@ -77,13 +78,7 @@ duint AnalysisPass::IdealThreadCount()
     if(m_InternalMaxThreads == 0)
     {
         // Determine the maximum hardware thread count at once
-        duint maximumThreads = max(std::thread::hardware_concurrency(), 1);
-
-        // Don't consume 100% of the CPU, adjust accordingly
-        if(maximumThreads > 1)
-            maximumThreads -= 1;
-
-        SetIdealThreadCount(maximumThreads);
+        SetIdealThreadCount(AnalysisIdealThreadCount());
     }
 
     return m_InternalMaxThreads;
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "_global.h"
+#include <thread>
+#include <ppl.h>
+
+// Chunked work scheduling for the analysis passes.
+//
+// The passes used to split their range into one contiguous chunk per core,
+// which leaves cores idle when the code density is skewed across a module:
+// a thread that got the resource section finishes immediately while the one
+// with the code section runs alone. Splitting the range into many small
+// chunks and handing them to the PPL work-stealing scheduler keeps all
+// cores busy until the very end of the pass.
+
+// Same thread count policy as AnalysisPass::IdealThreadCount, usable by
+// passes that do not derive from AnalysisPass
+inline duint AnalysisIdealThreadCount()
+{
+    duint maximumThreads = max(std::thread::hardware_concurrency(), 1);
+
+    // Don't consume 100% of the CPU, adjust accordingly
+    if(maximumThreads > 1)
+        maximumThreads -= 1;
+
+    return maximumThreads;
+}
+
+// Number of chunks [0, Total) should be split into: enough over-decomposition
+// for the scheduler to balance, bounded so chunks don't get smaller than
+// MinChunkSize work items
+inline duint AnalysisChunkCount(duint Total, duint ThreadCount, duint MinChunkSize)
+{
+    if(ThreadCount <= 1 || Total == 0)
+        return 1;
+
+    duint chunkCount = ThreadCount * 8;
+    if(MinChunkSize && chunkCount > Total / MinChunkSize)
+        chunkCount = max(Total / MinChunkSize, duint(1));
+
+    return chunkCount;
+}
+
+// Run Worker(chunkIndex, start, stop) over [0, Total) split into ChunkCount
+// chunks on the work-stealing scheduler. Empty chunks are not dispatched.
+template<typename Worker>
+void AnalysisDispatchChunks(duint Total, duint ChunkCount, Worker worker)
+{
+    duint chunkSize = (Total + ChunkCount - 1) / ChunkCount;
+
+    concurrency::parallel_for(duint(0), ChunkCount, [&](duint i)
+    {
+        duint start = chunkSize * i;
+        duint stop = min(start + chunkSize, Total);
+
+        if(start < stop)
+            worker(i, start, stop);
+    });
+}
@@ -1,4 +1,5 @@
 #include "FunctionPass.h"
+#include "AnalysisScheduler.h"
 #include <ppl.h>
 #include "memory.h"
 #include "console.h"
@@ -69,29 +70,26 @@ const char* FunctionPass::GetName()
 
 bool FunctionPass::Analyse()
 {
-    // THREAD_WORK = ceil(TOTAL / # THREADS)
-    duint workAmount = (m_MainBlocks.size() + (IdealThreadCount() - 1)) / IdealThreadCount();
+    // Split the blocks into small chunks for the work-stealing scheduler
+    duint chunkCount = AnalysisChunkCount(m_MainBlocks.size(), IdealThreadCount(), 0x1000);
 
-    // Initialize thread vector
-    auto threadFunctions = new std::vector<FunctionDef>[IdealThreadCount()];
+    // Initialize chunk vector
+    auto threadFunctions = new std::vector<FunctionDef>[chunkCount];
 
-    concurrency::parallel_for(duint(0), IdealThreadCount(), [&](duint i)
+    AnalysisDispatchChunks(m_MainBlocks.size(), chunkCount, [&](duint i, duint threadWorkStart, duint threadWorkStop)
     {
         // Memory allocation optimization
         // TODO: Option to conserve memory
-        threadFunctions[i].reserve(30000);
+        threadFunctions[i].reserve(30000 / chunkCount + 1);
 
         // Execute
-        duint threadWorkStart = (workAmount * i);
-        duint threadWorkStop = min((threadWorkStart + workAmount), m_MainBlocks.size());
-
         AnalysisWorker(threadWorkStart, threadWorkStop, &threadFunctions[i]);
     });
 
-    // Merge thread vectors into single local
+    // Merge chunk vectors into single local
     std::vector<FunctionDef> funcs;
 
-    for(duint i = 0; i < IdealThreadCount(); i++)
+    for(duint i = 0; i < chunkCount; i++)
         std::move(threadFunctions[i].begin(), threadFunctions[i].end(), std::back_inserter(funcs));
 
     // Sort and remove duplicates
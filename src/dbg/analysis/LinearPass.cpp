@@ -1,6 +1,7 @@
 #include <thread>
 #include <ppl.h>
 #include "AnalysisPass.h"
+#include "AnalysisScheduler.h"
 #include "LinearPass.h"
 #include <zydis_wrapper.h>
 
@@ -26,17 +27,17 @@ const char* LinearPass::GetName()
 
 bool LinearPass::Analyse()
 {
-    // Divide the work up between each thread
-    // THREAD_WORK = (TOTAL / # THREADS)
-    duint workAmount = m_DataSize / IdealThreadCount();
+    // Split the data into small chunks for the work-stealing scheduler,
+    // so skewed code density does not leave cores idle at the end
+    duint chunkCount = AnalysisChunkCount(m_DataSize, IdealThreadCount(), 0x10000);
 
-    // Initialize thread vector
-    auto threadBlocks = new std::vector<BasicBlock>[IdealThreadCount()];
+    // Initialize chunk vector
+    auto threadBlocks = new std::vector<BasicBlock>[chunkCount];
 
-    concurrency::parallel_for(duint(0), IdealThreadCount(), [&](duint i)
+    AnalysisDispatchChunks(m_DataSize, chunkCount, [&](duint i, duint start, duint stop)
     {
-        duint threadWorkStart = m_VirtualStart + (workAmount * i);
-        duint threadWorkStop = min((threadWorkStart + workAmount), m_VirtualEnd);
+        duint threadWorkStart = m_VirtualStart + start;
+        duint threadWorkStop = m_VirtualStart + stop;
 
         // Allow a 256-byte variance of scanning because of
         // integer rounding errors and instruction overlap
@@ -48,7 +49,7 @@ bool LinearPass::Analyse()
 
         // Memory allocation optimization
         // TODO: Option to conserve memory
-        threadBlocks[i].reserve(100000);
+        threadBlocks[i].reserve(100000 / chunkCount + 1);
 
         // Execute
         AnalysisWorker(threadWorkStart, threadWorkStop, &threadBlocks[i]);
@@ -57,7 +58,7 @@ bool LinearPass::Analyse()
     // Clear old data and combine vectors
     m_MainBlocks.clear();
 
-    for(duint i = 0; i < IdealThreadCount(); i++)
+    for(duint i = 0; i < chunkCount; i++)
     {
         std::move(threadBlocks[i].begin(), threadBlocks[i].end(), std::back_inserter(m_MainBlocks));
 
@@ -88,17 +89,17 @@ void LinearPass::AnalyseOverlaps()
     // This also checks for basic block targets jumping into
     // the middle of other basic blocks.
     //
-    // THREAD_WORK = ceil(TOTAL / # THREADS)
+    // Chunked like Analyse() so the scheduler can balance the work
     duint workTotal = m_MainBlocks.size();
-    duint workAmount = (workTotal + (IdealThreadCount() - 1)) / IdealThreadCount();
+    duint chunkCount = AnalysisChunkCount(workTotal, IdealThreadCount(), 0x1000);
 
-    // Initialize thread vectors
-    auto threadInserts = new std::vector<BasicBlock>[IdealThreadCount()];
+    // Initialize chunk vectors
+    auto threadInserts = new std::vector<BasicBlock>[chunkCount];
 
-    concurrency::parallel_for(duint(0), IdealThreadCount(), [&](duint i)
+    AnalysisDispatchChunks(workTotal, chunkCount, [&](duint i, duint start, duint stop)
     {
-        duint threadWorkStart = (workAmount * i);
-        duint threadWorkStop = min((threadWorkStart + workAmount), workTotal);
+        duint threadWorkStart = start;
+        duint threadWorkStop = stop;
 
         // Again, allow an overlap of +/- 1 entry
         if(threadWorkStart > 0)
@@ -114,7 +115,7 @@ void LinearPass::AnalyseOverlaps()
     // THREAD VECTOR
     std::vector<BasicBlock> overlapInserts;
     {
-        for(duint i = 0; i < IdealThreadCount(); i++)
+        for(duint i = 0; i < chunkCount; i++)
             std::move(threadInserts[i].begin(), threadInserts[i].end(), std::back_inserter(overlapInserts));
 
         // Sort and remove duplicates
@@ -144,6 +145,10 @@ void LinearPass::AnalysisWorker(duint Start, duint End, BBlockArray* Blocks)
 {
     Zydis disasm;
 
+    // Arena refilled in one decode pass at a time (the formatted text is
+    // never needed here, so the compact records skip the formatter entirely)
+    Zydis::InstrInfo instrArena[1024];
+
     duint blockBegin = Start;        // BBlock starting virtual address
     duint blockEnd = 0;              // BBlock ending virtual address
 
@@ -154,99 +159,93 @@ void LinearPass::AnalysisWorker(duint Start, duint End, BBlockArray* Blocks)
 
     for(duint i = Start; i < End;)
     {
-        if(!disasm.Disassemble(i, TranslateAddress(i), int(End - i)))
+        auto decoded = disasm.DisassembleRange(i, TranslateAddress(i), size_t(End - i), instrArena, _countof(instrArena));
+        if(!decoded)
+            break;
+
+        for(size_t n = 0; n < decoded; n++)
         {
-            // Skip instructions that can't be determined
-            i++;
-            continue;
-        }
+            const auto & instr = instrArena[n];
+            i = instr.address + instr.length;
 
-        // Increment counters
-        i += disasm.Size();
-        blockEnd = i;
-        insnCount++;
+            // Skip instructions that can't be determined
+            if(instr.mnemonic == ZYDIS_MNEMONIC_INVALID)
+                continue;
 
-        // The basic block ends here if it is a branch
-        bool call = disasm.IsCall();        // CALL
-        bool jmp = disasm.IsJump();         // JUMP
-        bool ret = disasm.IsRet();          // RETURN
-        bool padding = disasm.IsFilling();  // INSTRUCTION PADDING
+            // Increment counters
+            blockEnd = i;
+            insnCount++;
 
-        if(padding)
-        {
-            // PADDING is treated differently. They are all created as their
-            // own separate block for more analysis later.
-            duint realBlockEnd = blockEnd - disasm.Size();
+            // The basic block ends here if it is a branch
+            bool call = (instr.branchType & Zydis::BTCall) != 0;    // CALL
+            bool jmp = (instr.branchType & Zydis::BTJmp) != 0;      // JUMP
+            bool ret = (instr.branchType & Zydis::BTRet) != 0;      // RETURN
+            bool padding = instr.mnemonic == ZYDIS_MNEMONIC_NOP ||  // INSTRUCTION PADDING
+                           instr.mnemonic == ZYDIS_MNEMONIC_INT3;
 
-            if((realBlockEnd - blockBegin) > 0)
+            if(padding)
             {
-                // The next line terminates the BBlock before the INT instruction.
-                // Early termination, faked as an indirect JMP. Rare case.
-                lastBlock = CreateBlockWorker(Blocks, blockBegin, realBlockEnd, false, false, false, false);
-                lastBlock->SetFlag(BASIC_BLOCK_FLAG_PREPAD);
-
-                blockBegin = realBlockEnd;
-                lastBlock->InstrCount = insnCount;
-                insnCount = 0;
-            }
-        }
+                // PADDING is treated differently. They are all created as their
+                // own separate block for more analysis later.
+                duint realBlockEnd = blockEnd - instr.length;
 
-        if(call || jmp || ret || padding)
-        {
-            // Was this a padding instruction?
-            if(padding && blockPrevPad)
-            {
-                // Append it to the previous block
-                lastBlock->VirtualEnd = blockEnd;
+                if((realBlockEnd - blockBegin) > 0)
+                {
+                    // The next line terminates the BBlock before the INT instruction.
+                    // Early termination, faked as an indirect JMP. Rare case.
+                    lastBlock = CreateBlockWorker(Blocks, blockBegin, realBlockEnd, false, false, false, false);
+                    lastBlock->SetFlag(BASIC_BLOCK_FLAG_PREPAD);
+
+                    blockBegin = realBlockEnd;
+                    lastBlock->InstrCount = insnCount;
+                    insnCount = 0;
+                }
             }
-            else
-            {
-                // Otherwise use the default route: create a new entry
-                auto block = lastBlock = CreateBlockWorker(Blocks, blockBegin, blockEnd, call, jmp, ret, padding);
 
-                // Counters
-                lastBlock->InstrCount = insnCount;
-                insnCount = 0;
-
-                if(!padding)
+            if(call || jmp || ret || padding)
+            {
+                // Was this a padding instruction?
+                if(padding && blockPrevPad)
+                {
+                    // Append it to the previous block
+                    lastBlock->VirtualEnd = blockEnd;
+                }
+                else
                 {
-                    // Check if absolute jump, regardless of operand
-                    if(disasm.GetId() == ZYDIS_MNEMONIC_JMP)
-                        block->SetFlag(BASIC_BLOCK_FLAG_ABSJMP);
+                    // Otherwise use the default route: create a new entry
+                    auto block = lastBlock = CreateBlockWorker(Blocks, blockBegin, blockEnd, call, jmp, ret, padding);
+
+                    // Counters
+                    lastBlock->InstrCount = insnCount;
+                    insnCount = 0;
 
-                    // Figure out the operand type(s)
-                    if(disasm.OpCount() > 0)
+                    if(!padding)
                     {
-                        const auto & operand = disasm[0];
+                        // Check if absolute jump, regardless of operand
+                        if(instr.mnemonic == ZYDIS_MNEMONIC_JMP)
+                            block->SetFlag(BASIC_BLOCK_FLAG_ABSJMP);
 
-                        if(operand.type == ZYDIS_OPERAND_TYPE_IMMEDIATE)
-                        {
-                            // Branch target immediate
-                            block->Target = (duint)operand.imm.value.u;
-                        }
-                        else
+                        // Figure out the operand type(s)
+                        if(instr.visibleOpCount > 0)
                         {
-                            // Indirects (no operand, register, or memory)
-                            block->SetFlag(BASIC_BLOCK_FLAG_INDIRECT);
-
-                            if(operand.type == ZYDIS_OPERAND_TYPE_MEMORY &&
-                                    operand.mem.base == ZYDIS_REGISTER_RIP &&
-                                    operand.mem.index == ZYDIS_REGISTER_NONE &&
-                                    operand.mem.scale == 1)
+                            if(instr.op0Type == uint8_t(ZYDIS_OPERAND_TYPE_IMMEDIATE))
+                            {
+                                // Branch target immediate
+                                block->Target = (duint)instr.branchDestination;
+                            }
+                            else
                             {
-                                /*
-                                block->SetFlag(BASIC_BLOCK_FLAG_INDIRPTR);
-                                block->Target = (duint)operand.mem.disp;
-                                */
+                                // Indirects (no operand, register, or memory)
+                                block->SetFlag(BASIC_BLOCK_FLAG_INDIRECT);
                             }
                         }
                     }
                 }
-            }
 
-            // Reset the loop variables
-            blockBegin = i;
-            blockPrevPad = padding;
+                // Reset the loop variables
+                blockBegin = i;
+                blockPrevPad = padding;
+            }
         }
     }
 }
@@ -42,14 +42,16 @@ void AdvancedAnalysis::SetMarkers()
     EncodeMapReleaseBuffer(buffer);
 
     XrefDelRange(mBase, mBase + mSize - 1);
+    std::vector<XREF_EDGE> edges;
     for(const auto & vec : mXrefs)
     {
         for(const auto & xref : vec.second)
         {
-            if(xref.valid)
-                XrefAdd(xref.addr, xref.from);
+            if(xref.valid) //the type is already known, no need to re-disassemble
+                edges.push_back({ xref.addr, xref.from, xref.type });
         }
     }
+    XrefAddMulti(edges.data(), edges.size());
 
     FunctionClear();
     for(const auto & function : mFunctions)
@@ -1,4 +1,6 @@
 #include "controlflowanalysis.h"
+#include "AnalysisScheduler.h"
+#include <algorithm>
 #include "console.h"
 #include "module.h"
 #include "TitanEngine/TitanEngine.h"
@@ -93,114 +95,127 @@ void ControlFlowAnalysis::SetMarkers()
         const auto & range = mFunctionRanges[i];
         FunctionAdd(range.first, range.second, false);
     }
-    /*dprintf("digraph ControlFlow {\n");
-    int i = 0;
-    std::map<duint, int> nodeMap;
-    for(const auto & it : mBlocks)
-    {
-        const auto & block = it.second;
-        nodeMap.insert({ block.start, i });
-        dprintf("    node%u [label=\"s=%p, e=%p, f=%p\"];\n", i, block.start, block.end, block.function);
-        i++;
-    }
-    for(auto it : mBlocks)
-    {
-        const auto & block = it.second;
-        int startNode = nodeMap[block.start];
-        if(block.left)
-        {
-            if(nodeMap.count(block.left))
-                dprintf("    node%u -> node%u;\n", startNode, nodeMap[block.left]);
-        }
-        else
-        {
-            dprintf("    node%u [shape=point];\n", i);
-            dprintf("    node%u -> node%u;\n", startNode, i);
-            i++;
-        }
-        if(block.right)
-        {
-            if(nodeMap.count(block.right))
-                dprintf("    node%u -> node%u;\n", startNode, nodeMap[block.right]);
-        }
-        else
-        {
-            dprintf("    node%u [shape=point];\n", i);
-            dprintf("    node%u -> node%u;\n", startNode, i);
-            i++;
-        }
-    }
-    dprintf("}\n");*/
 }
 
 void ControlFlowAnalysis::BasicBlockStarts()
 {
     mBlockStarts.insert(mBase);
-    auto bSkipFilling = false;
-    for(duint i = 0; i < mSize;)
+
+    // Chunked scan on the work-stealing scheduler: every chunk collects its
+    // starts into local vectors with its own Zydis instance; the merge into
+    // the sets deduplicates the chunk overlap
+    duint chunkCount = AnalysisChunkCount(mSize, AnalysisIdealThreadCount(), 0x10000);
+    auto chunkBlockStarts = new std::vector<duint>[chunkCount];
+    auto chunkFunctionStarts = new std::vector<duint>[chunkCount];
+
+    AnalysisDispatchChunks(mSize, chunkCount, [&](duint c, duint start, duint stop)
     {
-        auto addr = mBase + i;
-        if(mCp.Disassemble(addr, translateAddr(addr), MAX_DISASM_BUFFER))
+        Zydis cp;
+        auto & blockStarts = chunkBlockStarts[c];
+        auto & functionStarts = chunkFunctionStarts[c];
+
+        // Allow a 256-byte variance because chunks can start in the middle
+        // of an instruction
+        duint chunkStop = stop;
+        if(start > 0)
+        {
+            start = max(start - 256, duint(0));
+            chunkStop = min(chunkStop + 256, mSize);
+        }
+
+        auto bSkipFilling = false;
+        for(duint i = start; i < chunkStop;)
         {
-            if(bSkipFilling) //handle filling skip mode
+            auto addr = mBase + i;
+            if(cp.Disassemble(addr, translateAddr(addr), MAX_DISASM_BUFFER))
             {
-                if(!mCp.IsFilling()) //do nothing until the filling stopped
+                if(bSkipFilling) //handle filling skip mode
                 {
-                    bSkipFilling = false;
-                    mBlockStarts.insert(addr);
+                    if(!cp.IsFilling()) //do nothing until the filling stopped
+                    {
+                        bSkipFilling = false;
+                        blockStarts.push_back(addr);
+                    }
                 }
-            }
-            else if(mCp.IsRet()) //RET breaks control flow
-            {
-                bSkipFilling = true; //skip INT3/NOP/whatever filling bytes (those are not part of the control flow)
-            }
-            else if(mCp.IsJump() || mCp.IsLoop()) //branches
-            {
-                auto dest1 = getReferenceOperand();
-                duint dest2 = 0;
-                if(mCp.GetId() != ZYDIS_MNEMONIC_JMP) //conditional jump
-                    dest2 = addr + mCp.Size();
-
-                if(!dest1 && !dest2) //TODO: better code for this (make sure absolutely no filling is inserted)
-                    bSkipFilling = true;
-                if(dest1)
-                    mBlockStarts.insert(dest1);
-                if(dest2)
-                    mBlockStarts.insert(dest2);
-            }
-            else if(mCp.IsCall())
-            {
-                auto dest1 = getReferenceOperand();
-                if(dest1)
+                else if(cp.IsRet()) //RET breaks control flow
+                {
+                    bSkipFilling = true; //skip INT3/NOP/whatever filling bytes (those are not part of the control flow)
+                }
+                else if(cp.IsJump() || cp.IsLoop()) //branches
+                {
+                    auto dest1 = getReferenceOperand(cp);
+                    duint dest2 = 0;
+                    if(cp.GetId() != ZYDIS_MNEMONIC_JMP) //conditional jump
+                        dest2 = addr + cp.Size();
+
+                    if(!dest1 && !dest2) //TODO: better code for this (make sure absolutely no filling is inserted)
+                        bSkipFilling = true;
+                    if(dest1)
+                        blockStarts.push_back(dest1);
+                    if(dest2)
+                        blockStarts.push_back(dest2);
+                }
+                else if(cp.IsCall())
                 {
-                    mBlockStarts.insert(dest1);
-                    mFunctionStarts.insert(dest1);
+                    auto dest1 = getReferenceOperand(cp);
+                    if(dest1)
+                    {
+                        blockStarts.push_back(dest1);
+                        functionStarts.push_back(dest1);
+                    }
                 }
+                else
+                {
+                    auto dest1 = getReferenceOperand(cp);
+                    if(dest1)
+                        blockStarts.push_back(dest1);
+                }
+                i += cp.Size();
             }
             else
-            {
-                auto dest1 = getReferenceOperand();
-                if(dest1)
-                    mBlockStarts.insert(dest1);
-            }
-            i += mCp.Size();
+                i++;
         }
-        else
-            i++;
+    });
+
+    for(duint c = 0; c < chunkCount; c++)
+    {
+        mBlockStarts.insert(chunkBlockStarts[c].begin(), chunkBlockStarts[c].end());
+        mFunctionStarts.insert(chunkFunctionStarts[c].begin(), chunkFunctionStarts[c].end());
     }
+    delete[] chunkBlockStarts;
+    delete[] chunkFunctionStarts;
 }
 
 void ControlFlowAnalysis::BasicBlocks()
 {
-    for(auto i = mBlockStarts.begin(); i != mBlockStarts.end(); ++i)
+    //iterate the starts in address order so the next start bounds the block
+    std::vector<duint> blockStarts;
+    blockStarts.reserve(mBlockStarts.size());
+    for(auto start : mBlockStarts)
+        if(inRange(start))
+            blockStarts.push_back(start);
+    std::sort(blockStarts.begin(), blockStarts.end());
+
+    //the successor addresses can point to blocks that don't exist yet, so the
+    //blocks are built with addresses first and resolved to indices afterwards
+    struct BlockBuild
     {
-        auto start = *i;
-        if(!inRange(start))
-            continue;
-        auto nextStart = mBase + mSize;
-        auto next = std::next(i);
-        if(next != mBlockStarts.end())
-            nextStart = *next;
+        duint start;
+        duint end;
+        duint left;
+        duint right;
+    };
+    std::vector<BlockBuild> builds;
+    builds.reserve(blockStarts.size());
+    auto insertBuild = [&builds](duint start, duint end, duint left, duint right)
+    {
+        builds.push_back({ start, end, min(left, right), min(left, right) });
+    };
+
+    for(size_t i = 0; i < blockStarts.size(); i++)
+    {
+        auto start = blockStarts[i];
+        auto nextStart = i + 1 < blockStarts.size() ? blockStarts[i + 1] : mBase + mSize;
         for(duint addr = start, prevaddr; addr < mBase + mSize;)
         {
             prevaddr = addr;
@@ -208,16 +223,18 @@ void ControlFlowAnalysis::BasicBlocks()
             {
                 if(mCp.IsRet())
                 {
-                    insertBlock(BasicBlock(start, addr, 0, 0)); //leaf block
+                    insertBuild(start, addr, 0, 0); //leaf block
                     break;
                 }
                 else if(mCp.IsJump() || mCp.IsLoop())
                 {
                     auto dest1 = getReferenceOperand();
                     auto dest2 = mCp.GetId() != ZYDIS_MNEMONIC_JMP ? addr + mCp.Size() : 0;
-                    insertBlock(BasicBlock(start, addr, dest1, dest2));
-                    insertParent(dest1, start);
-                    insertParent(dest2, start);
+                    insertBuild(start, addr, dest1, dest2);
+                    if(dest1)
+                        mParentEdges.emplace_back(dest1, start);
+                    if(dest2)
+                        mParentEdges.emplace_back(dest2, start);
                     break;
                 }
                 addr += mCp.Size();
@@ -226,14 +243,55 @@ void ControlFlowAnalysis::BasicBlocks()
                 addr++;
             if(addr == nextStart) //special case handling overlapping blocks
             {
-                insertBlock(BasicBlock(start, prevaddr, 0, nextStart));
-                insertParent(nextStart, start);
+                insertBuild(start, prevaddr, 0, nextStart);
+                mParentEdges.emplace_back(nextStart, start);
                 break;
             }
         }
     }
     mBlockStarts.clear();
 
+    //move the finished blocks into the arena (already in start order) and
+    //resolve the successor addresses to arena indices
+    mBlocks.resize(builds.size());
+    for(size_t i = 0; i < builds.size(); i++)
+    {
+        mBlocks[i].start = builds[i].start;
+        mBlocks[i].end = builds[i].end;
+    }
+    for(size_t i = 0; i < builds.size(); i++)
+    {
+        mBlocks[i].left = findBlockIndex(builds[i].left);
+        mBlocks[i].right = findBlockIndex(builds[i].right);
+    }
+
+    //pack the parent edges into the shared pool, one slice per block
+    std::vector<std::pair<uint32, uint32>> edges; //child index -> parent index
+    edges.reserve(mParentEdges.size());
+    for(const auto & edge : mParentEdges)
+    {
+        auto child = findBlockIndex(edge.first);
+        auto parent = findBlockIndex(edge.second);
+        if(child != NoBlock && parent != NoBlock)
+            edges.emplace_back(child, parent);
+    }
+    mParentEdges.clear();
+    for(const auto & edge : edges)
+        mBlocks[edge.first].parentCount++;
+    uint32 poolOffset = 0;
+    for(auto & block : mBlocks)
+    {
+        block.parentOffset = poolOffset;
+        poolOffset += block.parentCount;
+        block.parentCount = 0;
+    }
+    mParentPool.resize(poolOffset);
+    for(const auto & edge : edges)
+    {
+        auto & block = mBlocks[edge.first];
+        mParentPool[block.parentOffset + block.parentCount++] = edge.second;
+    }
+
 #ifdef _WIN64
     auto count = 0;
     enumerateFunctionRuntimeEntries64([&](PRUNTIME_FUNCTION Function)
@@ -255,29 +313,23 @@ void ControlFlowAnalysis::BasicBlocks()
 
 void ControlFlowAnalysis::Functions()
 {
-    typedef std::pair<BasicBlock*, const UintSet*> DelayedBlock;
-    std::vector<DelayedBlock> delayedBlocks;
-    for(auto & it : mBlocks)
+    std::vector<uint32> delayedBlocks;
+    for(auto & block : mBlocks) //address order
     {
-        auto block = &it.second;
-        auto parents = findParents(block->start);
-        if(!block->function)
+        if(!block.function)
         {
-            if(!parents || mFunctionStarts.count(block->start)) //no parents = function start
+            if(!block.parentCount || mFunctionStarts.count(block.start)) //no parents = function start
             {
-                auto functionStart = block->start;
-                block->function = functionStart;
-                UintSet functionBlocks;
-                functionBlocks.insert(functionStart);
-                mFunctions[functionStart] = functionBlocks;
+                block.function = block.start;
+                mFunctions[block.start]; //create the (empty) block list
             }
             else //in function
             {
-                auto function = findFunctionStart(block, parents);
+                auto function = findFunctionStart(block);
                 if(!function) //this happens with loops / unreferenced blocks sometimes
-                    delayedBlocks.push_back(DelayedBlock(block, parents));
+                    delayedBlocks.push_back(uint32(&block - mBlocks.data()));
                 else
-                    block->function = function;
+                    block.function = function;
             }
         }
         else
@@ -286,41 +338,26 @@ void ControlFlowAnalysis::Functions()
     auto delayedCount = int(delayedBlocks.size());
     dprintf("%d/%d delayed blocks...\n", delayedCount, int(mBlocks.size()));
     auto resolved = 0;
-    for(auto & delayedBlock : delayedBlocks)
+    for(auto index : delayedBlocks)
     {
-        auto block = delayedBlock.first;
-        auto parents = delayedBlock.second;
-        auto function = findFunctionStart(block, parents);
+        auto & block = mBlocks[index];
+        auto function = findFunctionStart(block);
         if(!function)
-        {
             continue;
-            /*dprintf("unresolved block %s\n", blockToString(block).c_str());
-            if(parents)
-            {
-                dprintf("parents:\n");
-                for(auto parent : *parents)
-                    dprintf("  %s\n", blockToString(findBlock(parent)).c_str());
-            }
-            else
-                dprintf("parents: null");
-            dprintf("left: %s\n", blockToString(findBlock(block->left)).c_str());
-            dprintf("right: %s\n", blockToString(findBlock(block->right)).c_str());
-            return;*/
-        }
-        block->function = function;
+        block.function = function;
         resolved++;
     }
     dprintf("%d/%d delayed blocks resolved (%d/%d still left, probably unreferenced functions)\n", resolved, delayedCount, delayedCount - resolved, int(mBlocks.size()));
     auto unreferencedCount = 0;
-    for(const auto & block : mBlocks)
+    for(uint32 i = 0; i < uint32(mBlocks.size()); i++)
     {
-        auto found = mFunctions.find(block.second.function);
+        auto found = mFunctions.find(mBlocks[i].function);
         if(found == mFunctions.end()) //unreferenced block
         {
             unreferencedCount++;
             continue;
         }
-        found->second.insert(block.second.start);
+        found->second.push_back(i);
     }
     dprintf("%d/%u unreferenced blocks\n", unreferencedCount, DWORD(mBlocks.size()));
     dprintf("%u functions found!\n", DWORD(mFunctions.size()));
@@ -333,89 +370,56 @@ void ControlFlowAnalysis::FunctionRanges()
     {
         auto start = function.first;
         auto end = start;
-        for(auto blockstart : function.second)
+        for(auto index : function.second)
         {
-            auto block = findBlock(blockstart);
-            if(!block)
-                __debugbreak(); //this shouldn't happen
-            if(block->end > end)
-                end = block->end;
+            const auto & block = mBlocks[index];
+            if(block.end > end)
+                end = block.end;
         }
         mFunctionRanges.push_back({ start, end });
     }
 }
 
-void ControlFlowAnalysis::insertBlock(const BasicBlock & block)
-{
-    if(mBlocks.find(block.start) != mBlocks.end())
-        DebugBreak();
-    mBlocks[block.start] = block;
-}
-
-const ControlFlowAnalysis::BasicBlock* ControlFlowAnalysis::findBlock(duint start) const
+uint32 ControlFlowAnalysis::findBlockIndex(duint start) const
 {
     if(!start)
-        return nullptr;
-    auto found = mBlocks.find(start);
-    return found != mBlocks.end() ? &found->second : nullptr;
-}
-
-void ControlFlowAnalysis::insertParent(duint child, duint parent)
-{
-    if(!child || !parent)
-        return;
-    auto found = mParentMap.find(child);
-    if(found == mParentMap.end())
+        return NoBlock;
+    auto found = std::lower_bound(mBlocks.begin(), mBlocks.end(), start, [](const BasicBlock & block, duint start)
     {
-        UintSet parents;
-        parents.insert(parent);
-        mParentMap[child] = parents;
-    }
-    else
-        found->second.insert(parent);
-}
-
-const ControlFlowAnalysis::UintSet* ControlFlowAnalysis::findParents(duint child) const
-{
-    if(!child)
-        return nullptr;
-    auto found = mParentMap.find(child);
-    return found != mParentMap.end() ? &found->second : nullptr;
+        return block.start < start;
+    });
+    if(found == mBlocks.end() || found->start != start)
+        return NoBlock;
+    return uint32(found - mBlocks.begin());
 }
 
-duint ControlFlowAnalysis::findFunctionStart(const BasicBlock* block, const UintSet* parents) const
+duint ControlFlowAnalysis::findFunctionStart(const BasicBlock & block) const
 {
-    if(!block)
-        return 0;
-    if(block->function)
-        return block->function;
-    auto left = findBlock(block->left);
-    if(left && left->function)
-        return left->function;
-    auto right = findBlock(block->right);
-    if(right && right->function)
-        return right->function;
-    for(auto start : *parents)
+    if(block.function)
+        return block.function;
+    if(block.left != NoBlock && mBlocks[block.left].function)
+        return mBlocks[block.left].function;
+    if(block.right != NoBlock && mBlocks[block.right].function)
+        return mBlocks[block.right].function;
+    for(uint32 i = 0; i < block.parentCount; i++)
     {
-        auto parent = findBlock(start);
-        if(parent->function)
-            return parent->function;
+        const auto & parent = mBlocks[mParentPool[block.parentOffset + i]];
+        if(parent.function)
+            return parent.function;
     }
     return 0;
 }
 
-String ControlFlowAnalysis::blockToString(const BasicBlock* block)
+duint ControlFlowAnalysis::getReferenceOperand() const
 {
-    if(!block)
-        return String("null");
-    return block->toString();
+    return getReferenceOperand(mCp);
 }
 
-duint ControlFlowAnalysis::getReferenceOperand() const
+duint ControlFlowAnalysis::getReferenceOperand(const Zydis & cp) const
 {
-    for(auto i = 0; i < mCp.OpCount(); i++)
+    for(auto i = 0; i < cp.OpCount(); i++)
     {
-        const auto & op = mCp[i];
+        const auto & op = cp[i];
         if(op.type == ZYDIS_OPERAND_TYPE_IMMEDIATE)
         {
             auto dest = duint(op.imm.value.u);
@@ -426,7 +430,7 @@ duint ControlFlowAnalysis::getReferenceOperand() const
         {
             auto dest = duint(op.mem.disp.value);
             if(op.mem.base == ZYDIS_REGISTER_RIP) //rip-relative
-                dest += mCp.Address() + mCp.Size();
+                dest += cp.Address() + cp.Size();
             if(inRange(dest))
                 return dest;
         }
@@ -15,31 +15,23 @@ public:
     void SetMarkers() override;
 
 private:
+    static const uint32 NoBlock = 0xFFFFFFFF;
+
+    //blocks live in a contiguous arena ordered by start address; edges are
+    //32-bit arena indices and the parents of all blocks share one edge pool
     struct BasicBlock
     {
-        duint start;
-        duint end;
-        duint left;
-        duint right;
-        duint function;
-
-        BasicBlock()
-            : BasicBlock(0, 0, 0, 0)
-        {
-        }
-
-        BasicBlock(duint start, duint end, duint left, duint right)
-            : start(start),
-              end(end),
-              left(min(left, right)),
-              right(min(left, right)),
-              function(0)
-        {
-        }
+        duint start = 0;
+        duint end = 0;
+        duint function = 0; //function start address, 0 if not assigned yet
+        uint32 left = NoBlock; //successor indices into the arena
+        uint32 right = NoBlock;
+        uint32 parentOffset = 0; //slice of the shared parent edge pool
+        uint32 parentCount = 0;
 
         String toString() const
         {
-            return StringUtils::sprintf("start:%p,end:%p,left:%p,right:%p,func:%p", start, end, left, right, function);
+            return StringUtils::sprintf("start:%p,end:%p,func:%p", start, end, function);
         }
     };
 
@@ -51,22 +43,20 @@ private:
 
     UintSet mBlockStarts;
     UintSet mFunctionStarts;
-    std::unordered_map<duint, BasicBlock> mBlocks; //start of block -> block
-    std::unordered_map<duint, UintSet> mParentMap; //start child -> parents
-    std::unordered_map<duint, UintSet> mFunctions; //function start -> function block starts
+    std::vector<BasicBlock> mBlocks; //basic block arena, ordered by start address
+    std::vector<std::pair<duint, duint>> mParentEdges; //child start -> parent start, collected during construction
+    std::vector<uint32> mParentPool; //shared parent edge pool (arena indices)
+    std::unordered_map<duint, std::vector<uint32>> mFunctions; //function start -> block indices
     std::vector<Range> mFunctionRanges; //function start -> function range TODO: smarter stuff with overlapping ranges
 
     void BasicBlockStarts();
     void BasicBlocks();
     void Functions();
     void FunctionRanges();
-    void insertBlock(const BasicBlock & block);
-    const BasicBlock* findBlock(duint start) const;
-    void insertParent(duint child, duint parent);
-    const UintSet* findParents(duint child) const;
-    duint findFunctionStart(const BasicBlock* block, const UintSet* parents) const;
-    static String blockToString(const BasicBlock* block);
+    uint32 findBlockIndex(duint start) const;
+    duint findFunctionStart(const BasicBlock & block) const;
     duint getReferenceOperand() const;
+    duint getReferenceOperand(const Zydis & cp) const;
 
 #ifdef _WIN64
     void enumerateFunctionRuntimeEntries64(const std::function<bool(PRUNTIME_FUNCTION)> & Callback) const;
@@ -4,6 +4,9 @@
 #include "memory.h"
 #include "console.h"
 #include "function.h"
+#include <algorithm>
+#include <thread>
+#include <ppl.h>
 
 ExceptionDirectoryAnalysis::ExceptionDirectoryAnalysis(duint base, duint size)
     : Analysis(base, size),
@@ -64,17 +67,40 @@ ExceptionDirectoryAnalysis::~ExceptionDirectoryAnalysis()
 void ExceptionDirectoryAnalysis::Analyse()
 {
 #ifdef _WIN64
-    EnumerateFunctionRuntimeEntries64([&](PRUNTIME_FUNCTION Function)
+    auto functionTable = PRUNTIME_FUNCTION(mFunctionInfoData);
+    auto totalCount = mFunctionInfoData ? mFunctionInfoSize / sizeof(RUNTIME_FUNCTION) : 0;
+    auto collect = [this](PRUNTIME_FUNCTION Function, std::vector<std::pair<duint, duint>> & functions)
     {
         auto funcAddr = mModuleBase + Function->BeginAddress;
         auto funcEnd = mModuleBase + Function->EndAddress;
 
         // If within limits...
         if(inRange(funcAddr) && inRange(funcEnd))
-            mFunctions.push_back({ funcAddr, funcEnd });
+            functions.push_back({ funcAddr, funcEnd });
+    };
 
-        return true;
-    });
+    // Partition the function table across threads (same chunking as the
+    // reference scan), each with its own list, merged in table order
+    const duint chunkSize = 0x10000;
+    if(totalCount >= chunkSize * 2 && std::thread::hardware_concurrency() > 1)
+    {
+        auto chunkCount = (totalCount + chunkSize - 1) / chunkSize;
+        std::vector<std::vector<std::pair<duint, duint>>> chunkFunctions(chunkCount);
+        concurrency::parallel_for(duint(0), chunkCount, [&](duint c)
+        {
+            auto & functions = chunkFunctions[c];
+            auto chunkEnd = std::min((c + 1) * chunkSize, totalCount);
+            for(auto i = c * chunkSize; i < chunkEnd; i++)
+                collect(&functionTable[i], functions);
+        });
+        for(const auto & functions : chunkFunctions)
+            mFunctions.insert(mFunctions.end(), functions.begin(), functions.end());
+    }
+    else
+    {
+        for(duint i = 0; i < totalCount; i++)
+            collect(&functionTable[i], mFunctions);
+    }
     dprintf(QT_TRANSLATE_NOOP("DBG", "%u functions discovered!\n"), DWORD(mFunctions.size()));
 #else //x32
     dputs(QT_TRANSLATE_NOOP("DBG", "This kind of analysis doesn't work on x32 executables...\n"));
@@ -84,25 +110,5 @@ void ExceptionDirectoryAnalysis::Analyse()
 void ExceptionDirectoryAnalysis::SetMarkers()
 {
     FunctionDelRange(mBase, mBase + mSize - 1, false);
-    for(const auto & function : mFunctions)
-        FunctionAdd(function.first, function.second, false);
-}
-
-#ifdef _WIN64
-void ExceptionDirectoryAnalysis::EnumerateFunctionRuntimeEntries64(const std::function<bool(PRUNTIME_FUNCTION)> & Callback) const
-{
-    if(!mFunctionInfoData)
-        return;
-
-    // Get the table pointer and size
-    auto functionTable = PRUNTIME_FUNCTION(mFunctionInfoData);
-    auto totalCount = mFunctionInfoSize / sizeof(RUNTIME_FUNCTION);
-
-    // Enumerate each entry
-    for(duint i = 0; i < totalCount; i++)
-    {
-        if(!Callback(&functionTable[i]))
-            break;
-    }
+    FunctionBatchAdd(mFunctions, false);
 }
-#endif // _WIN64
\ No newline at end of file
@@ -2,7 +2,6 @@
 #define _EXCEPTIONDIRECTORYANALYSIS_H
 
 #include "analysis.h"
-#include <functional>
 
 class ExceptionDirectoryAnalysis : public Analysis
 {
@@ -17,10 +16,6 @@ private:
     duint mFunctionInfoSize;
     void* mFunctionInfoData;
     std::vector<std::pair<duint, duint>> mFunctions;
-
-#ifdef _WIN64
-    void EnumerateFunctionRuntimeEntries64(const std::function<bool(PRUNTIME_FUNCTION)> & Callback) const;
-#endif // _WIN64
 };
 
 #endif //_EXCEPTIONDIRECTORYANALYSIS_H
\ No newline at end of file
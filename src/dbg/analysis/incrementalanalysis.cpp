@@ -0,0 +1,147 @@
+#include "incrementalanalysis.h"
+#include "linearanalysis.h"
+#include "function.h"
+#include "module.h"
+#include "console.h"
+#include "threading.h"
+#include "addrinfo.h"
+#include <algorithm>
+#include <map>
+
+//Dirty byte ranges as [start, end) virtual address pairs, merged on insert.
+//A range only leads to an incremental run when its region already went
+//through a full pass; without that baseline the function index is too sparse
+//to bound the re-analysis and the full pass runs instead.
+static std::map<duint, duint> dirtyRanges;
+static std::vector<Range> analysedRegions; //[base, base + size) of full passes
+
+void AnalysisDirtyMark(duint Address, duint Size)
+{
+    if(!Size)
+        return;
+    EXCLUSIVE_ACQUIRE(LockAnalysisDirty);
+    auto start = Address;
+    auto end = Address + Size;
+    //swallow every range that overlaps or touches the new one
+    auto itr = dirtyRanges.upper_bound(start);
+    if(itr != dirtyRanges.begin())
+    {
+        --itr;
+        if(itr->second < start)
+            ++itr;
+    }
+    while(itr != dirtyRanges.end() && itr->first <= end)
+    {
+        start = min(start, itr->first);
+        end = max(end, itr->second);
+        itr = dirtyRanges.erase(itr);
+    }
+    dirtyRanges[start] = end;
+}
+
+void AnalysisDirtyClear()
+{
+    EXCLUSIVE_ACQUIRE(LockAnalysisDirty);
+    dirtyRanges.clear();
+    analysedRegions.clear();
+}
+
+void AnalysisMarkAnalysed(duint Base, duint Size)
+{
+    EXCLUSIVE_ACQUIRE(LockAnalysisDirty);
+    //a full pass covered whatever dirt the region had
+    auto end = Base + Size;
+    for(auto itr = dirtyRanges.begin(); itr != dirtyRanges.end();)
+    {
+        if(itr->first < end && itr->second > Base)
+            itr = dirtyRanges.erase(itr);
+        else
+            ++itr;
+    }
+    for(const auto & region : analysedRegions)
+    {
+        if(region.first == Base && region.second == end)
+            return;
+    }
+    analysedRegions.push_back(Range(Base, end));
+}
+
+bool AnalysisTryIncremental(duint Base, duint Size)
+{
+    auto regionEnd = Base + Size;
+    std::vector<Range> work;
+    {
+        EXCLUSIVE_ACQUIRE(LockAnalysisDirty);
+        auto analysed = false;
+        for(const auto & region : analysedRegions)
+        {
+            if(region.first <= Base && region.second >= regionEnd)
+            {
+                analysed = true;
+                break;
+            }
+        }
+        if(!analysed)
+            return false;
+        for(auto itr = dirtyRanges.begin(); itr != dirtyRanges.end();)
+        {
+            if(itr->first < regionEnd && itr->second > Base)
+            {
+                work.push_back(Range(max(itr->first, Base), min(itr->second, regionEnd)));
+                itr = dirtyRanges.erase(itr);
+            }
+            else
+                ++itr;
+        }
+    }
+    if(work.empty())
+        return false; //nothing dirty, let the full pass run
+
+    //widen each range to the functions it overlaps, so the re-analysis window
+    //covers every function a patch could have reshaped; padding covers bytes
+    //that were not inside a known function
+    for(auto & range : work)
+    {
+        duint functionStart = 0, functionEnd = 0;
+        if(FunctionGet(range.first, &functionStart, nullptr))
+            range.first = min(range.first, functionStart);
+        else
+            range.first -= min(range.first - Base, duint(64));
+        if(FunctionGet(range.second - 1, nullptr, &functionEnd))
+            range.second = max(range.second, functionEnd + 1);
+        else
+            range.second = min(range.second + 64, regionEnd);
+    }
+    std::sort(work.begin(), work.end());
+    std::vector<Range> merged;
+    for(const auto & range : work)
+    {
+        if(!merged.empty() && range.first <= merged.back().second)
+            merged.back().second = max(merged.back().second, range.second);
+        else
+            merged.push_back(range);
+    }
+
+    //entries of functions already known inside the windows, so functions only
+    //referenced from outside a window survive its marker rebuild
+    std::vector<FUNCTIONSINFO> functionList;
+    FunctionGetList(functionList);
+
+    auto ticks = GetTickCount();
+    duint totalBytes = 0;
+    for(const auto & range : merged)
+    {
+        LinearAnalysis anal(range.first, range.second - range.first);
+        for(const auto & function : functionList)
+        {
+            auto start = function.start + ModBaseFromName(function.mod().c_str());
+            if(start >= range.first && start < range.second)
+                anal.AddFunctionEntry(start);
+        }
+        anal.Analyse();
+        anal.SetMarkers();
+        totalBytes += range.second - range.first;
+    }
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Incremental analysis: %u dirty bytes in %d windows re-analysed in %ums\n"), DWORD(totalBytes), int(merged.size()), GetTickCount() - ticks);
+    return true;
+}
@@ -0,0 +1,14 @@
+#ifndef _INCREMENTALANALYSIS_H
+#define _INCREMENTALANALYSIS_H
+
+#include "_global.h"
+
+//Dirty-range bookkeeping for incremental analysis. Patches mark the bytes
+//they touch, and the next "anal" run re-analyses only the affected functions
+//instead of the whole memory region.
+void AnalysisDirtyMark(duint Address, duint Size);
+void AnalysisDirtyClear();
+void AnalysisMarkAnalysed(duint Base, duint Size);
+bool AnalysisTryIncremental(duint Base, duint Size);
+
+#endif //_INCREMENTALANALYSIS_H
@@ -31,6 +31,14 @@ void LinearAnalysis::SetMarkers()
     }
 }
 
+void LinearAnalysis::AddFunctionEntry(duint start)
+{
+    //seeded entries are sorted and deduplicated together with the scanned
+    //references once Analyse runs
+    if(start >= mBase && start < mBase + mSize)
+        mFunctions.push_back({ start, 0 });
+}
+
 void LinearAnalysis::sortCleanup()
 {
     //sort & remove duplicates
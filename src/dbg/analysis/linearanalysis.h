@@ -10,6 +10,7 @@ public:
     explicit LinearAnalysis(duint base, duint size);
     void Analyse() override;
     void SetMarkers() override;
+    void AddFunctionEntry(duint start); //seed an entry before Analyse
 
 private:
     struct FunctionInfo
@@ -1,5 +1,7 @@
 #include "recursiveanalysis.h"
 #include <queue>
+#include <mutex>
+#include <ppl.h>
 #include "console.h"
 #include "filehelper.h"
 #include "function.h"
@@ -20,9 +22,45 @@ RecursiveAnalysis::RecursiveAnalysis(duint base, duint size, duint entryPoint, b
 
 void RecursiveAnalysis::Analyse()
 {
-    //TODO: implement queue to analyze multiple functions
-    analyzeFunction(mEntryPoint);
-    analyzeLoops(mEntryPoint);
+    if(!mFollowCalls)
+    {
+        std::vector<duint> callTargets; //discarded, only the entry function is wanted
+        mFunctions.emplace(mEntryPoint, analyzeFunction(mEntryPoint, mCp, mXrefs, callTargets));
+        analyzeLoops(mEntryPoint);
+        return;
+    }
+
+    //function discovery is naturally parallel: every frontier entry owns the
+    //CFG construction of one function on its own Zydis instance, and the
+    //direct call targets it finds form the next frontier after deduplication
+    UintSet discovered;
+    discovered.insert(mEntryPoint);
+    std::vector<duint> frontier;
+    frontier.push_back(mEntryPoint);
+    std::mutex resultMutex;
+    while(!frontier.empty())
+    {
+        std::vector<std::vector<duint>> callTargets(frontier.size());
+        concurrency::parallel_for(size_t(0), frontier.size(), [&](size_t i)
+        {
+            Zydis cp;
+            std::vector<XREF> xrefs;
+            auto graph = analyzeFunction(frontier.at(i), cp, xrefs, callTargets.at(i));
+            std::lock_guard<std::mutex> lock(resultMutex);
+            mFunctions.emplace(frontier.at(i), std::move(graph));
+            mXrefs.insert(mXrefs.end(), xrefs.begin(), xrefs.end());
+        });
+
+        std::vector<duint> nextFrontier;
+        for(const auto & targets : callTargets)
+            for(auto target : targets)
+                if(discovered.insert(target).second)
+                    nextFrontier.push_back(target);
+        frontier = std::move(nextFrontier);
+    }
+
+    for(const auto & function : mFunctions)
+        analyzeLoops(function.first);
 }
 
 void RecursiveAnalysis::SetMarkers()
@@ -137,13 +175,16 @@ void RecursiveAnalysis::SetMarkers()
     }
 
     //set xrefs
+    std::vector<XREF_EDGE> edges;
+    edges.reserve(mXrefs.size());
     for(const auto & xref : mXrefs)
-        XrefAdd(xref.addr, xref.from);
+        edges.push_back({ xref.addr, xref.from, XREF_NONE });
+    XrefAddMulti(edges.data(), edges.size());
 
     GuiUpdateAllViews();
 }
 
-void RecursiveAnalysis::analyzeFunction(duint entryPoint)
+RecursiveAnalysis::CFGraph RecursiveAnalysis::analyzeFunction(duint entryPoint, Zydis & cp, std::vector<XREF> & xrefs, std::vector<duint> & callTargets)
 {
     //first pass: BFS through the disassembly starting at entryPoint
     CFGraph graph(entryPoint);
@@ -170,14 +211,14 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
         {
             if(!inRange(node.end))
             {
-                node.end = mCp.Address();
+                node.end = cp.Address();
                 node.terminal = true;
                 graph.AddNode(node);
                 break;
             }
 
             node.icount++;
-            if(!mCp.Disassemble(node.end, translateAddr(node.end)))
+            if(!cp.Disassemble(node.end, translateAddr(node.end)))
             {
                 node.end++;
                 continue;
@@ -186,10 +227,10 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
             //do xref analysis on the instruction
             XREF xref;
             xref.addr = 0;
-            xref.from = mCp.Address();
-            for(auto i = 0; i < mCp.OpCount(); i++)
+            xref.from = cp.Address();
+            for(auto i = 0; i < cp.OpCount(); i++)
             {
-                duint dest = mCp.ResolveOpValue(i, [](ZydisRegister)->size_t
+                duint dest = cp.ResolveOpValue(i, [](ZydisRegister)->size_t
                 {
                     return 0;
                 });
@@ -200,25 +241,25 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
                 }
             }
             if(xref.addr)
-                mXrefs.push_back(xref);
+                xrefs.push_back(xref);
 
-            if(!mCp.IsNop() && (mCp.IsJump() || mCp.IsLoop())) //non-nop jump
+            if(!cp.IsNop() && (cp.IsJump() || cp.IsLoop())) //non-nop jump
             {
                 //set the branch destinations
-                node.brtrue = mCp.BranchDestination();
-                if(mCp.GetId() != ZYDIS_MNEMONIC_JMP) //unconditional jumps dont have a brfalse
-                    node.brfalse = node.end + mCp.Size();
+                node.brtrue = cp.BranchDestination();
+                if(cp.GetId() != ZYDIS_MNEMONIC_JMP) //unconditional jumps dont have a brfalse
+                    node.brfalse = node.end + cp.Size();
 
                 //consider register/memory branches as terminal nodes
-                if(mCp.OpCount() && mCp[0].type != ZYDIS_OPERAND_TYPE_IMMEDIATE)
+                if(cp.OpCount() && cp[0].type != ZYDIS_OPERAND_TYPE_IMMEDIATE)
                 {
                     //jmp ptr [index * sizeof(duint) + switchTable]
-                    if(mCp[0].type == ZYDIS_OPERAND_TYPE_MEMORY && mCp[0].mem.base == ZYDIS_REGISTER_NONE && mCp[0].mem.index != ZYDIS_REGISTER_NONE
-                            && mCp[0].mem.scale == sizeof(duint) && MemIsValidReadPtr(duint(mCp[0].mem.disp.value)))
+                    if(cp[0].type == ZYDIS_OPERAND_TYPE_MEMORY && cp[0].mem.base == ZYDIS_REGISTER_NONE && cp[0].mem.index != ZYDIS_REGISTER_NONE
+                            && cp[0].mem.scale == sizeof(duint) && MemIsValidReadPtr(duint(cp[0].mem.disp.value)))
                     {
                         Memory<duint*> switchTable(512 * sizeof(duint));
                         duint actualSize, index;
-                        MemRead(duint(mCp[0].mem.disp.value), switchTable(), 512 * sizeof(duint), &actualSize);
+                        MemRead(duint(cp[0].mem.disp.value), switchTable(), 512 * sizeof(duint), &actualSize);
                         actualSize /= sizeof(duint);
                         for(index = 0; index < actualSize; index++)
                             if(MemIsCodePage(switchTable()[index], false) == false)
@@ -233,7 +274,7 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
                                 node.exits.push_back(switchTable()[index]);
                                 queue.emplace(switchTable()[index]);
                                 xref.addr = switchTable()[index];
-                                mXrefs.push_back(xref);
+                                xrefs.push_back(xref);
                             }
                         }
                         else
@@ -254,17 +295,23 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
 
                 break;
             }
-            if(mCp.IsCall())
+            if(cp.IsCall())
             {
-                //TODO: add this to a queue to be analyzed later
+                //queue direct call destinations so the whole call tree can be analyzed
+                if(cp.OpCount() && cp[0].type == ZYDIS_OPERAND_TYPE_IMMEDIATE)
+                {
+                    auto dest = duint(cp.BranchDestination());
+                    if(inRange(dest))
+                        callTargets.push_back(dest);
+                }
             }
-            if(mCp.IsRet())
+            if(cp.IsRet())
             {
                 node.terminal = true;
                 graph.AddNode(node);
                 break;
             }
-            node.end += mCp.Size();
+            node.end += cp.Size();
         }
     }
     //second pass: split overlapping blocks introduced by backedges
@@ -276,7 +323,7 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
         while(addr < node.end)
         {
             icount++;
-            auto size = mCp.Disassemble(addr, translateAddr(addr)) ? mCp.Size() : 1;
+            auto size = cp.Disassemble(addr, translateAddr(addr)) ? cp.Size() : 1;
             if(graph.nodes.count(addr + size))
             {
                 node.end = addr;
@@ -309,10 +356,10 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
         auto addr = node.start;
         while(addr <= node.end) //disassemble all instructions
         {
-            auto size = mCp.Disassemble(addr, translateAddr(addr)) ? mCp.Size() : 1;
-            if(mCp.IsCall() && mCp.OpCount()) //call reg / call [reg+X]
+            auto size = cp.Disassemble(addr, translateAddr(addr)) ? cp.Size() : 1;
+            if(cp.IsCall() && cp.OpCount()) //call reg / call [reg+X]
             {
-                auto & op = mCp[0];
+                auto & op = cp[0];
                 switch(op.type)
                 {
                 case ZYDIS_OPERAND_TYPE_REGISTER:
@@ -337,12 +384,15 @@ void RecursiveAnalysis::analyzeFunction(duint entryPoint)
     //fourth pass: allow plugins to manipulate the graph
     if(mUsePlugins && !plugincbempty(CB_ANALYZE))
     {
+        //plugins don't expect concurrent analysis callbacks
+        static std::mutex pluginMutex;
+        std::lock_guard<std::mutex> lock(pluginMutex);
         PLUG_CB_ANALYZE info;
         info.graph = graph.ToGraphList();
         plugincbcall(CB_ANALYZE, &info);
         graph = BridgeCFGraph(&info.graph, true);
     }
-    mFunctions.emplace(entryPoint, graph);
+    return graph;
 }
 
 void RecursiveAnalysis::analyzeLoops(duint entryPoint)
@@ -9,6 +9,12 @@ public:
     void Analyse() override;
     void SetMarkers() override;
 
+    //also analyze the direct call targets discovered while building each CFG
+    void SetFollowCalls(bool followCalls)
+    {
+        mFollowCalls = followCalls;
+    }
+
     using UintSet = std::unordered_set<duint>;
 
     template<class T>
@@ -82,6 +88,7 @@ protected:
 private:
     bool mUsePlugins;
     bool mDump;
+    bool mFollowCalls = false;
 
     struct XREF
     {
@@ -100,7 +107,7 @@ private:
 
     std::unordered_map<duint, LoopInfo> mLoopInfo;
 
-    void analyzeFunction(duint entryPoint);
+    CFGraph analyzeFunction(duint entryPoint, Zydis & cp, std::vector<XREF> & xrefs, std::vector<duint> & callTargets);
     void analyzeLoops(duint entryPoint);
     void dominatorAnalysis(duint entryPoint);
 };
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "xrefsanalysis.h"
+#include "AnalysisScheduler.h"
 #include "xrefs.h"
 #include "console.h"
 #include <module.h>
+#include <algorithm>
 
 XrefsAnalysis::XrefsAnalysis(duint base, duint size)
     : Analysis(base, size)
@@ -15,33 +17,69 @@ void XrefsAnalysis::Analyse()
     dputs("Starting xref analysis...");
     auto ticks = GetTickCount();
 
-    for(auto addr = mBase; addr < mBase + mSize;)
+    // Chunked scan on the work-stealing scheduler; each chunk decodes with
+    // its own Zydis instance into a local vector and the results are merged
+    duint chunkCount = AnalysisChunkCount(mSize, AnalysisIdealThreadCount(), 0x10000);
+    auto chunkXrefs = new std::vector<XREF>[chunkCount];
+
+    AnalysisDispatchChunks(mSize, chunkCount, [&](duint i, duint start, duint stop)
     {
-        if(!mCp.Disassemble(addr, translateAddr(addr)))
+        Zydis cp;
+        duint chunkStart = mBase + start;
+        duint chunkStop = mBase + stop;
+
+        // Allow a 256-byte variance because chunks can start in the middle
+        // of an instruction; duplicates are removed after the merge
+        if(chunkStart > mBase)
         {
-            addr++;
-            continue;
+            chunkStart = max(chunkStart - 256, mBase);
+            chunkStop = min(chunkStop + 256, mBase + mSize);
         }
-        addr += mCp.Size();
 
-        XREF xref;
-        xref.addr = 0;
-        xref.from = mCp.Address();
-        for(auto i = 0; i < mCp.OpCount(); i++)
+        for(auto addr = chunkStart; addr < chunkStop;)
         {
-            duint dest = mCp.ResolveOpValue(i, [](ZydisRegister)->size_t
+            if(!cp.Disassemble(addr, translateAddr(addr)))
             {
-                return 0;
-            });
-            if(inModRange(dest))
+                addr++;
+                continue;
+            }
+            addr += cp.Size();
+
+            XREF xref;
+            xref.addr = 0;
+            xref.from = cp.Address();
+            for(auto j = 0; j < cp.OpCount(); j++)
             {
-                xref.addr = dest;
-                break;
+                duint dest = cp.ResolveOpValue(j, [](ZydisRegister)->size_t
+                {
+                    return 0;
+                });
+                if(inModRange(dest))
+                {
+                    xref.addr = dest;
+                    break;
+                }
             }
+            if(xref.addr)
+                chunkXrefs[i].push_back(xref);
         }
-        if(xref.addr)
-            mXrefs.push_back(xref);
-    }
+    });
+
+    // Merge, sort and remove the duplicates from the chunk overlap
+    for(duint i = 0; i < chunkCount; i++)
+        std::move(chunkXrefs[i].begin(), chunkXrefs[i].end(), std::back_inserter(mXrefs));
+    delete[] chunkXrefs;
+
+    auto xrefLess = [](const XREF & a, const XREF & b)
+    {
+        return a.addr < b.addr || (a.addr == b.addr && a.from < b.from);
+    };
+    auto xrefEqual = [](const XREF & a, const XREF & b)
+    {
+        return a.addr == b.addr && a.from == b.from;
+    };
+    std::sort(mXrefs.begin(), mXrefs.end(), xrefLess);
+    mXrefs.erase(std::unique(mXrefs.begin(), mXrefs.end(), xrefEqual), mXrefs.end());
 
     dprintf("%u xrefs found in %ums!\n", DWORD(mXrefs.size()), GetTickCount() - ticks);
 }
@@ -49,6 +87,9 @@ void XrefsAnalysis::Analyse()
 void XrefsAnalysis::SetMarkers()
 {
     XrefDelRange(mBase, mBase + mSize - 1);
+    std::vector<XREF_EDGE> edges;
+    edges.reserve(mXrefs.size());
     for(const auto & xref : mXrefs)
-        XrefAdd(xref.addr, xref.from);
+        edges.push_back({ xref.addr, xref.from, XREF_NONE });
+    XrefAddMulti(edges.data(), edges.size());
 }
@@ -81,7 +81,7 @@ bool ArgumentAdd(duint Start, duint End, bool Manual, duint InstructionCount)
 bool ArgumentGet(duint Address, duint* Start, duint* End, duint* InstrCount)
 {
     ARGUMENTSINFO argument;
-    if(!arguments.Get(Arguments::VaKey(Address, Address), argument))
+    if(!arguments.GetIndexed(Arguments::VaKey(Address, Address), argument))
         return false;
     arguments.AdjustValue(argument);
     if(Start)
@@ -98,7 +98,7 @@ bool ArgumentOverlaps(duint Start, duint End)
     // A argument can't end before it begins
     if(Start > End)
         return false;
-    return arguments.Contains(Arguments::VaKey(Start, End));
+    return arguments.ContainsIndexed(Arguments::VaKey(Start, End));
 }
 
 bool ArgumentDelete(duint Address)
@@ -157,7 +157,7 @@ void ArgumentGetList(std::vector<ARGUMENTSINFO> & list)
 
 bool ArgumentGetInfo(duint Address, ARGUMENTSINFO & info)
 {
-    return arguments.Get(Arguments::VaKey(Address, Address), info);
+    return arguments.GetIndexed(Arguments::VaKey(Address, Address), info);
 }
 
 bool ArgumentEnum(ARGUMENTSINFO* List, size_t* Size)
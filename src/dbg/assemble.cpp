@@ -12,9 +12,29 @@
 #include "disasm_helper.h"
 #include "datainst_helper.h"
 #include "debugger.h"
+#include "threading.h"
+#include "stringutils.h"
+#include <unordered_map>
+#include <vector>
 
 AssemblerEngine assemblerEngine = AssemblerEngine::XEDParse;
 
+// Assembled bytes keyed by (address, engine, instruction text). The assemble
+// dialog re-assembles on every keystroke and patch scripts assemble thousands
+// of lines, while the result only changes when the name resolution epoch does
+// (cbUnknown resolves labels and symbols through valfromstring).
+struct AssembleCacheEntry
+{
+    duint epoch;
+    std::vector<unsigned char> dest;
+};
+static std::unordered_map<String, AssembleCacheEntry> assembleCache;
+
+static String assemblecachekey(duint addr, const char* instruction)
+{
+    return StringUtils::sprintf("%p|%d|%s", addr, int(assemblerEngine), instruction);
+}
+
 namespace asmjit
 {
     static XEDPARSE_STATUS XEDParseAssemble(XEDPARSE* XEDParse)
@@ -46,6 +66,21 @@ bool assemble(duint addr, unsigned char* dest, int destsize, int* size, const ch
     }
     if(strlen(instruction) >= XEDPARSE_MAXBUFSIZE)
         return false;
+    auto cacheKey = assemblecachekey(addr, instruction);
+    auto epoch = valnamecacheepoch();
+    {
+        SHARED_ACQUIRE(LockAssembleCache);
+        auto found = assembleCache.find(cacheKey);
+        if(found != assembleCache.end() && found->second.epoch == epoch)
+        {
+            const auto & cached = found->second.dest;
+            if(dest)
+                memcpy(dest, cached.data(), cached.size());
+            if(size)
+                *size = int(cached.size());
+            return true;
+        }
+    }
     XEDPARSE parse;
     memset(&parse, 0, sizeof(parse));
 #ifdef _WIN64
@@ -71,6 +106,13 @@ bool assemble(duint addr, unsigned char* dest, int destsize, int* size, const ch
     if(size)
         *size = parse.dest_size;
 
+    EXCLUSIVE_ACQUIRE(LockAssembleCache);
+    if(assembleCache.size() > 4096) //bound stale entries from previous epochs
+        assembleCache.clear();
+    auto & entry = assembleCache[cacheKey];
+    entry.epoch = epoch;
+    entry.dest.assign(parse.dest, parse.dest + parse.dest_size);
+
     return true;
 }
 
@@ -159,4 +201,67 @@ bool assembleat(duint addr, const char* instruction, int* size, char* error, boo
     }
 
     return ret;
+}
+
+bool assembleatbatch(duint addr, const char* listing, int* size, char* error, bool fillnop)
+{
+    // Assemble every line of the listing at its running address and write the
+    // result with a single memory patch, so a whole patch script costs one
+    // fixup pass and one GUI refresh instead of one per instruction
+    std::vector<unsigned char> buffer;
+    duint runningAddr = addr;
+    int lineNumber = 0;
+    for(const auto & line : StringUtils::Split(listing, '\n'))
+    {
+        lineNumber++;
+        auto instruction = StringUtils::Trim(line);
+        if(instruction.empty())
+            continue;
+        int destSize = 0;
+        Memory<unsigned char*> dest(16 * sizeof(unsigned char), "AssembleBuffer");
+        if(!assemble(runningAddr, dest(), int(dest.size()), &destSize, instruction.c_str(), error))
+        {
+            auto retried = false;
+            if(destSize > int(dest.size()))
+            {
+                dest.realloc(destSize);
+                retried = assemble(runningAddr, dest(), destSize, &destSize, instruction.c_str(), error);
+            }
+            if(!retried)
+            {
+                if(error)
+                {
+                    // Prefix the failing line number so batch callers can locate it
+                    String lineError = StringUtils::sprintf("[%d] %s", lineNumber, error);
+                    strncpy_s(error, MAX_ERROR_SIZE, lineError.c_str(), _TRUNCATE);
+                }
+                return false;
+            }
+        }
+        buffer.insert(buffer.end(), dest(), dest() + destSize);
+        runningAddr += destSize;
+    }
+    if(buffer.empty())
+        return false;
+
+    if(fillnop)
+    {
+        //fill the last partially overwritten instruction with NOPs
+        int origLen = 0;
+        while(origLen < int(buffer.size()))
+            origLen += disasmgetsize(addr + origLen);
+        buffer.insert(buffer.end(), origLen - int(buffer.size()), 0x90);
+    }
+
+    if(size)
+        *size = int(buffer.size());
+
+    if(!MemPatch(addr, buffer.data(), buffer.size()))
+    {
+        if(error)
+            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Error while writing process memory")));
+        return false;
+    }
+    GuiUpdatePatches();
+    return true;
 }
\ No newline at end of file
@@ -14,5 +14,6 @@ extern AssemblerEngine assemblerEngine;
 
 bool assemble(duint addr, unsigned char* dest, int* size, const char* instruction, char* error);
 bool assembleat(duint addr, const char* instruction, int* size, char* error, bool fillnop);
+bool assembleatbatch(duint addr, const char* listing, int* size, char* error, bool fillnop); //listing lines separated by \n
 
 #endif // _ASSEMBLE_H
@@ -1,4 +1,5 @@
 #include "bookmark.h"
+#include "dbjournal.h"
 
 struct BookmarkSerializer : AddrInfoSerializer<BOOKMARKSINFO>
 {
@@ -21,8 +22,16 @@ bool BookmarkSet(duint Address, bool Manual)
         return false;
     auto key = Bookmarks::VaKey(Address);
     if(bookmarks.Contains(key))
-        return bookmarks.Delete(key);
-    return bookmarks.Add(bookmark);
+    {
+        if(!bookmarks.Delete(key))
+            return false;
+        DbJournalDeleteAt("bookmarks", Address);
+        return true;
+    }
+    if(!bookmarks.Add(bookmark))
+        return false;
+    DbJournalAddValue<BookmarkSerializer>("bookmarks", bookmark);
+    return true;
 }
 
 bool BookmarkGet(duint Address)
@@ -32,12 +41,21 @@ bool BookmarkGet(duint Address)
 
 bool BookmarkDelete(duint Address)
 {
-    return bookmarks.Delete(Bookmarks::VaKey(Address));
+    if(!bookmarks.Delete(Bookmarks::VaKey(Address)))
+        return false;
+    DbJournalDeleteAt("bookmarks", Address);
+    return true;
+}
+
+bool BookmarkDeleteByKey(duint Key)
+{
+    return bookmarks.Delete(Key);
 }
 
 void BookmarkDelRange(duint Start, duint End, bool Manual)
 {
     bookmarks.DeleteRange(Start, End, Manual);
+    DbJournalDelRangeAt("bookmarks", Start, End, Manual);
 }
 
 void BookmarkCacheSave(JSON Root)
@@ -11,6 +11,7 @@ struct BOOKMARKSINFO : AddrInfo
 bool BookmarkSet(duint Address, bool Manual);
 bool BookmarkGet(duint Address);
 bool BookmarkDelete(duint Address);
+bool BookmarkDeleteByKey(duint Key);
 void BookmarkDelRange(duint Start, duint End, bool Manual);
 void BookmarkCacheSave(JSON Root);
 void BookmarkCacheLoad(JSON Root);
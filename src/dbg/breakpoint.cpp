@@ -11,11 +11,313 @@
 #include "value.h"
 #include "debugger.h"
 #include "exception.h"
+#include "dbjournal.h"
 #include <algorithm>
+#include <memory>
 
 typedef std::pair<BP_TYPE, duint> BreakpointKey;
 std::map<BreakpointKey, BREAKPOINT> breakpoints;
 
+// Read-optimized snapshot of the breakpoint map. cbException performs a
+// breakpoint lookup on every exception the debuggee raises, and going through
+// BpGet there takes LockBreakpoints and walks a std::map each time, which
+// contends with the GUI refreshing the breakpoint view. The snapshot is a
+// flat linear-probing hash over the same keys, rebuilt under the exclusive
+// lock after every mutation and swapped in atomically, so the event path only
+// pays a probe. The keys are module-hash based like the map, so module
+// load/unload does not invalidate them; only the hit counter (incremented
+// directly on the map entry) can lag behind in a snapshot.
+struct BpIndex
+{
+    struct Entry
+    {
+        bool used = false;
+        BreakpointKey key;
+        BREAKPOINT bp;
+    };
+
+    std::vector<Entry> entries; //power-of-two sized
+
+    static size_t hashKey(const BreakpointKey & key)
+    {
+        auto h = key.second + duint(key.first);
+        h ^= h >> 13;
+#ifdef _WIN64
+        h *= 0x9E3779B97F4A7C15ull;
+        h ^= h >> 31;
+#else
+        h *= 0x9E3779B9u;
+        h ^= h >> 16;
+#endif //_WIN64
+        return size_t(h);
+    }
+
+    void insert(const BreakpointKey & key, const BREAKPOINT & bp)
+    {
+        auto mask = entries.size() - 1;
+        for(auto i = hashKey(key) & mask; ; i = (i + 1) & mask)
+        {
+            if(!entries[i].used)
+            {
+                entries[i].used = true;
+                entries[i].key = key;
+                entries[i].bp = bp;
+                return;
+            }
+        }
+    }
+
+    const BREAKPOINT* find(const BreakpointKey & key) const
+    {
+        if(entries.empty())
+            return nullptr;
+        auto mask = entries.size() - 1;
+        for(auto i = hashKey(key) & mask; entries[i].used; i = (i + 1) & mask)
+        {
+            if(entries[i].key == key)
+                return &entries[i].bp;
+        }
+        return nullptr;
+    }
+};
+
+static std::shared_ptr<const BpIndex> bpIndexSnapshot;
+
+// Watched sub-ranges of memory breakpoints, consulted on every guard page
+// fault to re-execute unrelated accesses without any breakpoint bookkeeping.
+// Flat table rebuilt together with the index, read lock-free.
+struct MemBpWatch
+{
+    duint regionStart;
+    duint regionEnd;
+    duint watchStart;
+    duint watchEnd;
+};
+
+static std::shared_ptr<const std::vector<MemBpWatch>> memBpWatchSnapshot;
+
+// Bumped by BpRebuildIndex, the choke point of every map mutation
+static std::atomic<duint> bpGeneration;
+
+// Journals a snapshot of the whole (small) breakpoint table once the guarded
+// mutator finished. Individual breakpoints have too many mutable fields for
+// per-field journal deltas, so the last snapshot in the journal wins on
+// replay. Declare before EXCLUSIVE_ACQUIRE: destruction runs in reverse
+// order, so the snapshot is taken after the lock is released (BpCacheSave
+// takes the lock itself and SRW locks are not reentrant).
+class BpJournalGuard
+{
+public:
+    BpJournalGuard()
+        : mGeneration(bpGeneration.load())
+    {
+    }
+
+    ~BpJournalGuard()
+    {
+        if(BpBatchActive() || mGeneration == bpGeneration.load() || !DbJournalActive())
+            return;
+        auto root = json_object();
+        BpCacheSave(root);
+        DbJournalBpSnapshot(root);
+        json_decref(root);
+    }
+
+private:
+    duint mGeneration;
+};
+
+// Batched breakpoint mutations (bpbatch command, Script::Debug). While a
+// batch is open BpRebuildIndex only bumps the generation and marks the
+// snapshots stale, the journal guard stays quiet and the GUI refreshes are
+// suppressed; BpBatchEnd publishes everything once. The event-path snapshot
+// keeps serving the pre-batch state until the batch commits.
+static std::atomic<int> bpBatchDepth;
+static duint bpBatchStartGen = 0;
+static bool bpBatchDirty = false; //protected by LockBreakpoints
+static std::atomic<bool> bpBatchHwPending(false);
+
+bool BpBatchActive()
+{
+    return bpBatchDepth.load() > 0;
+}
+
+void BpBatchDeferHardware()
+{
+    bpBatchHwPending.store(true);
+}
+
+// Lock-free hit tally for counting-only breakpoints. cbGenericBreakpoint
+// bumps a slot here instead of taking LockBreakpoints when a breakpoint
+// exists purely to count hits (see BpIsCountingOnly), so a hot path can be
+// sampled at millions of hits per second without serializing every hit
+// against the GUI. Slots are claimed by the debug event thread (the single
+// writer) and the tallies are folded back into the map entries under the
+// exclusive lock whenever the counts are read or the table mutates.
+struct BpHitCountSlot
+{
+    std::atomic<duint> key; //BpInfoFromAddr-style key, 0 = free
+    std::atomic<int> type;
+    std::atomic<uint32> count;
+};
+static BpHitCountSlot bpHitCountSlots[256];
+static std::atomic<bool> bpHitCountsPending;
+
+bool BpIsCountingOnly(const BREAKPOINT & Bp)
+{
+    // A breakpoint that fast resumes on a constant-false break condition and
+    // has nothing to log or execute exists purely to count hits
+    return Bp.fastResume && !Bp.singleshoot &&
+           strcmp(Bp.breakCondition, "0") == 0 &&
+           *Bp.logText == '\0' && *Bp.commandText == '\0';
+}
+
+bool BpHitCountIncFast(BP_TYPE Type, duint Address)
+{
+    duint key;
+    if(Type != BPDLL && Type != BPEXCEPTION)
+        key = ModHashFromAddr(Address);
+    else
+        key = Address;
+    if(!key)
+        return false;
+
+    const auto mask = _countof(bpHitCountSlots) - 1;
+    auto i = BpIndex::hashKey(BreakpointKey(Type, key)) & mask;
+    for(size_t probe = 0; probe < _countof(bpHitCountSlots); probe++, i = (i + 1) & mask)
+    {
+        auto & slot = bpHitCountSlots[i];
+        auto slotKey = slot.key.load(std::memory_order_relaxed);
+        if(slotKey == 0)
+        {
+            // Claim a fresh slot: publish the key last so a folder that sees
+            // it also sees the type and count
+            slot.type.store(Type, std::memory_order_relaxed);
+            slot.count.store(1, std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_release);
+            bpHitCountsPending.store(true, std::memory_order_release);
+            return true;
+        }
+        if(slotKey == key && slot.type.load(std::memory_order_relaxed) == Type)
+        {
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            bpHitCountsPending.store(true, std::memory_order_release);
+            return true;
+        }
+    }
+    return false; //table full, take the locked path
+}
+
+// Requires the exclusive breakpoint lock
+static void bpFoldHitCounts()
+{
+    if(!bpHitCountsPending.load(std::memory_order_acquire))
+        return;
+    bpHitCountsPending.store(false, std::memory_order_relaxed);
+    for(auto & slot : bpHitCountSlots)
+    {
+        auto key = slot.key.load(std::memory_order_acquire);
+        if(!key)
+            continue;
+        auto count = slot.count.exchange(0, std::memory_order_relaxed);
+        auto found = breakpoints.find(BreakpointKey(BP_TYPE(slot.type.load(std::memory_order_relaxed)), key));
+        if(found != breakpoints.end())
+            found->second.hitcount += count;
+        else
+            slot.key.store(0, std::memory_order_release); //breakpoint deleted, free the slot
+    }
+}
+
+// Requires the exclusive breakpoint lock, call after every map mutation
+static void BpRebuildIndex()
+{
+    bpFoldHitCounts();
+    bpGeneration++;
+    if(BpBatchActive())
+    {
+        bpBatchDirty = true;
+        return;
+    }
+    auto index = std::make_shared<BpIndex>();
+    size_t capacity = 16;
+    while(capacity < breakpoints.size() * 2)
+        capacity *= 2;
+    index->entries.resize(capacity);
+    for(const auto & i : breakpoints)
+        index->insert(i.first, i.second);
+    std::atomic_store(&bpIndexSnapshot, std::shared_ptr<const BpIndex>(std::move(index)));
+
+    auto watches = std::make_shared<std::vector<MemBpWatch>>();
+    for(const auto & i : breakpoints)
+    {
+        const auto & bp = i.second;
+        // Single-shot breakpoints are excluded: TitanEngine does not restore
+        // their page protection after a fault, so a rejected fault would
+        // silently consume them.
+        if(bp.type != BPMEMORY || !bp.enabled || !bp.watchSize || !bp.memsize || bp.singleshoot)
+            continue;
+        MemBpWatch watch;
+        watch.regionStart = bp.addr + ModBaseFromName(bp.mod);
+        watch.regionEnd = watch.regionStart + bp.memsize;
+        watch.watchStart = watch.regionStart + bp.watchOffset;
+        watch.watchEnd = watch.watchStart + bp.watchSize;
+        watches->push_back(watch);
+    }
+    std::atomic_store(&memBpWatchSnapshot, std::shared_ptr<const std::vector<MemBpWatch>>(std::move(watches)));
+}
+
+bool BpMemRejectFault(duint Address)
+{
+    auto watches = std::atomic_load(&memBpWatchSnapshot);
+    if(!watches)
+        return false;
+    for(const auto & watch : *watches)
+        if(Address >= watch.regionStart && Address < watch.regionEnd)
+            return Address < watch.watchStart || Address >= watch.watchEnd;
+    return false;
+}
+
+void BpBatchBegin()
+{
+    if(bpBatchDepth.fetch_add(1) == 0)
+    {
+        bpBatchStartGen = bpGeneration.load();
+        GuiUpdateDisable();
+    }
+}
+
+void BpBatchEnd()
+{
+    if(bpBatchDepth.load() <= 0)
+        return;
+    if(bpBatchDepth.fetch_sub(1) != 1)
+        return;
+
+    {
+        EXCLUSIVE_ACQUIRE(LockBreakpoints);
+        if(bpBatchDirty)
+        {
+            bpBatchDirty = false;
+            BpRebuildIndex();
+        }
+    }
+
+    // One debug register pass for the whole batch
+    if(bpBatchHwPending.exchange(false))
+        dbgreconcilehwbps();
+
+    // One journal snapshot for the whole batch
+    if(bpGeneration.load() != bpBatchStartGen && DbJournalActive())
+    {
+        auto root = json_object();
+        BpCacheSave(root);
+        DbJournalBpSnapshot(root);
+        json_decref(root);
+    }
+
+    GuiUpdateEnable(true);
+}
+
 static void setBpActive(BREAKPOINT & bp)
 {
     // DLL/Exception breakpoints are always enabled
@@ -61,6 +363,12 @@ BREAKPOINT* BpInfoFromAddr(BP_TYPE Type, duint Address)
 
 int BpGetList(std::vector<BREAKPOINT>* List)
 {
+    if(bpHitCountsPending.load(std::memory_order_acquire))
+    {
+        EXCLUSIVE_ACQUIRE(LockBreakpoints);
+        bpFoldHitCounts();
+    }
+
     SHARED_ACQUIRE(LockBreakpoints);
 
     // Did the caller request an output?
@@ -86,7 +394,7 @@ int BpGetList(std::vector<BREAKPOINT>* List)
     return (int)breakpoints.size();
 }
 
-bool BpNew(duint Address, bool Enable, bool Singleshot, short OldBytes, BP_TYPE Type, DWORD TitanType, const char* Name, duint memsize)
+bool BpNew(duint Address, bool Enable, bool Singleshot, short OldBytes, BP_TYPE Type, DWORD TitanType, const char* Name, duint memsize, duint watchOffset, duint watchSize)
 {
     ASSERT_DEBUGGING("Export call");
 
@@ -125,18 +433,20 @@ bool BpNew(duint Address, bool Enable, bool Singleshot, short OldBytes, BP_TYPE
     bp.titantype = TitanType;
     bp.type = Type;
     bp.memsize = memsize;
+    bp.watchOffset = watchOffset;
+    bp.watchSize = watchSize;
 
     // Insert new entry to the global list
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
+    bool inserted;
     if(Type != BPDLL && Type != BPEXCEPTION)
-    {
-        return breakpoints.insert(std::make_pair(BreakpointKey(Type, ModHashFromAddr(Address)), bp)).second;
-    }
+        inserted = breakpoints.insert(std::make_pair(BreakpointKey(Type, ModHashFromAddr(Address)), bp)).second;
     else
-    {
-        return breakpoints.insert(std::make_pair(BreakpointKey(Type, Address), bp)).second;
-    }
+        inserted = breakpoints.insert(std::make_pair(BreakpointKey(Type, Address), bp)).second;
+    BpRebuildIndex();
+    return inserted;
 }
 
 bool BpNewDll(const char* module, bool Enable, bool Singleshot, DWORD TitanType, const char* Name)
@@ -157,9 +467,12 @@ bool BpNewDll(const char* module, bool Enable, bool Singleshot, DWORD TitanType,
     bp.addr = BpGetDLLBpAddr(module);
 
     // Insert new entry to the global list
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
-    return breakpoints.insert(std::make_pair(BreakpointKey(BPDLL, bp.addr), bp)).second;
+    bool inserted = breakpoints.insert(std::make_pair(BreakpointKey(BPDLL, bp.addr), bp)).second;
+    BpRebuildIndex();
+    return inserted;
 }
 
 bool BpGet(duint Address, BP_TYPE Type, const char* Name, BREAKPOINT* Bp)
@@ -287,9 +600,38 @@ bool BpGetAny(BP_TYPE Type, const char* Name, BREAKPOINT* Bp)
     return false;
 }
 
+bool BpGetFast(duint Address, BP_TYPE Type, BREAKPOINT* Bp)
+{
+    // Lock-free address lookup against the current index snapshot, for the
+    // debug event path. Falls back to BpGet before the first rebuild.
+    auto index = std::atomic_load(&bpIndexSnapshot);
+    if(!index)
+        return BpGet(Address, Type, nullptr, Bp);
+
+    duint key;
+    if(Type != BPDLL && Type != BPEXCEPTION)
+        key = ModHashFromAddr(Address);
+    else
+        key = Address;
+
+    auto found = index->find(BreakpointKey(Type, key));
+    if(!found)
+        return false;
+
+    if(Bp)
+    {
+        *Bp = *found;
+        if(found->type != BPDLL && found->type != BPEXCEPTION)
+            Bp->addr += ModBaseFromAddr(Address);
+        setBpActive(*Bp);
+    }
+    return true;
+}
+
 bool BpUpdateDllPath(const char* module1, BREAKPOINT** newBpInfo)
 {
     const char* dashPos1 = max(strrchr(module1, '\\'), strrchr(module1, '/'));
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
     for(auto & i : breakpoints)
     {
@@ -306,6 +648,7 @@ bool BpUpdateDllPath(const char* module1, BREAKPOINT** newBpInfo)
                 breakpoints.erase(i.first);
                 auto newItem = breakpoints.insert(std::make_pair(BreakpointKey(BPDLL, temp.addr), temp));
                 *newBpInfo = &newItem.first->second;
+                BpRebuildIndex();
                 return true;
             }
             const char* dashPos = max(strrchr(bpRef.mod, '\\'), strrchr(bpRef.mod, '/'));
@@ -323,6 +666,7 @@ bool BpUpdateDllPath(const char* module1, BREAKPOINT** newBpInfo)
                 breakpoints.erase(i.first);
                 auto newItem = breakpoints.insert(std::make_pair(BreakpointKey(BPDLL, temp.addr), temp));
                 *newBpInfo = &newItem.first->second;
+                BpRebuildIndex();
                 return true;
             }
         }
@@ -344,18 +688,23 @@ duint BpGetDLLBpAddr(const char* fileName)
 bool BpDelete(duint Address, BP_TYPE Type)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Erase the index from the global list
+    bool erased;
     if(Type != BPDLL)
-        return (breakpoints.erase(BreakpointKey(Type, ModHashFromAddr(Address))) > 0);
+        erased = breakpoints.erase(BreakpointKey(Type, ModHashFromAddr(Address))) > 0;
     else
-        return (breakpoints.erase(BreakpointKey(BPDLL, Address)) > 0);
+        erased = breakpoints.erase(BreakpointKey(BPDLL, Address)) > 0;
+    BpRebuildIndex();
+    return erased;
 }
 
 bool BpEnable(duint Address, BP_TYPE Type, bool Enable)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Check if the breakpoint exists first
@@ -370,14 +719,19 @@ bool BpEnable(duint Address, BP_TYPE Type, bool Enable)
     if(Enable && Type == BPNORMAL)
     {
         if(!MemRead(Address, &bpInfo->oldbytes, sizeof(bpInfo->oldbytes)))
+        {
+            BpRebuildIndex();
             return false;
+        }
     }
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetName(duint Address, BP_TYPE Type, const char* Name)
 {
     ASSERT_DEBUGGING("Future(?): This is not used anywhere");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // If a name wasn't supplied, set to nothing
@@ -391,12 +745,14 @@ bool BpSetName(duint Address, BP_TYPE Type, const char* Name)
         return false;
 
     strncpy_s(bpInfo->name, Name, _TRUNCATE);
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetTitanType(duint Address, BP_TYPE Type, int TitanType)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set the TitanEngine type, separate from BP_TYPE
@@ -406,12 +762,14 @@ bool BpSetTitanType(duint Address, BP_TYPE Type, int TitanType)
         return false;
 
     bpInfo->titantype = TitanType;
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetBreakCondition(duint Address, BP_TYPE Type, const char* Condition)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint breakCondition
@@ -421,12 +779,14 @@ bool BpSetBreakCondition(duint Address, BP_TYPE Type, const char* Condition)
         return false;
 
     strncpy_s(bpInfo->breakCondition, Condition, _TRUNCATE);
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetLogText(duint Address, BP_TYPE Type, const char* Log)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint logText
@@ -439,12 +799,14 @@ bool BpSetLogText(duint Address, BP_TYPE Type, const char* Log)
 
     // Make log breakpoints silent (meaning they don't output the default log).
     bpInfo->silent = *Log != '\0';
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetLogCondition(duint Address, BP_TYPE Type, const char* Condition)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint logText
@@ -454,12 +816,14 @@ bool BpSetLogCondition(duint Address, BP_TYPE Type, const char* Condition)
         return false;
 
     strncpy_s(bpInfo->logCondition, Condition, _TRUNCATE);
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetCommandText(duint Address, BP_TYPE Type, const char* Cmd)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint hit command
@@ -469,12 +833,14 @@ bool BpSetCommandText(duint Address, BP_TYPE Type, const char* Cmd)
         return false;
 
     strncpy_s(bpInfo->commandText, Cmd, _TRUNCATE);
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetCommandCondition(duint Address, BP_TYPE Type, const char* Condition)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint hit command
@@ -484,12 +850,14 @@ bool BpSetCommandCondition(duint Address, BP_TYPE Type, const char* Condition)
         return false;
 
     strncpy_s(bpInfo->commandCondition, Condition, _TRUNCATE);
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetFastResume(duint Address, BP_TYPE Type, bool fastResume)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint fast resume
@@ -499,12 +867,14 @@ bool BpSetFastResume(duint Address, BP_TYPE Type, bool fastResume)
         return false;
 
     bpInfo->fastResume = fastResume;
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetSingleshoot(duint Address, BP_TYPE Type, bool singleshoot)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint fast resume
@@ -514,12 +884,14 @@ bool BpSetSingleshoot(duint Address, BP_TYPE Type, bool singleshoot)
         return false;
 
     bpInfo->singleshoot = singleshoot;
+    BpRebuildIndex();
     return true;
 }
 
 bool BpSetSilent(duint Address, BP_TYPE Type, bool silent)
 {
     ASSERT_DEBUGGING("Command function call");
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
     // Set breakpoint fast resume
@@ -529,12 +901,19 @@ bool BpSetSilent(duint Address, BP_TYPE Type, bool silent)
         return false;
 
     bpInfo->silent = silent;
+    BpRebuildIndex();
     return true;
 }
 
 bool BpEnumAll(BPENUMCALLBACK EnumCallback, const char* Module, duint base)
 {
     ASSERT_DEBUGGING("Export call");
+    if(bpHitCountsPending.load(std::memory_order_acquire))
+    {
+        EXCLUSIVE_ACQUIRE(LockBreakpoints);
+        bpFoldHitCounts();
+    }
+
     SHARED_ACQUIRE(LockBreakpoints);
 
     // Loop each entry, executing the user's callback
@@ -607,6 +986,13 @@ int BpGetCount(BP_TYPE Type, bool EnabledOnly)
 
 uint32 BpGetHitCount(duint Address, BP_TYPE Type)
 {
+    if(bpHitCountsPending.load(std::memory_order_acquire))
+    {
+        //fold the pending lock-free tallies into the map entries first
+        EXCLUSIVE_ACQUIRE(LockBreakpoints);
+        bpFoldHitCounts();
+    }
+
     SHARED_ACQUIRE(LockBreakpoints);
 
     BREAKPOINT* bpInfo = BpInfoFromAddr(Type, Address);
@@ -619,14 +1005,19 @@ uint32 BpGetHitCount(duint Address, BP_TYPE Type)
 
 bool BpResetHitCount(duint Address, BP_TYPE Type, uint32 newHitCount)
 {
+    BpJournalGuard journalGuard;
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
 
+    //consume any pending tallies so they do not resurrect after the reset
+    bpFoldHitCounts();
+
     BREAKPOINT* bpInfo = BpInfoFromAddr(Type, Address);
 
     if(!bpInfo)
         return false;
 
     bpInfo->hitcount = newHitCount;
+    BpRebuildIndex();
     return true;
 }
 
@@ -765,6 +1156,7 @@ void BpToBridge(const BREAKPOINT* Bp, BRIDGEBP* BridgeBp)
 void BpCacheSave(JSON Root)
 {
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
+    bpFoldHitCounts();
 
     // Create a JSON array to store each sub-object with a breakpoint
     const JSON jsonBreakpoints = json_array();
@@ -785,7 +1177,14 @@ void BpCacheSave(JSON Root)
         if(breakpoint.type == BPNORMAL) // "Normal" breakpoints save the old data
             json_object_set_new(jsonObj, "oldbytes", json_hex(breakpoint.oldbytes));
         else if(breakpoint.type == BPMEMORY) // Memory breakpoints save the memory size
+        {
             json_object_set_new(jsonObj, "memsize", json_hex(breakpoint.memsize));
+            if(breakpoint.watchSize) // and the watched sub-range when one is set
+            {
+                json_object_set_new(jsonObj, "watchOffset", json_hex(breakpoint.watchOffset));
+                json_object_set_new(jsonObj, "watchSize", json_hex(breakpoint.watchSize));
+            }
+        }
 
         json_object_set_new(jsonObj, "type", json_integer(breakpoint.type));
         json_object_set_new(jsonObj, "titantype", json_hex(breakpoint.titantype));
@@ -839,7 +1238,11 @@ void BpCacheLoad(JSON Root)
         if(breakpoint.type == BPNORMAL)
             breakpoint.oldbytes = (unsigned short)(json_hex_value(json_object_get(value, "oldbytes")) & 0xFFFF);
         else if(breakpoint.type == BPMEMORY)
+        {
             breakpoint.memsize = (duint)json_hex_value(json_object_get(value, "memsize"));
+            breakpoint.watchOffset = (duint)json_hex_value(json_object_get(value, "watchOffset"));
+            breakpoint.watchSize = (duint)json_hex_value(json_object_get(value, "watchSize"));
+        }
         breakpoint.addr = (duint)json_hex_value(json_object_get(value, "address"));
         breakpoint.enabled = json_boolean_value(json_object_get(value, "enabled"));
         breakpoint.titantype = (DWORD)json_hex_value(json_object_get(value, "titantype"));
@@ -872,10 +1275,12 @@ void BpCacheLoad(JSON Root)
         }
         breakpoints[BreakpointKey(breakpoint.type, key)] = breakpoint;
     }
+    BpRebuildIndex();
 }
 
 void BpClear()
 {
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
     breakpoints.clear();
+    BpRebuildIndex();
 }
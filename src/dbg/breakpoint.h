@@ -41,6 +41,8 @@ struct BREAKPOINT
     uint32 hitcount;                                  // hit counter
     bool fastResume;                                  // if true, debugger resumes without any GUI/Script/Plugin interaction.
     duint memsize;                                    // memory breakpoint size (not implemented)
+    duint watchOffset;                                // memory breakpoint: start of the watched sub-range, relative to addr
+    duint watchSize;                                  // memory breakpoint: size of the watched sub-range, 0 = the whole region triggers
 };
 
 // Breakpoint enumeration callback
@@ -48,9 +50,11 @@ typedef bool (*BPENUMCALLBACK)(const BREAKPOINT* bp);
 
 BREAKPOINT* BpInfoFromAddr(BP_TYPE Type, duint Address);
 int BpGetList(std::vector<BREAKPOINT>* List);
-bool BpNew(duint Address, bool Enable, bool Singleshot, short OldBytes, BP_TYPE Type, DWORD TitanType, const char* Name, duint memsize = 0);
+bool BpNew(duint Address, bool Enable, bool Singleshot, short OldBytes, BP_TYPE Type, DWORD TitanType, const char* Name, duint memsize = 0, duint watchOffset = 0, duint watchSize = 0);
 bool BpNewDll(const char* module, bool Enable, bool Singleshot, DWORD TitanType, const char* Name);
 bool BpGet(duint Address, BP_TYPE Type, const char* Name, BREAKPOINT* Bp);
+bool BpGetFast(duint Address, BP_TYPE Type, BREAKPOINT* Bp); // lock-free snapshot lookup for the debug event path
+bool BpMemRejectFault(duint Address); // true if a memory breakpoint fault is outside every watched sub-range
 bool BpGetAny(BP_TYPE Type, const char* Name, BREAKPOINT* Bp);
 bool BpDelete(duint Address, BP_TYPE Type);
 bool BpEnable(duint Address, BP_TYPE Type, bool Enable);
@@ -70,10 +74,19 @@ bool BpEnumAll(BPENUMCALLBACK EnumCallback);
 int BpGetCount(BP_TYPE Type, bool EnabledOnly = false);
 uint32 BpGetHitCount(duint Address, BP_TYPE Type);
 bool BpResetHitCount(duint Address, BP_TYPE Type, uint32 newHitCount);
+// Counting mode: fast resume + break condition "0" + no log/command. Such
+// breakpoints are tallied lock-free on the debug event path and the counts
+// are folded into hitcount lazily when it is read.
+bool BpIsCountingOnly(const BREAKPOINT & Bp);
+bool BpHitCountIncFast(BP_TYPE Type, duint Address);
 void BpToBridge(const BREAKPOINT* Bp, BRIDGEBP* BridgeBp);
 void BpCacheSave(JSON Root);
 void BpCacheLoad(JSON Root);
 void BpClear();
 bool BpUpdateDllPath(const char* module1, BREAKPOINT** newBpInfo);
+void BpBatchBegin(); // defer snapshot/journal/GUI publication of breakpoint mutations
+void BpBatchEnd(); // publish everything a batch deferred in one pass
+bool BpBatchActive();
+void BpBatchDeferHardware(); // request a debug register reconcile when the current batch commits
 
 #endif // _BREAKPOINT_H
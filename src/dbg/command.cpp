@@ -6,20 +6,34 @@
 
 #include "command.h"
 #include "value.h"
+#include <unordered_map>
 #include "console.h"
 #include "commandparser.h"
 #include "expressionparser.h"
 #include "variable.h"
 #include "cmd-undocumented.h"
+#include "threading.h"
 
 COMMAND* cmd_list = 0;
 
-static bool vecContains(std::vector<String>* names, const char* name)
+// Case-folded alias -> command hash table, so dispatch is a single lookup
+// instead of a linear scan over every registered alias. The linked list stays
+// the owner of the COMMAND structures; the table is rebuilt on deletion and
+// cmd_epoch is bumped on every change so pre-resolved handles can revalidate.
+static std::unordered_map<String, COMMAND*> cmd_aliases;
+static duint cmd_epoch = 1;
+
+static void aliasesRebuild()
 {
-    for(const auto & cmd : *names)
-        if(!_stricmp(cmd.c_str(), name))
-            return true;
-    return false;
+    cmd_aliases.clear();
+    for(COMMAND* cur = cmd_list; cur; cur = cur->next)
+    {
+        if(!cur->names)
+            continue;
+        for(const auto & alias : *cur->names)
+            cmd_aliases.emplace(StringUtils::ToLower(alias), cur);
+    }
+    cmd_epoch++;
 }
 
 /**
@@ -29,24 +43,27 @@ static bool vecContains(std::vector<String>* names, const char* name)
 \param [out] Link to the command.
 \return null if it fails, else a ::COMMAND*.
 */
-COMMAND* cmdfind(const char* name, COMMAND** link)
+static COMMAND* cmdfindNoLock(const char* name, COMMAND** link)
 {
-    COMMAND* cur = cmd_list;
-    if(!cur->names)
+    if(!cmd_list || !cmd_list->names || !name)
         return 0;
-    COMMAND* prev = 0;
-    while(cur)
+    auto found = cmd_aliases.find(StringUtils::ToLower(name));
+    if(found == cmd_aliases.end())
+        return 0;
+    if(link)
     {
-        if(vecContains(cur->names, name))
-        {
-            if(link)
-                *link = prev;
-            return cur;
-        }
-        prev = cur;
-        cur = cur->next;
+        //the previous node is only needed for deletion, walk the list for it
+        *link = 0;
+        for(COMMAND* cur = cmd_list; cur && cur != found->second; cur = cur->next)
+            *link = cur;
     }
-    return 0;
+    return found->second;
+}
+
+COMMAND* cmdfind(const char* name, COMMAND** link)
+{
+    SHARED_ACQUIRE(LockCommandList);
+    return cmdfindNoLock(name, link);
 }
 
 bool IsArgumentsLessThan(int argc, int minimumCount)
@@ -76,6 +93,9 @@ COMMAND* cmdinit()
 */
 void cmdfree()
 {
+    EXCLUSIVE_ACQUIRE(LockCommandList);
+    cmd_aliases.clear();
+    cmd_epoch++;
     COMMAND* cur = cmd_list;
     while(cur)
     {
@@ -96,7 +116,11 @@ void cmdfree()
 */
 bool cmdnew(const char* name, CBCOMMAND cbCommand, bool debugonly)
 {
-    if(!cmd_list || !cbCommand || !name || !*name || cmdfind(name, 0))
+    // Plugins register commands from pluginit, which runs on the loader
+    // worker pool, so the list and the alias table have to be guarded like
+    // the other plugin registration lists
+    EXCLUSIVE_ACQUIRE(LockCommandList);
+    if(!cmd_list || !cbCommand || !name || !*name || cmdfindNoLock(name, 0))
         return false;
     COMMAND* cmd;
     bool nonext = false;
@@ -125,6 +149,10 @@ bool cmdnew(const char* name, CBCOMMAND cbCommand, bool debugonly)
             cur = cur->next;
         cur->next = cmd;
     }
+    //aliases are expanded into the dispatch table at registration
+    for(const auto & alias : *cmd->names)
+        cmd_aliases.emplace(StringUtils::ToLower(alias), cmd);
+    cmd_epoch++;
     return true;
 }
 
@@ -161,7 +189,8 @@ CBCOMMAND cmdset(const char* name, CBCOMMAND cbCommand, bool debugonly)
 {
     if(!cbCommand)
         return 0;
-    COMMAND* found = cmdfind(name, 0);
+    EXCLUSIVE_ACQUIRE(LockCommandList);
+    COMMAND* found = cmdfindNoLock(name, 0);
     if(!found)
         return 0;
     CBCOMMAND old = found->cbCommand;
@@ -178,8 +207,9 @@ CBCOMMAND cmdset(const char* name, CBCOMMAND cbCommand, bool debugonly)
 */
 bool cmddel(const char* name)
 {
+    EXCLUSIVE_ACQUIRE(LockCommandList);
     COMMAND* prev = 0;
-    COMMAND* found = cmdfind(name, &prev);
+    COMMAND* found = cmdfindNoLock(name, &prev);
     if(!found)
         return false;
     delete found->names;
@@ -200,9 +230,16 @@ bool cmddel(const char* name)
         prev->next = found->next;
         efree(found, "cmddel:found");
     }
+    //deleting can move a COMMAND into the list head, rebuild the table
+    aliasesRebuild();
     return true;
 }
 
+duint cmdepoch()
+{
+    return cmd_epoch;
+}
+
 bool cbCommandProvider(char* cmd, int maxlen);
 
 void cmdsplit(const char* cmd, StringList & commands)
@@ -242,17 +279,16 @@ void cmdsplit(const char* cmd, StringList & commands)
         commands.push_back(split);
 }
 
-bool cmdexeccallback(COMMAND* cmd, const std::string & command)
+static bool cmdexeccallback(COMMAND* cmd, const std::string & command, const std::vector<String> & args)
 {
-    Command commandParsed(command);
-    int argcount = commandParsed.GetArgCount();
+    int argcount = (int)args.size();
     char** argv = (char**)emalloc((argcount + 1) * sizeof(char*), "cmdloop:argv");
     argv[0] = (char*)command.c_str();
     for(int i = 0; i < argcount; i++)
     {
         argv[i + 1] = (char*)emalloc(deflen, "cmdloop:argv[i+1]");
         *argv[i + 1] = 0;
-        strcpy_s(argv[i + 1], deflen, commandParsed.GetArg(i).c_str());
+        strcpy_s(argv[i + 1], deflen, args.at(i).c_str());
     }
     auto res = cmd->cbCommand(argcount + 1, argv);
     for(int i = 0; i < argcount; i++)
@@ -261,6 +297,17 @@ bool cmdexeccallback(COMMAND* cmd, const std::string & command)
     return res;
 }
 
+bool cmdexeccallback(COMMAND* cmd, const std::string & command)
+{
+    Command commandParsed(command);
+    int argcount = commandParsed.GetArgCount();
+    std::vector<String> args;
+    args.reserve(argcount);
+    for(int i = 0; i < argcount; i++)
+        args.push_back(commandParsed.GetArg(i));
+    return cmdexeccallback(cmd, command, args);
+}
+
 /**
 \brief Initiates the command loop. This function will not return until a command returns ::STATUS_EXIT.
 \return A bool, will always be ::STATUS_EXIT.
@@ -347,3 +394,75 @@ bool cmddirectexec(const char* cmd)
     }
     return true;
 }
+
+/**
+\brief Parses a command string into its commands and arguments ahead of time.
+\param cmd The command string to parse (may contain multiple commands separated by ';').
+\param [out] commands The parsed commands.
+*/
+void cmdparselist(const char* cmd, std::vector<PARSEDCOMMAND> & commands)
+{
+    commands.clear();
+    if(!cmd)
+        return;
+
+    StringList split;
+    cmdsplit(cmd, split);
+    for(auto & command : split)
+    {
+        command = StringUtils::Trim(command);
+        if(command.empty()) //skip empty commands
+            continue;
+        PARSEDCOMMAND parsed;
+        parsed.text = command;
+        Command commandParsed(command);
+        int argcount = commandParsed.GetArgCount();
+        parsed.args.reserve(argcount);
+        for(int i = 0; i < argcount; i++)
+            parsed.args.push_back(commandParsed.GetArg(i));
+        //resolve the command handle up front so execution skips dispatch
+        parsed.resolved = cmdget(parsed.text.c_str());
+        parsed.resolveEpoch = cmd_epoch;
+        commands.push_back(std::move(parsed));
+    }
+}
+
+/**
+\brief Directly execute commands parsed ahead of time with cmdparselist,
+skipping the per-call splitting and argument parsing (used by the script
+run loop, which executes the same lines many times).
+\param commands The parsed commands to execute.
+\return A bool.
+*/
+bool cmddirectexec(const std::vector<PARSEDCOMMAND> & commands)
+{
+    for(const auto & command : commands)
+    {
+        if(command.resolveEpoch != cmd_epoch) //a command was (un)registered since resolution
+        {
+            command.resolved = cmdget(command.text.c_str());
+            command.resolveEpoch = cmd_epoch;
+        }
+        COMMAND* found = command.resolved;
+        if(!found || !found->cbCommand) //unknown command
+        {
+            ExpressionParser parser(command.text);
+            duint result;
+            if(!parser.Calculate(result, valuesignedcalc(), true, false)) //stop processing on non-value commands
+                return false;
+            varset("$ans", result, true);
+            continue;
+        }
+
+        if(found->debugonly && !DbgIsDebugging()) //stop processing on debug-only commands
+        {
+            dprintf(QT_TRANSLATE_NOOP("DBG", "The command \"%s\" is debug-only\n"), command.text.c_str());
+            return false;
+        }
+
+        //execute command callback
+        if(!cmdexeccallback(found, command.text, command.args))
+            return false;
+    }
+    return true;
+}
@@ -22,6 +22,16 @@ struct COMMAND
     COMMAND* next;
 };
 
+struct PARSEDCOMMAND
+{
+    String text; //trimmed command text
+    std::vector<String> args; //parsed arguments
+    //command handle resolved at parse time, revalidated against cmdepoch()
+    //on execution so (un)registering commands cannot leave it dangling
+    mutable COMMAND* resolved = nullptr;
+    mutable duint resolveEpoch = 0;
+};
+
 //functions
 COMMAND* cmdinit();
 void cmdfree();
@@ -30,7 +40,10 @@ bool cmdnew(const char* name, CBCOMMAND cbCommand, bool debugonly);
 COMMAND* cmdget(const char* cmd);
 CBCOMMAND cmdset(const char* name, CBCOMMAND cbCommand, bool debugonly);
 bool cmddel(const char* name);
+duint cmdepoch(); //bumped whenever commands are registered or deleted
 void cmdloop();
 bool cmddirectexec(const char* cmd);
+void cmdparselist(const char* cmd, std::vector<PARSEDCOMMAND> & commands);
+bool cmddirectexec(const std::vector<PARSEDCOMMAND> & commands);
 
 #endif // _COMMAND_H
@@ -7,6 +7,7 @@
 #include "analysis_nukem.h"
 #include "xrefsanalysis.h"
 #include "recursiveanalysis.h"
+#include "incrementalanalysis.h"
 #include "value.h"
 #include "advancedanalysis.h"
 #include "debugger.h"
@@ -15,6 +16,7 @@
 #include "symbolinfo.h"
 #include "exception.h"
 #include "TraceRecord.h"
+#include "module.h"
 #include "dbghelp_safe.h"
 
 bool cbInstrAnalyse(int argc, char* argv[])
@@ -23,9 +25,16 @@ bool cbInstrAnalyse(int argc, char* argv[])
     GuiSelectionGet(GUI_DISASSEMBLY, &sel);
     duint size = 0;
     duint base = MemFindBaseAddr(sel.start, &size);
-    LinearAnalysis anal(base, size);
-    anal.Analyse();
-    anal.SetMarkers();
+    //after a full pass, later runs only re-analyse the functions around
+    //patched bytes; "anal force" re-analyses the whole region regardless
+    auto force = argc > 1 && _stricmp(argv[1], "force") == 0;
+    if(force || !AnalysisTryIncremental(base, size))
+    {
+        LinearAnalysis anal(base, size);
+        anal.Analyse();
+        anal.SetMarkers();
+        AnalysisMarkAnalysed(base, size);
+    }
     GuiUpdateAllViews();
     return true;
 }
@@ -95,6 +104,7 @@ bool cbInstrAnalrecur(int argc, char* argv[])
     if(!base)
         return false;
     RecursiveAnalysis analysis(base, size, entry, true);
+    analysis.SetFollowCalls(true);
     analysis.Analyse();
     analysis.SetMarkers();
     return true;
@@ -495,4 +505,87 @@ bool cbInstrTraceexecute(int argc, char* argv[])
         return false;
     _dbg_dbgtraceexecute(addr);
     return true;
+}
+
+bool cbInstrSaveTraceCoverage(int argc, char* argv[])
+{
+    if(IsArgumentsLessThan(argc, 2))
+        return false;
+    if(!TraceRecord.saveCoverage(argv[1]))
+    {
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Failed to write coverage file \"%s\"\n"), argv[1]);
+        return false;
+    }
+    return true;
+}
+
+static bool traceScopeRange(int argc, char* argv[], bool exclude)
+{
+    if(IsArgumentsLessThan(argc, 2))
+        return false;
+    duint start = 0, size = 0;
+    if(argc > 2) //explicit range: start, size
+    {
+        if(!valfromstring(argv[1], &start, false) || !valfromstring(argv[2], &size, false))
+            return false;
+    }
+    else //module name, or an address inside a module
+    {
+        start = ModBaseFromName(argv[1]);
+        if(!start)
+        {
+            duint addr;
+            if(valfromstring(argv[1], &addr, true))
+                start = ModBaseFromAddr(addr);
+        }
+        if(!start)
+        {
+            dprintf(QT_TRANSLATE_NOOP("DBG", "Invalid module \"%s\"!\n"), argv[1]);
+            return false;
+        }
+        size = ModSizeFromAddr(start);
+    }
+    if(!TraceRecord.scopeAddRange(start, size, exclude))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Invalid trace scope range"));
+        return false;
+    }
+    if(exclude)
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Trace scope: excluded %p-%p\n"), start, start + size - 1);
+    else
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Trace scope: included %p-%p\n"), start, start + size - 1);
+    return true;
+}
+
+bool cbInstrTraceScopeInclude(int argc, char* argv[])
+{
+    return traceScopeRange(argc, argv, false);
+}
+
+bool cbInstrTraceScopeExclude(int argc, char* argv[])
+{
+    return traceScopeRange(argc, argv, true);
+}
+
+bool cbInstrTraceScopeClear(int argc, char* argv[])
+{
+    TraceRecord.scopeClear();
+    dputs(QT_TRANSLATE_NOOP("DBG", "Trace scope cleared, everything is recorded again"));
+    return true;
+}
+
+bool cbInstrTraceScopeList(int argc, char* argv[])
+{
+    std::vector<std::pair<duint, duint>> includes, excludes;
+    TraceRecord.scopeGet(includes, excludes);
+    if(includes.empty() && excludes.empty())
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Trace scope is empty, everything is recorded"));
+        return true;
+    }
+    for(const auto & range : includes)
+        dprintf_untranslated("+ %p-%p\n", range.first, range.first + range.second - 1);
+    for(const auto & range : excludes)
+        dprintf_untranslated("- %p-%p\n", range.first, range.first + range.second - 1);
+    return true;
 }
\ No newline at end of file
@@ -18,4 +18,9 @@ bool cbInstrImageinfo(int argc, char* argv[]);
 bool cbInstrGetRelocSize(int argc, char* argv[]);
 bool cbInstrExhandlers(int argc, char* argv[]);
 bool cbInstrExinfo(int argc, char* argv[]);
-bool cbInstrTraceexecute(int argc, char* argv[]);
\ No newline at end of file
+bool cbInstrTraceexecute(int argc, char* argv[]);
+bool cbInstrSaveTraceCoverage(int argc, char* argv[]);
+bool cbInstrTraceScopeInclude(int argc, char* argv[]);
+bool cbInstrTraceScopeExclude(int argc, char* argv[]);
+bool cbInstrTraceScopeClear(int argc, char* argv[]);
+bool cbInstrTraceScopeList(int argc, char* argv[]);
\ No newline at end of file
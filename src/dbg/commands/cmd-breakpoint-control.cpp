@@ -334,7 +334,9 @@ static bool cbDeleteAllHardwareBreakpoints(const BREAKPOINT* bp)
         dprintf(QT_TRANSLATE_NOOP("DBG", "Delete hardware breakpoint failed (BpDelete): %p\n"), bp->addr);
         return false;
     }
-    if(bp->enabled && TITANDRXVALID(bp->titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(bp->titantype)))
+    if(BpBatchActive()) //debug registers are reconciled when the batch commits
+        BpBatchDeferHardware();
+    else if(bp->enabled && TITANDRXVALID(bp->titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(bp->titantype)))
     {
         dprintf(QT_TRANSLATE_NOOP("DBG", "Delete hardware breakpoint failed (DeleteHardwareBreakPoint): %p\n"), bp->addr);
         return false;
@@ -346,6 +348,16 @@ static bool cbEnableAllHardwareBreakpoints(const BREAKPOINT* bp)
 {
     if(bp->type != BPHARDWARE || bp->enabled)
         return true;
+    if(BpBatchActive()) //slot assignment and programming happen when the batch commits
+    {
+        if(!BpEnable(bp->addr, BPHARDWARE, true))
+        {
+            dprintf(QT_TRANSLATE_NOOP("DBG", "Could not enable hardware breakpoint %p (BpEnable)\n"), bp->addr);
+            return false;
+        }
+        BpBatchDeferHardware();
+        return true;
+    }
     DWORD drx = 0;
     if(!GetUnusedHardwareBreakPointRegister(&drx))
     {
@@ -377,7 +389,9 @@ static bool cbDisableAllHardwareBreakpoints(const BREAKPOINT* bp)
         dprintf(QT_TRANSLATE_NOOP("DBG", "Could not disable hardware breakpoint %p (BpEnable)\n"), bp->addr);
         return false;
     }
-    if(bp->enabled && TITANDRXVALID(bp->titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(bp->titantype)))
+    if(BpBatchActive()) //debug registers are reconciled when the batch commits
+        BpBatchDeferHardware();
+    else if(bp->enabled && TITANDRXVALID(bp->titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(bp->titantype)))
     {
         dprintf(QT_TRANSLATE_NOOP("DBG", "Could not disable hardware breakpoint %p (DeleteHardwareBreakPoint)\n"), bp->addr);
         return false;
@@ -447,13 +461,14 @@ bool cbDebugSetHardwareBreakpoint(int argc, char* argv[])
         }
     }
     DWORD drx = 0;
-    if(!GetUnusedHardwareBreakPointRegister(&drx))
+    //during a batch the slot is assigned at commit, and TitanEngine's slot table is stale anyway
+    if(!BpBatchActive() && !GetUnusedHardwareBreakPointRegister(&drx))
     {
         dputs(QT_TRANSLATE_NOOP("DBG", "You can only set 4 hardware breakpoints"));
         return false;
     }
     int titantype = 0;
-    TITANSETDRX(titantype, drx);
+    TITANSETDRX(titantype, BpBatchActive() ? UE_DR7 : drx);
     TITANSETTYPE(titantype, type);
     TITANSETSIZE(titantype, titsize);
     //TODO: hwbp in multiple threads TEST
@@ -470,7 +485,9 @@ bool cbDebugSetHardwareBreakpoint(int argc, char* argv[])
         dputs(QT_TRANSLATE_NOOP("DBG", "Error setting hardware breakpoint (bpnew)!"));
         return false;
     }
-    if(!SetHardwareBreakPoint(addr, drx, type, titsize, (void*)cbHardwareBreakpoint))
+    if(BpBatchActive()) //debug registers are programmed when the batch commits
+        BpBatchDeferHardware();
+    else if(!SetHardwareBreakPoint(addr, drx, type, titsize, (void*)cbHardwareBreakpoint))
     {
         dputs(QT_TRANSLATE_NOOP("DBG", "Error setting hardware breakpoint (TitanEngine)!"));
         return false;
@@ -503,7 +520,9 @@ bool cbDebugDeleteHardwareBreakpoint(int argc, char* argv[])
             dprintf(QT_TRANSLATE_NOOP("DBG", "Delete hardware breakpoint failed: %p (BpDelete)\n"), found.addr);
             return false;
         }
-        if(TITANDRXVALID(found.titantype) && !DeleteHardwareBreakPoint(found.titantype))
+        if(BpBatchActive()) //debug registers are reconciled when the batch commits
+            BpBatchDeferHardware();
+        else if(TITANDRXVALID(found.titantype) && !DeleteHardwareBreakPoint(found.titantype))
         {
             dprintf(QT_TRANSLATE_NOOP("DBG", "Delete hardware breakpoint failed: %p (DeleteHardwareBreakPoint)\n"), found.addr);
             return false;
@@ -522,7 +541,9 @@ bool cbDebugDeleteHardwareBreakpoint(int argc, char* argv[])
         dprintf(QT_TRANSLATE_NOOP("DBG", "Delete hardware breakpoint failed: %p (BpDelete)\n"), found.addr);
         return false;
     }
-    if(TITANDRXVALID(found.titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(found.titantype)))
+    if(BpBatchActive()) //debug registers are reconciled when the batch commits
+        BpBatchDeferHardware();
+    else if(TITANDRXVALID(found.titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(found.titantype)))
     {
         dprintf(QT_TRANSLATE_NOOP("DBG", "Delete hardware breakpoint failed: %p (DeleteHardwareBreakPoint)\n"), found.addr);
         return false;
@@ -535,7 +556,8 @@ bool cbDebugDeleteHardwareBreakpoint(int argc, char* argv[])
 bool cbDebugEnableHardwareBreakpoint(int argc, char* argv[])
 {
     DWORD drx = 0;
-    if(!GetUnusedHardwareBreakPointRegister(&drx))
+    //during a batch the slot is assigned at commit, and TitanEngine's slot table is stale anyway
+    if(!BpBatchActive() && !GetUnusedHardwareBreakPointRegister(&drx))
     {
         dputs(QT_TRANSLATE_NOOP("DBG", "You can only set 4 hardware breakpoints"));
         return false;
@@ -566,12 +588,21 @@ bool cbDebugEnableHardwareBreakpoint(int argc, char* argv[])
         GuiUpdateAllViews();
         return true;
     }
-    TITANSETDRX(found.titantype, drx);
-    BpSetTitanType(found.addr, BPHARDWARE, found.titantype);
-    if(!SetHardwareBreakPoint(found.addr, drx, TITANGETTYPE(found.titantype), TITANGETSIZE(found.titantype), (void*)cbHardwareBreakpoint))
+    if(BpBatchActive()) //slot assignment and programming happen when the batch commits
     {
-        dprintf(QT_TRANSLATE_NOOP("DBG", "Could not enable hardware breakpoint %p (SetHardwareBreakpoint)\n"), found.addr);
-        return false;
+        TITANSETDRX(found.titantype, UE_DR7);
+        BpSetTitanType(found.addr, BPHARDWARE, found.titantype);
+        BpBatchDeferHardware();
+    }
+    else
+    {
+        TITANSETDRX(found.titantype, drx);
+        BpSetTitanType(found.addr, BPHARDWARE, found.titantype);
+        if(!SetHardwareBreakPoint(found.addr, drx, TITANGETTYPE(found.titantype), TITANGETSIZE(found.titantype), (void*)cbHardwareBreakpoint))
+        {
+            dprintf(QT_TRANSLATE_NOOP("DBG", "Could not enable hardware breakpoint %p (SetHardwareBreakpoint)\n"), found.addr);
+            return false;
+        }
     }
     if(!BpEnable(found.addr, BPHARDWARE, true))
     {
@@ -615,7 +646,9 @@ bool cbDebugDisableHardwareBreakpoint(int argc, char* argv[])
         dprintf(QT_TRANSLATE_NOOP("DBG", "Could not disable hardware breakpoint %p (BpEnable)\n"), found.addr);
         return false;
     }
-    if(TITANDRXVALID(found.titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(found.titantype)))
+    if(BpBatchActive()) //debug registers are reconciled when the batch commits
+        BpBatchDeferHardware();
+    else if(TITANDRXVALID(found.titantype) && !DeleteHardwareBreakPoint(TITANGETDRX(found.titantype)))
     {
         dprintf(QT_TRANSLATE_NOOP("DBG", "Could not disable hardware breakpoint %p (DeleteHardwareBreakpoint)\n"), found.addr);
         return false;
@@ -724,8 +757,16 @@ bool cbDebugSetMemoryBpx(int argc, char* argv[])
             break;
         }
     }
+    duint watchSize = 0;
+    if(argc > 4 && !valfromstring(argv[4], &watchSize))
+        return false;
     duint size = 0;
     duint base = MemFindBaseAddr(addr, &size, true);
+    if(watchSize && addr - base + watchSize > size)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Watched range must not exceed the memory region!"));
+        return false;
+    }
     bool singleshoot = false;
     if(!restore)
         singleshoot = true;
@@ -737,7 +778,7 @@ bool cbDebugSetMemoryBpx(int argc, char* argv[])
         dputs(QT_TRANSLATE_NOOP("DBG", "Memory breakpoint already set!"));
         return true;
     }
-    if(!BpNew(base, true, singleshoot, 0, BPMEMORY, type, 0, size))
+    if(!BpNew(base, true, singleshoot, 0, BPMEMORY, type, 0, size, watchSize ? addr - base : 0, watchSize))
     {
         dputs(QT_TRANSLATE_NOOP("DBG", "Error setting memory breakpoint! (BpNew)"));
         return false;
@@ -1452,3 +1493,30 @@ bool cbDebugSetBPXOptions(int argc, char* argv[])
     dprintf(QT_TRANSLATE_NOOP("DBG", "Default breakpoint type set to: %s\n"), strType);
     return true;
 }
+
+bool cbDebugBpBatch(int argc, char* argv[])
+{
+    if(IsArgumentsLessThan(argc, 2))
+        return false;
+    if(!_stricmp(argv[1], "begin"))
+    {
+        BpBatchBegin();
+        dputs(QT_TRANSLATE_NOOP("DBG", "Breakpoint batch started!"));
+    }
+    else if(!_stricmp(argv[1], "commit") || !_stricmp(argv[1], "end"))
+    {
+        if(!BpBatchActive())
+        {
+            dputs(QT_TRANSLATE_NOOP("DBG", "No breakpoint batch in progress!"));
+            return false;
+        }
+        BpBatchEnd();
+        dputs(QT_TRANSLATE_NOOP("DBG", "Breakpoint batch committed!"));
+    }
+    else
+    {
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Invalid argument \"%s\"!\n"), argv[1]);
+        return false;
+    }
+    return true;
+}
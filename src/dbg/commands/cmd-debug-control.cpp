@@ -4,6 +4,7 @@
 #include "debugger.h"
 #include "animate.h"
 #include "historycontext.h"
+#include "performance.h"
 #include "threading.h"
 #include "memory.h"
 #include "disasm_fast.h"
@@ -38,8 +39,20 @@ static bool skipInt3Stepping(int argc, char* argv[])
 
 bool cbDebugRunInternal(int argc, char* argv[])
 {
-    if(argc >= 2 && !DbgCmdExecDirect(StringUtils::sprintf("bp \"%s\", ss", argv[1]).c_str()))
-        return false;
+    if(argc >= 2)
+    {
+        // Prefer a silent TitanEngine single-shot breakpoint: run-to-address
+        // is issued in tight scripted loops and the database breakpoint it
+        // used to create cost a breakpoint view and debug view update per
+        // run. The bp command stays as fallback for addresses the silent
+        // path cannot arm (existing breakpoint, invalid memory).
+        duint addr = 0;
+        bool armed = false;
+        if(valfromstring(argv[1], &addr, false) && MemIsValidReadPtr(addr) && !IsBPXEnabled(addr))
+            armed = SetBPX(addr, UE_SINGLESHOOT, (void*)cbRunToAddressBreakpoint);
+        if(!armed && !DbgCmdExecDirect(StringUtils::sprintf("bp \"%s\", ss", argv[1]).c_str()))
+            return false;
+    }
     // Don't "run" twice if the program is already running
     if(dbgisrunning())
         return false;
@@ -381,6 +394,7 @@ bool cbDebugStepInto(int argc, char* argv[])
     // History
     HistoryAdd();
     dbgsetsteprepeat(true, steprepeat);
+    StepLatencyMark(StepStage::Resume);
     return cbDebugRunInternal(1, argv);
 }
 
@@ -409,6 +423,7 @@ bool cbDebugStepOver(int argc, char* argv[])
     // History
     HistoryClear();
     dbgsetsteprepeat(false, steprepeat);
+    StepLatencyMark(StepStage::Resume);
     return cbDebugRunInternal(1, argv);
 }
 
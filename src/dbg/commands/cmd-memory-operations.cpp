@@ -7,6 +7,8 @@
 #include "value.h"
 #include "stringformat.h"
 #include "comment.h"
+#include "memsnapshot.h"
+#include "patches.h"
 
 bool cbDebugAlloc(int argc, char* argv[])
 {
@@ -123,6 +125,30 @@ bool cbDebugMemcpy(int argc, char* argv[])
     return true;
 }
 
+bool cbDebugUndoEdit(int argc, char* argv[])
+{
+    if(!PatchUndoEdit())
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Nothing to undo"));
+        return false;
+    }
+    GuiUpdatePatches();
+    GuiUpdateAllViews();
+    return true;
+}
+
+bool cbDebugRedoEdit(int argc, char* argv[])
+{
+    if(!PatchRedoEdit())
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Nothing to redo"));
+        return false;
+    }
+    GuiUpdatePatches();
+    GuiUpdateAllViews();
+    return true;
+}
+
 bool cbDebugGetPageRights(int argc, char* argv[])
 {
     duint addr = 0;
@@ -209,4 +235,80 @@ bool cbInstrSavedata(int argc, char* argv[])
 #endif
 
     return success;
+}
+
+bool cbInstrMemSnapshot(int argc, char* argv[])
+{
+    String name;
+    if(argc > 1)
+        name = stringformatinline(argv[1]);
+    if(name.empty() || name == ":memdump:")
+        name = StringUtils::sprintf("%s\\memdumps\\snapshot_%X_%u.snap", szProgramDir, fdProcessInfo->dwProcessId, GetTickCount());
+
+    if(!MemSnapshotCapture(name.c_str()))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Failed to capture the memory snapshot..."));
+        return false;
+    }
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Memory snapshot written to \"%s\" !\n"), name.c_str());
+    return true;
+}
+
+bool cbInstrMemSnapshotLoad(int argc, char* argv[])
+{
+    if(IsArgumentsLessThan(argc, 2))
+        return false;
+    String name = stringformatinline(argv[1]);
+    if(!MemSnapshotLoad(name.c_str()))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Failed to load the memory snapshot..."));
+        return false;
+    }
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Memory snapshot \"%s\" loaded!\n"), name.c_str());
+    return true;
+}
+
+bool cbInstrMemSnapshotClose(int argc, char* argv[])
+{
+    MemSnapshotClear();
+    dputs(QT_TRANSLATE_NOOP("DBG", "Memory snapshot unloaded!"));
+    return true;
+}
+
+bool cbInstrMemSnapshotDiff(int argc, char* argv[])
+{
+    if(!MemSnapshotIsLoaded())
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "No memory snapshot loaded!"));
+        return false;
+    }
+    duint addr = 0, size = 0;
+    if(argc > 1 && !valfromstring(argv[1], &addr, false))
+        return false;
+    if(argc > 2 && !valfromstring(argv[2], &size, false))
+        return false;
+
+    std::vector<std::pair<duint, duint>> ranges;
+    if(!MemSnapshotDiff(addr, size, ranges))
+        return false;
+
+    duint totalBytes = 0;
+    for(const auto & range : ranges)
+        totalBytes += range.second;
+    const size_t maxPrint = 100;
+    for(size_t i = 0; i < ranges.size() && i < maxPrint; i++)
+#ifdef _WIN64
+        dprintf(QT_TRANSLATE_NOOP("DBG", "%p[%llX] changed\n"), ranges[i].first, ranges[i].second);
+#else //x86
+        dprintf(QT_TRANSLATE_NOOP("DBG", "%p[%X] changed\n"), ranges[i].first, ranges[i].second);
+#endif
+    if(ranges.size() > maxPrint)
+        dprintf(QT_TRANSLATE_NOOP("DBG", "... %d more range(s)\n"), int(ranges.size() - maxPrint));
+#ifdef _WIN64
+    dprintf(QT_TRANSLATE_NOOP("DBG", "%d range(s) differ (%llX bytes total)\n"), int(ranges.size()), totalBytes);
+#else //x86
+    dprintf(QT_TRANSLATE_NOOP("DBG", "%d range(s) differ (%X bytes total)\n"), int(ranges.size()), totalBytes);
+#endif
+    varset("$result", duint(ranges.size()), false);
+    return true;
 }
\ No newline at end of file
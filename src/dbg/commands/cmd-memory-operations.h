@@ -6,6 +6,12 @@ bool cbDebugAlloc(int argc, char* argv[]);
 bool cbDebugFree(int argc, char* argv[]);
 bool cbDebugMemset(int argc, char* argv[]);
 bool cbDebugMemcpy(int argc, char* argv[]);
+bool cbDebugUndoEdit(int argc, char* argv[]);
+bool cbDebugRedoEdit(int argc, char* argv[]);
 bool cbDebugGetPageRights(int argc, char* argv[]);
 bool cbDebugSetPageRights(int argc, char* argv[]);
-bool cbInstrSavedata(int argc, char* argv[]);
\ No newline at end of file
+bool cbInstrSavedata(int argc, char* argv[]);
+bool cbInstrMemSnapshot(int argc, char* argv[]);
+bool cbInstrMemSnapshotLoad(int argc, char* argv[]);
+bool cbInstrMemSnapshotClose(int argc, char* argv[]);
+bool cbInstrMemSnapshotDiff(int argc, char* argv[]);
\ No newline at end of file
@@ -12,6 +12,12 @@
 #include "mnemonichelp.h"
 #include "commandline.h"
 #include "stringformat.h"
+#include "performance.h"
+#include "eventstats.h"
+#include "module.h"
+#include "label.h"
+#include "zydis_wrapper.h"
+#include <algorithm>
 
 bool cbInstrChd(int argc, char* argv[])
 {
@@ -252,6 +258,229 @@ bool cbDebugFreeLib(int argc, char* argv[])
     return true;
 }
 
+static duint RunToCondStubAddr;
+static duint RunToCondTarget;
+static unsigned char RunToCondOrigBytes[32];
+static duint RunToCondOrigSize;
+
+void dbgClearRunToConditionStub()
+{
+    //the stub memory died with the debuggee, only the bookkeeping has to go
+    RunToCondStubAddr = 0;
+    RunToCondTarget = 0;
+    RunToCondOrigSize = 0;
+}
+
+static void cbRunToConditionBPX()
+{
+    //put the original bytes back and report at the loop head
+    MemWrite(RunToCondTarget, RunToCondOrigBytes, RunToCondOrigSize);
+    SetContextDataEx(hActiveThread, UE_CIP, RunToCondTarget);
+    MemFreeRemote(RunToCondStubAddr);
+    RunToCondStubAddr = 0;
+    //update GUI
+    DebugUpdateGuiSetStateAsync(RunToCondTarget, true);
+    //lock
+    lock(WAITID_RUN);
+    dbgsetforeground();
+    PLUG_CB_PAUSEDEBUG pauseInfo = { nullptr };
+    plugincbcall(CB_PAUSEDEBUG, &pauseInfo);
+    wait(WAITID_RUN);
+}
+
+bool cbDebugRunToCondition(int argc, char* argv[])
+{
+    if(IsArgumentsLessThan(argc, 3))
+        return false;
+    if(RunToCondStubAddr)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: a condition stub is already active"));
+        return false;
+    }
+    duint target = 0;
+    if(!valfromstring(argv[1], &target, false))
+        return false;
+
+    //parse "[address] operator value" into a native compare + conditional jump (unsigned)
+    String condition = argv[2];
+    struct
+    {
+        const char* text;
+        unsigned char jcc; //short jump taken when the condition holds
+    } operators[] =
+    {
+        { "==", 0x74 }, //je
+        { "!=", 0x75 }, //jne
+        { "<=", 0x76 }, //jbe
+        { ">=", 0x73 }, //jae
+        { "<", 0x72 }, //jb
+        { ">", 0x77 }, //ja
+    };
+    size_t opPos = String::npos;
+    size_t opIndex = 0;
+    for(; opIndex < _countof(operators); opIndex++)
+    {
+        opPos = condition.find(operators[opIndex].text);
+        if(opPos != String::npos)
+            break;
+    }
+    auto left = opPos != String::npos ? StringUtils::Trim(condition.substr(0, opPos)) : String();
+    if(opPos == String::npos || left.size() < 3 || left.front() != '[' || left.back() != ']')
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: the condition must look like \"[address] == value\""));
+        return false;
+    }
+    duint memAddr = 0, value = 0;
+    if(!valfromstring(left.substr(1, left.size() - 2).c_str(), &memAddr, false))
+        return false;
+    if(!valfromstring(condition.substr(opPos + strlen(operators[opIndex].text)).c_str(), &value, false))
+        return false;
+#ifdef _WIN64
+    if(duint(dsint(int(value))) != value)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: the compared value must fit in a sign-extended 32 bit immediate"));
+        return false;
+    }
+#endif //_WIN64
+
+    //relocate whole instructions until the jump to the stub fits
+    unsigned char code[sizeof(RunToCondOrigBytes)];
+    if(!MemRead(target, code, sizeof(code)))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: could not read memory at the target address"));
+        return false;
+    }
+    Zydis cp;
+    duint origSize = 0;
+    while(origSize < 5)
+    {
+        if(!cp.Disassemble(target + origSize, code + origSize, int(sizeof(code) - origSize)))
+        {
+            dputs(QT_TRANSLATE_NOOP("DBG", "Error: could not disassemble the target instructions"));
+            return false;
+        }
+        if(cp.IsBranchType(Zydis::BTAny))
+        {
+            dputs(QT_TRANSLATE_NOOP("DBG", "Error: the first 5 bytes at the target must not contain a branch"));
+            return false;
+        }
+        for(auto i = 0; i < cp.OpCount(); i++)
+        {
+            const auto & op = cp[i];
+            if(op.type == ZYDIS_OPERAND_TYPE_MEMORY && (op.mem.base == ZYDIS_REGISTER_RIP || op.mem.base == ZYDIS_REGISTER_EIP))
+            {
+                dputs(QT_TRANSLATE_NOOP("DBG", "Error: the relocated instructions must not be RIP-relative"));
+                return false;
+            }
+        }
+        origSize += cp.Size();
+    }
+    memcpy(RunToCondOrigBytes, code, origSize);
+
+    //the jumps are rel32, so on x64 the stub has to land within reach of the target
+    duint stubSize = 0x40 + origSize;
+    duint stub = 0;
+#ifdef _WIN64
+    for(duint delta = 0x1000000; delta < 0x70000000 && !stub; delta <<= 1)
+    {
+        stub = MemAllocRemote(target > delta ? target - delta : 0x10000, stubSize);
+        if(stub && (stub > target ? stub - target : target - stub) > 0x7FF00000)
+        {
+            MemFreeRemote(stub);
+            stub = 0;
+        }
+    }
+#else
+    stub = MemAllocRemote(0, stubSize);
+#endif //_WIN64
+    if(!stub)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: couldn't allocate stub memory within jump range of the target"));
+        return false;
+    }
+
+    //  pushf / push [e|r]ax
+    //  mov [e|r]ax, memAddr ; mov [e|r]ax, [[e|r]ax] ; cmp [e|r]ax, value
+    //  jcc hit
+    //  pop [e|r]ax / popf / <original instructions> / jmp back
+    //hit:
+    //  pop [e|r]ax / popf / nop <- single shoot int3 breakpoint
+    unsigned char stubCode[sizeof(RunToCondOrigBytes) + 0x40];
+    duint offset = 0;
+    stubCode[offset++] = 0x9C; //pushf
+    stubCode[offset++] = 0x50; //push [e|r]ax
+#ifdef _WIN64
+    stubCode[offset++] = 0x48; //movabs rax, memAddr
+    stubCode[offset++] = 0xB8;
+    memcpy(stubCode + offset, &memAddr, sizeof(duint));
+    offset += sizeof(duint);
+    stubCode[offset++] = 0x48; //mov rax, [rax]
+    stubCode[offset++] = 0x8B;
+    stubCode[offset++] = 0x00;
+    stubCode[offset++] = 0x48; //cmp rax, imm32 (sign-extended)
+    stubCode[offset++] = 0x3D;
+#else
+    stubCode[offset++] = 0xB8; //mov eax, memAddr
+    memcpy(stubCode + offset, &memAddr, sizeof(duint));
+    offset += sizeof(duint);
+    stubCode[offset++] = 0x8B; //mov eax, [eax]
+    stubCode[offset++] = 0x00;
+    stubCode[offset++] = 0x3D; //cmp eax, imm32
+#endif //_WIN64
+    int imm32 = int(value);
+    memcpy(stubCode + offset, &imm32, sizeof(imm32));
+    offset += sizeof(imm32);
+    stubCode[offset++] = operators[opIndex].jcc; //jcc hit, over the not-taken path
+    stubCode[offset++] = (unsigned char)(2 + origSize + 5);
+    stubCode[offset++] = 0x58; //pop [e|r]ax
+    stubCode[offset++] = 0x9D; //popf
+    memcpy(stubCode + offset, RunToCondOrigBytes, origSize); //original instructions
+    offset += origSize;
+    stubCode[offset++] = 0xE9; //jmp back behind the patched site
+    int backRel = int(dsint(target + origSize) - dsint(stub + offset + 4));
+    memcpy(stubCode + offset, &backRel, sizeof(backRel));
+    offset += sizeof(backRel);
+    duint hitOffset = offset;
+    stubCode[offset++] = 0x58; //pop [e|r]ax
+    stubCode[offset++] = 0x9D; //popf
+    stubCode[offset++] = 0x90; //nop, the breakpoint lands here
+
+    if(!MemWrite(stub, stubCode, offset))
+    {
+        MemFreeRemote(stub);
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: couldn't write process memory"));
+        return false;
+    }
+    if(!SetBPX(stub + hitOffset + 2, UE_SINGLESHOOT | UE_BREAKPOINT_TYPE_INT3, (void*)cbRunToConditionBPX))
+    {
+        MemFreeRemote(stub);
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: couldn't SetBPX"));
+        return false;
+    }
+
+    //divert the target through the stub (NOP-filled so the listing stays aligned)
+    unsigned char patch[sizeof(RunToCondOrigBytes)];
+    memset(patch, 0x90, origSize);
+    patch[0] = 0xE9;
+    int stubRel = int(dsint(stub) - dsint(target + 5));
+    memcpy(patch + 1, &stubRel, sizeof(stubRel));
+    if(!MemWrite(target, patch, origSize))
+    {
+        DeleteBPX(stub + hitOffset + 2);
+        MemFreeRemote(stub);
+        dputs(QT_TRANSLATE_NOOP("DBG", "Error: couldn't write process memory"));
+        return false;
+    }
+
+    RunToCondStubAddr = stub;
+    RunToCondTarget = target;
+    RunToCondOrigSize = origSize;
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Condition stub injected at %p, running until \"%s\" holds at %p...\n"), stub, condition.c_str(), target);
+
+    unlock(WAITID_RUN);
+    return true;
+}
+
 bool cbInstrAssemble(int argc, char* argv[])
 {
     if(IsArgumentsLessThan(argc, 3))
@@ -738,3 +967,169 @@ bool cbInstrRestartadmin(int argc, char* argv[])
         GuiCloseApplication();
     return true;
 }
+
+bool cbInstrLockTelemetry(int argc, char* argv[])
+{
+    if(argc > 1)
+    {
+        if(_stricmp(argv[1], "enable") == 0)
+        {
+            SectionLockerGlobal::SetTelemetryEnabled(true);
+            dputs(QT_TRANSLATE_NOOP("DBG", "Lock telemetry enabled!"));
+            return true;
+        }
+        if(_stricmp(argv[1], "disable") == 0)
+        {
+            SectionLockerGlobal::SetTelemetryEnabled(false);
+            dputs(QT_TRANSLATE_NOOP("DBG", "Lock telemetry disabled!"));
+            return true;
+        }
+        if(_stricmp(argv[1], "reset") == 0)
+        {
+            SectionLockerGlobal::TelemetryReset();
+            dputs(QT_TRANSLATE_NOOP("DBG", "Lock telemetry reset!"));
+            return true;
+        }
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Unknown argument \"%s\" (expected enable, disable or reset)\n"), argv[1]);
+        return false;
+    }
+
+    if(!SectionLockerGlobal::TelemetryEnabled())
+        dputs(QT_TRANSLATE_NOOP("DBG", "Lock telemetry is disabled, use \"locktelemetry enable\" to start counting..."));
+
+    LOCKTELEMETRY telemetry[SectionLock::LockLast];
+    SectionLockerGlobal::TelemetrySnapshot(telemetry);
+
+    // Most total wait time first, so the hottest locks top the list
+    std::vector<int> order;
+    order.reserve(SectionLock::LockLast);
+    for(int i = 0; i < SectionLock::LockLast; i++)
+    {
+        if(telemetry[i].acquisitions)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&telemetry](int a, int b)
+    {
+        return telemetry[a].waitTime > telemetry[b].waitTime;
+    });
+
+    if(order.empty())
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "No lock acquisitions counted"));
+        return true;
+    }
+
+    dprintf_untranslated("%-28s %12s %12s %10s %10s  %s\n", "Lock", "Acquisitions", "Contentions", "Wait (us)", "Max (us)", "<1us/<10us/<100us/<1ms/<10ms/>=10ms");
+    for(auto i : order)
+    {
+        const auto & t = telemetry[i];
+        dprintf_untranslated("%-28s %12llu %12llu %10llu %10llu  %llu/%llu/%llu/%llu/%llu/%llu",
+                             SectionLockerGlobal::LockName(SectionLock(i)),
+                             t.acquisitions,
+                             t.contentions,
+                             t.waitTime,
+                             t.maxWaitTime,
+                             t.waitHistogram[0], t.waitHistogram[1], t.waitHistogram[2], t.waitHistogram[3], t.waitHistogram[4], t.waitHistogram[5]);
+        if(t.owner)
+            dprintf_untranslated(" (owner: %u)", t.owner);
+        dprintf_untranslated("\n");
+    }
+    return true;
+}
+
+bool cbInstrPerf(int argc, char* argv[])
+{
+    if(argc > 1)
+    {
+        if(_stricmp(argv[1], "enable") == 0)
+        {
+            perfEnabled.store(true, std::memory_order_relaxed);
+            dputs(QT_TRANSLATE_NOOP("DBG", "Performance markers enabled!"));
+            return true;
+        }
+        if(_stricmp(argv[1], "disable") == 0)
+        {
+            perfEnabled.store(false, std::memory_order_relaxed);
+            dputs(QT_TRANSLATE_NOOP("DBG", "Performance markers disabled!"));
+            return true;
+        }
+        if(_stricmp(argv[1], "reset") == 0)
+        {
+            PerfClear();
+            StepLatencyClear();
+            dputs(QT_TRANSLATE_NOOP("DBG", "Performance markers reset!"));
+            return true;
+        }
+        if(_stricmp(argv[1], "steps") == 0)
+        {
+            dprintf_untranslated("%s", StepLatencyReport().c_str());
+            return true;
+        }
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Unknown argument \"%s\" (expected enable, disable, reset or steps)\n"), argv[1]);
+        return false;
+    }
+
+    if(!perfEnabled.load(std::memory_order_relaxed))
+        dputs(QT_TRANSLATE_NOOP("DBG", "Performance markers are disabled, use \"perf enable\" to start counting..."));
+
+    dprintf_untranslated("%s", PerfReport().c_str());
+    return true;
+}
+
+bool cbInstrEventStats(int argc, char* argv[])
+{
+    if(argc > 1)
+    {
+        if(_stricmp(argv[1], "reset") == 0 || _stricmp(argv[1], "clear") == 0)
+        {
+            EventStatsClear();
+            dputs(QT_TRANSLATE_NOOP("DBG", "Event statistics reset!"));
+            return true;
+        }
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Unknown argument \"%s\" (expected reset)\n"), argv[1]);
+        return false;
+    }
+
+    EventStatsSnapshot stats;
+    EventStatsSnapshotGet(stats);
+
+    static const char* eventNames[] =
+    {
+        "<invalid>",
+        "EXCEPTION_DEBUG_EVENT",
+        "CREATE_THREAD_DEBUG_EVENT",
+        "CREATE_PROCESS_DEBUG_EVENT",
+        "EXIT_THREAD_DEBUG_EVENT",
+        "EXIT_PROCESS_DEBUG_EVENT",
+        "LOAD_DLL_DEBUG_EVENT",
+        "UNLOAD_DLL_DEBUG_EVENT",
+        "OUTPUT_DEBUG_STRING_EVENT",
+        "RIP_EVENT"
+    };
+    unsigned long long total = 0;
+    for(int i = 1; i <= RIP_EVENT; i++)
+        total += stats.eventCounts[i];
+    dprintf_untranslated("Debug events this session: %llu (%.1f events/s)\n", total, stats.eventsPerSecond);
+    for(int i = 1; i <= RIP_EVENT && i < _countof(eventNames); i++)
+    {
+        if(!stats.eventCounts[i])
+            continue;
+        dprintf_untranslated("  %-26s %llu\n", eventNames[i], stats.eventCounts[i]);
+    }
+    if(stats.eventCounts[EXCEPTION_DEBUG_EVENT])
+    {
+        dprintf_untranslated("Exceptions: %llu first chance, %llu last chance\n", stats.firstChanceExceptions, stats.lastChanceExceptions);
+        dputs_untranslated("Top exception addresses (approximate):");
+        for(int i = 0; i < EVENTSTATS_TOPK; i++)
+        {
+            if(!stats.topExceptions[i].address)
+                continue;
+            char module[MAX_MODULE_SIZE] = "";
+            ModNameFromAddr(stats.topExceptions[i].address, module, true);
+            char label[MAX_LABEL_SIZE] = "";
+            LabelGet(stats.topExceptions[i].address, label);
+            dprintf_untranslated("  %p %s %s (%llu hits)\n", stats.topExceptions[i].address, module, label, stats.topExceptions[i].count);
+        }
+    }
+    return true;
+}
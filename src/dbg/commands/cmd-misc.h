@@ -8,6 +8,8 @@ bool cbInstrZzz(int argc, char* argv[]);
 bool cbDebugHide(int argc, char* argv[]);
 bool cbDebugLoadLib(int argc, char* argv[]);
 bool cbDebugFreeLib(int argc, char* argv[]);
+bool cbDebugRunToCondition(int argc, char* argv[]);
+void dbgClearRunToConditionStub();
 bool cbInstrAssemble(int argc, char* argv[]);
 bool cbInstrGpa(int argc, char* argv[]);
 
@@ -23,4 +25,7 @@ bool cbInstrMnemonichelp(int argc, char* argv[]);
 bool cbInstrMnemonicbrief(int argc, char* argv[]);
 
 bool cbInstrConfig(int argc, char* argv[]);
-bool cbInstrRestartadmin(int argc, char* argv[]);
\ No newline at end of file
+bool cbInstrRestartadmin(int argc, char* argv[]);
+bool cbInstrLockTelemetry(int argc, char* argv[]);
+bool cbInstrPerf(int argc, char* argv[]);
+bool cbInstrEventStats(int argc, char* argv[]);
\ No newline at end of file
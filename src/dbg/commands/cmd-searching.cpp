@@ -10,6 +10,11 @@
 #include "stringformat.h"
 #include "disasm_helper.h"
 #include "symbolinfo.h"
+#include "stringsearch.h"
+#include "xrefs.h"
+#include "module.h"
+#include "console.h"
+#include <ppl.h>
 
 static int maxFindResults = 5000;
 
@@ -168,13 +173,13 @@ bool cbInstrFindAll(int argc, char* argv[])
         find_size = size - start;
 
     //setup reference view
-    String patterntitle = StringUtils::sprintf(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Pattern: %s")), patternshort.c_str());
+    String patterntitle = StringUtils::sprintf(dtranslate(QT_TRANSLATE_NOOP("DBG", "Pattern: %s")), patternshort.c_str());
     GuiReferenceInitialize(patterntitle.c_str());
-    GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
+    GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
     if(findData)
-        GuiReferenceAddColumn(0, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Data")));
+        GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Data")));
     else
-        GuiReferenceAddColumn(0, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
     GuiReferenceSetRowCount(0);
     GuiReferenceReloadData();
     DWORD ticks = GetTickCount();
@@ -188,10 +193,9 @@ bool cbInstrFindAll(int argc, char* argv[])
             break;
         i += foundoffset + 1;
         result = addr + i - 1;
+        char addrText[deflen] = "";
+        sprintf_s(addrText, "%p", result);
         char msg[deflen] = "";
-        sprintf_s(msg, "%p", result);
-        GuiReferenceSetRowCount(refCount + 1);
-        GuiReferenceSetCellContent(refCount, 0, msg);
         if(findData)
         {
             Memory<unsigned char*> printData(searchpattern.size(), "cbInstrFindAll:printData");
@@ -206,12 +210,14 @@ bool cbInstrFindAll(int argc, char* argv[])
         else
         {
             if(!GuiGetDisassembly(result, msg))
-                strcpy_s(msg, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "[Error disassembling]")));
+                strcpy_s(msg, dtranslate(QT_TRANSLATE_NOOP("DBG", "[Error disassembling]")));
         }
-        GuiReferenceSetCellContent(refCount, 1, msg);
+        const char* cells[] = { addrText, msg };
+        RefAddRow(_countof(cells), cells);
         result++;
         refCount++;
     }
+    RefFlushRows();
     GuiReferenceReloadData();
     dprintf(QT_TRANSLATE_NOOP("DBG", "%d occurrences found in %ums\n"), refCount, GetTickCount() - ticks);
     varset("$result", refCount, false);
@@ -267,23 +273,22 @@ bool cbInstrFindAllMem(int argc, char* argv[])
     }
 
     //setup reference view
-    String patterntitle = StringUtils::sprintf(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Pattern: %s")), patternshort.c_str());
+    String patterntitle = StringUtils::sprintf(dtranslate(QT_TRANSLATE_NOOP("DBG", "Pattern: %s")), patternshort.c_str());
     GuiReferenceInitialize(patterntitle.c_str());
-    GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
+    GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
     if(findData)
-        GuiReferenceAddColumn(0, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Data")));
+        GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Data")));
     else
-        GuiReferenceAddColumn(0, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
     GuiReferenceSetRowCount(0);
     GuiReferenceReloadData();
 
     int refCount = 0;
     for(duint result : results)
     {
+        char addrText[deflen] = "";
+        sprintf_s(addrText, "%p", result);
         char msg[deflen] = "";
-        sprintf_s(msg, "%p", result);
-        GuiReferenceSetRowCount(refCount + 1);
-        GuiReferenceSetCellContent(refCount, 0, msg);
         if(findData)
         {
             Memory<unsigned char*> printData(searchpattern.size(), "cbInstrFindAll:printData");
@@ -298,12 +303,104 @@ bool cbInstrFindAllMem(int argc, char* argv[])
         else
         {
             if(!GuiGetDisassembly(result, msg))
-                strcpy_s(msg, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "[Error disassembling]")));
+                strcpy_s(msg, dtranslate(QT_TRANSLATE_NOOP("DBG", "[Error disassembling]")));
         }
-        GuiReferenceSetCellContent(refCount, 1, msg);
+        const char* cells[] = { addrText, msg };
+        RefAddRow(_countof(cells), cells);
         refCount++;
     }
 
+    RefFlushRows();
+    GuiReferenceReloadData();
+    dprintf(QT_TRANSLATE_NOOP("DBG", "%d occurrences found in %ums\n"), refCount, GetTickCount() - ticks);
+    varset("$result", refCount, false);
+
+    return true;
+}
+
+bool cbInstrFindAllMemMulti(int argc, char* argv[])
+{
+    if(IsArgumentsLessThan(argc, 3))
+        return false;
+
+    duint addr = 0;
+    if(!valfromstring(argv[1], &addr, false))
+        return false;
+
+    // The patterns are separated by '&' so a whole signature set can be
+    // passed as a single (quoted) argument and searched in one memory walk
+    std::vector<std::vector<PatternByte>> searchpatterns;
+    std::vector<String> patternshorts;
+    for(const auto & patterntext : StringUtils::Split(argv[2], '&'))
+    {
+        std::vector<PatternByte> searchpattern;
+        String patternshort;
+        if(!handlePatternArgument(patterntext.c_str(), searchpattern, &patternshort))
+        {
+            dprintf(QT_TRANSLATE_NOOP("DBG", "Failed to transform pattern \"%s\"!\n"), patterntext.c_str());
+            return false;
+        }
+        searchpatterns.push_back(std::move(searchpattern));
+        patternshorts.push_back(std::move(patternshort));
+    }
+    if(searchpatterns.empty())
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Failed to transform pattern!"));
+        return false;
+    }
+
+    duint find_size = -1;
+    if(argc >= 4 && !valfromstring(argv[3], &find_size))
+        find_size = -1;
+
+    SHARED_ACQUIRE(LockMemoryPages);
+    std::vector<SimplePage> searchPages;
+    for(auto & itr : memoryPages)
+    {
+        if(itr.second.mbi.State != MEM_COMMIT)
+            continue;
+        SimplePage page(duint(itr.second.mbi.BaseAddress), itr.second.mbi.RegionSize);
+        if(page.address >= addr && (find_size == -1 || page.address + page.size <= addr + find_size))
+            searchPages.push_back(page);
+    }
+    SHARED_RELEASE();
+
+    DWORD ticks = GetTickCount();
+
+    std::vector<std::vector<duint>> results;
+    if(!MemFindInMapMulti(searchPages, searchpatterns, results, maxFindResults))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "MemFindInMap failed!"));
+        return false;
+    }
+
+    //setup reference view
+    String patterntitle = StringUtils::sprintf(dtranslate(QT_TRANSLATE_NOOP("DBG", "Patterns: %d")), int(searchpatterns.size()));
+    GuiReferenceInitialize(patterntitle.c_str());
+    GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+    GuiReferenceAddColumn(20, dtranslate(QT_TRANSLATE_NOOP("DBG", "Pattern")));
+    GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+    GuiReferenceSetRowCount(0);
+    GuiReferenceReloadData();
+
+    int refCount = 0;
+    for(size_t p = 0; p < results.size(); p++)
+    {
+        for(duint result : results[p])
+        {
+            char addrText[deflen] = "";
+            sprintf_s(addrText, "%p", result);
+            char msg[deflen] = "";
+            if(!GuiGetDisassembly(result, msg))
+                strcpy_s(msg, dtranslate(QT_TRANSLATE_NOOP("DBG", "[Error disassembling]")));
+            const char* cells[] = { addrText, patternshorts[p].c_str(), msg };
+            RefAddRow(_countof(cells), cells);
+            refCount++;
+        }
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Pattern %s: %d occurrences\n"), patternshorts[p].c_str(), int(results[p].size()));
+    }
+
+    RefFlushRows();
     GuiReferenceReloadData();
     dprintf(QT_TRANSLATE_NOOP("DBG", "%d occurrences found in %ums\n"), refCount, GetTickCount() - ticks);
     varset("$result", refCount, false);
@@ -316,8 +413,8 @@ static bool cbFindAsm(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO*
     if(!disasm || !basicinfo) //initialize
     {
         GuiReferenceInitialize(refinfo->name);
-        GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
-        GuiReferenceAddColumn(0, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+        GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
         GuiReferenceSetRowCount(0);
         GuiReferenceReloadData();
         return true;
@@ -328,13 +425,16 @@ static bool cbFindAsm(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO*
     {
         char addrText[20] = "";
         sprintf_s(addrText, "%p", disasm->Address());
-        GuiReferenceSetRowCount(refinfo->refcount + 1);
-        GuiReferenceSetCellContent(refinfo->refcount, 0, addrText);
         char disassembly[GUI_MAX_DISASSEMBLY_SIZE] = "";
-        if(GuiGetDisassembly((duint)disasm->Address(), disassembly))
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disassembly);
-        else
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disasm->InstructionText().c_str());
+        String fallback;
+        const char* disasmCell = disassembly;
+        if(!GuiGetDisassembly((duint)disasm->Address(), disassembly))
+        {
+            fallback = disasm->InstructionText();
+            disasmCell = fallback.c_str();
+        }
+        const char* cells[] = { addrText, disasmCell };
+        RefAddRow(_countof(cells), cells);
     }
     return found;
 }
@@ -372,7 +472,7 @@ bool cbInstrFindAsm(int argc, char* argv[])
 
     duint ticks = GetTickCount();
     char title[256] = "";
-    sprintf_s(title, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Command: \"%s\"")), basicinfo.instruction);
+    sprintf_s(title, dtranslate(QT_TRANSLATE_NOOP("DBG", "Command: \"%s\"")), basicinfo.instruction);
     int found = RefFind(addr, size, cbFindAsm, (void*)&basicinfo.instruction[0], false, title, (REFFINDTYPE)refFindType, true);
     dprintf(QT_TRANSLATE_NOOP("DBG", "%u result(s) in %ums\n"), DWORD(found), GetTickCount() - DWORD(ticks));
     varset("$result", found, false);
@@ -404,8 +504,8 @@ static bool cbRefFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO*
     if(!disasm || !basicinfo) //initialize
     {
         GuiReferenceInitialize(refinfo->name);
-        GuiReferenceAddColumn(sizeof(duint) * 2, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
-        GuiReferenceAddColumn(100, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(sizeof(duint) * 2, dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+        GuiReferenceAddColumn(100, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
         GuiReferenceSetRowCount(0);
         GuiReferenceReloadData();
         return true;
@@ -436,13 +536,16 @@ static bool cbRefFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO*
     {
         char addrText[20] = "";
         sprintf_s(addrText, "%p", disasm->Address());
-        GuiReferenceSetRowCount(refinfo->refcount + 1);
-        GuiReferenceSetCellContent(refinfo->refcount, 0, addrText);
         char disassembly[GUI_MAX_DISASSEMBLY_SIZE] = "";
-        if(GuiGetDisassembly((duint)disasm->Address(), disassembly))
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disassembly);
-        else
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disasm->InstructionText().c_str());
+        String fallback;
+        const char* disasmCell = disassembly;
+        if(!GuiGetDisassembly((duint)disasm->Address(), disassembly))
+        {
+            fallback = disasm->InstructionText();
+            disasmCell = fallback.c_str();
+        }
+        const char* cells[] = { addrText, disasmCell };
+        RefAddRow(_countof(cells), cells);
     }
     return found;
 }
@@ -466,9 +569,9 @@ bool cbInstrRefFindRange(int argc, char* argv[])
     duint ticks = GetTickCount();
     char title[256] = "";
     if(range.start == range.end)
-        sprintf_s(title, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Constant: %p")), range.start);
+        sprintf_s(title, dtranslate(QT_TRANSLATE_NOOP("DBG", "Constant: %p")), range.start);
     else
-        sprintf_s(title, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Range: %p-%p")), range.start, range.end);
+        sprintf_s(title, dtranslate(QT_TRANSLATE_NOOP("DBG", "Range: %p-%p")), range.start, range.end);
 
     duint refFindType = CURRENT_REGION;
     if(argc >= 6 && valfromstring(argv[5], &refFindType, true))
@@ -486,9 +589,9 @@ static bool cbRefStr(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO*
     if(!disasm || !basicinfo) //initialize
     {
         GuiReferenceInitialize(refinfo->name);
-        GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
-        GuiReferenceAddColumn(100, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
-        GuiReferenceAddColumn(500, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "String")));
+        GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+        GuiReferenceAddColumn(100, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(500, dtranslate(QT_TRANSLATE_NOOP("DBG", "String")));
         GuiReferenceSetSearchStartCol(2); //only search the strings
         GuiReferenceSetRowCount(0);
         GuiReferenceReloadData();
@@ -502,14 +605,16 @@ static bool cbRefStr(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO*
     {
         char addrText[20] = "";
         sprintf_s(addrText, "%p", disasm->Address());
-        GuiReferenceSetRowCount(refinfo->refcount + 1);
-        GuiReferenceSetCellContent(refinfo->refcount, 0, addrText);
         char disassembly[4096] = "";
-        if(GuiGetDisassembly((duint)disasm->Address(), disassembly))
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disassembly);
-        else
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disasm->InstructionText().c_str());
-        GuiReferenceSetCellContent(refinfo->refcount, 2, string);
+        String fallback;
+        const char* disasmCell = disassembly;
+        if(!GuiGetDisassembly((duint)disasm->Address(), disassembly))
+        {
+            fallback = disasm->InstructionText();
+            disasmCell = fallback.c_str();
+        }
+        const char* cells[] = { addrText, disasmCell, string };
+        RefAddRow(_countof(cells), cells);
         refinfo->refcount++;
     };
     if((basicinfo->type & TYPE_VALUE) == TYPE_VALUE)
@@ -530,10 +635,10 @@ static bool cbRefFuncPtr(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFIN
     if(!disasm || !basicinfo) //initialize
     {
         GuiReferenceInitialize(refinfo->name);
-        GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
-        GuiReferenceAddColumn(100, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
-        GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Function pointer")));
-        GuiReferenceAddColumn(500, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Label")));
+        GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+        GuiReferenceAddColumn(100, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Function pointer")));
+        GuiReferenceAddColumn(500, dtranslate(QT_TRANSLATE_NOOP("DBG", "Label")));
         GuiReferenceSetSearchStartCol(2); //only search the function pointers
         GuiReferenceSetRowCount(0);
         GuiReferenceReloadData();
@@ -546,19 +651,21 @@ static bool cbRefFuncPtr(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFIN
     {
         char addrText[20] = "";
         sprintf_s(addrText, "%p", disasm->Address());
-        GuiReferenceSetRowCount(refinfo->refcount + 1);
-        GuiReferenceSetCellContent(refinfo->refcount, 0, addrText);
         char disassembly[4096] = "";
-        if(GuiGetDisassembly((duint)disasm->Address(), disassembly))
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disassembly);
-        else
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disasm->InstructionText().c_str());
+        String fallback;
+        const char* disasmCell = disassembly;
+        if(!GuiGetDisassembly((duint)disasm->Address(), disassembly))
+        {
+            fallback = disasm->InstructionText();
+            disasmCell = fallback.c_str();
+        }
+        char pointerText[20] = "";
+        sprintf_s(pointerText, "%p", pointer);
         char label[MAX_LABEL_SIZE];
-        sprintf_s(addrText, "%p", pointer);
         memset(label, 0, sizeof(label));
         DbgGetLabelAt(pointer, SEG_DEFAULT, label);
-        GuiReferenceSetCellContent(refinfo->refcount, 2, addrText);
-        GuiReferenceSetCellContent(refinfo->refcount, 3, label);
+        const char* cells[] = { addrText, disasmCell, pointerText, label };
+        RefAddRow(_countof(cells), cells);
         refinfo->refcount++;
     };
     if((basicinfo->type & TYPE_VALUE) == TYPE_VALUE)
@@ -593,13 +700,95 @@ bool cbInstrRefStr(int argc, char* argv[])
         if(refFindType != CURRENT_REGION && refFindType != CURRENT_MODULE && refFindType != ALL_MODULES)
             refFindType = CURRENT_REGION;
 
-    TranslatedString = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Strings"));
+    TranslatedString = dtranslate(QT_TRANSLATE_NOOP("DBG", "Strings"));
     int found = RefFind(addr, size, cbRefStr, 0, false, TranslatedString.c_str(), (REFFINDTYPE)refFindType, false);
     dprintf(QT_TRANSLATE_NOOP("DBG", "%u string(s) in %ums\n"), DWORD(found), GetTickCount() - DWORD(ticks));
     varset("$result", found, false);
     return true;
 }
 
+bool cbInstrFindStrings(int argc, char* argv[])
+{
+    duint ticks = GetTickCount();
+
+    // If not specified, assume the module at CIP by default
+    duint addr;
+    if(argc < 2 || !valfromstring(argv[1], &addr, true))
+        addr = GetContextDataEx(hActiveThread, UE_CIP);
+    duint minLength = 5;
+    if(argc >= 3 && (!valfromstring(argv[2], &minLength) || minLength < 2))
+        minLength = 5;
+
+    duint base = ModBaseFromAddr(addr);
+    duint size = ModSizeFromAddr(addr);
+    if(!base)
+        base = MemFindBaseAddr(addr, &size);
+    if(!base)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Invalid address!"));
+        return false;
+    }
+
+    SHARED_ACQUIRE(LockMemoryPages);
+    std::vector<SimplePage> searchPages;
+    for(auto & itr : memoryPages)
+    {
+        if(itr.second.mbi.State != MEM_COMMIT)
+            continue;
+        SimplePage page(duint(itr.second.mbi.BaseAddress), itr.second.mbi.RegionSize);
+        if(page.address >= base && page.address + page.size <= base + size)
+            searchPages.push_back(page);
+    }
+    SHARED_RELEASE();
+
+    // The raw pages are classified for printable runs without any
+    // disassembly, so the scan is bounded by memory bandwidth
+    duint total = searchPages.size();
+    std::vector<std::vector<FoundString>> pageResults(total);
+    concurrency::parallel_for(duint(0), total, [&](duint i)
+    {
+        Memory<unsigned char*> data(searchPages[i].size);
+        if(MemRead(searchPages[i].address, data(), data.size()))
+            stringsearch(data(), data.size(), searchPages[i].address, minLength, pageResults[i]);
+    });
+
+    //setup reference view
+    String title = StringUtils::sprintf(dtranslate(QT_TRANSLATE_NOOP("DBG", "Strings in %p-%p")), base, base + size - 1);
+    GuiReferenceInitialize(title.c_str());
+    GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+    GuiReferenceAddColumn(8, dtranslate(QT_TRANSLATE_NOOP("DBG", "Type")));
+    GuiReferenceAddColumn(10, dtranslate(QT_TRANSLATE_NOOP("DBG", "References")));
+    GuiReferenceAddColumn(500, dtranslate(QT_TRANSLATE_NOOP("DBG", "String")));
+    GuiReferenceSetSearchStartCol(3); //only search the strings
+    GuiReferenceSetRowCount(0);
+    GuiReferenceReloadData();
+
+    int refCount = 0;
+    for(const auto & pageFound : pageResults)
+    {
+        for(const auto & found : pageFound)
+        {
+            char addrText[20] = "";
+            sprintf_s(addrText, "%p", found.addr);
+            // Join against the xref index filled by analysis
+            char xrefText[20] = "";
+            auto xrefCount = XrefGetCount(found.addr);
+            if(xrefCount)
+                sprintf_s(xrefText, "%u", unsigned(xrefCount));
+            auto text = StringUtils::sprintf(found.unicode ? "L\"%s\"" : "\"%s\"", StringUtils::Escape(found.text).c_str());
+            const char* cells[] = { addrText, found.unicode ? "UNICODE" : "ASCII", xrefText, text.c_str() };
+            RefAddRow(_countof(cells), cells);
+            refCount++;
+        }
+    }
+
+    RefFlushRows();
+    GuiReferenceReloadData();
+    dprintf(QT_TRANSLATE_NOOP("DBG", "%u string(s) in %ums\n"), DWORD(refCount), GetTickCount() - DWORD(ticks));
+    varset("$result", refCount, false);
+    return true;
+}
+
 bool cbInstrRefFuncionPointer(int argc, char* argv[])
 {
     duint ticks = GetTickCount();
@@ -619,7 +808,7 @@ bool cbInstrRefFuncionPointer(int argc, char* argv[])
         if(refFindType != CURRENT_REGION && refFindType != CURRENT_MODULE && refFindType != ALL_MODULES)
             refFindType = CURRENT_REGION;
 
-    TranslatedString = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Function pointers"));
+    TranslatedString = dtranslate(QT_TRANSLATE_NOOP("DBG", "Function pointers"));
     int found = RefFind(addr, size, cbRefFuncPtr, 0, false, TranslatedString.c_str(), (REFFINDTYPE)refFindType, false);
     dprintf(QT_TRANSLATE_NOOP("DBG", "%u function pointer(s) in %ums\n"), DWORD(found), GetTickCount() - DWORD(ticks));
     varset("$result", found, false);
@@ -631,9 +820,9 @@ static bool cbModCallFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFI
     if(!disasm || !basicinfo) //initialize
     {
         GuiReferenceInitialize(refinfo->name);
-        GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
-        GuiReferenceAddColumn(100, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
-        GuiReferenceAddColumn(MAX_LABEL_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Destination")));
+        GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+        GuiReferenceAddColumn(100, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(MAX_LABEL_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Destination")));
         GuiReferenceSetRowCount(0);
         GuiReferenceReloadData();
         return true;
@@ -692,19 +881,16 @@ static bool cbModCallFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFI
             symbolic = StringUtils::sprintf("%p", foundaddr);
         char addrText[20] = "";
         sprintf_s(addrText, "%p", disasm->Address());
-        GuiReferenceSetRowCount(refinfo->refcount + 1);
-        GuiReferenceSetCellContent(refinfo->refcount, 0, addrText);
         char disassembly[GUI_MAX_DISASSEMBLY_SIZE] = "";
-        if(GuiGetDisassembly((duint)disasm->Address(), disassembly))
+        String fallback;
+        const char* disasmCell = disassembly;
+        if(!GuiGetDisassembly((duint)disasm->Address(), disassembly))
         {
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disassembly);
-            GuiReferenceSetCellContent(refinfo->refcount, 2, symbolic.c_str());
-        }
-        else
-        {
-            GuiReferenceSetCellContent(refinfo->refcount, 1, disasm->InstructionText().c_str());
-            GuiReferenceSetCellContent(refinfo->refcount, 2, symbolic.c_str());
+            fallback = disasm->InstructionText();
+            disasmCell = fallback.c_str();
         }
+        const char* cells[] = { addrText, disasmCell, symbolic.c_str() };
+        RefAddRow(_countof(cells), cells);
     }
     return foundaddr != 0;
 }
@@ -725,7 +911,7 @@ bool cbInstrModCallFind(int argc, char* argv[])
             refFindType = CURRENT_REGION;
 
     duint ticks = GetTickCount();
-    String Calls = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Calls"));
+    String Calls = dtranslate(QT_TRANSLATE_NOOP("DBG", "Calls"));
     int found = RefFind(addr, size, cbModCallFind, 0, false, Calls.c_str(), (REFFINDTYPE)refFindType, false);
     dprintf(QT_TRANSLATE_NOOP("DBG", "%u call(s) in %ums\n"), DWORD(found), GetTickCount() - DWORD(ticks));
     varset("$result", found, false);
@@ -821,12 +1007,12 @@ static bool cbGUIDFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO
     if(!disasm || !basicinfo) //initialize
     {
         GuiReferenceInitialize(refinfo->name);
-        GuiReferenceAddColumn(2 * sizeof(duint), GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Address")));
-        GuiReferenceAddColumn(100, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
-        GuiReferenceAddColumn(40, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "GUID")));
-        GuiReferenceAddColumn(20, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "ProgId")));
-        GuiReferenceAddColumn(40, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Path")));
-        GuiReferenceAddColumn(40, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Description")));
+        GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+        GuiReferenceAddColumn(100, dtranslate(QT_TRANSLATE_NOOP("DBG", "Disassembly")));
+        GuiReferenceAddColumn(40, dtranslate(QT_TRANSLATE_NOOP("DBG", "GUID")));
+        GuiReferenceAddColumn(20, dtranslate(QT_TRANSLATE_NOOP("DBG", "ProgId")));
+        GuiReferenceAddColumn(40, dtranslate(QT_TRANSLATE_NOOP("DBG", "Path")));
+        GuiReferenceAddColumn(40, dtranslate(QT_TRANSLATE_NOOP("DBG", "Description")));
         GuiReferenceSetRowCount(0);
         GuiReferenceReloadData();
         return true;
@@ -887,16 +1073,17 @@ static bool cbGUIDFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO
         {
             char addrText[20] = "";
             sprintf_s(addrText, "%p", disasm->Address());
-            GuiReferenceSetRowCount(refinfo->refcount + 1);
-            GuiReferenceSetCellContent(refinfo->refcount, 0, addrText);
             char disassembly[4096] = "";
-            if(GuiGetDisassembly((duint)disasm->Address(), disassembly))
-                GuiReferenceSetCellContent(refinfo->refcount, 1, disassembly);
-            else
-                GuiReferenceSetCellContent(refinfo->refcount, 1, disasm->InstructionText().c_str());
+            String fallback;
+            const char* disasmCell = disassembly;
+            if(!GuiGetDisassembly((duint)disasm->Address(), disassembly))
+            {
+                fallback = disasm->InstructionText();
+                disasmCell = fallback.c_str();
+            }
             wchar_t guidText[40];
             StringFromGUID2(guid, guidText, 40);
-            GuiReferenceSetCellContent(refinfo->refcount, 2, StringUtils::Utf16ToUtf8(guidText).c_str());
+            auto guidUtf8 = StringUtils::Utf16ToUtf8(guidText);
             size_t infoIndex = iterator->second;
             if(infoIndex == 0)
             {
@@ -905,9 +1092,9 @@ static bool cbGUIDFind(Zydis* disasm, BASIC_INSTRUCTION_INFO* basicinfo, REFINFO
                 refInfo->allRegisteredGUIDs->at(guid) = infoIndex;
             }
             infoIndex--;
-            GuiReferenceSetCellContent(refinfo->refcount, 3, refInfo->allQueriedGUIDs->at(infoIndex).ProgId.c_str());
-            GuiReferenceSetCellContent(refinfo->refcount, 4, refInfo->allQueriedGUIDs->at(infoIndex).Path.c_str());
-            GuiReferenceSetCellContent(refinfo->refcount, 5, refInfo->allQueriedGUIDs->at(infoIndex).Description.c_str());
+            const GUIDInfo & guidInfo = refInfo->allQueriedGUIDs->at(infoIndex);
+            const char* cells[] = { addrText, disasmCell, guidUtf8.c_str(), guidInfo.ProgId.c_str(), guidInfo.Path.c_str(), guidInfo.Description.c_str() };
+            RefAddRow(_countof(cells), cells);
         }
     }
     return found;
@@ -966,7 +1153,7 @@ bool cbInstrGUIDFind(int argc, char* argv[])
     refInfo.allRegisteredGUIDs = &allRegisteredGUIDs;
     refInfo.CLSID = CLSID;
 
-    TranslatedString = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "GUID"));
+    TranslatedString = dtranslate(QT_TRANSLATE_NOOP("DBG", "GUID"));
     int found = RefFind(addr, size, cbGUIDFind, &refInfo, false, TranslatedString.c_str(), (REFFINDTYPE)refFindType, false);
     dprintf(QT_TRANSLATE_NOOP("DBG", "%u GUID(s) in %ums\n"), DWORD(found), GetTickCount() - DWORD(ticks));
     varset("$result", found, false);
@@ -974,6 +1161,66 @@ bool cbInstrGUIDFind(int argc, char* argv[])
     return true;
 }
 
+bool cbInstrPointerScan(int argc, char* argv[])
+{
+    if(IsArgumentsLessThan(argc, 2))
+        return false;
+    duint target = 0;
+    if(!valfromstring(argv[1], &target, false))
+        return false;
+    duint maxDepth = 3;
+    if(argc > 2 && !valfromstring(argv[2], &maxDepth, false))
+        return false;
+    if(!maxDepth || maxDepth > 16)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Invalid depth (expected 1-16)!"));
+        return false;
+    }
+    duint maxOffset = 0x3FF;
+    if(argc > 3 && !valfromstring(argv[3], &maxOffset, false))
+        return false;
+
+    duint ticks = GetTickCount();
+    std::vector<PointerChain> chains;
+    if(!PointerScan(target, int(maxDepth), maxOffset, maxFindResults, chains))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "No committed memory to scan!"));
+        return false;
+    }
+
+    //setup reference view
+    String title = StringUtils::sprintf(dtranslate(QT_TRANSLATE_NOOP("DBG", "Pointer chains to %p")), target);
+    GuiReferenceInitialize(title.c_str());
+    GuiReferenceAddColumn(2 * sizeof(duint), dtranslate(QT_TRANSLATE_NOOP("DBG", "Address")));
+    GuiReferenceAddColumn(0, dtranslate(QT_TRANSLATE_NOOP("DBG", "Pointer chain")));
+    GuiReferenceSetRowCount(0);
+    GuiReferenceReloadData();
+
+    for(const auto & chain : chains)
+    {
+        auto root = chain.front().location;
+        char addrText[deflen] = "";
+        sprintf_s(addrText, "%p", root);
+        String expr;
+        char modname[MAX_MODULE_SIZE] = "";
+        auto modbase = ModBaseFromAddr(root);
+        if(modbase && ModNameFromAddr(root, modname, true))
+            expr = StringUtils::sprintf("%s+%X", modname, root - modbase);
+        else
+            expr = StringUtils::sprintf("%p", root);
+        for(const auto & link : chain)
+            expr = StringUtils::sprintf("[%s]+%X", expr.c_str(), link.offset);
+        const char* cells[] = { addrText, expr.c_str() };
+        RefAddRow(_countof(cells), cells);
+    }
+
+    RefFlushRows();
+    GuiReferenceReloadData();
+    dprintf(QT_TRANSLATE_NOOP("DBG", "%d pointer chain(s) found in %ums\n"), int(chains.size()), GetTickCount() - DWORD(ticks));
+    varset("$result", chains.size(), false);
+    return true;
+}
+
 bool cbInstrSetMaxFindResult(int argc, char* argv[])
 {
     if(IsArgumentsLessThan(argc, 2))
@@ -86,6 +86,7 @@ bool cbDebugSuspendthread(int argc, char* argv[])
         return false;
     }
     dputs(QT_TRANSLATE_NOOP("DBG", "Thread suspended"));
+    ThreadDetailsInvalidate();
     GuiUpdateAllViews();
     return true;
 }
@@ -108,6 +109,7 @@ bool cbDebugResumethread(int argc, char* argv[])
         return false;
     }
     dputs(QT_TRANSLATE_NOOP("DBG", "Thread resumed!"));
+    ThreadDetailsInvalidate();
     GuiUpdateAllViews();
     return true;
 }
@@ -213,6 +215,7 @@ bool cbDebugSetPriority(int argc, char* argv[])
         return false;
     }
     dputs(QT_TRANSLATE_NOOP("DBG", "Thread priority changed!"));
+    ThreadDetailsInvalidate();
     GuiUpdateAllViews();
     return true;
 }
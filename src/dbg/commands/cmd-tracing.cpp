@@ -171,6 +171,36 @@ bool cbDebugTraceSetLogFile(int argc, char* argv[])
     return dbgsettracelogfile(fileName);
 }
 
+bool cbDebugTraceSetFast(int argc, char* argv[])
+{
+    duint enabled = 1;
+    if(argc > 1 && !valfromstring(argv[1], &enabled, false))
+        return false;
+    if(!dbgsettracefast(!!enabled))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Trace already active"));
+        return false;
+    }
+    if(enabled)
+        dputs(QT_TRANSLATE_NOOP("DBG", "Fast trace enabled: only the stop condition is evaluated per step, log/command/switch conditions are ignored"));
+    return true;
+}
+
+bool cbDebugTraceSetBranchStep(int argc, char* argv[])
+{
+    duint enabled = 1;
+    if(argc > 1 && !valfromstring(argv[1], &enabled, false))
+        return false;
+    if(!dbgsettracebranchstep(!!enabled))
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "Trace already active"));
+        return false;
+    }
+    if(enabled)
+        dputs(QT_TRANSLATE_NOOP("DBG", "Branch step trace enabled: one debug event per basic block, conditions are evaluated at branches and branch targets only"));
+    return true;
+}
+
 bool cbDebugStartRunTrace(int argc, char* argv[])
 {
     if(IsArgumentsLessThan(argc, 2))
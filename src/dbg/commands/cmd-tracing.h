@@ -14,5 +14,7 @@ bool cbDebugTraceSetLog(int argc, char* argv[]);
 bool cbDebugTraceSetCommand(int argc, char* argv[]);
 bool cbDebugTraceSetSwitchCondition(int argc, char* argv[]);
 bool cbDebugTraceSetLogFile(int argc, char* argv[]);
+bool cbDebugTraceSetFast(int argc, char* argv[]);
+bool cbDebugTraceSetBranchStep(int argc, char* argv[]);
 bool cbDebugStartRunTrace(int argc, char* argv[]);
 bool cbDebugStopRunTrace(int argc, char* argv[]);
\ No newline at end of file
@@ -12,6 +12,13 @@
 #include "value.h"
 #include "symbolinfo.h"
 #include "argument.h"
+#include "memory.h"
+#include "patternfind.h"
+#include "expressionparser.h"
+#include "breakpoint.h"
+#include "module.h"
+#include "database.h"
+#include <functional>
 
 bool cbBadCmd(int argc, char* argv[])
 {
@@ -98,18 +105,116 @@ bool cbBadCmd(int argc, char* argv[])
 
 bool cbDebugBenchmark(int argc, char* argv[])
 {
-    duint addr = MemFindBaseAddr(GetContextDataEx(hActiveThread, UE_CIP), 0);
-    DWORD ticks = GetTickCount();
-    for(duint i = addr; i < addr + 100000; i++)
-    {
-        CommentSet(i, "test", false);
-        LabelSet(i, "test", false);
-        BookmarkSet(i, false);
-        FunctionAdd(i, i, false);
-        ArgumentAdd(i, i, false);
-        LoopAdd(i, i, false);
+    // Microbenchmark suite for the hot paths that tend to regress between
+    // releases. Usage: bench [name] [iterations]. Each benchmark prints one
+    // machine-readable line
+    //   BENCH,<name>,<iterations>,<total ms>,<us/op>
+    // so the timings can be diffed across versions. Without a name the whole
+    // suite runs with default iteration counts. Note that "addrinfo" floods
+    // the current database with synthetic entries, like this command always
+    // did.
+    String filter = argc > 1 ? argv[1] : "";
+    duint iterArg = 0;
+    if(argc > 2)
+        valfromstring(argv[2], &iterArg);
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    auto runBench = [&](const char* name, duint defaultIterations, const std::function<void(duint)> & body)
+    {
+        if(!filter.empty() && filter != name)
+            return;
+        auto iterations = iterArg ? iterArg : defaultIterations;
+        LARGE_INTEGER start, end;
+        QueryPerformanceCounter(&start);
+        body(iterations);
+        QueryPerformanceCounter(&end);
+        auto totalMs = double(end.QuadPart - start.QuadPart) * 1000.0 / double(frequency.QuadPart);
+        dprintf_untranslated("BENCH,%s,%llu,%.3f,%.3f\n", name, (unsigned long long)iterations, totalMs, totalMs * 1000.0 / double(iterations));
+    };
+
+    auto cip = GetContextDataEx(hActiveThread, UE_CIP);
+    auto base = MemFindBaseAddr(cip, 0);
+
+    //page-straddling reads exercise the splitting in MemRead
+    runBench("memread", 100000, [base](duint iterations)
+    {
+        unsigned char buffer[0x300];
+        for(duint i = 0; i < iterations; i++)
+            MemRead(base + 0xF00 + (i & 0xFF), buffer, sizeof(buffer));
+    });
+
+    //pattern scan over a synthetic buffer without a match
+    std::vector<unsigned char> patternData;
+    if(filter.empty() || filter == "patternfind")
+    {
+        patternData.resize(16 * 1024 * 1024);
+        unsigned int seed = 0x1337;
+        for(auto & b : patternData)
+        {
+            seed = seed * 1103515245 + 12345;
+            b = (unsigned char)(seed >> 16);
+        }
     }
-    dprintf_untranslated("%ums\n", GetTickCount() - ticks);
+    runBench("patternfind", 16, [&patternData](duint iterations)
+    {
+        for(duint i = 0; i < iterations; i++)
+            patternfind(patternData.data(), patternData.size(), "11 22 ?? 44 55 66 77 88 99");
+    });
+
+    //expression parsing and evaluation
+    runBench("expression", 10000, [](duint iterations)
+    {
+        duint value = 0;
+        for(duint i = 0; i < iterations; i++)
+            valfromstring("cax*2+1000/4+cbx", &value);
+    });
+
+    //breakpoint lookup at addresses without a breakpoint (the common case)
+    runBench("bplookup", 1000000, [cip](duint iterations)
+    {
+        BREAKPOINT bp;
+        for(duint i = 0; i < iterations; i++)
+            BpGet(cip + (i & 0xFFF), BPNORMAL, nullptr, &bp);
+    });
+
+    //module name resolution, the render path hot spot
+    runBench("modname", 1000000, [cip](duint iterations)
+    {
+        char name[MAX_MODULE_SIZE] = "";
+        for(duint i = 0; i < iterations; i++)
+            ModNameFromAddr(cip + (i & 0xFFF), name, true);
+    });
+
+    //database save/load round trips over the current session data
+    auto benchDbPath = StringUtils::sprintf("%s\\bench.db.tmp", szSymbolCachePath);
+    runBench("dbsave", 4, [&benchDbPath](duint iterations)
+    {
+        for(duint i = 0; i < iterations; i++)
+            DbSave(DbLoadSaveType::DebugData, benchDbPath.c_str(), true);
+    });
+    if(filter == "dbload" && !FileExists(benchDbPath.c_str()))
+        DbSave(DbLoadSaveType::DebugData, benchDbPath.c_str(), true);
+    runBench("dbload", 4, [&benchDbPath](duint iterations)
+    {
+        for(duint i = 0; i < iterations; i++)
+            DbLoad(DbLoadSaveType::DebugData, benchDbPath.c_str());
+    });
+    DeleteFileW(StringUtils::Utf8ToUtf16(benchDbPath).c_str());
+
+    //the original address-info stress test (100000 of each entry type)
+    runBench("addrinfo", 100000, [base](duint iterations)
+    {
+        for(duint i = base; i < base + iterations; i++)
+        {
+            CommentSet(i, "test", false);
+            LabelSet(i, "test", false);
+            BookmarkSet(i, false);
+            FunctionAdd(i, i, false);
+            ArgumentAdd(i, i, false);
+            LoopAdd(i, i, false);
+        }
+    });
     return true;
 }
 
@@ -488,10 +593,19 @@ bool cbInstrFocusinfo(int argc, char* argv[])
 
 bool cbInstrFlushlog(int argc, char* argv[])
 {
+    dlogflush();
     GuiFlushLog();
     return true;
 }
 
+bool cbInstrLossyLog(int argc, char* argv[])
+{
+    if(argc > 1)
+        dloglossy(*argv[1] == '1' || _stricmp(argv[1], "on") == 0);
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Lossy logging mode is %s\n"), dlogislossy() ? "on" : "off");
+    return true;
+}
+
 extern char animate_command[deflen];
 
 bool cbInstrAnimateWait(int argc, char* argv[])
@@ -13,6 +13,7 @@ bool cbInstrMeminfo(int argc, char* argv[]);
 bool cbInstrBriefcheck(int argc, char* argv[]);
 bool cbInstrFocusinfo(int argc, char* argv[]);
 bool cbInstrFlushlog(int argc, char* argv[]);
+bool cbInstrLossyLog(int argc, char* argv[]);
 bool cbInstrAnimateWait(int argc, char* argv[]);
 bool cbInstrDbdecompress(int argc, char* argv[]);
 bool cbInstrDebugFlags(int argc, char* argv[]);
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "cmd-watch-control.h"
 #include "variable.h"
 #include "watch.h"
+#include "memwatch.h"
 #include "console.h"
 #include "threading.h"
 
@@ -183,17 +184,23 @@ bool cbSetWatchName(int argc, char* argv[])
 
 bool cbCheckWatchdog(int argc, char* argv[])
 {
+    MemWatchPoll(); // one read per distinct watched range, marks the changed ones
     EXCLUSIVE_ACQUIRE(LockWatch);
     bool watchdogTriggered = false;
+    bool valueChanged = false;
     for(auto j = watchexpr.begin(); j != watchexpr.end(); ++j)
     {
-        std::pair<unsigned int, WatchExpr*> i = *j;
-        i.second->watchdogTriggered = false;
-        duint intVal = i.second->getIntValue();
-        watchdogTriggered |= i.second->watchdogTriggered;
+        WatchExpr* watch = j->second;
+        watch->watchdogTriggered = false;
+        if(!watch->needsRefresh()) // no dependency changed, the cached value is still valid
+            continue;
+        duint prevValue = watch->getCurrIntValue();
+        watch->getIntValue();
+        valueChanged |= watch->getCurrIntValue() != prevValue;
+        watchdogTriggered |= watch->watchdogTriggered;
     }
     EXCLUSIVE_RELEASE();
-    if(watchdogTriggered)
+    if(watchdogTriggered || valueChanged) // one batched view update for all watches
         GuiUpdateWatchViewAsync();
     varset("$result", watchdogTriggered ? 1 : 0, false);
     return true;
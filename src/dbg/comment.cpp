@@ -1,4 +1,5 @@
 #include "comment.h"
+#include "dbjournal.h"
 
 struct CommentSerializer : AddrInfoSerializer<COMMENTSINFO>
 {
@@ -11,8 +12,11 @@ struct CommentSerializer : AddrInfoSerializer<COMMENTSINFO>
 
     bool Load(COMMENTSINFO & value) override
     {
-        return AddrInfoSerializer::Load(value) &&
-               getString("text", value.text);
+        std::string text;
+        if(!AddrInfoSerializer::Load(value) || !getString("text", text))
+            return false;
+        value.text = text;
+        return true;
     }
 };
 
@@ -42,7 +46,10 @@ bool CommentSet(duint Address, const char* Text, bool Manual)
     if(!comments.PrepareValue(comment, Address, Manual))
         return false;
     comment.text = Text;
-    return comments.Add(comment);
+    if(!comments.Add(comment))
+        return false;
+    DbJournalAddValue<CommentSerializer>("comments", comment);
+    return true;
 }
 
 bool CommentGet(duint Address, char* Text)
@@ -59,12 +66,21 @@ bool CommentGet(duint Address, char* Text)
 
 bool CommentDelete(duint Address)
 {
-    return comments.Delete(Comments::VaKey(Address));
+    if(!comments.Delete(Comments::VaKey(Address)))
+        return false;
+    DbJournalDeleteAt("comments", Address);
+    return true;
+}
+
+bool CommentDeleteByKey(duint Key)
+{
+    return comments.Delete(Key);
 }
 
 void CommentDelRange(duint Start, duint End, bool Manual)
 {
     comments.DeleteRange(Start, End, Manual);
+    DbJournalDelRangeAt("comments", Start, End, Manual);
 }
 
 void CommentCacheSave(JSON Root)
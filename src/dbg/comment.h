@@ -3,15 +3,17 @@
 
 #include "_global.h"
 #include "addrinfo.h"
+#include "stringpool.h"
 
 struct COMMENTSINFO : AddrInfo
 {
-    std::string text;
+    PooledString text; //auto comments repeat the same text across many addresses
 };
 
 bool CommentSet(duint Address, const char* Text, bool Manual);
 bool CommentGet(duint Address, char* Text);
 bool CommentDelete(duint Address);
+bool CommentDeleteByKey(duint Key);
 void CommentDelRange(duint Start, duint End, bool Manual);
 void CommentCacheSave(JSON Root);
 void CommentCacheLoad(JSON Root);
@@ -4,15 +4,197 @@
 */
 
 #include "console.h"
-#include "taskthread.h"
+#include <mutex>
+#include <unordered_map>
 
-static void GuiAddLogMessageAsync(_In_z_ const char* msg)
+// Asynchronous log engine: callers enqueue formatted lines into a bounded
+// ring and a log thread batches them into single GuiAddLogMessage calls, so
+// a flood of log lines (e.g. a log-condition breakpoint in a hot loop) does
+// not stall the debug thread on the bridge. In the default exact mode a
+// caller blocks when the ring is full and no line is ever lost; in lossy
+// mode (dloglossy) the line is dropped and a summary of the dropped count is
+// logged instead.
+class ConsoleLogEngine
 {
-    static StringConcatTaskThread_<void(*)(const std::string &)> task([](const std::string & msg)
+    static const size_t EntryTextSize = 504;
+    static const LONG RingSize = 512;
+
+    struct LOGENTRY
+    {
+        volatile LONG Ready;
+        DWORD Length;
+        char Text[EntryTextSize];
+    };
+
+public:
+    ConsoleLogEngine()
+    {
+        memset((void*)Entries, 0, sizeof(Entries));
+        FreeSlots = CreateSemaphoreW(nullptr, RingSize, RingSize, nullptr);
+        UsedSlots = CreateSemaphoreW(nullptr, 0, RingSize, nullptr);
+        StopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        hThread = CreateThread(nullptr, 0, LogThread, this, 0, nullptr);
+    }
+
+    ~ConsoleLogEngine()
+    {
+        SetEvent(StopEvent);
+        WaitForSingleObject(hThread, INFINITE);
+        CloseHandle(hThread);
+        CloseHandle(StopEvent);
+        CloseHandle(UsedSlots);
+        CloseHandle(FreeSlots);
+    }
+
+    void Add(const char* Text)
+    {
+        // A message longer than one entry is split over several entries; the
+        // chunks of one message stay in order because the ring is FIFO
+        size_t length = strlen(Text);
+        size_t offset = 0;
+        do
+        {
+            size_t chunk = length - offset;
+            if(chunk > EntryTextSize)
+                chunk = EntryTextSize;
+            if(!Enqueue(Text + offset, chunk))
+                return; //lossy mode dropped the line
+            offset += chunk;
+        }
+        while(offset < length);
+    }
+
+    void SetLossy(bool Enabled)
+    {
+        InterlockedExchange(&Lossy, Enabled ? 1 : 0);
+    }
+
+    bool IsLossy() const
+    {
+        return Lossy != 0;
+    }
+
+    // Block until every queued line has been handed to the GUI
+    void Flush()
+    {
+        while(InterlockedCompareExchange(&PendingCount, 0, 0) != 0)
+            Sleep(10);
+    }
+
+private:
+    bool Enqueue(const char* Data, size_t Size)
+    {
+        if(Lossy)
+        {
+            if(WaitForSingleObject(FreeSlots, 0) != WAIT_OBJECT_0) //ring full?
+            {
+                InterlockedIncrement(&DroppedLines);
+                return false;
+            }
+        }
+        else
+            WaitForSingleObject(FreeSlots, INFINITE);
+        auto & entry = Entries[ULONG(InterlockedIncrement(&EnqueuePos) - 1) & (RingSize - 1)];
+        memcpy(entry.Text, Data, Size);
+        entry.Length = DWORD(Size);
+        InterlockedIncrement(&PendingCount);
+        InterlockedExchange(&entry.Ready, 1); //orders the copy before the publish
+        ReleaseSemaphore(UsedSlots, 1, nullptr);
+        return true;
+    }
+
+    void Loop()
+    {
+        HANDLE waitHandles[2] = { UsedSlots, StopEvent };
+        String batch;
+        bool stopping = false;
+        for(;;)
+        {
+            auto wait = WaitForMultipleObjects(_countof(waitHandles), waitHandles, FALSE, INFINITE);
+            if(wait == WAIT_OBJECT_0 + 1)
+                stopping = true;
+            batch.clear();
+            LONG consumed = 0;
+            bool haveEntry = wait == WAIT_OBJECT_0 || WaitForSingleObject(UsedSlots, 0) == WAIT_OBJECT_0;
+            while(haveEntry)
+            {
+                auto & entry = Entries[ULONG(DequeuePos++) & (RingSize - 1)];
+                // A producer that claimed a later slot may have signalled
+                // before this one was published, the window is tiny
+                while(InterlockedCompareExchange(&entry.Ready, 0, 1) != 1)
+                    YieldProcessor();
+                batch.append(entry.Text, entry.Length);
+                ReleaseSemaphore(FreeSlots, 1, nullptr);
+                consumed++;
+                haveEntry = WaitForSingleObject(UsedSlots, 0) == WAIT_OBJECT_0;
+            }
+            auto dropped = InterlockedExchange(&DroppedLines, 0);
+            if(dropped > 0)
+                batch += StringUtils::sprintf(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "[%d log lines dropped in lossy logging mode]\n")), dropped);
+            if(!batch.empty())
+                GuiAddLogMessage(batch.c_str());
+            while(consumed--)
+                InterlockedDecrement(&PendingCount);
+            if(stopping)
+                return;
+            // Pace the GUI updates so a flood coalesces into few big appends
+            if(WaitForSingleObject(StopEvent, 100) == WAIT_OBJECT_0)
+                stopping = true; //loop once more to drain, then exit
+        }
+    }
+
+    static DWORD WINAPI LogThread(LPVOID self)
     {
-        GuiAddLogMessage(msg.c_str());
-    });
-    task.WakeUp(msg);
+        ((ConsoleLogEngine*)self)->Loop();
+        return 0;
+    }
+
+    LOGENTRY Entries[RingSize];
+    volatile LONG EnqueuePos = 0;
+    LONG DequeuePos = 0; //only touched by the log thread
+    volatile LONG Lossy = 0;
+    volatile LONG DroppedLines = 0;
+    volatile LONG PendingCount = 0;
+    HANDLE FreeSlots;
+    HANDLE UsedSlots;
+    HANDLE StopEvent;
+    HANDLE hThread;
+};
+
+static ConsoleLogEngine & LogEngine()
+{
+    static ConsoleLogEngine engine;
+    return engine;
+}
+
+// GuiTranslateText crosses the bridge and takes a global lock on every call,
+// which adds up when a single breakpoint hit logs several lines or a view
+// annotates every visible row. The language cannot change while the debugger
+// runs (switching requires a restart), so translations are cached by content.
+const char* dtranslate(_In_z_ const char* Source)
+{
+    static std::mutex cacheMutex;
+    static std::unordered_map<String, String> cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto found = cache.find(Source);
+    if(found == cache.end())
+        found = cache.emplace(Source, String(GuiTranslateText(Source))).first;
+    return found->second.c_str();
+}
+
+void dloglossy(bool Enabled)
+{
+    LogEngine().SetLossy(Enabled);
+}
+
+bool dlogislossy()
+{
+    return LogEngine().IsLossy();
+}
+
+void dlogflush()
+{
+    LogEngine().Flush();
 }
 
 /**
@@ -21,19 +203,7 @@ static void GuiAddLogMessageAsync(_In_z_ const char* msg)
 */
 void dputs(_In_z_ const char* Text)
 {
-    // Only append the newline if the caller didn't
-    const char* TranslatedText = GuiTranslateText(Text);
-    size_t textlen = strlen(TranslatedText);
-    if(TranslatedText[textlen - 1] != '\n')
-    {
-        Memory<char*> buffer(textlen + 2, "dputs");
-        memcpy(buffer(), TranslatedText, textlen);
-        buffer()[textlen] = '\n';
-        buffer()[textlen + 1] = '\0';
-        GuiAddLogMessageAsync(buffer());
-    }
-    else
-        GuiAddLogMessageAsync(TranslatedText);
+    dputs_untranslated(dtranslate(Text));
 }
 
 /**
@@ -66,9 +236,9 @@ void dprintf_untranslated(_In_z_ _Printf_format_string_ const char* Format, ...)
 void dprintf_args(_In_z_ _Printf_format_string_ const char* Format, va_list Args)
 {
     char buffer[16384];
-    vsnprintf_s(buffer, _TRUNCATE, GuiTranslateText(Format), Args);
+    vsnprintf_s(buffer, _TRUNCATE, dtranslate(Format), Args);
 
-    GuiAddLogMessageAsync(buffer);
+    LogEngine().Add(buffer);
 }
 
 /**
@@ -79,16 +249,16 @@ void dputs_untranslated(_In_z_ const char* Text)
 {
     // Only append the newline if the caller didn't
     size_t textlen = strlen(Text);
-    if(Text[textlen - 1] != '\n')
+    if(textlen == 0 || Text[textlen - 1] != '\n')
     {
         Memory<char*> buffer(textlen + 2, "dputs");
         memcpy(buffer(), Text, textlen);
         buffer()[textlen] = '\n';
         buffer()[textlen + 1] = '\0';
-        GuiAddLogMessageAsync(buffer());
+        LogEngine().Add(buffer());
     }
     else
-        GuiAddLogMessageAsync(Text);
+        LogEngine().Add(Text);
 }
 /**
 \brief Print a formatted string to the console.
@@ -100,5 +270,5 @@ void dprintf_args_untranslated(_In_z_ _Printf_format_string_ const char* Format,
     char buffer[16384];
     vsnprintf_s(buffer, _TRUNCATE, Format, Args);
 
-    GuiAddLogMessageAsync(buffer);
+    LogEngine().Add(buffer);
 }
@@ -9,5 +9,17 @@ void dprintf_args(_In_z_ _Printf_format_string_ const char* Format, va_list Args
 void dputs_untranslated(_In_z_ const char* Text);
 void dprintf_untranslated(_In_z_ _Printf_format_string_ const char* Format, ...);
 void dprintf_args_untranslated(_In_z_ _Printf_format_string_ const char* Format, va_list Args);
+// Translate a string through the GUI, caching the result by content so hot
+// paths (logging, per-row annotations) don't cross the bridge on every call
+const char* dtranslate(_In_z_ const char* Source);
+
+// Lossy logging mode: when the log ring is full, drop lines (counting them)
+// instead of blocking the caller. Use for flood scenarios like log-condition
+// breakpoints that hit millions of times; the default exact mode never loses
+// a line.
+void dloglossy(bool Enabled);
+bool dlogislossy();
+// Block until every queued log line has been handed to the GUI
+void dlogflush();
 
 #endif // _CONSOLE_H
\ No newline at end of file
@@ -5,6 +5,7 @@
 */
 
 #include "lz4/lz4file.h"
+#include "lz4/lz4.h"
 #include "console.h"
 #include "breakpoint.h"
 #include "patches.h"
@@ -26,6 +27,14 @@
 #include "filemap.h"
 #include "debugger.h"
 #include "stringformat.h"
+#include "module.h"
+#include "murmurhash.h"
+#include "dbjournal.h"
+#include "incrementalanalysis.h"
+#include "performance.h"
+#include <atomic>
+#include <unordered_map>
+#include <ppl.h>
 
 /**
 \brief Directory where program databases are stored (usually in \db). UTF-8 encoding.
@@ -42,8 +51,382 @@ duint dbhash = 0;
 */
 char dbpath[deflen];
 
+// Binary database container: a section directory followed by independently
+// LZ4-compressed compact JSON payloads per subsystem. Sections can be skipped
+// or decompressed straight from the file mapping without parsing the rest,
+// which is what makes load time proportional to what is actually needed.
+// The JSON format remains fully supported for import/export compatibility.
+#pragma pack(push, 1)
+struct DbBinaryHeader
+{
+    char magic[4]; //"XDB1"
+    unsigned int sectionCount;
+};
+
+struct DbBinarySection
+{
+    char name[16];
+    unsigned int offset; //file offset of the compressed payload
+    unsigned int compressedSize;
+    unsigned int uncompressedSize;
+};
+#pragma pack(pop)
+
+static const char dbBinaryMagic[4] = { 'X', 'D', 'B', '1' };
+
+// Compressed payloads of the last save, keyed by section name. Periodic saves
+// rarely change more than a couple of subsystems, so a section whose
+// serialized JSON hashes to the same value is written from this cache instead
+// of going through LZ4 again. The file is still rewritten as a whole (partial
+// in-place updates would leave a torn database on a crash), but for an
+// autosave the compression cost is reduced to the dirty sections.
+struct DbCachedCompression
+{
+    duint jsonHash = 0;
+    size_t jsonSize = 0;
+    std::vector<char> compressed;
+};
+static std::unordered_map<String, DbCachedCompression> dbCompressionCache;
+
+static void DbCompressionCacheClear()
+{
+    dbCompressionCache.clear();
+}
+
+static bool DbSaveBinary(const char* file, DbLoadSaveType saveType, const String & cmdlinepath, bool makeBackup)
+{
+    struct Section
+    {
+        char name[16];
+        String json;
+    };
+    std::vector<Section> sections;
+    auto addSection = [&sections](const char* name, JSON root)
+    {
+        if(json_object_size(root))
+        {
+            auto dump = json_dumps(root, JSON_COMPACT);
+            if(dump)
+            {
+                Section section;
+                memset(section.name, 0, sizeof(section.name));
+                strncpy_s(section.name, name, _TRUNCATE);
+                section.json = dump;
+                free(dump);
+                sections.push_back(std::move(section));
+            }
+        }
+        json_decref(root);
+    };
+
+    if(saveType == DbLoadSaveType::CommandLine || saveType == DbLoadSaveType::All)
+    {
+        JSON root = json_object();
+        CmdLineCacheSave(root, cmdlinepath);
+        addSection("commandline", root);
+    }
+
+    if(saveType == DbLoadSaveType::DebugData || saveType == DbLoadSaveType::All)
+    {
+        // Meta section goes first so the hash is validated before data sections load
+        {
+            JSON root = json_object();
+            if(dbhash != 0)
+            {
+                json_object_set_new(root, "hashAlgorithm", json_string("murmurhash"));
+                json_object_set_new(root, "hash", json_hex(dbhash));
+            }
+            char* text = nullptr;
+            GuiGetDebuggeeNotes(&text);
+            if(text)
+            {
+                json_object_set_new(root, "notes", json_string(text));
+                BridgeFree(text);
+            }
+            const char* initscript = dbggetdebuggeeinitscript();
+            if(initscript[0] != 0)
+                json_object_set_new(root, "initscript", json_string(initscript));
+            addSection("meta", root);
+        }
+
+        struct NamedSaver
+        {
+            const char* name;
+            void (*save)(JSON);
+        };
+        NamedSaver savers[] =
+        {
+            { "comments", CommentCacheSave },
+            { "labels", LabelCacheSave },
+            { "bookmarks", BookmarkCacheSave },
+            { "functions", FunctionCacheSave },
+            { "arguments", ArgumentCacheSave },
+            { "loops", LoopCacheSave },
+            { "xrefs", XrefCacheSave },
+            { "encodemaps", EncodeMapCacheSave },
+            { "breakpoints", BpCacheSave },
+            { "watches", WatchCacheSave },
+            { "moduleparty", ModPartyCacheSave },
+            { "modulehashes", ModHashCacheSave },
+        };
+        for(auto & saver : savers)
+        {
+            JSON root = json_object();
+            saver.save(root);
+            addSection(saver.name, root);
+        }
+
+        {
+            JSON root = json_object();
+            TraceRecord.saveToDb(root);
+            addSection("tracerecord", root);
+        }
+
+        {
+            PLUG_CB_LOADSAVEDB pluginSaveDb;
+            JSON pluginRoot = json_object();
+            pluginSaveDb.root = pluginRoot;
+            pluginSaveDb.loadSaveType = saveType == DbLoadSaveType::All ? PLUG_DB_LOADSAVE_ALL : PLUG_DB_LOADSAVE_DATA;
+            plugincbcall(CBTYPE::CB_SAVEDB, &pluginSaveDb);
+            addSection("plugins", pluginRoot);
+        }
+    }
+
+    auto wdbpath = StringUtils::Utf8ToUtf16(file);
+    if(makeBackup)
+        CopyFileW(wdbpath.c_str(), (wdbpath + L".bak").c_str(), FALSE); //make a backup
+    if(sections.empty()) //remove database when nothing is in there
+    {
+        DeleteFileW(wdbpath.c_str());
+        DeleteFileW(StringUtils::Utf8ToUtf16(cmdlinepath).c_str());
+        return true;
+    }
+
+    // Every section payload is compressed independently, so unchanged ones
+    // can be served from the cache and the rest are compressed in parallel
+    std::vector<std::vector<char>> compressed(sections.size());
+    std::vector<duint> hashes(sections.size());
+    std::vector<size_t> dirty;
+    for(size_t i = 0; i < sections.size(); i++)
+    {
+        if(sections[i].json.size() <= INT_MAX)
+            hashes[i] = murmurhash(sections[i].json.c_str(), int(sections[i].json.size()));
+        auto found = dbCompressionCache.find(sections[i].name);
+        if(hashes[i] && found != dbCompressionCache.end() && found->second.jsonHash == hashes[i] && found->second.jsonSize == sections[i].json.size())
+            compressed[i] = found->second.compressed;
+        else
+            dirty.push_back(i);
+    }
+
+    std::atomic<bool> compressSuccess(true);
+    concurrency::parallel_for(size_t(0), dirty.size(), [&](size_t d)
+    {
+        auto i = dirty[d];
+        auto inputSize = int(sections[i].json.size());
+        compressed[i].resize(LZ4_compressBound(inputSize));
+        auto compressedSize = LZ4_compress(sections[i].json.c_str(), compressed[i].data(), inputSize);
+        if(compressedSize <= 0)
+            compressSuccess = false;
+        else
+            compressed[i].resize(compressedSize);
+    });
+    if(!compressSuccess)
+        return false;
+
+    auto hFile = CreateFileW(wdbpath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, 0, nullptr);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    BufferedWriter bufWriter(hFile);
+    DbBinaryHeader header;
+    memcpy(header.magic, dbBinaryMagic, sizeof(header.magic));
+    header.sectionCount = (unsigned int)sections.size();
+    auto writeSuccess = bufWriter.Write(&header, sizeof(header));
+
+    auto dataOffset = (unsigned int)(sizeof(DbBinaryHeader) + sections.size() * sizeof(DbBinarySection));
+    for(size_t i = 0; i < sections.size(); i++)
+    {
+        DbBinarySection entry;
+        memcpy(entry.name, sections[i].name, sizeof(entry.name));
+        entry.offset = dataOffset;
+        entry.compressedSize = (unsigned int)compressed[i].size();
+        entry.uncompressedSize = (unsigned int)sections[i].json.size();
+        dataOffset += entry.compressedSize;
+        writeSuccess = writeSuccess && bufWriter.Write(&entry, sizeof(entry));
+    }
+    for(size_t i = 0; i < sections.size(); i++)
+        writeSuccess = writeSuccess && bufWriter.Write(compressed[i].data(), compressed[i].size());
+
+    // Remember the freshly compressed payloads for the next save
+    for(auto i : dirty)
+    {
+        if(!hashes[i])
+            continue;
+        auto & cached = dbCompressionCache[sections[i].name];
+        cached.jsonHash = hashes[i];
+        cached.jsonSize = sections[i].json.size();
+        cached.compressed = std::move(compressed[i]);
+    }
+    return writeSuccess;
+}
+
+static void DbLoadBinarySection(const char* name, JSON root, DbLoadSaveType loadType)
+{
+    if(strcmp(name, "commandline") == 0)
+        CmdLineCacheLoad(root);
+    else if(strcmp(name, "meta") == 0)
+    {
+        auto hashalgo = json_string_value(json_object_get(root, "hashAlgorithm"));
+        if(hashalgo && strcmp(hashalgo, "murmurhash") == 0) //Checking checksum of the debuggee.
+            dbhash = duint(json_hex_value(json_object_get(root, "hash")));
+        else
+            dbhash = 0;
+        GuiSetDebuggeeNotes(json_string_value(json_object_get(root, "notes")));
+        dbgsetdebuggeeinitscript(json_string_value(json_object_get(root, "initscript")));
+    }
+    else if(strcmp(name, "comments") == 0)
+        CommentCacheLoad(root);
+    else if(strcmp(name, "labels") == 0)
+        LabelCacheLoad(root);
+    else if(strcmp(name, "bookmarks") == 0)
+        BookmarkCacheLoad(root);
+    else if(strcmp(name, "functions") == 0)
+        FunctionCacheLoad(root);
+    else if(strcmp(name, "arguments") == 0)
+        ArgumentCacheLoad(root);
+    else if(strcmp(name, "loops") == 0)
+        LoopCacheLoad(root);
+    else if(strcmp(name, "xrefs") == 0)
+        XrefCacheLoad(root);
+    else if(strcmp(name, "encodemaps") == 0)
+        EncodeMapCacheLoad(root);
+    else if(strcmp(name, "tracerecord") == 0)
+        TraceRecord.loadFromDb(root);
+    else if(strcmp(name, "breakpoints") == 0)
+        BpCacheLoad(root);
+    else if(strcmp(name, "watches") == 0)
+        WatchCacheLoad(root);
+    else if(strcmp(name, "moduleparty") == 0)
+        ModPartyCacheLoad(root);
+    else if(strcmp(name, "modulehashes") == 0)
+        ModHashCacheLoad(root);
+    else if(strcmp(name, "plugins") == 0)
+    {
+        PLUG_CB_LOADSAVEDB pluginLoadDb;
+        pluginLoadDb.root = root;
+        pluginLoadDb.loadSaveType = loadType == DbLoadSaveType::All ? PLUG_DB_LOADSAVE_ALL : PLUG_DB_LOADSAVE_DATA;
+        plugincbcall(CB_LOADDB, &pluginLoadDb);
+    }
+    //unknown sections (from a newer version) are skipped without error
+}
+
+static bool DbLoadBinary(FileMap<char> & dbMap, DbLoadSaveType loadType)
+{
+    auto data = (const char*)dbMap.Data();
+    auto fileSize = dbMap.Size();
+    if(fileSize < sizeof(DbBinaryHeader))
+        return false;
+    DbBinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, dbBinaryMagic, sizeof(header.magic)) != 0)
+        return false;
+    auto directorySize = sizeof(DbBinaryHeader) + header.sectionCount * sizeof(DbBinarySection);
+    if(fileSize < directorySize)
+    {
+        dputs(QT_TRANSLATE_NOOP("DBG", "\nInvalid database file!"));
+        return true; //the magic matched, don't fall back to the JSON parser
+    }
+
+    std::vector<DbBinarySection> entries;
+    entries.reserve(header.sectionCount);
+    for(unsigned int i = 0; i < header.sectionCount; i++)
+    {
+        DbBinarySection entry;
+        memcpy(&entry, data + sizeof(DbBinaryHeader) + i * sizeof(DbBinarySection), sizeof(entry));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+
+        // Only touch the sections the requested load type needs
+        auto isCmdLine = strcmp(entry.name, "commandline") == 0;
+        if(loadType == DbLoadSaveType::CommandLine && !isCmdLine)
+            continue;
+        if(loadType == DbLoadSaveType::DebugData && isCmdLine)
+            continue;
+
+        entries.push_back(entry);
+    }
+
+    // The annotation caches touch independent maps behind their own locks, so
+    // those sections can be deserialized on workers, overlapping the LZ4
+    // decompression and JSON parsing of one section with the map fills of the
+    // others. Sections with side effects outside their own subsystem (GUI
+    // notes, plugin callbacks, trace record file handling, breakpoints) keep
+    // their original order on the calling thread; their parsed documents are
+    // still produced on the workers.
+    auto isParallelSafeSection = [](const char* name)
+    {
+        static const char* safeSections[] =
+        {
+            "comments", "labels", "bookmarks", "functions",
+            "arguments", "loops", "xrefs", "encodemaps", "moduleparty"
+        };
+        for(auto section : safeSections)
+            if(strcmp(name, section) == 0)
+                return true;
+        return false;
+    };
+
+    json_object_seed(0); //make sure the hashtable seed exists before the workers race to create objects
+    std::vector<JSON> deferredRoots(entries.size());
+    std::vector<char> invalidData(entries.size()), invalidJson(entries.size()); //not vector<bool>, workers write concurrently
+    concurrency::parallel_for(size_t(0), entries.size(), [&](size_t i)
+    {
+        const auto & entry = entries[i];
+        if(duint(entry.offset) + entry.compressedSize > fileSize)
+        {
+            invalidData[i] = 1;
+            return;
+        }
+
+        Memory<char*> buffer(entry.uncompressedSize + 1, "DbLoadBinary");
+        if(LZ4_decompress_safe(data + entry.offset, buffer(), entry.compressedSize, entry.uncompressedSize) != int(entry.uncompressedSize))
+        {
+            invalidData[i] = 1;
+            return;
+        }
+
+        JSON root = json_loadb(buffer(), entry.uncompressedSize, 0, 0);
+        if(!root)
+        {
+            invalidJson[i] = 1;
+            return;
+        }
+        if(isParallelSafeSection(entries[i].name))
+        {
+            DbLoadBinarySection(entries[i].name, root, loadType);
+            json_decref(root);
+        }
+        else
+            deferredRoots[i] = root;
+    });
+
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        if(invalidData[i])
+            dputs(QT_TRANSLATE_NOOP("DBG", "\nInvalid database file!"));
+        else if(invalidJson[i])
+            dputs(QT_TRANSLATE_NOOP("DBG", "\nInvalid database file (JSON)!"));
+        else if(deferredRoots[i])
+        {
+            DbLoadBinarySection(entries[i].name, deferredRoots[i], loadType);
+            json_decref(deferredRoots[i]);
+        }
+    }
+    return true;
+}
+
 void DbSave(DbLoadSaveType saveType, const char* dbfile, bool disablecompression)
 {
+    PerfScope perf(PerfPhase::DbSave);
     EXCLUSIVE_ACQUIRE(LockDatabase);
 
     auto file = dbfile ? dbfile : dbpath;
@@ -51,6 +434,19 @@ void DbSave(DbLoadSaveType saveType, const char* dbfile, bool disablecompression
     auto cmdlinepath = filename ? StringUtils::sprintf("%s%s.cmdline", dbbasepath, filename) : file + String(".cmdline");
     dprintf(QT_TRANSLATE_NOOP("DBG", "Saving database to %s "), file);
     DWORD ticks = GetTickCount();
+
+    if(settingboolget("Engine", "DatabaseBinaryFormat"))
+    {
+        if(DbSaveBinary(file, saveType, cmdlinepath, !dbfile))
+        {
+            dprintf(QT_TRANSLATE_NOOP("DBG", "%ums\n"), GetTickCount() - ticks);
+            if(!dbfile && saveType != DbLoadSaveType::CommandLine)
+                DbJournalReset(); //everything the journal protected is on disk now
+            return;
+        }
+        // Fall through to the JSON format when the binary save failed
+    }
+
     JSON root = json_object();
 
     // Save only command line
@@ -72,6 +468,8 @@ void DbSave(DbLoadSaveType saveType, const char* dbfile, bool disablecompression
         TraceRecord.saveToDb(root);
         BpCacheSave(root);
         WatchCacheSave(root);
+        ModPartyCacheSave(root);
+        ModHashCacheSave(root);
 
         //save notes
         char* text = nullptr;
@@ -155,6 +553,8 @@ void DbSave(DbLoadSaveType saveType, const char* dbfile, bool disablecompression
 
     dprintf(QT_TRANSLATE_NOOP("DBG", "%ums\n"), GetTickCount() - ticks);
     json_decref(root); //free root
+    if(!dbfile && saveType != DbLoadSaveType::CommandLine)
+        DbJournalReset(); //everything the journal protected is on disk now
 }
 
 void DbLoad(DbLoadSaveType loadType, const char* dbfile)
@@ -206,6 +606,16 @@ void DbLoad(DbLoadSaveType loadType, const char* dbfile)
         return;
     }
 
+    // Binary container? Sections are decompressed straight from the mapping
+    // and only the ones needed for this load type are parsed at all
+    if(DbLoadBinary(dbMap, loadType))
+    {
+        dbMap.Unmap();
+        if(loadType != DbLoadSaveType::CommandLine)
+            dprintf(QT_TRANSLATE_NOOP("DBG", "%ums\n"), GetTickCount() - ticks);
+        return;
+    }
+
     // Deserialize JSON and validate
     JSON root = json_loadb(dbMap.Data(), dbMap.Size(), 0, 0);
 
@@ -248,6 +658,8 @@ void DbLoad(DbLoadSaveType loadType, const char* dbfile)
         TraceRecord.loadFromDb(root);
         BpCacheLoad(root);
         WatchCacheLoad(root);
+        ModPartyCacheLoad(root);
+        ModHashCacheLoad(root);
 
         // Load notes
         const char* text = json_string_value(json_object_get(root, "notes"));
@@ -296,21 +708,27 @@ void DbClear(bool terminating)
 {
     CommentClear();
     LabelClear();
+    StringPoolClear(); //interned comment/label text, only referenced by the two maps above
     BookmarkClear();
     FunctionClear();
     ArgumentClear();
     LoopClear();
     XrefClear();
     EncodeMapClear();
+    AnalysisDirtyClear();
     TraceRecord.clear();
     BpClear();
     WatchClear();
+    ModPartyCacheClear();
+    ModHashCacheClear();
     GuiSetDebuggeeNotes("");
 
     if(terminating)
     {
         PatchClear();
         dbhash = 0;
+        DbCompressionCacheClear();
+        DbJournalClose();
     }
 }
 
@@ -400,6 +818,11 @@ void DbSetPath(const char* Directory, const char* ModulePath)
     }
 }
 
+const char* DbGetPath()
+{
+    return dbpath;
+}
+
 /**
 \brief Warn the user if the hash in the database and the executable mismatch.
 */
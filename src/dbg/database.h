@@ -15,6 +15,7 @@ void DbLoad(DbLoadSaveType loadType, const char* dbfile = nullptr);
 void DbClose();
 void DbClear(bool terminating = false);
 void DbSetPath(const char* Directory, const char* ModulePath);
+const char* DbGetPath();
 bool DbCheckHash(duint currentHash);
 duint DbGetHash();
 
@@ -1,4 +1,5 @@
 #include "datainst_helper.h"
+#include "console.h"
 #include "encodemap.h"
 #include "stringutils.h"
 #include "value.h"
@@ -148,7 +149,7 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
     if(!parsedatainstruction(instruction, di))
     {
         if(di.operand.empty())
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Missing operand")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Missing operand")));
         return false;
     }
 
@@ -166,14 +167,14 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
         unsigned long long result = 0;
         if(!convertLongLongNumber(di.operand.c_str(), result, 16))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Failed to convert operand")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Failed to convert operand")));
             return false;
         }
         auto buf = (char*)&result;
         for(auto i = retsize; i < sizeof(result); i++)
             if(buf[i])
             {
-                strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Operand value too big")));
+                strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Operand value too big")));
                 return false;
             }
         buffer = String(buf, retsize);
@@ -186,15 +187,15 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
         std::vector<unsigned char> data;
         if(!StringUtils::FromHex(StringUtils::PadLeft(di.operand, retsize * 2, '0'), data, true))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid operand (FromHex failed)")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid operand (FromHex failed)")));
             return false;
         }
         if(data.size() != retsize)
         {
 #ifdef _WIN64
-            sprintf_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %llu, got %llu)")), retsize, data.size());
+            sprintf_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %llu, got %llu)")), retsize, data.size());
 #else //x86
-            sprintf_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %u, got %u)")), retsize, data.size());
+            sprintf_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %u, got %u)")), retsize, data.size());
 #endif //_WIN64
             return false;
         }
@@ -209,15 +210,15 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
         std::vector<unsigned char> data;
         if(!StringUtils::FromHex(StringUtils::PadLeft(di.operand, retsize * 2, '0'), data, false))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid operand (FromHex failed)")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid operand (FromHex failed)")));
             return false;
         }
         if(data.size() != retsize)
         {
 #ifdef _WIN64
-            sprintf_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %llu, got %llu)")), retsize, data.size());
+            sprintf_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %llu, got %llu)")), retsize, data.size());
 #else //x86
-            sprintf_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %u, got %u)")), retsize, data.size());
+            sprintf_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid size (expected %u, got %u)")), retsize, data.size());
 #endif //_WIN64
             return false;
         }
@@ -242,7 +243,7 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
     }
 
     case enc_real10:
-        strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "80bit extended float is not supported")));
+        strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "80bit extended float is not supported")));
         return false; //80 bit float is not supported in MSVC, need to add other library
 
     case enc_ascii:
@@ -250,12 +251,12 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
         String unescaped;
         if(!StringUtils::Unescape(di.operand, unescaped))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid string literal")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid string literal")));
             return false;
         }
         if(unescaped.size() > size_t(destsize))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "String too long")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "String too long")));
             if(size)
             {
                 *size = int(unescaped.size());  //return correct size
@@ -273,14 +274,14 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
         String unescaped;
         if(!StringUtils::Unescape(di.operand, unescaped))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid string literal")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid string literal")));
             return false;
         }
         WString unicode = StringUtils::Utf8ToUtf16(unescaped);
 
         if(unicode.size()*sizeof(wchar_t) > size_t(destsize))
         {
-            strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "String too long")));
+            strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "String too long")));
             if(size)
             {
                 retsize = unicode.size() * 2; //return correct size
@@ -300,7 +301,7 @@ bool tryassembledata(duint addr, unsigned char* dest, int destsize, int* size, c
 
     if(retsize > size_t(destsize))
     {
-        strcpy_s(error, MAX_ERROR_SIZE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Dest buffer too small")));
+        strcpy_s(error, MAX_ERROR_SIZE, dtranslate(QT_TRANSLATE_NOOP("DBG", "Dest buffer too small")));
         return false;
     }
 
@@ -1,6 +1,10 @@
 #include "_global.h"
 #include "dbghelp_safe.h"
 
+//dbghelp is not thread safe, so every call is serialized behind one critical
+//section. Symbol loading and address-to-line queries no longer go through
+//dbghelp (see symbolsourcebase.h); the only live caller left is the stack
+//walker, so a slow call here can only stall another stack walk.
 static CRITICAL_SECTION criticalSection;
 
 struct Lock
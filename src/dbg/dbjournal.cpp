@@ -0,0 +1,230 @@
+#include "dbjournal.h"
+#include "database.h"
+#include "console.h"
+#include "comment.h"
+#include "label.h"
+#include "bookmark.h"
+#include "breakpoint.h"
+#include "module.h"
+#include "filehelper.h"
+#include "threading.h"
+
+//One redo line per mutation, in the order they happened:
+//  {"table":"comments","op":"add","entry":{...}} - same shape as a db entry
+//  {"table":"comments","op":"del","module":"...","address":"0x..."}
+//  {"table":"comments","op":"delrange","module":"...","start":"0x...","end":"0x...","manual":true}
+//  {"op":"bpsnapshot","data":{...}} - breakpoints have too many mutable
+//    fields for per-field deltas, so every mutation journals the (small)
+//    table whole and the last snapshot wins on replay.
+//Writes go through the OS file cache without flushing: they survive a
+//debugger crash (the common case), just not a machine power loss.
+
+static HANDLE hJournal = INVALID_HANDLE_VALUE;
+
+struct JournalTable
+{
+    const char* name; //db section key
+    void (*CacheLoad)(JSON Root); //inserts serialized entries
+    bool (*DeleteByKey)(duint Key); //delete by the stable modhash + rva key
+    void (*DelRange)(duint Start, duint End, bool Manual);
+};
+
+static JournalTable journalTables[] =
+{
+    { "comments", CommentCacheLoad, CommentDeleteByKey, CommentDelRange },
+    { "labels", LabelCacheLoad, LabelDeleteByKey, LabelDelRange },
+    { "bookmarks", BookmarkCacheLoad, BookmarkDeleteByKey, BookmarkDelRange },
+};
+
+static String journalPath()
+{
+    return String(DbGetPath()) + ".journal";
+}
+
+bool DbJournalActive()
+{
+    return hJournal != INVALID_HANDLE_VALUE;
+}
+
+static void journalAppend(JSON line)
+{
+    EXCLUSIVE_ACQUIRE(LockDbJournal);
+    if(hJournal == INVALID_HANDLE_VALUE)
+        return;
+    auto dump = json_dumps(line, JSON_COMPACT);
+    if(!dump)
+        return;
+    DWORD written = 0;
+    SetFilePointer(hJournal, 0, nullptr, FILE_END);
+    WriteFile(hJournal, dump, (DWORD)strlen(dump), &written, nullptr);
+    WriteFile(hJournal, "\n", 1, &written, nullptr);
+    free(dump);
+}
+
+void DbJournalAdd(const char* table, JSON entry)
+{
+    if(!DbJournalActive())
+        return;
+    auto line = json_object();
+    json_object_set_new(line, "table", json_string(table));
+    json_object_set_new(line, "op", json_string("add"));
+    json_object_set(line, "entry", entry);
+    journalAppend(line);
+    json_decref(line);
+}
+
+void DbJournalDeleteAt(const char* table, duint va)
+{
+    if(!DbJournalActive())
+        return;
+    //mirror what AddrInfoSerializer stores, so the replayed key matches
+    //entries loaded from the database
+    auto base = ModBaseFromAddr(va);
+    auto line = json_object();
+    json_object_set_new(line, "table", json_string(table));
+    json_object_set_new(line, "op", json_string("del"));
+    json_object_set_new(line, "module", json_string(ModNameFromHash(ModHashFromAddr(base)).c_str()));
+    json_object_set_new(line, "address", json_hex(va - base));
+    journalAppend(line);
+    json_decref(line);
+}
+
+void DbJournalDelRangeAt(const char* table, duint start, duint end, bool manual)
+{
+    if(!DbJournalActive())
+        return;
+    auto base = ModBaseFromAddr(start);
+    auto line = json_object();
+    json_object_set_new(line, "table", json_string(table));
+    json_object_set_new(line, "op", json_string("delrange"));
+    json_object_set_new(line, "module", json_string(ModNameFromHash(ModHashFromAddr(base)).c_str()));
+    json_object_set_new(line, "start", json_hex(start - base));
+    json_object_set_new(line, "end", json_hex(end - base));
+    json_object_set_new(line, "manual", json_boolean(manual));
+    journalAppend(line);
+    json_decref(line);
+}
+
+void DbJournalBpSnapshot(JSON root)
+{
+    if(!DbJournalActive())
+        return;
+    auto line = json_object();
+    json_object_set_new(line, "op", json_string("bpsnapshot"));
+    json_object_set(line, "data", root);
+    journalAppend(line);
+    json_decref(line);
+}
+
+void DbJournalStart()
+{
+    EXCLUSIVE_ACQUIRE(LockDbJournal);
+    if(hJournal != INVALID_HANDLE_VALUE)
+        return;
+    auto path = journalPath();
+
+    //Replay what a crashed session left behind. A clean close truncates the
+    //journal after its final full save, making this a no-op.
+    int replayed = 0;
+    JSON bpSnapshot = nullptr;
+    FileHelper::ReadLinesMapped(path, [&](const char* line, size_t length)
+    {
+        auto json = json_loadb(line, length, 0, nullptr);
+        if(!json) //torn tail line from a crash mid-write
+            return true;
+        auto op = json_string_value(json_object_get(json, "op"));
+        auto table = json_string_value(json_object_get(json, "table"));
+        if(op && strcmp(op, "bpsnapshot") == 0)
+        {
+            auto data = json_object_get(json, "data");
+            if(data)
+            {
+                if(bpSnapshot)
+                    json_decref(bpSnapshot);
+                bpSnapshot = json_incref(data);
+                replayed++;
+            }
+        }
+        else if(op && table)
+        {
+            for(auto & journalTable : journalTables)
+            {
+                if(strcmp(journalTable.name, table) != 0)
+                    continue;
+                if(strcmp(op, "add") == 0)
+                {
+                    auto entry = json_object_get(json, "entry");
+                    if(entry)
+                    {
+                        auto root = json_object();
+                        auto entries = json_array();
+                        json_array_append(entries, entry);
+                        json_object_set(root, journalTable.name, entries);
+                        json_decref(entries);
+                        journalTable.CacheLoad(root);
+                        json_decref(root);
+                        replayed++;
+                    }
+                }
+                else if(strcmp(op, "del") == 0)
+                {
+                    auto module = json_string_value(json_object_get(json, "module"));
+                    auto address = duint(json_hex_value(json_object_get(json, "address")));
+                    journalTable.DeleteByKey(ModHashFromName(module ? module : "") + address);
+                    replayed++;
+                }
+                else if(strcmp(op, "delrange") == 0)
+                {
+                    auto module = json_string_value(json_object_get(json, "module"));
+                    auto start = duint(json_hex_value(json_object_get(json, "start")));
+                    auto end = duint(json_hex_value(json_object_get(json, "end")));
+                    auto manual = json_is_true(json_object_get(json, "manual"));
+                    duint base = 0;
+                    if(module && *module)
+                        base = ModBaseFromName(module);
+                    if(!module || !*module || base) //skip modules that are not loaded
+                    {
+                        journalTable.DelRange(base + start, base + end, manual);
+                        replayed++;
+                    }
+                }
+                break;
+            }
+        }
+        json_decref(json);
+        return true;
+    });
+    if(bpSnapshot)
+    {
+        BpClear();
+        BpCacheLoad(bpSnapshot);
+        json_decref(bpSnapshot);
+    }
+    if(replayed)
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Replayed %d journaled database operations\n"), replayed);
+
+    hJournal = CreateFileW(StringUtils::Utf8ToUtf16(path).c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+}
+
+void DbJournalReset()
+{
+    EXCLUSIVE_ACQUIRE(LockDbJournal);
+    if(hJournal == INVALID_HANDLE_VALUE)
+        return;
+    //the full save that just finished captured everything the journal protected
+    SetFilePointer(hJournal, 0, nullptr, FILE_BEGIN);
+    SetEndOfFile(hJournal);
+}
+
+void DbJournalClose()
+{
+    EXCLUSIVE_ACQUIRE(LockDbJournal);
+    if(hJournal == INVALID_HANDLE_VALUE)
+        return;
+    LARGE_INTEGER size;
+    auto empty = GetFileSizeEx(hJournal, &size) && size.QuadPart == 0;
+    CloseHandle(hJournal);
+    hJournal = INVALID_HANDLE_VALUE;
+    if(empty) //keep a non-empty journal: the final save must have failed
+        DeleteFileW(StringUtils::Utf8ToUtf16(journalPath()).c_str());
+}
@@ -0,0 +1,37 @@
+#ifndef _DBJOURNAL_H
+#define _DBJOURNAL_H
+
+#include "_global.h"
+#include "jansson/jansson_x64dbg.h"
+
+//Write-ahead journal for annotation and breakpoint mutations. Mutations are
+//appended to <database>.journal as they happen, so a crash loses at most the
+//line being written instead of everything since the last full save. The
+//journal is replayed on the next session start and truncated whenever a full
+//DbSave captures its contents.
+bool DbJournalActive();
+void DbJournalStart();
+void DbJournalReset();
+void DbJournalClose();
+void DbJournalAdd(const char* table, JSON entry);
+void DbJournalDeleteAt(const char* table, duint va);
+void DbJournalDelRangeAt(const char* table, duint start, duint end, bool manual);
+void DbJournalBpSnapshot(JSON root);
+
+//Serialize a value the same way the database would and journal it as an add.
+//Auto entries are regenerated by analysis and would flood the journal, so
+//only manual ones are recorded.
+template<class TSerializer, class TValue>
+void DbJournalAddValue(const char* table, const TValue & value)
+{
+    if(!value.manual || !DbJournalActive())
+        return;
+    TSerializer serializer;
+    auto entry = json_object();
+    serializer.SetJson(entry);
+    if(serializer.Save(value))
+        DbJournalAdd(table, entry);
+    json_decref(entry);
+}
+
+#endif // _DBJOURNAL_H
@@ -29,6 +29,7 @@
 #include "simplescript.h"
 #include "zydis_wrapper.h"
 #include "cmd-watch-control.h"
+#include "cmd-misc.h"
 #include "filemap.h"
 #include "jit.h"
 #include "handle.h"
@@ -36,6 +37,12 @@
 #include "exprfunc.h"
 #include "debugger_cookie.h"
 #include "debugger_tracing.h"
+#include "expressionparser.h"
+#include "expressionfunctions.h"
+#include "dbjournal.h"
+#include "performance.h"
+#include "eventstats.h"
+#include <unordered_map>
 
 // Debugging variables
 static PROCESS_INFORMATION g_pi = {0, 0, 0, 0};
@@ -97,10 +104,17 @@ duint mRtrPreviousCSP = 0;
 HANDLE hDebugLoopThread = nullptr;
 DWORD dwDebugFlags = 0;
 
+static duint branchStepBpAddr = 0; //single-shot breakpoint armed by branch step tracing, 0 when none
+
 static duint dbgcleartracestate()
 {
     auto steps = traceState.StepCount();
     traceState.Clear();
+    if(branchStepBpAddr) //remove a leftover branch step breakpoint when the trace ends abnormally
+    {
+        DeleteBPX(branchStepBpAddr);
+        branchStepBpAddr = 0;
+    }
     return steps;
 }
 
@@ -149,6 +163,22 @@ bool dbgsettraceswitchcondition(const String & expression)
     return traceState.InitSwitchCondition(expression);
 }
 
+bool dbgsettracefast(bool enabled)
+{
+    if(dbgtraceactive())
+        return false;
+    traceState.SetFastTrace(enabled);
+    return true;
+}
+
+bool dbgsettracebranchstep(bool enabled)
+{
+    if(dbgtraceactive())
+        return false;
+    traceState.SetBranchStep(enabled);
+    return true;
+}
+
 bool dbgtraceactive()
 {
     return traceState.IsActive();
@@ -180,6 +210,9 @@ static DWORD WINAPI memMapThread(void* ptr)
             break;
         MemUpdateMapAsync();
         ThreadUpdateWaitReasons();
+        // Thread times and cycles keep changing while the target runs
+        if(dbgisrunning())
+            ThreadDetailsInvalidate();
         GuiUpdateThreadView();
         Sleep(2000);
     }
@@ -457,7 +490,7 @@ static void DebugUpdateTitle(duint disasm_addr, bool analyzeThreadSwitch)
     if(!ModNameFromAddr(disasm_addr, modname, true))
         *modname = 0;
     else
-        sprintf_s(modtext, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Module: %s - ")), modname);
+        sprintf_s(modtext, dtranslate(QT_TRANSLATE_NOOP("DBG", "Module: %s - ")), modname);
     char threadswitch[256] = "";
     DWORD currentThreadId = ThreadGetId(hActiveThread);
     if(analyzeThreadSwitch)
@@ -470,7 +503,7 @@ static void DebugUpdateTitle(duint disasm_addr, bool analyzeThreadSwitch)
             char threadName2[MAX_THREAD_NAME_SIZE] = "";
             if(!ThreadGetName(PrevThreadId, threadName2) || threadName2[0] == 0)
                 sprintf_s(threadName2, "%X", PrevThreadId);
-            sprintf_s(threadswitch, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", " (switched from %s)")), threadName2);
+            sprintf_s(threadswitch, dtranslate(QT_TRANSLATE_NOOP("DBG", " (switched from %s)")), threadName2);
             PrevThreadId = currentThreadId;
         }
     }
@@ -489,7 +522,7 @@ static void DebugUpdateTitle(duint disasm_addr, bool analyzeThreadSwitch)
         sprintf_s(PIDnumber, "%u", fdProcessInfo->dwProcessId);
         sprintf_s(TIDnumber, "%u", currentThreadId);
     }
-    sprintf_s(title, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "%s - PID: %s - %sThread: %s%s%s")), szBaseFileName, PIDnumber, modtext, threadName, TIDnumber, threadswitch);
+    sprintf_s(title, dtranslate(QT_TRANSLATE_NOOP("DBG", "%s - PID: %s - %sThread: %s%s%s")), szBaseFileName, PIDnumber, modtext, threadName, TIDnumber, threadswitch);
     GuiUpdateWindowTitle(title);
 }
 
@@ -628,14 +661,14 @@ static void printHwBpInfo(const BREAKPOINT & bp)
     switch(TITANGETTYPE(bp.titantype)) //type
     {
     case UE_HARDWARE_EXECUTE:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "execute")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", "execute")));
         bpsize = "";
         break;
     case UE_HARDWARE_READWRITE:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "read/write")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", "read/write")));
         break;
     case UE_HARDWARE_WRITE:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "write")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", "write")));
         break;
     default:
         bptype = _strdup(" ");
@@ -664,16 +697,16 @@ static void printMemBpInfo(const BREAKPOINT & bp, const void* ExceptionAddress)
     switch(bp.titantype)
     {
     case UE_MEMORY_READ:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", " (read)")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", " (read)")));
         break;
     case UE_MEMORY_WRITE:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", " (write)")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", " (write)")));
         break;
     case UE_MEMORY_EXECUTE:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", " (execute)")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", " (execute)")));
         break;
     case UE_MEMORY:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", " (read/write/execute)")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", " (read/write/execute)")));
         break;
     default:
         bptype = _strdup("");
@@ -702,13 +735,13 @@ static void printDllBpInfo(const BREAKPOINT & bp)
     switch(bp.titantype)
     {
     case UE_ON_LIB_LOAD:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "DLL Load")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", "DLL Load")));
         break;
     case UE_ON_LIB_UNLOAD:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "DLL Unload")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", "DLL Unload")));
         break;
     case UE_ON_LIB_ALL:
-        bptype = _strdup(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "DLL Load and unload")));
+        bptype = _strdup(dtranslate(QT_TRANSLATE_NOOP("DBG", "DLL Load and unload")));
         break;
     default:
         bptype = _strdup("");
@@ -735,8 +768,18 @@ static bool getConditionValue(const char* expression)
         return false;
     if(word == '1') //short circuit for condition "1\0"
         return true;
+    // A condition on a hot breakpoint is evaluated millions of times, so the
+    // tokenized (RPN) form is cached per expression text and only the value
+    // resolution runs on a hit. Editing a condition changes the key, so there
+    // is nothing to invalidate. Only the debug event thread gets here.
+    static std::unordered_map<String, ExpressionParser> compiledConditions;
+    if(compiledConditions.size() > 1000) //sanity check to avoid unbounded growth
+        compiledConditions.clear();
+    auto compiled = compiledConditions.find(expression);
+    if(compiled == compiledConditions.end())
+        compiled = compiledConditions.emplace(expression, ExpressionParser(expression)).first;
     duint value;
-    if(valfromstring(expression, &value))
+    if(compiled->second.Calculate(value, valuesignedcalc(), false))
         return value != 0;
     return true;
 }
@@ -761,6 +804,29 @@ void cbPauseBreakpoint()
     wait(WAITID_RUN);
 }
 
+//Silent single-shot breakpoint used by run-to-address (cbDebugRunInternal).
+//It lives only inside TitanEngine, so arming it and hitting it involve no
+//breakpoint database writes, no breakpoint view updates and no plugin
+//breakpoint callbacks - only the final pause is published.
+void cbRunToAddressBreakpoint()
+{
+    hActiveThread = ThreadGetHandle(((DEBUG_EVENT*)GetDebugData())->dwThreadId);
+    auto CIP = GetContextDataEx(hActiveThread, UE_CIP);
+    DeleteBPX(CIP); //in case TitanEngine did not consume the single-shot breakpoint
+    DebugUpdateGuiSetStateAsync(CIP, true);
+    _dbg_animatestop(); // Stop animating when paused
+    // Trace record
+    _dbg_dbgtraceexecute(CIP);
+    //lock
+    lock(WAITID_RUN);
+    // Plugin callback
+    PLUG_CB_PAUSEDEBUG pauseInfo = { nullptr };
+    plugincbcall(CB_PAUSEDEBUG, &pauseInfo);
+    dbgsetforeground();
+    dbgsetskipexceptions(false);
+    wait(WAITID_RUN);
+}
+
 static void handleBreakCondition(const BREAKPOINT & bp, const void* ExceptionAddress, duint CIP, bool doBreak)
 {
     if(doBreak)
@@ -807,6 +873,17 @@ static void cbGenericBreakpoint(BP_TYPE bptype, void* ExceptionAddress = nullptr
     if(bptype == BPNORMAL && cookie.HandleBreakpoint(CIP))
         return;
 
+    //counting-only breakpoints: tally the hit lock-free and resume without
+    //entering full breakpoint processing (conditions, plugins, GUI updates),
+    //so counting hits on a hot path does not serialize against LockBreakpoints
+    if(bptype == BPNORMAL || bptype == BPHARDWARE)
+    {
+        auto countAddr = bptype == BPNORMAL ? CIP : duint(ExceptionAddress);
+        BREAKPOINT countBp;
+        if(BpGetFast(countAddr, bptype, &countBp) && countBp.enabled && BpIsCountingOnly(countBp) && BpHitCountIncFast(bptype, countAddr))
+            return;
+    }
+
     BREAKPOINT* bpPtr = nullptr;
     //NOTE: this locking is very tricky, make sure you understand it before modifying anything
     EXCLUSIVE_ACQUIRE(LockBreakpoints);
@@ -910,7 +987,16 @@ static void cbGenericBreakpoint(BP_TYPE bptype, void* ExceptionAddress = nullptr
 
     if(*bp.logText && logCondition) //log
     {
-        dprintf_untranslated("%s\n", stringformatinline(bp.logText).c_str());
+        //compiled log formats, only touched on the debug event thread
+        static std::unordered_map<String, FormatStringCompiled> bpLogFormatCache;
+        static String bpLogBuffer;
+        if(bpLogFormatCache.size() > 64)
+            bpLogFormatCache.clear();
+        auto found = bpLogFormatCache.find(bp.logText);
+        if(found == bpLogFormatCache.end())
+            found = bpLogFormatCache.emplace(bp.logText, FormatStringCompiled(bp.logText)).first;
+        found->second.Format(bpLogBuffer);
+        dprintf_untranslated("%s\n", bpLogBuffer.c_str());
     }
     if(*bp.commandText && commandCondition) //command
     {
@@ -954,6 +1040,11 @@ void cbHardwareBreakpoint(void* ExceptionAddress)
 
 void cbMemoryBreakpoint(void* ExceptionAddress)
 {
+    // Fast-reject faults from the protected pages that fall outside the
+    // watched sub-range: re-execute without hit counting, condition
+    // evaluation, plugin callbacks or GUI updates
+    if(BpMemRejectFault(duint(ExceptionAddress)))
+        return;
     cbGenericBreakpoint(BPMEMORY, ExceptionAddress);
 }
 
@@ -1161,9 +1252,11 @@ void cbStep()
     duint CIP = GetContextDataEx(hActiveThread, UE_CIP);
     if(!stepRepeat || !--stepRepeat)
     {
+        StepLatencyMark(StepStage::Event);
         DebugUpdateGuiSetStateAsync(CIP, true);
         // Trace record
         _dbg_dbgtraceexecute(CIP);
+        StepLatencyMark(StepStage::GuiUpdate);
         // Plugin interaction
         PLUG_CB_STEPPED stepInfo;
         stepInfo.reserved = 0;
@@ -1227,7 +1320,7 @@ void cbRtrStep()
 #endif //_WIN64
                )
         {
-            Zydis cp;
+            auto & cp = Zydis::ThreadLocal();
             unsigned char data[MAX_DISASM_BUFFER];
             memset(data, 0, sizeof(data));
             MemRead(cip, data, MAX_DISASM_BUFFER);
@@ -1245,8 +1338,85 @@ void cbRtrStep()
         StepOverWrapper((void*)cbRtrStep);
 }
 
+//Branch step trace: statically decode from cip to the terminating branch of
+//the basic block and run there with a single-shot breakpoint, so the block
+//takes one debug event instead of one per instruction. The skipped
+//instructions are counted and trace recorded from the static decode. Returns
+//false when the block must be stepped instruction by instruction instead:
+//decode failure, a stop condition constant or a breakpoint inside the block,
+//or a block that would exhaust the step budget.
+static bool dbgarmbranchstep(duint cip, void(*callback)())
+{
+    unsigned char data[512];
+    memset(data, 0, sizeof(data));
+    if(!MemRead(cip, data, sizeof(data)))
+        return false;
+    auto & cp = Zydis::ThreadLocal();
+    const auto & condAddrs = traceState.ConditionAddresses();
+    duint addr = cip;
+    std::vector<duint> skipped;
+    while(true)
+    {
+        auto offset = addr - cip;
+        if(offset + MAX_DISASM_BUFFER > sizeof(data)) //block extends past the decode window
+            return false;
+        if(!cp.Disassemble(addr, data + offset, int(sizeof(data) - offset)))
+            return false;
+        if(cp.IsBranchType(Zydis::BTCallSem | Zydis::BTRetSem | Zydis::BTCondJmpSem | Zydis::BTUncondJmpSem))
+            break;
+        addr += cp.Size();
+        for(auto condAddr : condAddrs)
+            if(condAddr == addr)
+                return false; //the stop condition mentions an address inside the block
+        if(BpGetFast(addr, BPNORMAL, nullptr))
+            return false; //do not run over or conflict with a user breakpoint
+        skipped.push_back(addr);
+    }
+    if(skipped.empty()) //already at the branch, a plain step is as good
+        return false;
+    skipped.pop_back(); //the branch itself gets a real debug event
+    if(!traceState.TrySkipSteps(skipped.size()))
+        return false; //stepping will hit the step budget exactly
+    if(bTraceRecordEnabledDuringTrace)
+        for(auto skippedAddr : skipped)
+            _dbg_dbgtraceexecute(skippedAddr);
+    if(!SetBPX(addr, UE_SINGLESHOOT, (void*)callback))
+        return false;
+    branchStepBpAddr = addr;
+    return true;
+}
+
 static void cbTraceUniversalConditionalStep(duint cip, bool bStepInto, void(*callback)(), bool forceBreakTrace)
 {
+    if(branchStepBpAddr) //the armed breakpoint was consumed (hit or superseded by this event)
+    {
+        DeleteBPX(branchStepBpAddr);
+        branchStepBpAddr = 0;
+    }
+    if(traceState.IsFastTrace())
+    {
+        //Fast trace: per step only the compiled stop condition runs. Trace
+        //coverage, plugin notifications, log/command/switch conditions and
+        //per-step GUI/variable updates are skipped and reconciled once below,
+        //so multi-million step traces are not dominated by bookkeeping.
+        if(!(traceState.BreakTrace() || forceBreakTrace || traceState.ForceBreakTrace()))
+        {
+            if(bStepInto && traceState.IsBranchStep() && !traceState.HasSwitchCondition() && dbgarmbranchstep(cip, callback))
+                return; //running to the end of the basic block instead
+            (bStepInto ? StepIntoWow64 : StepOverWrapper)((void*)callback);
+            return;
+        }
+        auto steps = dbgcleartracestate();
+        varset("$tracecounter", steps, true);
+#ifdef _WIN64
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Trace finished after %llu steps!\n"), steps);
+#else //x86
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Trace finished after %u steps!\n"), steps);
+#endif //_WIN64
+        cbRtrFinalStep(); //updates trace record, GUI state and watches for the final position
+        return;
+    }
+
     PLUG_CB_TRACEEXECUTE info;
     info.cip = cip;
     auto breakCondition = (info.stop = traceState.BreakTrace() || forceBreakTrace);
@@ -1259,7 +1429,7 @@ static void cbTraceUniversalConditionalStep(duint cip, bool bStepInto, void(*cal
     auto switchCondition = traceState.EvaluateSwitch(false);
     if(logCondition) //log
     {
-        traceState.LogWrite(stringformatinline(traceState.LogText()));
+        traceState.LogWriteFormatted();
     }
     if(cmdCondition) //command
     {
@@ -1291,6 +1461,10 @@ static void cbTraceUniversalConditionalStep(duint cip, bool bStepInto, void(*cal
             _dbg_dbgtraceexecute(cip);
         if(switchCondition) //switch (invert) the step type once
             bStepInto = !bStepInto;
+        //log/command/switch conditions must be evaluated on every instruction, so
+        //branch stepping only applies to a plain conditional step-into trace
+        if(bStepInto && traceState.IsBranchStep() && !traceState.IsExtended() && !traceState.HasSwitchCondition() && dbgarmbranchstep(cip, callback))
+            return; //running to the end of the basic block instead
         (bStepInto ? StepIntoWow64 : StepOverWrapper)((void*)callback);
     }
 }
@@ -1349,7 +1523,7 @@ static void cbCreateProcess(CREATE_PROCESS_DEBUG_INFO* CreateProcessInfo)
 
     char DebugFileName[deflen] = "";
     if(!GetFileNameFromHandle(CreateProcessInfo->hFile, DebugFileName) && !GetFileNameFromProcessHandle(CreateProcessInfo->hProcess, DebugFileName))
-        strcpy_s(DebugFileName, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "??? (GetFileNameFromHandle failed)")));
+        strcpy_s(DebugFileName, dtranslate(QT_TRANSLATE_NOOP("DBG", "??? (GetFileNameFromHandle failed)")));
     dprintf(QT_TRANSLATE_NOOP("DBG", "Process Started: %p %s\n"), base, DebugFileName);
 
     char* cmdline = nullptr;
@@ -1375,6 +1549,7 @@ static void cbCreateProcess(CREATE_PROCESS_DEBUG_INFO* CreateProcessInfo)
     GuiDumpAt(MemFindBaseAddr(GetContextDataEx(CreateProcessInfo->hThread, UE_CIP), 0) + PAGE_SIZE); //dump somewhere
 
     ModLoad((duint)base, 1, DebugFileName);
+    ModHashValidateAsync((duint)base);
 
     char modname[256] = "";
     if(ModNameFromAddr((duint)base, modname, true))
@@ -1399,7 +1574,7 @@ static void cbCreateProcess(CREATE_PROCESS_DEBUG_INFO* CreateProcessInfo)
                 auto callbackVA = modInfo->tlsCallbacks.at(i);
                 if(MemIsValidReadPtr(callbackVA))
                 {
-                    String breakpointname = StringUtils::sprintf(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "TLS Callback %d")), i + 1);
+                    String breakpointname = StringUtils::sprintf(dtranslate(QT_TRANSLATE_NOOP("DBG", "TLS Callback %d")), i + 1);
                     sprintf_s(command, "bp %p,\"%s\",ss", callbackVA, breakpointname.c_str());
                     cmddirectexec(command);
                 }
@@ -1412,7 +1587,7 @@ static void cbCreateProcess(CREATE_PROCESS_DEBUG_INFO* CreateProcessInfo)
 
         if(settingboolget("Events", "EntryBreakpoint") && !bEntryIsInMzHeader)
         {
-            sprintf_s(command, "bp %p,\"%s\",ss", pDebuggedBase + pDebuggedEntry, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "entry breakpoint")));
+            sprintf_s(command, "bp %p,\"%s\",ss", pDebuggedBase + pDebuggedEntry, dtranslate(QT_TRANSLATE_NOOP("DBG", "entry breakpoint")));
             cmddirectexec(command);
         }
 
@@ -1498,7 +1673,7 @@ static void cbCreateThread(CREATE_THREAD_DEBUG_INFO* CreateThread)
     if(settingboolget("Events", "ThreadEntry"))
     {
         String command;
-        command = StringUtils::sprintf("bp %p,\"%s %X\",ss", entry, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Thread Entry")), dwThreadId);
+        command = StringUtils::sprintf("bp %p,\"%s %X\",ss", entry, dtranslate(QT_TRANSLATE_NOOP("DBG", "Thread Entry")), dwThreadId);
         cmddirectexec(command.c_str());
     }
 
@@ -1527,7 +1702,7 @@ static void cbCreateThread(CREATE_THREAD_DEBUG_INFO* CreateThread)
             MEMPAGE page;
             auto limit = duint(tib.StackLimit);
             auto base = duint(tib.StackBase);
-            sprintf_s(page.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Thread %X Stack")), dwThreadId);
+            sprintf_s(page.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "Thread %X Stack")), dwThreadId);
             page.mbi.BaseAddress = page.mbi.AllocationBase = tib.StackLimit;
             page.mbi.Protect = page.mbi.AllocationProtect = PAGE_READWRITE;
             page.mbi.RegionSize = base - limit;
@@ -1664,11 +1839,13 @@ static void cbLoadDll(LOAD_DLL_DEBUG_INFO* LoadDll)
 
     char DLLDebugFileName[deflen] = "";
     if(!GetFileNameFromHandle(LoadDll->hFile, DLLDebugFileName) && !GetFileNameFromModuleHandle(fdProcessInfo->hProcess, HMODULE(base), DLLDebugFileName))
-        strcpy_s(DLLDebugFileName, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "??? (GetFileNameFromHandle failed)")));
+        strcpy_s(DLLDebugFileName, dtranslate(QT_TRANSLATE_NOOP("DBG", "??? (GetFileNameFromHandle failed)")));
 
     ModLoad((duint)base, 1, DLLDebugFileName);
+    ModHashValidateAsync((duint)base);
 
-    // Update memory map
+    // Update memory map (only the module range has to be requeried)
+    MemUpdateMapDirty(duint(base), ModSizeFromAddr(duint(base)));
     MemUpdateMapAsync();
 
     char modname[MAX_MODULE_SIZE] = "";
@@ -1689,7 +1866,7 @@ static void cbLoadDll(LOAD_DLL_DEBUG_INFO* LoadDll)
         if(settingboolget("Events", "EntryBreakpoint"))
         {
             bAlreadySetEntry = true;
-            sprintf_s(command, "bp %p,\"%s\",ss", pDebuggedBase + pDebuggedEntry, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "entry breakpoint")));
+            sprintf_s(command, "bp %p,\"%s\",ss", pDebuggedBase + pDebuggedEntry, dtranslate(QT_TRANSLATE_NOOP("DBG", "entry breakpoint")));
             cmddirectexec(command);
         }
     }
@@ -1708,9 +1885,9 @@ static void cbLoadDll(LOAD_DLL_DEBUG_INFO* LoadDll)
             if(MemIsValidReadPtr(callbackVA))
             {
                 if(bIsDebuggingThis)
-                    sprintf_s(command, "bp %p,\"%s %u\",ss", callbackVA, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "TLS Callback")), i + 1);
+                    sprintf_s(command, "bp %p,\"%s %u\",ss", callbackVA, dtranslate(QT_TRANSLATE_NOOP("DBG", "TLS Callback")), i + 1);
                 else
-                    sprintf_s(command, "bp %p,\"%s %u (%s)\",ss", callbackVA, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "TLS Callback")), i + 1, modname);
+                    sprintf_s(command, "bp %p,\"%s %u (%s)\",ss", callbackVA, dtranslate(QT_TRANSLATE_NOOP("DBG", "TLS Callback")), i + 1, modname);
                 cmddirectexec(command);
             }
             else
@@ -1835,6 +2012,7 @@ static void cbUnloadDll(UNLOAD_DLL_DEBUG_INFO* UnloadDll)
         BpEnumAll(cbRemoveModuleBreakpoints, modname, duint(base));
     int party = ModGetParty(duint(base));
     DebugUpdateBreakpointsViewAsync();
+    stackclearfunctiontablecache(); //the module base may be reused by a later load
     dprintf(QT_TRANSLATE_NOOP("DBG", "DLL Unloaded: %p %s\n"), base, modname);
 
     if(dbghandledllbreakpoint(modname, false))
@@ -1855,6 +2033,9 @@ static void cbUnloadDll(UNLOAD_DLL_DEBUG_INFO* UnloadDll)
         wait(WAITID_RUN);
     }
 
+    //only the module range has to be requeried, take the size before the module is gone
+    MemUpdateMapDirty(duint(base), ModSizeFromAddr(duint(base)));
+
     ModUnload((duint)base);
 
     //update memory map
@@ -1930,7 +2111,7 @@ static void cbException(EXCEPTION_DEBUG_INFO* ExceptionData)
     duint addr = (duint)ExceptionData->ExceptionRecord.ExceptionAddress;
     {
         BREAKPOINT bp;
-        if(BpGet(ExceptionCode, BPEXCEPTION, nullptr, &bp) && bp.enabled && ((bp.titantype == 1 && ExceptionData->dwFirstChance) || (bp.titantype == 2 && !ExceptionData->dwFirstChance) || bp.titantype == 3))
+        if(BpGetFast(ExceptionCode, BPEXCEPTION, &bp) && bp.enabled && ((bp.titantype == 1 && ExceptionData->dwFirstChance) || (bp.titantype == 2 && !ExceptionData->dwFirstChance) || bp.titantype == 3))
         {
             bPausedOnException = true;
             cbGenericBreakpoint(BPEXCEPTION, ExceptionData);
@@ -2012,7 +2193,14 @@ static void cbException(EXCEPTION_DEBUG_INFO* ExceptionData)
 
 static void cbDebugEvent(DEBUG_EVENT* DebugEvent)
 {
+    PerfScope perf(PerfPhase::DebugEvent);
     InterlockedIncrement((volatile long*)&DbgEvents);
+    EventStatsRecord(*DebugEvent);
+    // Target state may have changed in any way, drop all cached memory reads,
+    // cached expression function results and cached thread details
+    MemCacheFlush();
+    ExpressionFunctions::InvalidateStep();
+    ThreadDetailsInvalidate();
     PLUG_CB_DEBUGEVENT debugEventInfo;
     debugEventInfo.DebugEvent = DebugEvent;
     plugincbcall(CB_DEBUGEVENT, &debugEventInfo);
@@ -2638,6 +2826,7 @@ static void debugLoopFunction(void* lpParameter, bool attach)
     bIsAttached = attach;
     dbgsetskipexceptions(false);
     bFreezeStack = false;
+    EventStatsClear();
 
     //prepare attach/createprocess
     DWORD pid;
@@ -2696,8 +2885,8 @@ static void debugLoopFunction(void* lpParameter, bool attach)
             String error = stringformatinline(StringUtils::sprintf("{winerror@%d}", lastError));
             if(lastError == ERROR_ELEVATION_REQUIRED && !isElevated)
             {
-                auto msg = StringUtils::Utf8ToUtf16(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "The executable you are trying to debug requires elevation. Restart as admin?")));
-                auto title = StringUtils::Utf8ToUtf16(GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Elevation")));
+                auto msg = StringUtils::Utf8ToUtf16(dtranslate(QT_TRANSLATE_NOOP("DBG", "The executable you are trying to debug requires elevation. Restart as admin?")));
+                auto title = StringUtils::Utf8ToUtf16(dtranslate(QT_TRANSLATE_NOOP("DBG", "Elevation")));
                 auto answer = MessageBoxW(GuiGetWindowHandle(), msg.c_str(), title.c_str(), MB_ICONQUESTION | MB_YESNO);
                 wchar_t wszProgramPath[MAX_PATH] = L"";
                 if(answer == IDYES && dbgrestartadmin())
@@ -2790,6 +2979,7 @@ static void debugLoopFunction(void* lpParameter, bool attach)
 
     // Init program database
     DbLoad(DbLoadSaveType::DebugData);
+    DbJournalStart(); //replay mutations a crashed session left behind and start journaling
 
     //run debug loop (returns when process debugging is stopped)
     if(attach)
@@ -2827,6 +3017,8 @@ static void debugLoopFunction(void* lpParameter, bool attach)
     //cleanup
     dbgcleartracestate();
     dbgClearRtuBreakpoints();
+    dbgClearRunToConditionStub();
+    stackclearfunctiontablecache();
     ModClear();
     ThreadClear();
     WatchClear();
@@ -2881,6 +3073,38 @@ void dbgsetforeground()
         SetForegroundWindow(GuiGetWindowHandle());
 }
 
+static bool cbReconcileHwBps(const BREAKPOINT* bp)
+{
+    if(bp->type != BPHARDWARE || !bp->enabled)
+        return true;
+    DWORD drx = 0;
+    if(!GetUnusedHardwareBreakPointRegister(&drx))
+    {
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Did not enable hardware breakpoint %p (all slots full)\n"), bp->addr);
+        return true;
+    }
+    int titantype = bp->titantype;
+    TITANSETDRX(titantype, drx);
+    BpSetTitanType(bp->addr, BPHARDWARE, titantype);
+    if(!SetHardwareBreakPoint(bp->addr, drx, TITANGETTYPE(titantype), TITANGETSIZE(titantype), (void*)cbHardwareBreakpoint))
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Could not set hardware breakpoint %p (SetHardwareBreakPoint)\n"), bp->addr);
+    return true;
+}
+
+void dbgreconcilehwbps()
+{
+    if(!DbgIsDebugging())
+        return;
+    //A breakpoint batch defers the TitanEngine calls its hardware breakpoint
+    //commands would have made, because every one of them walks all threads to
+    //rewrite the debug registers. Clearing the four slots and re-programming
+    //the breakpoints that ended up enabled costs at most eight thread passes
+    //per batch, no matter how many operations the batch contained.
+    for(DWORD drx = UE_DR0; drx <= UE_DR3; drx++)
+        DeleteHardwareBreakPoint(drx);
+    BpEnumAll(cbReconcileHwBps);
+}
+
 DWORD WINAPI threadDebugLoop(void* lpParameter)
 {
     debugLoopFunction(lpParameter, false);
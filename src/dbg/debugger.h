@@ -71,12 +71,15 @@ bool dbgsettracecondition(const String & expression, duint maxCount);
 bool dbgsettracelog(const String & expression, const String & text);
 bool dbgsettracecmd(const String & expression, const String & text);
 bool dbgsettraceswitchcondition(const String & expression);
+bool dbgsettracefast(bool enabled);
+bool dbgsettracebranchstep(bool enabled);
 bool dbgtraceactive();
 void dbgforcebreaktrace();
 bool dbgsettracelogfile(const char* fileName);
 void dbgsetdebuggeeinitscript(const char* fileName);
 const char* dbggetdebuggeeinitscript();
 void dbgsetforeground();
+void dbgreconcilehwbps();
 bool dbggetwintext(std::vector<std::string>* winTextList, const DWORD dwProcessId);
 void dbgtracebrowserneedsupdate();
 bool dbgsetdllbreakpoint(const char* mod, DWORD type, bool singleshoot);
@@ -86,6 +89,7 @@ void dbgsetdebugflags(DWORD flags);
 void cbStep();
 void cbRtrStep();
 void cbPauseBreakpoint();
+void cbRunToAddressBreakpoint();
 void cbSystemBreakpoint(void* ExceptionData);
 void cbMemoryBreakpoint(void* ExceptionAddress);
 void cbHardwareBreakpoint(void* ExceptionAddress);
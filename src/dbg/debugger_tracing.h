@@ -9,8 +9,20 @@ struct TraceCondition
     duint steps;
     duint maxSteps;
 
+    std::vector<duint> constantAddrs; //constant token values, used by branch step trace to find stop addresses inside a block
+
     explicit TraceCondition(const String & expression, duint maxCount)
-        : condition(expression), steps(0), maxSteps(maxCount) {}
+        : condition(expression), steps(0), maxSteps(maxCount)
+    {
+        for(const auto & token : condition.GetTokens())
+        {
+            if(token.type() != ExpressionParser::Token::Type::Data)
+                continue;
+            duint value;
+            if(valtokendep(token.data().c_str()) == dep_constant && valfromstring(token.data().c_str(), &value, true))
+                constantAddrs.push_back(value);
+        }
+    }
 
     bool BreakTrace()
     {
@@ -26,9 +38,10 @@ struct TextCondition
 {
     ExpressionParser condition;
     String text;
+    FormatStringCompiled compiledText; //compiled once, formatted per step
 
     explicit TextCondition(const String & expression, const String & text)
-        : condition(expression), text(text) {}
+        : condition(expression), text(text), compiledText(text) {}
 
     bool Evaluate(bool defaultValue) const
     {
@@ -68,7 +81,7 @@ struct TraceState
         return true;
     }
 
-    void LogWrite(String text)
+    void LogWrite(const String & text)
     {
         if(logWriter)
         {
@@ -128,6 +141,15 @@ struct TraceState
         return logCondition ? logCondition->text : emptyString;
     }
 
+    //Format the compiled log text into a reused buffer and write it
+    void LogWriteFormatted()
+    {
+        if(!logCondition)
+            return;
+        logCondition->compiledText.Format(logBuffer);
+        LogWrite(logBuffer);
+    }
+
     bool InitCmdCondition(const String & expression, const String & text)
     {
         delete cmdCondition;
@@ -168,6 +190,54 @@ struct TraceState
         logFile = StringUtils::Utf8ToUtf16(fileName);
     }
 
+    //Fast trace: the per-step handler only evaluates the compiled stop
+    //condition; trace coverage, plugin notifications, log/command/switch
+    //conditions and GUI state are reconciled once when the trace stops.
+    void SetFastTrace(bool enabled)
+    {
+        fastTrace = enabled;
+    }
+
+    bool IsFastTrace() const
+    {
+        return fastTrace;
+    }
+
+    //Branch step trace: take one debug event per basic block instead of one
+    //per instruction, reconstructing the intra-block instructions by static
+    //decode. Conditions are only evaluated at branches and branch targets,
+    //except that a block containing a constant from the stop condition
+    //(cip == addr style) is stepped instruction by instruction.
+    void SetBranchStep(bool enabled)
+    {
+        branchStep = enabled;
+    }
+
+    bool IsBranchStep() const
+    {
+        return branchStep;
+    }
+
+    bool HasSwitchCondition() const
+    {
+        return switchCondition != nullptr;
+    }
+
+    const std::vector<duint> & ConditionAddresses() const
+    {
+        return traceCondition ? traceCondition->constantAddrs : emptyAddresses;
+    }
+
+    //Account intra-block instructions skipped by branch stepping, false if
+    //the step budget would be exhausted and the block must be stepped instead
+    bool TrySkipSteps(duint count)
+    {
+        if(!traceCondition || traceCondition->steps + count >= traceCondition->maxSteps)
+            return false;
+        traceCondition->steps += count;
+        return true;
+    }
+
     bool ForceBreakTrace()
     {
         return forceBreakTrace;
@@ -189,10 +259,13 @@ struct TraceState
         delete switchCondition;
         switchCondition = nullptr;
         logFile.clear();
+        logBuffer.clear();
         delete logWriter;
         logWriter = nullptr;
         writeUtf16 = false;
         forceBreakTrace = false;
+        fastTrace = false;
+        branchStep = false;
     }
 
 private:
@@ -201,8 +274,12 @@ private:
     TextCondition* cmdCondition = nullptr;
     TextCondition* switchCondition = nullptr;
     String emptyString;
+    std::vector<duint> emptyAddresses;
+    String logBuffer;
     WString logFile;
     BufferedWriter* logWriter = nullptr;
     bool writeUtf16 = false;
     bool forceBreakTrace = false;
+    bool fastTrace = false;
+    bool branchStep = false;
 };
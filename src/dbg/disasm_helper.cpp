@@ -13,6 +13,8 @@
 #include "encodemap.h"
 #include <zydis_wrapper.h>
 #include "datainst_helper.h"
+#include <mutex>
+#include <unordered_map>
 
 duint disasmback(unsigned char* data, duint base, duint size, duint ip, int n)
 {
@@ -22,7 +24,7 @@ duint disasmback(unsigned char* data, duint base, duint size, duint ip, int n)
     unsigned char* pdata;
 
     // Reset Disasm Structure
-    Zydis cp;
+    auto & cp = Zydis::ThreadLocal();
 
     // Check if the pointer is not null
     if(data == NULL)
@@ -82,7 +84,7 @@ duint disasmnext(unsigned char* data, duint base, duint size, duint ip, int n)
     unsigned char* pdata;
 
     // Reset Disasm Structure
-    Zydis cp;
+    auto & cp = Zydis::ThreadLocal();
 
     if(data == NULL)
         return 0;
@@ -261,8 +263,7 @@ void disasmget(Zydis & cp, duint addr, DISASM_INSTR* instr, bool getregs)
 
 void disasmget(unsigned char* buffer, duint addr, DISASM_INSTR* instr, bool getregs)
 {
-    Zydis cp;
-    disasmget(cp, buffer, addr, instr, getregs);
+    disasmget(Zydis::ThreadLocal(), buffer, addr, instr, getregs);
 }
 
 void disasmget(duint addr, DISASM_INSTR* instr, bool getregs)
@@ -460,7 +461,59 @@ bool disasmgetstringat(duint addr, STRING_TYPE* type, char* ascii, char* unicode
     return false;
 }
 
+// Annotation cache for the GUI string column. Every annotated operand costs
+// several remote reads (pointer dereference + string probes) and the GUI asks
+// again on every repaint, so resolved annotations are kept until the memory
+// read cache generation changes (every debug event and every debugger write).
+// Negative results are cached too, they are the common case.
+struct CachedStringAt
+{
+    bool success;
+    String text;
+};
+static std::unordered_map<duint, CachedStringAt> stringAtCache;
+static duint stringAtCacheGeneration = 0;
+static std::mutex stringAtCacheMutex;
+
+static bool disasmgetstringatuncached(duint addr, char* dest, bool cache);
+
 bool disasmgetstringatwrapper(duint addr, char* dest, bool cache)
+{
+    if(cache)
+    {
+        std::lock_guard<std::mutex> lock(stringAtCacheMutex);
+        auto generation = MemCacheGeneration();
+        if(stringAtCacheGeneration != generation)
+        {
+            stringAtCache.clear();
+            stringAtCacheGeneration = generation;
+        }
+        auto found = stringAtCache.find(addr);
+        if(found != stringAtCache.end())
+        {
+            if(found->second.success)
+                strcpy_s(dest, MAX_STRING_SIZE, found->second.text.c_str());
+            else
+                *dest = '\0';
+            return found->second.success;
+        }
+    }
+
+    auto success = disasmgetstringatuncached(addr, dest, cache);
+    if(cache)
+    {
+        std::lock_guard<std::mutex> lock(stringAtCacheMutex);
+        if(stringAtCache.size() >= 65536) //bound the footprint during very long pauses
+            stringAtCache.clear();
+        auto & cached = stringAtCache[addr];
+        cached.success = success;
+        if(success)
+            cached.text = dest;
+    }
+    return success;
+}
+
+static bool disasmgetstringatuncached(duint addr, char* dest, bool cache)
 {
     if(!MemIsValidReadPtrUnsafe(addr, cache))
         return false;
@@ -504,7 +557,7 @@ bool disasmgetstringatwrapper(duint addr, char* dest, bool cache)
 
 int disasmgetsize(duint addr, unsigned char* data)
 {
-    Zydis cp;
+    auto & cp = Zydis::ThreadLocal();
     if(!cp.Disassemble(addr, data, MAX_DISASM_BUFFER))
         return 1;
     return int(EncodeMapGetSize(addr, cp.Size()));
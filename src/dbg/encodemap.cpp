@@ -1,12 +1,21 @@
 #include "encodemap.h"
 #include <unordered_map>
+#include <algorithm>
 #include "addrinfo.h"
 #include <zydis_wrapper.h>
 
+struct ENCODERUN
+{
+    duint offset;
+    duint size;
+    byte type;
+};
+
 struct ENCODEMAP : AddrInfo
 {
     duint size;
-    byte* data;
+    byte* data; //flat buffer, only allocated while the segment is viewed or edited
+    std::vector<ENCODERUN> runs; //run-length encoding when data is null, sorted by offset, enc_unknown omitted
 };
 
 std::unordered_map<duint, duint> referenceCount;
@@ -43,12 +52,47 @@ duint DecreaseReferenceCount(void* buffer, bool lock = true)
     return iter->second;
 }
 
+static void EncodeMapCompressRuns(const byte* data, duint size, std::vector<ENCODERUN> & runs)
+{
+    runs.clear();
+    for(duint i = 0; i < size;)
+    {
+        auto type = data[i];
+        auto start = i;
+        while(i < size && data[i] == type)
+            i++;
+        if(type != (byte)enc_unknown)
+            runs.push_back(ENCODERUN { start, i - start, type });
+    }
+}
+
+static ENCODETYPE EncodeMapRunType(const std::vector<ENCODERUN> & runs, duint offset)
+{
+    auto itr = std::upper_bound(runs.begin(), runs.end(), offset, [](duint offset, const ENCODERUN & run)
+    {
+        return offset < run.offset;
+    });
+    if(itr == runs.begin())
+        return enc_unknown;
+    --itr;
+    return offset < itr->offset + itr->size ? ENCODETYPE(itr->type) : enc_unknown;
+}
+
 struct EncodeMapSerializer : AddrInfoSerializer<ENCODEMAP>
 {
     bool Save(const ENCODEMAP & value) override
     {
         AddrInfoSerializer::Save(value);
-        setString("data", StringUtils::ToCompressedHex(value.data, value.size));
+        if(value.data)
+            setString("data", StringUtils::ToCompressedHex(value.data, value.size));
+        else
+        {
+            //expand the runs so the database format stays the same
+            std::vector<byte> flat(value.size, (byte)enc_unknown);
+            for(const auto & run : value.runs)
+                memset(flat.data() + run.offset, run.type, run.size);
+            setString("data", StringUtils::ToCompressedHex(flat.data(), flat.size()));
+        }
         return true;
     }
 
@@ -63,11 +107,8 @@ struct EncodeMapSerializer : AddrInfoSerializer<ENCODEMAP>
         if(!StringUtils::FromCompressedHex(json_string_value(dataJson), data))
             return false;
         value.size = data.size();
-        value.data = (byte*)VirtualAlloc(NULL, value.size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-        if(!value.data)
-            return false;
-        memcpy(value.data, data.data(), data.size());
-        IncreaseReferenceCount(value.data, false);
+        value.data = nullptr;
+        EncodeMapCompressRuns(data.data(), data.size(), value.runs);
         return true;
     }
 };
@@ -96,9 +137,8 @@ static bool EncodeMapGetorCreate(duint addr, ENCODEMAP & map, bool* created = nu
         if(created)
             *created = true;
         map.size = segsize;
-        map.data = (byte*)VirtualAlloc(NULL, segsize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-        if(map.data == NULL) return false;
-        IncreaseReferenceCount(map.data);
+        map.data = nullptr;
+        map.runs.clear();
         encmaps.PrepareValue(map, base, false);
         encmaps.Add(map);
     }
@@ -110,6 +150,38 @@ static bool EncodeMapGetorCreate(duint addr, ENCODEMAP & map, bool* created = nu
     return true;
 }
 
+static byte* EncodeMapEnsureFlat(ENCODEMAP & map)
+{
+    if(map.data)
+        return map.data;
+    map.data = (byte*)VirtualAlloc(NULL, map.size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if(!map.data)
+        return nullptr;
+    //VirtualAlloc zeroes the buffer and enc_unknown must be 0
+    for(const auto & run : map.runs)
+        memset(map.data + run.offset, run.type, run.size);
+    map.runs.clear();
+    IncreaseReferenceCount(map.data); //the map itself keeps the buffer alive
+    encmaps.Add(map);
+    return map.data;
+}
+
+static void EncodeMapCompressSegment(void* buffer)
+{
+    //the caller holds LockEncodeMaps exclusively
+    for(auto & itr : encmaps.GetDataUnsafe())
+    {
+        auto & map = itr.second;
+        if(map.data != buffer)
+            continue;
+        EncodeMapCompressRuns(map.data, map.size, map.runs);
+        DecreaseReferenceCount(map.data, false); //drop the map's own reference
+        VirtualFree(map.data, 0, MEM_RELEASE);
+        map.data = nullptr;
+        break;
+    }
+}
+
 void* EncodeMapGetBuffer(duint addr, duint* size, bool create)
 {
     auto base = MemFindBaseAddr(addr);
@@ -118,7 +190,7 @@ void* EncodeMapGetBuffer(duint addr, duint* size, bool create)
     if(create ? EncodeMapGetorCreate(addr, map) : encmaps.Get(EncodeMap::VaKey(base), map))
     {
         auto offset = addr - base;
-        if(offset < map.size)
+        if(offset < map.size && EncodeMapEnsureFlat(map))
         {
             IncreaseReferenceCount(map.data);
             if(size)
@@ -133,8 +205,18 @@ void* EncodeMapGetBuffer(duint addr, duint* size, bool create)
 
 void EncodeMapReleaseBuffer(void* buffer, bool lock)
 {
-    if(DecreaseReferenceCount(buffer, lock) == 0)
+    if(!lock)
+    {
+        if(DecreaseReferenceCount(buffer, false) == 0)
+            VirtualFree(buffer, 0, MEM_RELEASE);
+        return;
+    }
+    EXCLUSIVE_ACQUIRE(LockEncodeMaps);
+    auto remaining = DecreaseReferenceCount(buffer, false);
+    if(remaining == 0)
         VirtualFree(buffer, 0, MEM_RELEASE);
+    else if(remaining == 1) //only the map's own reference is left, go back to runs
+        EncodeMapCompressSegment(buffer);
 }
 
 void EncodeMapReleaseBuffer(void* buffer)
@@ -190,17 +272,20 @@ ENCODETYPE EncodeMapGetType(duint addr, duint codesize)
 {
     duint size;
     auto base = MemFindBaseAddr(addr, &size);
-
-    ENCODEMAP map;
-    if(base && encmaps.Get(EncodeMap::VaKey(base), map))
-    {
-        auto offset = addr - base;
-        if(offset >= map.size)
-            return enc_unknown;
-        return ENCODETYPE(map.data[offset]);
-    }
-
-    return enc_unknown;
+    if(!base)
+        return enc_unknown;
+
+    SHARED_ACQUIRE(LockEncodeMaps);
+    const EncodeMap & constmaps = encmaps;
+    auto & mapData = constmaps.GetDataUnsafe();
+    auto found = mapData.find(EncodeMap::VaKey(base));
+    if(found == mapData.end())
+        return enc_unknown;
+    const auto & map = found->second;
+    auto offset = addr - base;
+    if(offset >= map.size)
+        return enc_unknown;
+    return map.data ? ENCODETYPE(map.data[offset]) : EncodeMapRunType(map.runs, offset);
 }
 
 duint EncodeMapGetSize(duint addr, duint codesize)
@@ -209,13 +294,17 @@ duint EncodeMapGetSize(duint addr, duint codesize)
     if(!base)
         return codesize;
 
-    ENCODEMAP map;
-    if(encmaps.Get(EncodeMap::VaKey(base), map))
+    SHARED_ACQUIRE(LockEncodeMaps);
+    const EncodeMap & constmaps = encmaps;
+    auto & mapData = constmaps.GetDataUnsafe();
+    auto found = mapData.find(EncodeMap::VaKey(base));
+    if(found != mapData.end())
     {
+        const auto & map = found->second;
         auto offset = addr - base;
         if(offset >= map.size)
             return 1;
-        auto type = ENCODETYPE(map.data[offset]);
+        auto type = map.data ? ENCODETYPE(map.data[offset]) : EncodeMapRunType(map.runs, offset);
 
         auto datasize = GetEncodeTypeSize(type);
         if(!IsCodeType(type))
@@ -236,6 +325,9 @@ bool EncodeMapSetType(duint addr, duint size, ENCODETYPE type, bool* created)
         *created = false;
     if(!EncodeMapGetorCreate(base, map, created))
         return false;
+    //the segment is under active editing, so expand it to a flat buffer
+    if(!EncodeMapEnsureFlat(map))
+        return false;
     auto offset = addr - base;
     size = min(map.size - offset, size);
     auto datasize = GetEncodeTypeSize(type);
@@ -248,7 +340,7 @@ bool EncodeMapSetType(duint addr, duint size, ENCODETYPE type, bool* created)
         memset(map.data + offset, (byte)enc_middle, size);
         if(IsCodeType(type) && size > 1)
         {
-            Zydis cp;
+            auto & cp = Zydis::ThreadLocal();
             Memory<unsigned char*> buffer(size);
             if(!MemRead(addr, buffer(), size))
                 return false;
@@ -289,12 +381,11 @@ void EncodeMapDelSegment(duint Start)
         return;
     duint key = EncodeMap::VaKey(base);
     ENCODEMAP map;
-    if(encmaps.Contains(key))
-    {
-        encmaps.Get(key, map);
-        EncodeMapReleaseBuffer(map.data);
-    }
+    bool hadBuffer = encmaps.Contains(key) && encmaps.Get(key, map) && map.data;
+    //delete the entry first so releasing the map's reference cannot recompress into it
     encmaps.Delete(key);
+    if(hadBuffer)
+        EncodeMapReleaseBuffer(map.data);
 }
 
 void EncodeMapDelRange(duint Start, duint End)
@@ -316,7 +407,8 @@ void EncodeMapClear()
 {
     EXCLUSIVE_ACQUIRE(LockEncodeMaps);
     for(auto & encmap : encmaps.GetDataUnsafe())
-        EncodeMapReleaseBuffer(encmap.second.data, false);
+        if(encmap.second.data)
+            EncodeMapReleaseBuffer(encmap.second.data, false);
     EXCLUSIVE_RELEASE();
     encmaps.Clear();
 }
@@ -0,0 +1,140 @@
+/**
+ @file eventstats.cpp
+
+ @brief Implements aggregated debug-event statistics.
+*/
+
+#include "eventstats.h"
+#include <algorithm>
+#include <atomic>
+
+static std::atomic<unsigned long long> eventCounts[RIP_EVENT + 1];
+static std::atomic<unsigned long long> firstChanceCount;
+static std::atomic<unsigned long long> lastChanceCount;
+
+//Space-saving style sketch: a known address bumps its slot, an unknown one
+//takes a free slot or evicts the current minimum. Approximate by design;
+//races with the reader only ever misattribute single counts.
+struct TopSlot
+{
+    std::atomic<duint> address;
+    std::atomic<unsigned long long> count;
+};
+static TopSlot topExceptions[EVENTSTATS_TOPK];
+
+//Per-second ring for the events/sec estimate.
+struct SecondBucket
+{
+    std::atomic<unsigned long long> second;
+    std::atomic<unsigned long long> count;
+};
+#define EVENTSTATS_SECONDS 16
+static SecondBucket secondBuckets[EVENTSTATS_SECONDS];
+
+static void recordException(duint address)
+{
+    int freeSlot = -1;
+    int minSlot = 0;
+    unsigned long long minCount = ~0ull;
+    for(int i = 0; i < EVENTSTATS_TOPK; i++)
+    {
+        auto slotAddress = topExceptions[i].address.load(std::memory_order_relaxed);
+        if(slotAddress == address)
+        {
+            topExceptions[i].count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if(!slotAddress && freeSlot == -1)
+            freeSlot = i;
+        auto slotCount = topExceptions[i].count.load(std::memory_order_relaxed);
+        if(slotCount < minCount)
+        {
+            minCount = slotCount;
+            minSlot = i;
+        }
+    }
+    if(freeSlot != -1)
+    {
+        topExceptions[freeSlot].address.store(address, std::memory_order_relaxed);
+        topExceptions[freeSlot].count.store(1, std::memory_order_relaxed);
+    }
+    else //evict the minimum, inheriting its count as the space-saving scheme does
+    {
+        topExceptions[minSlot].address.store(address, std::memory_order_relaxed);
+        topExceptions[minSlot].count.store(minCount + 1, std::memory_order_relaxed);
+    }
+}
+
+void EventStatsRecord(const DEBUG_EVENT & DebugEvent)
+{
+    auto code = DebugEvent.dwDebugEventCode;
+    if(code <= RIP_EVENT)
+        eventCounts[code].fetch_add(1, std::memory_order_relaxed);
+    if(code == EXCEPTION_DEBUG_EVENT)
+    {
+        if(DebugEvent.u.Exception.dwFirstChance)
+            firstChanceCount.fetch_add(1, std::memory_order_relaxed);
+        else
+            lastChanceCount.fetch_add(1, std::memory_order_relaxed);
+        recordException(duint(DebugEvent.u.Exception.ExceptionRecord.ExceptionAddress));
+    }
+
+    auto second = GetTickCount64() / 1000;
+    auto & bucket = secondBuckets[second % EVENTSTATS_SECONDS];
+    if(bucket.second.load(std::memory_order_relaxed) != second)
+    {
+        bucket.second.store(second, std::memory_order_relaxed);
+        bucket.count.store(0, std::memory_order_relaxed);
+    }
+    bucket.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventStatsClear()
+{
+    for(auto & count : eventCounts)
+        count.store(0, std::memory_order_relaxed);
+    firstChanceCount.store(0, std::memory_order_relaxed);
+    lastChanceCount.store(0, std::memory_order_relaxed);
+    for(auto & slot : topExceptions)
+    {
+        slot.address.store(0, std::memory_order_relaxed);
+        slot.count.store(0, std::memory_order_relaxed);
+    }
+    for(auto & bucket : secondBuckets)
+    {
+        bucket.second.store(0, std::memory_order_relaxed);
+        bucket.count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void EventStatsSnapshotGet(EventStatsSnapshot & Snapshot)
+{
+    memset(&Snapshot, 0, sizeof(Snapshot));
+    for(int i = 0; i <= RIP_EVENT; i++)
+        Snapshot.eventCounts[i] = eventCounts[i].load(std::memory_order_relaxed);
+    Snapshot.firstChanceExceptions = firstChanceCount.load(std::memory_order_relaxed);
+    Snapshot.lastChanceExceptions = lastChanceCount.load(std::memory_order_relaxed);
+
+    for(int i = 0; i < EVENTSTATS_TOPK; i++)
+    {
+        Snapshot.topExceptions[i].address = topExceptions[i].address.load(std::memory_order_relaxed);
+        Snapshot.topExceptions[i].count = topExceptions[i].count.load(std::memory_order_relaxed);
+    }
+    std::sort(std::begin(Snapshot.topExceptions), std::end(Snapshot.topExceptions), [](const EventStatsTopEntry & a, const EventStatsTopEntry & b)
+    {
+        return a.count > b.count;
+    });
+
+    //average over the buckets that saw events, excluding the (partial) current second
+    auto currentSecond = GetTickCount64() / 1000;
+    unsigned long long total = 0, seconds = 0;
+    for(const auto & bucket : secondBuckets)
+    {
+        auto second = bucket.second.load(std::memory_order_relaxed);
+        if(!second || second == currentSecond)
+            continue;
+        total += bucket.count.load(std::memory_order_relaxed);
+        seconds++;
+    }
+    Snapshot.eventsPerSecond = seconds ? double(total) / double(seconds) : 0.0;
+}
@@ -0,0 +1,33 @@
+#ifndef _EVENTSTATS_H
+#define _EVENTSTATS_H
+
+#include "_global.h"
+
+//Aggregated debug-event statistics. Every event is counted by type and
+//exceptions additionally feed a small top-K sketch keyed by exception
+//address, so exception storms (fuzz replays, guard-page loops) can be
+//located without logging each event. Recording is a handful of relaxed
+//atomic operations on the debug-event thread; readers only take snapshots.
+
+#define EVENTSTATS_TOPK 16
+
+struct EventStatsTopEntry
+{
+    duint address;
+    unsigned long long count;
+};
+
+struct EventStatsSnapshot
+{
+    unsigned long long eventCounts[RIP_EVENT + 1]; //indexed by dwDebugEventCode, [0] unused
+    unsigned long long firstChanceExceptions;
+    unsigned long long lastChanceExceptions;
+    EventStatsTopEntry topExceptions[EVENTSTATS_TOPK]; //sorted by count, unused entries have address 0
+    double eventsPerSecond; //average over the most recent seconds with activity
+};
+
+void EventStatsRecord(const DEBUG_EVENT & DebugEvent);
+void EventStatsClear();
+void EventStatsSnapshotGet(EventStatsSnapshot & Snapshot);
+
+#endif // _EVENTSTATS_H
@@ -14,6 +14,57 @@ static std::unordered_map<unsigned int, String> ErrorNames;
 static std::unordered_map<String, unsigned int> Constants;
 static std::unordered_map<unsigned int, String> SyscallIndices;
 
+// The code databases are parsed once at startup from user-editable text files
+// (exceptiondb.txt, ntstatusdb.txt, errordb.txt) and never change afterwards.
+// Each (re)parse freezes the entries into flat tables sorted by code or name,
+// so the cbException hot path resolves a code with one binary search over
+// contiguous memory and no locks, hashing or heap allocations; the maps above
+// stay around as the extensible backing store the tables point into.
+typedef std::vector<std::pair<unsigned int, const String*>> CodeNameTable;
+static CodeNameTable ExceptionCodeTable; //exception + NTSTATUS merged, sorted by code
+static CodeNameTable ErrorCodeTable; //sorted by code
+static std::vector<std::pair<const String*, unsigned int>> ExceptionNameTable; //sorted by name
+
+static void FreezeCodeTable(CodeNameTable & table, const std::unordered_map<unsigned int, String> & names)
+{
+    table.clear();
+    table.reserve(names.size());
+    for(const auto & it : names)
+        table.push_back({ it.first, &it.second });
+    std::sort(table.begin(), table.end(), [](const std::pair<unsigned int, const String*> & a, const std::pair<unsigned int, const String*> & b)
+    {
+        return a.first < b.first;
+    });
+}
+
+static void FreezeExceptionTables()
+{
+    ExceptionCodeTable.clear();
+    ExceptionNameTable.clear();
+    ExceptionCodeTable.reserve(ExceptionNames.size() + NtStatusNames.size());
+    ExceptionNameTable.reserve(ExceptionNames.size() + NtStatusNames.size());
+    for(const auto & it : ExceptionNames)
+    {
+        ExceptionCodeTable.push_back({ it.first, &it.second });
+        ExceptionNameTable.push_back({ &it.second, it.first });
+    }
+    for(const auto & it : NtStatusNames)
+    {
+        ExceptionCodeTable.push_back({ it.first, &it.second });
+        ExceptionNameTable.push_back({ &it.second, it.first });
+    }
+    // A stable sort keeps the exception database entries ahead of the NTSTATUS
+    // ones on duplicate codes or names, matching the old two-map probe order
+    std::stable_sort(ExceptionCodeTable.begin(), ExceptionCodeTable.end(), [](const std::pair<unsigned int, const String*> & a, const std::pair<unsigned int, const String*> & b)
+    {
+        return a.first < b.first;
+    });
+    std::stable_sort(ExceptionNameTable.begin(), ExceptionNameTable.end(), [](const std::pair<const String*, unsigned int> & a, const std::pair<const String*, unsigned int> & b)
+    {
+        return *a.first < *b.first;
+    });
+}
+
 static bool UniversalCodeInit(const String & file, std::unordered_map<unsigned int, String> & names, unsigned char radix)
 {
     names.clear();
@@ -44,12 +95,16 @@ static bool UniversalCodeInit(const String & file, std::unordered_map<unsigned i
 
 bool ErrorCodeInit(const String & errorFile)
 {
-    return UniversalCodeInit(errorFile, ErrorNames, 10);
+    auto result = UniversalCodeInit(errorFile, ErrorNames, 10);
+    FreezeCodeTable(ErrorCodeTable, ErrorNames);
+    return result;
 }
 
 bool ExceptionCodeInit(const String & exceptionFile)
 {
-    return UniversalCodeInit(exceptionFile, ExceptionNames, 16);
+    auto result = UniversalCodeInit(exceptionFile, ExceptionNames, 16);
+    FreezeExceptionTables();
+    return result;
 }
 
 bool ConstantCodeInit(const String & constantFile)
@@ -88,53 +143,41 @@ std::vector<CONSTANTINFO> ConstantList()
     return result;
 }
 
-static bool ExceptionDatabaseNameToCode(const std::unordered_map<unsigned int, String>* db, const char* Name, unsigned int* ErrorCode)
-{
-    for(const auto & i : *db)
-    {
-        if(i.second.compare(Name) == 0)
-        {
-            *ErrorCode = i.first;
-            return true;
-        }
-    }
-    return false;
-}
-
 bool ExceptionNameToCode(const char* Name, unsigned int* ErrorCode)
 {
-    if(!ExceptionDatabaseNameToCode(&ExceptionNames, Name, ErrorCode))
-        return ExceptionDatabaseNameToCode(&NtStatusNames, Name, ErrorCode);
+    auto it = std::lower_bound(ExceptionNameTable.begin(), ExceptionNameTable.end(), Name, [](const std::pair<const String*, unsigned int> & entry, const char* name)
+    {
+        return entry.first->compare(name) < 0;
+    });
+    if(it == ExceptionNameTable.end() || it->first->compare(Name) != 0)
+        return false;
+    *ErrorCode = it->second;
     return true;
 }
 
 bool NtStatusCodeInit(const String & ntStatusFile)
 {
-    return UniversalCodeInit(ntStatusFile, NtStatusNames, 16);
+    auto result = UniversalCodeInit(ntStatusFile, NtStatusNames, 16);
+    FreezeExceptionTables();
+    return result;
 }
 
 static const String emptyString("");
 
-static const String & ExceptionDatabaseCodeToName(std::unordered_map<unsigned int, String>* db, unsigned int ErrorCode, bool* success)
+static const String & CodeTableLookup(const CodeNameTable & table, unsigned int code)
 {
-    auto i = db->find(ErrorCode);
-    if(i == db->end())
+    auto it = std::lower_bound(table.begin(), table.end(), code, [](const std::pair<unsigned int, const String*> & entry, unsigned int code)
     {
-        *success = false;
+        return entry.first < code;
+    });
+    if(it == table.end() || it->first != code)
         return emptyString;
-    }
-    *success = true;
-    return i->second;
+    return *it->second;
 }
 
 const String & ExceptionCodeToName(unsigned int ExceptionCode)
 {
-    bool success;
-    const String & name = ExceptionDatabaseCodeToName(&ExceptionNames, ExceptionCode, &success);
-    if(!success)
-        return ExceptionDatabaseCodeToName(&NtStatusNames, ExceptionCode, &success);
-    else
-        return name;
+    return CodeTableLookup(ExceptionCodeTable, ExceptionCode);
 }
 
 std::vector<CONSTANTINFO> ExceptionList()
@@ -159,14 +202,13 @@ std::vector<CONSTANTINFO> ExceptionList()
 
 const String & NtStatusCodeToName(unsigned int NtStatusCode)
 {
-    bool success;
-    return ExceptionDatabaseCodeToName(&NtStatusNames, NtStatusCode, &success);
+    auto found = NtStatusNames.find(NtStatusCode);
+    return found != NtStatusNames.end() ? found->second : emptyString;
 }
 
 const String & ErrorCodeToName(unsigned int ErrorCode)
 {
-    bool success;
-    return ExceptionDatabaseCodeToName(&ErrorNames, ErrorCode, &success);
+    return CodeTableLookup(ErrorCodeTable, ErrorCode);
 }
 
 std::vector<CONSTANTINFO> ErrorCodeList()
@@ -9,6 +9,21 @@
 #include "thread.h"
 #include "value.h"
 #include "debugger.h"
+#include <mutex>
+
+// Walked chains are cached until the memory read cache is invalidated (every
+// debug event and every debugger write), so refreshing SEHChainView while the
+// target is paused does not re-walk the TEB chain or the ntdll handler lists
+// with remote reads. The SEH chain additionally depends on the active thread.
+struct CachedChain
+{
+    duint generation = 0;
+    DWORD threadId = 0;
+    bool success = false;
+    std::vector<duint> entries;
+};
+static CachedChain cachedChains[EX_HANDLER_UNHANDLED + 1];
+static std::mutex cachedChainMutex;
 
 bool IsVistaOrLater()
 {
@@ -24,21 +39,49 @@ bool IsVistaOrLater()
 bool ExHandlerGetInfo(EX_HANDLER_TYPE Type, std::vector<duint> & Entries)
 {
     Entries.clear();
+    if(Type < EX_HANDLER_SEH || Type > EX_HANDLER_UNHANDLED)
+        return false;
+
+    auto generation = MemCacheGeneration();
+    auto threadId = Type == EX_HANDLER_SEH ? ThreadGetId(hActiveThread) : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(cachedChainMutex);
+        auto & cached = cachedChains[Type];
+        if(cached.generation == generation && cached.threadId == threadId && generation)
+        {
+            Entries = cached.entries;
+            return cached.success;
+        }
+    }
+
+    bool success = false;
     switch(Type)
     {
     case EX_HANDLER_SEH:
-        return ExHandlerGetSEH(Entries);
+        success = ExHandlerGetSEH(Entries);
+        break;
 
     case EX_HANDLER_VEH:
-        return ExHandlerGetVEH(Entries);
+        success = ExHandlerGetVEH(Entries);
+        break;
 
     case EX_HANDLER_VCH:
-        return ExHandlerGetVCH(Entries, false);
+        success = ExHandlerGetVCH(Entries, false);
+        break;
 
     case EX_HANDLER_UNHANDLED:
-        return ExHandlerGetUnhandled(Entries);
+        success = ExHandlerGetUnhandled(Entries);
+        break;
     }
-    return false;
+
+    std::lock_guard<std::mutex> lock(cachedChainMutex);
+    auto & cached = cachedChains[Type];
+    cached.generation = generation;
+    cached.threadId = threadId;
+    cached.success = success;
+    cached.entries = Entries;
+    return success;
 }
 
 bool ExHandlerGetInfo(EX_HANDLER_TYPE Type, EX_HANDLER_INFO* Info)
@@ -6,6 +6,9 @@
 #include "value.h"
 
 std::unordered_map<String, ExpressionFunctions::Function> ExpressionFunctions::mFunctions;
+std::unordered_map<String, ExpressionFunctions::CachedResult> ExpressionFunctions::mCache;
+std::atomic<duint> ExpressionFunctions::mStepEpoch;
+std::atomic<duint> ExpressionFunctions::mModuleEpoch;
 
 //Copied from https://stackoverflow.com/a/7858971/1806760
 template<int...>
@@ -27,14 +30,14 @@ static T callFunc(const T* argv, T(*cbFunction)(Ts...), seq<S...>)
 }
 
 template<typename... Ts>
-static bool RegisterEasy(const String & name, duint(*cbFunction)(Ts...))
+static bool RegisterEasy(const String & name, duint(*cbFunction)(Ts...), ExpressionFunctions::Validity validity = ExpressionFunctions::Validity::Volatile)
 {
     auto aliases = StringUtils::Split(name, ',');
     auto tempFunc = [cbFunction](int argc, duint * argv, void* userdata)
     {
         return callFunc(argv, cbFunction, typename gens<sizeof...(Ts)>::type());
     };
-    if(!ExpressionFunctions::Register(aliases[0], sizeof...(Ts), tempFunc))
+    if(!ExpressionFunctions::Register(aliases[0], sizeof...(Ts), tempFunc, nullptr, validity))
         return false;
     for(size_t i = 1; i < aliases.size(); i++)
         ExpressionFunctions::RegisterAlias(aliases[0], aliases[i]);
@@ -56,18 +59,19 @@ void ExpressionFunctions::Init()
     RegisterEasy("src.disp", srcdisp);
 
     //Modules
-    RegisterEasy("mod.party", modparty);
-    RegisterEasy("mod.base", ModBaseFromAddr);
-    RegisterEasy("mod.size", ModSizeFromAddr);
-    RegisterEasy("mod.hash", ModHashFromAddr);
-    RegisterEasy("mod.entry", ModEntryFromAddr);
-    RegisterEasy("mod.system,mod.issystem", modsystem);
-    RegisterEasy("mod.user,mod.isuser", moduser);
-    RegisterEasy("mod.main,mod.mainbase", dbgdebuggedbase);
-    RegisterEasy("mod.rva", modrva);
-    RegisterEasy("mod.offset,mod.fileoffset", valvatofileoffset);
-    RegisterEasy("mod.headerva", modheaderva);
-    RegisterEasy("mod.isexport", modisexport);
+    //ModSetParty bumps the module epoch, so party-based results can be cached
+    RegisterEasy("mod.party", modparty, Validity::UntilModuleChange);
+    RegisterEasy("mod.base", ModBaseFromAddr, Validity::UntilModuleChange);
+    RegisterEasy("mod.size", ModSizeFromAddr, Validity::UntilModuleChange);
+    RegisterEasy("mod.hash", ModHashFromAddr, Validity::UntilModuleChange);
+    RegisterEasy("mod.entry", ModEntryFromAddr, Validity::UntilModuleChange);
+    RegisterEasy("mod.system,mod.issystem", modsystem, Validity::UntilModuleChange);
+    RegisterEasy("mod.user,mod.isuser", moduser, Validity::UntilModuleChange);
+    RegisterEasy("mod.main,mod.mainbase", dbgdebuggedbase, Validity::UntilModuleChange);
+    RegisterEasy("mod.rva", modrva, Validity::UntilModuleChange);
+    RegisterEasy("mod.offset,mod.fileoffset", valvatofileoffset, Validity::UntilModuleChange);
+    RegisterEasy("mod.headerva", modheaderva, Validity::UntilModuleChange);
+    RegisterEasy("mod.isexport", modisexport, Validity::UntilModuleChange);
 
     //Process information
     RegisterEasy("peb,PEB", peb);
@@ -80,30 +84,30 @@ void ExpressionFunctions::Init()
     RegisterEasy("GetTickCount,gettickcount", gettickcount);
 
     //Memory
-    RegisterEasy("mem.valid,mem.isvalid", memvalid);
-    RegisterEasy("mem.base", membase);
-    RegisterEasy("mem.size", memsize);
-    RegisterEasy("mem.iscode", memiscode);
-    RegisterEasy("mem.isstring", memisstring);
-    RegisterEasy("mem.decodepointer", memdecodepointer);
+    RegisterEasy("mem.valid,mem.isvalid", memvalid, Validity::UntilStep);
+    RegisterEasy("mem.base", membase, Validity::UntilStep);
+    RegisterEasy("mem.size", memsize, Validity::UntilStep);
+    RegisterEasy("mem.iscode", memiscode, Validity::UntilStep);
+    RegisterEasy("mem.isstring", memisstring, Validity::UntilStep);
+    RegisterEasy("mem.decodepointer", memdecodepointer, Validity::UntilStep);
 
     //Disassembly
-    RegisterEasy("dis.len,dis.size", dislen);
-    RegisterEasy("dis.iscond", disiscond);
-    RegisterEasy("dis.isbranch", disisbranch);
-    RegisterEasy("dis.isret", disisret);
-    RegisterEasy("dis.iscall", disiscall);
-    RegisterEasy("dis.ismem", disismem);
-    RegisterEasy("dis.isnop", disisnop);
-    RegisterEasy("dis.isunusual", disisunusual);
-    RegisterEasy("dis.branchdest", disbranchdest);
-    RegisterEasy("dis.branchexec", disbranchexec);
-    RegisterEasy("dis.imm", disimm);
-    RegisterEasy("dis.brtrue", disbrtrue);
-    RegisterEasy("dis.brfalse", disbrfalse);
-    RegisterEasy("dis.next", disnext);
-    RegisterEasy("dis.prev", disprev);
-    RegisterEasy("dis.iscallsystem", disiscallsystem);
+    RegisterEasy("dis.len,dis.size", dislen, Validity::UntilStep);
+    RegisterEasy("dis.iscond", disiscond, Validity::UntilStep);
+    RegisterEasy("dis.isbranch", disisbranch, Validity::UntilStep);
+    RegisterEasy("dis.isret", disisret, Validity::UntilStep);
+    RegisterEasy("dis.iscall", disiscall, Validity::UntilStep);
+    RegisterEasy("dis.ismem", disismem, Validity::UntilStep);
+    RegisterEasy("dis.isnop", disisnop, Validity::UntilStep);
+    RegisterEasy("dis.isunusual", disisunusual, Validity::UntilStep);
+    RegisterEasy("dis.branchdest", disbranchdest, Validity::UntilStep);
+    RegisterEasy("dis.branchexec", disbranchexec, Validity::UntilStep);
+    RegisterEasy("dis.imm", disimm, Validity::UntilStep);
+    RegisterEasy("dis.brtrue", disbrtrue, Validity::UntilStep);
+    RegisterEasy("dis.brfalse", disbrfalse, Validity::UntilStep);
+    RegisterEasy("dis.next", disnext, Validity::UntilStep);
+    RegisterEasy("dis.prev", disprev, Validity::UntilStep);
+    RegisterEasy("dis.iscallsystem", disiscallsystem, Validity::UntilStep);
 
     //Trace record
     RegisterEasy("tr.enabled", trenabled);
@@ -111,13 +115,13 @@ void ExpressionFunctions::Init()
     RegisterEasy("tr.runtraceenabled", trisruntraceenabled);
 
     //Byte/Word/Dword/Qword/Pointer
-    RegisterEasy("ReadByte,Byte,byte", readbyte);
-    RegisterEasy("ReadWord,Word,word", readword);
-    RegisterEasy("ReadDword,Dword,dword", readdword);
+    RegisterEasy("ReadByte,Byte,byte", readbyte, Validity::UntilStep);
+    RegisterEasy("ReadWord,Word,word", readword, Validity::UntilStep);
+    RegisterEasy("ReadDword,Dword,dword", readdword, Validity::UntilStep);
 #ifdef _WIN64
-    RegisterEasy("ReadQword,Qword,qword", readqword);
+    RegisterEasy("ReadQword,Qword,qword", readqword, Validity::UntilStep);
 #endif //_WIN64
-    RegisterEasy("ReadPtr,ReadPointer,ptr,Pointer,pointer", readptr);
+    RegisterEasy("ReadPtr,ReadPointer,ptr,Pointer,pointer", readptr, Validity::UntilStep);
 
     //Functions
     RegisterEasy("func.start,sub.start", funcstart);
@@ -134,18 +138,18 @@ void ExpressionFunctions::Init()
     RegisterEasy("arg.set", argset);
 
     //Exceptions
-    RegisterEasy("ex.firstchance", exfirstchance);
-    RegisterEasy("ex.addr", exaddr);
-    RegisterEasy("ex.code", excode);
-    RegisterEasy("ex.flags", exflags);
-    RegisterEasy("ex.infocount", exinfocount);
-    RegisterEasy("ex.info", exinfo);
+    RegisterEasy("ex.firstchance", exfirstchance, Validity::UntilStep);
+    RegisterEasy("ex.addr", exaddr, Validity::UntilStep);
+    RegisterEasy("ex.code", excode, Validity::UntilStep);
+    RegisterEasy("ex.flags", exflags, Validity::UntilStep);
+    RegisterEasy("ex.infocount", exinfocount, Validity::UntilStep);
+    RegisterEasy("ex.info", exinfo, Validity::UntilStep);
 
     //Undocumented
     RegisterEasy("bpgoto", bpgoto);
 }
 
-bool ExpressionFunctions::Register(const String & name, int argc, const CBEXPRESSIONFUNCTION & cbFunction, void* userdata)
+bool ExpressionFunctions::Register(const String & name, int argc, const CBEXPRESSIONFUNCTION & cbFunction, void* userdata, Validity validity)
 {
     if(!isValidName(name))
         return false;
@@ -157,6 +161,7 @@ bool ExpressionFunctions::Register(const String & name, int argc, const CBEXPRES
     f.argc = argc;
     f.cbFunction = cbFunction;
     f.userdata = userdata;
+    f.validity = validity;
     mFunctions[name] = f;
     return true;
 }
@@ -167,7 +172,7 @@ bool ExpressionFunctions::RegisterAlias(const String & name, const String & alia
     auto found = mFunctions.find(name);
     if(found == mFunctions.end())
         return false;
-    if(!Register(alias, found->second.argc, found->second.cbFunction, found->second.userdata))
+    if(!Register(alias, found->second.argc, found->second.cbFunction, found->second.userdata, found->second.validity))
         return false;
     found->second.aliases.push_back(alias);
     return true;
@@ -195,10 +200,43 @@ bool ExpressionFunctions::Call(const String & name, std::vector<duint> & argv, d
     const auto & f = found->second;
     if(f.argc != int(argv.size()))
         return false;
+    String cacheKey;
+    duint epoch = 0;
+    if(f.validity != Validity::Volatile)
+    {
+        epoch = f.validity == Validity::UntilStep ? mStepEpoch.load() : mModuleEpoch.load();
+        cacheKey = name;
+        for(auto arg : argv)
+            cacheKey += StringUtils::sprintf("|%p", arg);
+        EXCLUSIVE_ACQUIRE(LockExpressionFunctionsCache);
+        auto cached = mCache.find(cacheKey);
+        if(cached != mCache.end() && cached->second.epoch == epoch)
+        {
+            result = cached->second.result;
+            return true;
+        }
+    }
     result = f.cbFunction(f.argc, argv.data(), f.userdata);
+    if(f.validity != Validity::Volatile)
+    {
+        EXCLUSIVE_ACQUIRE(LockExpressionFunctionsCache);
+        if(mCache.size() > 4096) //bound stale entries from previous epochs
+            mCache.clear();
+        mCache[cacheKey] = CachedResult { epoch, result };
+    }
     return true;
 }
 
+void ExpressionFunctions::InvalidateStep()
+{
+    mStepEpoch++;
+}
+
+void ExpressionFunctions::InvalidateModule()
+{
+    mModuleEpoch++;
+}
+
 bool ExpressionFunctions::GetArgc(const String & name, int & argc)
 {
     SHARED_ACQUIRE(LockExpressionFunctions);
@@ -2,18 +2,31 @@
 
 #include "_global.h"
 #include <functional>
+#include <atomic>
 
 class ExpressionFunctions
 {
 public:
     using CBEXPRESSIONFUNCTION = std::function<duint(int argc, duint* argv, void* userdata)>;
 
+    //How long the result of a function stays valid for the same arguments.
+    //Used to serve repeated evaluations (GUI refreshes, conditional
+    //breakpoints) from a cache instead of re-executing the function.
+    enum class Validity
+    {
+        Volatile, //the result may change at any time, never cached
+        UntilStep, //the result only changes when the debuggee executes or memory is written
+        UntilModuleChange //the result only changes when the module list changes
+    };
+
     static void Init();
-    static bool Register(const String & name, int argc, const CBEXPRESSIONFUNCTION & cbFunction, void* userdata = nullptr);
+    static bool Register(const String & name, int argc, const CBEXPRESSIONFUNCTION & cbFunction, void* userdata = nullptr, Validity validity = Validity::Volatile);
     static bool RegisterAlias(const String & name, const String & alias);
     static bool Unregister(const String & name);
     static bool Call(const String & name, std::vector<duint> & argv, duint & result);
     static bool GetArgc(const String & name, int & argc);
+    static void InvalidateStep(); //the debuggee executed or memory was written
+    static void InvalidateModule(); //the module list changed
 
 private:
     struct Function
@@ -22,10 +35,20 @@ private:
         int argc = 0;
         CBEXPRESSIONFUNCTION cbFunction;
         void* userdata = nullptr;
+        Validity validity = Validity::Volatile;
         std::vector<String> aliases;
     };
 
+    struct CachedResult
+    {
+        duint epoch;
+        duint result;
+    };
+
     static bool isValidName(const String & name);
 
     static std::unordered_map<String, Function> mFunctions;
+    static std::unordered_map<String, CachedResult> mCache; //key: function name and arguments
+    static std::atomic<duint> mStepEpoch;
+    static std::atomic<duint> mModuleEpoch;
 };
\ No newline at end of file
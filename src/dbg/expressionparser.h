@@ -110,6 +110,11 @@ public:
         Type mType;
     };
 
+    const std::vector<Token> & GetTokens() const
+    {
+        return mTokens;
+    }
+
     struct EvalValue
     {
         bool evaluated;
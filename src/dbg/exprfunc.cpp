@@ -221,7 +221,7 @@ namespace Exprfunc
         unsigned char data[16];
         if(MemRead(addr, data, sizeof(data), nullptr, true))
         {
-            Zydis cp;
+            auto & cp = Zydis::ThreadLocal();
             if(cp.Disassemble(addr, data))
                 return cp.IsNop();
         }
@@ -233,7 +233,7 @@ namespace Exprfunc
         unsigned char data[16];
         if(MemRead(addr, data, sizeof(data), nullptr, true))
         {
-            Zydis cp;
+            auto & cp = Zydis::ThreadLocal();
             if(cp.Disassemble(addr, data))
                 return cp.IsUnusual();
         }
@@ -1,6 +1,7 @@
 #include "filehelper.h"
 #include "handle.h"
 #include "stringutils.h"
+#include "filemap.h"
 
 bool FileHelper::ReadAllData(const String & fileName, std::vector<unsigned char> & content)
 {
@@ -71,30 +72,68 @@ bool FileHelper::WriteAllText(const String & fileName, const String & content)
 
 bool FileHelper::ReadAllLines(const String & fileName, std::vector<String> & lines, bool keepEmpty)
 {
-    String content;
-    if(!ReadAllText(fileName, content))
-        return false;
     lines.clear();
-    String line;
-    for(auto ch : content)
+    //the clipboard pseudo-file cannot be mapped, split the copied text instead
+    if(fileName.compare("x64dbg://localhost/clipboard") == 0)
+    {
+        String content;
+        if(!ReadAllText(fileName, content))
+            return false;
+        String line;
+        for(auto ch : content)
+        {
+            switch(ch)
+            {
+            case '\r':
+                break;
+            case '\n':
+                if(line.length() || keepEmpty)
+                    lines.push_back(line);
+                line.clear();
+                break;
+            default:
+                line.resize(line.length() + 1);
+                line[line.length() - 1] = ch;
+                break;
+            }
+        }
+        if(line.length())
+            lines.push_back(line);
+        return true;
+    }
+    return ReadLinesMapped(fileName, [&lines, keepEmpty](const char* line, size_t length)
+    {
+        if(length || keepEmpty)
+            lines.emplace_back(line, length);
+        return true;
+    });
+}
+
+bool FileHelper::ReadLinesMapped(const String & fileName, const std::function<bool(const char* line, size_t length)> & cbLine)
+{
+    FileMap<char> fileMap;
+    if(!fileMap.Map(StringUtils::Utf8ToUtf16(fileName).c_str()))
+    {
+        //an empty file cannot be mapped, but has no lines to report either
+        Handle hFile = CreateFileW(StringUtils::Utf8ToUtf16(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+        return hFile != INVALID_HANDLE_VALUE && GetFileSize(hFile, nullptr) == 0;
+    }
+    auto data = fileMap.Data();
+    size_t size = fileMap.Size();
+    size_t lineStart = 0;
+    for(size_t i = 0; i <= size; i++)
     {
-        switch(ch)
+        if(i == size || data[i] == '\n')
         {
-        case '\r':
-            break;
-        case '\n':
-            if(line.length() || keepEmpty)
-                lines.push_back(line);
-            line.clear();
-            break;
-        default:
-            line.resize(line.length() + 1);
-            line[line.length() - 1] = ch;
-            break;
+            auto lineLength = i - lineStart;
+            if(lineLength && data[lineStart + lineLength - 1] == '\r')
+                lineLength--;
+            //a trailing line break does not start an empty final line
+            if((lineLength || i != size) && !cbLine(data + lineStart, lineLength))
+                break;
+            lineStart = i + 1;
         }
     }
-    if(line.length())
-        lines.push_back(line);
     return true;
 }
 
@@ -2,6 +2,7 @@
 #define _FILEREADER_H
 
 #include "_global.h"
+#include <functional>
 
 class FileHelper
 {
@@ -11,6 +12,11 @@ public:
     static bool ReadAllText(const String & fileName, String & content);
     static bool WriteAllText(const String & fileName, const String & content);
     static bool ReadAllLines(const String & fileName, std::vector<String> & lines, bool keepEmpty = false);
+    //Map fileName and invoke cbLine(line, length) for every line in order,
+    //without materializing the file contents; the pointer is only valid
+    //during the callback and the line break is not included. Return false
+    //from the callback to stop early.
+    static bool ReadLinesMapped(const String & fileName, const std::function<bool(const char* line, size_t length)> & cbLine);
     static String GetFileName(const String & fileName);
 };
 
@@ -1,4 +1,5 @@
 #include "formatfunctions.h"
+#include "console.h"
 #include "threading.h"
 #include "value.h"
 #include "memory.h"
@@ -58,23 +59,23 @@ static FORMATRESULT memoryFormatter(char* dest, size_t destCount, int argc, char
     duint size = DefaultSize;
     if(argc > 1 && !valfromstring(argv[1], &size))
     {
-        strcpy_s(dest, destCount, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid argument...")));
+        strcpy_s(dest, destCount, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid argument...")));
         return FORMAT_ERROR_MESSAGE;
     }
     if(size == 0)
     {
-        strcpy_s(dest, destCount, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Not enough arguments...")));
+        strcpy_s(dest, destCount, dtranslate(QT_TRANSLATE_NOOP("DBG", "Not enough arguments...")));
         return FORMAT_ERROR_MESSAGE;
     }
     if(size > 1024 * 1024 * 10) //10MB max
     {
-        strcpy_s(dest, destCount, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Too much data (10MB max)...")));
+        strcpy_s(dest, destCount, dtranslate(QT_TRANSLATE_NOOP("DBG", "Too much data (10MB max)...")));
         return FORMAT_ERROR_MESSAGE;
     }
     std::vector<Char> data(size);
     if(!MemRead(addr, data.data(), size * sizeof(Char)))
     {
-        strcpy_s(dest, destCount, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Failed to read memory...")));
+        strcpy_s(dest, destCount, dtranslate(QT_TRANSLATE_NOOP("DBG", "Failed to read memory...")));
         return FORMAT_ERROR_MESSAGE;
     }
     auto result = format(data);
@@ -84,6 +85,44 @@ static FORMATRESULT memoryFormatter(char* dest, size_t destCount, int argc, char
     return FORMAT_SUCCESS;
 }
 
+static FORMATRESULT streamErrorMsg(const FormatFunctions::CBFORMATSINK & sink, const char* message)
+{
+    auto translated = dtranslate(message);
+    sink(translated, strlen(translated));
+    return FORMAT_ERROR_MESSAGE;
+}
+
+//Streaming variant of memoryFormatter: memory is read and formatted one
+//fixed-size segment at a time, so peak usage is bounded by the segment
+//size plus the final output instead of the full raw buffer, the full
+//formatted string and the grow-and-retry copies in Call. The memory
+//itself still has to be read while the debuggee is paused, so segments
+//cannot be produced lazily after a resume.
+template<class Char, size_t DefaultSize = 0>
+static FORMATRESULT memoryStreamFormatter(const FormatFunctions::CBFORMATSINK & sink, int argc, char* argv[], duint addr, const std::function<void(const Char*, size_t, String &)> & formatSegment)
+{
+    duint size = DefaultSize;
+    if(argc > 1 && !valfromstring(argv[1], &size))
+        return streamErrorMsg(sink, QT_TRANSLATE_NOOP("DBG", "Invalid argument..."));
+    if(size == 0)
+        return streamErrorMsg(sink, QT_TRANSLATE_NOOP("DBG", "Not enough arguments..."));
+    if(size > 1024 * 1024 * 64) //64MB max, only one segment is buffered at a time
+        return streamErrorMsg(sink, QT_TRANSLATE_NOOP("DBG", "Too much data (64MB max)..."));
+    const duint segmentCount = 65536 / sizeof(Char);
+    std::vector<Char> data(min(segmentCount, size));
+    String formatted;
+    for(duint offset = 0; offset < size; offset += segmentCount)
+    {
+        auto count = min(segmentCount, size - offset);
+        if(!MemRead(addr + offset * sizeof(Char), data.data(), count * sizeof(Char)))
+            return streamErrorMsg(sink, QT_TRANSLATE_NOOP("DBG", "Failed to read memory..."));
+        formatted.clear();
+        formatSegment(data.data(), count, formatted);
+        sink(formatted.c_str(), formatted.size());
+    }
+    return FORMAT_SUCCESS;
+}
+
 static FORMATRESULT formatcpy_s(char* dest, size_t destCount, const char* source)
 {
     switch(strncpy_s(dest, destCount, source, _TRUNCATE))
@@ -100,31 +139,33 @@ static FORMATRESULT formatcpy_s(char* dest, size_t destCount, const char* source
 
 void FormatFunctions::Init()
 {
-    Register("mem", [](char* dest, size_t destCount, int argc, char* argv[], duint addr, void* userdata)
+    //mem and ascii format each byte independently so they can stream
+    //large dumps segment by segment
+    RegisterStream("mem", [](const CBFORMATSINK & sink, int argc, char* argv[], duint addr, void* userdata)
     {
-        return memoryFormatter<unsigned char>(dest, destCount, argc, argv, addr, [](std::vector<unsigned char> & data)
+        return memoryStreamFormatter<unsigned char>(sink, argc, argv, addr, [](const unsigned char* data, size_t count, String & formatted)
         {
-            return StringUtils::ToHex(data.data(), data.size());
+            formatted = StringUtils::ToHex(data, count);
         });
     });
 
-    Register("ascii", [](char* dest, size_t destCount, int argc, char* argv[], duint addr, void* userdata)
+    RegisterStream("ascii", [](const CBFORMATSINK & sink, int argc, char* argv[], duint addr, void* userdata)
     {
-        return memoryFormatter<unsigned char, 512>(dest, destCount, argc, argv, addr, [](std::vector<unsigned char> & data)
+        return memoryStreamFormatter<unsigned char, 512>(sink, argc, argv, addr, [](const unsigned char* data, size_t count, String & formatted)
         {
-            String result;
-            result.reserve(data.size());
-            for(auto & ch : data)
+            formatted.reserve(count);
+            for(size_t i = 0; i < count; i++)
             {
-                if(isprint(ch))
-                    result.push_back(char(ch));
+                if(isprint(data[i]))
+                    formatted.push_back(char(data[i]));
                 else
-                    result.push_back('?');
+                    formatted.push_back('?');
             }
-            return result;
         });
     });
 
+    //the codepage conversions below can have multibyte sequences spanning
+    //a segment boundary, so they keep the buffered formatter
     Register("ansi", [](char* dest, size_t destCount, int argc, char* argv[], duint addr, void* userdata)
     {
         return memoryFormatter<char, 512>(dest, destCount, argc, argv, addr, [](std::vector<char> & data)
@@ -212,12 +253,12 @@ void FormatFunctions::Init()
         duint size = sizeof(duint);
         if(argc > 1 && !valfromstring(argv[1], &size))
         {
-            strcpy_s(dest, destCount, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid argument...")));
+            strcpy_s(dest, destCount, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid argument...")));
             return FORMAT_ERROR_MESSAGE;
         }
         if(size > sizeof(duint) || size == 0)
         {
-            strcpy_s(dest, destCount, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid size...")));
+            strcpy_s(dest, destCount, dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid size...")));
             return FORMAT_ERROR_MESSAGE;
         }
         auto data = (unsigned char*)&addr;
@@ -243,13 +284,33 @@ bool FormatFunctions::Register(const String & type, const CBFORMATFUNCTION & cbF
     return true;
 }
 
+bool FormatFunctions::RegisterStream(const String & type, const CBFORMATSTREAMFUNCTION & cbFunction, void* userdata)
+{
+    if(!isValidName(type))
+        return false;
+    EXCLUSIVE_ACQUIRE(LockFormatFunctions);
+    if(mFunctions.count(type))
+        return false;
+    Function f;
+    f.type = type;
+    f.cbStreamFunction = cbFunction;
+    f.userdata = userdata;
+    mFunctions[type] = f;
+    return true;
+}
+
 bool FormatFunctions::RegisterAlias(const String & name, const String & alias)
 {
     EXCLUSIVE_ACQUIRE(LockFormatFunctions);
     auto found = mFunctions.find(name);
     if(found == mFunctions.end())
         return false;
-    if(!Register(alias, found->second.cbFunction, found->second.userdata))
+    if(found->second.cbStreamFunction)
+    {
+        if(!RegisterStream(alias, found->second.cbStreamFunction, found->second.userdata))
+            return false;
+    }
+    else if(!Register(alias, found->second.cbFunction, found->second.userdata))
         return false;
     found->second.aliases.push_back(alias);
     return true;
@@ -280,6 +341,17 @@ bool FormatFunctions::Call(std::vector<char> & dest, const String & type, std::v
         argvn[i] = (char*)argv[i].c_str();
 
     const auto & f = found->second;
+    if(f.cbStreamFunction) //streaming formatter: segments are appended as produced, no grow-and-retry
+    {
+        dest.clear();
+        auto sink = [&dest](const char* data, size_t size)
+        {
+            dest.insert(dest.end(), data, data + size);
+        };
+        auto streamResult = f.cbStreamFunction(sink, int(argv.size()), argvn.data(), value, f.userdata);
+        dest.push_back('\0');
+        return streamResult != FORMAT_ERROR;
+    }
     dest.resize(512, '\0');
 fuckthis:
     auto result = f.cbFunction(dest.data(), dest.size() - 1, int(argv.size()), argvn.data(), value, f.userdata);
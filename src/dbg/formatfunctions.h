@@ -9,8 +9,16 @@ class FormatFunctions
 public:
     using CBFORMATFUNCTION = std::function<FORMATRESULT(char* dest, size_t destCount, int argc, char* argv[], duint value, void* userdata)>;
 
+    //Sink that appends one formatted segment to the output. Streaming
+    //formatters push fixed-size segments through the sink instead of
+    //filling a caller-provided buffer, so only one segment worth of
+    //intermediate data is in flight regardless of the dump size.
+    using CBFORMATSINK = std::function<void(const char* data, size_t size)>;
+    using CBFORMATSTREAMFUNCTION = std::function<FORMATRESULT(const CBFORMATSINK & sink, int argc, char* argv[], duint value, void* userdata)>;
+
     static void Init();
     static bool Register(const String & type, const CBFORMATFUNCTION & cbFunction, void* userdata = nullptr);
+    static bool RegisterStream(const String & type, const CBFORMATSTREAMFUNCTION & cbFunction, void* userdata = nullptr);
     static bool RegisterAlias(const String & type, const String & alias);
     static bool Unregister(const String & type);
     static bool Call(std::vector<char> & dest, const String & type, std::vector<String> & argv, duint value);
@@ -20,6 +28,7 @@ private:
     {
         String type;
         CBFORMATFUNCTION cbFunction;
+        CBFORMATSTREAMFUNCTION cbStreamFunction; //set for streaming formatters, takes precedence over cbFunction
         void* userdata = nullptr;
         std::vector<String> aliases;
     };
@@ -86,10 +86,40 @@ bool FunctionAdd(duint Start, duint End, bool Manual, duint InstructionCount, du
     return functions.Add(function);
 }
 
+duint FunctionBatchAdd(const std::vector<std::pair<duint, duint>> & Functions, bool Manual)
+{
+    // Validate and convert every range without the lock held, then insert the
+    // whole batch with a single acquisition
+    std::vector<FUNCTIONSINFO> batch;
+    batch.reserve(Functions.size());
+    for(const auto & range : Functions)
+    {
+        duint start = range.first;
+        duint end = range.second;
+        if(start > end || !MemIsValidReadPtr(start))
+            continue;
+        auto moduleBase = ModBaseFromAddr(start);
+        if(moduleBase != ModBaseFromAddr(end))
+            continue;
+        if(FunctionOverlaps(start, end))
+            continue;
+        FUNCTIONSINFO function;
+        function.modhash = ModHashFromAddr(moduleBase);
+        function.start = start - moduleBase;
+        function.end = end - moduleBase;
+        function.manual = Manual;
+        function.instructioncount = 0;
+        function.parent = start - moduleBase;
+        batch.push_back(function);
+    }
+    functions.AddRange(batch);
+    return batch.size();
+}
+
 bool FunctionGet(duint Address, duint* Start, duint* End, duint* InstrCount, duint* Parent)
 {
     FUNCTIONSINFO function;
-    if(!functions.Get(Functions::VaKey(Address, Address), function))
+    if(!functions.GetIndexed(Functions::VaKey(Address, Address), function))
         return false;
     functions.AdjustValue(function);
     if(Start)
@@ -108,7 +138,7 @@ bool FunctionOverlaps(duint Start, duint End)
     // A function can't end before it begins
     if(Start > End)
         return false;
-    return functions.Contains(Functions::VaKey(Start, End));
+    return functions.ContainsIndexed(Functions::VaKey(Start, End));
 }
 
 bool FunctionDelete(duint Address)
@@ -173,5 +203,5 @@ void FunctionGetList(std::vector<FUNCTIONSINFO> & list)
 
 bool FunctionGetInfo(duint Address, FUNCTIONSINFO & info)
 {
-    return functions.Get(Functions::VaKey(Address, Address), info);
+    return functions.GetIndexed(Functions::VaKey(Address, Address), info);
 }
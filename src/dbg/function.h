@@ -19,6 +19,7 @@ struct FUNCTIONSINFO
 };
 
 bool FunctionAdd(duint Start, duint End, bool Manual, duint InstructionCount = 0, duint Parent = 0);
+duint FunctionBatchAdd(const std::vector<std::pair<duint, duint>> & Functions, bool Manual);
 bool FunctionGet(duint Address, duint* Start = nullptr, duint* End = nullptr, duint* InstrCount = nullptr, duint* Parent = nullptr);
 bool FunctionOverlaps(duint Start, duint End);
 bool FunctionDelete(duint Address);
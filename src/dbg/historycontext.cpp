@@ -1,5 +1,6 @@
 #include "historycontext.h"
 #include "disasm_helper.h"
+#include "disasm_fast.h"
 #include "memory.h"
 #include "console.h"
 #include "watch.h"
@@ -9,7 +10,22 @@
 #include <deque>
 
 static const duint HistoryMaxCount = 4096;
+static const duint HistoryMaxBytes = 64 * 1024 * 1024; //cap on snapshot memory across all restore points
 static std::deque<HistoryContext> history;
+static duint historyBytes = 0; //uniquely held snapshot bytes, guarded by LockHistory
+
+// Instructions that write memory without a visible memory operand, these must
+// take the full disassembly path below
+static bool writesImplicitMemory(const char* instruction)
+{
+    return strncmp(instruction, "push", 4) == 0 ||
+           strncmp(instruction, "call", 4) == 0 ||
+           strncmp(instruction, "enter", 5) == 0 ||
+           strncmp(instruction, "stos", 4) == 0 ||
+           strncmp(instruction, "movs", 4) == 0 ||
+           strncmp(instruction, "ins", 3) == 0 ||
+           strncmp(instruction, "rep", 3) == 0;
+}
 
 //This will capture the current instruction
 HistoryContext::HistoryContext()
@@ -17,6 +33,13 @@ HistoryContext::HistoryContext()
     DISASM_INSTR instruction;
     if(GetFullContextDataEx(hActiveThread, &registers) && MemIsValidReadPtr(registers.cip))
     {
+        invalid = false;
+        // Cheap classification first: most stepped instructions write no
+        // memory at all, in that case the registers are the entire snapshot
+        // and the full disassembly below is skipped
+        BASIC_INSTRUCTION_INFO basicinfo;
+        if(disasmfast(registers.cip, &basicinfo, true) && !(basicinfo.type & TYPE_MEMORY) && !writesImplicitMemory(basicinfo.instruction))
+            return;
         disasmget(registers.cip, &instruction);
         if(!(memcmp(instruction.instruction, "nop ", 4) == 0 || memcmp(instruction.instruction, "lea ", 4) == 0))
             // do not process the memory operands of these instructions, because these instructions do not write to the memory.
@@ -24,10 +47,10 @@ HistoryContext::HistoryContext()
             if(memcmp(instruction.instruction, "push", 4) == 0 || memcmp(instruction.instruction, "call", 4) == 0)
                 // push and call instruction : save previous content on the stack
             {
-                ChangedData olddata;
-                olddata.addr = registers.csp - sizeof(duint);
-                MemRead(olddata.addr, (unsigned char*)olddata.oldvalue, sizeof(duint));
-                ChangedLocation.push_back(olddata);
+                auto olddata = std::make_shared<PreImage>();
+                olddata->addr = registers.csp - sizeof(duint);
+                MemRead(olddata->addr, (unsigned char*)olddata->oldvalue, sizeof(duint));
+                ChangedLocation.push_back(std::move(olddata));
             }
             // TODO: FPU/SSE instructions, ENTER instruction, and possibly other instructions.
             // These instructions can write more than sizeof(duint) bytes.
@@ -36,14 +59,13 @@ HistoryContext::HistoryContext()
                 DISASM_ARG & arg = instruction.arg[i];
                 if(arg.type == DISASM_ARGTYPE::arg_memory)
                 {
-                    ChangedData olddata;
-                    olddata.addr = arg.value;
-                    memcpy(olddata.oldvalue, &arg.memvalue, sizeof(arg.memvalue));
-                    ChangedLocation.push_back(olddata);
+                    auto olddata = std::make_shared<PreImage>();
+                    olddata->addr = arg.value;
+                    memcpy(olddata->oldvalue, &arg.memvalue, sizeof(arg.memvalue));
+                    ChangedLocation.push_back(std::move(olddata));
                 }
             }
         }
-        invalid = false;
     }
     else
         invalid = true;
@@ -54,7 +76,7 @@ void HistoryContext::restore()
     if(!invalid)
     {
         for(auto & i : ChangedLocation)
-            MemWrite(i.addr, i.oldvalue, sizeof(duint));
+            MemWrite(i->addr, i->oldvalue, sizeof(duint));
         SetFullContextDataEx(hActiveThread, &registers);
         cbCheckWatchdog(0, nullptr);
         DebugUpdateGui(GetContextDataEx(hActiveThread, UE_CIP), true);
@@ -66,6 +88,34 @@ void HistoryContext::restore()
     }
 }
 
+void HistoryContext::shareUnchangedWith(const HistoryContext & previous)
+{
+    for(auto & entry : ChangedLocation)
+    {
+        for(const auto & previousEntry : previous.ChangedLocation)
+        {
+            if(previousEntry->addr == entry->addr && memcmp(previousEntry->oldvalue, entry->oldvalue, sizeof(entry->oldvalue)) == 0)
+            {
+                entry = previousEntry; //reference the unchanged pre-image instead of keeping a second copy
+                break;
+            }
+        }
+    }
+}
+
+duint HistoryContext::ownedBytes() const
+{
+    // Pre-images shared with a neighbouring snapshot are accounted to
+    // whichever snapshot holds the last reference when it gets evicted
+    duint bytes = 0;
+    for(const auto & entry : ChangedLocation)
+    {
+        if(entry.use_count() == 1)
+            bytes += sizeof(PreImage);
+    }
+    return bytes;
+}
+
 HistoryContext::~HistoryContext()
 {
 }
@@ -73,9 +123,18 @@ HistoryContext::~HistoryContext()
 void HistoryAdd()
 {
     EXCLUSIVE_ACQUIRE(LockHistory);
-    if(history.size() > HistoryMaxCount)
-        history.pop_front();
     history.emplace_back();
+    auto & added = history.back();
+    if(history.size() >= 2)
+        added.shareUnchangedWith(history[history.size() - 2]);
+    historyBytes += sizeof(HistoryContext) + added.ownedBytes();
+    // Evict the oldest restore points when over the count or byte cap, so a
+    // multi-hour session keeps a bounded window of restorable steps
+    while(history.size() > HistoryMaxCount || (historyBytes > HistoryMaxBytes && history.size() > 1))
+    {
+        historyBytes -= sizeof(HistoryContext) + history.front().ownedBytes();
+        history.pop_front();
+    }
 }
 
 void HistoryRestore()
@@ -84,6 +143,7 @@ void HistoryRestore()
     if(!history.empty())
     {
         history.back().restore();
+        historyBytes -= sizeof(HistoryContext) + history.back().ownedBytes();
         history.pop_back();
     }
     else
@@ -100,4 +160,5 @@ void HistoryClear()
 {
     EXCLUSIVE_ACQUIRE(LockHistory);
     history.clear();
+    historyBytes = 0;
 }
@@ -3,6 +3,7 @@
 
 #include "_global.h"
 #include "TitanEngine/TitanEngine.h"
+#include <memory>
 
 /**
  * @brief The class used to hold history context.
@@ -14,15 +15,19 @@ public:
     ~HistoryContext();
 
     void restore();
+    //Share pre-images identical to the previous snapshot's, so unchanged
+    //state costs a reference count instead of another copy
+    void shareUnchangedWith(const HistoryContext & previous);
+    duint ownedBytes() const; //pre-image bytes this snapshot is the only holder of
 
 protected:
     TITAN_ENGINE_CONTEXT_t registers;
-    struct ChangedData
+    struct PreImage
     {
         duint addr;
         char oldvalue[32];
     };
-    std::vector<ChangedData> ChangedLocation;
+    std::vector<std::shared_ptr<PreImage>> ChangedLocation;
     bool invalid;
 };
 
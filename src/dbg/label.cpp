@@ -1,4 +1,6 @@
 #include "label.h"
+#include "value.h"
+#include "dbjournal.h"
 
 struct LabelSerializer : AddrInfoSerializer<LABELSINFO>
 {
@@ -11,8 +13,11 @@ struct LabelSerializer : AddrInfoSerializer<LABELSINFO>
 
     bool Load(LABELSINFO & value) override
     {
-        return AddrInfoSerializer::Load(value) &&
-               getString("text", value.text);
+        std::string text;
+        if(!AddrInfoSerializer::Load(value) || !getString("text", text))
+            return false;
+        value.text = text;
+        return true;
     }
 };
 
@@ -48,7 +53,11 @@ bool LabelSet(duint Address, const char* Text, bool Manual, bool Temp)
     if(!labels.PrepareValue(label, Address, Manual))
         return false;
     label.text = Text;
-    return labels.Add(label);
+    valnamecacheclear();
+    if(!labels.Add(label))
+        return false;
+    DbJournalAddValue<LabelSerializer>("labels", label);
+    return true;
 }
 
 bool LabelFromString(const char* Text, duint* Address)
@@ -93,12 +102,26 @@ bool LabelGet(duint Address, char* Text)
 
 bool LabelDelete(duint Address)
 {
-    return labels.Delete(Labels::VaKey(Address)) || tempLabels.erase(Address) > 0;
+    valnamecacheclear();
+    if(labels.Delete(Labels::VaKey(Address)))
+    {
+        DbJournalDeleteAt("labels", Address);
+        return true;
+    }
+    return tempLabels.erase(Address) > 0;
+}
+
+bool LabelDeleteByKey(duint Key)
+{
+    valnamecacheclear();
+    return labels.Delete(Key);
 }
 
 void LabelDelRange(duint Start, duint End, bool Manual)
 {
     labels.DeleteRange(Start, End, Manual);
+    DbJournalDelRangeAt("labels", Start, End, Manual);
+    valnamecacheclear();
     if(Start == 0 && End == ~0)
     {
         tempLabels.clear();
@@ -124,12 +147,14 @@ void LabelCacheLoad(JSON Root)
 {
     labels.CacheLoad(Root);
     labels.CacheLoad(Root, "auto"); //legacy support
+    valnamecacheclear();
 }
 
 void LabelClear()
 {
     labels.Clear();
     tempLabels.clear();
+    valnamecacheclear();
 }
 
 void LabelGetList(std::vector<LABELSINFO> & list)
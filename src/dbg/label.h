@@ -3,16 +3,18 @@
 
 #include "_global.h"
 #include "addrinfo.h"
+#include "stringpool.h"
 
 struct LABELSINFO : AddrInfo
 {
-    std::string text;
+    PooledString text; //imports and runtime names repeat across many addresses
 };
 
 bool LabelSet(duint Address, const char* Text, bool Manual, bool Temp = false);
 bool LabelFromString(const char* Text, duint* Address);
 bool LabelGet(duint Address, char* Text);
 bool LabelDelete(duint Address);
+bool LabelDeleteByKey(duint Key);
 void LabelDelRange(duint Start, duint End, bool Manual);
 void LabelCacheSave(JSON root);
 void LabelCacheLoad(JSON root);
@@ -3,9 +3,56 @@
 #include "threading.h"
 #include "module.h"
 #include "debugger.h"
+#include <algorithm>
 
 static std::map<DepthModuleRange, LOOPSINFO, DepthModuleRangeCompare> loops;
 
+// Flattened copy of the loop map for stabbing queries, same idea as the
+// indexed lookup in SerializableModuleRangeMap: the sidebar and disassembly
+// ask for the loop at every visible address and depth, and the sorted vector
+// answers that with contiguous probes. Rebuilt lazily after the map changed
+// (hold the exclusive lock to rebuild, the shared lock to query).
+static std::vector<std::pair<DepthModuleRange, LOOPSINFO>> loopsIndex;
+static bool loopsIndexDirty = true;
+
+static const LOOPSINFO* LoopsIndexFind(const DepthModuleRange & key)
+{
+    DepthModuleRangeCompare comp;
+    auto found = std::lower_bound(loopsIndex.begin(), loopsIndex.end(), key, [&comp](const std::pair<DepthModuleRange, LOOPSINFO> & a, const DepthModuleRange & b)
+    {
+        return comp(a.first, b);
+    });
+    if(found == loopsIndex.end() || comp(key, found->first))
+        return nullptr;
+    return &found->second;
+}
+
+static bool LoopsIndexGet(const DepthModuleRange & key, LOOPSINFO & info)
+{
+    {
+        SHARED_ACQUIRE(LockLoops);
+        if(!loopsIndexDirty)
+        {
+            auto found = LoopsIndexFind(key);
+            if(!found)
+                return false;
+            info = *found;
+            return true;
+        }
+    }
+    EXCLUSIVE_ACQUIRE(LockLoops);
+    if(loopsIndexDirty)
+    {
+        loopsIndex.assign(loops.begin(), loops.end());
+        loopsIndexDirty = false;
+    }
+    auto found = LoopsIndexFind(key);
+    if(!found)
+        return false;
+    info = *found;
+    return true;
+}
+
 bool LoopAdd(duint Start, duint End, bool Manual, duint instructionCount)
 {
     ASSERT_DEBUGGING("Export call");
@@ -90,6 +137,7 @@ bool LoopAdd(duint Start, duint End, bool Manual, duint instructionCount)
 
     // Insert into list
     loops.emplace(DepthModuleRange(finalDepth, ModuleRange(loopInfo.modhash, Range(loopInfo.start, loopInfo.end))), loopInfo);
+    loopsIndexDirty = true;
     return true;
 }
 
@@ -104,23 +152,20 @@ bool LoopGet(int Depth, duint Address, duint* Start, duint* End, duint* Instruct
     // Virtual address to relative address
     Address -= moduleBase;
 
-    SHARED_ACQUIRE(LockLoops);
-
     // Search with this address range
-    auto found = loops.find(DepthModuleRange(Depth, ModuleRange(ModHashFromAddr(moduleBase), Range(Address, Address))));
-
-    if(found == loops.end())
+    LOOPSINFO info;
+    if(!LoopsIndexGet(DepthModuleRange(Depth, ModuleRange(ModHashFromAddr(moduleBase), Range(Address, Address))), info))
         return false;
 
     // Return the loop start and end
     if(Start)
-        *Start = found->second.start + moduleBase;
+        *Start = info.start + moduleBase;
 
     if(End)
-        *End = found->second.end + moduleBase;
+        *End = info.end + moduleBase;
 
     if(InstructionCount)
-        *InstructionCount = found->second.instructioncount;
+        *InstructionCount = info.instructioncount;
 
     return true;
 }
@@ -141,20 +186,18 @@ bool LoopOverlaps(int Depth, duint Start, duint End, int* FinalDepth, duint* Fin
     if(FinalDepth)
         *FinalDepth = Depth;
 
-    SHARED_ACQUIRE(LockLoops);
-
-    auto found = loops.find(DepthModuleRange(Depth, ModuleRange(ModHashFromAddr(moduleBase), Range(Start, End))));
-    if(found == loops.end())
+    LOOPSINFO info;
+    if(!LoopsIndexGet(DepthModuleRange(Depth, ModuleRange(ModHashFromAddr(moduleBase), Range(Start, End))), info))
         return false;
 
-    if(found->second.start <= Start && found->second.end >= End)
+    if(info.start <= Start && info.end >= End)
         return LoopOverlaps(Depth + 1, Start + moduleBase, End + moduleBase, FinalDepth, FinalStart, FinalEnd);
 
     if(FinalStart)
-        *FinalStart = found->second.start + moduleBase;
+        *FinalStart = info.start + moduleBase;
 
     if(FinalEnd)
-        *FinalEnd = found->second.end + moduleBase;
+        *FinalEnd = info.end + moduleBase;
 
     return true;
 }
@@ -178,6 +221,7 @@ void LoopDeleteRange(duint Start, duint End)
     auto range = DepthModuleRange(0, ModuleRange(modHash, Range(Start - modBase, End - modBase)));
     while(LoopDeleteAllRange(range))
         range.first++;
+    loopsIndexDirty = true;
 }
 
 // This should delete a loop and all sub-loops that matches a certain addr
@@ -200,6 +244,7 @@ bool LoopDelete(int Depth, duint Address)
     auto range = found->first;
     while(LoopDeleteAllRange(range))
         range.first++;
+    loopsIndexDirty = true;
 
     return true;
 }
@@ -290,6 +335,8 @@ void LoopCacheLoad(JSON Root)
     // Load auto-set loops
     if(jsonAutoLoops)
         AddLoops(jsonAutoLoops, false);
+
+    loopsIndexDirty = true;
 }
 
 bool LoopEnum(LOOPSINFO* List, size_t* Size)
@@ -327,4 +374,6 @@ void LoopClear()
     EXCLUSIVE_ACQUIRE(LockLoops);
     std::map<DepthModuleRange, LOOPSINFO, DepthModuleRangeCompare> empty;
     std::swap(loops, empty);
+    loopsIndex.clear();
+    loopsIndexDirty = true;
 }
\ No newline at end of file
@@ -12,6 +12,15 @@
 #include "module.h"
 #include "taskthread.h"
 #include "value.h"
+#include "expressionfunctions.h"
+#include "incrementalanalysis.h"
+#include "performance.h"
+#include "console.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <ppl.h>
 
 #define PAGE_SHIFT              (12)
 //#define PAGE_SIZE               (4096)
@@ -23,21 +32,114 @@ static ULONG fallbackCookie = 0;
 std::map<Range, MEMPAGE, RangeCompare> memoryPages;
 bool bListAllPages = false;
 bool bQueryWorkingSet = false;
+bool bCacheMemoryReads = true;
 
-void MemUpdateMap()
+// Process-wide cache of target pages served to MemRead while the debuggee is paused.
+// The debug loop flushes it on every debug event (cbDebugEvent) and MemWrite
+// invalidates the written range, so cached data can never outlive a change the
+// debugger knows about.
+struct CachedPage
+{
+    unsigned char data[PAGE_SIZE];
+};
+
+static std::unordered_map<duint, CachedPage> readCachePages;
+
+// Bound the footprint to 16MB of target data, a full flush on overflow is
+// cheaper than LRU bookkeeping on the read hot path
+static const size_t ReadCacheMaxPages = 4096;
+
+// Bumped whenever cached target data may have gone stale, so derived caches
+// (like the walked exception handler chains) can cheaply detect staleness
+static std::atomic<duint> readCacheGeneration;
+
+void MemCacheFlush()
+{
+    readCacheGeneration.fetch_add(1, std::memory_order_relaxed);
+    EXCLUSIVE_ACQUIRE(LockMemoryReadCache);
+    readCachePages.clear();
+}
+
+void MemCacheInvalidate(duint BaseAddress, duint Size)
+{
+    if(!Size)
+        return;
+    readCacheGeneration.fetch_add(1, std::memory_order_relaxed);
+    auto start = PAGE_ALIGN(BaseAddress);
+    auto end = PAGE_ALIGN(BaseAddress + Size - 1);
+    EXCLUSIVE_ACQUIRE(LockMemoryReadCache);
+    if(readCachePages.empty())
+        return;
+    for(auto page = start; page <= end; page += PAGE_SIZE)
+        readCachePages.erase(page);
+}
+
+duint MemCacheGeneration()
+{
+    return readCacheGeneration.load(std::memory_order_relaxed);
+}
+
+static bool MemoryReadCachedPage(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID lpBuffer, SIZE_T nSize, SIZE_T* lpNumberOfBytesRead)
+{
+    auto pageBase = PAGE_ALIGN(lpBaseAddress);
+    auto pageOffset = duint(lpBaseAddress) - pageBase;
+
+    // Serve the read locally when the page is already cached
+    {
+        SHARED_ACQUIRE(LockMemoryReadCache);
+        auto found = readCachePages.find(pageBase);
+        if(found != readCachePages.end())
+        {
+            memcpy(lpBuffer, found->second.data + pageOffset, nSize);
+            if(lpNumberOfBytesRead)
+                *lpNumberOfBytesRead = nSize;
+            return true;
+        }
+    }
+
+    // Cache miss: read the whole page once so repaint-driven reads of the same
+    // page no longer cost a kernel round-trip each
+    CachedPage page;
+    SIZE_T pageBytesRead = 0;
+    if(!MemoryReadSafe(hProcess, LPVOID(pageBase), page.data, PAGE_SIZE, &pageBytesRead) || pageBytesRead != PAGE_SIZE)
+    {
+        // Partially readable page, fall back to the exact request without caching
+        return MemoryReadSafe(hProcess, lpBaseAddress, lpBuffer, nSize, lpNumberOfBytesRead);
+    }
+
+    memcpy(lpBuffer, page.data + pageOffset, nSize);
+    if(lpNumberOfBytesRead)
+        *lpNumberOfBytesRead = nSize;
+
+    EXCLUSIVE_ACQUIRE(LockMemoryReadCache);
+    if(readCachePages.size() >= ReadCacheMaxPages)
+        readCachePages.clear();
+    readCachePages.emplace(pageBase, page);
+    return true;
+}
+
+// Ranges touched since the last map refresh, used to requery only the affected
+// regions instead of rebuilding the whole map (guarded by LockMemoryPages)
+static std::vector<Range> memMapDirtyRanges;
+
+void MemUpdateMapDirty(duint Address, duint Size)
+{
+    EXCLUSIVE_ACQUIRE(LockMemoryPages);
+    memMapDirtyRanges.push_back(std::make_pair(Address, Size ? Address + Size - 1 : Address));
+}
+
+static bool MemEnumPageRange(duint rangeStart, duint rangeEnd, std::vector<MEMPAGE> & pageVector)
 {
-    // First gather all possible pages in the memory range
-    std::vector<MEMPAGE> pageVector;
-    pageVector.reserve(200); //TODO: provide a better estimate
+    // Gather all possible pages in the given memory range
     {
         SIZE_T numBytes = 0;
-        duint pageStart = 0;
+        duint pageStart = rangeStart;
         duint allocationBase = 0;
 
         do
         {
             if(!DbgIsDebugging())
-                return;
+                return false;
 
             // Query memory attributes
             MEMORY_BASIC_INFORMATION mbi;
@@ -63,9 +165,9 @@ void MemUpdateMap()
                     if(bReserved)
                     {
                         if(duint(curPage.mbi.BaseAddress) != allocationBase)
-                            sprintf_s(curPage.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Reserved (%p)")), allocationBase);
+                            sprintf_s(curPage.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "Reserved (%p)")), allocationBase);
                         else
-                            strcpy_s(curPage.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Reserved")));
+                            strcpy_s(curPage.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "Reserved")));
                     }
                     else if(!ModNameFromAddr(pageStart, curPage.info, true))
                     {
@@ -96,21 +198,25 @@ void MemUpdateMap()
             // Calculate the next page start
             duint newAddress = duint(mbi.BaseAddress) + mbi.RegionSize;
 
-            if(newAddress <= pageStart)
+            if(newAddress <= pageStart || newAddress > rangeEnd)
                 break;
 
             pageStart = newAddress;
         }
         while(numBytes);
     }
+    return true;
+}
 
+static bool MemProcessFileSections(std::vector<MEMPAGE> & pageVector)
+{
     // Process file sections
     int pagecount = (int)pageVector.size();
     char curMod[MAX_MODULE_SIZE] = "";
     for(int i = pagecount - 1; i > -1; i--)
     {
         if(!DbgIsDebugging())
-            return;
+            return false;
 
         auto & currentPage = pageVector.at(i);
         if(!currentPage.info[0] || (scmp(curMod, currentPage.info) && !bListAllPages)) //there is a module
@@ -181,7 +287,11 @@ void MemUpdateMap()
             }
         }
     }
+    return true;
+}
 
+static void MemAnnotateSystemPages(std::vector<MEMPAGE> & pageVector)
+{
     // Get a list of threads for information about Kernel/PEB/TEB/Stack ranges
     THREADLIST threadList;
     ThreadGetList(&threadList);
@@ -215,7 +325,7 @@ void MemUpdateMap()
         // Mark PEB
         if(pageBase == pebBase)
         {
-            strcpy_s(page.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "PEB")));
+            strcpy_s(page.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "PEB")));
             continue;
         }
 
@@ -233,7 +343,7 @@ void MemUpdateMap()
 
             if(pageBase == tebBase)
             {
-                sprintf_s(page.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Thread %X TEB")), threadId);
+                sprintf_s(page.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "Thread %X TEB")), threadId);
                 break;
             }
             else if(pageBase == tebBaseWow64)
@@ -241,7 +351,7 @@ void MemUpdateMap()
 #ifndef _WIN64
                 if(pageSize == (3 * PAGE_SIZE))
                 {
-                    sprintf_s(page.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Thread %X WoW64 TEB")), threadId);
+                    sprintf_s(page.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "Thread %X WoW64 TEB")), threadId);
                     break;
                 }
 #endif //_WIN64
@@ -251,24 +361,226 @@ void MemUpdateMap()
             duint stackAddr = stackAddrs[i];
 
             if(stackAddr >= pageBase && stackAddr < (pageBase + pageSize))
-                sprintf_s(page.info, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Thread %X Stack")), threadId);
+                sprintf_s(page.info, dtranslate(QT_TRANSLATE_NOOP("DBG", "Thread %X Stack")), threadId);
         }
     }
 
     // Only free thread data if it was allocated
     if(threadList.list)
         BridgeFree(threadList.list);
+}
 
-    // Convert the vector to a map
-    EXCLUSIVE_ACQUIRE(LockMemoryPages);
-    memoryPages.clear();
+typedef BOOL(WINAPI* QUERYWORKINGSETEX)(HANDLE, PVOID, DWORD);
 
-    for(auto & page : pageVector)
+static QUERYWORKINGSETEX fnQueryWorkingSetEx()
+{
+    static auto fn = QUERYWORKINGSETEX(GetProcAddress(GetModuleHandleW(L"psapi.dll"), "QueryWorkingSetEx"));
+    return fn;
+}
+
+// Sampled working-set cache. IgnoreThisRead used to issue one QueryWorkingSetEx
+// syscall per page read, which made enabling the setting painfully slow on big
+// targets. Instead the residency of all committed pages is sampled on a worker
+// thread after the memory map is published, batching thousands of pages into a
+// single QueryWorkingSetEx call, and the read path only checks the resulting
+// set of non-resident pages
+static std::unordered_set<duint> wsNonResidentPages;
+static bool wsCacheValid = false;
+
+static DWORD WINAPI memUpdateWorkingSetCache()
+{
+    auto fnQuery = fnQueryWorkingSetEx();
+    if(!bQueryWorkingSet || !fnQuery || !DbgIsDebugging())
+        return 0;
+
+    // Snapshot the committed pages from the published map
+    std::vector<Range> regions;
+    {
+        SHARED_ACQUIRE(LockMemoryPages);
+        regions.reserve(memoryPages.size());
+        for(auto & itr : memoryPages)
+        {
+            const auto & mbi = itr.second.mbi;
+            if(mbi.State == MEM_COMMIT)
+                regions.emplace_back(duint(mbi.BaseAddress), duint(mbi.BaseAddress) + mbi.RegionSize);
+        }
+    }
+
+    std::unordered_set<duint> nonResident;
+    std::vector<PSAPI_WORKING_SET_EX_INFORMATION> batch;
+    const size_t batchSize = 4096;
+    batch.reserve(batchSize);
+    auto flushBatch = [&]()
+    {
+        if(batch.empty())
+            return;
+        if(fnQuery(fdProcessInfo->hProcess, batch.data(), DWORD(batch.size() * sizeof(PSAPI_WORKING_SET_EX_INFORMATION))))
+        {
+            for(const auto & wsi : batch)
+                if(!wsi.VirtualAttributes.Valid)
+                    nonResident.insert(duint(wsi.VirtualAddress));
+        }
+        batch.clear();
+    };
+    for(const auto & region : regions)
+    {
+        for(duint page = region.first; page < region.second; page += PAGE_SIZE)
+        {
+            PSAPI_WORKING_SET_EX_INFORMATION wsi = {};
+            wsi.VirtualAddress = PVOID(page);
+            batch.push_back(wsi);
+            if(batch.size() >= batchSize)
+                flushBatch();
+        }
+    }
+    flushBatch();
+
+    EXCLUSIVE_ACQUIRE(LockWorkingSetCache);
+    wsNonResidentPages = std::move(nonResident);
+    wsCacheValid = true;
+    return 0;
+}
+
+static void MemUpdateWorkingSetCacheAsync()
+{
+    if(!bQueryWorkingSet)
+        return;
+    static TaskThread_<decltype(&memUpdateWorkingSetCache)> workingSetCacheTask(&memUpdateWorkingSetCache, 300);
+    workingSetCacheTask.WakeUp();
+}
+
+//Lock-free snapshot of the readable ranges in the published map. Pointer
+//styling in the GUI queries validity once per visible cell per repaint, so
+//those checks must not contend on LockMemoryPages; they binary search this
+//snapshot instead. Republished whenever memoryPages changes.
+static std::shared_ptr<const std::vector<Range>> validReadRanges;
+
+static void memPublishValidReadSnapshot()
+{
+    auto ranges = std::make_shared<std::vector<Range>>();
+    {
+        SHARED_ACQUIRE(LockMemoryPages);
+        ranges->reserve(memoryPages.size());
+        for(const auto & itr : memoryPages)
+        {
+            //match MemIsValidReadPtr(addr, true): reserved pages are not readable
+            if(itr.second.mbi.State != MEM_RESERVE)
+                ranges->push_back(itr.first);
+        }
+    }
+    std::atomic_store(&validReadRanges, std::shared_ptr<const std::vector<Range>>(std::move(ranges)));
+}
+
+void MemUpdateMap()
+{
+    PerfScope perf(PerfPhase::MemUpdateMap);
+    // Consume the pending dirty ranges. Without any (or without a previous map
+    // to patch) the entire address space has to be rebuilt
+    std::vector<Range> dirtyRanges;
+    {
+        EXCLUSIVE_ACQUIRE(LockMemoryPages);
+        if(!memoryPages.empty())
+            dirtyRanges = std::move(memMapDirtyRanges);
+        memMapDirtyRanges.clear();
+    }
+
+    if(dirtyRanges.empty())
+    {
+        // Full rebuild over the whole address space. When the target is
+        // running, freeze it during the enumeration so the snapshot cannot
+        // race concurrent allocations
+        std::vector<MEMPAGE> pageVector;
+        pageVector.reserve(200); //TODO: provide a better estimate
+        bool enumerated = false;
+        if(dbgisrunning())
+        {
+            ThreadRunWithWorldStopped([&pageVector, &enumerated]()
+            {
+                enumerated = MemEnumPageRange(0, ~duint(0), pageVector);
+            });
+        }
+        else
+            enumerated = MemEnumPageRange(0, ~duint(0), pageVector);
+        if(!enumerated)
+            return;
+        if(!MemProcessFileSections(pageVector))
+            return;
+        MemAnnotateSystemPages(pageVector);
+
+        // Convert the vector to a map
+        {
+            EXCLUSIVE_ACQUIRE(LockMemoryPages);
+            memoryPages.clear();
+
+            for(auto & page : pageVector)
+            {
+                duint start = (duint)page.mbi.BaseAddress;
+                duint size = (duint)page.mbi.RegionSize;
+                memoryPages.insert(std::make_pair(std::make_pair(start, start + size - 1), page));
+            }
+        }
+
+        memPublishValidReadSnapshot();
+
+        // A full rebuild may belong to a fresh debuggee: drop the stale
+        // residency samples before scheduling a pass over the published map
+        {
+            EXCLUSIVE_ACQUIRE(LockWorkingSetCache);
+            wsCacheValid = false;
+            wsNonResidentPages.clear();
+        }
+        MemUpdateWorkingSetCacheAsync();
+        return;
+    }
+
+    // Incremental refresh: requery only the touched ranges and splice the
+    // results into the existing map
+    for(auto & dirty : dirtyRanges)
     {
-        duint start = (duint)page.mbi.BaseAddress;
-        duint size = (duint)page.mbi.RegionSize;
-        memoryPages.insert(std::make_pair(std::make_pair(start, start + size - 1), page));
+        duint start = PAGE_ALIGN(dirty.first);
+        duint end = dirty.second | (PAGE_SIZE - 1);
+
+        // Expand to the boundaries of the regions currently overlapping the
+        // range, so partially affected allocations are requeried whole
+        {
+            SHARED_ACQUIRE(LockMemoryPages);
+            auto first = memoryPages.find(std::make_pair(start, start));
+            if(first != memoryPages.end())
+                start = min(start, first->first.first);
+            auto last = memoryPages.find(std::make_pair(end, end));
+            if(last != memoryPages.end())
+                end = max(end, last->first.second);
+        }
+
+        // Keep whole modules together, the section splitting assumes the
+        // module resides in one contiguous region
+        if(auto modBase = ModBaseFromAddr(start))
+            start = min(start, modBase);
+        if(auto modBase = ModBaseFromAddr(end))
+            end = max(end, modBase + ModSizeFromAddr(modBase) - 1);
+
+        std::vector<MEMPAGE> pageVector;
+        if(!MemEnumPageRange(start, end, pageVector))
+            return;
+        if(!MemProcessFileSections(pageVector))
+            return;
+        MemAnnotateSystemPages(pageVector);
+
+        // Drop the stale entries overlapping the requeried window and insert the fresh ones
+        EXCLUSIVE_ACQUIRE(LockMemoryPages);
+        auto stale = memoryPages.equal_range(std::make_pair(start, end));
+        memoryPages.erase(stale.first, stale.second);
+
+        for(auto & page : pageVector)
+        {
+            duint pageStart = (duint)page.mbi.BaseAddress;
+            duint pageSize = (duint)page.mbi.RegionSize;
+            memoryPages.insert(std::make_pair(std::make_pair(pageStart, pageStart + pageSize - 1), page));
+        }
     }
+
+    memPublishValidReadSnapshot();
+    MemUpdateWorkingSetCacheAsync();
 }
 
 static DWORD WINAPI memUpdateMap()
@@ -315,13 +627,22 @@ duint MemFindBaseAddr(duint Address, duint* Size, bool Refresh, bool FindReserve
 //TODO: name this function properly
 static bool IgnoreThisRead(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID lpBuffer, SIZE_T nSize, SIZE_T* lpNumberOfBytesRead)
 {
-    typedef BOOL(WINAPI * QUERYWORKINGSETEX)(HANDLE, PVOID, DWORD);
-    static auto fnQueryWorkingSetEx = QUERYWORKINGSETEX(GetProcAddress(GetModuleHandleW(L"psapi.dll"), "QueryWorkingSetEx"));
-    if(!bQueryWorkingSet || !fnQueryWorkingSetEx)
+    auto fnQuery = fnQueryWorkingSetEx();
+    if(!bQueryWorkingSet || !fnQuery)
         return false;
+
+    // Consult the sampled cache first so resident pages (the overwhelming
+    // majority) cost no syscall. Cache hits are re-confirmed with a single
+    // per-page query because the sample may be stale
+    auto pageAddress = PVOID(PAGE_ALIGN(lpBaseAddress));
+    {
+        SHARED_ACQUIRE(LockWorkingSetCache);
+        if(wsCacheValid && wsNonResidentPages.find(duint(pageAddress)) == wsNonResidentPages.end())
+            return false;
+    }
     PSAPI_WORKING_SET_EX_INFORMATION wsi;
-    wsi.VirtualAddress = (PVOID)PAGE_ALIGN(lpBaseAddress);
-    if(fnQueryWorkingSetEx(hProcess, &wsi, sizeof(wsi)) && !wsi.VirtualAttributes.Valid)
+    wsi.VirtualAddress = pageAddress;
+    if(fnQuery(hProcess, &wsi, sizeof(wsi)) && !wsi.VirtualAttributes.Valid)
     {
         MEMORY_BASIC_INFORMATION mbi;
         if(VirtualQueryEx(hProcess, wsi.VirtualAddress, &mbi, sizeof(mbi)) && mbi.State == MEM_COMMIT/* && mbi.Type == MEM_PRIVATE*/)
@@ -345,9 +666,62 @@ bool MemoryReadSafePage(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID lpBuffer,
 #endif
     if(IgnoreThisRead(hProcess, lpBaseAddress, lpBuffer, nSize, lpNumberOfBytesRead))
         return true;
+    // While paused the target cannot change behind our back, so reads are safe to
+    // serve from the page cache. A running target bypasses the cache entirely.
+    if(bCacheMemoryReads && !dbgisrunning())
+        return MemoryReadCachedPage(hProcess, lpBaseAddress, lpBuffer, nSize, lpNumberOfBytesRead);
     return MemoryReadSafe(hProcess, lpBaseAddress, lpBuffer, nSize, lpNumberOfBytesRead);
 }
 
+// Read tracking: while enabled on the current thread every successful MemRead
+// records the range it touched. The watch system uses this to learn which
+// memory an expression actually reads (see memwatch.cpp).
+static thread_local bool trackReads = false;
+static thread_local std::vector<std::pair<duint, duint>> trackedReads;
+
+void MemReadTrackStart()
+{
+    trackReads = true;
+    trackedReads.clear();
+}
+
+std::vector<std::pair<duint, duint>> MemReadTrackStop()
+{
+    trackReads = false;
+    return std::move(trackedReads);
+}
+
+// Read [BaseAddress, BaseAddress + Size) with as few ReadProcessMemory calls
+// as possible: attempt the whole run in one call and bisect on page boundaries
+// when a run is only partially readable. Returns the length of the readable
+// prefix, matching the sequential page loop this replaces for large reads.
+static duint MemReadBisect(duint BaseAddress, unsigned char* Buffer, duint Size)
+{
+    SIZE_T bytesRead = 0;
+    if(MemoryReadSafe(fdProcessInfo->hProcess, LPVOID(BaseAddress), Buffer, Size, &bytesRead) && bytesRead == Size)
+        return Size;
+
+    // A chunk that fits in one page goes through the page reader (and its cache)
+    duint sizeLeftInPage = PAGE_SIZE - (BaseAddress & (PAGE_SIZE - 1));
+    if(Size <= sizeLeftInPage)
+    {
+        bytesRead = 0;
+        MemoryReadSafePage(fdProcessInfo->hProcess, LPVOID(BaseAddress), Buffer, Size, &bytesRead);
+        return duint(bytesRead);
+    }
+
+    // Split on the page boundary closest to the middle
+    duint split = PAGE_ALIGN(BaseAddress + Size / 2);
+    if(split <= BaseAddress)
+        split = BaseAddress + sizeLeftInPage;
+
+    auto leftSize = split - BaseAddress;
+    auto left = MemReadBisect(BaseAddress, Buffer, leftSize);
+    if(left != leftSize)
+        return left;
+    return left + MemReadBisect(split, Buffer + leftSize, Size - leftSize);
+}
+
 bool MemRead(duint BaseAddress, void* Buffer, duint Size, duint* NumberOfBytesRead, bool cache)
 {
     if(!MemIsCanonicalAddress(BaseAddress) || !DbgIsDebugging())
@@ -368,6 +742,20 @@ bool MemRead(duint BaseAddress, void* Buffer, duint Size, duint* NumberOfBytesRe
     duint sizeLeftInFirstPage = PAGE_SIZE - (BaseAddress & (PAGE_SIZE - 1));
     duint readSize = min(sizeLeftInFirstPage, requestedSize);
 
+    // Aggregate multi-page requests into large ReadProcessMemory calls instead
+    // of one syscall per page. Not done while the working-set probe is active
+    // (a bulk read would page the probed memory in behind it), and paused
+    // cache-sized reads keep going through the page cache per page.
+    bool bulkRead = requestedSize - readSize > PAGE_SIZE && !(bQueryWorkingSet && fnQueryWorkingSetEx());
+    if(bulkRead && bCacheMemoryReads && !dbgisrunning())
+        bulkRead = requestedSize >= 64 * PAGE_SIZE;
+
+    if(bulkRead)
+    {
+        *NumberOfBytesRead = MemReadBisect(BaseAddress, (unsigned char*)Buffer, Size);
+        readSize = 0;
+    }
+
     while(readSize)
     {
         SIZE_T bytesRead = 0;
@@ -385,10 +773,33 @@ bool MemRead(duint BaseAddress, void* Buffer, duint Size, duint* NumberOfBytesRe
     }
 
     auto success = *NumberOfBytesRead == Size;
+    if(success && trackReads)
+        trackedReads.emplace_back(BaseAddress, Size);
     SetLastError(success ? ERROR_SUCCESS : ERROR_PARTIAL_COPY);
     return success;
 }
 
+// Serve several reads in one bridge call. Failed ranges are zeroed and marked,
+// the remaining ranges are still attempted, so callers can batch reads of
+// which some may hit unreadable memory (see DBG_MEMREAD_SCATTER).
+bool MemReadScatter(MEMREADRANGE* Ranges, duint Count)
+{
+    if(!Ranges || !Count)
+        return false;
+
+    auto anySuccess = false;
+    for(duint i = 0; i < Count; i++)
+    {
+        auto & range = Ranges[i];
+        range.success = MemRead(range.addr, range.dest, range.size, nullptr, true);
+        if(range.success)
+            anySuccess = true;
+        else if(range.dest && range.size)
+            memset(range.dest, 0, range.size);
+    }
+    return anySuccess;
+}
+
 bool MemReadUnsafePage(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID lpBuffer, SIZE_T nSize, SIZE_T* lpNumberOfBytesRead)
 {
     //TODO: remove when proven stable, this function checks if reads are always within page boundaries
@@ -480,6 +891,13 @@ bool MemWrite(duint BaseAddress, const void* Buffer, duint Size, duint* NumberOf
             __debugbreak(); //TODO: remove when proven stable, this checks if (BaseAddress + offset) is aligned to PAGE_SIZE after the first call
     }
 
+    // Drop cached copies of the written range so subsequent reads see the new data
+    if(*NumberOfBytesWritten)
+    {
+        MemCacheInvalidate(BaseAddress, *NumberOfBytesWritten);
+        ExpressionFunctions::InvalidateStep(); //cached expression function results may depend on the old bytes
+    }
+
     auto success = *NumberOfBytesWritten == Size;
     SetLastError(success ? ERROR_SUCCESS : ERROR_PARTIAL_COPY);
     return success;
@@ -501,11 +919,25 @@ bool MemPatch(duint BaseAddress, const void* Buffer, duint Size, duint* NumberOf
         return false;
     }
 
-    // Are we able to write on this page?
-    if(MemWrite(BaseAddress, Buffer, Size, NumberOfBytesWritten))
+    // Are we able to write on this page? Freeze the target while the bytes
+    // land so no thread can execute a half-written sequence
+    bool success = false;
+    ThreadRunWithWorldStopped([&]()
+    {
+        success = MemWrite(BaseAddress, Buffer, Size, NumberOfBytesWritten);
+    });
+
+    if(success)
     {
-        for(duint i = 0; i < Size; i++)
-            PatchSet(BaseAddress + i, oldData()[i], ((const unsigned char*)Buffer)[i]);
+        // Record the whole range in one batch instead of one lock
+        // acquisition per byte
+        PatchSetRange(BaseAddress, oldData(), (const unsigned char*)Buffer, Size);
+
+        // One grouped undo transaction per edit (see PatchUndoEdit)
+        PatchJournalRecord(BaseAddress, oldData(), (const unsigned char*)Buffer, Size);
+
+        // The next analysis run only needs to revisit these bytes
+        AnalysisDirtyMark(BaseAddress, Size);
 
         // Done
         return true;
@@ -531,6 +963,18 @@ bool MemIsValidReadPtrUnsafe(duint Address, bool cache)
     return MemReadUnsafe(Address, &ch, sizeof(ch));
 }
 
+bool MemIsValidReadPtrFast(duint Address)
+{
+    auto ranges = std::atomic_load(&validReadRanges);
+    if(!ranges) //no snapshot published yet, fall back to the map
+        return MemIsValidReadPtr(Address, true);
+    auto found = std::lower_bound(ranges->begin(), ranges->end(), Address, [](const Range & range, duint address)
+    {
+        return range.second < address;
+    });
+    return found != ranges->end() && Address >= found->first;
+}
+
 bool MemIsCanonicalAddress(duint Address)
 {
 #ifndef _WIN64
@@ -558,12 +1002,18 @@ bool MemIsCodePage(duint Address, bool Refresh)
 
 duint MemAllocRemote(duint Address, duint Size, DWORD Type, DWORD Protect)
 {
-    return (duint)VirtualAllocEx(fdProcessInfo->hProcess, (LPVOID)Address, Size, Type, Protect);
+    auto base = (duint)VirtualAllocEx(fdProcessInfo->hProcess, (LPVOID)Address, Size, Type, Protect);
+    if(base)
+        MemUpdateMapDirty(base, Size);
+    return base;
 }
 
 bool MemFreeRemote(duint Address)
 {
-    return !!VirtualFreeEx(fdProcessInfo->hProcess, (LPVOID)Address, 0, MEM_RELEASE);
+    auto result = !!VirtualFreeEx(fdProcessInfo->hProcess, (LPVOID)Address, 0, MEM_RELEASE);
+    if(result)
+        MemUpdateMapDirty(Address, PAGE_SIZE);
+    return result;
 }
 
 bool MemGetPageInfo(duint Address, MEMPAGE* PageInfo, bool Refresh)
@@ -598,7 +1048,10 @@ bool MemSetPageRights(duint Address, const char* Rights)
         return false;
 
     DWORD oldProtect;
-    return !!VirtualProtectEx(fdProcessInfo->hProcess, (void*)Address, PAGE_SIZE, protect, &oldProtect);
+    auto result = !!VirtualProtectEx(fdProcessInfo->hProcess, (void*)Address, PAGE_SIZE, protect, &oldProtect);
+    if(result)
+        MemUpdateMapDirty(Address, PAGE_SIZE);
+    return result;
 }
 
 bool MemGetPageRights(duint Address, char* Rights)
@@ -721,17 +1174,103 @@ bool MemFindInPage(const SimplePage & page, duint startoffset, const std::vector
 
 bool MemFindInMap(const std::vector<SimplePage> & pages, const std::vector<PatternByte> & pattern, std::vector<duint> & results, duint maxresults, bool progress)
 {
-    duint count = 0;
     duint total = pages.size();
-    for(const auto page : pages)
+    if(total)
     {
-        if(!MemFindInPage(page, 0, pattern, results, maxresults))
-            continue;
-        if(progress)
-            GuiReferenceSetProgress(int(floor((float(count) / float(total)) * 100.0f)));
-        if(results.size() >= maxresults)
-            break;
-        count++;
+        // Scan the pages in parallel. The PPL scheduler steals work from a
+        // shared queue, so threads that land on small or unreadable pages pick
+        // up the remaining ones instead of idling.
+        std::vector<std::vector<duint>> pageResults(total);
+        std::atomic<duint> foundCount(results.size());
+        std::atomic<duint> finishedCount(0);
+        concurrency::parallel_for(duint(0), total, [&](duint i)
+        {
+            auto found = foundCount.load();
+            if(found < maxresults)
+            {
+                auto & pageFound = pageResults[i];
+                if(MemFindInPage(pages[i], 0, pattern, pageFound, maxresults - found))
+                    foundCount += pageFound.size();
+            }
+            auto finished = ++finishedCount;
+            if(progress)
+                GuiReferenceSetProgress(int(floor((float(finished) / float(total)) * 100.0f)));
+        });
+
+        // Merge in page order to keep the result order deterministic
+        for(const auto & pageFound : pageResults)
+        {
+            for(auto result : pageFound)
+            {
+                if(results.size() >= maxresults)
+                    break;
+                results.push_back(result);
+            }
+        }
+    }
+    if(progress)
+    {
+        GuiReferenceSetProgress(100);
+        GuiReferenceReloadData();
+    }
+    return true;
+}
+
+bool MemFindInMapMulti(const std::vector<SimplePage> & pages, const std::vector<std::vector<PatternByte>> & patterns, std::vector<std::vector<duint>> & results, duint maxresults, bool progress)
+{
+    results.assign(patterns.size(), std::vector<duint>());
+    duint total = pages.size();
+    if(total && !patterns.empty())
+    {
+        // Every page is read and scanned exactly once for all patterns, the
+        // per-pattern results are merged in page order afterwards
+        std::vector<std::vector<std::vector<size_t>>> pageResults(total);
+        std::vector<std::atomic<duint>> foundCounts(patterns.size());
+        for(auto & foundCount : foundCounts)
+            foundCount = 0;
+        std::atomic<duint> finishedCount(0);
+        concurrency::parallel_for(duint(0), total, [&](duint i)
+        {
+            bool allDone = true;
+            for(const auto & foundCount : foundCounts)
+            {
+                if(foundCount.load() < maxresults)
+                {
+                    allDone = false;
+                    break;
+                }
+            }
+            if(!allDone)
+            {
+                Memory<unsigned char*> data(pages[i].size);
+                if(MemRead(pages[i].address, data(), data.size()))
+                {
+                    patternfindall(data(), data.size(), patterns, pageResults[i], maxresults);
+                    for(size_t p = 0; p < patterns.size(); p++)
+                        foundCounts[p] += pageResults[i][p].size();
+                }
+            }
+            auto finished = ++finishedCount;
+            if(progress)
+                GuiReferenceSetProgress(int(floor((float(finished) / float(total)) * 100.0f)));
+        });
+
+        // Merge in page order to keep the result order deterministic
+        for(duint i = 0; i < total; i++)
+        {
+            if(pageResults[i].empty())
+                continue;
+            for(size_t p = 0; p < patterns.size(); p++)
+            {
+                auto & found = results[p];
+                for(auto offset : pageResults[i][p])
+                {
+                    if(found.size() >= maxresults)
+                        break;
+                    found.push_back(pages[i].address + offset);
+                }
+            }
+        }
     }
     if(progress)
     {
@@ -7,15 +7,18 @@
 struct SimplePage;
 void MemUpdateMap();
 void MemUpdateMapAsync();
+void MemUpdateMapDirty(duint Address, duint Size);
 duint MemFindBaseAddr(duint Address, duint* Size = nullptr, bool Refresh = false, bool FindReserved = false);
 bool MemoryReadSafePage(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID lpBuffer, SIZE_T nSize, SIZE_T* lpNumberOfBytesRead);
 bool MemRead(duint BaseAddress, void* Buffer, duint Size, duint* NumberOfBytesRead = nullptr, bool cache = false);
+bool MemReadScatter(MEMREADRANGE* Ranges, duint Count);
 bool MemReadUnsafePage(HANDLE hProcess, LPVOID lpBaseAddress, LPVOID lpBuffer, SIZE_T nSize, SIZE_T* lpNumberOfBytesRead);
 bool MemReadUnsafe(duint BaseAddress, void* Buffer, duint Size, duint* NumberOfBytesRead = nullptr);
 bool MemWrite(duint BaseAddress, const void* Buffer, duint Size, duint* NumberOfBytesWritten = nullptr);
 bool MemPatch(duint BaseAddress, const void* Buffer, duint Size, duint* NumberOfBytesWritten = nullptr);
 bool MemIsValidReadPtr(duint Address, bool cache = false);
 bool MemIsValidReadPtrUnsafe(duint Address, bool cache = false);
+bool MemIsValidReadPtrFast(duint Address); //lock-free snapshot lookup, for per-cell styling queries
 bool MemIsCanonicalAddress(duint Address);
 bool MemIsCodePage(duint Address, bool Refresh);
 duint MemAllocRemote(duint Address, duint Size, DWORD Type = MEM_RESERVE | MEM_COMMIT, DWORD Protect = PAGE_EXECUTE_READWRITE);
@@ -27,15 +30,22 @@ bool MemPageRightsToString(DWORD Protect, char* Rights);
 bool MemPageRightsFromString(DWORD* Protect, const char* Rights);
 bool MemFindInPage(const SimplePage & page, duint startoffset, const std::vector<PatternByte> & pattern, std::vector<duint> & results, duint maxresults);
 bool MemFindInMap(const std::vector<SimplePage> & pages, const std::vector<PatternByte> & pattern, std::vector<duint> & results, duint maxresults, bool progress = true);
+bool MemFindInMapMulti(const std::vector<SimplePage> & pages, const std::vector<std::vector<PatternByte>> & patterns, std::vector<std::vector<duint>> & results, duint maxresults, bool progress = true);
 bool MemDecodePointer(duint* Pointer, bool vistaPlus);
 void MemInitRemoteProcessCookie(ULONG cookie);
 bool MemReadDumb(duint BaseAddress, void* Buffer, duint Size);
+void MemCacheFlush();
+void MemCacheInvalidate(duint BaseAddress, duint Size);
+duint MemCacheGeneration();
+void MemReadTrackStart();
+std::vector<std::pair<duint, duint>> MemReadTrackStop();
 
 #include "addrinfo.h"
 
 extern std::map<Range, MEMPAGE, RangeCompare> memoryPages;
 extern bool bListAllPages;
 extern bool bQueryWorkingSet;
+extern bool bCacheMemoryReads;
 extern DWORD memMapThreadCounter;
 
 struct SimplePage
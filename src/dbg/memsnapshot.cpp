@@ -0,0 +1,271 @@
+/**
+ @file memsnapshot.cpp
+
+ @brief Implements the process memory snapshot engine.
+*/
+
+#include "memsnapshot.h"
+#include "memory.h"
+#include "threading.h"
+#include "filehelper.h"
+#include "lz4/lz4.h"
+#include <algorithm>
+#include <mutex>
+
+struct SnapshotRegion
+{
+    duint address = 0;
+    duint size = 0;
+    std::vector<char> compressed; //emptied once decompressed
+    std::vector<unsigned char> data; //filled on first access
+};
+
+static std::vector<SnapshotRegion> snapshotRegions; //sorted by address
+static std::mutex snapshotMutex;
+
+struct SnapshotHeader
+{
+    char magic[8]; //"X64SNAP"
+    uint32 version;
+    uint32 regionCount;
+};
+
+struct SnapshotRegionHeader
+{
+    duint address;
+    duint size;
+    duint compressedSize;
+};
+
+static const char snapshotMagic[8] = "X64SNAP";
+static const uint32 snapshotVersion = 1;
+
+//Decompress a region in place; the compressed payload is dropped afterwards
+//so a region costs memory only once.
+static bool ensureDecompressed(SnapshotRegion & region)
+{
+    if(!region.data.empty() || !region.size)
+        return !region.data.empty();
+    std::vector<unsigned char> data(region.size);
+    if(LZ4_decompress_safe(region.compressed.data(), (char*)data.data(), int(region.compressed.size()), int(region.size)) != int(region.size))
+        return false;
+    region.data = std::move(data);
+    region.compressed.clear();
+    region.compressed.shrink_to_fit();
+    return true;
+}
+
+bool MemSnapshotCapture(const char* FilePath)
+{
+    //snapshot the committed pages (same filter as the pointer scanner)
+    std::vector<SimplePage> pages;
+    SHARED_ACQUIRE(LockMemoryPages);
+    for(auto & itr : memoryPages)
+    {
+        const auto & mbi = itr.second.mbi;
+        if(mbi.State != MEM_COMMIT)
+            continue;
+        if(mbi.Protect & (PAGE_NOACCESS | PAGE_GUARD))
+            continue;
+        pages.push_back(SimplePage(duint(mbi.BaseAddress), mbi.RegionSize));
+    }
+    SHARED_RELEASE();
+    if(pages.empty())
+        return false;
+
+    std::vector<SnapshotRegion> regions;
+    regions.reserve(pages.size());
+    std::vector<char> file;
+    file.resize(sizeof(SnapshotHeader) + pages.size() * sizeof(SnapshotRegionHeader));
+    size_t regionTableOffset = sizeof(SnapshotHeader);
+
+    Memory<unsigned char*> buffer(0x1000, "MemSnapshotCapture:buffer");
+    for(const auto & page : pages)
+    {
+        if(buffer.size() < page.size)
+            buffer.realloc(page.size, "MemSnapshotCapture:buffer");
+        if(!MemReadDumb(page.address, buffer(), page.size))
+            continue; //the region went away between the map refresh and now
+
+        SnapshotRegion region;
+        region.address = page.address;
+        region.size = page.size;
+        region.compressed.resize(LZ4_compressBound(int(page.size)));
+        auto compressedSize = LZ4_compress((const char*)buffer(), region.compressed.data(), int(page.size));
+        if(compressedSize <= 0)
+            continue;
+        region.compressed.resize(compressedSize);
+
+        SnapshotRegionHeader header;
+        header.address = region.address;
+        header.size = region.size;
+        header.compressedSize = region.compressed.size();
+        memcpy(file.data() + regionTableOffset, &header, sizeof(header));
+        regionTableOffset += sizeof(header);
+        file.insert(file.end(), region.compressed.begin(), region.compressed.end());
+        regions.push_back(std::move(region));
+    }
+    if(regions.empty())
+        return false;
+
+    SnapshotHeader header;
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = snapshotVersion;
+    header.regionCount = uint32(regions.size());
+    memcpy(file.data(), &header, sizeof(header));
+
+    //an unused slice of the region table remains when regions failed to read;
+    //compact the table so the payload offset matches the header count
+    auto tableEnd = sizeof(SnapshotHeader) + regions.size() * sizeof(SnapshotRegionHeader);
+    auto tableReserved = sizeof(SnapshotHeader) + pages.size() * sizeof(SnapshotRegionHeader);
+    if(tableEnd != tableReserved)
+        file.erase(file.begin() + tableEnd, file.begin() + tableReserved);
+
+    if(!FileHelper::WriteAllData(FilePath, file.data(), file.size()))
+        return false;
+
+    //keep the captured regions as the loaded snapshot so inspection can start
+    //right away without re-reading the file
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshotRegions = std::move(regions);
+    return true;
+}
+
+bool MemSnapshotLoad(const char* FilePath)
+{
+    std::vector<unsigned char> file;
+    if(!FileHelper::ReadAllData(FilePath, file))
+        return false;
+    if(file.size() < sizeof(SnapshotHeader))
+        return false;
+    SnapshotHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if(memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0 || header.version != snapshotVersion)
+        return false;
+
+    size_t tableOffset = sizeof(SnapshotHeader);
+    size_t dataOffset = tableOffset + header.regionCount * sizeof(SnapshotRegionHeader);
+    if(dataOffset > file.size())
+        return false;
+
+    std::vector<SnapshotRegion> regions;
+    regions.reserve(header.regionCount);
+    for(uint32 i = 0; i < header.regionCount; i++)
+    {
+        SnapshotRegionHeader regionHeader;
+        memcpy(&regionHeader, file.data() + tableOffset + i * sizeof(regionHeader), sizeof(regionHeader));
+        if(dataOffset + regionHeader.compressedSize > file.size())
+            return false;
+        SnapshotRegion region;
+        region.address = regionHeader.address;
+        region.size = regionHeader.size;
+        region.compressed.assign((const char*)file.data() + dataOffset, (const char*)file.data() + dataOffset + regionHeader.compressedSize);
+        dataOffset += regionHeader.compressedSize;
+        regions.push_back(std::move(region));
+    }
+    std::sort(regions.begin(), regions.end(), [](const SnapshotRegion & a, const SnapshotRegion & b)
+    {
+        return a.address < b.address;
+    });
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshotRegions = std::move(regions);
+    return true;
+}
+
+void MemSnapshotClear()
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshotRegions.clear();
+    snapshotRegions.shrink_to_fit();
+}
+
+bool MemSnapshotIsLoaded()
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return !snapshotRegions.empty();
+}
+
+static SnapshotRegion* findRegion(duint Address)
+{
+    auto itr = std::upper_bound(snapshotRegions.begin(), snapshotRegions.end(), Address, [](duint address, const SnapshotRegion & region)
+    {
+        return address < region.address;
+    });
+    if(itr == snapshotRegions.begin())
+        return nullptr;
+    --itr;
+    if(Address >= itr->address && Address < itr->address + itr->size)
+        return &*itr;
+    return nullptr;
+}
+
+bool MemSnapshotRead(duint Address, void* Buffer, duint Size)
+{
+    if(!Size)
+        return false;
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    auto dest = (unsigned char*)Buffer;
+    while(Size)
+    {
+        auto region = findRegion(Address);
+        if(!region || !ensureDecompressed(*region))
+            return false;
+        auto offset = Address - region->address;
+        auto chunk = std::min(Size, region->size - offset);
+        memcpy(dest, region->data.data() + offset, chunk);
+        dest += chunk;
+        Address += chunk;
+        Size -= chunk;
+    }
+    return true;
+}
+
+bool MemSnapshotDiff(duint Address, duint Size, std::vector<std::pair<duint, duint>> & Ranges)
+{
+    Ranges.clear();
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if(snapshotRegions.empty())
+        return false;
+
+    Memory<unsigned char*> live(0x1000, "MemSnapshotDiff:live");
+    for(auto & region : snapshotRegions)
+    {
+        //clip the region against the requested window (Size 0 = everything)
+        auto start = region.address;
+        auto end = region.address + region.size;
+        if(Size)
+        {
+            start = std::max(start, Address);
+            end = std::min(end, Address + Size);
+            if(start >= end)
+                continue;
+        }
+        if(!ensureDecompressed(region))
+            continue;
+
+        auto length = end - start;
+        if(live.size() < length)
+            live.realloc(length, "MemSnapshotDiff:live");
+        if(!MemReadDumb(start, live(), length))
+        {
+            Ranges.emplace_back(start, length); //the whole region went away
+            continue;
+        }
+
+        const auto snapshot = region.data.data() + (start - region.address);
+        for(duint i = 0; i < length;)
+        {
+            if(snapshot[i] == live()[i])
+            {
+                i++;
+                continue;
+            }
+            auto runStart = i;
+            while(i < length && snapshot[i] != live()[i])
+                i++;
+            Ranges.emplace_back(start + runStart, i - runStart);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef _MEMSNAPSHOT_H
+#define _MEMSNAPSHOT_H
+
+#include "_global.h"
+
+//A snapshot captures the committed memory of the debuggee into an
+//LZ4-compressed file so it can be inspected after the target runs free.
+//Loaded snapshots keep the compressed regions in memory and decompress a
+//region on first access.
+bool MemSnapshotCapture(const char* FilePath);
+bool MemSnapshotLoad(const char* FilePath);
+void MemSnapshotClear();
+bool MemSnapshotIsLoaded();
+
+//Read Size bytes at Address from the loaded snapshot (no partial reads).
+bool MemSnapshotRead(duint Address, void* Buffer, duint Size);
+
+//Compare the loaded snapshot against live memory and collect the differing
+//ranges (address + size). Regions that can no longer be read count as one
+//whole-region difference. Returns false when no snapshot is loaded.
+bool MemSnapshotDiff(duint Address, duint Size, std::vector<std::pair<duint, duint>> & Ranges);
+
+#endif // _MEMSNAPSHOT_H
@@ -0,0 +1,100 @@
+/**
+ @file memwatch.cpp
+
+ @brief Implements change detection for watched memory ranges.
+*/
+
+#include "memwatch.h"
+#include "memory.h"
+#include <map>
+#include <mutex>
+
+struct WatchedRange
+{
+    std::vector<unsigned char> snapshot; //bytes at the last poll
+    unsigned int refCount = 0;
+    bool valid = false; //the last read succeeded
+    bool dirty = false; //the bytes changed at the last poll
+};
+
+typedef std::pair<duint, duint> RangeKey; //address, size
+
+static std::map<RangeKey, WatchedRange> watchedRanges;
+static std::map<unsigned int, RangeKey> watchedIds;
+static unsigned int watchedIdCounter = 1;
+static std::mutex watchedMutex;
+
+unsigned int MemWatchRegister(duint Address, duint Size)
+{
+    if(!Size)
+        return 0;
+    std::lock_guard<std::mutex> lock(watchedMutex);
+    auto & range = watchedRanges[RangeKey(Address, Size)];
+    if(!range.refCount++)
+    {
+        range.snapshot.resize(Size);
+        range.valid = MemReadDumb(Address, range.snapshot.data(), Size);
+        range.dirty = false;
+    }
+    auto id = watchedIdCounter++;
+    if(!id) //the counter wrapped, 0 means invalid
+        id = watchedIdCounter++;
+    watchedIds.emplace(id, RangeKey(Address, Size));
+    return id;
+}
+
+void MemWatchUnregister(unsigned int Id)
+{
+    std::lock_guard<std::mutex> lock(watchedMutex);
+    auto idItr = watchedIds.find(Id);
+    if(idItr == watchedIds.end())
+        return;
+    auto rangeItr = watchedRanges.find(idItr->second);
+    if(rangeItr != watchedRanges.end() && !--rangeItr->second.refCount)
+        watchedRanges.erase(rangeItr);
+    watchedIds.erase(idItr);
+}
+
+void MemWatchPoll()
+{
+    std::lock_guard<std::mutex> lock(watchedMutex);
+    std::vector<unsigned char> current;
+    for(auto & itr : watchedRanges)
+    {
+        auto & range = itr.second;
+        current.resize(itr.first.second);
+        if(!MemReadDumb(itr.first.first, current.data(), current.size()))
+        {
+            //a range that was readable before and went away counts as changed
+            range.dirty = range.valid;
+            range.valid = false;
+            continue;
+        }
+        if(!range.valid || memcmp(range.snapshot.data(), current.data(), current.size()) != 0)
+        {
+            range.snapshot = current;
+            range.valid = true;
+            range.dirty = true;
+        }
+        else
+            range.dirty = false;
+    }
+}
+
+bool MemWatchIsDirty(unsigned int Id)
+{
+    std::lock_guard<std::mutex> lock(watchedMutex);
+    auto idItr = watchedIds.find(Id);
+    if(idItr == watchedIds.end())
+        return false;
+    auto rangeItr = watchedRanges.find(idItr->second);
+    return rangeItr != watchedRanges.end() && rangeItr->second.dirty;
+}
+
+void MemWatchClear()
+{
+    std::lock_guard<std::mutex> lock(watchedMutex);
+    watchedRanges.clear();
+    watchedIds.clear();
+    watchedIdCounter = 1;
+}
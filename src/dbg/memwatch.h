@@ -0,0 +1,19 @@
+#ifndef _MEMWATCH_H
+#define _MEMWATCH_H
+
+#include "_global.h"
+
+//Change detection for ranges of target memory. Consumers register the ranges
+//they depend on; MemWatchPoll re-reads every distinct range once per debug
+//event and marks the ones whose bytes actually changed, so consumers can skip
+//work instead of polling the memory themselves. GetWriteWatch only covers
+//MEM_WRITE_WATCH allocations made by the owning process, so a byte-level
+//snapshot comparison is the closest we can get for arbitrary debuggee pages.
+//Identical ranges share one snapshot and are read once per poll.
+unsigned int MemWatchRegister(duint Address, duint Size);
+void MemWatchUnregister(unsigned int Id);
+void MemWatchPoll();
+bool MemWatchIsDirty(unsigned int Id);
+void MemWatchClear();
+
+#endif // _MEMWATCH_H
@@ -1,15 +1,226 @@
 #include "mnemonichelp.h"
+#include "console.h"
 #include "threading.h"
 #include <atomic>
+#include <algorithm>
 #include "jansson/jansson_x64dbg.h"
 #include "debugger.h"
 #include "filehelper.h"
+#include "filemap.h"
+#include "murmurhash.h"
 
 static std::unordered_map<String, String> MnemonicMap;
 static std::unordered_map<String, String> MnemonicBriefMap;
 static std::atomic<bool> isMnemonicLoaded(false);
 static bool loadFromText();
 
+// On first use mnemdb.json is compiled into an indexed blob next to the
+// databases and memory-mapped on subsequent runs, so the first hover over an
+// instruction costs a binary search over mapped pages instead of parsing a
+// multi-megabyte JSON document into in-memory maps. The blob is recompiled
+// whenever mnemdb.json changes; the parsed maps remain as a fallback when the
+// index cannot be written (e.g. read-only install directory).
+static const unsigned int MnemDbVersion = 1;
+
+#pragma pack(push, 1)
+struct MnemDbHeader
+{
+    char magic[4]; // "MNH1"
+    unsigned int version; // MnemDbVersion, bump when the serialized layout changes
+    unsigned int descriptionCount; // records in the full description table
+    unsigned int briefCount; // records in the brief description table
+    unsigned int poolSize; // string pool bytes following the record tables
+    unsigned long long sourceSize; // mnemdb.json size when the index was compiled
+    unsigned long long sourceWriteTime; // mnemdb.json FILETIME when the index was compiled
+};
+
+// Fixed-size record sorted by hash, so a lookup is a binary search over the
+// mapped tables without touching the string pool until a hash matches
+struct MnemDbRecord
+{
+    unsigned int hash; // MurmurHash3_x86_32 of the mnemonic
+    unsigned int mnemOffset; // string pool offset of the mnemonic (collision check)
+    unsigned int mnemLength;
+    unsigned int descOffset; // string pool offset of the description
+    unsigned int descLength;
+};
+#pragma pack(pop)
+
+static const char mnemDbMagic[4] = { 'M', 'N', 'H', '1' };
+
+static FileMap<char> mnemDbMap;
+static const MnemDbRecord* mnemDbDescriptions = nullptr;
+static const MnemDbRecord* mnemDbBriefs = nullptr;
+static size_t mnemDbDescriptionCount = 0;
+static size_t mnemDbBriefCount = 0;
+static const char* mnemDbPool = nullptr;
+static size_t mnemDbPoolSize = 0;
+
+static unsigned int mnemDbHash(const String & mnem)
+{
+    // 32 bits regardless of architecture, so x32 and x64 share the same layout
+    unsigned int hash;
+    MurmurHash3_x86_32(mnem.c_str(), int(mnem.length()), 0x1337, &hash);
+    return hash;
+}
+
+static String mnemDbSourcePath()
+{
+    return StringUtils::sprintf("%s\\..\\mnemdb.json", szProgramDir);
+}
+
+static WString mnemDbIndexPath(bool createDirectory)
+{
+    auto dir = StringUtils::sprintf("%s\\db", szProgramDir);
+    if(createDirectory)
+        CreateDirectoryW(StringUtils::Utf8ToUtf16(dir).c_str(), nullptr);
+    return StringUtils::Utf8ToUtf16(StringUtils::sprintf("%s\\mnemdb.cache", dir.c_str()));
+}
+
+static bool mnemDbSourceInfo(unsigned long long & size, unsigned long long & lastWriteTime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attrib;
+    if(!GetFileAttributesExW(StringUtils::Utf8ToUtf16(mnemDbSourcePath()).c_str(), GetFileExInfoStandard, &attrib))
+        return false;
+    size = (unsigned long long)attrib.nFileSizeHigh << 32 | attrib.nFileSizeLow;
+    lastWriteTime = (unsigned long long)attrib.ftLastWriteTime.dwHighDateTime << 32 | attrib.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
+static bool mnemDbMapIndex(unsigned long long sourceSize, unsigned long long sourceWriteTime)
+{
+    auto invalid = []()
+    {
+        mnemDbMap.Unmap();
+        mnemDbDescriptions = nullptr;
+        mnemDbBriefs = nullptr;
+        mnemDbDescriptionCount = 0;
+        mnemDbBriefCount = 0;
+        mnemDbPool = nullptr;
+        mnemDbPoolSize = 0;
+        return false;
+    };
+    if(!mnemDbMap.Map(mnemDbIndexPath(false).c_str()))
+        return invalid();
+    auto data = mnemDbMap.Data();
+    auto size = mnemDbMap.Size();
+    if(size < sizeof(MnemDbHeader))
+        return invalid();
+    auto header = (const MnemDbHeader*)data;
+    if(memcmp(header->magic, mnemDbMagic, sizeof(mnemDbMagic)) != 0 || header->version != MnemDbVersion)
+        return invalid();
+    if(header->sourceSize != sourceSize || header->sourceWriteTime != sourceWriteTime) //mnemdb.json changed, recompile
+        return invalid();
+    auto tableBytes = (unsigned long long)(header->descriptionCount + header->briefCount) * sizeof(MnemDbRecord);
+    if(sizeof(MnemDbHeader) + tableBytes + header->poolSize != size)
+        return invalid();
+    mnemDbDescriptions = (const MnemDbRecord*)(data + sizeof(MnemDbHeader));
+    mnemDbBriefs = mnemDbDescriptions + header->descriptionCount;
+    mnemDbDescriptionCount = header->descriptionCount;
+    mnemDbBriefCount = header->briefCount;
+    mnemDbPool = (const char*)(mnemDbBriefs + header->briefCount);
+    mnemDbPoolSize = header->poolSize;
+    // Reject corrupt offsets up front so lookups can copy strings unchecked
+    for(size_t i = 0; i < mnemDbDescriptionCount + mnemDbBriefCount; i++)
+    {
+        const auto & record = mnemDbDescriptions[i];
+        if((unsigned long long)record.mnemOffset + record.mnemLength > mnemDbPoolSize ||
+                (unsigned long long)record.descOffset + record.descLength > mnemDbPoolSize)
+            return invalid();
+    }
+    return true;
+}
+
+static void mnemDbBuildTable(const std::unordered_map<String, String> & map, String & pool, std::vector<MnemDbRecord> & records)
+{
+    records.reserve(map.size());
+    for(const auto & entry : map)
+    {
+        MnemDbRecord record;
+        record.hash = mnemDbHash(entry.first);
+        record.mnemOffset = (unsigned int)pool.size();
+        record.mnemLength = (unsigned int)entry.first.size();
+        pool += entry.first;
+        record.descOffset = (unsigned int)pool.size();
+        record.descLength = (unsigned int)entry.second.size();
+        pool += entry.second;
+        records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(), [](const MnemDbRecord & a, const MnemDbRecord & b)
+    {
+        return a.hash < b.hash;
+    });
+}
+
+static bool mnemDbCompile(unsigned long long sourceSize, unsigned long long sourceWriteTime)
+{
+    String pool;
+    std::vector<MnemDbRecord> descriptions;
+    std::vector<MnemDbRecord> briefs;
+    mnemDbBuildTable(MnemonicMap, pool, descriptions);
+    mnemDbBuildTable(MnemonicBriefMap, pool, briefs);
+
+    auto indexPath = mnemDbIndexPath(true);
+    auto hFile = CreateFileW(indexPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, 0, nullptr);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    bool success;
+    {
+        BufferedWriter out(hFile); //closes the handle on destruction
+        MnemDbHeader header;
+        memcpy(header.magic, mnemDbMagic, sizeof(mnemDbMagic));
+        header.version = MnemDbVersion;
+        header.descriptionCount = (unsigned int)descriptions.size();
+        header.briefCount = (unsigned int)briefs.size();
+        header.poolSize = (unsigned int)pool.size();
+        header.sourceSize = sourceSize;
+        header.sourceWriteTime = sourceWriteTime;
+        success = out.Write(&header, sizeof(header))
+                  && out.Write(descriptions.data(), descriptions.size() * sizeof(MnemDbRecord))
+                  && out.Write(briefs.data(), briefs.size() * sizeof(MnemDbRecord))
+                  && out.Write(pool.data(), pool.size());
+    }
+
+    if(!success)
+        DeleteFileW(indexPath.c_str());
+    return success;
+}
+
+static const MnemDbRecord* mnemDbFind(const MnemDbRecord* table, size_t count, const String & mnem)
+{
+    auto hash = mnemDbHash(mnem);
+    auto end = table + count;
+    auto it = std::lower_bound(table, end, hash, [](const MnemDbRecord & record, unsigned int hash)
+    {
+        return record.hash < hash;
+    });
+    for(; it != end && it->hash == hash; ++it)
+    {
+        if(it->mnemLength == mnem.length() && memcmp(mnemDbPool + it->mnemOffset, mnem.c_str(), it->mnemLength) == 0)
+            return it;
+    }
+    return nullptr;
+}
+
+static bool mnemDbGet(bool brief, const String & mnem, String & description)
+{
+    if(mnemDbPool) //serve from the mapped index
+    {
+        auto record = mnemDbFind(brief ? mnemDbBriefs : mnemDbDescriptions, brief ? mnemDbBriefCount : mnemDbDescriptionCount, mnem);
+        if(!record)
+            return false;
+        description.assign(mnemDbPool + record->descOffset, record->descLength);
+        return true;
+    }
+    const auto & map = brief ? MnemonicBriefMap : MnemonicMap;
+    auto found = map.find(mnem);
+    if(found == map.end())
+        return false;
+    description = found->second;
+    return true;
+}
+
 static inline void loadMnemonicHelp()
 {
     if(isMnemonicLoaded.load())
@@ -25,8 +236,13 @@ static bool loadFromText()
     if(isMnemonicLoaded.load())
         return true;
     isMnemonicLoaded.store(true); //Don't retry failed load(and spam log).
+    unsigned long long sourceSize = 0;
+    unsigned long long sourceWriteTime = 0;
+    auto haveSourceInfo = mnemDbSourceInfo(sourceSize, sourceWriteTime);
+    if(haveSourceInfo && mnemDbMapIndex(sourceSize, sourceWriteTime))
+        return true; //serve lookups straight from the mapped index, no JSON parsing
     String json;
-    if(!FileHelper::ReadAllText(StringUtils::sprintf("%s\\..\\mnemdb.json", szProgramDir), json))
+    if(!FileHelper::ReadAllText(mnemDbSourcePath(), json))
     {
         dputs(QT_TRANSLATE_NOOP("DBG", "Failed to read mnemonic help database..."));
         return false;
@@ -77,6 +293,13 @@ static bool loadFromText()
         dputs(QT_TRANSLATE_NOOP("DBG", "Failed to load mnemonic help database..."));
         return false;
     }
+    // Compile the parsed maps into the indexed blob for the next run and drop
+    // them once the freshly written index maps back in
+    if(haveSourceInfo && mnemDbCompile(sourceSize, sourceWriteTime) && mnemDbMapIndex(sourceSize, sourceWriteTime))
+    {
+        MnemonicMap.clear();
+        MnemonicBriefMap.clear();
+    }
     dputs(QT_TRANSLATE_NOOP("DBG", "Mnemonic help database loaded!"));
     return true;
 }
@@ -110,25 +333,23 @@ String MnemonicHelp::getUniversalMnemonic(const String & mnem)
 String MnemonicHelp::getDescription(const char* mnem, int depth)
 {
     if(mnem == nullptr)
-        return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid mnemonic!"));
+        return dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid mnemonic!"));
     if(depth == 10)
-        return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Too many redirections..."));
+        return dtranslate(QT_TRANSLATE_NOOP("DBG", "Too many redirections..."));
     loadMnemonicHelp();
     SHARED_ACQUIRE(LockMnemonicHelp);
     auto mnemuni = getUniversalMnemonic(mnem);
-    auto found = MnemonicMap.find(mnemuni);
-    if(found == MnemonicMap.end())
+    String description;
+    if(!mnemDbGet(false, mnemuni, description))
     {
         if(mnemuni[0] == 'v') //v/vm
         {
-            found = MnemonicMap.find(mnemuni.c_str() + 1);
-            if(found == MnemonicMap.end())
+            if(!mnemDbGet(false, mnemuni.substr(1), description))
                 return "";
         }
         else
             return "";
     }
-    const auto & description = found->second;
     if(StringUtils::StartsWith(description, "-R:")) //redirect
         return getDescription(description.c_str() + 3, depth + 1);
     return description;
@@ -137,26 +358,25 @@ String MnemonicHelp::getDescription(const char* mnem, int depth)
 String MnemonicHelp::getBriefDescription(const char* mnem)
 {
     if(mnem == nullptr)
-        return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Invalid mnemonic!"));
+        return dtranslate(QT_TRANSLATE_NOOP("DBG", "Invalid mnemonic!"));
     loadMnemonicHelp();
     SHARED_ACQUIRE(LockMnemonicHelp);
     auto mnemLower = StringUtils::ToLower(mnem);
     if(mnemLower == "???")
-        return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "invalid instruction"));
-    auto found = MnemonicBriefMap.find(mnemLower);
-    if(found == MnemonicBriefMap.end())
+        return dtranslate(QT_TRANSLATE_NOOP("DBG", "invalid instruction"));
+    String brief;
+    if(!mnemDbGet(true, mnemLower, brief))
     {
         if(mnemLower[0] == 'v') //v/vm
         {
-            found = MnemonicBriefMap.find(mnemLower.c_str() + 1);
-            if(found != MnemonicBriefMap.end())
+            if(mnemDbGet(true, mnemLower.substr(1), brief))
             {
                 if(mnemLower.length() > 1 && mnemLower[1] == 'm') //vm
-                    return "vm " + found->second;
-                return "vector " + found->second;
+                    return "vm " + brief;
+                return "vector " + brief;
             }
         }
         return "";
     }
-    return found->second;
+    return brief;
 }
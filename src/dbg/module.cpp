@@ -13,10 +13,108 @@
 #include "debugger.h"
 #include <memory>
 #include "symbolundecorator.h"
+#include "expressionfunctions.h"
+#include "value.h"
+#include "modulecache.h"
+#include "function.h"
+#include "xrefs.h"
+#include "encodemap.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
 
 std::map<Range, std::unique_ptr<MODINFO>, RangeCompare> modinfo;
 std::unordered_map<duint, std::string> hashNameMap;
 
+// Immutable snapshot of the module ranges and names, swapped out atomically
+// whenever the module list changes. The GUI formats tens of thousands of
+// addresses per repaint through ModNameFromAddr/ModBaseFromAddr and taking
+// the modules lock plus a range-map lookup for each of them is measurable,
+// so those read from the snapshot without locks instead.
+struct ModSnapshotEntry
+{
+    duint base;
+    duint end; //last address of the module (inclusive)
+    duint entry; //entry point
+    duint hash; //full module name hash
+    MODULEPARTY party;
+    char name[MAX_MODULE_SIZE]; //name (without extension)
+    char extension[MAX_MODULE_SIZE]; //extension (including the dot)
+};
+
+static std::shared_ptr<const std::vector<ModSnapshotEntry>> modSnapshot = std::make_shared<const std::vector<ModSnapshotEntry>>();
+static std::atomic<uint32_t> modSnapshotEpoch;
+
+// User overrides of the party classification, keyed by the module name hash
+// so they follow the module across sessions and base address changes. The
+// table is persisted with the database.
+struct MODPARTYOVERRIDE
+{
+    String module; //module name with extension, used for persistence
+    MODULEPARTY party;
+};
+static std::unordered_map<duint, MODPARTYOVERRIDE> modPartyOverrides; //guarded by LockModules
+static std::map<String, duint> moduleContentHashes; //module name -> content hash from the previous session, guarded by LockModules
+
+// Rebuild the lock-free snapshot from modinfo (caller holds LockModules)
+static void ModSnapshotRebuild()
+{
+    auto snapshot = std::make_shared<std::vector<ModSnapshotEntry>>();
+    snapshot->reserve(modinfo.size());
+    for(const auto & i : modinfo)
+    {
+        ModSnapshotEntry entry;
+        entry.base = i.second->base;
+        entry.end = i.first.second;
+        entry.entry = i.second->entry;
+        entry.hash = i.second->hash;
+        entry.party = i.second->party;
+        strcpy_s(entry.name, i.second->name);
+        strcpy_s(entry.extension, i.second->extension);
+        snapshot->push_back(entry);
+    }
+    std::atomic_store(&modSnapshot, std::shared_ptr<const std::vector<ModSnapshotEntry>>(std::move(snapshot)));
+    // Published after the snapshot so a reader that sees the new epoch also
+    // sees (at least) the matching snapshot
+    modSnapshotEpoch++;
+}
+
+// Find the snapshot entry containing Address without taking LockModules.
+// Consecutive lookups overwhelmingly hit the same module, so each thread
+// keeps the snapshot it last used and the entry it last found. The returned
+// pointer stays valid until the calling thread does another lookup.
+static const ModSnapshotEntry* ModSnapshotFromAddr(duint Address)
+{
+    static thread_local std::shared_ptr<const std::vector<ModSnapshotEntry>> snapshot;
+    static thread_local uint32_t snapshotEpoch = 0;
+    static thread_local const ModSnapshotEntry* lastHit = nullptr;
+
+    auto epoch = modSnapshotEpoch.load();
+    if(!snapshot || epoch != snapshotEpoch)
+    {
+        snapshot = std::atomic_load(&modSnapshot);
+        snapshotEpoch = epoch;
+        lastHit = nullptr;
+    }
+
+    if(lastHit && Address >= lastHit->base && Address <= lastHit->end)
+        return lastHit;
+
+    auto found = std::upper_bound(snapshot->begin(), snapshot->end(), Address, [](duint addr, const ModSnapshotEntry & entry)
+    {
+        return addr < entry.base;
+    });
+    if(found == snapshot->begin())
+        return nullptr;
+    --found;
+    if(Address > found->end)
+        return nullptr;
+    lastHit = &*found;
+    return lastHit;
+}
+
 // RtlImageNtHeaderEx is much better than the non-Ex version due to stricter validation, but isn't available on XP x86.
 // This is essentially a fallback replacement that does the same thing
 static NTSTATUS ImageNtHeaders(duint base, duint size, PIMAGE_NT_HEADERS* outHeaders)
@@ -677,13 +775,13 @@ static bool GetUnsafeModuleInfoImpl(MODINFO & Info, ULONG_PTR FileMapVA, void(*f
     return true;
 }
 
-void GetModuleInfo(MODINFO & Info, ULONG_PTR FileMapVA)
+static bool GetModuleInfoHeader(MODINFO & Info, ULONG_PTR FileMapVA)
 {
     // Get the PE headers
     if(!NT_SUCCESS(ImageNtHeaders(FileMapVA, Info.loadedSize, &Info.headers)))
     {
         dprintf(QT_TRANSLATE_NOOP("DBG", "Module %s%s: invalid PE file!\n"), Info.name, Info.extension);
-        return;
+        return false;
     }
 
     // Get the entry point
@@ -734,6 +832,11 @@ void GetModuleInfo(MODINFO & Info, ULONG_PTR FileMapVA)
         ntSection++;
     }
 
+    return true;
+}
+
+static void GetModuleInfoDirectories(MODINFO & Info, ULONG_PTR FileMapVA)
+{
 #define GetUnsafeModuleInfo(func) GetUnsafeModuleInfoImpl(Info, FileMapVA, func, #func)
     if(!GetUnsafeModuleInfo(ReadExportDirectory))
     {
@@ -755,6 +858,164 @@ void GetModuleInfo(MODINFO & Info, ULONG_PTR FileMapVA)
     GetUnsafeModuleInfo(ReadExceptionDirectory);
 #endif // _WIN64
 #undef GetUnsafeModuleInfo
+
+    ModCacheSave(Info);
+}
+
+static void GetModuleInfo(MODINFO & Info, ULONG_PTR FileMapVA)
+{
+    if(!GetModuleInfoHeader(Info, FileMapVA))
+        return;
+
+    // The directory walks (and especially the name undecoration) are what
+    // makes attaching to a process with many modules slow, so their results
+    // are cached on disk keyed on the module path, size and timestamp
+    if(ModCacheLoad(Info))
+        return;
+
+    GetModuleInfoDirectories(Info, FileMapVA);
+}
+
+// Worker pool that parses the expensive module metadata (exports, imports,
+// relocations, PDB info) off the debug event thread. The debug thread only
+// parses the headers, sections and TLS callbacks (those are consumed right
+// after the load event to set TLS breakpoints) and resumes the debuggee; a
+// worker re-maps the file, runs the directory walks into a staging MODINFO
+// and publishes the results under a brief write lock.
+struct MODLOADJOB
+{
+    duint base = 0;
+    String path;
+    bool loadSymbols = false;
+    bool validateHash = false; //validate-only job, see ModHashValidateAsync
+};
+
+static std::mutex modLoadQueueMutex;
+static std::condition_variable modLoadQueueReady;
+static std::deque<MODLOADJOB> modLoadQueue;
+static bool modLoadWorkersStarted = false;
+
+static void ModLoadWorker()
+{
+    // The directory walks are a warm pass: nothing blocks on them (consumers
+    // see an empty result until the worker publishes), so run below normal
+    // priority to keep the debug event thread responsive while attaching to
+    // a DLL-heavy target loads dozens of modules at once.
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+    for(;;)
+    {
+        MODLOADJOB job;
+        {
+            std::unique_lock<std::mutex> lock(modLoadQueueMutex);
+            modLoadQueueReady.wait(lock, []()
+            {
+                return !modLoadQueue.empty();
+            });
+            job = std::move(modLoadQueue.front());
+            modLoadQueue.pop_front();
+        }
+
+        if(job.validateHash)
+        {
+            // Validate-only job: check the module content against the hash
+            // profile restored from the database (see ModHashValidateAsync)
+            ModHashValidate(job.base);
+            continue;
+        }
+
+        // Parse into a staging MODINFO with a private file mapping, so a
+        // module unload during the parse cannot pull the mapping out from
+        // under us. The staging base has to match the real base because the
+        // TLS callbacks and cache contents are stored as virtual addresses.
+        MODINFO staging;
+        staging.base = job.base;
+        strcpy_s(staging.path, job.path.c_str());
+
+        {
+            SHARED_ACQUIRE(LockModules);
+            auto info = ModInfoFromAddr(job.base);
+            if(!info || !info->metadataPending || _stricmp(info->path, job.path.c_str()) != 0)
+                continue; // the module was unloaded (and possibly replaced) in the meantime
+            strcpy_s(staging.name, info->name);
+            strcpy_s(staging.extension, info->extension);
+        }
+
+        auto wszPath = StringUtils::Utf8ToUtf16(job.path);
+        if(!StaticFileLoadW(wszPath.c_str(), UE_ACCESS_READ, false, &staging.fileHandle, &staging.loadedSize, &staging.fileMap, &staging.fileMapVA))
+            continue;
+
+        if(!GetModuleInfoHeader(staging, staging.fileMapVA))
+            continue;
+        if(!ModCacheLoad(staging))
+            GetModuleInfoDirectories(staging, staging.fileMapVA);
+
+        bool published = false;
+        {
+            EXCLUSIVE_ACQUIRE(LockModules);
+            auto info = ModInfoFromAddr(job.base);
+            if(info && info->metadataPending && _stricmp(info->path, job.path.c_str()) == 0)
+            {
+                // Moving the vectors only steals the buffers, so the name
+                // pointers in exportsByName stay valid. The headers and
+                // sections are deliberately not touched: they belong to the
+                // live module's own file mapping.
+                info->exportOrdinalBase = staging.exportOrdinalBase;
+                info->exports = std::move(staging.exports);
+                info->exportsByName = std::move(staging.exportsByName);
+                info->exportsByRva = std::move(staging.exportsByRva);
+                info->importModules = std::move(staging.importModules);
+                info->imports = std::move(staging.imports);
+                info->importsByRva = std::move(staging.importsByRva);
+                info->tlsCallbacks = std::move(staging.tlsCallbacks);
+                info->relocations = std::move(staging.relocations);
+#ifdef _WIN64
+                info->runtimeFunctions = std::move(staging.runtimeFunctions);
+#endif // _WIN64
+                info->pdbSignature = std::move(staging.pdbSignature);
+                info->pdbFile = std::move(staging.pdbFile);
+                info->pdbValidation = staging.pdbValidation;
+                info->pdbPaths = std::move(staging.pdbPaths);
+                info->metadataPending = false;
+                published = true;
+
+                // Attach symbols under the lock, like SymDownloadSymbol does
+                if(job.loadSymbols)
+                {
+                    for(const auto & pdbPath : info->pdbPaths)
+                    {
+                        if(info->loadSymbols(pdbPath, bForceLoadSymbols))
+                            break;
+                    }
+                }
+            }
+        }
+
+        if(published)
+            SymUpdateModuleList();
+    }
+}
+
+static void ModQueueJob(MODLOADJOB && job)
+{
+    std::unique_lock<std::mutex> lock(modLoadQueueMutex);
+    if(!modLoadWorkersStarted)
+    {
+        auto workerCount = std::max<size_t>(1, std::min<size_t>(4, std::thread::hardware_concurrency() / 2));
+        for(size_t i = 0; i < workerCount; i++)
+            std::thread(ModLoadWorker).detach();
+        modLoadWorkersStarted = true;
+    }
+    modLoadQueue.push_back(std::move(job));
+    modLoadQueueReady.notify_one();
+}
+
+static void ModQueueMetadataJob(duint Base, const char* FullPath, bool LoadSymbols)
+{
+    MODLOADJOB job;
+    job.base = Base;
+    job.path = FullPath;
+    job.loadSymbols = LoadSymbols;
+    ModQueueJob(std::move(job));
 }
 
 bool ModLoad(duint Base, duint Size, const char* FullPath, bool loadSymbols)
@@ -828,6 +1089,14 @@ bool ModLoad(duint Base, duint Size, const char* FullPath, bool loadSymbols)
         info.party = mod_user;
     }
 
+    // Apply the party the user assigned in a previous session
+    {
+        SHARED_ACQUIRE(LockModules);
+        auto partyOverride = modPartyOverrides.find(info.hash);
+        if(partyOverride != modPartyOverrides.end())
+            info.party = partyOverride->second.party;
+    }
+
     // Load module data
     bool virtualModule = strstr(FullPath, "virtual:\\") == FullPath;
 
@@ -838,7 +1107,16 @@ bool ModLoad(duint Base, duint Size, const char* FullPath, bool loadSymbols)
         // Load the physical module from disk
         if(StaticFileLoadW(wszFullPath.c_str(), UE_ACCESS_READ, false, &info.fileHandle, &info.loadedSize, &info.fileMap, &info.fileMapVA))
         {
-            GetModuleInfo(info, info.fileMapVA);
+            if(GetModuleInfoHeader(info, info.fileMapVA) && !ModCacheLoad(info))
+            {
+                // On a cache miss only the TLS callbacks are parsed here,
+                // because the debug loop consumes them right after the load
+                // event to set TLS breakpoints. The expensive directory
+                // walks are deferred to a worker thread so the debuggee can
+                // resume immediately.
+                GetUnsafeModuleInfoImpl(info, info.fileMapVA, ReadTlsCallbacks, "ReadTlsCallbacks");
+                info.metadataPending = true;
+            }
 
             Size = GetPE32DataFromMappedFile(info.fileMapVA, 0, UE_SIZEOFIMAGE);
             info.size = Size;
@@ -864,7 +1142,7 @@ bool ModLoad(duint Base, duint Size, const char* FullPath, bool loadSymbols)
 
     info.symbols = &EmptySymbolSource; // empty symbol source per default
 
-    if(loadSymbols)
+    if(loadSymbols && !info.metadataPending)
     {
         for(const auto & pdbPath : info.pdbPaths)
         {
@@ -876,8 +1154,16 @@ bool ModLoad(duint Base, duint Size, const char* FullPath, bool loadSymbols)
     // Add module to list
     EXCLUSIVE_ACQUIRE(LockModules);
     modinfo.insert(std::make_pair(Range(Base, Base + Size - 1), std::move(infoPtr)));
+    ModSnapshotRebuild();
     EXCLUSIVE_RELEASE();
 
+    ExpressionFunctions::InvalidateModule();
+    valnamecacheclear();
+
+    // Hand the deferred directory walks (and the symbol load) to the workers
+    if(info.metadataPending)
+        ModQueueMetadataJob(Base, FullPath, loadSymbols);
+
     // Put labels for virtual module exports
     if(virtualModule)
     {
@@ -906,8 +1192,12 @@ bool ModUnload(duint Base)
 
     // Remove it from the list
     modinfo.erase(found);
+    ModSnapshotRebuild();
     EXCLUSIVE_RELEASE();
 
+    ExpressionFunctions::InvalidateModule();
+    valnamecacheclear();
+
     // Update symbols
     SymUpdateModuleList();
     return true;
@@ -919,6 +1209,7 @@ void ModClear(bool updateGui)
         // Clean up all the modules
         EXCLUSIVE_ACQUIRE(LockModules);
         modinfo.clear();
+        ModSnapshotRebuild();
     }
 
     {
@@ -927,6 +1218,9 @@ void ModClear(bool updateGui)
         hashNameMap.clear();
     }
 
+    ExpressionFunctions::InvalidateModule();
+    valnamecacheclear();
+
     // Tell the symbol updater
     if(updateGui)
         GuiSymbolUpdateModuleList(0, nullptr);
@@ -949,10 +1243,9 @@ MODINFO* ModInfoFromAddr(duint Address)
 bool ModNameFromAddr(duint Address, char* Name, bool Extension)
 {
     ASSERT_NONNULL(Name);
-    SHARED_ACQUIRE(LockModules);
 
-    // Get a pointer to module information
-    auto module = ModInfoFromAddr(Address);
+    // Served from the lock-free snapshot, this is a render path hot spot
+    auto module = ModSnapshotFromAddr(Address);
 
     if(!module)
     {
@@ -971,9 +1264,8 @@ bool ModNameFromAddr(duint Address, char* Name, bool Extension)
 
 duint ModBaseFromAddr(duint Address)
 {
-    SHARED_ACQUIRE(LockModules);
-
-    auto module = ModInfoFromAddr(Address);
+    // Served from the lock-free snapshot, this is a render path hot spot
+    auto module = ModSnapshotFromAddr(Address);
 
     if(!module)
         return 0;
@@ -983,10 +1275,11 @@ duint ModBaseFromAddr(duint Address)
 
 duint ModHashFromAddr(duint Address)
 {
-    // Returns a unique hash from a virtual address
-    SHARED_ACQUIRE(LockModules);
-
-    auto module = ModInfoFromAddr(Address);
+    // Returns a unique hash from a virtual address. The name hash is computed
+    // once at module load and composed with the offset here, and the lookup
+    // is served from the lock-free snapshot because every label/comment/
+    // bookmark key goes through this function.
+    auto module = ModSnapshotFromAddr(Address);
 
     if(!module)
         return Address;
@@ -1016,6 +1309,16 @@ duint ModHashFromName(const char* Module)
     auto len = int(strlen(Module));
     if(!len)
         return 0;
+
+    // A database load resolves the same handful of module names millions of
+    // times while rebuilding the keys. The name hash is a pure function, so
+    // each thread memoizes it and skips the hashing and the name cache lock
+    // for names it has seen before.
+    static thread_local std::unordered_map<String, duint> hashMemo;
+    auto memoized = hashMemo.find(Module);
+    if(memoized != hashMemo.end())
+        return memoized->second;
+
     auto hash = murmurhash(Module, len);
 
     //update the hash cache
@@ -1028,6 +1331,7 @@ duint ModHashFromName(const char* Module)
         hashNameMap[hash] = Module;
     }
 
+    hashMemo.emplace(Module, hash);
     return hash;
 }
 
@@ -1098,9 +1402,9 @@ bool ModSectionsFromAddr(duint Address, std::vector<MODSECTIONINFO>* Sections)
 
 duint ModEntryFromAddr(duint Address)
 {
-    SHARED_ACQUIRE(LockModules);
-
-    auto module = ModInfoFromAddr(Address);
+    // Served from the lock-free snapshot, the entry point is parsed from the
+    // headers before the module is inserted and never changes afterwards
+    auto module = ModSnapshotFromAddr(Address);
 
     if(!module)
         return 0;
@@ -1135,9 +1439,9 @@ void ModEnum(const std::function<void(const MODINFO &)> & cbEnum)
 
 MODULEPARTY ModGetParty(duint Address)
 {
-    SHARED_ACQUIRE(LockModules);
-
-    auto module = ModInfoFromAddr(Address);
+    // Served from the lock-free snapshot, the side bar and trace views call
+    // this for every visible instruction
+    auto module = ModSnapshotFromAddr(Address);
 
     // If the module is not found, it is an user module
     if(!module)
@@ -1157,6 +1461,171 @@ void ModSetParty(duint Address, MODULEPARTY Party)
         return;
 
     module->party = Party;
+
+    // Remember the choice across sessions and base address changes
+    MODPARTYOVERRIDE partyOverride;
+    partyOverride.module = String(module->name) + module->extension;
+    partyOverride.party = Party;
+    modPartyOverrides[module->hash] = partyOverride;
+
+    ModSnapshotRebuild();
+    EXCLUSIVE_RELEASE();
+
+    ExpressionFunctions::InvalidateModule();
+    valnamecacheclear();
+}
+
+void ModPartyCacheSave(JSON Root)
+{
+    SHARED_ACQUIRE(LockModules);
+    if(modPartyOverrides.empty())
+        return;
+    JSON jsonOverrides = json_array();
+    for(const auto & i : modPartyOverrides)
+    {
+        JSON jsonOverride = json_object();
+        json_object_set_new(jsonOverride, "module", json_string(i.second.module.c_str()));
+        json_object_set_new(jsonOverride, "party", json_integer(i.second.party));
+        json_array_append_new(jsonOverrides, jsonOverride);
+    }
+    json_object_set_new(Root, "moduleparty", jsonOverrides);
+}
+
+void ModPartyCacheLoad(JSON Root)
+{
+    EXCLUSIVE_ACQUIRE(LockModules);
+    modPartyOverrides.clear();
+
+    JSON jsonOverrides = json_object_get(Root, "moduleparty");
+    if(!jsonOverrides)
+        return;
+
+    size_t i;
+    JSON value;
+    json_array_foreach(jsonOverrides, i, value)
+    {
+        auto module = json_string_value(json_object_get(value, "module"));
+        if(!module || !*module)
+            continue;
+        MODPARTYOVERRIDE partyOverride;
+        partyOverride.module = module;
+        partyOverride.party = MODULEPARTY(json_integer_value(json_object_get(value, "party")));
+        modPartyOverrides[ModHashFromName(module)] = partyOverride;
+    }
+
+    // Apply to modules that loaded before the database (the debuggee itself)
+    bool changed = false;
+    for(const auto & mod : modinfo)
+    {
+        auto found = modPartyOverrides.find(mod.second->hash);
+        if(found != modPartyOverrides.end() && mod.second->party != found->second.party)
+        {
+            mod.second->party = found->second.party;
+            changed = true;
+        }
+    }
+    if(changed)
+    {
+        ModSnapshotRebuild();
+        EXCLUSIVE_RELEASE();
+        ExpressionFunctions::InvalidateModule();
+    valnamecacheclear();
+    }
+}
+
+void ModPartyCacheClear()
+{
+    EXCLUSIVE_ACQUIRE(LockModules);
+    modPartyOverrides.clear();
+}
+
+void ModHashCacheSave(JSON Root)
+{
+    SHARED_ACQUIRE(LockModules);
+    if(moduleContentHashes.empty())
+        return;
+    JSON jsonHashes = json_array();
+    for(const auto & i : moduleContentHashes)
+    {
+        JSON jsonHash = json_object();
+        json_object_set_new(jsonHash, "module", json_string(i.first.c_str()));
+        json_object_set_new(jsonHash, "hash", json_hex(i.second));
+        json_array_append_new(jsonHashes, jsonHash);
+    }
+    json_object_set_new(Root, "modulehashes", jsonHashes);
+}
+
+void ModHashCacheLoad(JSON Root)
+{
+    EXCLUSIVE_ACQUIRE(LockModules);
+    moduleContentHashes.clear();
+
+    JSON jsonHashes = json_object_get(Root, "modulehashes");
+    if(!jsonHashes)
+        return;
+
+    size_t i;
+    JSON value;
+    json_array_foreach(jsonHashes, i, value)
+    {
+        auto module = json_string_value(json_object_get(value, "module"));
+        if(!module || !*module)
+            continue;
+        moduleContentHashes[module] = duint(json_hex_value(json_object_get(value, "hash")));
+    }
+}
+
+void ModHashCacheClear()
+{
+    EXCLUSIVE_ACQUIRE(LockModules);
+    moduleContentHashes.clear();
+}
+
+void ModHashValidate(duint Base)
+{
+    // The database restores analysis results (functions, xrefs, encode maps)
+    // keyed by module name, so a module whose bytes changed since the last
+    // session would come back with analysis describing the old binary. The
+    // stored content hash detects that and drops only the automatic entries
+    // for this module; everything else keeps its restored analysis and does
+    // not need to be re-analyzed.
+    auto contentHash = ModContentHashFromAddr(Base);
+    if(!contentHash)
+        return;
+    char modname[MAX_MODULE_SIZE] = "";
+    if(!ModNameFromAddr(Base, modname, true))
+        return;
+    auto base = ModBaseFromAddr(Base);
+    auto size = ModSizeFromAddr(Base);
+    bool mismatch = false;
+    {
+        EXCLUSIVE_ACQUIRE(LockModules);
+        auto found = moduleContentHashes.find(modname);
+        mismatch = found != moduleContentHashes.end() && found->second != contentHash;
+        moduleContentHashes[modname] = contentHash;
+    }
+    if(mismatch && base && size)
+    {
+        dprintf(QT_TRANSLATE_NOOP("DBG", "Module %s changed since the last session, discarding its cached analysis...
+"), modname);
+        FunctionDelRange(base, base + size - 1, false);
+        XrefDelRange(base, base + size - 1);
+        EncodeMapDelSegment(base);
+    }
+}
+
+void ModHashValidateAsync(duint Base)
+{
+    // Re-hashing every mapped module inline would stall the debug event
+    // thread during attach, exactly when getting to a usable state matters
+    // most. The hashes stored in the database act as a warm-start profile of
+    // the last session: the restored analysis is used immediately and the
+    // module load workers verify it in the background, discarding it only
+    // when a module actually changed.
+    MODLOADJOB job;
+    job.base = Base;
+    job.validateHash = true;
+    ModQueueJob(std::move(job));
 }
 
 bool ModRelocationsFromAddr(duint Address, std::vector<MODRELOCATIONINFO> & Relocations)
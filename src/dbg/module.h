@@ -5,6 +5,7 @@
 #include <functional>
 
 #include "symbolsourcebase.h"
+#include "jansson/jansson_x64dbg.h"
 
 // Macros to safely access IMAGE_NT_HEADERS fields since the compile-time typedef of this struct may not match the actual file bitness.
 // Never access OptionalHeader.xx values directly unless they have the same size and offset on 32 and 64 bit. IMAGE_FILE_HEADER fields are safe to use
@@ -118,6 +119,8 @@ struct MODINFO
 
     MODULEPARTY party;  // Party. Currently used value: 0: User, 1: System
 
+    bool metadataPending = false; // Directory walks (exports/imports/etc.) still running on a worker thread
+
     MODINFO()
     {
         memset(name, 0, sizeof(name));
@@ -167,6 +170,14 @@ void ModEnum(const std::function<void(const MODINFO &)> & cbEnum);
 
 MODULEPARTY ModGetParty(duint Address);
 void ModSetParty(duint Address, MODULEPARTY Party);
+void ModPartyCacheSave(JSON Root);
+void ModPartyCacheLoad(JSON Root);
+void ModPartyCacheClear();
+void ModHashCacheSave(JSON Root);
+void ModHashCacheLoad(JSON Root);
+void ModHashCacheClear();
+void ModHashValidate(duint Base);
+void ModHashValidateAsync(duint Base);
 bool ModRelocationsFromAddr(duint Address, std::vector<MODRELOCATIONINFO> & Relocations);
 bool ModRelocationAtAddr(duint Address, MODRELOCATIONINFO* Relocation);
 bool ModRelocationsInRange(duint Address, duint Size, std::vector<MODRELOCATIONINFO> & Relocations);
@@ -0,0 +1,405 @@
+#include "modulecache.h"
+#include "debugger.h"
+#include "murmurhash.h"
+#include "filemap.h"
+#include <algorithm>
+
+static const unsigned int ModCacheVersion = 1;
+
+#pragma pack(push, 1)
+struct ModCacheHeader
+{
+    char magic[4]; // "MDC1"
+    unsigned int version; // ModCacheVersion, bump when the serialized layout changes
+    unsigned int pointerSize; // sizeof(duint), x32 and x64 caches are incompatible
+    unsigned int loadedSize; // module file size when the cache was written
+    unsigned long long lastWriteTime; // module FILETIME when the cache was written
+};
+#pragma pack(pop)
+
+static const char modCacheMagic[4] = { 'M', 'D', 'C', '1' };
+
+static bool modCacheFileTime(const char* path, unsigned long long & lastWriteTime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attrib;
+    if(!GetFileAttributesExW(StringUtils::Utf8ToUtf16(path).c_str(), GetFileExInfoStandard, &attrib))
+        return false;
+    lastWriteTime = (unsigned long long)attrib.ftLastWriteTime.dwHighDateTime << 32 | attrib.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
+static WString modCachePath(const MODINFO & Info, bool createDirectory)
+{
+    auto pathLower = StringUtils::ToLower(Info.path);
+    auto hash = (unsigned long long)murmurhash(pathLower.c_str(), int(pathLower.length()));
+    auto dir = StringUtils::sprintf("%s\\db\\modcache", szProgramDir);
+    if(createDirectory)
+        CreateDirectoryW(StringUtils::Utf8ToUtf16(dir).c_str(), nullptr);
+    return StringUtils::Utf8ToUtf16(StringUtils::sprintf("%s\\%s%s-%llX.cache", dir.c_str(), Info.name, Info.extension, hash));
+}
+
+namespace
+{
+struct CacheReader
+{
+    CacheReader(const char* data, size_t size)
+        : mPtr(data), mRemaining(size) { }
+
+    bool Read(void* dest, size_t size)
+    {
+        if(size > mRemaining)
+            return false;
+        memcpy(dest, mPtr, size);
+        mPtr += size;
+        mRemaining -= size;
+        return true;
+    }
+
+    template<typename T>
+    bool Read(T & value)
+    {
+        return Read(&value, sizeof(value));
+    }
+
+    bool ReadString(String & str)
+    {
+        unsigned int length;
+        if(!Read(length) || length > mRemaining)
+            return false;
+        str.assign(mPtr, length);
+        mPtr += length;
+        mRemaining -= length;
+        return true;
+    }
+
+    // An element count can never exceed the remaining payload bytes, reject
+    // it before it is used to size a vector
+    bool ReadCount(unsigned int & count)
+    {
+        return Read(count) && count <= mRemaining;
+    }
+
+    size_t Remaining() const
+    {
+        return mRemaining;
+    }
+
+private:
+    const char* mPtr;
+    size_t mRemaining;
+};
+} //namespace
+
+template<typename T>
+static bool writeValue(BufferedWriter & out, const T & value)
+{
+    return out.Write(&value, sizeof(value));
+}
+
+static bool writeString(BufferedWriter & out, const String & str)
+{
+    if(!writeValue(out, (unsigned int)str.size()))
+        return false;
+    return out.Write(str.c_str(), str.size());
+}
+
+static bool readIndexVector(CacheReader & in, std::vector<size_t> & indices, size_t elementCount)
+{
+    unsigned int count;
+    if(!in.ReadCount(count) || count != elementCount)
+        return false;
+    indices.resize(count);
+    for(unsigned int i = 0; i < count; i++)
+    {
+        unsigned int index;
+        if(!in.Read(index) || index >= elementCount)
+            return false;
+        indices[i] = index;
+    }
+    return true;
+}
+
+static bool writeIndexVector(BufferedWriter & out, const std::vector<size_t> & indices)
+{
+    if(!writeValue(out, (unsigned int)indices.size()))
+        return false;
+    for(auto index : indices)
+    {
+        if(!writeValue(out, (unsigned int)index))
+            return false;
+    }
+    return true;
+}
+
+static bool deserializeModInfo(MODINFO & Info, CacheReader & in)
+{
+    // Exports
+    if(!in.Read(Info.exportOrdinalBase))
+        return false;
+    unsigned int exportCount;
+    if(!in.ReadCount(exportCount))
+        return false;
+    Info.exports.resize(exportCount);
+    for(auto & entry : Info.exports)
+    {
+        unsigned char forwarded;
+        if(!in.Read(entry.ordinal) ||
+                !in.Read(entry.rva) ||
+                !in.Read(forwarded) ||
+                !in.ReadString(entry.forwardName) ||
+                !in.ReadString(entry.name) ||
+                !in.ReadString(entry.undecoratedName))
+            return false;
+        entry.forwarded = forwarded != 0;
+    }
+
+    // Sorted export orders (stored so the name sort is not redone on load)
+    unsigned int count;
+    if(!in.ReadCount(count) || count != exportCount)
+        return false;
+    Info.exportsByName.resize(count);
+    for(auto & nameIndex : Info.exportsByName)
+    {
+        unsigned int index;
+        if(!in.Read(index) || index >= exportCount)
+            return false;
+        nameIndex.index = index;
+        nameIndex.name = Info.exports[index].name.c_str(); //NOTE: DO NOT MODIFY name is any way!
+    }
+    if(!readIndexVector(in, Info.exportsByRva, exportCount))
+        return false;
+
+    // Imports
+    unsigned int importModuleCount;
+    if(!in.ReadCount(importModuleCount))
+        return false;
+    Info.importModules.resize(importModuleCount);
+    for(auto & moduleName : Info.importModules)
+    {
+        if(!in.ReadString(moduleName))
+            return false;
+    }
+    unsigned int importCount;
+    if(!in.ReadCount(importCount))
+        return false;
+    Info.imports.resize(importCount);
+    for(auto & entry : Info.imports)
+    {
+        unsigned int moduleIndex;
+        if(!in.Read(moduleIndex) ||
+                moduleIndex >= importModuleCount ||
+                !in.Read(entry.iatRva) ||
+                !in.Read(entry.ordinal) ||
+                !in.ReadString(entry.name) ||
+                !in.ReadString(entry.undecoratedName))
+            return false;
+        entry.moduleIndex = moduleIndex;
+    }
+    if(!readIndexVector(in, Info.importsByRva, importCount))
+        return false;
+
+    // TLS callbacks (stored as RVAs, the base differs per session)
+    if(!in.ReadCount(count))
+        return false;
+    Info.tlsCallbacks.resize(count);
+    for(auto & callback : Info.tlsCallbacks)
+    {
+        duint rva;
+        if(!in.Read(rva))
+            return false;
+        callback = rva + Info.base;
+    }
+
+    // Relocations
+    if(!in.ReadCount(count) || (size_t)count * sizeof(MODRELOCATIONINFO) > in.Remaining())
+        return false;
+    Info.relocations.resize(count);
+    if(count && !in.Read(Info.relocations.data(), count * sizeof(MODRELOCATIONINFO)))
+        return false;
+
+#ifdef _WIN64
+    // Runtime functions
+    if(!in.ReadCount(count) || (size_t)count * sizeof(RUNTIME_FUNCTION) > in.Remaining())
+        return false;
+    Info.runtimeFunctions.resize(count);
+    if(count && !in.Read(Info.runtimeFunctions.data(), count * sizeof(RUNTIME_FUNCTION)))
+        return false;
+#endif // _WIN64
+
+    // PDB information
+    if(!in.ReadString(Info.pdbSignature) ||
+            !in.ReadString(Info.pdbFile) ||
+            !in.Read(&Info.pdbValidation, sizeof(Info.pdbValidation)))
+        return false;
+    if(!in.ReadCount(count))
+        return false;
+    Info.pdbPaths.resize(count);
+    for(auto & pdbPath : Info.pdbPaths)
+    {
+        if(!in.ReadString(pdbPath))
+            return false;
+    }
+    return true;
+}
+
+static bool serializeModInfo(const MODINFO & Info, BufferedWriter & out)
+{
+    // Exports
+    if(!writeValue(out, Info.exportOrdinalBase))
+        return false;
+    if(!writeValue(out, (unsigned int)Info.exports.size()))
+        return false;
+    for(const auto & entry : Info.exports)
+    {
+        if(!writeValue(out, entry.ordinal) ||
+                !writeValue(out, entry.rva) ||
+                !writeValue(out, (unsigned char)(entry.forwarded ? 1 : 0)) ||
+                !writeString(out, entry.forwardName) ||
+                !writeString(out, entry.name) ||
+                !writeString(out, entry.undecoratedName))
+            return false;
+    }
+    if(!writeValue(out, (unsigned int)Info.exportsByName.size()))
+        return false;
+    for(const auto & nameIndex : Info.exportsByName)
+    {
+        if(!writeValue(out, (unsigned int)nameIndex.index))
+            return false;
+    }
+    if(!writeIndexVector(out, Info.exportsByRva))
+        return false;
+
+    // Imports
+    if(!writeValue(out, (unsigned int)Info.importModules.size()))
+        return false;
+    for(const auto & moduleName : Info.importModules)
+    {
+        if(!writeString(out, moduleName))
+            return false;
+    }
+    if(!writeValue(out, (unsigned int)Info.imports.size()))
+        return false;
+    for(const auto & entry : Info.imports)
+    {
+        if(!writeValue(out, (unsigned int)entry.moduleIndex) ||
+                !writeValue(out, entry.iatRva) ||
+                !writeValue(out, entry.ordinal) ||
+                !writeString(out, entry.name) ||
+                !writeString(out, entry.undecoratedName))
+            return false;
+    }
+    if(!writeIndexVector(out, Info.importsByRva))
+        return false;
+
+    // TLS callbacks (stored as RVAs, the base differs per session)
+    if(!writeValue(out, (unsigned int)Info.tlsCallbacks.size()))
+        return false;
+    for(auto callback : Info.tlsCallbacks)
+    {
+        if(!writeValue(out, duint(callback - Info.base)))
+            return false;
+    }
+
+    // Relocations
+    if(!writeValue(out, (unsigned int)Info.relocations.size()))
+        return false;
+    if(!Info.relocations.empty() && !out.Write(Info.relocations.data(), Info.relocations.size() * sizeof(MODRELOCATIONINFO)))
+        return false;
+
+#ifdef _WIN64
+    // Runtime functions
+    if(!writeValue(out, (unsigned int)Info.runtimeFunctions.size()))
+        return false;
+    if(!Info.runtimeFunctions.empty() && !out.Write(Info.runtimeFunctions.data(), Info.runtimeFunctions.size() * sizeof(RUNTIME_FUNCTION)))
+        return false;
+#endif // _WIN64
+
+    // PDB information
+    if(!writeString(out, Info.pdbSignature) ||
+            !writeString(out, Info.pdbFile) ||
+            !writeValue(out, Info.pdbValidation))
+        return false;
+    if(!writeValue(out, (unsigned int)Info.pdbPaths.size()))
+        return false;
+    for(const auto & pdbPath : Info.pdbPaths)
+    {
+        if(!writeString(out, pdbPath))
+            return false;
+    }
+    return true;
+}
+
+bool ModCacheLoad(MODINFO & Info)
+{
+    unsigned long long lastWriteTime;
+    if(!modCacheFileTime(Info.path, lastWriteTime))
+        return false;
+
+    FileMap<char> cacheMap;
+    if(!cacheMap.Map(modCachePath(Info, false).c_str()))
+        return false;
+
+    CacheReader in(cacheMap.Data(), cacheMap.Size());
+    ModCacheHeader header;
+    String cachedPath;
+    if(!in.Read(header) ||
+            memcmp(header.magic, modCacheMagic, sizeof(modCacheMagic)) != 0 ||
+            header.version != ModCacheVersion ||
+            header.pointerSize != sizeof(duint) ||
+            header.loadedSize != Info.loadedSize ||
+            header.lastWriteTime != lastWriteTime ||
+            !in.ReadString(cachedPath) ||
+            _stricmp(cachedPath.c_str(), Info.path) != 0) //defend against path hash collisions
+        return false;
+
+    if(!deserializeModInfo(Info, in))
+    {
+        // Discard whatever a truncated or corrupt cache left behind, the
+        // caller falls back to parsing the PE structures
+        Info.exports.clear();
+        Info.exportOrdinalBase = 0;
+        Info.exportsByName.clear();
+        Info.exportsByRva.clear();
+        Info.importModules.clear();
+        Info.imports.clear();
+        Info.importsByRva.clear();
+        Info.tlsCallbacks.clear();
+        Info.relocations.clear();
+#ifdef _WIN64
+        Info.runtimeFunctions.clear();
+#endif // _WIN64
+        Info.pdbSignature.clear();
+        Info.pdbFile.clear();
+        Info.pdbValidation = PdbValidationData();
+        Info.pdbPaths.clear();
+        return false;
+    }
+    return true;
+}
+
+void ModCacheSave(const MODINFO & Info)
+{
+    unsigned long long lastWriteTime;
+    if(!modCacheFileTime(Info.path, lastWriteTime))
+        return;
+
+    auto cachePath = modCachePath(Info, true);
+    auto hFile = CreateFileW(cachePath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, 0, nullptr);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    bool success;
+    {
+        BufferedWriter out(hFile); //closes the handle on destruction
+        ModCacheHeader header;
+        memcpy(header.magic, modCacheMagic, sizeof(modCacheMagic));
+        header.version = ModCacheVersion;
+        header.pointerSize = sizeof(duint);
+        header.loadedSize = Info.loadedSize;
+        header.lastWriteTime = lastWriteTime;
+        success = writeValue(out, header) && writeString(out, Info.path) && serializeModInfo(Info, out);
+    }
+
+    if(!success)
+        DeleteFileW(cachePath.c_str());
+}
@@ -0,0 +1,15 @@
+#ifndef _MODULECACHE_H
+#define _MODULECACHE_H
+
+#include "module.h"
+
+// Disk cache for parsed module metadata (exports, imports, TLS callbacks,
+// relocations, runtime functions and PDB info), keyed on the module path,
+// file size and last write time. Attaching to a process with hundreds of
+// DLLs re-parses the same PE structures every session; the cache stores the
+// parsed tables in a flat format that loads with one sequential read and
+// skips the name undecoration entirely.
+bool ModCacheLoad(MODINFO & Info);
+void ModCacheSave(const MODINFO & Info);
+
+#endif // _MODULECACHE_H
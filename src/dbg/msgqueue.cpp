@@ -1,5 +1,43 @@
 #include "msgqueue.h"
 
+MESSAGE_STACK::MESSAGE_STACK()
+{
+    memset((void*)Slots, 0, sizeof(Slots));
+    FreeSlots = CreateSemaphoreW(nullptr, MAX_MESSAGES, MAX_MESSAGES, nullptr);
+    UsedSlots = CreateSemaphoreW(nullptr, 0, MAX_MESSAGES, nullptr);
+}
+
+MESSAGE_STACK::~MESSAGE_STACK()
+{
+    CloseHandle(FreeSlots);
+    CloseHandle(UsedSlots);
+}
+
+// Claim a slot and publish a message, blocking while the ring is full
+void MESSAGE_STACK::Enqueue(const MESSAGE & Msg)
+{
+    WaitForSingleObject(FreeSlots, INFINITE);
+    auto & slot = Slots[ULONG(InterlockedIncrement(&EnqueuePos) - 1) & (MAX_MESSAGES - 1)];
+    slot.Msg = Msg;
+    InterlockedExchange(&slot.Ready, 1); //orders the message write before the publish
+    ReleaseSemaphore(UsedSlots, 1, nullptr);
+}
+
+// Pop the oldest message, only ever called from the consumer thread
+bool MESSAGE_STACK::Dequeue(MESSAGE & Msg, DWORD Timeout)
+{
+    if(WaitForSingleObject(UsedSlots, Timeout) != WAIT_OBJECT_0)
+        return false;
+    auto & slot = Slots[ULONG(DequeuePos++) & (MAX_MESSAGES - 1)];
+    // A producer that claimed a later slot may have signalled before this
+    // slot was published, the window is tiny so just spin
+    while(InterlockedCompareExchange(&slot.Ready, 0, 1) != 1)
+        YieldProcessor();
+    Msg = slot.Msg;
+    ReleaseSemaphore(FreeSlots, 1, nullptr);
+    return true;
+}
+
 // Allocate a message stack
 MESSAGE_STACK* MsgAllocStack()
 {
@@ -18,7 +56,8 @@ void MsgFreeStack(MESSAGE_STACK* Stack)
     for(int i = 0; i < Stack->WaitingCalls + 1; i++) //TODO: found crash here on exit
     {
         MESSAGE newMessage;
-        Stack->msgs.enqueue(newMessage);
+        memset(&newMessage, 0, sizeof(newMessage));
+        Stack->Enqueue(newMessage);
     }
 
     // Delete allocated structure
@@ -36,8 +75,7 @@ bool MsgSend(MESSAGE_STACK* Stack, int Msg, duint Param1, duint Param2)
     newMessage.param1 = Param1;
     newMessage.param2 = Param2;
 
-    // Asynchronous send
-    asend(Stack->msgs, newMessage);
+    Stack->Enqueue(newMessage);
     return true;
 }
 
@@ -48,7 +86,7 @@ bool MsgGet(MESSAGE_STACK* Stack, MESSAGE* Msg)
         return false;
 
     // Don't increment the wait count because this does not wait
-    return try_receive(Stack->msgs, *Msg);
+    return Stack->Dequeue(*Msg, 0);
 }
 
 // Wait for a message on the specified stack
@@ -59,6 +97,6 @@ void MsgWait(MESSAGE_STACK* Stack, MESSAGE* Msg)
 
     // Increment/decrement wait count
     InterlockedIncrement((volatile long*)&Stack->WaitingCalls);
-    *Msg = Stack->msgs.dequeue();
+    Stack->Dequeue(*Msg, INFINITE);
     InterlockedDecrement((volatile long*)&Stack->WaitingCalls);
 }
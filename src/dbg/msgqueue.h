@@ -2,7 +2,6 @@
 #define _MSGQUEUE_H
 
 #include "_global.h"
-#include <agents.h>
 
 #define MAX_MESSAGES 256
 
@@ -14,14 +13,36 @@ struct MESSAGE
     duint param2;
 };
 
-// Message stack structure
+// Message stack structure: a bounded ring buffer instead of a ConcRT
+// unbounded_buffer, so sending a message does not heap-allocate. Producers
+// (GUI, script, plugins) claim slots with an atomic increment and the
+// command loop is the single consumer, popping the slots in order. The two
+// semaphores pace the sides: a producer only blocks when the ring is full,
+// the consumer only when it is empty.
 class MESSAGE_STACK
 {
 public:
-    Concurrency::unbounded_buffer<MESSAGE> msgs;
+    MESSAGE_STACK();
+    ~MESSAGE_STACK();
+
+    void Enqueue(const MESSAGE & Msg);
+    bool Dequeue(MESSAGE & Msg, DWORD Timeout);
 
     int WaitingCalls = 0; // Number of threads waiting
     bool Destroy = false; // Destroy stack as soon as possible
+
+private:
+    struct SLOT
+    {
+        volatile LONG Ready;
+        MESSAGE Msg;
+    };
+
+    SLOT Slots[MAX_MESSAGES];
+    volatile LONG EnqueuePos = 0;
+    LONG DequeuePos = 0; // Only touched by the consumer
+    HANDLE FreeSlots; // Semaphore counting free ring slots
+    HANDLE UsedSlots; // Semaphore counting pending messages
 };
 
 // Function definitions
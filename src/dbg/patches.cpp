@@ -9,10 +9,40 @@
 #include "debugger.h"
 #include "threading.h"
 #include "module.h"
+#include <algorithm>
+#include <deque>
 
 static std::unordered_map<duint, PATCHINFO> patches;
 static std::unordered_map<DWORD, size_t> lastEnumSize;
 
+// Insert or update a single patch record. The caller holds LockPatches
+// exclusively and has already filtered out unchanged bytes.
+static void patchSetNoLock(duint Key, const PATCHINFO & NewPatch)
+{
+    // Find any patch with this specific address
+    auto found = patches.find(Key);
+
+    if(found != patches.end())
+    {
+        if(found->second.oldbyte == NewPatch.newbyte)
+        {
+            // The patch was undone here
+            patches.erase(found);
+            return;
+        }
+
+        // Keep the original byte from the previous patch
+        auto oldByte = found->second.oldbyte;
+        found->second = NewPatch;
+        found->second.oldbyte = oldByte;
+    }
+    else
+    {
+        // The entry was never found, insert it
+        patches.insert(std::make_pair(Key, NewPatch));
+    }
+}
+
 bool PatchSet(duint Address, unsigned char OldByte, unsigned char NewByte)
 {
     if(!DbgIsDebugging())
@@ -36,29 +66,73 @@ bool PatchSet(duint Address, unsigned char OldByte, unsigned char NewByte)
     const duint key = ModHashFromAddr(Address);
 
     EXCLUSIVE_ACQUIRE(LockPatches);
+    patchSetNoLock(key, newPatch);
+    return true;
+}
 
-    // Find any patch with this specific address
-    auto found = patches.find(key);
+bool PatchSetRange(duint Address, const unsigned char* OldData, const unsigned char* NewData, duint Size)
+{
+    if(!DbgIsDebugging())
+        return false;
 
-    if(found != patches.end())
+    // Buffers and size must be valid
+    if(!OldData || !NewData || !Size)
+        return false;
+
+    // Address must be valid
+    if(!MemIsValidReadPtr(Address))
+        return false;
+
+    // Build the records before taking the lock, resolving the owning
+    // module once per run instead of once per byte
+    std::vector<std::pair<duint, PATCHINFO>> batch;
+    batch.reserve(Size);
+    for(duint i = 0; i < Size;)
     {
-        if(found->second.oldbyte == NewByte)
+        const duint runStart = Address + i;
+        duint moduleBase = ModBaseFromAddr(runStart);
+        const duint moduleSize = moduleBase ? ModSizeFromAddr(runStart) : 0;
+
+        // End of the stretch served by this module lookup (exclusive,
+        // relative to Address). Outside any module the key is the
+        // virtual address itself, so advance a single byte
+        duint runEnd;
+        duint hashBase = 0;
+        char modName[MAX_MODULE_SIZE] = "";
+        if(moduleBase && moduleSize)
         {
-            // The patch was undone here
-            patches.erase(found);
-            return true;
+            runEnd = std::min(moduleBase + moduleSize - Address, Size);
+            hashBase = ModHashFromAddr(moduleBase);
+            ModNameFromAddr(runStart, modName, true);
+        }
+        else
+        {
+            moduleBase = 0;
+            runEnd = i + 1;
         }
 
-        // Keep the original byte from the previous patch
-        newPatch.oldbyte = found->second.oldbyte;
-        found->second = newPatch;
-    }
-    else
-    {
-        // The entry was never found, insert it
-        patches.insert(std::make_pair(key, newPatch));
+        for(; i < runEnd; i++)
+        {
+            // Don't patch anything if the new and old values are the same
+            if(OldData[i] == NewData[i])
+                continue;
+
+            PATCHINFO newPatch;
+            newPatch.addr = Address + i - moduleBase;
+            newPatch.oldbyte = OldData[i];
+            newPatch.newbyte = NewData[i];
+            strcpy_s(newPatch.mod, modName);
+            batch.emplace_back(moduleBase ? hashBase + newPatch.addr : newPatch.addr, newPatch);
+        }
     }
 
+    if(batch.empty())
+        return true;
+
+    // Record the whole range with a single lock acquisition
+    EXCLUSIVE_ACQUIRE(LockPatches);
+    for(const auto & entry : batch)
+        patchSetNoLock(entry.first, entry.second);
     return true;
 }
 
@@ -131,24 +205,140 @@ void PatchDelRange(duint Start, duint End, bool Restore)
         End -= moduleBase;
 
         EXCLUSIVE_ACQUIRE(LockPatches);
+        std::vector<std::pair<duint, unsigned char>> restoreBytes;
         for(auto itr = patches.begin(); itr != patches.end();)
         {
             const auto & currentPatch = itr->second;
             // [Start, End)
             if(currentPatch.addr >= Start && currentPatch.addr < End)
             {
-                // Restore the original byte if necessary
+                // Remember the original byte if necessary
                 if(Restore)
-                    MemWrite((currentPatch.addr + moduleBase), &currentPatch.oldbyte, sizeof(char));
+                    restoreBytes.push_back({ currentPatch.addr + moduleBase, currentPatch.oldbyte });
 
                 itr = patches.erase(itr);
             }
             else
                 ++itr;
         }
+
+        // Restore the original bytes, coalescing contiguous patches into
+        // a single write each instead of one write per byte
+        if(!restoreBytes.empty())
+        {
+            std::sort(restoreBytes.begin(), restoreBytes.end());
+
+            std::vector<unsigned char> runData;
+            size_t runStart = 0;
+            for(size_t i = 1; i <= restoreBytes.size(); i++)
+            {
+                if(i == restoreBytes.size() || restoreBytes[i].first != restoreBytes[i - 1].first + 1)
+                {
+                    runData.clear();
+                    for(size_t j = runStart; j < i; j++)
+                        runData.push_back(restoreBytes[j].second);
+                    MemWrite(restoreBytes[runStart].first, runData.data(), runData.size());
+                    runStart = i;
+                }
+            }
+        }
     }
 }
 
+// Grouped undo/redo journal over memory edits. Every successful MemPatch
+// call records one transaction holding the original and the written bytes as
+// a single range, so undoing a large interactive edit issues one ranged
+// write instead of one write per patched byte. Journal memory is bounded by
+// dropping the oldest transactions; their byte-level state stays in the
+// patch map above (and thus in the database), only the grouping is lost.
+struct PatchEdit
+{
+    duint addr;
+    std::vector<unsigned char> oldData;
+    std::vector<unsigned char> newData;
+};
+
+static std::deque<PatchEdit> patchUndoLog;
+static std::deque<PatchEdit> patchRedoLog;
+static duint patchJournalBytes = 0; //bytes held by patchUndoLog
+static bool patchJournalReplay = false;
+
+void PatchJournalRecord(duint Address, const unsigned char* OldData, const unsigned char* NewData, duint Size)
+{
+    if(!OldData || !NewData || !Size)
+        return;
+    EXCLUSIVE_ACQUIRE(LockPatchJournal);
+    if(patchJournalReplay) //undo/redo replays maintain the logs themselves
+        return;
+    if(!memcmp(OldData, NewData, Size))
+        return;
+    PatchEdit edit;
+    edit.addr = Address;
+    edit.oldData.assign(OldData, OldData + Size);
+    edit.newData.assign(NewData, NewData + Size);
+    patchUndoLog.push_back(std::move(edit));
+    patchRedoLog.clear(); //a new edit invalidates the redo history
+    patchJournalBytes += Size * 2;
+    const duint maxBytes = 1024 * 1024;
+    const size_t maxEdits = 128;
+    while(patchUndoLog.size() > 1 && (patchJournalBytes > maxBytes || patchUndoLog.size() > maxEdits))
+    {
+        patchJournalBytes -= patchUndoLog.front().oldData.size() * 2;
+        patchUndoLog.pop_front();
+    }
+}
+
+bool PatchUndoEdit()
+{
+    PatchEdit edit;
+    {
+        EXCLUSIVE_ACQUIRE(LockPatchJournal);
+        if(patchUndoLog.empty())
+            return false;
+        edit = std::move(patchUndoLog.back());
+        patchUndoLog.pop_back();
+        patchJournalBytes -= edit.oldData.size() * 2;
+        patchJournalReplay = true;
+    }
+    // MemPatch re-applies the old bytes as one ranged write and takes the
+    // matching patch records out through patchSetNoLock
+    auto success = MemPatch(edit.addr, edit.oldData.data(), edit.oldData.size());
+    EXCLUSIVE_ACQUIRE(LockPatchJournal);
+    patchJournalReplay = false;
+    if(success)
+        patchRedoLog.push_back(std::move(edit));
+    else
+    {
+        patchJournalBytes += edit.oldData.size() * 2;
+        patchUndoLog.push_back(std::move(edit));
+    }
+    return success;
+}
+
+bool PatchRedoEdit()
+{
+    PatchEdit edit;
+    {
+        EXCLUSIVE_ACQUIRE(LockPatchJournal);
+        if(patchRedoLog.empty())
+            return false;
+        edit = std::move(patchRedoLog.back());
+        patchRedoLog.pop_back();
+        patchJournalReplay = true;
+    }
+    auto success = MemPatch(edit.addr, edit.newData.data(), edit.newData.size());
+    EXCLUSIVE_ACQUIRE(LockPatchJournal);
+    patchJournalReplay = false;
+    if(success)
+    {
+        patchJournalBytes += edit.oldData.size() * 2;
+        patchUndoLog.push_back(std::move(edit));
+    }
+    else
+        patchRedoLog.push_back(std::move(edit));
+    return success;
+}
+
 bool PatchEnum(PATCHINFO* List, size_t* Size)
 {
     /*if(!DbgIsDebugging())
@@ -309,6 +499,14 @@ int PatchFile(const PATCHINFO* List, int Count, const char* FileName, char* Erro
 
 void PatchClear(const char* Module)
 {
+    // The journal references addresses by VA, which a module unload or a new
+    // session invalidates wholesale
+    {
+        EXCLUSIVE_ACQUIRE(LockPatchJournal);
+        patchUndoLog.clear();
+        patchRedoLog.clear();
+        patchJournalBytes = 0;
+    }
     EXCLUSIVE_ACQUIRE(LockPatches);
 
     // Was a module specified?
@@ -13,11 +13,15 @@ struct PATCHINFO
 };
 
 bool PatchSet(duint Address, unsigned char OldByte, unsigned char NewByte);
+bool PatchSetRange(duint Address, const unsigned char* OldData, const unsigned char* NewData, duint Size);
 bool PatchGet(duint Address, PATCHINFO* Patch);
 bool PatchDelete(duint Address, bool Restore);
 void PatchDelRange(duint Start, duint End, bool Restore);
 bool PatchEnum(PATCHINFO* List, size_t* Size);
 int PatchFile(const PATCHINFO* List, int Count, const char* FileName, char* Error);
 void PatchClear(const char* Module = nullptr);
+void PatchJournalRecord(duint Address, const unsigned char* OldData, const unsigned char* NewData, duint Size);
+bool PatchUndoEdit();
+bool PatchRedoEdit();
 
 #endif // _PATCHES_H
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "patternfind.h"
 #include <vector>
 #include <algorithm>
+#include <intrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
 
 using namespace std;
 
@@ -164,7 +167,7 @@ bool patternsnr(unsigned char* data, size_t datasize, const char* searchpattern,
     return true;
 }
 
-size_t patternfind(const unsigned char* data, size_t datasize, const std::vector<PatternByte> & pattern)
+static size_t patternfindscalar(const unsigned char* data, size_t datasize, const std::vector<PatternByte> & pattern)
 {
     size_t searchpatternsize = pattern.size();
     for(size_t i = 0, pos = 0; i < datasize; i++) //search for the pattern
@@ -182,4 +185,197 @@ size_t patternfind(const unsigned char* data, size_t datasize, const std::vector
         }
     }
     return -1;
+}
+
+static inline bool patternverify(const unsigned char* data, size_t datasize, const std::vector<PatternByte> & pattern)
+{
+    size_t searchpatternsize = pattern.size();
+    if(searchpatternsize > datasize)
+        return false;
+    for(size_t i = 0; i < searchpatternsize; i++)
+        if(!patternmatchbyte(data[i], pattern[i]))
+            return false;
+    return true;
+}
+
+// Find the first pattern byte without wildcard nibbles, used as the anchor for
+// the vectorized first-byte filter. Returns false for nibble-wildcard-only
+// patterns, which have to take the scalar path.
+static bool patternanchor(const std::vector<PatternByte> & pattern, size_t & anchorOffset, unsigned char & anchorByte)
+{
+    for(size_t i = 0; i < pattern.size(); i++)
+    {
+        const auto & pbyte = pattern[i];
+        if(!pbyte.nibble[0].wildcard && !pbyte.nibble[1].wildcard)
+        {
+            anchorOffset = i;
+            anchorByte = ((pbyte.nibble[0].data << 4) & 0xF0) | (pbyte.nibble[1].data & 0xF);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runtime CPU feature detection: 0 = scalar only, 1 = SSE2, 2 = AVX2
+static int patternsimdsupport()
+{
+    static int support = -1;
+    if(support != -1)
+        return support;
+    int info[4] = { 0 };
+    __cpuid(info, 0);
+    int nIds = info[0];
+    int detected = 0;
+    if(nIds >= 1)
+    {
+        __cpuidex(info, 1, 0);
+        if(info[3] & (1 << 26)) //SSE2
+            detected = 1;
+        auto osxsave = (info[2] & (1 << 27)) != 0; //OSXSAVE, required to trust AVX state
+        if(detected && osxsave && nIds >= 7 && (_xgetbv(0) & 6) == 6)
+        {
+            __cpuidex(info, 7, 0);
+            if(info[1] & (1 << 5)) //AVX2
+                detected = 2;
+        }
+    }
+    support = detected;
+    return support;
+}
+
+static size_t patternfindsse2(const unsigned char* data, size_t datasize, const std::vector<PatternByte> & pattern, size_t anchorOffset, unsigned char anchorByte)
+{
+    const __m128i anchor = _mm_set1_epi8(char(anchorByte));
+    size_t i = anchorOffset;
+    for(; i + 16 <= datasize; i += 16)
+    {
+        auto chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, anchor));
+        while(mask)
+        {
+            unsigned long bit = 0;
+            _BitScanForward(&bit, mask);
+            mask &= mask - 1;
+            size_t candidate = i + bit - anchorOffset;
+            if(patternverify(data + candidate, datasize - candidate, pattern))
+                return candidate;
+        }
+    }
+    // Handle the remaining tail with the scalar loop
+    if(i > anchorOffset)
+    {
+        size_t tailStart = i - anchorOffset;
+        auto found = patternfindscalar(data + tailStart, datasize - tailStart, pattern);
+        return found == -1 ? -1 : tailStart + found;
+    }
+    return patternfindscalar(data, datasize, pattern);
+}
+
+static size_t patternfindavx2(const unsigned char* data, size_t datasize, const std::vector<PatternByte> & pattern, size_t anchorOffset, unsigned char anchorByte)
+{
+    const __m256i anchor = _mm256_set1_epi8(char(anchorByte));
+    size_t i = anchorOffset;
+    for(; i + 32 <= datasize; i += 32)
+    {
+        auto chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, anchor));
+        while(mask)
+        {
+            unsigned long bit = 0;
+            _BitScanForward(&bit, mask);
+            mask &= mask - 1;
+            size_t candidate = i + bit - anchorOffset;
+            if(patternverify(data + candidate, datasize - candidate, pattern))
+                return candidate;
+        }
+    }
+    // Handle the remaining tail with the scalar loop
+    if(i > anchorOffset)
+    {
+        size_t tailStart = i - anchorOffset;
+        auto found = patternfindscalar(data + tailStart, datasize - tailStart, pattern);
+        return found == -1 ? -1 : tailStart + found;
+    }
+    return patternfindscalar(data, datasize, pattern);
+}
+
+void patternfindall(const unsigned char* data, size_t datasize, const std::vector<std::vector<PatternByte>> & patterns, std::vector<std::vector<size_t>> & results, size_t maxresults)
+{
+    results.assign(patterns.size(), std::vector<size_t>());
+    if(!datasize)
+        return;
+
+    // Bucket the patterns by their anchor byte so a single pass over the data
+    // checks each byte against one table instead of once per pattern
+    struct AnchorCandidate
+    {
+        size_t patternIndex;
+        size_t anchorOffset;
+    };
+    std::vector<std::vector<AnchorCandidate>> anchorTable(256);
+    bool hasCandidates[256] = { false };
+    for(size_t p = 0; p < patterns.size(); p++)
+    {
+        if(patterns[p].empty())
+            continue;
+        size_t anchorOffset = 0;
+        unsigned char anchorByte = 0;
+        if(patternanchor(patterns[p], anchorOffset, anchorByte))
+        {
+            anchorTable[anchorByte].push_back(AnchorCandidate { p, anchorOffset });
+            hasCandidates[anchorByte] = true;
+        }
+        else
+        {
+            // No fully concrete byte to anchor on, scan this pattern alone
+            auto & found = results[p];
+            size_t i = 0;
+            while(found.size() < maxresults && i < datasize)
+            {
+                auto offset = patternfindscalar(data + i, datasize - i, patterns[p]);
+                if(offset == -1)
+                    break;
+                found.push_back(i + offset);
+                i += offset + 1;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < datasize; i++)
+    {
+        if(!hasCandidates[data[i]])
+            continue;
+        for(const auto & candidate : anchorTable[data[i]])
+        {
+            if(i < candidate.anchorOffset)
+                continue;
+            auto start = i - candidate.anchorOffset;
+            auto & found = results[candidate.patternIndex];
+            if(found.size() >= maxresults)
+                continue;
+            if(patternverify(data + start, datasize - start, patterns[candidate.patternIndex]))
+                found.push_back(start);
+        }
+    }
+}
+
+size_t patternfind(const unsigned char* data, size_t datasize, const std::vector<PatternByte> & pattern)
+{
+    // Vectorized first-byte filtering pays off once there is enough data to
+    // scan and the pattern contains at least one fully concrete byte
+    size_t anchorOffset = 0;
+    unsigned char anchorByte = 0;
+    if(datasize >= 64 && patternanchor(pattern, anchorOffset, anchorByte))
+    {
+        switch(patternsimdsupport())
+        {
+        case 2:
+            return patternfindavx2(data, datasize, pattern, anchorOffset, anchorByte);
+        case 1:
+            return patternfindsse2(data, datasize, pattern, anchorOffset, anchorByte);
+        default:
+            break;
+        }
+    }
+    return patternfindscalar(data, datasize, pattern);
 }
\ No newline at end of file
@@ -56,4 +56,13 @@ size_t patternfind(
     const std::vector<PatternByte> & pattern //pattern to search
 );
 
+//returns: nothing, results holds the match offsets per pattern
+void patternfindall(
+    const unsigned char* data, //data
+    size_t datasize, //size of data
+    const std::vector<std::vector<PatternByte>> & patterns, //patterns to search simultaneously
+    std::vector<std::vector<size_t>> & results, //per-pattern match offsets (same order as patterns)
+    size_t maxresults //maximum number of matches per pattern
+);
+
 #endif // _PATTERNFIND_H
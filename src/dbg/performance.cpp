@@ -0,0 +1,173 @@
+#include "performance.h"
+#include "stringutils.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> perfEnabled(false);
+
+struct PerfCounter
+{
+    std::atomic<unsigned long long> ticks { 0 };
+    std::atomic<unsigned long long> hits { 0 };
+};
+
+static PerfCounter perfCounters[size_t(PerfPhase::Count)];
+
+static const char* perfPhaseNames[] =
+{
+    "debugevent",
+    "memmap",
+    "dbsave",
+    "symload",
+};
+
+static_assert(_countof(perfPhaseNames) == size_t(PerfPhase::Count), "perfPhaseNames is out of sync with PerfPhase");
+
+void PerfAdd(PerfPhase Phase, unsigned long long Ticks)
+{
+    auto & counter = perfCounters[size_t(Phase)];
+    counter.ticks.fetch_add(Ticks, std::memory_order_relaxed);
+    counter.hits.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfClear()
+{
+    for(auto & counter : perfCounters)
+    {
+        counter.ticks.store(0, std::memory_order_relaxed);
+        counter.hits.store(0, std::memory_order_relaxed);
+    }
+}
+
+//Measure how many RDTSC ticks elapse per millisecond. Modern CPUs have an
+//invariant TSC, so a single calibration against the performance counter is
+//good enough for reporting.
+static double perfTicksPerMs()
+{
+    static double ticksPerMs = 0.0;
+    if(ticksPerMs == 0.0)
+    {
+        LARGE_INTEGER freq, qpcStart, qpcEnd;
+        QueryPerformanceFrequency(&freq);
+        auto tscStart = __rdtsc();
+        QueryPerformanceCounter(&qpcStart);
+        Sleep(20);
+        auto tscEnd = __rdtsc();
+        QueryPerformanceCounter(&qpcEnd);
+        auto qpcElapsed = double(qpcEnd.QuadPart - qpcStart.QuadPart);
+        if(qpcElapsed > 0.0)
+            ticksPerMs = double(tscEnd - tscStart) * double(freq.QuadPart) / (qpcElapsed * 1000.0);
+    }
+    return ticksPerMs;
+}
+
+//Step pipeline latency. The stamps come from different threads (GUI thread
+//enqueue, command loop, debug event loop), so the record is guarded by a
+//mutex; while perfEnabled is clear every call is a single relaxed load.
+#define STEPLATENCY_SAMPLES 256
+
+static std::mutex stepLatencyMutex;
+static bool stepLatencyActive = false;
+static unsigned long long stepLatencyStamps[size_t(StepStage::Count)];
+
+//ring of per-segment durations in milliseconds, newest overwrites oldest.
+//[0] holds the end-to-end total, [i] the segment ending at stage i
+static double stepLatencySamples[size_t(StepStage::Count)][STEPLATENCY_SAMPLES];
+static size_t stepLatencyCount = 0;
+
+static unsigned long long stepLatencyNow()
+{
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+    return qpc.QuadPart;
+}
+
+void StepLatencyBegin()
+{
+    if(!perfEnabled.load(std::memory_order_relaxed))
+        return;
+    std::lock_guard<std::mutex> lock(stepLatencyMutex);
+    stepLatencyActive = true;
+    memset(stepLatencyStamps, 0, sizeof(stepLatencyStamps));
+    stepLatencyStamps[size_t(StepStage::Enqueue)] = stepLatencyNow();
+}
+
+void StepLatencyMark(StepStage Stage)
+{
+    if(!perfEnabled.load(std::memory_order_relaxed))
+        return;
+    std::lock_guard<std::mutex> lock(stepLatencyMutex);
+    if(!stepLatencyActive)
+        return;
+    stepLatencyStamps[size_t(Stage)] = stepLatencyNow();
+    if(Stage != StepStage::GuiUpdate)
+        return;
+    stepLatencyActive = false;
+    //every stage has to be stamped in order for the sample to count (a step
+    //that re-used an already dequeued command or never armed is dropped)
+    for(size_t i = 0; i < size_t(StepStage::Count); i++)
+        if(!stepLatencyStamps[i] || (i && stepLatencyStamps[i] < stepLatencyStamps[i - 1]))
+            return;
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    auto toMs = 1000.0 / double(freq.QuadPart);
+    auto slot = stepLatencyCount++ % STEPLATENCY_SAMPLES;
+    stepLatencySamples[0][slot] = double(stepLatencyStamps[size_t(StepStage::GuiUpdate)] - stepLatencyStamps[size_t(StepStage::Enqueue)]) * toMs;
+    for(size_t i = 1; i < size_t(StepStage::Count); i++)
+        stepLatencySamples[i][slot] = double(stepLatencyStamps[i] - stepLatencyStamps[i - 1]) * toMs;
+}
+
+void StepLatencyClear()
+{
+    std::lock_guard<std::mutex> lock(stepLatencyMutex);
+    stepLatencyActive = false;
+    stepLatencyCount = 0;
+}
+
+String StepLatencyReport()
+{
+    static const char* segmentNames[] =
+    {
+        "total", //enqueue -> GUI update dispatched
+        "queue", //bridge enqueue -> command loop dispatch
+        "command", //dispatch -> step armed
+        "target", //resume -> single-step event
+        "handling", //event -> GUI update dispatched
+    };
+    static_assert(_countof(segmentNames) == size_t(StepStage::Count), "segmentNames is out of sync with StepStage");
+
+    std::lock_guard<std::mutex> lock(stepLatencyMutex);
+    auto n = stepLatencyCount < STEPLATENCY_SAMPLES ? stepLatencyCount : STEPLATENCY_SAMPLES;
+    if(!n)
+        return "STEP,no samples (use \"perf enable\" and step)\n";
+    String result = "STEP,segment,samples,p50 ms,p90 ms,p99 ms,max ms\n";
+    for(size_t i = 0; i < size_t(StepStage::Count); i++)
+    {
+        std::vector<double> sorted(stepLatencySamples[i], stepLatencySamples[i] + n);
+        std::sort(sorted.begin(), sorted.end());
+        result += StringUtils::sprintf("STEP,%s,%u,%.3f,%.3f,%.3f,%.3f\n",
+                                       segmentNames[i],
+                                       unsigned(n),
+                                       sorted[size_t(0.50 * double(n - 1))],
+                                       sorted[size_t(0.90 * double(n - 1))],
+                                       sorted[size_t(0.99 * double(n - 1))],
+                                       sorted[n - 1]);
+    }
+    return result;
+}
+
+String PerfReport()
+{
+    auto ticksPerMs = perfTicksPerMs();
+    String result = "PERF,phase,hits,total ms,us/hit\n";
+    for(size_t i = 0; i < size_t(PerfPhase::Count); i++)
+    {
+        auto ticks = perfCounters[i].ticks.load(std::memory_order_relaxed);
+        auto hits = perfCounters[i].hits.load(std::memory_order_relaxed);
+        auto totalMs = ticksPerMs > 0.0 ? double(ticks) / ticksPerMs : 0.0;
+        auto usPerHit = hits ? totalMs * 1000.0 / double(hits) : 0.0;
+        result += StringUtils::sprintf("PERF,%s,%llu,%.3f,%.3f\n", perfPhaseNames[i], hits, totalMs, usPerHit);
+    }
+    return result;
+}
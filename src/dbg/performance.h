@@ -0,0 +1,71 @@
+#ifndef _PERFORMANCE_H
+#define _PERFORMANCE_H
+
+#include "_global.h"
+#include <atomic>
+#include <intrin.h>
+
+//Self-profiling phases, one slot per known hot path. Extend this enum and
+//the name table in performance.cpp together.
+enum class PerfPhase
+{
+    DebugEvent, //cbDebugEvent dispatch (cache flushes + plugin callbacks)
+    MemUpdateMap, //memory map enumeration
+    DbSave, //database serialization
+    SymbolLoad, //PDB symbol ingestion
+    Count
+};
+
+extern std::atomic<bool> perfEnabled;
+
+void PerfAdd(PerfPhase Phase, unsigned long long Ticks);
+void PerfClear();
+String PerfReport();
+
+//Stages of a single step command's journey through the pipeline:
+//GUI -> bridge (DbgCmdExec) -> message queue -> command loop -> TitanEngine
+//-> single-step debug event -> GUI update dispatch. Steps are serialized by
+//the debugger, so one in-flight record correlates the stamps; a new step
+//abandons an incomplete predecessor.
+enum class StepStage
+{
+    Enqueue, //step command entered the message queue (bridge boundary)
+    Dispatch, //command loop dequeued the command
+    Resume, //step armed, about to resume the target
+    Event, //single-step debug event arrived
+    GuiUpdate, //GUI refresh dispatched
+    Count
+};
+
+void StepLatencyBegin();
+void StepLatencyMark(StepStage Stage);
+void StepLatencyClear();
+String StepLatencyReport();
+
+//Scoped RDTSC marker around a hot path. While profiling is disabled (the
+//default) constructing one costs a single relaxed load; enabled it adds two
+//RDTSC reads and an atomic addition on destruction.
+class PerfScope
+{
+public:
+    explicit PerfScope(PerfPhase Phase)
+        : mPhase(Phase),
+          mActive(perfEnabled.load(std::memory_order_relaxed))
+    {
+        if(mActive)
+            mStart = __rdtsc();
+    }
+
+    ~PerfScope()
+    {
+        if(mActive)
+            PerfAdd(mPhase, __rdtsc() - mStart);
+    }
+
+private:
+    PerfPhase mPhase;
+    bool mActive;
+    unsigned long long mStart = 0;
+};
+
+#endif // _PERFORMANCE_H
@@ -10,7 +10,11 @@
 #include "threading.h"
 #include "expressionfunctions.h"
 #include "formatfunctions.h"
+#include "_exports.h"
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
 #include <shlwapi.h>
 
 /**
@@ -24,9 +28,9 @@ static std::vector<PLUG_DATA> pluginList;
 static std::wstring pluginDirectory;
 
 /**
-\brief The current plugin handle.
+\brief The current plugin handle (atomic because plugins initialize concurrently on startup).
 */
-static int curPluginHandle = 0;
+static std::atomic<int> curPluginHandle(0);
 
 /**
 \brief List of plugin callbacks.
@@ -58,125 +62,96 @@ static std::vector<PLUG_EXPRFUNCTION> pluginExprfunctionList;
 */
 static std::vector<PLUG_FORMATFUNCTION> pluginFormatfunctionList;
 
-static PLUG_DATA pluginData;
-
 /**
-\brief Loads a plugin from the plugin directory.
-\param pluginName Name of the plugin.
-\param loadall true on unload all.
-\return true if it succeeds, false if it fails.
+\brief Shared register dump cache for plugin subscriptions (LockPluginRegdumpCache).
 */
-bool pluginload(const char* pluginName, bool loadall)
-{
-    //no empty plugin names allowed
-    if(!pluginName)
-        return false;
-
-    char name[MAX_PATH] = "";
-    strncpy_s(name, pluginName, _TRUNCATE);
-
-    if(!loadall)
-#ifdef _WIN64
-        strncat_s(name, ".dp64", _TRUNCATE);
-#else
-        strncat_s(name, ".dp32", _TRUNCATE);
-#endif
-
-    wchar_t currentDir[deflen] = L"";
-    if(!loadall)
-    {
-        GetCurrentDirectoryW(deflen, currentDir);
-        SetCurrentDirectoryW(pluginDirectory.c_str());
-    }
-    char searchName[deflen] = "";
-#ifdef _WIN64
-    sprintf_s(searchName, "%s\\%s", StringUtils::Utf16ToUtf8(pluginDirectory.c_str()).c_str(), name);
-#else
-    sprintf_s(searchName, "%s\\%s", StringUtils::Utf16ToUtf8(pluginDirectory.c_str()).c_str(), name);
-#endif // _WIN64
+static std::unordered_set<int> pluginRegdumpCacheHandles;
+static int pluginRegdumpCacheNextHandle = 1;
+static REGDUMP pluginRegdumpCache;
+static unsigned int pluginRegdumpCacheGeneration = 0;
+static std::atomic<unsigned int> pluginRegdumpGeneration(1);
 
-    //Check to see if this plugin is already loaded
-    if(!loadall)
-    {
-        EXCLUSIVE_ACQUIRE(LockPluginList);
-        for(auto it = pluginList.begin(); it != pluginList.end(); ++it)
-        {
-            if(_stricmp(it->plugname, name) == 0 && it->isLoaded)
-            {
-                dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %s already loaded\n"), name);
-                SetCurrentDirectoryW(currentDir);
-                return false;
-            }
-        }
-    }
+/**
+\brief Plugins that are currently executing pluginit and are not in pluginList yet (LockPluginList).
+*/
+static std::vector<PLUG_DATA*> pluginLoadingList;
 
-    //check if the file exists
-    if(!loadall && !PathFileExistsW(StringUtils::Utf8ToUtf16(searchName).c_str()))
-    {
-        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] Cannot find plugin: %s\n"), name);
-        return false;
-    }
+static void pluginloadingremove(PLUG_DATA & pdata)
+{
+    EXCLUSIVE_ACQUIRE(LockPluginList);
+    pluginLoadingList.erase(std::remove(pluginLoadingList.begin(), pluginLoadingList.end(), &pdata), pluginLoadingList.end());
+}
 
-    //setup plugin data
-    memset(&pluginData, 0, sizeof(pluginData));
-    pluginData.initStruct.pluginHandle = curPluginHandle;
-    pluginData.hPlugin = LoadLibraryW(StringUtils::Utf8ToUtf16(searchName).c_str()); //load the plugin library
-    if(!pluginData.hPlugin)
+/**
+\brief Loads the plugin library and runs pluginit. Does not touch the GUI, so
+multiple plugins can run this concurrently on startup.
+\param pdata Plugin data, plugpath and plugname must be set.
+\return true if it succeeds, false if it fails.
+*/
+static bool plugininitload(PLUG_DATA & pdata)
+{
+    pdata.initStruct.pluginHandle = curPluginHandle++;
+    auto pluginHandle = pdata.initStruct.pluginHandle;
+    auto ticks = GetTickCount();
+    pdata.hPlugin = LoadLibraryW(StringUtils::Utf8ToUtf16(pdata.plugpath).c_str()); //load the plugin library
+    if(!pdata.hPlugin)
     {
-        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] Failed to load plugin: %s\n"), name);
-        SetCurrentDirectoryW(currentDir);
+        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] Failed to load plugin: %s\n"), pdata.plugname);
         return false;
     }
-    pluginData.pluginit = (PLUGINIT)GetProcAddress(pluginData.hPlugin, "pluginit");
-    if(!pluginData.pluginit)
+    pdata.pluginit = (PLUGINIT)GetProcAddress(pdata.hPlugin, "pluginit");
+    if(!pdata.pluginit)
     {
-        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] Export \"pluginit\" not found in plugin: %s\n"), name);
+        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] Export \"pluginit\" not found in plugin: %s\n"), pdata.plugname);
         for(int i = CB_INITDEBUG; i < CB_LAST; i++)
-            pluginunregistercallback(curPluginHandle, CBTYPE(i));
-        FreeLibrary(pluginData.hPlugin);
-        SetCurrentDirectoryW(currentDir);
+            pluginunregistercallback(pluginHandle, CBTYPE(i));
+        FreeLibrary(pdata.hPlugin);
         return false;
     }
-    pluginData.plugstop = (PLUGSTOP)GetProcAddress(pluginData.hPlugin, "plugstop");
-    pluginData.plugsetup = (PLUGSETUP)GetProcAddress(pluginData.hPlugin, "plugsetup");
+    pdata.plugstop = (PLUGSTOP)GetProcAddress(pdata.hPlugin, "plugstop");
+    pdata.plugsetup = (PLUGSETUP)GetProcAddress(pdata.hPlugin, "plugsetup");
 
-    strncpy_s(pluginData.plugpath, searchName, MAX_PATH);
-    strncpy_s(pluginData.plugname, name, MAX_PATH);
+    //make the plugin visible for handle lookups while pluginit runs
+    {
+        EXCLUSIVE_ACQUIRE(LockPluginList);
+        pluginLoadingList.push_back(&pdata);
+    }
 
     //init plugin
-    if(!pluginData.pluginit(&pluginData.initStruct))
+    if(!pdata.pluginit(&pdata.initStruct))
     {
-        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] pluginit failed for plugin: %s\n"), name);
+        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] pluginit failed for plugin: %s\n"), pdata.plugname);
+        pluginloadingremove(pdata);
         for(int i = CB_INITDEBUG; i < CB_LAST; i++)
-            pluginunregistercallback(curPluginHandle, CBTYPE(i));
-        FreeLibrary(pluginData.hPlugin);
-        SetCurrentDirectoryW(currentDir);
+            pluginunregistercallback(pluginHandle, CBTYPE(i));
+        FreeLibrary(pdata.hPlugin);
         return false;
     }
-    if(pluginData.initStruct.sdkVersion < PLUG_SDKVERSION) //the plugin SDK is not compatible
+    if(pdata.initStruct.sdkVersion < PLUG_SDKVERSION) //the plugin SDK is not compatible
     {
-        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %s is incompatible with this SDK version\n"), pluginData.initStruct.pluginName);
+        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %s is incompatible with this SDK version\n"), pdata.initStruct.pluginName);
+        pluginloadingremove(pdata);
         for(int i = CB_INITDEBUG; i < CB_LAST; i++)
-            pluginunregistercallback(curPluginHandle, CBTYPE(i));
-        FreeLibrary(pluginData.hPlugin);
-        SetCurrentDirectoryW(currentDir);
+            pluginunregistercallback(pluginHandle, CBTYPE(i));
+        FreeLibrary(pdata.hPlugin);
         return false;
     }
 
-    dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %s v%d Loaded!\n"), pluginData.initStruct.pluginName, pluginData.initStruct.pluginVersion);
+    pdata.initTime = GetTickCount() - ticks;
+    dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %s v%d Loaded in %ums!\n"), pdata.initStruct.pluginName, pdata.initStruct.pluginVersion, pdata.initTime);
 
     //auto-register callbacks for certain export names
-    auto cbPlugin = CBPLUGIN(GetProcAddress(pluginData.hPlugin, "CBALLEVENTS"));
+    auto cbPlugin = CBPLUGIN(GetProcAddress(pdata.hPlugin, "CBALLEVENTS"));
     if(cbPlugin)
     {
         for(int i = CB_INITDEBUG; i < CB_LAST; i++)
-            pluginregistercallback(curPluginHandle, CBTYPE(i), cbPlugin);
+            pluginregistercallback(pluginHandle, CBTYPE(i), cbPlugin);
     }
-    auto regExport = [](const char* exportname, CBTYPE cbType)
+    auto regExport = [&pdata, pluginHandle](const char* exportname, CBTYPE cbType)
     {
-        auto cbPlugin = CBPLUGIN(GetProcAddress(pluginData.hPlugin, exportname));
+        auto cbPlugin = CBPLUGIN(GetProcAddress(pdata.hPlugin, exportname));
         if(cbPlugin)
-            pluginregistercallback(curPluginHandle, cbType, cbPlugin);
+            pluginregistercallback(pluginHandle, cbType, cbPlugin);
     };
     regExport("CBINITDEBUG", CB_INITDEBUG);
     regExport("CBSTOPDEBUG", CB_STOPDEBUG);
@@ -210,16 +185,26 @@ bool pluginload(const char* pluginName, bool loadall)
     regExport("CBVALTOSTRING", CB_VALTOSTRING);
     regExport("CBMENUPREPARE", CB_MENUPREPARE);
 
+    return true;
+}
+
+/**
+\brief Assembles the plugin menus and runs plugsetup. Must be called on the
+loader thread after plugininitload succeeded.
+\param pdata Plugin data.
+*/
+static void pluginsetupgui(PLUG_DATA & pdata)
+{
     //add plugin menus
     {
         SectionLocker<LockPluginMenuList, false> menuLock; //exclusive lock
 
-        auto addPluginMenu = [](GUIMENUTYPE type)
+        auto addPluginMenu = [&pdata](GUIMENUTYPE type)
         {
-            int hNewMenu = GuiMenuAdd(type, pluginData.initStruct.pluginName);
+            int hNewMenu = GuiMenuAdd(type, pdata.initStruct.pluginName);
             if(hNewMenu == -1)
             {
-                dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] GuiMenuAdd(%d) failed for plugin: %s\n"), type, pluginData.initStruct.pluginName);
+                dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] GuiMenuAdd(%d) failed for plugin: %s\n"), type, pdata.initStruct.pluginName);
                 return -1;
             }
             else
@@ -227,43 +212,115 @@ bool pluginload(const char* pluginName, bool loadall)
                 PLUG_MENU newMenu;
                 newMenu.hEntryMenu = hNewMenu;
                 newMenu.hParentMenu = type;
-                newMenu.pluginHandle = pluginData.initStruct.pluginHandle;
+                newMenu.pluginHandle = pdata.initStruct.pluginHandle;
                 pluginMenuList.push_back(newMenu);
                 return newMenu.hEntryMenu;
             }
         };
 
-        pluginData.hMenu = addPluginMenu(GUI_PLUGIN_MENU);
-        pluginData.hMenuDisasm = addPluginMenu(GUI_DISASM_MENU);
-        pluginData.hMenuDump = addPluginMenu(GUI_DUMP_MENU);
-        pluginData.hMenuStack = addPluginMenu(GUI_STACK_MENU);
-        pluginData.hMenuGraph = addPluginMenu(GUI_GRAPH_MENU);
-        pluginData.hMenuMemmap = addPluginMenu(GUI_MEMMAP_MENU);
-        pluginData.hMenuSymmod = addPluginMenu(GUI_SYMMOD_MENU);
+        pdata.hMenu = addPluginMenu(GUI_PLUGIN_MENU);
+        pdata.hMenuDisasm = addPluginMenu(GUI_DISASM_MENU);
+        pdata.hMenuDump = addPluginMenu(GUI_DUMP_MENU);
+        pdata.hMenuStack = addPluginMenu(GUI_STACK_MENU);
+        pdata.hMenuGraph = addPluginMenu(GUI_GRAPH_MENU);
+        pdata.hMenuMemmap = addPluginMenu(GUI_MEMMAP_MENU);
+        pdata.hMenuSymmod = addPluginMenu(GUI_SYMMOD_MENU);
     }
 
-    //add the plugin to the list
+    //add the plugin to the list and retire the loading entry
     {
         SectionLocker<LockPluginList, false> pluginLock; //exclusive lock
-        pluginList.push_back(pluginData);
+        pluginList.push_back(pdata);
+        pluginLoadingList.erase(std::remove(pluginLoadingList.begin(), pluginLoadingList.end(), &pdata), pluginLoadingList.end());
     }
 
     //setup plugin
-    if(pluginData.plugsetup)
+    if(pdata.plugsetup)
     {
         PLUG_SETUPSTRUCT setupStruct;
         setupStruct.hwndDlg = GuiGetWindowHandle();
-        setupStruct.hMenu = pluginData.hMenu;
-        setupStruct.hMenuDisasm = pluginData.hMenuDisasm;
-        setupStruct.hMenuDump = pluginData.hMenuDump;
-        setupStruct.hMenuStack = pluginData.hMenuStack;
-        setupStruct.hMenuGraph = pluginData.hMenuGraph;
-        setupStruct.hMenuMemmap = pluginData.hMenuMemmap;
-        setupStruct.hMenuSymmod = pluginData.hMenuSymmod;
-        pluginData.plugsetup(&setupStruct);
+        setupStruct.hMenu = pdata.hMenu;
+        setupStruct.hMenuDisasm = pdata.hMenuDisasm;
+        setupStruct.hMenuDump = pdata.hMenuDump;
+        setupStruct.hMenuStack = pdata.hMenuStack;
+        setupStruct.hMenuGraph = pdata.hMenuGraph;
+        setupStruct.hMenuMemmap = pdata.hMenuMemmap;
+        setupStruct.hMenuSymmod = pdata.hMenuSymmod;
+        pdata.plugsetup(&setupStruct);
+    }
+    pdata.isLoaded = true;
+}
+
+/**
+\brief Loads a plugin from the plugin directory.
+\param pluginName Name of the plugin.
+\param loadall true on unload all.
+\return true if it succeeds, false if it fails.
+*/
+bool pluginload(const char* pluginName, bool loadall)
+{
+    //no empty plugin names allowed
+    if(!pluginName)
+        return false;
+
+    char name[MAX_PATH] = "";
+    strncpy_s(name, pluginName, _TRUNCATE);
+
+    if(!loadall)
+#ifdef _WIN64
+        strncat_s(name, ".dp64", _TRUNCATE);
+#else
+        strncat_s(name, ".dp32", _TRUNCATE);
+#endif
+
+    wchar_t currentDir[deflen] = L"";
+    if(!loadall)
+    {
+        GetCurrentDirectoryW(deflen, currentDir);
+        SetCurrentDirectoryW(pluginDirectory.c_str());
+    }
+    char searchName[deflen] = "";
+#ifdef _WIN64
+    sprintf_s(searchName, "%s\\%s", StringUtils::Utf16ToUtf8(pluginDirectory.c_str()).c_str(), name);
+#else
+    sprintf_s(searchName, "%s\\%s", StringUtils::Utf16ToUtf8(pluginDirectory.c_str()).c_str(), name);
+#endif // _WIN64
+
+    //Check to see if this plugin is already loaded
+    if(!loadall)
+    {
+        EXCLUSIVE_ACQUIRE(LockPluginList);
+        for(auto it = pluginList.begin(); it != pluginList.end(); ++it)
+        {
+            if(_stricmp(it->plugname, name) == 0 && it->isLoaded)
+            {
+                dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %s already loaded\n"), name);
+                SetCurrentDirectoryW(currentDir);
+                return false;
+            }
+        }
     }
-    pluginData.isLoaded = true;
-    curPluginHandle++;
+
+    //check if the file exists
+    if(!loadall && !PathFileExistsW(StringUtils::Utf8ToUtf16(searchName).c_str()))
+    {
+        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] Cannot find plugin: %s\n"), name);
+        return false;
+    }
+
+    //setup plugin data
+    PLUG_DATA pdata;
+    memset(&pdata, 0, sizeof(pdata));
+    strncpy_s(pdata.plugpath, searchName, MAX_PATH);
+    strncpy_s(pdata.plugname, name, MAX_PATH);
+
+    if(!plugininitload(pdata))
+    {
+        if(!loadall)
+            SetCurrentDirectoryW(currentDir);
+        return false;
+    }
+    pluginsetupgui(pdata);
 
     if(!loadall)
         SetCurrentDirectoryW(currentDir);
@@ -375,12 +432,47 @@ void pluginloadall(const char* pluginDir)
         SetCurrentDirectoryW(currentDir);
         return;
     }
+    std::vector<PLUG_DATA> plugins;
     do
     {
-        pluginload(StringUtils::Utf16ToUtf8(foundData.cFileName).c_str(), true);
+        PLUG_DATA pdata;
+        memset(&pdata, 0, sizeof(pdata));
+        auto name = StringUtils::Utf16ToUtf8(foundData.cFileName);
+        char path[deflen] = "";
+        sprintf_s(path, "%s\\%s", pluginDir, name.c_str());
+        strncpy_s(pdata.plugpath, path, MAX_PATH);
+        strncpy_s(pdata.plugname, name.c_str(), MAX_PATH);
+        plugins.push_back(pdata);
     }
     while(FindNextFileW(hSearch, &foundData));
     FindClose(hSearch);
+
+    //run the library loads and pluginit calls on a small pool (the plugins
+    //have no way to express dependencies on each other, so they are treated
+    //as independent), then assemble the menus and run plugsetup on this
+    //thread in directory order once all of them passed the barrier
+    auto ticks = GetTickCount();
+    std::vector<char> initialized(plugins.size(), 0);
+    std::atomic<size_t> nextPlugin(0);
+    auto initWorker = [&plugins, &initialized, &nextPlugin]()
+    {
+        for(auto i = nextPlugin++; i < plugins.size(); i = nextPlugin++)
+            initialized[i] = plugininitload(plugins[i]);
+    };
+    size_t threadCount = min(size_t(4), plugins.size());
+    std::vector<std::thread> initPool;
+    for(size_t i = 1; i < threadCount; i++)
+        initPool.emplace_back(initWorker);
+    initWorker();
+    for(auto & thread : initPool)
+        thread.join();
+
+    for(size_t i = 0; i < plugins.size(); i++)
+        if(initialized[i])
+            pluginsetupgui(plugins[i]);
+    if(plugins.size() > 1)
+        dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN] %d plugins initialized in %ums\n"), int(plugins.size()), GetTickCount() - ticks);
+
     SetCurrentDirectoryW(currentDir);
 }
 
@@ -511,6 +603,18 @@ bool pluginunregistercallback(int pluginHandle, CBTYPE cbType)
 */
 void plugincbcall(CBTYPE cbType, void* callbackInfo)
 {
+    switch(cbType)
+    {
+    //the debuggee (re)gained control of the CPU, cached register snapshots are stale
+    case CB_STEPPED:
+    case CB_PAUSEDEBUG:
+    case CB_RESUMEDEBUG:
+    case CB_DEBUGEVENT:
+        pluginregdumpcacheinvalidate();
+        break;
+    default:
+        break;
+    }
     if(pluginCallbackList[cbType].empty())
         return;
     SHARED_ACQUIRE(LockPluginCallbackList);
@@ -533,10 +637,13 @@ bool plugincbempty(CBTYPE cbType)
 static bool findPluginName(int pluginHandle, String & name)
 {
     SHARED_ACQUIRE(LockPluginList);
-    if(pluginData.initStruct.pluginHandle == pluginHandle)
+    for(auto plugin : pluginLoadingList) //plugins still inside pluginit
     {
-        name = pluginData.initStruct.pluginName;
-        return true;
+        if(plugin->initStruct.pluginHandle == pluginHandle)
+        {
+            name = plugin->initStruct.pluginName;
+            return true;
+        }
     }
     for(auto & plugin : pluginList)
     {
@@ -1070,3 +1177,42 @@ beach:
     dprintf(QT_TRANSLATE_NOOP("DBG", "[PLUGIN, %s] Format function \"%s\" failed to unregister...\n"), plugName.c_str(), type);
     return false;
 }
+
+int pluginregdumpcachecreate()
+{
+    EXCLUSIVE_ACQUIRE(LockPluginRegdumpCache);
+    auto hCache = pluginRegdumpCacheNextHandle++;
+    pluginRegdumpCacheHandles.insert(hCache);
+    return hCache;
+}
+
+bool pluginregdumpcacheget(int hCache, REGDUMP* regdump)
+{
+    if(!regdump)
+        return false;
+    EXCLUSIVE_ACQUIRE(LockPluginRegdumpCache);
+    if(pluginRegdumpCacheHandles.find(hCache) == pluginRegdumpCacheHandles.end())
+        return false;
+    //the register dump is per-process state, so all subscriptions share one cached
+    //copy that is refetched lazily after the generation counter was bumped
+    auto generation = pluginRegdumpGeneration.load();
+    if(pluginRegdumpCacheGeneration != generation)
+    {
+        if(!_dbg_getregdump(&pluginRegdumpCache))
+            return false;
+        pluginRegdumpCacheGeneration = generation;
+    }
+    memcpy(regdump, &pluginRegdumpCache, sizeof(REGDUMP));
+    return true;
+}
+
+bool pluginregdumpcachefree(int hCache)
+{
+    EXCLUSIVE_ACQUIRE(LockPluginRegdumpCache);
+    return pluginRegdumpCacheHandles.erase(hCache) != 0;
+}
+
+void pluginregdumpcacheinvalidate()
+{
+    pluginRegdumpGeneration++;
+}
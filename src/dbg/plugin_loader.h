@@ -38,6 +38,7 @@ struct PLUG_DATA
     int hMenuGraph;
     int hMenuMemmap;
     int hMenuSymmod;
+    DWORD initTime; //milliseconds spent in LoadLibrary and pluginit
     PLUG_INITSTRUCT initStruct;
 };
 
@@ -101,5 +102,9 @@ bool pluginexprfuncregister(int pluginHandle, const char* name, int argc, CBPLUG
 bool pluginexprfuncunregister(int pluginHandle, const char* name);
 bool pluginformatfuncregister(int pluginHandle, const char* type, CBPLUGINFORMATFUNCTION cbFunction, void* userdata);
 bool pluginformatfuncunregister(int pluginHandle, const char* type);
+int pluginregdumpcachecreate();
+bool pluginregdumpcacheget(int hCache, REGDUMP* regdump);
+bool pluginregdumpcachefree(int hCache);
+void pluginregdumpcacheinvalidate();
 
 #endif // _PLUGIN_LOADER_H
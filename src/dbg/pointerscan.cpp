@@ -0,0 +1,129 @@
+/**
+ @file pointerscan.cpp
+
+ @brief Implements the multi-threaded pointer chain scanner.
+*/
+
+#include "pointerscan.h"
+#include "memory.h"
+#include "module.h"
+#include "threading.h"
+#include <ppl.h>
+#include <unordered_set>
+
+struct PointerRecord
+{
+    duint value; //pointer-sized value stored at location
+    duint location; //virtual address the value was read from
+};
+
+bool PointerScan(duint Target, int MaxDepth, duint MaxOffset, duint MaxResults, std::vector<PointerChain> & Chains)
+{
+    Chains.clear();
+
+    //snapshot the committed pages and the address range they span
+    std::vector<SimplePage> pages;
+    duint rangeStart = -1, rangeEnd = 0;
+    SHARED_ACQUIRE(LockMemoryPages);
+    for(auto & itr : memoryPages)
+    {
+        const auto & mbi = itr.second.mbi;
+        if(mbi.State != MEM_COMMIT)
+            continue;
+        if(mbi.Protect & (PAGE_NOACCESS | PAGE_GUARD))
+            continue;
+        SimplePage page(duint(mbi.BaseAddress), mbi.RegionSize);
+        rangeStart = std::min(rangeStart, page.address);
+        rangeEnd = std::max(rangeEnd, page.address + page.size);
+        pages.push_back(page);
+    }
+    SHARED_RELEASE();
+    if(pages.empty())
+        return false;
+
+    //build the pointer-value index in parallel, one bucket per page so no
+    //synchronization is needed while scanning
+    std::vector<std::vector<PointerRecord>> pageRecords(pages.size());
+    concurrency::parallel_for(size_t(0), pages.size(), [&](size_t i)
+    {
+        const auto & page = pages.at(i);
+        Memory<unsigned char*> data(page.size, "PointerScan:data");
+        if(!MemRead(page.address, data(), page.size))
+            return;
+        auto & records = pageRecords.at(i);
+        for(duint offset = 0; offset + sizeof(duint) <= page.size; offset += sizeof(duint))
+        {
+            auto value = *(duint*)(data() + offset);
+            if(value >= rangeStart && value < rangeEnd)
+                records.push_back({ value, page.address + offset });
+        }
+    });
+
+    size_t total = 0;
+    for(const auto & records : pageRecords)
+        total += records.size();
+    std::vector<PointerRecord> index;
+    index.reserve(total);
+    for(auto & records : pageRecords)
+        index.insert(index.end(), records.begin(), records.end());
+    pageRecords.clear();
+    concurrency::parallel_sort(index.begin(), index.end(), [](const PointerRecord & a, const PointerRecord & b)
+    {
+        return a.value < b.value;
+    });
+
+    //breadth-first search backwards from the target: every level joins the
+    //frontier against the sorted index with binary searches, stopping a
+    //branch as soon as it reaches a module (static) location
+    struct Node
+    {
+        duint location;
+        duint offset;
+        int parent; //index into nodes, -1 for links that reach the target
+    };
+    std::vector<Node> nodes;
+    std::vector<std::pair<duint, int>> frontier; //searched-for address + pointing node
+    frontier.emplace_back(Target, -1);
+    std::unordered_set<duint> visited;
+    visited.insert(Target);
+
+    for(int depth = 0; depth < MaxDepth && !frontier.empty() && duint(Chains.size()) < MaxResults; depth++)
+    {
+        std::vector<std::vector<Node>> found(frontier.size());
+        concurrency::parallel_for(size_t(0), frontier.size(), [&](size_t i)
+        {
+            auto target = frontier.at(i).first;
+            auto parent = frontier.at(i).second;
+            auto from = target < MaxOffset ? 0 : target - MaxOffset;
+            auto itr = std::lower_bound(index.begin(), index.end(), from, [](const PointerRecord & record, duint value)
+            {
+                return record.value < value;
+            });
+            for(; itr != index.end() && itr->value <= target; ++itr)
+                found.at(i).push_back({ itr->location, target - itr->value, parent });
+        });
+
+        std::vector<std::pair<duint, int>> nextFrontier;
+        for(auto & levelNodes : found)
+        {
+            for(const auto & node : levelNodes)
+            {
+                if(duint(Chains.size()) >= MaxResults)
+                    break;
+                auto nodeIdx = int(nodes.size());
+                nodes.push_back(node);
+                if(ModBaseFromAddr(node.location)) //static location, chain complete
+                {
+                    PointerChain chain;
+                    for(int link = nodeIdx; link != -1; link = nodes.at(link).parent)
+                        chain.push_back({ nodes.at(link).location, nodes.at(link).offset });
+                    Chains.push_back(std::move(chain));
+                }
+                else if(depth + 1 < MaxDepth && visited.insert(node.location).second)
+                    nextFrontier.emplace_back(node.location, nodeIdx);
+            }
+        }
+        frontier = std::move(nextFrontier);
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef _POINTERSCAN_H
+#define _POINTERSCAN_H
+
+#include "_global.h"
+
+struct PointerChainLink
+{
+    duint location; //virtual address the pointer value was read from
+    duint offset; //added to the pointed-to value to reach the next link
+};
+
+//A chain is ordered root-first: the first link lives inside a module, and
+//dereferencing each link's location plus its offset yields the next link's
+//location (the last link yields the scanned target).
+typedef std::vector<PointerChainLink> PointerChain;
+
+//Scan all committed memory for pointer chains that lead from a static
+//(module) address to Target. The pointer-value index is built and joined in
+//parallel; MaxOffset bounds the allowed displacement per link and MaxDepth
+//the chain length. Returns false when there is no memory to scan.
+bool PointerScan(duint Target, int MaxDepth, duint MaxOffset, duint MaxResults, std::vector<PointerChain> & Chains);
+
+#endif // _POINTERSCAN_H
@@ -9,6 +9,60 @@
 #include "console.h"
 #include "module.h"
 #include "threading.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <ppl.h>
+
+// Row accumulator for the reference view. Producers run serialized (the
+// parallel disassembly path locks around its callback), so no lock is needed
+// here.
+static std::vector<String> refRowCells;
+static int refRowCols = 0;
+static const size_t refRowFlushCount = 0x1000; //rows per block sent to the GUI
+
+// When set, rows are buffered here instead of going to the GUI accumulator.
+// The parallel scan in RefFindInRange uses this to collect each chunk's rows
+// separately and commit them in address order afterwards. Only written under
+// the scan's callback mutex.
+static std::vector<String>* refRowRedirect = nullptr;
+static int refRowRedirectCols = 0;
+
+void RefAddRow(int cols, const char* const* cells)
+{
+    if(refRowRedirect)
+    {
+        refRowRedirectCols = cols;
+        for(int i = 0; i < cols; i++)
+            refRowRedirect->push_back(cells[i]);
+        return;
+    }
+    if(refRowCols != cols)
+    {
+        RefFlushRows();
+        refRowCols = cols;
+    }
+    for(int i = 0; i < cols; i++)
+        refRowCells.push_back(cells[i]);
+    if(refRowCells.size() >= refRowFlushCount * refRowCols)
+        RefFlushRows();
+}
+
+void RefFlushRows()
+{
+    if(refRowCells.empty())
+        return;
+    std::vector<const char*> cells;
+    cells.reserve(refRowCells.size());
+    for(const auto & cell : refRowCells)
+        cells.push_back(cell.c_str());
+    REFROWBATCH batch;
+    batch.count = int(refRowCells.size()) / refRowCols;
+    batch.cols = refRowCols;
+    batch.cells = cells.data();
+    GuiReferenceAddRows(&batch);
+    refRowCells.clear();
+}
 
 /**
 @brief RefFind Find reference to the buffer by a given criterion.
@@ -58,9 +112,9 @@ int RefFind(duint Address, duint Size, CBREF Callback, void* UserData, bool Sile
 
         // Determine the full module name
         if(ModNameFromAddr(scanStart, moduleName, true))
-            sprintf_s(fullName, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "%s (Region %s)")), Name, moduleName);
+            sprintf_s(fullName, dtranslate(QT_TRANSLATE_NOOP("DBG", "%s (Region %s)")), Name, moduleName);
         else
-            sprintf_s(fullName, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "%s (Region %p)")), Name, scanStart);
+            sprintf_s(fullName, dtranslate(QT_TRANSLATE_NOOP("DBG", "%s (Region %p)")), Name, scanStart);
 
         // Initialize disassembler
         Zydis cp;
@@ -72,7 +126,7 @@ int RefFind(duint Address, duint Size, CBREF Callback, void* UserData, bool Sile
 
         RefFindInRange(scanStart, scanSize, Callback, UserData, Silent, refInfo, cp, true, [](int percent)
         {
-            GuiReferenceSetCurrentTaskProgress(percent, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Region Search")));
+            GuiReferenceSetCurrentTaskProgress(percent, dtranslate(QT_TRANSLATE_NOOP("DBG", "Region Search")));
             GuiReferenceSetProgress(percent);
         }, disasmText);
     }
@@ -113,7 +167,7 @@ int RefFind(duint Address, duint Size, CBREF Callback, void* UserData, bool Sile
 
         RefFindInRange(scanStart, scanSize, Callback, UserData, Silent, refInfo, cp, true, [](int percent)
         {
-            GuiReferenceSetCurrentTaskProgress(percent, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Module Search")));
+            GuiReferenceSetCurrentTaskProgress(percent, dtranslate(QT_TRANSLATE_NOOP("DBG", "Module Search")));
             GuiReferenceSetProgress(percent);
         }, disasmText);
     }
@@ -150,7 +204,7 @@ int RefFind(duint Address, duint Size, CBREF Callback, void* UserData, bool Sile
         Zydis cp;
 
         // Determine the full module
-        sprintf_s(fullName, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "All Modules (%s)")), Name);
+        sprintf_s(fullName, dtranslate(QT_TRANSLATE_NOOP("DBG", "All Modules (%s)")), Name);
 
         // Allow an "initialization" notice
         refInfo.refcount = 0;
@@ -180,6 +234,7 @@ int RefFind(duint Address, duint Size, CBREF Callback, void* UserData, bool Sile
     else
         return 0;
 
+    RefFlushRows();
     GuiReferenceSetProgress(100);
     GuiReferenceReloadData();
     return refInfo.refcount;
@@ -196,6 +251,73 @@ int RefFindInRange(duint scanStart, duint scanSize, CBREF Callback, void* UserDa
     if(initCallBack)
         Callback(0, 0, &refInfo);
 
+    // Large buffers are disassembled in parallel chunks, each worker with its
+    // own Zydis instance. The callback stays serialized behind a lock; its
+    // rows are redirected into a per-chunk buffer and committed in chunk
+    // order below, so the reference view stays sorted by address even though
+    // the chunks finish out of order. Only the (dominant) decode cost is
+    // spread over the cores.
+    const duint chunkSize = 0x40000;
+    if(scanSize >= chunkSize * 2 && std::thread::hardware_concurrency() > 1)
+    {
+        duint chunkCount = (scanSize + chunkSize - 1) / chunkSize;
+        std::vector<std::vector<String>> chunkRows(chunkCount);
+        std::mutex callbackMutex;
+        std::atomic<duint> processed(0);
+        concurrency::parallel_for(duint(0), chunkCount, [&](duint c)
+        {
+            duint chunkStart = c * chunkSize;
+            duint chunkEnd = min(chunkStart + chunkSize, scanSize);
+            // Start decoding early so the disassembler can self-synchronize
+            // across the chunk boundary (same variance trick as LinearPass)
+            duint decodeStart = chunkStart >= 256 ? chunkStart - 256 : 0;
+            Zydis chunkCp;
+            for(duint i = decodeStart; i < chunkEnd;)
+            {
+                int disasmMaxSize = min(MAX_DISASM_BUFFER, (int)(scanSize - i));
+                int disasmLen = 1;
+                if(chunkCp.Disassemble(scanStart + i, data() + i, disasmMaxSize))
+                {
+                    disasmLen = chunkCp.Size();
+                    if(i >= chunkStart) //instructions before the chunk are only decoded for synchronization
+                    {
+                        BASIC_INSTRUCTION_INFO basicinfo;
+                        fillbasicinfo(&chunkCp, &basicinfo, disasmText);
+
+                        std::lock_guard<std::mutex> lock(callbackMutex);
+                        refRowRedirect = &chunkRows[c];
+                        if(Callback(&chunkCp, &basicinfo, &refInfo))
+                            refInfo.refcount++;
+                        refRowRedirect = nullptr;
+                    }
+                }
+                i += disasmLen;
+            }
+
+            auto done = processed += chunkEnd - chunkStart;
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            cbUpdateProgress((int)floor(((float)done / (float)scanSize) * 100.0f));
+        });
+
+        // Commit the buffered rows in chunk order to restore address order
+        for(duint c = 0; c < chunkCount; c++)
+        {
+            const auto & rows = chunkRows[c];
+            if(rows.empty())
+                continue;
+            std::vector<const char*> cells(refRowRedirectCols);
+            for(size_t r = 0; r + refRowRedirectCols <= rows.size(); r += refRowRedirectCols)
+            {
+                for(int col = 0; col < refRowRedirectCols; col++)
+                    cells[col] = rows[r + col].c_str();
+                RefAddRow(refRowRedirectCols, cells.data());
+            }
+        }
+
+        cbUpdateProgress(100);
+        return refInfo.refcount;
+    }
+
     auto percentCount = scanSize / 500;
 
     //concurrency::parallel_for(duint (0), scanSize, [&](duint i)
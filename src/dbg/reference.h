@@ -26,4 +26,12 @@ typedef std::function<void(int)> CBPROGRESS;
 int RefFind(duint Address, duint Size, CBREF Callback, void* UserData, bool Silent, const char* Name, REFFINDTYPE type, bool disasmText);
 int RefFindInRange(duint scanStart, duint scanSize, CBREF Callback, void* UserData, bool Silent, REFINFO & refInfo, Zydis & cp, bool initCallBack, const CBPROGRESS & cbUpdateProgress, bool disasmText);
 
+// Batched row output for search result producers: rows accumulate in a buffer
+// and are appended to the reference view in blocks of a few thousand, one
+// bridge call per block instead of one per cell. Callers append rows with
+// RefAddRow and must call RefFlushRows when done (RefFind does this for its
+// callbacks).
+void RefAddRow(int cols, const char* const* cells);
+void RefFlushRows();
+
 #endif // _REFERENCE_H
\ No newline at end of file
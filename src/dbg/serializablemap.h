@@ -6,6 +6,9 @@
 #include "module.h"
 #include "memory.h"
 #include "jansson/jansson_x64dbg.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 template<class TValue>
 class JSONWrapper
@@ -105,6 +108,7 @@ class SerializableTMap
     static_assert(std::is_base_of<JSONWrapper<TValue>, TSerializer>::value, "TSerializer is not derived from JSONWrapper<TValue>");
 public:
     using TValuePred = std::function<bool(const TValue & value)>;
+    using SnapshotPtr = std::shared_ptr<const TMap>;
 
     virtual ~SerializableTMap()
     {
@@ -113,14 +117,30 @@ public:
     bool Add(const TValue & value)
     {
         EXCLUSIVE_ACQUIRE(TLock);
-        return addNoLock(value);
+        auto result = addNoLock(value);
+        invalidateIndex();
+        invalidateSnapshot();
+        return result;
+    }
+
+    //Insert a whole batch with a single lock acquisition and one snapshot
+    //invalidation, instead of paying both per value
+    void AddRange(const std::vector<TValue> & values)
+    {
+        if(values.empty())
+            return;
+        EXCLUSIVE_ACQUIRE(TLock);
+        for(const auto & value : values)
+            addNoLock(value);
+        invalidateIndex();
+        invalidateSnapshot();
     }
 
     bool Get(const TKey & key, TValue & value) const
     {
-        SHARED_ACQUIRE(TLock);
-        auto found = mMap.find(key);
-        if(found == mMap.end())
+        auto snapshot = GetSnapshot();
+        auto found = snapshot->find(key);
+        if(found == snapshot->end())
             return false;
         value = found->second;
         return true;
@@ -128,14 +148,20 @@ public:
 
     bool Contains(const TKey & key) const
     {
-        SHARED_ACQUIRE(TLock);
-        return mMap.count(key) > 0;
+        auto snapshot = GetSnapshot();
+        return snapshot->count(key) > 0;
     }
 
     bool Delete(const TKey & key)
     {
         EXCLUSIVE_ACQUIRE(TLock);
-        return mMap.erase(key) > 0;
+        auto result = mMap.erase(key) > 0;
+        if(result)
+        {
+            invalidateIndex();
+            invalidateSnapshot();
+        }
+        return result;
     }
 
     void DeleteWhere(TValuePred predicate)
@@ -148,6 +174,27 @@ public:
             else
                 ++itr;
         }
+        invalidateIndex();
+        invalidateSnapshot();
+    }
+
+    //Copy-on-write snapshot of the map. Writers invalidate the published
+    //pointer and the next reader clones the map once under the lock; after
+    //that rendering and autosave share the immutable copy without taking
+    //the lock at all, so DbSave no longer stalls the debug loop.
+    SnapshotPtr GetSnapshot() const
+    {
+        auto snapshot = std::atomic_load(&mSnapshot);
+        if(snapshot)
+            return snapshot;
+        EXCLUSIVE_ACQUIRE(TLock);
+        snapshot = std::atomic_load(&mSnapshot);
+        if(!snapshot)
+        {
+            snapshot = std::make_shared<const TMap>(mMap);
+            std::atomic_store(&mSnapshot, snapshot);
+        }
+        return snapshot;
     }
 
     bool GetWhere(TValuePred predicate, TValue & value)
@@ -165,14 +212,17 @@ public:
         EXCLUSIVE_ACQUIRE(TLock);
         TMap empty;
         std::swap(mMap, empty);
+        invalidateIndex();
+        invalidateSnapshot();
     }
 
     void CacheSave(JSON root) const
     {
-        SHARED_ACQUIRE(TLock);
+        //serialize from the immutable snapshot so the JSON work runs without the lock
+        auto snapshot = GetSnapshot();
         auto jsonValues = json_array();
         TSerializer serializer;
-        for(const auto & itr : mMap)
+        for(const auto & itr : *snapshot)
         {
             auto jsonValue = json_object();
             serializer.SetJson(jsonValue);
@@ -201,14 +251,16 @@ public:
             if(deserializer.Load(value))
                 addNoLock(value);
         }
+        invalidateIndex();
+        invalidateSnapshot();
     }
 
     void GetList(std::vector<TValue> & values) const
     {
-        SHARED_ACQUIRE(TLock);
+        auto snapshot = GetSnapshot();
         values.clear();
-        values.reserve(mMap.size());
-        for(const auto & itr : mMap)
+        values.reserve(snapshot->size());
+        for(const auto & itr : *snapshot)
             values.push_back(itr.second);
     }
 
@@ -216,14 +268,14 @@ public:
     {
         if(!list && !size)
             return false;
-        SHARED_ACQUIRE(TLock);
+        auto snapshot = GetSnapshot();
         if(size)
         {
-            *size = mMap.size() * sizeof(TValue);
+            *size = snapshot->size() * sizeof(TValue);
             if(!list)
                 return true;
         }
-        for(auto & itr : mMap)
+        for(auto & itr : *snapshot)
         {
             *list = itr.second;
             AdjustValue(*list);
@@ -243,6 +295,14 @@ public:
     }
 
     TMap & GetDataUnsafe()
+    {
+        //the caller can mutate the map behind our back (XrefAddMulti), so the
+        //published snapshot cannot be trusted anymore
+        invalidateSnapshot();
+        return mMap;
+    }
+
+    const TMap & GetDataUnsafe() const
     {
         return mMap;
     }
@@ -253,8 +313,22 @@ protected:
     virtual const char* jsonKey() const = 0;
     virtual TKey makeKey(const TValue & value) const = 0;
 
+    //Called with the exclusive lock held whenever the map changed, so
+    //derived classes can maintain a secondary lookup index
+    virtual void invalidateIndex() const
+    {
+    }
+
 private:
     TMap mMap;
+    mutable SnapshotPtr mSnapshot;
+
+    //Called with the exclusive lock held whenever the map changed; the next
+    //GetSnapshot call clones the new state
+    void invalidateSnapshot()
+    {
+        std::atomic_store(&mSnapshot, SnapshotPtr());
+    }
 
     bool addNoLock(const TValue & value)
     {
@@ -291,6 +365,58 @@ struct SerializableModuleRangeMap : SerializableMap<TLock, ModuleRange, TValue,
         auto moduleBase = ModBaseFromAddr(start);
         return ModuleRange(ModHashFromAddr(moduleBase), Range(start - moduleBase, end - moduleBase));
     }
+
+    //Stabbing query against a flattened copy of the map. The disassembly view
+    //asks for the range at every visible address and with six figures of
+    //auto-analysis ranges the pointer chasing of the node-based map shows up
+    //in rendering; the sorted vector gives the same O(log n) bound with
+    //contiguous probes. The copy is rebuilt lazily after the map changed, so
+    //bulk insertion during analysis stays cheap.
+    bool GetIndexed(const ModuleRange & key, TValue & value) const
+    {
+        {
+            SHARED_ACQUIRE(TLock);
+            if(!mIndexDirty)
+                return findIndexed(key, value);
+        }
+        EXCLUSIVE_ACQUIRE(TLock);
+        if(mIndexDirty)
+        {
+            const auto & map = this->GetDataUnsafe();
+            mIndex.assign(map.begin(), map.end());
+            mIndexDirty = false;
+        }
+        return findIndexed(key, value);
+    }
+
+    bool ContainsIndexed(const ModuleRange & key) const
+    {
+        TValue value;
+        return GetIndexed(key, value);
+    }
+
+protected:
+    void invalidateIndex() const override
+    {
+        mIndexDirty = true;
+    }
+
+private:
+    mutable std::vector<std::pair<ModuleRange, TValue>> mIndex;
+    mutable bool mIndexDirty = true;
+
+    bool findIndexed(const ModuleRange & key, TValue & value) const
+    {
+        ModuleRangeCompare comp;
+        auto found = std::lower_bound(mIndex.begin(), mIndex.end(), key, [&comp](const std::pair<ModuleRange, TValue> & a, const ModuleRange & b)
+        {
+            return comp(a.first, b);
+        });
+        if(found == mIndex.end() || comp(key, found->first))
+            return false;
+        value = found->second;
+        return true;
+    }
 };
 
 template<SectionLock TLock, class TValue, class TSerializer>
@@ -19,7 +19,33 @@ enum CMDRESULT
     STATUS_PAUSE = 3
 };
 
+//Precompiled form of a script line: the line type and internal commands are
+//classified once, branch destinations are resolved and command arguments are
+//parsed at load time, so the run loop doesn't redo the string work on every
+//step (scripts can loop over the same lines hundreds of thousands of times).
+enum SCRIPTCOMPILEDTYPE
+{
+    compiledskip, //empty line, comment or label
+    compiledret,
+    compilederror,
+    compiledinvalid,
+    compiledpause,
+    compilednop,
+    compiledbranch,
+    compiledcommands,
+};
+
+struct SCRIPTCOMPILEDLINE
+{
+    SCRIPTCOMPILEDTYPE type = compiledskip;
+    SCRIPTBRANCHTYPE branchtype = scriptnobranch;
+    int branchdest = 0; //first command after the branch label
+    bool log = false; //line starts with the "log" command
+    std::vector<PARSEDCOMMAND> commands; //pre-parsed commands for compiledcommands
+};
+
 static std::vector<LINEMAPENTRY> linemap;
+static std::vector<SCRIPTCOMPILEDLINE> compiledmap;
 static std::vector<SCRIPTBP> scriptbplist;
 static std::vector<int> scriptstack;
 static int scriptIp = 0;
@@ -94,62 +120,35 @@ static bool scriptisinternalcommand(const char* text, const char* cmd)
 
 static bool scriptcreatelinemap(const char* filename)
 {
-    String filedata;
-    if(!FileHelper::ReadAllText(filename, filedata))
-    {
-        String TranslatedString = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "FileHelper::ReadAllText failed..."));
-        GuiScriptError(0, TranslatedString.c_str());
-        return false;
-    }
-    auto len = filedata.length();
-    char temp[256] = "";
-    LINEMAPENTRY entry;
-    memset(&entry, 0, sizeof(entry));
     linemap.clear();
-    for(size_t i = 0, j = 0; i < len; i++) //make raw line map
-    {
-        if(filedata[i] == '\r' && filedata[i + 1] == '\n') //windows file
-        {
-            memset(&entry, 0, sizeof(entry));
-            int add = 0;
-            while(isspace(temp[add]))
-                add++;
-            strcpy_s(entry.raw, temp + add);
-            *temp = 0;
-            j = 0;
-            i++;
-            linemap.push_back(entry);
-        }
-        else if(filedata[i] == '\n') //other file
-        {
-            memset(&entry, 0, sizeof(entry));
-            int add = 0;
-            while(isspace(temp[add]))
-                add++;
-            strcpy_s(entry.raw, temp + add);
-            *temp = 0;
-            j = 0;
-            linemap.push_back(entry);
-        }
-        else if(j >= 254)
-        {
-            memset(&entry, 0, sizeof(entry));
-            int add = 0;
-            while(isspace(temp[add]))
-                add++;
-            strcpy_s(entry.raw, temp + add);
-            *temp = 0;
-            j = 0;
-            linemap.push_back(entry);
-        }
-        else
-            j += sprintf_s(temp + j, sizeof(temp) - j, "%c", filedata[i]);
-    }
-    if(*temp)
+    //make the raw line map from views into the mapped file, without
+    //materializing the script contents first
+    auto appendRaw = [](const char* str, size_t len)
     {
+        LINEMAPENTRY entry;
         memset(&entry, 0, sizeof(entry));
-        strcpy_s(entry.raw, temp);
+        while(len && isspace((unsigned char)*str)) //trim leading whitespace
+            str++, len--;
+        memcpy(entry.raw, str, len);
         linemap.push_back(entry);
+    };
+    if(!FileHelper::ReadLinesMapped(filename, [&appendRaw](const char* line, size_t length)
+{
+    //the raw storage is limited, overlong lines continue in the next entry
+    do
+    {
+        auto chunk = length < sizeof(LINEMAPENTRY::raw) - 2 ? length : sizeof(LINEMAPENTRY::raw) - 2;
+        appendRaw(line, chunk);
+        line += chunk;
+        length -= chunk;
+    }
+    while(length);
+    return true;
+}))
+    {
+        String TranslatedString = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "FileHelper::ReadAllText failed..."));
+        GuiScriptError(0, TranslatedString.c_str());
+        return false;
     }
     int linemapsize = (int)linemap.size();
     while(linemapsize && !*linemap.at(linemapsize - 1).raw) //remove empty lines from the end
@@ -320,6 +319,47 @@ static bool scriptcreatelinemap(const char* filename)
     return true;
 }
 
+static void scriptcompile() //compile the line map into the precompiled representation
+{
+    compiledmap.assign(linemap.size(), SCRIPTCOMPILEDLINE());
+    for(size_t i = 0; i < linemap.size(); i++)
+    {
+        const auto & cur = linemap.at(i);
+        auto & compiled = compiledmap.at(i);
+        switch(cur.type)
+        {
+        case linecommand:
+            if(scriptisinternalcommand(cur.u.command, "ret"))
+                compiled.type = compiledret;
+            else if(scriptisinternalcommand(cur.u.command, "error"))
+                compiled.type = compilederror;
+            else if(scriptisinternalcommand(cur.u.command, "invalid"))
+                compiled.type = compiledinvalid;
+            else if(scriptisinternalcommand(cur.u.command, "pause"))
+                compiled.type = compiledpause;
+            else if(scriptisinternalcommand(cur.u.command, "nop"))
+                compiled.type = compilednop;
+            else
+            {
+                compiled.type = compiledcommands;
+                compiled.log = scriptisinternalcommand(cur.u.command, "log");
+                cmdparselist(cur.u.command, compiled.commands);
+            }
+            break;
+
+        case linebranch:
+            compiled.type = compiledbranch;
+            compiled.branchtype = cur.u.branch.type;
+            compiled.branchdest = cur.u.branch.dest; //resolved by scriptcreatelinemap
+            break;
+
+        default: //label, comment or empty line
+            compiled.type = compiledskip;
+            break;
+        }
+    }
+}
+
 static bool scriptinternalbpget(int line) //internal bpget routine
 {
     int bpcount = (int)scriptbplist.size();
@@ -463,6 +503,55 @@ static CMDRESULT scriptinternalcmdexec(const char* cmd, bool silentRet)
     return res ? STATUS_CONTINUE : STATUS_ERROR;
 }
 
+//precompiled version of scriptinternalcmdexec: the line was already classified
+//and its commands parsed by scriptcompile (branches never reach this, they are
+//their own line type in the line map)
+static CMDRESULT scriptinternalcmdexeccompiled(const SCRIPTCOMPILEDLINE & compiled, const char* cmd, bool silentRet)
+{
+    switch(compiled.type)
+    {
+    case compiledret: //script finished
+        if(!scriptstack.size()) //nothing on the stack
+        {
+            if(!silentRet)
+            {
+                String TranslatedString = GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Script finished!"));
+                GuiScriptMessage(TranslatedString.c_str());
+            }
+            return STATUS_EXIT;
+        }
+        scriptIp = scriptstack.back();
+        scriptstack.pop_back(); //remove last stack entry
+        return STATUS_CONTINUE;
+
+    case compilederror: //show an error and end the script
+        GuiScriptError(0, StringUtils::Trim(cmd + strlen("error"), " \"'").c_str());
+        return STATUS_EXIT;
+
+    case compiledinvalid: //invalid command for testing
+        return STATUS_ERROR;
+
+    case compiledpause: //pause the script
+        return STATUS_PAUSE;
+
+    case compilednop: //do nothing
+        return STATUS_CONTINUE;
+
+    default:
+        break;
+    }
+    if(compiled.log)
+        scriptLogEnabled = true;
+    auto res = cmddirectexec(compiled.commands);
+    while(DbgIsDebugging() && dbgisrunning() && !bAbort) //while not locked (NOTE: possible deadlock)
+    {
+        Sleep(1);
+        GuiProcessEvents(); //workaround for scripts being executed on the GUI thread
+    }
+    scriptLogEnabled = false;
+    return res ? STATUS_CONTINUE : STATUS_ERROR;
+}
+
 static bool scriptinternalcmd(bool silentRet)
 {
     bool bContinue = true;
@@ -473,7 +562,7 @@ static bool scriptinternalcmd(bool silentRet)
     scriptIp = scriptinternalstep(scriptIp);
     if(cur.type == linecommand)
     {
-        scriptLastError = scriptinternalcmdexec(cur.u.command, silentRet);
+        scriptLastError = scriptinternalcmdexeccompiled(compiledmap.at(scriptIpOld - 1), cur.u.command, silentRet);
         switch(scriptLastError)
         {
         case STATUS_CONTINUE:
@@ -505,8 +594,7 @@ static bool scriptinternalcmd(bool silentRet)
         {
             if(cur.u.branch.type == scriptcall) //calls have a special meaning
                 scriptstack.push_back(scriptIp);
-            scriptIp = scriptlabelfind(cur.u.branch.branchlabel);
-            scriptIp = scriptinternalstep(scriptIp); //go to the first command after the label
+            scriptIp = cur.u.branch.dest; //already resolved to the first command after the label
         }
     }
     return bContinue;
@@ -572,6 +660,7 @@ bool scriptLoadSync(const char* filename)
     bAbort = false;
     if(!scriptcreatelinemap(reinterpret_cast<const char*>(filename)))
         return false; // Script load failed
+    scriptcompile();
     int lines = (int)linemap.size();
     const char** script = reinterpret_cast<const char**>(BridgeAlloc(lines * sizeof(const char*)));
     for(int i = 0; i < lines; i++) //add script lines
@@ -596,6 +685,7 @@ void scriptunload()
 {
     GuiScriptClear();
     linemap.clear();
+    compiledmap.clear();
     scriptbplist.clear();
     scriptstack.clear();
     scriptIp = 0;
@@ -16,6 +16,11 @@
 #include "symbolinfo.h"
 #include "debugger.h"
 #include "dbghelp_safe.h"
+#include "console.h"
+#include "value.h"
+#include <unordered_set>
+#include <atomic>
+#include <thread>
 
 using SehMap = std::unordered_map<duint, STACK_COMMENT>;
 static SehMap SehCache;
@@ -33,9 +38,9 @@ void stackupdateseh()
         for(duint i = 0; i < count; i++)
         {
             if(i + 1 != count)
-                sprintf_s(comment.comment, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Pointer to SEH_Record[%d]")), i + 1);
+                sprintf_s(comment.comment, dtranslate(QT_TRANSLATE_NOOP("DBG", "Pointer to SEH_Record[%d]")), i + 1);
             else
-                sprintf_s(comment.comment, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "End of SEH Chain")));
+                sprintf_s(comment.comment, dtranslate(QT_TRANSLATE_NOOP("DBG", "End of SEH Chain")));
             newcache.insert({ SEHList[i], comment });
         }
     }
@@ -98,7 +103,7 @@ bool stackcommentget(duint addr, STACK_COMMENT* comment)
         data = basicinfo.addr;
         char returnFromAddr[MAX_LABEL_SIZE] = "";
         getSymAddrName(data, returnFromAddr);
-        _snprintf_s(comment->comment, _TRUNCATE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "return to %s from %s")), returnToAddr, returnFromAddr);
+        _snprintf_s(comment->comment, _TRUNCATE, dtranslate(QT_TRANSLATE_NOOP("DBG", "return to %s from %s")), returnToAddr, returnFromAddr);
         strcpy_s(comment->color, "!rtnclr"); // Special token for return address color;
         return true;
     }
@@ -153,25 +158,63 @@ static BOOL CALLBACK StackReadProcessMemoryProc64(HANDLE hProcess, DWORD64 lpBas
     return false;
 }
 
+#ifdef _WIN64
+//Module bases whose dbghelp function table lookup already failed (LockFunctionTableCache).
+//Without this every walked frame in such a module makes dbghelp re-attempt the
+//deferred module load, which can mean a symbol path (or symbol server) probe
+//per frame while the dbghelp critical section is held.
+static std::unordered_set<duint> NoFunctionTableModules;
+#endif // _WIN64
+
+void stackclearfunctiontablecache()
+{
+#ifdef _WIN64
+    EXCLUSIVE_ACQUIRE(LockFunctionTableCache);
+    NoFunctionTableModules.clear();
+#endif // _WIN64
+}
+
 static PVOID CALLBACK StackSymFunctionTableAccess64(HANDLE hProcess, DWORD64 AddrBase)
 {
 #ifdef _WIN64
     // https://github.com/dotnet/coreclr/blob/master/src/unwinder/amd64/dbs_stack_x64.cpp
     MODINFO* info = ModInfoFromAddr(AddrBase);
-    if(!info)
+    if(info && !info->runtimeFunctions.empty())
+    {
+        DWORD rva = DWORD(AddrBase - info->base);
+        auto found = std::lower_bound(info->runtimeFunctions.begin(), info->runtimeFunctions.end(), rva, [](const RUNTIME_FUNCTION & a, const DWORD & rva)
+        {
+            return a.EndAddress <= rva;
+        });
+
+        if(found != info->runtimeFunctions.end() && rva >= found->BeginAddress)
+            return &found->BeginAddress;
+
+        //This table was parsed from the same exception directory dbghelp would
+        //read, so a miss here is a leaf frame and not a parse failure.
         return nullptr;
+    }
 
-    DWORD rva = DWORD(AddrBase - info->base);
-    auto found = std::lower_bound(info->runtimeFunctions.begin(), info->runtimeFunctions.end(), rva, [](const RUNTIME_FUNCTION & a, const DWORD & rva)
+    //Only addresses without parsed unwind data reach dbghelp. Failures are
+    //remembered per module base so they are not retried on every frame.
+    duint moduleBase = info ? info->base : 0;
     {
-        return a.EndAddress <= rva;
-    });
-
-    if(found != info->runtimeFunctions.end() && rva >= found->BeginAddress)
-        return &found->BeginAddress;
-#endif // _WIN64
+        SHARED_ACQUIRE(LockFunctionTableCache);
+        if(NoFunctionTableModules.count(moduleBase))
+            return nullptr;
+    }
 
+    auto result = SymFunctionTableAccess64(hProcess, AddrBase);
+    if(!result)
+    {
+        EXCLUSIVE_ACQUIRE(LockFunctionTableCache);
+        NoFunctionTableModules.insert(moduleBase);
+    }
+    return result;
+#else
+    //On x86 FPO data is per-address, so negative results cannot be cached.
     return SymFunctionTableAccess64(hProcess, AddrBase);
+#endif // _WIN64
 }
 
 static DWORD64 CALLBACK StackGetModuleBaseProc64(HANDLE hProcess, DWORD64 Address)
@@ -196,16 +239,56 @@ void StackEntryFromFrame(CALLSTACKENTRY* Entry, duint Address, duint From, duint
     getSymAddrName(To, returnToAddr);
     char returnFromAddr[MAX_LABEL_SIZE] = "";
     getSymAddrName(From, returnFromAddr);
-    _snprintf_s(Entry->comment, _TRUNCATE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "return to %s from %s")), returnToAddr, returnFromAddr);
+    _snprintf_s(Entry->comment, _TRUNCATE, dtranslate(QT_TRANSLATE_NOOP("DBG", "return to %s from %s")), returnToAddr, returnFromAddr);
     */
 
-    getSymAddrName(From, Entry->comment);
+    auto epoch = valnamecacheepoch();
+    SHARED_ACQUIRE(LockCallstackCache);
+    auto found = SymAddrNameCache.find(From);
+    if(found != SymAddrNameCache.end() && found->second.epoch == epoch)
+        strncpy_s(Entry->comment, found->second.name.c_str(), _TRUNCATE);
+    else
+        _snprintf_s(Entry->comment, _TRUNCATE, "%p", (void*)From); //placeholder until the background symbolizer answers
 }
 
 #define MAX_CALLSTACK_CACHE 20
 using CallstackMap = std::unordered_map<duint, std::vector<CALLSTACKENTRY>>;
 static CallstackMap CallstackCache;
 
+//Symbol text per return address, epoch-tagged so module loads and label
+//changes invalidate it together with the other name caches. Frames without
+//an entry here get a raw address placeholder and are symbolized by a
+//background worker, so the stack view refresh never waits on dbghelp.
+struct SymAddrNameEntry
+{
+    duint epoch;
+    String name;
+};
+static std::unordered_map<duint, SymAddrNameEntry> SymAddrNameCache; //guarded by LockCallstackCache
+static std::atomic<bool> SymbolizeRunning(false);
+
+//Previous full walk per thread (LockCallstackCache). After a step only the
+//innermost frames change, so once the walk reaches a frame whose return slot
+//and return address match the previous stack, the outer tail is spliced in
+//as-is instead of re-unwinding and re-symbolizing it - on deep recursion that
+//turns the multi-hundred-ms re-walk into a couple of StackWalk64 iterations.
+static std::unordered_map<DWORD, std::vector<CALLSTACKENTRY>> PreviousCallstack;
+
+static bool stackspliceprevious(const std::vector<CALLSTACKENTRY> & previous, duint addr, duint from, duint to, std::vector<CALLSTACKENTRY> & callstackVector)
+{
+    for(size_t i = 0; i < previous.size(); i++)
+    {
+        const auto & prevEntry = previous[i];
+        if(prevEntry.addr < addr) //outer frames live at higher stack addresses
+            continue;
+        if(prevEntry.addr != addr || prevEntry.from != from || prevEntry.to != to)
+            return false; //the frame at this depth changed, keep unwinding
+        callstackVector.insert(callstackVector.end(), previous.begin() + i, previous.end());
+        return true;
+    }
+    return false;
+}
+
 void stackupdatecallstack(duint csp)
 {
     std::vector<CALLSTACKENTRY> callstack;
@@ -249,7 +332,7 @@ static void stackgetsuspectedcallstack(duint csp, std::vector<CALLSTACKENTRY> &
                 data = basicinfo.addr;
                 char returnFromAddr[MAX_LABEL_SIZE] = "";
                 getSymAddrName(data, returnFromAddr);
-                _snprintf_s(stackframe.comment, _TRUNCATE, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "return to %s from %s")), returnToAddr, returnFromAddr);
+                _snprintf_s(stackframe.comment, _TRUNCATE, dtranslate(QT_TRANSLATE_NOOP("DBG", "return to %s from %s")), returnToAddr, returnFromAddr);
                 stackframe.from = data;
                 callstackVector.push_back(stackframe);
             }
@@ -287,12 +370,23 @@ void stackgetcallstack(duint csp, std::vector<CALLSTACKENTRY> & callstackVector,
     if(ResumeThread(hActiveThread) == -1)
         return;
 
+    auto threadId = ThreadGetId(hActiveThread);
+
     if(ShowSuspectedCallStack)
     {
         stackgetsuspectedcallstack(csp, callstackVector);
     }
     else
     {
+        //copy of the previous walk for this thread, used to splice unchanged frames
+        std::vector<CALLSTACKENTRY> previous;
+        {
+            SHARED_ACQUIRE(LockCallstackCache);
+            auto found = PreviousCallstack.find(threadId);
+            if(found != PreviousCallstack.end())
+                previous = found->second;
+        }
+
         // Set up all frame data
         STACKFRAME64 frame;
         ZeroMemory(&frame, sizeof(STACKFRAME64));
@@ -340,10 +434,18 @@ void stackgetcallstack(duint csp, std::vector<CALLSTACKENTRY> & callstackVector,
             if(frame.AddrPC.Offset != 0)
             {
                 // Valid frame
+                auto addr = (duint)frame.AddrFrame.Offset + sizeof(duint);
+                auto from = (duint)frame.AddrPC.Offset;
+                auto to = (duint)frame.AddrReturn.Offset;
+
+                // Reuse the untouched tail of the previous call stack
+                if(stackspliceprevious(previous, addr, from, to, callstackVector))
+                    break;
+
                 CALLSTACKENTRY entry;
                 memset(&entry, 0, sizeof(CALLSTACKENTRY));
 
-                StackEntryFromFrame(&entry, (duint)frame.AddrFrame.Offset + sizeof(duint), (duint)frame.AddrPC.Offset, (duint)frame.AddrReturn.Offset);
+                StackEntryFromFrame(&entry, addr, from, to);
                 callstackVector.push_back(entry);
             }
             else
@@ -354,10 +456,75 @@ void stackgetcallstack(duint csp, std::vector<CALLSTACKENTRY> & callstackVector,
         }
     }
 
+    //Frames whose return address has no cached symbol text yet are handed to
+    //a background worker; the view shows their raw addresses meanwhile
+    std::vector<duint> missingNames;
+    auto epoch = valnamecacheepoch();
+
     EXCLUSIVE_ACQUIRE(LockCallstackCache);
     if(CallstackCache.size() > MAX_CALLSTACK_CACHE)
         CallstackCache.clear();
     CallstackCache[csp] = callstackVector;
+    if(ShowSuspectedCallStack)
+    {
+        //suspected frames have different semantics, do not splice them later
+        PreviousCallstack.erase(threadId);
+    }
+    else
+    {
+        if(PreviousCallstack.size() > MAX_CALLSTACK_CACHE)
+            PreviousCallstack.clear();
+        PreviousCallstack[threadId] = callstackVector;
+
+        for(const auto & entry : callstackVector)
+        {
+            auto found = SymAddrNameCache.find(entry.from);
+            if(found == SymAddrNameCache.end() || found->second.epoch != epoch)
+                missingNames.push_back(entry.from);
+        }
+    }
+    EXCLUSIVE_RELEASE();
+
+    if(!missingNames.empty() && !SymbolizeRunning.exchange(true))
+    {
+        std::thread([missingNames, csp, threadId, epoch]()
+        {
+            std::unordered_map<duint, String> results;
+            char name[MAX_COMMENT_SIZE] = "";
+            for(auto addr : missingNames)
+            {
+                getSymAddrName(addr, name);
+                results.emplace(addr, name);
+            }
+
+            auto patchComments = [&results](std::vector<CALLSTACKENTRY> & entries)
+            {
+                for(auto & entry : entries)
+                {
+                    auto found = results.find(entry.from);
+                    if(found != results.end())
+                        strncpy_s(entry.comment, found->second.c_str(), _TRUNCATE);
+                }
+            };
+
+            EXCLUSIVE_ACQUIRE(LockCallstackCache);
+            if(SymAddrNameCache.size() > 65536) //bound stale entries from previous epochs
+                SymAddrNameCache.clear();
+            for(const auto & result : results)
+                SymAddrNameCache[result.first] = SymAddrNameEntry { epoch, result.second };
+            //patch the published walks so the next view read sees the names
+            auto foundCallstack = CallstackCache.find(csp);
+            if(foundCallstack != CallstackCache.end())
+                patchComments(foundCallstack->second);
+            auto foundPrevious = PreviousCallstack.find(threadId);
+            if(foundPrevious != PreviousCallstack.end())
+                patchComments(foundPrevious->second);
+            EXCLUSIVE_RELEASE();
+
+            SymbolizeRunning = false;
+            GuiUpdateCallStack();
+        }).detach();
+    }
 }
 
 void stackgetcallstack(duint csp, CALLSTACK* callstack)
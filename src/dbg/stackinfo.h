@@ -18,6 +18,7 @@ struct CALLSTACK
 };
 
 void stackupdateseh();
+void stackclearfunctiontablecache();
 bool stackcommentget(duint addr, STACK_COMMENT* comment);
 void stackupdatecallstack(duint csp);
 void stackgetcallstack(duint csp, CALLSTACK* callstack);
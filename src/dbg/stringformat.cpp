@@ -1,4 +1,5 @@
 #include "stringformat.h"
+#include "console.h"
 #include "value.h"
 #include "symbolinfo.h"
 #include "module.h"
@@ -168,7 +169,7 @@ static String handleFormatString(const String & formatString, const FormatValueV
     auto argnum = getArgNumType(formatString, type);
     if(type != ValueType::Unknown && argnum < values.size())
         return printValue(values.at(argnum), type);
-    return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "[Formatting Error]"));
+    return dtranslate(QT_TRANSLATE_NOOP("DBG", "[Formatting Error]"));
 }
 
 String stringformat(String format, const FormatValueVector & values)
@@ -229,7 +230,7 @@ static String printComplexValue(FormatValueType value, const String & complexArg
         if(FormatFunctions::Call(dest, split[0], split, valuint))
             return String(dest.data());
     }
-    return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "[Formatting Error]"));
+    return dtranslate(QT_TRANSLATE_NOOP("DBG", "[Formatting Error]"));
 }
 
 static String handleFormatStringInline(const String & formatString)
@@ -241,27 +242,36 @@ static String handleFormatStringInline(const String & formatString)
         return printComplexValue(value, complexArgs);
     else if(value && *value)
         return printValue(value, type);
-    return GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "[Formatting Error]"));
+    return dtranslate(QT_TRANSLATE_NOOP("DBG", "[Formatting Error]"));
 }
 
-String stringformatinline(String format)
+void FormatStringCompiled::Compile(const String & format)
 {
+    mSegments.clear();
     int len = (int)format.length();
-    String output;
+    String literal;
     String formatString;
     bool inFormatter = false;
+    auto flushLiteral = [this, &literal]()
+    {
+        if(!literal.empty())
+        {
+            mSegments.push_back(Segment { false, std::move(literal) });
+            literal.clear();
+        }
+    };
     for(int i = 0; i < len; i++)
     {
         //handle escaped format sequences "{{" and "}}"
         if(format[i] == '{' && (i + 1 < len && format[i + 1] == '{'))
         {
-            output += "{";
+            literal += "{";
             i++;
             continue;
         }
         if(format[i] == '}' && (i + 1 < len && format[i + 1] == '}'))
         {
-            output += "}";
+            literal += "}";
             i++;
             continue;
         }
@@ -276,18 +286,42 @@ String stringformatinline(String format)
             inFormatter = false;
             if(formatString.length())
             {
-                output += handleFormatStringInline(formatString);
+                flushLiteral();
+                mSegments.push_back(Segment { true, formatString });
                 formatString.clear();
             }
         }
         else if(inFormatter) //inside brackets
             formatString += format[i];
         else //outside brackets
-            output += format[i];
+            literal += format[i];
     }
     if(inFormatter && formatString.size())
-        output += handleFormatStringInline(formatString);
+    {
+        flushLiteral();
+        mSegments.push_back(Segment { true, formatString });
+    }
     else if(inFormatter)
-        output += "{";
+        literal += "{";
+    flushLiteral();
+}
+
+void FormatStringCompiled::Format(String & output) const
+{
+    output.clear();
+    for(const auto & segment : mSegments)
+    {
+        if(segment.formatter)
+            output += handleFormatStringInline(segment.text);
+        else
+            output += segment.text;
+    }
+}
+
+String stringformatinline(String format)
+{
+    FormatStringCompiled compiled(format);
+    String output;
+    compiled.Format(output);
     return output;
 }
@@ -9,4 +9,33 @@ typedef std::vector<FormatValueType> FormatValueVector;
 String stringformat(String format, const FormatValueVector & values);
 String stringformatinline(String format);
 
+/**
+\brief Format string compiled into literal and formatter segments once, so
+per-hit callers (log breakpoints, trace logs) do not re-parse the braces on
+every evaluation. Format() writes into a caller-provided buffer that can be
+reused across evaluations.
+*/
+class FormatStringCompiled
+{
+public:
+    FormatStringCompiled() = default;
+
+    explicit FormatStringCompiled(const String & format)
+    {
+        Compile(format);
+    }
+
+    void Compile(const String & format);
+    void Format(String & output) const;
+
+private:
+    struct Segment
+    {
+        bool formatter; //evaluate text as {...} contents instead of copying it
+        String text;
+    };
+
+    std::vector<Segment> mSegments;
+};
+
 #endif //_STRINGFORMAT_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+/**
+ @file stringpool.cpp
+
+ @brief Implements interned string storage shared by annotation records.
+*/
+
+#include "stringpool.h"
+#include "threading.h"
+#include <deque>
+
+// Entry 0 is always the empty string so a default PooledString is empty.
+// std::deque never moves existing elements on growth, which makes it safe to
+// hand out references into the pool while other threads intern new strings.
+static std::deque<std::string> pool(1);
+static std::unordered_map<std::string, uint32_t> poolIds;
+
+uint32_t StringPoolIntern(const char* Text)
+{
+    if(!Text || !*Text)
+        return 0;
+    EXCLUSIVE_ACQUIRE(LockStringPool);
+    auto found = poolIds.find(Text);
+    if(found != poolIds.end())
+        return found->second;
+    auto id = uint32_t(pool.size());
+    pool.emplace_back(Text);
+    poolIds.emplace(pool.back(), id);
+    return id;
+}
+
+const std::string & StringPoolGet(uint32_t Id)
+{
+    SHARED_ACQUIRE(LockStringPool);
+    if(Id >= pool.size())
+        Id = 0;
+    return pool[Id];
+}
+
+void StringPoolClear()
+{
+    EXCLUSIVE_ACQUIRE(LockStringPool);
+    pool.clear();
+    pool.emplace_back();
+    poolIds.clear();
+}
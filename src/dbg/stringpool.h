@@ -0,0 +1,53 @@
+#ifndef _STRINGPOOL_H
+#define _STRINGPOOL_H
+
+#include "_global.h"
+
+// Interned storage for strings that are duplicated across many addresses
+// (auto comments and labels produced by analysis). Each unique string is
+// stored once in an append-only pool and referenced by a 32-bit id; id 0 is
+// always the empty string. Individual entries are never freed, the whole
+// pool is discarded together with the database (see DbClear).
+uint32_t StringPoolIntern(const char* Text);
+const std::string & StringPoolGet(uint32_t Id);
+void StringPoolClear();
+
+// Drop-in replacement for a std::string member in per-address records: the
+// record only carries the 32-bit pool id, the text lives in the shared pool.
+class PooledString
+{
+public:
+    PooledString() = default;
+
+    PooledString & operator=(const char* Text)
+    {
+        mId = StringPoolIntern(Text);
+        return *this;
+    }
+
+    PooledString & operator=(const std::string & Text)
+    {
+        mId = StringPoolIntern(Text.c_str());
+        return *this;
+    }
+
+    operator const std::string & () const
+    {
+        return StringPoolGet(mId);
+    }
+
+    const char* c_str() const
+    {
+        return StringPoolGet(mId).c_str();
+    }
+
+    bool empty() const
+    {
+        return mId == 0;
+    }
+
+private:
+    uint32_t mId = 0;
+};
+
+#endif // _STRINGPOOL_H
@@ -0,0 +1,145 @@
+#include "stringsearch.h"
+#include <algorithm>
+#include <intrin.h>
+#include <emmintrin.h>
+
+// Printable in the string heuristic sense: the visible ASCII range plus tab
+static inline bool isPrintableChar(unsigned char ch)
+{
+    return (ch >= 0x20 && ch <= 0x7E) || ch == '\t';
+}
+
+// Runtime SSE2 check (x64 always has it), same approach as patternfind.cpp
+static bool stringsimdsupport()
+{
+#ifdef _WIN64
+    return true;
+#else
+    static int support = -1;
+    if(support == -1)
+    {
+        int info[4] = { 0 };
+        __cpuid(info, 1);
+        support = (info[3] & (1 << 26)) ? 1 : 0; //SSE2
+    }
+    return support == 1;
+#endif //_WIN64
+}
+
+// Bitmask of the printable bytes among the 16 bytes at p (bit n = p[n])
+static inline unsigned printableMask16(const unsigned char* p)
+{
+    auto chunk = _mm_loadu_si128((const __m128i*)p);
+    // (ch - 0x20) is unsigned <= 0x5E exactly for the 0x20..0x7E range
+    auto shifted = _mm_sub_epi8(chunk, _mm_set1_epi8(0x20));
+    auto inRange = _mm_cmpeq_epi8(_mm_subs_epu8(shifted, _mm_set1_epi8(0x5E)), _mm_setzero_si128());
+    auto tab = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'));
+    return unsigned(_mm_movemask_epi8(_mm_or_si128(inRange, tab)));
+}
+
+static void scanAscii(const unsigned char* data, size_t datasize, duint base, size_t minLength, std::vector<FoundString> & results)
+{
+    const bool simd = stringsimdsupport();
+    size_t i = 0;
+    while(i < datasize)
+    {
+        // Skip to the next printable byte, 16 at a time
+        if(simd)
+        {
+            while(i + 16 <= datasize)
+            {
+                auto mask = printableMask16(data + i);
+                if(mask)
+                {
+                    unsigned long bit = 0;
+                    _BitScanForward(&bit, mask);
+                    i += bit;
+                    break;
+                }
+                i += 16;
+            }
+        }
+        while(i < datasize && !isPrintableChar(data[i]))
+            i++;
+        if(i >= datasize)
+            break;
+
+        // Extend the printable run, 16 at a time
+        size_t start = i;
+        if(simd)
+        {
+            while(i + 16 <= datasize)
+            {
+                auto mask = printableMask16(data + i);
+                if(mask != 0xFFFF)
+                {
+                    unsigned long bit = 0;
+                    _BitScanForward(&bit, ~mask);
+                    i += bit;
+                    break;
+                }
+                i += 16;
+            }
+        }
+        while(i < datasize && isPrintableChar(data[i]))
+            i++;
+
+        auto length = i - start;
+        if(length >= minLength)
+        {
+            FoundString found;
+            found.addr = base + start;
+            found.size = length;
+            found.unicode = false;
+            auto textLength = min(length, size_t(MAX_STRING_SIZE - 1));
+            found.text = String((const char*)data + start, (const char*)data + start + textLength);
+            results.push_back(std::move(found));
+        }
+    }
+}
+
+static void scanUtf16(const unsigned char* data, size_t datasize, duint base, size_t minLength, std::vector<FoundString> & results)
+{
+    // Latin-subset UTF-16: printable low byte, zero high byte. The bytes of a
+    // character pair keep the ASCII pass from matching (every printable byte
+    // is followed by a terminator), so the passes never report the same run.
+    size_t i = 0;
+    while(i + 1 < datasize)
+    {
+        if(!(isPrintableChar(data[i]) && data[i + 1] == 0))
+        {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        String text;
+        while(i + 1 < datasize && isPrintableChar(data[i]) && data[i + 1] == 0)
+        {
+            if(text.size() < MAX_STRING_SIZE - 1)
+                text.push_back(char(data[i]));
+            i += 2;
+        }
+        auto length = (i - start) / 2;
+        if(length >= minLength)
+        {
+            FoundString found;
+            found.addr = base + start;
+            found.size = i - start;
+            found.unicode = true;
+            found.text = std::move(text);
+            results.push_back(std::move(found));
+        }
+    }
+}
+
+void stringsearch(const unsigned char* data, size_t datasize, duint base, size_t minLength, std::vector<FoundString> & results)
+{
+    if(!datasize || !minLength)
+        return;
+    scanAscii(data, datasize, base, minLength, results);
+    scanUtf16(data, datasize, base, minLength, results);
+    std::sort(results.begin(), results.end(), [](const FoundString & a, const FoundString & b)
+    {
+        return a.addr < b.addr;
+    });
+}
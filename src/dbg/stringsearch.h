@@ -0,0 +1,25 @@
+#ifndef _STRINGSEARCH_H
+#define _STRINGSEARCH_H
+
+#include "_global.h"
+
+struct FoundString
+{
+    duint addr; //virtual address of the first character
+    duint size; //size in bytes (excluding any terminator)
+    bool unicode; //UTF-16 when true, ASCII otherwise
+    String text; //UTF-8 rendering, truncated to MAX_STRING_SIZE
+};
+
+//Scan a raw buffer for printable ASCII and UTF-16 runs of at least
+//minLength characters. base is the virtual address of data and is only
+//used to fill FoundString::addr.
+void stringsearch(
+    const unsigned char* data, //data
+    size_t datasize, //size of data
+    duint base, //virtual address of data
+    size_t minLength, //minimum number of characters
+    std::vector<FoundString> & results //found strings in offset order
+);
+
+#endif // _STRINGSEARCH_H
@@ -9,10 +9,14 @@
 #include "console.h"
 #include "module.h"
 #include "addrinfo.h"
+#include "value.h"
 #include "dbghelp_safe.h"
 #include "exception.h"
 #include "WinInet-Downloader/downslib.h"
 #include <shlwapi.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 duint symbolDownloadingBase = 0;
 
@@ -94,6 +98,10 @@ bool SymGetModuleList(std::vector<SYMBOLMODULEINFO>* List)
 
 void SymUpdateModuleList()
 {
+    // This runs whenever modules or their symbols change, which also
+    // invalidates cached name resolutions
+    valnamecacheclear();
+
     // Build the vector of modules
     std::vector<SYMBOLMODULEINFO> modList;
 
@@ -127,10 +135,18 @@ bool SymDownloadSymbol(duint Base, const char* SymbolStore)
 {
     struct DownloadBaseGuard
     {
-        DownloadBaseGuard(duint downloadBase) { symbolDownloadingBase = downloadBase; GuiRepaintTableView(); }
-        ~DownloadBaseGuard() { symbolDownloadingBase = 0; GuiRepaintTableView(); }
+        duint base;
+        DownloadBaseGuard(duint downloadBase) : base(downloadBase) { symbolDownloadingBase = downloadBase; GuiRepaintTableView(); }
+        ~DownloadBaseGuard()
+        {
+            // Downloads can run in parallel, only clear the marker if another
+            // download didn't take it over in the meantime
+            if(symbolDownloadingBase == base)
+                symbolDownloadingBase = 0;
+            GuiRepaintTableView();
+        }
     } g(Base);
-#define symprintf(format, ...) GuiSymbolLogAdd(StringUtils::sprintf(GuiTranslateText(format), __VA_ARGS__).c_str())
+#define symprintf(format, ...) GuiSymbolLogAdd(StringUtils::sprintf(dtranslate(format), __VA_ARGS__).c_str())
 
     // Default to Microsoft's symbol server
     if(!SymbolStore)
@@ -186,7 +202,12 @@ bool SymDownloadSymbol(duint Base, const char* SymbolStore)
 
     symprintf(QT_TRANSLATE_NOOP("DBG", "Downloading symbol %s\n  Signature: %s\n  Destination: %s\n  URL: %s\n"), pdbBaseFile, pdbSignature.c_str(), StringUtils::Utf16ToUtf8(destinationPath).c_str(), symbolUrl.c_str());
 
-    auto result = downslib_download(symbolUrl.c_str(), destinationPath.c_str(), "x64dbg", 1000, [](void* userdata, unsigned long long read_bytes, unsigned long long total_bytes)
+    // Download to a staging file and only rename to the final name on success,
+    // so an interrupted transfer never leaves a truncated PDB where the symbol
+    // loader would pick it up. The staging file is kept on failure and resumed
+    // with an HTTP range request on the next attempt.
+    WString stagingPath = destinationPath + L".part";
+    auto result = downslib_download(symbolUrl.c_str(), stagingPath.c_str(), "x64dbg", 1000, [](void* userdata, unsigned long long read_bytes, unsigned long long total_bytes)
     {
         if(total_bytes)
         {
@@ -194,7 +215,7 @@ bool SymDownloadSymbol(duint Base, const char* SymbolStore)
             SymSetProgress((int)(progress * 100.0), (const char*)userdata);
         }
         return true;
-    }, (void*)pdbBaseFile);
+    }, (void*)pdbBaseFile, true);
     SymSetProgress(0, pdbBaseFile);
 
     switch(result)
@@ -215,15 +236,21 @@ bool SymDownloadSymbol(duint Base, const char* SymbolStore)
         symprintf(QT_TRANSLATE_NOOP("DBG", "Connection succeeded, but download failed (status code: %d)...\n"), GetLastError());
         return false;
     case downslib_error::cancel:
-        symprintf(QT_TRANSLATE_NOOP("DBG", "Download interrupted...\n"), ErrorCodeToName(GetLastError()).c_str());
+        symprintf(QT_TRANSLATE_NOOP("DBG", "Download interrupted, will be resumed on the next attempt...\n"), ErrorCodeToName(GetLastError()).c_str());
         return false;
     case downslib_error::incomplete:
-        symprintf(QT_TRANSLATE_NOOP("DBG", "Download incomplete...\n"), ErrorCodeToName(GetLastError()).c_str());
+        symprintf(QT_TRANSLATE_NOOP("DBG", "Download incomplete, will be resumed on the next attempt...\n"), ErrorCodeToName(GetLastError()).c_str());
         return false;
     default:
         __debugbreak();
     }
 
+    if(!MoveFileExW(stagingPath.c_str(), destinationPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        symprintf(QT_TRANSLATE_NOOP("DBG", "Failed to rename downloaded file (%s)...\n"), ErrorCodeToName(GetLastError()).c_str());
+        return false;
+    }
+
     {
         EXCLUSIVE_ACQUIRE(LockModules);
         auto info = ModInfoFromAddr(Base);
@@ -255,9 +282,37 @@ void SymDownloadAllSymbols(const char* SymbolStore)
     {
         mods.push_back(info.base);
     });
+    if(mods.empty())
+        return;
 
-    for(duint base : mods)
-        SymDownloadSymbol(base, SymbolStore);
+    // Fetch the debuggee itself first, its symbols are the ones most likely
+    // needed right away
+    auto mainItr = std::find(mods.begin(), mods.end(), dbgdebuggedbase());
+    if(mainItr != mods.end())
+        std::swap(mods.front(), *mainItr);
+
+    // Most of the time per module is spent waiting on the symbol server, so
+    // run a few transfers in parallel
+    auto total = mods.size();
+    auto workerCount = std::min<size_t>(4, total);
+    std::atomic<size_t> nextModule(0);
+    std::atomic<size_t> finishedModules(0);
+    auto worker = [&]()
+    {
+        size_t i;
+        while((i = nextModule++) < total)
+        {
+            SymDownloadSymbol(mods[i], SymbolStore);
+            GuiSymbolSetProgress(int(++finishedModules * 100 / total));
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for(size_t i = 0; i < workerCount; i++)
+        workers.emplace_back(worker);
+    for(auto & thread : workers)
+        thread.join();
+    GuiSymbolSetProgress(0);
 }
 
 bool SymAddrFromName(const char* Name, duint* Address)
@@ -311,44 +366,100 @@ bool SymAddrFromName(const char* Name, duint* Address)
     return false;
 }
 
+// Reverse (address to name) resolutions, the GUI and trace views request the
+// same addresses over and over. Entries share the name resolution epoch, so
+// module, label and symbol changes invalidate both directions at once.
+struct SymbolicNameEntry
+{
+    duint epoch;
+    String name;
+};
+static std::unordered_map<duint, SymbolicNameEntry> symbolicNameCache;
+
 String SymGetSymbolicName(duint Address)
 {
     //
     // This resolves an address to a module and symbol:
     // [modname.]symbolname
     //
+    auto epoch = valnamecacheepoch();
+    {
+        SHARED_ACQUIRE(LockNameResolutionCache);
+        auto found = symbolicNameCache.find(Address);
+        if(found != symbolicNameCache.end() && found->second.epoch == epoch)
+            return found->second.name;
+    }
+
     char label[MAX_SYM_NAME];
     char modname[MAX_MODULE_SIZE];
     auto hasModule = ModNameFromAddr(Address, modname, false);
 
+    String result;
     // User labels have priority, but if one wasn't found,
     // default to a symbol lookup
     if(!DbgGetLabelAt(Address, SEG_DEFAULT, label))
     {
         if(hasModule)
-            return StringUtils::sprintf("%s.%p", modname, Address);
-        return "";
+            result = StringUtils::sprintf("%s.%p", modname, Address);
     }
+    else if(hasModule)
+        result = StringUtils::sprintf("<%s.%s>", modname, label);
+    else
+        result = StringUtils::sprintf("<%s>", label);
 
-    if(hasModule)
-        return StringUtils::sprintf("<%s.%s>", modname, label);
-    return StringUtils::sprintf("<%s>", label);
+    EXCLUSIVE_ACQUIRE(LockNameResolutionCache);
+    if(symbolicNameCache.size() > 65536) //bound stale entries from previous epochs
+        symbolicNameCache.clear();
+    symbolicNameCache[Address] = SymbolicNameEntry { epoch, result };
+    return result;
 }
 
-bool SymGetSourceLine(duint Cip, char* FileName, int* Line, DWORD* disp)
+// Source line resolutions repeat for every visible row while the line column
+// is enabled, and a resolution can probe the disk (FileExists) each time.
+// Resolved lines share the name resolution epoch, so module and symbol
+// changes invalidate them together with the symbolic names.
+struct SourceLineEntry
 {
-    SHARED_ACQUIRE(LockModules);
-    MODINFO* modInfo = ModInfoFromAddr(Cip);
-    if(!modInfo)
-        return false;
+    duint epoch;
+    int line;
+    duint disp;
+    String fileName;
+};
+static std::unordered_map<duint, SourceLineEntry> sourceLineCache;
 
-    SymbolSourceBase* sym = modInfo->symbols;
-    if(!sym || sym == &EmptySymbolSource)
-        return false;
+bool SymGetSourceLine(duint Cip, char* FileName, int* Line, DWORD* disp)
+{
+    auto epoch = valnamecacheepoch();
+    {
+        SHARED_ACQUIRE(LockNameResolutionCache);
+        auto found = sourceLineCache.find(Cip);
+        if(found != sourceLineCache.end() && found->second.epoch == epoch)
+        {
+            const auto & entry = found->second;
+            if(disp)
+                *disp = entry.disp;
+            if(Line)
+                *Line = entry.line;
+            if(FileName)
+                strncpy_s(FileName, MAX_STRING_SIZE, entry.fileName.c_str(), _TRUNCATE);
+            return true;
+        }
+    }
 
     LineInfo lineInfo;
-    if(!sym->findSourceLineInfo(Cip - modInfo->base, lineInfo))
-        return false;
+    {
+        SHARED_ACQUIRE(LockModules);
+        MODINFO* modInfo = ModInfoFromAddr(Cip);
+        if(!modInfo)
+            return false;
+
+        SymbolSourceBase* sym = modInfo->symbols;
+        if(!sym || sym == &EmptySymbolSource)
+            return false;
+
+        if(!sym->findSourceLineInfo(Cip - modInfo->base, lineInfo))
+            return false;
+    }
 
     if(disp)
         *disp = lineInfo.disp;
@@ -358,36 +469,33 @@ bool SymGetSourceLine(duint Cip, char* FileName, int* Line, DWORD* disp)
 
     if(FileName)
     {
-        strncpy_s(FileName, MAX_STRING_SIZE, lineInfo.sourceFile.c_str(), _TRUNCATE);
-
         // Check if it was a full path
-        if(!PathIsRelativeW(StringUtils::Utf8ToUtf16(lineInfo.sourceFile).c_str()))
-            return true;
-
-        // Construct full path from pdb path
+        if(PathIsRelativeW(StringUtils::Utf8ToUtf16(lineInfo.sourceFile).c_str()))
         {
+            // Construct full path from pdb path
             SHARED_ACQUIRE(LockModules);
             MODINFO* info = ModInfoFromAddr(Cip);
-            if(!info)
-                return true;
-
-            String sourceFilePath = info->symbols->loadedSymbolPath();
+            if(info)
+            {
+                String sourceFilePath = info->symbols->loadedSymbolPath();
 
-            // Strip the name, leaving only the file directory
-            size_t bslash = sourceFilePath.rfind('\\');
-            if(bslash != String::npos)
-                sourceFilePath.resize(bslash + 1);
-            sourceFilePath += lineInfo.sourceFile;
+                // Strip the name, leaving only the file directory
+                size_t bslash = sourceFilePath.rfind('\\');
+                if(bslash != String::npos)
+                    sourceFilePath.resize(bslash + 1);
+                sourceFilePath += lineInfo.sourceFile;
 
-            // Attempt to remap the source file if it exists (more heuristics could be added in the future)
-            if(FileExists(sourceFilePath.c_str()))
-            {
-                if(info->symbols->mapSourceFilePdbToDisk(lineInfo.sourceFile, sourceFilePath))
-                {
-                    strncpy_s(FileName, MAX_STRING_SIZE, sourceFilePath.c_str(), _TRUNCATE);
-                }
+                // Attempt to remap the source file if it exists (more heuristics could be added in the future)
+                if(FileExists(sourceFilePath.c_str()) && info->symbols->mapSourceFilePdbToDisk(lineInfo.sourceFile, sourceFilePath))
+                    lineInfo.sourceFile = sourceFilePath;
             }
         }
+        strncpy_s(FileName, MAX_STRING_SIZE, lineInfo.sourceFile.c_str(), _TRUNCATE);
+
+        EXCLUSIVE_ACQUIRE(LockNameResolutionCache);
+        if(sourceLineCache.size() > 65536) //bound stale entries from previous epochs
+            sourceLineCache.clear();
+        sourceLineCache[Cip] = SourceLineEntry { epoch, lineInfo.lineNumber, lineInfo.disp, lineInfo.sourceFile };
     }
 
     return true;
@@ -66,6 +66,102 @@ bool NameIndex::findByName(const std::vector<NameIndex> & byName, const std::str
     return false;
 }
 
+static char foldCase(char ch)
+{
+    return ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch;
+}
+
+static bool containsFolded(const char* name, const std::string & foldedPattern)
+{
+    auto patternSize = foldedPattern.size();
+    for(; *name; name++)
+    {
+        size_t i = 0;
+        while(i < patternSize && name[i] && foldCase(name[i]) == foldedPattern[i])
+            i++;
+        if(i == patternSize)
+            return true;
+    }
+    return false;
+}
+
+uint32_t NameSubstringIndex::foldedTrigram(const char* str)
+{
+    return uint32_t(uint8_t(foldCase(str[0]))) | uint32_t(uint8_t(foldCase(str[1]))) << 8 | uint32_t(uint8_t(foldCase(str[2]))) << 16;
+}
+
+void NameSubstringIndex::build(const std::vector<NameIndex> & names)
+{
+    clear();
+    _names = &names;
+    for(uint32_t i = 0; i < names.size(); i++)
+    {
+        auto name = names[i].name;
+        auto len = strlen(name);
+        for(size_t j = 0; j + 3 <= len; j++)
+        {
+            auto & posting = _postings[foldedTrigram(name + j)];
+            // A name is listed at most once per trigram (repeated trigrams hit
+            // the same posting consecutively, so checking the tail suffices)
+            if(posting.empty() || posting.back() != i)
+                posting.push_back(i);
+        }
+    }
+}
+
+void NameSubstringIndex::clear()
+{
+    _postings.clear();
+    _names = nullptr;
+}
+
+bool NameSubstringIndex::query(const std::string & pattern, const std::function<bool(const NameIndex &)> & cbFound, size_t maxResults) const
+{
+    if(!_names)
+        return false;
+
+    std::string folded;
+    folded.resize(pattern.size());
+    std::transform(pattern.begin(), pattern.end(), folded.begin(), foldCase);
+
+    size_t results = 0;
+    if(folded.size() < 3)
+    {
+        // Too short for a trigram, scan the names linearly (still cheaper than
+        // the callers doing it because long patterns never take this path)
+        for(const auto & nameIndex : *_names)
+        {
+            if(!folded.empty() && !containsFolded(nameIndex.name, folded))
+                continue;
+            if(!cbFound(nameIndex) || ++results >= maxResults)
+                break;
+        }
+        return true;
+    }
+
+    // Every name containing the pattern is on each of these posting lists, so
+    // only the shortest one has to be verified
+    const std::vector<uint32_t>* rarest = nullptr;
+    for(size_t i = 0; i + 3 <= folded.size(); i++)
+    {
+        auto found = _postings.find(foldedTrigram(folded.c_str() + i));
+        if(found == _postings.end())
+            return true; //a trigram of the pattern never occurs -> no results
+        if(!rarest || found->second.size() < rarest->size())
+            rarest = &found->second;
+    }
+
+    for(auto position : *rarest)
+    {
+        const auto & nameIndex = (*_names)[position];
+        if(!containsFolded(nameIndex.name, folded))
+            continue;
+        if(!cbFound(nameIndex) || ++results >= maxResults)
+            break;
+    }
+    return true;
+}
+
 bool SymbolSourceBase::mapSourceFilePdbToDisk(const std::string & pdb, const std::string & disk)
 {
     std::string pdblower = pdb, disklower = disk;
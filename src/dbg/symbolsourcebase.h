@@ -7,6 +7,7 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 
 //http://en.cppreference.com/w/cpp/algorithm/lower_bound
@@ -74,6 +75,33 @@ struct NameIndex
     static bool findByName(const std::vector<NameIndex> & byName, const std::string & name, NameIndex & foundIndex, bool caseSensitive);
 };
 
+// Case-folded trigram index for substring filtering over symbol names. Built
+// once after a symbol source finished loading; a query walks the rarest
+// posting list of the pattern's trigrams and verifies candidates with a real
+// case-insensitive substring search, so typing in the symbol search box
+// touches a few thousand candidates instead of every loaded name.
+class NameSubstringIndex
+{
+public:
+    void build(const std::vector<NameIndex> & names);
+    void clear();
+
+    bool empty() const
+    {
+        return _names == nullptr;
+    }
+
+    // Returns false when the index was never built; patterns too short for a
+    // trigram are answered with a linear scan over the indexed names.
+    bool query(const std::string & pattern, const std::function<bool(const NameIndex &)> & cbFound, size_t maxResults) const;
+
+private:
+    static uint32_t foldedTrigram(const char* str);
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> _postings; //trigram -> positions in the name vector
+    const std::vector<NameIndex>* _names = nullptr;
+};
+
 using CbEnumSymbol = std::function<bool(const SymbolInfo &)>;
 
 class SymbolSourceBase
@@ -170,6 +198,13 @@ public:
         return false; // Stub
     }
 
+    // Case-insensitive substring filter over all symbol names, capped at
+    // maxResults. Returns false when the source has no substring index.
+    virtual bool findSymbolsBySubstring(const std::string & pattern, const std::function<bool(const SymbolInfo &)> & cbSymbol, size_t maxResults)
+    {
+        return false; // Stub
+    }
+
     virtual std::string loadedSymbolPath() const
     {
         return ""; // Stub
@@ -1,7 +1,11 @@
 #include "symbolsourcedia.h"
 #include "console.h"
 #include "debugger.h"
+#include "filehelper.h"
+#include "value.h"
+#include "performance.h"
 #include <algorithm>
+#include <ppl.h>
 
 SymbolSourceDIA::SymbolSourceDIA()
     : _isOpen(false),
@@ -56,15 +60,16 @@ bool SymbolSourceDIA::loadPDB(const std::string & path, const std::string & modn
         _imageSize = imageSize;
         _modname = modname;
         _imageBase = imageBase;
+        _hasValidationData = validationData != nullptr;
+        if(validationData)
+            _validationData = *validationData;
         _requiresShutdown = false;
         _symbolsLoaded = false;
-        _loadCounter.store(2);
+        _loadCounter.store(1);
         _symbolsThread = CreateThread(nullptr, 0, SymbolsThread, this, CREATE_SUSPENDED, nullptr);
         SetWin10ThreadDescription(_symbolsThread, L"SymbolsThread");
-        _sourceLinesThread = CreateThread(nullptr, 0, SourceLinesThread, this, CREATE_SUSPENDED, nullptr);
-        SetWin10ThreadDescription(_sourceLinesThread, L"SourceLinesThread");
         ResumeThread(_symbolsThread);
-        ResumeThread(_sourceLinesThread);
+        //source lines are ingested lazily on the first line query (requestSourceLines)
     }
     return _isOpen;
 }
@@ -109,12 +114,328 @@ static bool startsWith(const char* str, const char(&prefix)[Count])
     return strncmp(str, prefix, Count - 1) == 0;
 }
 
+//Binary (de)serialization helpers for the on-disk symbol cache. All sizes and
+//indices are stored as fixed-width integers so the x32 and x64 builds share
+//the same format.
+static const uint32_t SymbolCacheMagic = 0x43535844; //'DXSC'
+static const uint32_t SymbolCacheVersion = 1;
+
+struct SymbolCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    GUID guid;
+    uint32_t signature;
+    uint32_t age;
+};
+
+static void cacheAppend(std::vector<unsigned char> & buf, const void* data, size_t size)
+{
+    auto ptr = (const unsigned char*)data;
+    buf.insert(buf.end(), ptr, ptr + size);
+}
+
+template<typename T>
+static void cacheAppendValue(std::vector<unsigned char> & buf, const T & value)
+{
+    cacheAppend(buf, &value, sizeof(value));
+}
+
+static void cacheAppendString(std::vector<unsigned char> & buf, const String & str)
+{
+    cacheAppendValue(buf, uint32_t(str.size()));
+    cacheAppend(buf, str.data(), str.size());
+}
+
+struct CacheReader
+{
+    const unsigned char* ptr;
+    size_t remaining;
+
+    explicit CacheReader(const std::vector<unsigned char> & data)
+        : ptr(data.data()), remaining(data.size()) { }
+
+    bool read(void* dest, size_t size)
+    {
+        if(size > remaining)
+            return false;
+        memcpy(dest, ptr, size);
+        ptr += size;
+        remaining -= size;
+        return true;
+    }
+
+    template<typename T>
+    bool readValue(T & value)
+    {
+        return read(&value, sizeof(value));
+    }
+
+    bool readString(String & str)
+    {
+        uint32_t len = 0;
+        if(!readValue(len) || len > remaining)
+            return false;
+        str.assign((const char*)ptr, len);
+        ptr += len;
+        remaining -= len;
+        return true;
+    }
+
+    bool readHeader(const DiaValidationData_t & validationData)
+    {
+        SymbolCacheHeader header;
+        if(!readValue(header))
+            return false;
+        return header.magic == SymbolCacheMagic &&
+               header.version == SymbolCacheVersion &&
+               memcmp(&header.guid, &validationData.guid, sizeof(GUID)) == 0 &&
+               header.signature == validationData.signature &&
+               header.age == validationData.age;
+    }
+};
+
+static void cacheAppendHeader(std::vector<unsigned char> & buf, const DiaValidationData_t & validationData)
+{
+    SymbolCacheHeader header;
+    header.magic = SymbolCacheMagic;
+    header.version = SymbolCacheVersion;
+    memcpy(&header.guid, &validationData.guid, sizeof(GUID));
+    header.signature = validationData.signature;
+    header.age = validationData.age;
+    cacheAppendValue(buf, header);
+}
+
+bool SymbolSourceDIA::trySymbolCacheLoad()
+{
+    if(!_hasValidationData)
+        return false;
+
+    std::vector<unsigned char> data;
+    if(!FileHelper::ReadAllData(_path + ".symcache", data))
+        return false;
+
+    auto failed = [this]()
+    {
+        _symData.clear();
+        _symAddrMap.clear();
+        _symNameMap.clear();
+        return false;
+    };
+
+    CacheReader reader(data);
+    if(!reader.readHeader(_validationData))
+        return false;
+
+    uint64_t symCount = 0, mapCount = 0;
+    if(!reader.readValue(symCount) || !reader.readValue(mapCount))
+        return false;
+    if(symCount > reader.remaining || mapCount > symCount) //corrupt or truncated
+        return false;
+
+    _symData.resize(size_t(symCount));
+    for(auto & sym : _symData)
+    {
+        uint64_t rva = 0, size = 0;
+        unsigned char publicSymbol = 0;
+        if(!reader.readValue(rva) ||
+                !reader.readValue(size) ||
+                !reader.readValue(sym.disp) ||
+                !reader.readValue(publicSymbol) ||
+                !reader.readString(sym.decoratedName) ||
+                !reader.readString(sym.undecoratedName))
+            return failed();
+        sym.rva = duint(rva);
+        sym.size = duint(size);
+        sym.publicSymbol = publicSymbol != 0;
+    }
+
+    _symAddrMap.resize(size_t(mapCount));
+    for(auto & addrIndex : _symAddrMap)
+    {
+        uint64_t addr = 0, index = 0;
+        if(!reader.readValue(addr) || !reader.readValue(index) || index >= symCount)
+            return failed();
+        addrIndex.addr = duint(addr);
+        addrIndex.index = size_t(index);
+    }
+
+    _symNameMap.resize(size_t(mapCount));
+    for(auto & nameIndex : _symNameMap)
+    {
+        uint64_t index = 0;
+        if(!reader.readValue(index) || index >= symCount)
+            return failed();
+        nameIndex.name = _symData[size_t(index)].decoratedName.c_str();
+        nameIndex.index = size_t(index);
+    }
+
+    _symSubstringIndex.build(_symNameMap);
+    return true;
+}
+
+void SymbolSourceDIA::symbolCacheSave() const
+{
+    if(!_hasValidationData)
+        return;
+
+    std::vector<unsigned char> data;
+    data.reserve(sizeof(SymbolCacheHeader) + _symData.size() * 64);
+    cacheAppendHeader(data, _validationData);
+    cacheAppendValue(data, uint64_t(_symData.size()));
+    cacheAppendValue(data, uint64_t(_symAddrMap.size()));
+    for(const auto & sym : _symData)
+    {
+        cacheAppendValue(data, uint64_t(sym.rva));
+        cacheAppendValue(data, uint64_t(sym.size));
+        cacheAppendValue(data, sym.disp);
+        cacheAppendValue(data, (unsigned char)(sym.publicSymbol ? 1 : 0));
+        cacheAppendString(data, sym.decoratedName);
+        cacheAppendString(data, sym.undecoratedName);
+    }
+    for(const auto & addrIndex : _symAddrMap)
+    {
+        cacheAppendValue(data, uint64_t(addrIndex.addr));
+        cacheAppendValue(data, uint64_t(addrIndex.index));
+    }
+    for(const auto & nameIndex : _symNameMap)
+        cacheAppendValue(data, uint64_t(nameIndex.index));
+    FileHelper::WriteAllData(_path + ".symcache", data.data(), data.size());
+}
+
+bool SymbolSourceDIA::tryLineCacheLoad()
+{
+    if(!_hasValidationData)
+        return false;
+
+    std::vector<unsigned char> data;
+    if(!FileHelper::ReadAllData(_path + ".linecache", data))
+        return false;
+
+    auto failed = [this]()
+    {
+        _linesData.clear();
+        _lineAddrMap.clear();
+        _sourceFiles.clear();
+        _sourceLines.clear();
+        _sourceFileMap.clear();
+        return false;
+    };
+
+    CacheReader reader(data);
+    if(!reader.readHeader(_validationData))
+        return false;
+
+    uint64_t lineCount = 0, fileCount = 0;
+    if(!reader.readValue(lineCount) || !reader.readValue(fileCount))
+        return false;
+    if(lineCount > reader.remaining || fileCount > reader.remaining) //corrupt or truncated
+        return false;
+
+    _linesData.resize(size_t(lineCount));
+    for(auto & line : _linesData)
+    {
+        if(!reader.readValue(line.rva) ||
+                !reader.readValue(line.lineNumber) ||
+                !reader.readValue(line.sourceFileIndex) ||
+                line.sourceFileIndex >= fileCount)
+            return failed();
+    }
+
+    _lineAddrMap.resize(size_t(lineCount));
+    for(auto & addrIndex : _lineAddrMap)
+    {
+        uint64_t addr = 0, index = 0;
+        if(!reader.readValue(addr) || !reader.readValue(index) || index >= lineCount || addr > 0xFFFFFFFF)
+            return failed();
+        addrIndex.rva = uint32(addr);
+        addrIndex.index = uint32(index);
+    }
+
+    _sourceFiles.resize(size_t(fileCount));
+    for(auto & file : _sourceFiles)
+    {
+        if(!reader.readString(file))
+            return failed();
+    }
+
+    _sourceLines.resize(size_t(fileCount));
+    for(auto & lineMap : _sourceLines)
+    {
+        uint64_t count = 0;
+        if(!reader.readValue(count) || count > lineCount)
+            return failed();
+        lineMap.resize(size_t(count));
+        for(auto & lineIndex : lineMap)
+        {
+            if(!reader.readValue(lineIndex.line) || !reader.readValue(lineIndex.index) || lineIndex.index >= lineCount)
+                return failed();
+        }
+    }
+
+    return true;
+}
+
+void SymbolSourceDIA::lineCacheSave() const
+{
+    if(!_hasValidationData)
+        return;
+
+    std::vector<unsigned char> data;
+    data.reserve(sizeof(SymbolCacheHeader) + _linesData.size() * 32);
+    cacheAppendHeader(data, _validationData);
+    cacheAppendValue(data, uint64_t(_linesData.size()));
+    cacheAppendValue(data, uint64_t(_sourceFiles.size()));
+    for(const auto & line : _linesData)
+    {
+        cacheAppendValue(data, line.rva);
+        cacheAppendValue(data, line.lineNumber);
+        cacheAppendValue(data, line.sourceFileIndex);
+    }
+    for(const auto & addrIndex : _lineAddrMap)
+    {
+        cacheAppendValue(data, uint64_t(addrIndex.rva));
+        cacheAppendValue(data, uint64_t(addrIndex.index));
+    }
+    for(const auto & file : _sourceFiles)
+        cacheAppendString(data, file);
+    for(const auto & lineMap : _sourceLines)
+    {
+        cacheAppendValue(data, uint64_t(lineMap.size()));
+        for(const auto & lineIndex : lineMap)
+        {
+            cacheAppendValue(data, lineIndex.line);
+            cacheAppendValue(data, lineIndex.index);
+        }
+    }
+    FileHelper::WriteAllData(_path + ".linecache", data.data(), data.size());
+}
+
 bool SymbolSourceDIA::loadSymbolsAsync()
 {
+    PerfScope perf(PerfPhase::SymbolLoad);
     ScopedDecrement ref(_loadCounter);
 
     GuiRepaintTableView();
 
+    DWORD lastUpdate = 0;
+    DWORD loadStart = GetTickCount();
+
+    //A cache from a previous session skips the DIA ingestion entirely
+    if(trySymbolCacheLoad())
+    {
+        _symbolsLoaded = true;
+
+        DWORD ms = GetTickCount() - loadStart;
+        double secs = (double)ms / 1000.0;
+        GuiSymbolLogAdd(StringUtils::sprintf("[%p, %s] Loaded %u cached symbols in %.03fs\n", _imageBase, _modname.c_str(), _symAddrMap.size(), secs).c_str());
+
+        valnamecacheclear(); //cached misses for this module are stale now
+        GuiInvalidateSymbolSource(_imageBase);
+        GuiUpdateAllViews();
+        return true;
+    }
+
     PDBDiaFile pdb;
 
     if(!pdb.open(_path.c_str()))
@@ -122,9 +443,6 @@ bool SymbolSourceDIA::loadSymbolsAsync()
         return false;
     }
 
-    DWORD lastUpdate = 0;
-    DWORD loadStart = GetTickCount();
-
     PDBDiaFile::Query_t query;
     query.collectSize = false;
     query.collectUndecoratedNames = true;
@@ -179,7 +497,7 @@ bool SymbolSourceDIA::loadSymbolsAsync()
             addrIndex.index = i;
             _symAddrMap[i] = addrIndex;
         }
-        std::sort(_symAddrMap.begin(), _symAddrMap.end(), [this](const AddrIndex & a, const AddrIndex & b)
+        concurrency::parallel_sort(_symAddrMap.begin(), _symAddrMap.end(), [this](const AddrIndex & a, const AddrIndex & b)
         {
             // smaller
             if(a.addr < b.addr)
@@ -233,7 +551,12 @@ bool SymbolSourceDIA::loadSymbolsAsync()
             nameIndex.index = symIndex;
             _symNameMap[i] = nameIndex;
         }
-        std::sort(_symNameMap.begin(), _symNameMap.end());
+        // The name comparisons dominate load time on big PDBs, sort them on all cores
+        concurrency::parallel_sort(_symNameMap.begin(), _symNameMap.end());
+
+        // Built once here so interactive substring filtering does not have to
+        // walk every name per keystroke
+        _symSubstringIndex.build(_symNameMap);
     }
 
     if(_requiresShutdown)
@@ -241,11 +564,14 @@ bool SymbolSourceDIA::loadSymbolsAsync()
 
     _symbolsLoaded = true;
 
+    symbolCacheSave();
+
     DWORD ms = GetTickCount() - loadStart;
     double secs = (double)ms / 1000.0;
 
     GuiSymbolLogAdd(StringUtils::sprintf("[%p, %s] Loaded %u symbols in %.03fs\n", _imageBase, _modname.c_str(), _symAddrMap.size(), secs).c_str());
 
+    valnamecacheclear(); //cached misses for this module are stale now
     GuiInvalidateSymbolSource(_imageBase);
 
     GuiUpdateAllViews();
@@ -259,6 +585,22 @@ bool SymbolSourceDIA::loadSourceLinesAsync()
 
     GuiRepaintTableView();
 
+    DWORD lineLoadStart = GetTickCount();
+
+    //A cache from a previous session skips the DIA ingestion entirely
+    if(tryLineCacheLoad())
+    {
+        buildSourceFileMap();
+        _linesLoaded = true;
+
+        DWORD ms = GetTickCount() - lineLoadStart;
+        double secs = (double)ms / 1000.0;
+        GuiSymbolLogAdd(StringUtils::sprintf("[%p, %s] Loaded %d cached line infos in %.03fs\n", _imageBase, _modname.c_str(), _linesData.size(), secs).c_str());
+
+        GuiUpdateAllViews();
+        return true;
+    }
+
     PDBDiaFile pdb;
 
     if(!pdb.open(_path.c_str()))
@@ -266,14 +608,56 @@ bool SymbolSourceDIA::loadSourceLinesAsync()
         return false;
     }
 
-    DWORD lineLoadStart = GetTickCount();
-
     const uint32_t rangeSize = 1024 * 1024 * 10;
 
     std::vector<DiaLineInfo_t> lines;
     std::map<DWORD, String> files;
 
-    if(!pdb.enumerateLineNumbers(0, uint32_t(_imageSize), lines, files, _requiresShutdown))
+    // Partition the image into ranges enumerated concurrently, each worker
+    // with its own DIA session (DIA sessions are apartment-bound, so splitting
+    // one session is not an option). Merged in range order the result is the
+    // same as a single full-image enumeration.
+    auto rangeCount = uint32_t((_imageSize + rangeSize - 1) / rangeSize);
+    if(rangeCount > 1)
+    {
+        std::vector<std::vector<DiaLineInfo_t>> rangeLines(rangeCount);
+        std::vector<std::map<DWORD, String>> rangeFiles(rangeCount);
+        std::atomic<bool> enumFailed(false);
+        concurrency::parallel_for(uint32_t(0), rangeCount, [&](uint32_t r)
+        {
+            if(_requiresShutdown || enumFailed)
+                return;
+            PDBDiaFile rangePdb;
+            if(!rangePdb.open(_path.c_str()))
+            {
+                enumFailed = true;
+                return;
+            }
+            auto rangeStart = r * rangeSize;
+            auto rangeLength = min(rangeSize, uint32_t(_imageSize) - rangeStart);
+            if(!rangePdb.enumerateLineNumbers(rangeStart, rangeLength, rangeLines[r], rangeFiles[r], _requiresShutdown))
+                enumFailed = true;
+        });
+        if(enumFailed || _requiresShutdown)
+            return false;
+
+        size_t totalLines = 0;
+        for(const auto & rl : rangeLines)
+            totalLines += rl.size();
+        lines.reserve(totalLines);
+        for(uint32_t r = 0; r < rangeCount; r++)
+        {
+            for(const auto & line : rangeLines[r])
+            {
+                // Drop duplicates of records reported on both sides of a range boundary
+                if(!lines.empty() && lines.back().rva == line.rva && lines.back().lineNumber == line.lineNumber && lines.back().sourceFileId == line.sourceFileId)
+                    continue;
+                lines.push_back(line);
+            }
+            files.insert(rangeFiles[r].begin(), rangeFiles[r].end());
+        }
+    }
+    else if(!pdb.enumerateLineNumbers(0, uint32_t(_imageSize), lines, files, _requiresShutdown))
         return false;
 
     if(files.size() == 1)
@@ -344,9 +728,9 @@ bool SymbolSourceDIA::loadSourceLinesAsync()
         found->second.lineCount++;
         lineInfo.sourceFileIndex = found->second.sourceFileIndex;
 
-        AddrIndex lineIndex;
-        lineIndex.addr = lineInfo.rva;
-        lineIndex.index = _linesData.size() - 1;
+        LineAddrIndex lineIndex;
+        lineIndex.rva = lineInfo.rva;
+        lineIndex.index = uint32(_linesData.size() - 1);
         _lineAddrMap.push_back(lineIndex);
     }
 
@@ -378,8 +762,11 @@ bool SymbolSourceDIA::loadSourceLinesAsync()
     if(_requiresShutdown)
         return false;
 
+    buildSourceFileMap();
     _linesLoaded = true;
 
+    lineCacheSave();
+
     DWORD ms = GetTickCount() - lineLoadStart;
     double secs = (double)ms / 1000.0;
 
@@ -390,6 +777,23 @@ bool SymbolSourceDIA::loadSourceLinesAsync()
     return true;
 }
 
+// Sorted name index over _sourceFiles, built once when the line data is
+// ready. Every line in SourceView resolves its address through
+// findSourceFile, so this lookup has to be O(log n) rather than a scan
+// over every file name in the PDB.
+void SymbolSourceDIA::buildSourceFileMap()
+{
+    _sourceFileMap.reserve(_sourceFiles.size());
+    for(size_t i = 0; i < _sourceFiles.size(); i++)
+    {
+        NameIndex nameIndex;
+        nameIndex.name = _sourceFiles[i].c_str();
+        nameIndex.index = i;
+        _sourceFileMap.push_back(nameIndex);
+    }
+    std::sort(_sourceFileMap.begin(), _sourceFileMap.end());
+}
+
 uint32_t SymbolSourceDIA::findSourceFile(const std::string & fileName) const
 {
     // Map the disk file name back to PDB file name
@@ -397,18 +801,10 @@ uint32_t SymbolSourceDIA::findSourceFile(const std::string & fileName) const
     if(!getSourceFileDiskToPdb(fileName, mappedFileName))
         mappedFileName = fileName;
 
-    //TODO: make this fast
-    uint32_t idx = -1;
-    for(uint32_t n = 0; n < _sourceFiles.size(); n++)
-    {
-        const String & str = _sourceFiles[n];
-        if(_stricmp(str.c_str(), mappedFileName.c_str()) == 0)
-        {
-            idx = n;
-            break;
-        }
-    }
-    return idx;
+    NameIndex found;
+    if(!NameIndex::findByName(_sourceFileMap, mappedFileName, found, false))
+        return -1;
+    return uint32_t(found.index);
 }
 
 bool SymbolSourceDIA::findSymbolExact(duint rva, SymbolInfo & symInfo)
@@ -485,14 +881,31 @@ void SymbolSourceDIA::enumSymbols(const CbEnumSymbol & cbEnum)
     }
 }
 
+// Source lines are only ingested once something actually asks for them, so
+// modules whose source is never viewed skip the line enumeration (and the
+// memory for its tables) entirely. Queries return false until the worker
+// finishes; it repaints the views when the data arrives.
+void SymbolSourceDIA::requestSourceLines()
+{
+    if(_requiresShutdown || _linesLoadRequested.exchange(true))
+        return;
+    _loadCounter++;
+    _sourceLinesThread = CreateThread(nullptr, 0, SourceLinesThread, this, CREATE_SUSPENDED, nullptr);
+    SetWin10ThreadDescription(_sourceLinesThread, L"SourceLinesThread");
+    ResumeThread(_sourceLinesThread);
+}
+
 bool SymbolSourceDIA::findSourceLineInfo(duint rva, LineInfo & lineInfo)
 {
     if(!_linesLoaded)
+    {
+        requestSourceLines();
         return false;
+    }
 
-    AddrIndex find;
-    find.addr = rva;
-    find.index = -1;
+    LineAddrIndex find;
+    find.rva = uint32(rva);
+    find.index = 0;
     auto it = binary_find(_lineAddrMap.begin(), _lineAddrMap.end(), find);
     if(it == _lineAddrMap.end())
         return false;
@@ -510,7 +923,10 @@ bool SymbolSourceDIA::findSourceLineInfo(duint rva, LineInfo & lineInfo)
 bool SymbolSourceDIA::findSourceLineInfo(const std::string & file, int line, LineInfo & lineInfo)
 {
     if(!_linesLoaded)
+    {
+        requestSourceLines();
         return false;
+    }
 
     auto sourceIdx = findSourceFile(file);
     if(sourceIdx == -1)
@@ -557,6 +973,17 @@ bool SymbolSourceDIA::findSymbolsByPrefix(const std::string & prefix, const std:
     }, caseSensitive);
 }
 
+bool SymbolSourceDIA::findSymbolsBySubstring(const std::string & pattern, const std::function<bool(const SymbolInfo &)> & cbSymbol, size_t maxResults)
+{
+    if(!_symbolsLoaded)
+        return false;
+
+    return _symSubstringIndex.query(pattern, [this, &cbSymbol](const NameIndex & index)
+    {
+        return cbSymbol(_symData[index.index]);
+    }, maxResults);
+}
+
 std::string SymbolSourceDIA::loadedSymbolPath() const
 {
     return _path;
@@ -46,10 +46,22 @@ private: //symbols
 
     std::vector<AddrIndex> _symAddrMap; //rva -> data index (sorted on rva)
     std::vector<NameIndex> _symNameMap; //name -> data index (sorted on name)
+    NameSubstringIndex _symSubstringIndex; //trigram index over _symNameMap
+
+    struct LineAddrIndex
+    {
+        uint32 rva;
+        uint32 index;
+
+        bool operator<(const LineAddrIndex & b) const
+        {
+            return rva < b.rva;
+        }
+    };
 
 private: //line info
     std::vector<CachedLineInfo> _linesData;
-    std::vector<AddrIndex> _lineAddrMap; //addr -> line
+    std::vector<LineAddrIndex> _lineAddrMap; //rva -> line (8-byte entries, half an AddrIndex)
     std::vector<String> _sourceFiles; // uniqueId + name
 
     struct LineIndex
@@ -64,6 +76,7 @@ private: //line info
     };
 
     std::vector<std::vector<LineIndex>> _sourceLines; //uses index in _sourceFiles
+    std::vector<NameIndex> _sourceFileMap; //file name -> index in _sourceFiles (sorted on name)
 
 private: //general
     HANDLE _symbolsThread = nullptr;
@@ -78,6 +91,9 @@ private: //general
     duint _imageSize;
     std::atomic<bool> _symbolsLoaded = false;
     std::atomic<bool> _linesLoaded = false;
+    std::atomic<bool> _linesLoadRequested = false;
+    DiaValidationData_t _validationData = {};
+    bool _hasValidationData = false;
 
 private:
     static int hackicmp(const char* s1, const char* s2)
@@ -126,6 +142,8 @@ public:
 
     virtual bool findSymbolsByPrefix(const std::string & prefix, const std::function<bool(const SymbolInfo &)> & cbSymbol, bool caseSensitive) override;
 
+    virtual bool findSymbolsBySubstring(const std::string & pattern, const std::function<bool(const SymbolInfo &)> & cbSymbol, size_t maxResults) override;
+
     virtual std::string loadedSymbolPath() const override;
 
 public:
@@ -134,8 +152,18 @@ public:
 private:
     bool loadSymbolsAsync();
     bool loadSourceLinesAsync();
+    void requestSourceLines();
+    void buildSourceFileMap();
     uint32_t findSourceFile(const std::string & fileName) const;
 
+    //On-disk cache of the ingested symbol/line vectors, keyed by the PDB
+    //GUID/signature/age, so a PDB already seen in a previous session loads
+    //without going through DIA again.
+    bool trySymbolCacheLoad();
+    void symbolCacheSave() const;
+    bool tryLineCacheLoad();
+    void lineCacheSave() const;
+
     static DWORD WINAPI SymbolsThread(void* parameter);
     static DWORD WINAPI SourceLinesThread(void* parameter);
 };
@@ -2,6 +2,7 @@
 #include "dbghelp_safe.h"
 #include "addrinfo.h"
 #include "threading.h"
+#include "value.h"
 #include <algorithm>
 
 /*template<typename T>
@@ -10,11 +11,60 @@ using RangeMap = std::map<Range, T, RangeCompare>;
 static RangeMap<RangeMap<SymbolInfo>> symbolRange;
 static std::unordered_map<duint, duint> symbolName;*/
 
-bool SymbolFromAddressExact(duint address, SymbolInfo & symInfo)
+// Per-thread first level in front of the per-module symbol stores. Every
+// rendered address funnels through the two lookups below and consecutive
+// repaints mostly resolve the same screenful of addresses, so a hit skips the
+// module lock and the binary search in the symbol store. Slots are
+// direct-mapped by address and validated against the name cache epoch, which
+// is bumped whenever modules, labels or symbols change, so stale entries
+// (including cached misses) are simply ignored.
+struct SymbolResolutionCache
 {
-    if(address == 0)
-        return false;
+    static const size_t Slots = 64;
+
+    bool get(duint address, duint epoch, bool & found, SymbolInfo & symInfo)
+    {
+        auto & entry = slot(address);
+        if(!entry.valid || entry.address != address || entry.epoch != epoch)
+            return false;
+        found = entry.found;
+        if(found)
+            symInfo = entry.info;
+        return true;
+    }
+
+    void put(duint address, duint epoch, bool found, const SymbolInfo & symInfo)
+    {
+        auto & entry = slot(address);
+        entry.address = address;
+        entry.epoch = epoch;
+        entry.found = found;
+        entry.info = found ? symInfo : SymbolInfo();
+        entry.valid = true;
+    }
+
+private:
+    struct CachedResolution
+    {
+        duint address = 0;
+        duint epoch = 0;
+        bool found = false;
+        bool valid = false;
+        SymbolInfo info;
+    };
+
+    CachedResolution & slot(duint address)
+    {
+        //instruction addresses mostly differ in the low bits, fold some
+        //higher ones in so neighbouring modules do not map to the same slots
+        return entries[(address ^ (address >> 6)) % Slots];
+    }
+
+    CachedResolution entries[Slots];
+};
 
+static bool symbolResolveExact(duint address, SymbolInfo & symInfo)
+{
     SHARED_ACQUIRE(LockModules);
     MODINFO* modInfo = ModInfoFromAddr(address);
     if(modInfo)
@@ -46,11 +96,24 @@ bool SymbolFromAddressExact(duint address, SymbolInfo & symInfo)
     return false;
 }
 
-bool SymbolFromAddressExactOrLower(duint address, SymbolInfo & symInfo)
+bool SymbolFromAddressExact(duint address, SymbolInfo & symInfo)
 {
     if(address == 0)
         return false;
 
+    static thread_local SymbolResolutionCache cache;
+    auto epoch = valnamecacheepoch();
+    bool found = false;
+    if(cache.get(address, epoch, found, symInfo))
+        return found;
+
+    found = symbolResolveExact(address, symInfo);
+    cache.put(address, epoch, found, symInfo);
+    return found;
+}
+
+static bool symbolResolveExactOrLower(duint address, SymbolInfo & symInfo)
+{
     SHARED_ACQUIRE(LockModules);
     MODINFO* modInfo = ModInfoFromAddr(address);
     if(modInfo)
@@ -65,6 +128,22 @@ bool SymbolFromAddressExactOrLower(duint address, SymbolInfo & symInfo)
     return false;
 }
 
+bool SymbolFromAddressExactOrLower(duint address, SymbolInfo & symInfo)
+{
+    if(address == 0)
+        return false;
+
+    static thread_local SymbolResolutionCache cache;
+    auto epoch = valnamecacheepoch();
+    bool found = false;
+    if(cache.get(address, epoch, found, symInfo))
+        return found;
+
+    found = symbolResolveExactOrLower(address, symInfo);
+    cache.put(address, epoch, found, symInfo);
+    return found;
+}
+
 /*bool SymbolFromAddr(duint addr, SymbolInfo & symbol)
 {
     SHARED_ACQUIRE(LockSymbolCache);
@@ -5,14 +5,68 @@
  */
 
 #include "thread.h"
+#include "console.h"
 #include "memory.h"
 #include "threading.h"
 #include "ntdll/ntdll.h"
 #include "debugger.h"
+#include <ppl.h>
+#include <thread>
 
 static std::unordered_map<DWORD, THREADINFO> threadList;
 static std::unordered_map<DWORD, THREADWAITREASON> threadWaitReasons;
 
+// Cached per-thread details (context, suspend count, priority, times, cycles).
+// Querying these takes several syscalls per thread, which dominates the thread
+// view refresh on targets with hundreds of threads. The cache survives until
+// the target state changes (debug event, manual suspend/resume, ...).
+static std::unordered_map<DWORD, THREADALLINFO> threadDetailCache;
+static volatile bool threadDetailCacheValid = false;
+
+// Sampled per-thread cycle counter history. A background thread reads every
+// thread's cycle counter in one batched pass at a few Hz while the target
+// runs and keeps the deltas in small ring buffers, so the thread view can
+// show which thread is burning CPU before breaking in. The overhead is
+// bounded by design: one QueryThreadCycleTime syscall per thread per tick,
+// and nothing at all while the target is paused.
+static const int ThreadCycleHistoryDepth = 32;
+
+struct THREADCYCLEHISTORY
+{
+    ULONG64 lastCycles = 0;
+    ULONG64 deltas[ThreadCycleHistoryDepth] = {};
+    int head = 0; //next write slot
+    int count = 0; //valid slots
+};
+
+static std::unordered_map<DWORD, THREADCYCLEHISTORY> threadCycleHistory;
+static bool threadCycleSamplerStarted = false;
+
+static void ThreadCycleSampler()
+{
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+    for(;;)
+    {
+        Sleep(250);
+        if(!dbgisrunning())
+            continue;
+        EXCLUSIVE_ACQUIRE(LockThreads);
+        for(auto & itr : threadList)
+        {
+            auto & history = threadCycleHistory[itr.first];
+            auto cycles = ThreadQueryCycleTime(itr.second.Handle);
+            if(history.lastCycles && cycles >= history.lastCycles)
+            {
+                history.deltas[history.head] = cycles - history.lastCycles;
+                history.head = (history.head + 1) % ThreadCycleHistoryDepth;
+                if(history.count < ThreadCycleHistoryDepth)
+                    history.count++;
+            }
+            history.lastCycles = cycles;
+        }
+    }
+}
+
 // Function pointer for dynamic linking. Do not link statically for Windows XP compatibility.
 // TODO: move this function definition out of thread.cpp
 BOOL(WINAPI* QueryThreadCycleTime)(HANDLE ThreadHandle, PULONG64 CycleTime) = nullptr;
@@ -39,13 +93,21 @@ void ThreadCreate(CREATE_THREAD_DEBUG_INFO* CreateThread)
 
     // The first thread (#0) is always the main program thread
     if(curInfo.ThreadNumber <= 0)
-        strcpy_s(curInfo.threadName, GuiTranslateText(QT_TRANSLATE_NOOP("DBG", "Main Thread")));
+        strcpy_s(curInfo.threadName, dtranslate(QT_TRANSLATE_NOOP("DBG", "Main Thread")));
     else
         curInfo.threadName[0] = 0;
 
     // Modify global thread list
     EXCLUSIVE_ACQUIRE(LockThreads);
     threadList.insert(std::make_pair(curInfo.ThreadId, curInfo));
+    threadDetailCacheValid = false;
+
+    // The first thread of the first session starts the cycle sampler
+    if(!threadCycleSamplerStarted)
+    {
+        threadCycleSamplerStarted = true;
+        std::thread(ThreadCycleSampler).detach();
+    }
     EXCLUSIVE_RELEASE();
 
     // Notify GUI
@@ -65,6 +127,9 @@ void ThreadExit(DWORD ThreadId)
         threadList.erase(itr);
     }
 
+    threadDetailCache.erase(ThreadId);
+    threadCycleHistory.erase(ThreadId);
+    threadDetailCacheValid = false;
     EXCLUSIVE_RELEASE();
     GuiUpdateThreadView();
 }
@@ -79,6 +144,9 @@ void ThreadClear()
 
     // Empty the array
     threadList.clear();
+    threadDetailCache.clear();
+    threadCycleHistory.clear();
+    threadDetailCacheValid = false;
 
     // Update the GUI's list
     EXCLUSIVE_RELEASE();
@@ -91,10 +159,31 @@ int ThreadGetCount()
     return (int)threadList.size();
 }
 
+static void ThreadFillDetail(THREADALLINFO & Info)
+{
+    HANDLE threadHandle = Info.BasicInfo.Handle;
+
+    // Unused thread exit time
+    FILETIME threadExitTime;
+
+    Info.ThreadCip = GetContextDataEx(threadHandle, UE_CIP);
+    Info.SuspendCount = ThreadGetSuspendCount(threadHandle);
+    Info.Priority = ThreadGetPriority(threadHandle);
+    Info.LastError = ThreadGetLastErrorTEB(Info.BasicInfo.ThreadLocalBase);
+    GetThreadTimes(threadHandle, &Info.CreationTime, &threadExitTime, &Info.KernelTime, &Info.UserTime);
+    Info.Cycles = ThreadQueryCycleTime(threadHandle);
+}
+
+void ThreadDetailsInvalidate()
+{
+    // Single flag write, safe to call from any context
+    threadDetailCacheValid = false;
+}
+
 void ThreadGetList(THREADLIST* List)
 {
     ASSERT_NONNULL(List);
-    SHARED_ACQUIRE(LockThreads);
+    EXCLUSIVE_ACQUIRE(LockThreads);
 
     //
     // This function converts a C++ std::unordered_map to a C-style THREADLIST[].
@@ -109,11 +198,10 @@ void ThreadGetList(THREADLIST* List)
     // Allocate C-style array
     List->list = (THREADALLINFO*)BridgeAlloc(List->count * sizeof(THREADALLINFO));
 
-    // Fill out the list data
+    // Fill out the cheap identity data, serving the expensive details from
+    // the cache when it is still valid
     int index = 0;
-
-    // Unused thread exit time
-    FILETIME threadExitTime;
+    std::vector<int> missing;
 
     for(auto & itr : threadList)
     {
@@ -123,18 +211,36 @@ void ThreadGetList(THREADLIST* List)
         if(threadHandle == hActiveThread)
             List->CurrentThread = index;
 
-        memcpy(&List->list[index].BasicInfo, &itr.second, sizeof(THREADINFO));
+        auto cached = threadDetailCacheValid ? threadDetailCache.find(itr.first) : threadDetailCache.end();
+        if(cached != threadDetailCache.end())
+            memcpy(&List->list[index], &cached->second, sizeof(THREADALLINFO));
+        else
+            missing.push_back(index);
 
-        List->list[index].ThreadCip = GetContextDataEx(threadHandle, UE_CIP);
-        List->list[index].SuspendCount = ThreadGetSuspendCount(threadHandle);
-        List->list[index].Priority = ThreadGetPriority(threadHandle);
-        List->list[index].LastError = ThreadGetLastErrorTEB(itr.second.ThreadLocalBase);
-        GetThreadTimes(threadHandle, &List->list[index].CreationTime, &threadExitTime, &List->list[index].KernelTime, &List->list[index].UserTime);
-        List->list[index].Cycles = ThreadQueryCycleTime(threadHandle);
+        // The identity data is always refreshed from the live list
+        memcpy(&List->list[index].BasicInfo, &itr.second, sizeof(THREADINFO));
         index++;
     }
 
-    // Get the wait reason for every thread in the list
+    // Resolve the missing details in parallel; each one takes several
+    // syscalls but none of them touch the thread list itself
+    if(missing.size() > 1)
+    {
+        concurrency::parallel_for(size_t(0), missing.size(), [List, &missing](size_t i)
+        {
+            ThreadFillDetail(List->list[missing[i]]);
+        });
+    }
+    else if(!missing.empty())
+        ThreadFillDetail(List->list[missing[0]]);
+
+    // Cache the resolved details until the next invalidation
+    for(int missingIndex : missing)
+        threadDetailCache[List->list[missingIndex].BasicInfo.ThreadId] = List->list[missingIndex];
+    threadDetailCacheValid = true;
+
+    // Get the wait reason for every thread in the list. This is refreshed
+    // periodically by ThreadUpdateWaitReasons, so it bypasses the cache
     for(int i = 0; i < List->count; i++)
     {
         auto found = threadWaitReasons.find(List->list[i].BasicInfo.ThreadId);
@@ -321,8 +427,32 @@ DWORD ThreadGetId(HANDLE Thread)
     return _GetThreadId ? _GetThreadId(Thread) : 0;
 }
 
+// Freeze/thaw the whole target with a single syscall. NtSuspendProcess bumps
+// the suspend count of every thread, so the semantics match the per-thread
+// loops below while avoiding hundreds of SuspendThread round trips.
+static bool ThreadSuspendProcess()
+{
+    if(!fdProcessInfo || !fdProcessInfo->hProcess)
+        return false;
+    return NT_SUCCESS(NtSuspendProcess(fdProcessInfo->hProcess));
+}
+
+static bool ThreadResumeProcess()
+{
+    if(!fdProcessInfo || !fdProcessInfo->hProcess)
+        return false;
+    return NT_SUCCESS(NtResumeProcess(fdProcessInfo->hProcess));
+}
+
 int ThreadSuspendAll()
 {
+    // Kernel fast path first
+    if(ThreadSuspendProcess())
+    {
+        ThreadDetailsInvalidate();
+        return ThreadGetCount();
+    }
+
     // SuspendThread does not modify any internal variables
     SHARED_ACQUIRE(LockThreads);
 
@@ -335,11 +465,19 @@ int ThreadSuspendAll()
             dprintf(QT_TRANSLATE_NOOP("DBG", "Failed to suspend thread 0x%X...\n"), entry.second.ThreadId);
     }
 
+    ThreadDetailsInvalidate();
     return count;
 }
 
 int ThreadResumeAll()
 {
+    // Kernel fast path first
+    if(ThreadResumeProcess())
+    {
+        ThreadDetailsInvalidate();
+        return ThreadGetCount();
+    }
+
     // ResumeThread does not modify any internal variables
     SHARED_ACQUIRE(LockThreads);
 
@@ -350,9 +488,17 @@ int ThreadResumeAll()
             count++;
     }
 
+    ThreadDetailsInvalidate();
     return count;
 }
 
+void ThreadRunWithWorldStopped(const std::function<void()> & Action)
+{
+    ThreadSuspendAll();
+    Action();
+    ThreadResumeAll();
+}
+
 ULONG_PTR ThreadGetLocalBase(DWORD ThreadId)
 {
     SHARED_ACQUIRE(LockThreads);
@@ -377,6 +523,20 @@ ULONG64 ThreadQueryCycleTime(HANDLE hThread)
     return CycleTime;
 }
 
+int ThreadGetCycleHistory(DWORD ThreadId, ULONG64* Deltas, int MaxCount)
+{
+    SHARED_ACQUIRE(LockThreads);
+    auto found = threadCycleHistory.find(ThreadId);
+    if(found == threadCycleHistory.end())
+        return 0;
+    const auto & history = found->second;
+    int count = history.count < MaxCount ? history.count : MaxCount;
+    // Copy oldest to newest
+    for(int i = 0; i < count; i++)
+        Deltas[i] = history.deltas[(history.head - count + i + ThreadCycleHistoryDepth) % ThreadCycleHistoryDepth];
+    return count;
+}
+
 void ThreadUpdateWaitReasons()
 {
     ULONG size;
@@ -3,6 +3,7 @@
 
 #include "_global.h"
 #include "ntdll/ntdll.h"
+#include <functional>
 
 void ThreadCreate(CREATE_THREAD_DEBUG_INFO* CreateThread);
 void ThreadExit(DWORD ThreadId);
@@ -10,6 +11,7 @@ void ThreadClear();
 int ThreadGetCount();
 void ThreadGetList(THREADLIST* list);
 void ThreadGetList(std::vector<THREADINFO> & list);
+void ThreadDetailsInvalidate();
 bool ThreadGetInfo(DWORD ThreadId, THREADINFO & info);
 bool ThreadIsValid(DWORD ThreadId);
 bool ThreadSetName(DWORD ThreadId, const char* name);
@@ -27,8 +29,10 @@ HANDLE ThreadGetHandle(DWORD ThreadId);
 DWORD ThreadGetId(HANDLE Thread);
 int ThreadSuspendAll();
 int ThreadResumeAll();
+void ThreadRunWithWorldStopped(const std::function<void()> & Action);
 ULONG_PTR ThreadGetLocalBase(DWORD ThreadId);
 ULONG64 ThreadQueryCycleTime(HANDLE hThread);
+int ThreadGetCycleHistory(DWORD ThreadId, ULONG64* Deltas, int MaxCount);
 void ThreadUpdateWaitReasons();
 
 #endif // _THREAD_H
\ No newline at end of file
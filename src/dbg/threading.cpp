@@ -1,4 +1,5 @@
 #include <ntstatus.h>
+#include <functional>
 #include "threading.h"
 
 static HANDLE waitArray[WAITID_LAST];
@@ -60,6 +61,68 @@ SectionLockerGlobal::SRWLOCKFUNCTION SectionLockerGlobal::m_AcquireSRWLockShared
 SectionLockerGlobal::SRWLOCKFUNCTION SectionLockerGlobal::m_AcquireSRWLockExclusive;
 SectionLockerGlobal::SRWLOCKFUNCTION SectionLockerGlobal::m_ReleaseSRWLockShared;
 SectionLockerGlobal::SRWLOCKFUNCTION SectionLockerGlobal::m_ReleaseSRWLockExclusive;
+SectionLockerGlobal::SRWLOCKTRYFUNCTION SectionLockerGlobal::m_TryAcquireSRWLockShared;
+SectionLockerGlobal::SRWLOCKTRYFUNCTION SectionLockerGlobal::m_TryAcquireSRWLockExclusive;
+std::atomic<bool> SectionLockerGlobal::m_TelemetryEnabled(false);
+SectionLockerGlobal::telemetry_info SectionLockerGlobal::m_telemetry[SectionLock::LockLast];
+unsigned long long SectionLockerGlobal::m_qpcFrequency = 1;
+
+// Keep in sync with the SectionLock enumeration in threading.h!
+static const char* lockNames[] =
+{
+    "LockMemoryPages",
+    "LockVariables",
+    "LockModules",
+    "LockComments",
+    "LockLabels",
+    "LockBookmarks",
+    "LockFunctions",
+    "LockLoops",
+    "LockBreakpoints",
+    "LockPatches",
+    "LockThreads",
+    "LockSym",
+    "LockCmdLine",
+    "LockDatabase",
+    "LockPluginList",
+    "LockPluginCallbackList",
+    "LockPluginCommandList",
+    "LockPluginMenuList",
+    "LockPluginExprfunctionList",
+    "LockPluginFormatfunctionList",
+    "LockSehCache",
+    "LockMnemonicHelp",
+    "LockTraceRecord",
+    "LockCrossReferences",
+    "LockDebugStartStop",
+    "LockArguments",
+    "LockEncodeMaps",
+    "LockCallstackCache",
+    "LockRunToUserCode",
+    "LockWatch",
+    "LockExpressionFunctions",
+    "LockHistory",
+    "LockSymbolCache",
+    "LockLineCache",
+    "LockTypeManager",
+    "LockModuleHashes",
+    "LockFormatFunctions",
+    "LockDllBreakpoints",
+    "LockMemoryReadCache",
+    "LockPluginRegdumpCache",
+    "LockExpressionFunctionsCache",
+    "LockNameResolutionCache",
+    "LockAssembleCache",
+    "LockFunctionTableCache",
+    "LockDbJournal",
+    "LockAnalysisDirty",
+    "LockWorkingSetCache",
+    "LockStringPool",
+    "LockPatchJournal",
+    "LockCommandList",
+};
+
+static_assert(_countof(lockNames) == SectionLock::LockLast, "lockNames is out of sync with the SectionLock enumeration");
 
 void SectionLockerGlobal::Initialize()
 {
@@ -71,6 +134,8 @@ void SectionLockerGlobal::Initialize()
     // Attempt to read the SRWLock API
     HMODULE hKernel32 = GetModuleHandleW(L"kernel32.dll");
     m_InitializeSRWLock = (SRWLOCKFUNCTION)GetProcAddress(hKernel32, "InitializeSRWLock");
+    m_TryAcquireSRWLockShared = (SRWLOCKTRYFUNCTION)GetProcAddress(hKernel32, "TryAcquireSRWLockShared"); //Win7+, only needed for telemetry
+    m_TryAcquireSRWLockExclusive = (SRWLOCKTRYFUNCTION)GetProcAddress(hKernel32, "TryAcquireSRWLockExclusive");
     m_AcquireSRWLockShared = (SRWLOCKFUNCTION)GetProcAddress(hKernel32, "AcquireSRWLockShared");
     m_AcquireSRWLockExclusive = (SRWLOCKFUNCTION)GetProcAddress(hKernel32, "AcquireSRWLockExclusive");
     m_ReleaseSRWLockShared = (SRWLOCKFUNCTION)GetProcAddress(hKernel32, "ReleaseSRWLockShared");
@@ -99,6 +164,10 @@ void SectionLockerGlobal::Initialize()
             InitializeCriticalSection(&m_crLocks[i]);
     }
 
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    m_qpcFrequency = frequency.QuadPart ? (unsigned long long)frequency.QuadPart : 1;
+
     m_Initialized = true;
 }
 
@@ -135,3 +204,143 @@ void SectionLockerGlobal::Deinitialize()
 
     m_Initialized = false;
 }
+
+void SectionLockerGlobal::SetTelemetryEnabled(bool enabled)
+{
+    m_TelemetryEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool SectionLockerGlobal::TelemetryEnabled()
+{
+    return m_TelemetryEnabled.load(std::memory_order_relaxed);
+}
+
+void SectionLockerGlobal::TelemetrySnapshot(LOCKTELEMETRY* telemetry)
+{
+    auto ticksToMicroseconds = [](unsigned long long ticks)
+    {
+        return ticks * 1000000ull / m_qpcFrequency;
+    };
+    for(int i = 0; i < SectionLock::LockLast; i++)
+    {
+        const auto & info = m_telemetry[i];
+        telemetry[i].acquisitions = info.acquisitions.load(std::memory_order_relaxed);
+        telemetry[i].contentions = info.contentions.load(std::memory_order_relaxed);
+        telemetry[i].waitTime = ticksToMicroseconds(info.waitTicks.load(std::memory_order_relaxed));
+        telemetry[i].maxWaitTime = ticksToMicroseconds(info.maxWaitTicks.load(std::memory_order_relaxed));
+        for(int bucket = 0; bucket < _countof(telemetry[i].waitHistogram); bucket++)
+            telemetry[i].waitHistogram[bucket] = info.waitHistogram[bucket].load(std::memory_order_relaxed);
+        telemetry[i].owner = m_owner[i].thread;
+    }
+}
+
+void SectionLockerGlobal::TelemetryReset()
+{
+    for(int i = 0; i < SectionLock::LockLast; i++)
+    {
+        auto & info = m_telemetry[i];
+        info.acquisitions.store(0, std::memory_order_relaxed);
+        info.contentions.store(0, std::memory_order_relaxed);
+        info.waitTicks.store(0, std::memory_order_relaxed);
+        info.maxWaitTicks.store(0, std::memory_order_relaxed);
+        for(int bucket = 0; bucket < _countof(info.waitHistogram); bucket++)
+            info.waitHistogram[bucket].store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* SectionLockerGlobal::LockName(SectionLock LockIndex)
+{
+    return LockIndex >= 0 && LockIndex < SectionLock::LockLast ? lockNames[LockIndex] : "<invalid>";
+}
+
+void SectionLockerGlobal::RecordWait(SectionLock LockIndex, unsigned long long waitTicks)
+{
+    auto & info = m_telemetry[LockIndex];
+    info.contentions.fetch_add(1, std::memory_order_relaxed);
+    info.waitTicks.fetch_add(waitTicks, std::memory_order_relaxed);
+    auto previousMax = info.maxWaitTicks.load(std::memory_order_relaxed);
+    while(waitTicks > previousMax && !info.maxWaitTicks.compare_exchange_weak(previousMax, waitTicks, std::memory_order_relaxed))
+    {
+    }
+    auto microseconds = waitTicks * 1000000ull / m_qpcFrequency;
+    int bucket;
+    if(microseconds < 1)
+        bucket = 0;
+    else if(microseconds < 10)
+        bucket = 1;
+    else if(microseconds < 100)
+        bucket = 2;
+    else if(microseconds < 1000)
+        bucket = 3;
+    else if(microseconds < 10000)
+        bucket = 4;
+    else
+        bucket = 5;
+    info.waitHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void SectionLockerGlobal::TrackedAcquireLock(SectionLock LockIndex, bool Shared)
+{
+    // Mirrors the untracked AcquireLock fast path, with the actual lock waits
+    // timed. The recursion cases never touch the lock and are not counted.
+    auto & info = m_telemetry[LockIndex];
+    auto timedAcquire = [LockIndex](const std::function<void()> & acquire)
+    {
+        LARGE_INTEGER start;
+        LARGE_INTEGER end;
+        QueryPerformanceCounter(&start);
+        acquire();
+        QueryPerformanceCounter(&end);
+        RecordWait(LockIndex, (unsigned long long)(end.QuadPart - start.QuadPart));
+    };
+
+    if(m_SRWLocks)
+    {
+        if(Shared)
+        {
+            if(m_owner[LockIndex].thread == GetCurrentThreadId())
+                return;
+
+            info.acquisitions.fetch_add(1, std::memory_order_relaxed);
+            if(m_TryAcquireSRWLockShared && m_TryAcquireSRWLockShared(&m_srwLocks[LockIndex]))
+                return; //uncontended
+            timedAcquire([LockIndex]()
+            {
+                m_AcquireSRWLockShared(&m_srwLocks[LockIndex]);
+            });
+            return;
+        }
+
+        if(m_owner[LockIndex].thread == GetCurrentThreadId())
+        {
+            assert(m_owner[LockIndex].count > 0);
+            m_owner[LockIndex].count++;
+            return;
+        }
+
+        info.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if(!(m_TryAcquireSRWLockExclusive && m_TryAcquireSRWLockExclusive(&m_srwLocks[LockIndex])))
+        {
+            timedAcquire([LockIndex]()
+            {
+                m_AcquireSRWLockExclusive(&m_srwLocks[LockIndex]);
+            });
+        }
+
+        assert(m_owner[LockIndex].thread == 0);
+        assert(m_owner[LockIndex].count == 0);
+        m_owner[LockIndex].thread = GetCurrentThreadId();
+        m_owner[LockIndex].count = 1;
+    }
+    else
+    {
+        info.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        if(!TryEnterCriticalSection(&m_crLocks[LockIndex]))
+        {
+            timedAcquire([LockIndex]()
+            {
+                EnterCriticalSection(&m_crLocks[LockIndex]);
+            });
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #define _THREADING_H
 
 #include "_global.h"
+#include <atomic>
 
 enum WAIT_ID
 {
@@ -33,6 +34,7 @@ void waitdeinitialize();
 #define SHARED_REACQUIRE()          __SThreadLock.Lock()
 #define SHARED_RELEASE()            __SThreadLock.Unlock()
 
+// Update lockNames in threading.cpp when changing this enumeration!
 enum SectionLock
 {
     LockMemoryPages,
@@ -73,11 +75,34 @@ enum SectionLock
     LockModuleHashes,
     LockFormatFunctions,
     LockDllBreakpoints,
+    LockMemoryReadCache,
+    LockPluginRegdumpCache,
+    LockExpressionFunctionsCache,
+    LockNameResolutionCache,
+    LockAssembleCache,
+    LockFunctionTableCache,
+    LockDbJournal,
+    LockAnalysisDirty,
+    LockWorkingSetCache,
+    LockStringPool,
+    LockPatchJournal,
+    LockCommandList,
 
     // Number of elements in this enumeration. Must always be the last index.
     LockLast
 };
 
+// Per-lock contention statistics snapshot, wait times in microseconds
+struct LOCKTELEMETRY
+{
+    unsigned long long acquisitions; // acquisitions counted while telemetry was enabled
+    unsigned long long contentions; // acquisitions that had to wait for another thread
+    unsigned long long waitTime; // total time spent waiting
+    unsigned long long maxWaitTime; // longest single wait
+    unsigned long long waitHistogram[6]; // waits <1us, <10us, <100us, <1ms, <10ms, >=10ms
+    DWORD owner; // thread currently holding the lock exclusively (0 if none)
+};
+
 class SectionLockerGlobal
 {
     template<SectionLock LockIndex, bool Shared>
@@ -87,9 +112,24 @@ public:
     static void Initialize();
     static void Deinitialize();
 
+    // Lock telemetry: compiled in, but the counting code is only reached when
+    // enabled at runtime so the common acquisition path stays a single
+    // relaxed atomic load
+    static void SetTelemetryEnabled(bool enabled);
+    static bool TelemetryEnabled();
+    static void TelemetrySnapshot(LOCKTELEMETRY* telemetry); //LockLast entries
+    static void TelemetryReset();
+    static const char* LockName(SectionLock LockIndex);
+
 private:
     static inline void AcquireLock(SectionLock LockIndex, bool Shared)
     {
+        if(m_TelemetryEnabled.load(std::memory_order_relaxed))
+        {
+            TrackedAcquireLock(LockIndex, Shared);
+            return;
+        }
+
         if(m_SRWLocks)
         {
             if(Shared)
@@ -145,12 +185,28 @@ private:
             LeaveCriticalSection(&m_crLocks[LockIndex]);
     }
 
+    // Counted acquisition, only reached when telemetry is enabled
+    static void TrackedAcquireLock(SectionLock LockIndex, bool Shared);
+    static void RecordWait(SectionLock LockIndex, unsigned long long waitTicks);
+
     typedef void (WINAPI* SRWLOCKFUNCTION)(PSRWLOCK SWRLock);
+    typedef BOOLEAN(WINAPI* SRWLOCKTRYFUNCTION)(PSRWLOCK SWRLock);
 
     static bool m_Initialized;
     static bool m_SRWLocks;
     struct owner_info { DWORD thread; size_t count; };
     static owner_info m_owner[SectionLock::LockLast];
+    struct telemetry_info
+    {
+        std::atomic<unsigned long long> acquisitions;
+        std::atomic<unsigned long long> contentions;
+        std::atomic<unsigned long long> waitTicks;
+        std::atomic<unsigned long long> maxWaitTicks;
+        std::atomic<unsigned long long> waitHistogram[6];
+    };
+    static std::atomic<bool> m_TelemetryEnabled;
+    static telemetry_info m_telemetry[SectionLock::LockLast];
+    static unsigned long long m_qpcFrequency;
     static SRWLOCK m_srwLocks[SectionLock::LockLast];
     static CRITICAL_SECTION m_crLocks[SectionLock::LockLast];
     static SRWLOCKFUNCTION m_InitializeSRWLock;
@@ -158,6 +214,8 @@ private:
     static SRWLOCKFUNCTION m_AcquireSRWLockExclusive;
     static SRWLOCKFUNCTION m_ReleaseSRWLockShared;
     static SRWLOCKFUNCTION m_ReleaseSRWLockExclusive;
+    static SRWLOCKTRYFUNCTION m_TryAcquireSRWLockShared;
+    static SRWLOCKTRYFUNCTION m_TryAcquireSRWLockExclusive;
 };
 
 template<SectionLock LockIndex, bool Shared>
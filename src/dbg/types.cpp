@@ -2,6 +2,9 @@
 #include "stringutils.h"
 #include "threading.h"
 #include "filehelper.h"
+#include "filemap.h"
+#include "murmurhash.h"
+#include "debugger.h"
 #include "console.h"
 #include "jansson/jansson_x64dbg.h"
 #include <algorithm>
@@ -657,36 +660,312 @@ void LoadModel(const std::string & owner, Model & model)
     }
 }
 
+static bool ParseTypesJson(const std::string & json, Model & model)
+{
+    auto root = json_loads(json.c_str(), 0, 0);
+    if(!root)
+        return false;
+    loadTypes(json_object_get(root, "types"), model.types);
+    loadTypes(json_object_get(root, ArchValue("types32", "types64")), model.types);
+    loadStructUnions(json_object_get(root, "structs"), false, model.structUnions);
+    loadStructUnions(json_object_get(root, ArchValue("structs32", "structs64")), false, model.structUnions);
+    loadStructUnions(json_object_get(root, "unions"), true, model.structUnions);
+    loadStructUnions(json_object_get(root, ArchValue("unions32", "unions64")), true, model.structUnions);
+    loadFunctions(json_object_get(root, "functions"), model.functions);
+    loadFunctions(json_object_get(root, ArchValue("functions32", "functions64")), model.functions);
+    json_decref(root);
+    return true;
+}
+
 bool LoadTypesJson(const std::string & json, const std::string & owner)
 {
+    Model model;
+    if(!ParseTypesJson(json, model))
+        return false;
     EXCLUSIVE_ACQUIRE(LockTypeManager);
-    auto root = json_loads(json.c_str(), 0, 0);
-    if(root)
-    {
-        Model model;
-        loadTypes(json_object_get(root, "types"), model.types);
-        loadTypes(json_object_get(root, ArchValue("types32", "types64")), model.types);
-        loadStructUnions(json_object_get(root, "structs"), false, model.structUnions);
-        loadStructUnions(json_object_get(root, ArchValue("structs32", "structs64")), false, model.structUnions);
-        loadStructUnions(json_object_get(root, "unions"), true, model.structUnions);
-        loadStructUnions(json_object_get(root, ArchValue("unions32", "unions64")), true, model.structUnions);
-        loadFunctions(json_object_get(root, "functions"), model.functions);
-        loadFunctions(json_object_get(root, ArchValue("functions32", "functions64")), model.functions);
+    LoadModel(owner, model);
+    return true;
+}
 
-        LoadModel(owner, model);
+// Compiled type archive: the parsed model of a types file is serialized into
+// a sidecar blob under the db directory so later sessions can skip the JSON
+// parse and load the resolved model straight from a file mapping. The archive
+// is keyed by the source file size and timestamp and recompiled when stale.
+#pragma pack(push, 1)
+struct TypeDbHeader
+{
+    char magic[4]; // TPA1
+    unsigned int version;
+    unsigned long long sourceSize; // types file size when compiled
+    unsigned long long sourceWriteTime; // types file FILETIME when compiled
+    unsigned int typeCount;
+    unsigned int structCount;
+    unsigned int functionCount;
+    unsigned int poolSize; // interned string pool at the end of the file
+};
 
-        // Free root
-        json_decref(root);
-    }
-    else
+struct TypeDbString
+{
+    unsigned int offset; // string pool offset
+    unsigned int length;
+};
+#pragma pack(pop)
+
+static const char typeDbMagic[4] = { 'T', 'P', 'A', '1' };
+static const unsigned int TypeDbVersion = 1;
+
+static unsigned int typeDbHash(const String & str)
+{
+    // 32 bits regardless of architecture, the same as the other sidecar caches
+    unsigned int hash;
+    MurmurHash3_x86_32(str.c_str(), int(str.length()), 0x1337, &hash);
+    return hash;
+}
+
+static WString typeDbArchivePath(const std::string & sourcePath, bool createDirectory)
+{
+    auto dir = StringUtils::sprintf("%s\\db", szProgramDir);
+    if(createDirectory)
+        CreateDirectoryW(StringUtils::Utf8ToUtf16(dir).c_str(), nullptr);
+    // Keyed on the lowercased source path; x32 and x64 parse different
+    // sections of the same file so each architecture gets its own archive
+    return StringUtils::Utf8ToUtf16(StringUtils::sprintf("%s\\types.%08X.%s.cache", dir.c_str(), typeDbHash(StringUtils::ToLower(sourcePath)), ArchValue("x32", "x64")));
+}
+
+static bool typeDbSourceInfo(const std::string & sourcePath, unsigned long long & size, unsigned long long & lastWriteTime)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attrib;
+    if(!GetFileAttributesExW(StringUtils::Utf8ToUtf16(sourcePath).c_str(), GetFileExInfoStandard, &attrib))
         return false;
+    size = (unsigned long long)attrib.nFileSizeHigh << 32 | attrib.nFileSizeLow;
+    lastWriteTime = (unsigned long long)attrib.ftLastWriteTime.dwHighDateTime << 32 | attrib.ftLastWriteTime.dwLowDateTime;
     return true;
 }
 
+struct TypeDbBuilder
+{
+    String records;
+    String pool;
+
+    TypeDbString Intern(const std::string & str)
+    {
+        auto found = interned.find(str);
+        if(found != interned.end())
+            return found->second;
+        TypeDbString result;
+        result.offset = (unsigned int)pool.size();
+        result.length = (unsigned int)str.length();
+        pool.append(str);
+        interned.emplace(str, result);
+        return result;
+    }
+
+    void Write(const void* data, size_t size)
+    {
+        records.append((const char*)data, size);
+    }
+
+    void WriteString(const std::string & str)
+    {
+        auto interned_ = Intern(str);
+        Write(&interned_, sizeof(interned_));
+    }
+
+    void WriteMember(const Member & member)
+    {
+        WriteString(member.type);
+        WriteString(member.name);
+        Write(&member.arrsize, sizeof(member.arrsize));
+        Write(&member.offset, sizeof(member.offset));
+    }
+
+private:
+    std::unordered_map<std::string, TypeDbString> interned;
+};
+
+static void typeDbCompileArchive(const std::string & sourcePath, const Model & model)
+{
+    unsigned long long sourceSize, sourceWriteTime;
+    if(!typeDbSourceInfo(sourcePath, sourceSize, sourceWriteTime))
+        return;
+
+    TypeDbBuilder builder;
+    for(const auto & type : model.types)
+    {
+        builder.WriteString(type.type);
+        builder.WriteString(type.name);
+    }
+    for(const auto & su : model.structUnions)
+    {
+        builder.WriteString(su.name);
+        unsigned char isunion = su.isunion ? 1 : 0;
+        builder.Write(&isunion, sizeof(isunion));
+        auto memberCount = (unsigned int)su.members.size();
+        builder.Write(&memberCount, sizeof(memberCount));
+        for(const auto & member : su.members)
+            builder.WriteMember(member);
+    }
+    for(const auto & function : model.functions)
+    {
+        builder.WriteString(function.name);
+        builder.WriteString(function.rettype);
+        unsigned char callconv = (unsigned char)function.callconv;
+        unsigned char noreturn = function.noreturn ? 1 : 0;
+        builder.Write(&callconv, sizeof(callconv));
+        builder.Write(&noreturn, sizeof(noreturn));
+        auto argCount = (unsigned int)function.args.size();
+        builder.Write(&argCount, sizeof(argCount));
+        for(const auto & arg : function.args)
+            builder.WriteMember(arg);
+    }
+
+    TypeDbHeader header;
+    memcpy(header.magic, typeDbMagic, sizeof(header.magic));
+    header.version = TypeDbVersion;
+    header.sourceSize = sourceSize;
+    header.sourceWriteTime = sourceWriteTime;
+    header.typeCount = (unsigned int)model.types.size();
+    header.structCount = (unsigned int)model.structUnions.size();
+    header.functionCount = (unsigned int)model.functions.size();
+    header.poolSize = (unsigned int)builder.pool.size();
+
+    auto archivePath = typeDbArchivePath(sourcePath, true);
+    auto hFile = CreateFileW(archivePath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, 0, nullptr);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return;
+    bool success;
+    {
+        BufferedWriter writer(hFile);
+        success = writer.Write(&header, sizeof(header)) &&
+                  writer.Write(builder.records.data(), builder.records.size()) &&
+                  writer.Write(builder.pool.data(), builder.pool.size());
+    }
+    if(!success)
+        DeleteFileW(archivePath.c_str());
+}
+
+static bool typeDbLoadArchive(const std::string & sourcePath, Model & model)
+{
+    unsigned long long sourceSize, sourceWriteTime;
+    if(!typeDbSourceInfo(sourcePath, sourceSize, sourceWriteTime))
+        return false;
+
+    FileMap<char> map;
+    if(!map.Map(typeDbArchivePath(sourcePath, false).c_str()))
+        return false;
+    auto data = map.Data();
+    auto size = (size_t)map.Size();
+    if(size < sizeof(TypeDbHeader))
+        return false;
+    auto header = (const TypeDbHeader*)data;
+    if(memcmp(header->magic, typeDbMagic, sizeof(typeDbMagic)) != 0 || header->version != TypeDbVersion)
+        return false;
+    if(header->sourceSize != sourceSize || header->sourceWriteTime != sourceWriteTime) //types file changed, recompile
+        return false;
+    if((size_t)header->poolSize > size - sizeof(TypeDbHeader))
+        return false;
+
+    auto pool = data + size - header->poolSize;
+    auto cursor = sizeof(TypeDbHeader);
+    auto recordsEnd = size - header->poolSize;
+    auto read = [&](void* out, size_t count)
+    {
+        if(cursor + count > recordsEnd)
+            return false;
+        memcpy(out, data + cursor, count);
+        cursor += count;
+        return true;
+    };
+    auto readString = [&](std::string & out)
+    {
+        TypeDbString str;
+        if(!read(&str, sizeof(str)))
+            return false;
+        if((unsigned long long)str.offset + str.length > header->poolSize)
+            return false;
+        out.assign(pool + str.offset, str.length);
+        return true;
+    };
+    auto readMember = [&](Member & member)
+    {
+        return readString(member.type) &&
+               readString(member.name) &&
+               read(&member.arrsize, sizeof(member.arrsize)) &&
+               read(&member.offset, sizeof(member.offset));
+    };
+
+    model.types.reserve(header->typeCount);
+    for(unsigned int i = 0; i < header->typeCount; i++)
+    {
+        Member type;
+        if(!readString(type.type) || !readString(type.name))
+            return false;
+        model.types.push_back(std::move(type));
+    }
+    model.structUnions.reserve(header->structCount);
+    for(unsigned int i = 0; i < header->structCount; i++)
+    {
+        StructUnion su;
+        unsigned char isunion = 0;
+        unsigned int memberCount = 0;
+        if(!readString(su.name) || !read(&isunion, sizeof(isunion)) || !read(&memberCount, sizeof(memberCount)))
+            return false;
+        su.isunion = isunion != 0;
+        for(unsigned int j = 0; j < memberCount; j++)
+        {
+            Member member;
+            if(!readMember(member))
+                return false;
+            su.members.push_back(std::move(member));
+        }
+        model.structUnions.push_back(std::move(su));
+    }
+    model.functions.reserve(header->functionCount);
+    for(unsigned int i = 0; i < header->functionCount; i++)
+    {
+        Function function;
+        unsigned char callconv = 0, noreturn = 0;
+        unsigned int argCount = 0;
+        if(!readString(function.name) || !readString(function.rettype) ||
+                !read(&callconv, sizeof(callconv)) || !read(&noreturn, sizeof(noreturn)) || !read(&argCount, sizeof(argCount)))
+            return false;
+        function.callconv = (CallingConvention)callconv;
+        function.noreturn = noreturn != 0;
+        for(unsigned int j = 0; j < argCount; j++)
+        {
+            Member arg;
+            if(!readMember(arg))
+                return false;
+            function.args.push_back(std::move(arg));
+        }
+        model.functions.push_back(std::move(function));
+    }
+
+    // The whole record stream has to be consumed, otherwise the counts lied
+    return cursor == recordsEnd;
+}
+
 bool LoadTypesFile(const std::string & path, const std::string & owner)
 {
+    // Serve the compiled archive when it is still current, skipping the JSON
+    // parse entirely
+    Model model;
+    if(typeDbLoadArchive(path, model))
+    {
+        EXCLUSIVE_ACQUIRE(LockTypeManager);
+        LoadModel(owner, model);
+        return true;
+    }
+
+    model = Model();
     std::string json;
     if(!FileHelper::ReadAllText(path, json))
         return false;
-    return LoadTypesJson(json, owner);
+    if(!ParseTypesJson(json, model))
+        return false;
+    typeDbCompileArchive(path, model);
+
+    EXCLUSIVE_ACQUIRE(LockTypeManager);
+    LoadModel(owner, model);
+    return true;
 }
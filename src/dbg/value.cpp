@@ -18,9 +18,54 @@
 #include "TraceRecord.h"
 #include "plugin_loader.h"
 #include "exception.h"
+#include <atomic>
+#include <unordered_map>
 
 static bool dosignedcalc = false;
 
+// Positive API/label/symbol resolutions keyed by name. Breakpoint conditions
+// and watch expressions resolve the same few names on every evaluation and
+// SymAddrFromName can trigger full symbol walks, so hits skip the resolution
+// machinery entirely. The epoch is bumped whenever modules, labels or symbols
+// change; stale entries are simply ignored.
+struct NameCacheEntry
+{
+    duint epoch;
+    duint value;
+};
+static std::unordered_map<String, NameCacheEntry> nameCache;
+static std::atomic<duint> nameCacheEpoch;
+
+void valnamecacheclear()
+{
+    nameCacheEpoch++;
+}
+
+duint valnamecacheepoch()
+{
+    return nameCacheEpoch.load();
+}
+
+static bool namecacheget(const char* name, duint* value)
+{
+    auto epoch = nameCacheEpoch.load();
+    SHARED_ACQUIRE(LockNameResolutionCache);
+    auto found = nameCache.find(name);
+    if(found == nameCache.end() || found->second.epoch != epoch)
+        return false;
+    *value = found->second.value;
+    return true;
+}
+
+static void namecacheset(const char* name, duint value)
+{
+    auto epoch = nameCacheEpoch.load();
+    EXCLUSIVE_ACQUIRE(LockNameResolutionCache);
+    if(nameCache.size() > 4096) //bound stale entries from previous epochs
+        nameCache.clear();
+    nameCache[name] = NameCacheEntry { epoch, value };
+}
+
 /**
 \brief Returns whether we do signed or unsigned calculations.
 \return true if we do signed calculations, false for unsigned calculationss.
@@ -1694,6 +1739,25 @@ static bool isdigitduint(char digit)
 #endif //_WIN64
 }
 
+/**
+\brief Classify what a plain (non-memory) expression token depends on. Used by the watch view to decide when an expression has to be re-evaluated.
+\param string The token to classify.
+\return dep_register for registers and flags, dep_constant for numeric literals and named constants, dep_other for everything resolved at evaluation time (variables, labels, symbols, plugin values).
+*/
+VALTOKENDEP valtokendep(const char* string)
+{
+    if(isregister(string))
+        return dep_register;
+    if(*string == '_' && isflag(string + 1))
+        return dep_register;
+    if(isdecnumber(string) || ishexnumber(string))
+        return dep_constant;
+    duint value;
+    if(ConstantFromName(string, value))
+        return dep_constant;
+    return dep_other;
+}
+
 /**
 \brief Gets a value from a string. This function can parse expressions, memory locations, registers, flags, API names, labels, symbols and variables.
 \param string The string to parse.
@@ -1944,12 +2008,24 @@ bool valfromstring_noexpr(const char* string, duint* value, bool silent, bool ba
     if(baseonly)
         return false;
 
+    if(namecacheget(string, value)) //cached resolution from a previous evaluation
+        return true;
+
     if(valapifromstring(string, value, value_size, true, silent, hexonly)) //then come APIs
+    {
+        namecacheset(string, *value);
         return true;
+    }
     else if(LabelFromString(string, value)) //then come labels
+    {
+        namecacheset(string, *value);
         return true;
+    }
     else if(SymAddrFromName(string, value)) //then come symbols
+    {
+        namecacheset(string, *value);
         return true;
+    }
     else if(strstr(string, "sub_") == string) //then come sub_ functions
     {
 #ifdef _WIN64
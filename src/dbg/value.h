@@ -3,6 +3,14 @@
 
 #include "_global.h"
 
+//enums
+enum VALTOKENDEP //expression token dependency classes, used for watch dirty tracking
+{
+    dep_constant, //numeric literals and named constants
+    dep_register, //CPU context (register or flag)
+    dep_other //variables, labels, symbols, plugin values
+};
+
 //functions
 bool valuesignedcalc();
 void valuesetsignedcalc(bool a);
@@ -11,6 +19,8 @@ bool valapifromstring(const char* name, duint* value, int* value_size, bool prin
 bool convertNumber(const char* str, duint & result, int radix);
 bool convertLongLongNumber(const char* str, unsigned long long & result, int radix);
 bool valfromstring_noexpr(const char* string, duint* value, bool silent = true, bool baseonly = false, int* value_size = nullptr, bool* isvar = nullptr, bool* hexonly = nullptr);
+void valnamecacheclear(); //call when modules, labels or symbols change
+duint valnamecacheepoch();
 bool valfromstring(const char* string, duint* value, bool silent = true, bool baseonly = false, int* value_size = nullptr, bool* isvar = nullptr, bool* hexonly = nullptr, bool allowassign = false);
 bool valflagfromstring(duint eflags, const char* string);
 bool valtostring(const char* string, duint value, bool silent);
@@ -23,6 +33,7 @@ unsigned short valx87controlwordfieldfromstring(duint controlword, const char* s
 duint valfileoffsettova(const char* modname, duint offset);
 duint valvatofileoffset(duint va);
 bool setregister(const char* string, duint value);
+VALTOKENDEP valtokendep(const char* string);
 bool setflag(const char* string, bool set);
 duint getregister(int* size, const char* string);
 
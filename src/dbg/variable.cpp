@@ -7,12 +7,52 @@
 #include "variable.h"
 #include "threading.h"
 #include <map>
+#include <unordered_map>
 
 /**
 \brief The container that stores all variables.
 */
 std::map<String, VAR, CaseInsensitiveCompare> variables;
 
+// Case-folded index over the map nodes with aliases resolved at registration,
+// so the hot varget/varset paths are a single O(1) probe instead of an
+// O(log n) case-insensitive walk plus an alias recursion. std::map nodes are
+// stable, so the interned pointers stay valid until the variable is deleted.
+struct CaseInsensitiveHash
+{
+    size_t operator()(const String & str) const
+    {
+        size_t hash = 2166136261u; //FNV-1a
+        for(auto ch : str)
+            hash = (hash ^ (size_t)tolower((unsigned char)ch)) * 16777619u;
+        return hash;
+    }
+};
+
+struct CaseInsensitiveEqual
+{
+    bool operator()(const String & str1, const String & str2) const
+    {
+        return _stricmp(str1.c_str(), str2.c_str()) == 0;
+    }
+};
+
+static std::unordered_map<String, VAR*, CaseInsensitiveHash, CaseInsensitiveEqual> variableIndex;
+
+/**
+\brief Finds the interned variable for a name, with aliases already resolved.
+The variable lock must be held.
+*/
+static VAR* varfind(const char* Name)
+{
+    String name_;
+    if(*Name != '$')
+        name_ = "$";
+    name_ += Name;
+    auto found = variableIndex.find(name_);
+    return found != variableIndex.end() ? found->second : nullptr;
+}
+
 /**
 \brief Sets a variable with a value.
 \param [in,out] Var The variable to set the value of. The previous value will be freed. Cannot be null.
@@ -39,19 +79,13 @@ bool varset(const char* Name, VAR_VALUE* Value, bool ReadOnly)
 {
     EXCLUSIVE_ACQUIRE(LockVariables);
 
-    String name_;
-    if(*Name != '$')
-        name_ = "$";
-    name_ += Name;
-    auto found = variables.find(name_);
-    if(found == variables.end()) //not found
+    auto var = varfind(Name);
+    if(!var) //not found
         return false;
-    if(found->second.alias.length())
-        return varset(found->second.alias.c_str(), Value, ReadOnly);
 
-    if(!ReadOnly && (found->second.type == VAR_READONLY || found->second.type == VAR_HIDDEN))
+    if(!ReadOnly && (var->type == VAR_READONLY || var->type == VAR_HIDDEN))
         return false;
-    varsetvalue(&found->second, Value);
+    varsetvalue(var, Value);
     return true;
 }
 
@@ -112,6 +146,7 @@ void varfree()
         varsetvalue(&itr.second, &emptyValue);
 
     // Now clear all vector elements
+    variableIndex.clear();
     variables.clear();
 }
 
@@ -131,6 +166,7 @@ bool varnew(const char* Name, duint Value, VAR_TYPE Type)
 
     std::vector<String> names = StringUtils::Split(Name, '\1');
     String firstName;
+    VAR* firstVar = nullptr;
     for(int i = 0; i < (int)names.size(); i++)
     {
         String name_;
@@ -156,7 +192,12 @@ bool varnew(const char* Name, duint Value, VAR_TYPE Type)
         var.value.size = sizeof(duint);
         var.value.type = VAR_UINT;
         var.value.u.value = Value;
-        variables.insert(std::make_pair(name_, var));
+        auto inserted = variables.insert(std::make_pair(name_, var)).first;
+        if(!i)
+            firstVar = &inserted->second;
+        // Aliases intern straight to their target, resolving them at
+        // registration instead of on every lookup
+        variableIndex[name_] = i ? firstVar : &inserted->second;
     }
     return true;
 }
@@ -173,27 +214,15 @@ bool varget(const char* Name, VAR_VALUE* Value, int* Size, VAR_TYPE* Type)
 {
     SHARED_ACQUIRE(LockVariables);
 
-    String name_;
-    if(*Name == '$')
-    {
-        name_ = Name;
-    }
-    else
-    {
-        name_ = "$";
-        name_ += Name;
-    }
-    auto found = variables.find(name_);
-    if(found == variables.end()) //not found
+    auto var = varfind(Name);
+    if(!var) //not found
         return false;
-    if(found->second.alias.length())
-        return varget(found->second.alias.c_str(), Value, Size, Type);
     if(Type)
-        *Type = found->second.type;
+        *Type = var->type;
     if(Size)
-        *Size = found->second.value.size;
+        *Size = var->value.size;
     if(Value)
-        *Value = found->second.value;
+        *Value = var->value;
     return true;
 }
 
@@ -304,29 +333,19 @@ bool vardel(const char* Name, bool DelSystem)
 {
     EXCLUSIVE_ACQUIRE(LockVariables);
 
-    String name_;
-    if(*Name != '$')
-        name_ = "$";
-    name_ += Name;
-    auto found = variables.find(name_);
-    if(found == variables.end()) //not found
+    auto var = varfind(Name); //aliases resolve to their target
+    if(!var) //not found
         return false;
-    if(found->second.alias.length())
-    {
-        // Release the lock (potential deadlock here)
-        EXCLUSIVE_RELEASE();
-
-        return vardel(found->second.alias.c_str(), DelSystem);
-    }
 
-    if(!DelSystem && found->second.type != VAR_USER)
+    if(!DelSystem && var->type != VAR_USER)
         return false;
-    found = variables.begin();
-    String NameString(Name);
+    String targetName = var->name;
+    auto found = variables.begin();
     while(found != variables.end())
     {
-        if(found->first == NameString || found->second.alias == NameString)
+        if(found->second.name == targetName || found->second.alias == targetName)
         {
+            variableIndex.erase(found->first);
             found = variables.erase(found); // Invalidate iterators
         }
         else
@@ -346,19 +365,13 @@ bool vargettype(const char* Name, VAR_TYPE* Type, VAR_VALUE_TYPE* ValueType)
 {
     SHARED_ACQUIRE(LockVariables);
 
-    String name_;
-    if(*Name != '$')
-        name_ = "$";
-    name_ += Name;
-    auto found = variables.find(name_);
-    if(found == variables.end()) //not found
+    auto var = varfind(Name);
+    if(!var) //not found
         return false;
-    if(found->second.alias.length())
-        return vargettype(found->second.alias.c_str(), Type, ValueType);
     if(ValueType)
-        *ValueType = found->second.value.type;
+        *ValueType = var->value.type;
     if(Type)
-        *Type = found->second.type;
+        *Type = var->type;
     return true;
 }
 
@@ -1,5 +1,7 @@
 #include "watch.h"
 #include "console.h"
+#include "memory.h"
+#include "memwatch.h"
 #include "threading.h"
 #include "debugger.h"
 #include "taskthread.h"
@@ -19,6 +21,100 @@ WatchExpr::WatchExpr(const char* name, const char* expression, WATCHVARTYPE type
     if(!expr.IsValidExpression())
         varType = WATCHVARTYPE::TYPE_INVALID;
     strcpy_s(this->WatchName, name);
+    classifyDependencies();
+}
+
+WatchExpr::~WatchExpr()
+{
+    for(auto id : memDeps)
+        MemWatchUnregister(id);
+}
+
+// Determine what the expression reads so cbCheckWatchdog can skip re-evaluation when none of the inputs changed
+void WatchExpr::classifyDependencies()
+{
+    dependencies = DEP_CONSTANT;
+    regDeps.clear();
+    auto addRegDep = [this](const String & name)
+    {
+        dependencies |= DEP_REGISTER;
+        const char* reg = name[0] == '_' ? "cflags" : name.c_str(); // flags (_zf) all map to the flags register
+        bool present = false;
+        for(const auto & dep : regDeps)
+            present |= dep.first == reg;
+        if(!present)
+            regDeps.emplace_back(reg, 0);
+    };
+    for(const auto & token : expr.GetTokens())
+    {
+        if(token.type() == ExpressionParser::Token::Type::Function)
+        {
+            dependencies |= DEP_MEMORY; // expression functions may read memory or other volatile state
+            continue;
+        }
+        if(token.type() != ExpressionParser::Token::Type::Data)
+            continue;
+        const auto & data = token.data();
+        if(data.find('[') != String::npos) // memory operand, the registers inside form the address
+        {
+            dependencies |= DEP_MEMORY;
+            String ident;
+            for(size_t i = 0; i <= data.size(); i++) // the registers still count as inputs: a new address means new memory
+            {
+                char ch = i < data.size() ? data[i] : '\0';
+                if(isalnum((unsigned char)ch) || ch == '_')
+                {
+                    ident += ch;
+                    continue;
+                }
+                if(!ident.empty() && valtokendep(ident.c_str()) == dep_register)
+                    addRegDep(ident);
+                ident.clear();
+            }
+            continue;
+        }
+        switch(valtokendep(data.c_str()))
+        {
+        case dep_register:
+            addRegDep(data);
+            break;
+        case dep_constant:
+            break;
+        default:
+            dependencies |= DEP_OTHER;
+            break;
+        }
+    }
+}
+
+// Check whether the expression has to be re-evaluated on this debug event. Updates the stored register values as a side effect.
+bool WatchExpr::needsRefresh()
+{
+    if(!haveCurrValue)
+        return true;
+    // these modes can (re)trigger even when all the inputs stayed the same
+    if(watchdogMode == WATCHDOGMODE::MODE_ISTRUE || watchdogMode == WATCHDOGMODE::MODE_ISFALSE || watchdogMode == WATCHDOGMODE::MODE_UNCHANGED)
+        return true;
+    if(dependencies & DEP_OTHER)
+        return true;
+    bool changed = false;
+    if(dependencies & DEP_MEMORY)
+    {
+        if(memDeps.empty()) // never tracked, cannot prove the memory inputs unchanged
+            return true;
+        for(auto id : memDeps)
+            changed |= MemWatchIsDirty(id);
+    }
+    for(auto & dep : regDeps)
+    {
+        duint value = getregister(nullptr, dep.first.c_str());
+        if(value != dep.second)
+        {
+            dep.second = value;
+            changed = true;
+        }
+    }
+    return changed;
 }
 
 duint WatchExpr::getIntValue()
@@ -29,7 +125,19 @@ duint WatchExpr::getIntValue()
             varType == WATCHVARTYPE::TYPE_ASCII || varType == WATCHVARTYPE::TYPE_UNICODE)
     {
         duint val;
+        // track the ranges the expression reads so needsRefresh can check them for changes
+        bool track = (dependencies & DEP_MEMORY) != 0;
+        if(track)
+            MemReadTrackStart();
         bool ok = expr.Calculate(val, varType == WATCHVARTYPE::TYPE_INT, false);
+        if(track)
+        {
+            for(auto id : memDeps)
+                MemWatchUnregister(id);
+            memDeps.clear();
+            for(const auto & range : MemReadTrackStop())
+                memDeps.push_back(MemWatchRegister(range.first, range.second));
+        }
         if(ok)
         {
             currValue = val;
@@ -92,6 +200,7 @@ bool WatchExpr::modifyExpr(const char* expression, WATCHVARTYPE type)
         varType = type;
         currValue = 0;
         haveCurrValue = false;
+        classifyDependencies();
         return true;
     }
     else
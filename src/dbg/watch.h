@@ -5,6 +5,15 @@
 #include "expressionparser.h"
 #include <map>
 
+// What a watch expression reads, used to skip re-evaluation on debug events
+enum WATCHDEPFLAGS
+{
+    DEP_CONSTANT = 0, // numeric literals and named constants only
+    DEP_REGISTER = 1, // reads the CPU context
+    DEP_MEMORY = 2, // reads target memory or calls an expression function
+    DEP_OTHER = 4 // variables, labels, symbols, plugin values
+};
+
 class WatchExpr
 {
 protected:
@@ -14,14 +23,20 @@ protected:
     bool haveCurrValue;
     WATCHVARTYPE varType;
     duint currValue; // last result of getIntValue()
+    unsigned int dependencies; // WATCHDEPFLAGS of what the expression reads
+    std::vector<std::pair<String, duint>> regDeps; // referenced registers with their last seen values
+    std::vector<unsigned int> memDeps; // memwatch registrations for the ranges the expression read
+
+    void classifyDependencies();
 
 public:
     bool watchdogTriggered;
     unsigned int watchWindow;
 
     WatchExpr(const char* name, const char* expression, WATCHVARTYPE type);
-    ~WatchExpr() {};
+    ~WatchExpr();
     duint getIntValue(); // evaluate the expression as integer
+    bool needsRefresh(); // check the dependencies for changes since the last evaluation
     bool modifyExpr(const char* expression, WATCHVARTYPE type); // modify the expression and data type
     void modifyName(const char* newName);
 
@@ -12,6 +12,7 @@
 #include "console.h"
 #include "x64dbg.h"
 #include "msgqueue.h"
+#include "performance.h"
 #include "threading.h"
 #include "watch.h"
 #include "plugin_loader.h"
@@ -146,6 +147,7 @@ static void registercommands()
     dbgcmdnew("bpgoto", cbDebugSetBPGoto, true);
     dbgcmdnew("bplist", cbDebugBplist, true); //breakpoint list
     dbgcmdnew("SetBPXOptions,bptype", cbDebugSetBPXOptions, false); //breakpoint type
+    dbgcmdnew("bpbatch", cbDebugBpBatch, false); //batch breakpoint operations
 
     //conditional breakpoint control
     dbgcmdnew("SetBreakpointName,bpname", cbDebugSetBPXName, true); //set breakpoint name
@@ -221,6 +223,8 @@ static void registercommands()
     dbgcmdnew("TraceSetCommand,SetTraceCommand", cbDebugTraceSetCommand, true); //Set trace command text + condition
     dbgcmdnew("TraceSetSwitchCondition,SetTraceSwitchCondition", cbDebugTraceSetSwitchCondition, true); //Set trace switch condition
     dbgcmdnew("TraceSetLogFile,SetTraceLogFile", cbDebugTraceSetLogFile, true); //Set trace log file
+    dbgcmdnew("TraceSetFast,SetTraceFast", cbDebugTraceSetFast, true); //Set fast trace mode (skip per-step bookkeeping)
+    dbgcmdnew("TraceSetBranchStep,SetTraceBranchStep", cbDebugTraceSetBranchStep, true); //Set branch step trace mode (one debug event per basic block)
     dbgcmdnew("StartRunTrace,opentrace", cbDebugStartRunTrace, true); //start run trace (Ollyscript command "opentrace" "opens run trace window")
     dbgcmdnew("StopRunTrace,tc", cbDebugStopRunTrace, true); //stop run trace (and Ollyscript command)
 
@@ -240,9 +244,15 @@ static void registercommands()
     dbgcmdnew("free", cbDebugFree, true); //free memory
     dbgcmdnew("Fill,memset", cbDebugMemset, true); //memset
     dbgcmdnew("memcpy", cbDebugMemcpy, true); //memcpy
+    dbgcmdnew("undoedit,editundo", cbDebugUndoEdit, true); //undo the last memory edit
+    dbgcmdnew("redoedit,editredo", cbDebugRedoEdit, true); //redo the last undone memory edit
     dbgcmdnew("getpagerights,getrightspage", cbDebugGetPageRights, true);
     dbgcmdnew("setpagerights,setrightspage", cbDebugSetPageRights, true);
     dbgcmdnew("savedata", cbInstrSavedata, true); //save data to disk
+    dbgcmdnew("memsnap,memsnapshot", cbInstrMemSnapshot, true); //capture a memory snapshot TODO: undocumented
+    dbgcmdnew("memsnapload", cbInstrMemSnapshotLoad, false); //load a memory snapshot from disk TODO: undocumented
+    dbgcmdnew("memsnapclose", cbInstrMemSnapshotClose, false); //unload the memory snapshot TODO: undocumented
+    dbgcmdnew("memsnapdiff", cbInstrMemSnapshotDiff, true); //diff the memory snapshot against live memory TODO: undocumented
 
     //operating system control
     dbgcmdnew("GetPrivilegeState", cbGetPrivilegeState, true); //get priv state
@@ -271,14 +281,17 @@ static void registercommands()
     dbgcmdnew("find", cbInstrFind, true); //find a pattern
     dbgcmdnew("findall", cbInstrFindAll, true); //find all patterns
     dbgcmdnew("findallmem,findmemall", cbInstrFindAllMem, true); //memory map pattern find
+    dbgcmdnew("findallmemmulti,findmemallmulti", cbInstrFindAllMemMulti, true); //memory map multi-pattern find
     dbgcmdnew("findasm,asmfind", cbInstrFindAsm, true); //find instruction
     dbgcmdnew("reffind,findref,ref", cbInstrRefFind, true); //find references to a value
     dbgcmdnew("reffindrange,findrefrange,refrange", cbInstrRefFindRange, true);
     dbgcmdnew("refstr,strref", cbInstrRefStr, true); //find string references
+    dbgcmdnew("findstrings,strscan", cbInstrFindStrings, true); //find strings in raw memory
     dbgcmdnew("reffunctionpointer", cbInstrRefFuncionPointer, true); //find function pointers
     dbgcmdnew("modcallfind", cbInstrModCallFind, true); //find intermodular calls
     dbgcmdnew("setmaxfindresult,findsetmaxresult", cbInstrSetMaxFindResult, false); //set the maximum number of occurences found
     dbgcmdnew("guidfind,findguid", cbInstrGUIDFind, true); //find GUID references TODO: undocumented
+    dbgcmdnew("ptrscan,pointerscan", cbInstrPointerScan, true); //find pointer chains to an address TODO: undocumented
 
     //user database
     dbgcmdnew("dbsave,savedb", cbInstrDbsave, true); //save program database
@@ -324,6 +337,11 @@ static void registercommands()
     dbgcmdnew("analrecur,analr", cbInstrAnalrecur, true); //analyze a single function
     dbgcmdnew("analadv", cbInstrAnalyseadv, true); //analyze xref,function and data
     dbgcmdnew("traceexecute", cbInstrTraceexecute, true); //execute trace record on address TODO: undocumented
+    dbgcmdnew("SaveTraceRecordCoverage,savecoverage", cbInstrSaveTraceCoverage, true); //save trace record coverage as a DRCOV file
+    dbgcmdnew("TraceScopeInclude,tracescopeinclude", cbInstrTraceScopeInclude, true); //limit trace recording to a module or range TODO: undocumented
+    dbgcmdnew("TraceScopeExclude,tracescopeexclude", cbInstrTraceScopeExclude, true); //exclude a module or range from trace recording TODO: undocumented
+    dbgcmdnew("TraceScopeClear,tracescopeclear", cbInstrTraceScopeClear, true); //clear the trace recording scope TODO: undocumented
+    dbgcmdnew("TraceScopeList,tracescopelist", cbInstrTraceScopeList, true); //list the trace recording scope TODO: undocumented
 
     dbgcmdnew("virtualmod", cbInstrVirtualmod, true); //virtual module
     dbgcmdnew("symdownload,downloadsym", cbDebugDownloadSymbol, true); //download symbols
@@ -414,6 +432,7 @@ static void registercommands()
     dbgcmdnew("HideDebugger,dbh,hide", cbDebugHide, true); //HideDebugger
     dbgcmdnew("loadlib", cbDebugLoadLib, true); //Load DLL
     dbgcmdnew("freelib", cbDebugFreeLib, true); //Unload DLL TODO: undocumented
+    dbgcmdnew("runtocond,rtc", cbDebugRunToCondition, true); //run until an injected condition stub hits TODO: undocumented
     dbgcmdnew("asm", cbInstrAssemble, true); //assemble instruction
     dbgcmdnew("gpa", cbInstrGpa, true); //get proc address
 
@@ -430,6 +449,9 @@ static void registercommands()
 
     dbgcmdnew("config", cbInstrConfig, false); //get or set config uint
     dbgcmdnew("restartadmin,runas,adminrestart", cbInstrRestartadmin, false); //restart x64dbg as administrator
+    dbgcmdnew("locktelemetry,lockstats", cbInstrLockTelemetry, false); //lock contention telemetry
+    dbgcmdnew("perf,perfmarkers", cbInstrPerf, false); //hot path performance markers
+    dbgcmdnew("eventstats", cbInstrEventStats, true); //aggregated debug event statistics TODO: undocumented
 
     //undocumented
     dbgcmdnew("bench", cbDebugBenchmark, true); //benchmark test (readmem etc)
@@ -444,11 +466,32 @@ static void registercommands()
     dbgcmdnew("focusinfo", cbInstrFocusinfo, false);
     dbgcmdnew("printstack,logstack", cbInstrPrintStack, true); //print the call stack
     dbgcmdnew("flushlog", cbInstrFlushlog, false); //flush the log
+    dbgcmdnew("lossylog", cbInstrLossyLog, false); //drop log lines instead of blocking when flooded
     dbgcmdnew("AnimateWait", cbInstrAnimateWait, true); //Wait for the debuggee to pause.
     dbgcmdnew("dbdecompress", cbInstrDbdecompress, false); //Decompress a database.
     dbgcmdnew("DebugFlags", cbInstrDebugFlags, false); //Set ntdll LdrpDebugFlags
 };
 
+static bool dbgisstepcommand(const char* cmd)
+{
+    //aliases of cbDebugStepInto/cbDebugStepOver (see registercommands)
+    static const char* stepCommands[] =
+    {
+        "StepInto", "sti", "SingleStep", "sstep", "sst",
+        "eStepInto", "esti", "seStepInto", "sesti", "eSingleStep", "esstep", "esst",
+        "StepOver", "step", "sto", "st",
+        "eStepOver", "estep", "esto", "est",
+        "seStepOver", "sestep", "sesto", "sest",
+    };
+    size_t len = 0;
+    while(cmd[len] && cmd[len] != ' ' && cmd[len] != ';' && cmd[len] != ',')
+        len++;
+    for(auto stepCommand : stepCommands)
+        if(strlen(stepCommand) == len && !_memicmp(cmd, stepCommand, len))
+            return true;
+    return false;
+}
+
 bool cbCommandProvider(char* cmd, int maxlen)
 {
     MESSAGE msg;
@@ -463,6 +506,8 @@ bool cbCommandProvider(char* cmd, int maxlen)
     }
     strcpy_s(cmd, deflen, newcmd);
     efree(newcmd, "cbCommandProvider:newcmd"); //free allocated command
+    if(dbgisstepcommand(cmd))
+        StepLatencyMark(StepStage::Dispatch);
     return true;
 }
 
@@ -474,6 +519,8 @@ extern "C" DLL_EXPORT bool _dbg_dbgcmdexec(const char* cmd)
     int len = (int)strlen(cmd);
     char* newcmd = (char*)emalloc((len + 1) * sizeof(char), "_dbg_dbgcmdexec:newcmd");
     strcpy_s(newcmd, len + 1, cmd);
+    if(dbgisstepcommand(cmd))
+        StepLatencyBegin(); //this runs on the caller's (GUI) thread, so it stamps the bridge boundary
     return MsgSend(gMsgStack, 0, (duint)newcmd, 0);
 }
 
@@ -575,6 +622,8 @@ static bool DbgScriptDllExec(const char* dll)
 
 static DWORD WINAPI loadDbThread(LPVOID)
 {
+    auto ticks = GetTickCount();
+
     // Load error codes
     if(ErrorCodeInit(StringUtils::sprintf("%s\\..\\errordb.txt", szProgramDir)))
         dputs(QT_TRANSLATE_NOOP("DBG", "Error codes database loaded!"));
@@ -599,6 +648,15 @@ static DWORD WINAPI loadDbThread(LPVOID)
     else
         dputs(QT_TRANSLATE_NOOP("DBG", "Failed to load Windows constants..."));
 
+    dprintf(QT_TRANSLATE_NOOP("DBG", "File read thread finished in %ums!\n"), GetTickCount() - ticks);
+
+    return 0;
+}
+
+static DWORD WINAPI loadMiscThread(LPVOID)
+{
+    auto ticks = GetTickCount();
+
     // Load global notes
     dputs(QT_TRANSLATE_NOOP("DBG", "Reading notes file..."));
     notesFile = String(szProgramDir) + "\\notes.txt";
@@ -615,7 +673,7 @@ static DWORD WINAPI loadDbThread(LPVOID)
     else
         dputs(QT_TRANSLATE_NOOP("DBG", "Failed to load syscall indices..."));
 
-    dputs(QT_TRANSLATE_NOOP("DBG", "File read thread finished!"));
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Misc read thread finished in %ums!\n"), GetTickCount() - ticks);
 
     return 0;
 }
@@ -692,6 +750,7 @@ extern "C" DLL_EXPORT const char* _dbg_dbginit()
     setalloctrace(alloctrace);
 #endif //ENABLE_MEM_TRACE
 
+    auto initTicks = GetTickCount();
     dputs(QT_TRANSLATE_NOOP("DBG", "Initializing wait objects..."));
     waitinitialize();
     SafeDbghelpInitialize();
@@ -711,8 +770,9 @@ extern "C" DLL_EXPORT const char* _dbg_dbginit()
     strcat_s(scriptDllDir, "\\scripts\\");
     initDataInstMap();
 
-    dputs(QT_TRANSLATE_NOOP("DBG", "Start file read thread..."));
+    dputs(QT_TRANSLATE_NOOP("DBG", "Start file read threads..."));
     CloseHandle(CreateThread(nullptr, 0, loadDbThread, nullptr, 0, nullptr));
+    CloseHandle(CreateThread(nullptr, 0, loadMiscThread, nullptr, 0, nullptr));
 
     // Create database directory in the local debugger folder
     DbSetPath(StringUtils::sprintf("%s\\db", szProgramDir).c_str(), nullptr);
@@ -790,7 +850,9 @@ extern "C" DLL_EXPORT const char* _dbg_dbginit()
     dputs(QT_TRANSLATE_NOOP("DBG", "Initialization successful!"));
     bIsStopped = false;
     dputs(QT_TRANSLATE_NOOP("DBG", "Loading plugins..."));
+    auto pluginTicks = GetTickCount();
     pluginloadall(plugindir);
+    dprintf(QT_TRANSLATE_NOOP("DBG", "Debugger initialized in %ums (plugins: %ums)!\n"), GetTickCount() - initTicks, GetTickCount() - pluginTicks);
     dputs(QT_TRANSLATE_NOOP("DBG", "Handling command line..."));
     dprintf("  %s\n", StringUtils::Utf16ToUtf8(GetCommandLineW()).c_str());
     //handle command line
@@ -4,9 +4,21 @@
 struct XREFSINFO : AddrInfo
 {
     XREFTYPE type = XREF_NONE;
-    std::unordered_map<duint, XREF_RECORD> references;
+    std::vector<XREF_RECORD> references; //sorted by addr, no duplicates
 };
 
+static void sortReferences(std::vector<XREF_RECORD> & references)
+{
+    std::sort(references.begin(), references.end(), [](const XREF_RECORD & a, const XREF_RECORD & b)
+    {
+        return a.addr < b.addr;
+    });
+    references.erase(std::unique(references.begin(), references.end(), [](const XREF_RECORD & a, const XREF_RECORD & b)
+    {
+        return a.addr == b.addr;
+    }), references.end());
+}
+
 struct XrefSerializer : AddrInfoSerializer<XREFSINFO>
 {
     bool Save(const XREFSINFO & value) override
@@ -16,8 +28,8 @@ struct XrefSerializer : AddrInfoSerializer<XREFSINFO>
         for(const auto & itr : value.references)
         {
             auto reference = json_object();
-            json_object_set_new(reference, "addr", json_hex(itr.second.addr));
-            json_object_set_new(reference, "type", json_hex(itr.second.type));
+            json_object_set_new(reference, "addr", json_hex(itr.addr));
+            json_object_set_new(reference, "type", json_hex(itr.type));
             json_array_append_new(references, reference);
         }
         set("references", references);
@@ -32,6 +44,7 @@ struct XrefSerializer : AddrInfoSerializer<XREFSINFO>
         if(!references)
             return false;
         value.type = XREF_DATA;
+        value.references.reserve(json_array_size(references));
         size_t i;
         JSON reference;
         json_array_foreach(references, i, reference)
@@ -40,8 +53,9 @@ struct XrefSerializer : AddrInfoSerializer<XREFSINFO>
             record.addr = duint(json_hex_value(json_object_get(reference, "addr")));
             record.type = XREFTYPE(json_hex_value(json_object_get(reference, "type")));
             value.type = max(record.type, value.type);
-            value.references.insert({ record.addr, record });
+            value.references.push_back(record);
         }
+        sortReferences(value.references);
         return true;
     }
 };
@@ -58,41 +72,85 @@ static Xrefs xrefs;
 
 bool XrefAdd(duint Address, duint From)
 {
-    XREFSINFO info;
-    if(!MemIsValidReadPtr(From) || !xrefs.PrepareValue(info, Address, false))
-        return false;
+    XREF_EDGE edge;
+    edge.addr = Address;
+    edge.from = From;
+    edge.type = XREF_NONE;
+    return XrefAddMulti(&edge, 1);
+}
 
-    // Fail if boundary exceeds module size
-    auto moduleBase = ModBaseFromAddr(Address);
-    if(moduleBase != ModBaseFromAddr(From))
+bool XrefAddMulti(const XREF_EDGE* Edges, duint Count)
+{
+    if(!Edges || !Count)
         return false;
 
-    BASIC_INSTRUCTION_INFO instInfo;
-    DbgDisasmFastAt(From, &instInfo);
+    //classify the edges and group them per destination outside the lock, so
+    //analysis passes inserting millions of references disassemble and
+    //allocate without blocking readers and take the lock exactly once
+    std::unordered_map<duint, XREFSINFO> prepared;
+    prepared.reserve(Count);
+    for(duint i = 0; i < Count; i++)
+    {
+        const auto & edge = Edges[i];
+        auto moduleBase = ModBaseFromAddr(edge.addr);
+
+        // Fail if boundary exceeds module size
+        if(moduleBase != ModBaseFromAddr(edge.from))
+            continue;
+        if(!MemIsValidReadPtr(edge.from))
+            continue;
+
+        auto key = Xrefs::VaKey(edge.addr);
+        auto found = prepared.find(key);
+        if(found == prepared.end())
+        {
+            XREFSINFO info;
+            if(!xrefs.PrepareValue(info, edge.addr, false))
+                continue;
+            found = prepared.insert({ key, std::move(info) }).first;
+        }
+
+        XREF_RECORD xrefRecord;
+        xrefRecord.addr = edge.from - moduleBase;
+        if(edge.type != XREF_NONE) //the caller already knows the reference type
+            xrefRecord.type = edge.type;
+        else
+        {
+            BASIC_INSTRUCTION_INFO instInfo;
+            DbgDisasmFastAt(edge.from, &instInfo);
+            if(instInfo.call)
+                xrefRecord.type = XREF_CALL;
+            else if(instInfo.branch)
+                xrefRecord.type = XREF_JMP;
+            else
+                xrefRecord.type = XREF_DATA;
+        }
+
+        auto & info = found->second;
+        info.references.push_back(xrefRecord);
+        info.type = max(info.type, xrefRecord.type);
+    }
+
+    if(prepared.empty())
+        return false;
 
-    XREF_RECORD xrefRecord;
-    xrefRecord.addr = From - moduleBase;
-    if(instInfo.call)
-        xrefRecord.type = XREF_CALL;
-    else if(instInfo.branch)
-        xrefRecord.type = XREF_JMP;
-    else
-        xrefRecord.type = XREF_DATA;
+    for(auto & itr : prepared)
+        sortReferences(itr.second.references);
 
     EXCLUSIVE_ACQUIRE(LockCrossReferences);
     auto & mapData = xrefs.GetDataUnsafe();
-    auto key = Xrefs::VaKey(Address);
-    auto found = mapData.find(key);
-    if(found == mapData.end())
-    {
-        info.type = xrefRecord.type;
-        info.references.insert({ xrefRecord.addr, xrefRecord });
-        mapData.insert({ key, info });
-    }
-    else
+    for(auto & itr : prepared)
     {
-        found->second.references.insert({ xrefRecord.addr, xrefRecord });
-        found->second.type = max(found->second.type, xrefRecord.type);
+        auto found = mapData.find(itr.first);
+        if(found == mapData.end())
+            mapData.insert(std::move(itr));
+        else
+        {
+            auto & references = found->second.references;
+            references.insert(references.end(), itr.second.references.begin(), itr.second.references.end());
+            sortReferences(references);
+            found->second.type = max(found->second.type, itr.second.type);
+        }
     }
     return true;
 }
@@ -110,7 +168,7 @@ bool XrefGet(duint Address, XREF_INFO* List)
     auto ptr = List->references;
     for(const auto & itr : found->second.references)
     {
-        *ptr = itr.second;
+        *ptr = itr;
         ptr->addr += moduleBase;
         ++ptr;
     }
@@ -4,7 +4,15 @@
 #include "_global.h"
 #include "jansson/jansson_x64dbg.h"
 
+struct XREF_EDGE
+{
+    duint addr; //destination of the reference
+    duint from; //source of the reference
+    XREFTYPE type = XREF_NONE; //XREF_NONE means classify by disassembling 'from'
+};
+
 bool XrefAdd(duint Address, duint From);
+bool XrefAddMulti(const XREF_EDGE* Edges, duint Count);
 bool XrefGet(duint Address, XREF_INFO* List);
 duint XrefGetCount(duint Address);
 XREFTYPE XrefGetType(duint Address);
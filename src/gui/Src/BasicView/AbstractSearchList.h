@@ -2,6 +2,7 @@
 #define ABSTRACTSEARCHLIST_H
 
 #include "AbstractStdTable.h"
+#include <vector>
 
 class AbstractSearchList
 {
@@ -20,7 +21,13 @@ public:
     virtual void unlock() = 0;
     virtual AbstractStdTable* list() const = 0;
     virtual AbstractStdTable* searchList() const = 0;
-    virtual void filter(const QString & filter, FilterType type, int startColumn) = 0;
+
+    // Reset the search list to an empty result set. The caller holds the lock
+    virtual void clearSearchList() = 0;
+
+    // Append the given source list rows to the search list. The caller holds
+    // the lock and has already matched the rows against the filter
+    virtual void appendToSearchList(const std::vector<int> & rows) = 0;
 
     bool rowMatchesFilter(const QString & filter, FilterType type, int row, int startColumn) const
     {
@@ -1,6 +1,8 @@
 #include "AbstractStdTable.h"
 #include "Bridge.h"
 #include "RichTextPainter.h"
+#include "MiscUtil.h"
+#include <QMessageBox>
 
 AbstractStdTable::AbstractStdTable(QWidget* parent) : AbstractTableView(parent)
 {
@@ -617,15 +619,14 @@ int AbstractStdTable::getInitialSelection() const
     return mSelection.firstSelectedIndex;
 }
 
-QList<int> AbstractStdTable::getSelection() const
+int AbstractStdTable::getSelectionStart() const
 {
-    QList<int> selection;
-    selection.reserve(mSelection.toIndex - mSelection.fromIndex);
-    for(int i = mSelection.fromIndex; i <= mSelection.toIndex; i++)
-    {
-        selection.append(i);
-    }
-    return selection;
+    return mSelection.fromIndex;
+}
+
+int AbstractStdTable::getSelectionEnd() const
+{
+    return mSelection.toIndex;
 }
 
 void AbstractStdTable::selectStart()
@@ -733,7 +734,7 @@ void AbstractStdTable::copyLineSlot()
         finalText = getCellContent(getInitialSelection(), 0);
     else
     {
-        for(int selected : getSelection())
+        for(int selected = getSelectionStart(); selected <= getSelectionEnd(); selected++)
         {
             for(int i = 0; i < colCount; i++)
             {
@@ -775,55 +776,102 @@ void AbstractStdTable::copyLineToLogSlot()
     emit Bridge::getBridge()->addMsgToLog(finalText.toUtf8());
 }
 
-QString AbstractStdTable::copyTable(const std::vector<int> & colWidths)
+QString AbstractStdTable::copyTableHeader(const std::vector<int> & colWidths)
 {
     int colCount = getColumnCount();
-    int rowCount = getRowCount();
+    if(colCount == 1) //single-column tables are copied without a header
+        return QString();
     QString finalText = "";
+    for(int i = 0; i < colCount; i++)
+    {
+        if(i)
+            finalText += " ";
+        int colWidth = colWidths[i];
+        if(colWidth)
+            finalText += getColTitle(i).leftJustified(colWidth, QChar(' '), true);
+        else
+            finalText += getColTitle(i);
+    }
+    return finalText;
+}
+
+QString AbstractStdTable::copyTableRow(int row, const std::vector<int> & colWidths)
+{
+    int colCount = getColumnCount();
     if(colCount == 1)
     {
-        for(int i = 0; i < rowCount; i++)
-        {
-            QString cellContent = getCellContent(i, 0);
-            if(!cellContent.length()) //skip empty cells
-                continue;
-            finalText += cellContent + "\r\n";
-        }
+        QString cellContent = getCellContent(row, 0);
+        if(!cellContent.length()) //skip empty cells
+            return QString();
+        return cellContent;
     }
-    else
+    QString finalRowText = "";
+    for(int j = 0; j < colCount; j++)
     {
-        //std::vector<int> colWidths;
-        //for(int i = 0; i < colCount; i++)
-        //    colWidths.push_back(getMaxColumnLength(i));
-        for(int i = 0; i < colCount; i++)
-        {
-            if(i)
-                finalText += " ";
-            int colWidth = colWidths[i];
-            if(colWidth)
-                finalText += getColTitle(i).leftJustified(colWidth, QChar(' '), true);
-            else
-                finalText += getColTitle(i);
-        }
-        finalText += "\r\n";
-        for(int i = 0; i < rowCount; i++)
+        if(j)
+            finalRowText += " ";
+        QString cellContent = getCellContent(row, j);
+        int colWidth = colWidths[j];
+        if(colWidth && j != colCount - 1)
+            finalRowText += cellContent.leftJustified(colWidth, QChar(' '), true);
+        else
+            finalRowText += cellContent;
+    }
+    return finalRowText;
+}
+
+QString AbstractStdTable::copyTable(const std::vector<int> & colWidths)
+{
+    int rowCount = getRowCount();
+    QString finalText = "";
+    //reserve the estimated size up front so appending rows doesn't repeatedly
+    //reallocate a buffer that can reach hundreds of megabytes
+    dsint rowWidth = 2;
+    for(auto colWidth : colWidths)
+        rowWidth += (colWidth ? colWidth : 20) + 1;
+    finalText.reserve(int(std::min(dsint(INT_MAX / 2), rowWidth * (rowCount + 1))));
+    QString header = copyTableHeader(colWidths);
+    if(!header.isNull())
+        finalText += header + "\r\n";
+    for(int i = 0; i < rowCount; i++)
+    {
+        QString rowText = copyTableRow(i, colWidths);
+        if(rowText.isNull()) //skipped row
+            continue;
+        finalText += rowText + "\r\n";
+    }
+    return finalText;
+}
+
+void AbstractStdTable::copyTableChecked(const std::vector<int> & colWidths)
+{
+    //a clipboard assignment needs the whole payload in one buffer, so for
+    //very large tables offer a streamed export to a file instead
+    dsint rowWidth = 2;
+    for(auto colWidth : colWidths)
+        rowWidth += (colWidth ? colWidth : 20) + 1;
+    auto estimatedChars = rowWidth * (dsint(getRowCount()) + 1);
+    if(estimatedChars > 32 * 1024 * 1024)
+    {
+        auto answer = QMessageBox::question(this, tr("Copy table"),
+                                            tr("The selection is very large and copying it to the clipboard may run out of memory.\n\nExport it to a file instead?"),
+                                            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel, QMessageBox::Yes);
+        if(answer == QMessageBox::Cancel)
+            return;
+        if(answer == QMessageBox::Yes)
         {
-            QString finalRowText = "";
-            for(int j = 0; j < colCount; j++)
+            QString header = copyTableHeader(colWidths);
+            auto headerRows = header.isNull() ? 0 : 1;
+            ExportTableText(dsint(getRowCount()) + headerRows, [this, &colWidths, &header, headerRows](dsint row) -> QString
             {
-                if(j)
-                    finalRowText += " ";
-                QString cellContent = getCellContent(i, j);
-                int colWidth = colWidths[j];
-                if(colWidth && j != colCount - 1)
-                    finalRowText += cellContent.leftJustified(colWidth, QChar(' '), true);
-                else
-                    finalRowText += cellContent;
-            }
-            finalText += finalRowText + "\r\n";
+                if(headerRows && row == 0)
+                    return header;
+                return copyTableRow(int(row - headerRows), colWidths);
+            });
+            return;
         }
     }
-    return finalText;
+    Bridge::CopyToClipboard(copyTable(colWidths));
 }
 
 void AbstractStdTable::copyTableSlot()
@@ -832,7 +880,7 @@ void AbstractStdTable::copyTableSlot()
     int colCount = getColumnCount();
     for(int i = 0; i < colCount; i++)
         colWidths.push_back(getColumnWidth(i) / getCharWidth());
-    Bridge::CopyToClipboard(copyTable(colWidths));
+    copyTableChecked(colWidths);
 }
 
 void AbstractStdTable::copyTableToLogSlot()
@@ -856,7 +904,7 @@ void AbstractStdTable::copyTableResizeSlot()
             max = std::max(getCellContent(j, i).length(), max);
         colWidths.push_back(max);
     }
-    Bridge::CopyToClipboard(copyTable(colWidths));
+    copyTableChecked(colWidths);
 }
 
 void AbstractStdTable::copyTableResizeToLogSlot()
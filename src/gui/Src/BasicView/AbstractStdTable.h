@@ -28,7 +28,8 @@ public:
     void expandBottom();
     void setSingleSelection(int index);
     int getInitialSelection() const;
-    QList<int> getSelection() const;
+    int getSelectionStart() const;
+    int getSelectionEnd() const;
     void selectStart();
     void selectEnd();
     void selectNext();
@@ -96,6 +97,9 @@ public slots:
 
 protected:
     QString copyTable(const std::vector<int> & colWidths);
+    QString copyTableHeader(const std::vector<int> & colWidths);
+    QString copyTableRow(int row, const std::vector<int> & colWidths);
+    void copyTableChecked(const std::vector<int> & colWidths);
 
     struct SelectionData
     {
@@ -1,5 +1,6 @@
 #include "AbstractTableView.h"
 #include <QStyleOptionButton>
+#include <QOpenGLWidget>
 #include "Configuration.h"
 #include "ColumnReorderDialog.h"
 #include "CachedFontMetrics.h"
@@ -54,7 +55,18 @@ AbstractTableView::AbstractTableView(QWidget* parent)
 
     mGuiState = AbstractTableView::NoState;
 
+    // Optionally composite through OpenGL: the rows are still rasterized into
+    // the paint cache, but blitting it to the screen goes through the GPU,
+    // which helps when several 4K table views repaint at once. Opt-in with the
+    // Gui/OpenGLViewport setting because driver quality varies.
+    duint openglViewport = 0;
+    if(BridgeSettingGetUint("Gui", "OpenGLViewport", &openglViewport) && openglViewport)
+        setViewport(new QOpenGLWidget(this));
+
     mShouldReload = true;
+    mPaintCacheOffset = 0;
+    mPaintCacheScrollX = 0;
+    mPaintCacheValid = false;
     mAllowPainting = true;
     mDrawDebugOnly = false;
     mPopupEnabled = true;
@@ -109,6 +121,7 @@ void AbstractTableView::updateColors()
     mSeparatorColor = ConfigColor("AbstractTableViewSeparatorColor");
     mHeaderTextColor = ConfigColor("AbstractTableViewHeaderTextColor");
     mSelectionColor = ConfigColor("AbstractTableViewSelectionColor");
+    mPaintCacheValid = false;
 }
 
 void AbstractTableView::updateFonts()
@@ -116,6 +129,7 @@ void AbstractTableView::updateFonts()
     setFont(ConfigFont("AbstractTableView"));
     invalidateCachedFont();
     mHeader.height = mFontMetrics->height() + 4;
+    mPaintCacheValid = false;
 }
 
 QColor AbstractTableView::getCellColor(int r, int c)
@@ -147,13 +161,24 @@ void AbstractTableView::updateShortcutsSlot()
 }
 
 void AbstractTableView::loadColumnFromConfig(const QString & viewName)
+{
+    mViewName = viewName;
+    if(!isVisible()) //most views start hidden in a tab, apply the state on first show instead
+    {
+        mColumnConfigPending = true;
+        return;
+    }
+    applyColumnConfig();
+}
+
+void AbstractTableView::applyColumnConfig()
 {
     int columnCount = getColumnCount();
     for(int i = 0; i < columnCount; i++)
     {
-        duint width = ConfigUint("Gui", QString("%1ColumnWidth%2").arg(viewName).arg(i).toUtf8().constData());
-        duint hidden = ConfigUint("Gui", QString("%1ColumnHidden%2").arg(viewName).arg(i).toUtf8().constData());
-        duint order = ConfigUint("Gui", QString("%1ColumnOrder%2").arg(viewName).arg(i).toUtf8().constData());
+        duint width = ConfigUint("Gui", QString("%1ColumnWidth%2").arg(mViewName).arg(i).toUtf8().constData());
+        duint hidden = ConfigUint("Gui", QString("%1ColumnHidden%2").arg(mViewName).arg(i).toUtf8().constData());
+        duint order = ConfigUint("Gui", QString("%1ColumnOrder%2").arg(mViewName).arg(i).toUtf8().constData());
         if(width != 0)
             setColumnWidth(i, width);
         if(hidden != 2)
@@ -161,13 +186,14 @@ void AbstractTableView::loadColumnFromConfig(const QString & viewName)
         if(order != 0)
             mColumnOrder[i] = order - 1;
     }
-    mViewName = viewName;
 }
 
 void AbstractTableView::saveColumnToConfig()
 {
     if(mViewName.length() == 0)
         return;
+    if(mColumnConfigPending) //never shown, the stored state is still the most recent one
+        return;
     int columnCount = getColumnCount();
     auto cfg = Config();
     for(int i = 0; i < columnCount; i++)
@@ -227,55 +253,135 @@ void AbstractTableView::paintEvent(QPaintEvent* event)
 
     Q_UNUSED(event);
     QPainter wPainter(this->viewport());
-    wPainter.setFont(font());
     int wViewableRowsCount = getViewableRowsCount();
 
     int scrollValue = -horizontalScrollBar()->value();
 
-    int x = scrollValue;
-    int y = 0;
-
     // Reload data if needed
     if(mPrevTableOffset != mTableOffset || mShouldReload == true)
     {
         updateScrollBarRange(getRowCount());
         prepareData();
-        mPrevTableOffset = mTableOffset;
-        mShouldReload = false;
+        if(mShouldReload == true)
+        {
+            mPaintCacheValid = false;
+            mShouldReload = false;
+        }
     }
 
-    // Paints background
-    wPainter.fillRect(wPainter.viewport(), QBrush(mBackgroundColor));
-
-    // Paints header
-    if(mHeader.isVisible == true)
+    // The rows are rendered into a cached pixmap so a paint event only has to
+    // redraw what actually changed: a pure scroll shifts the pixmap and renders
+    // the rows that came into view, a plain expose just blits it. The cache is
+    // slightly taller than the viewport so the partially visible bottom row is
+    // always fully rendered.
+    const qreal dpr = devicePixelRatioF();
+    const int wRowHeight = getRowHeight();
+    QSize wCacheSize(viewport()->width(), getHeaderHeight() + wViewableRowsCount * wRowHeight);
+    bool wCacheUsable = mPaintCacheValid && mPaintCache.devicePixelRatio() == dpr && mPaintCache.size() == wCacheSize * dpr && mPaintCacheScrollX == scrollValue;
+    dsint wScrolledRows = mTableOffset - mPaintCacheOffset;
+    mPrevTableOffset = mTableOffset;
+    if(wCacheUsable && wScrolledRows == 0)
+    {
+        // Nothing changed, the cache can be blitted as-is
+    }
+    else if(wCacheUsable && wScrolledRows > -wViewableRowsCount && wScrolledRows < wViewableRowsCount && dpr == qreal(int(dpr)))
     {
-        for(int j = 0; j < getColumnCount(); j++)
+        // Shift the cached rows and render only the exposed band, extended by
+        // one guard row because the jump graphics bleed a pixel across cells
+        int wHeaderPx = int(getHeaderHeight() * dpr);
+        mPaintCache.scroll(0, int(-wScrolledRows * wRowHeight * dpr), QRect(0, wHeaderPx, mPaintCache.width(), mPaintCache.height() - wHeaderPx));
+        QPainter cachePainter(&mPaintCache);
+        cachePainter.setFont(font());
+        if(wScrolledRows > 0)
         {
-            int i = mColumnOrder[j];
-            if(getColumnHidden(i))
-                continue;
-            int width = getColumnWidth(i);
-            QStyleOptionButton wOpt;
-            if((mColumnList[i].header.isPressed == true) && (mColumnList[i].header.isMouseOver == true)
-                    || (mGuiState == AbstractTableView::HeaderButtonReordering && mColumnOrder[mHoveredColumnDisplayIndex] == i))
-                wOpt.state = QStyle::State_Sunken;
-            else
-                wOpt.state = QStyle::State_Enabled;
+            int wFirstRow = wViewableRowsCount - int(wScrolledRows);
+            if(wFirstRow > 0)
+                wFirstRow--;
+            paintRows(cachePainter, scrollValue, wFirstRow, wViewableRowsCount - wFirstRow);
+        }
+        else
+        {
+            int wRowCount = int(-wScrolledRows) + 1;
+            if(wRowCount > wViewableRowsCount)
+                wRowCount = wViewableRowsCount;
+            paintRows(cachePainter, scrollValue, 0, wRowCount);
+        }
+        mPaintCacheOffset = mTableOffset;
+    }
+    else
+    {
+        if(mPaintCache.devicePixelRatio() != dpr || mPaintCache.size() != wCacheSize * dpr)
+        {
+            mPaintCache = QPixmap(wCacheSize * dpr);
+            mPaintCache.setDevicePixelRatio(dpr);
+        }
+        QPainter cachePainter(&mPaintCache);
+        cachePainter.setFont(font());
+        cachePainter.fillRect(QRect(QPoint(0, 0), wCacheSize), QBrush(mBackgroundColor));
+        paintHeader(cachePainter, scrollValue);
+        paintRows(cachePainter, scrollValue, 0, wViewableRowsCount);
+        mPaintCacheOffset = mTableOffset;
+        mPaintCacheScrollX = scrollValue;
+        mPaintCacheValid = true;
+    }
+    wPainter.drawPixmap(0, 0, mPaintCache);
+    //emit repainted();
+}
 
-            wOpt.rect = QRect(x, y, width, getHeaderHeight());
+/**
+ * @brief       Paints the header buttons at the top of the table.
+ *
+ * @param[in]   wPainter    Painter to draw with (viewport or paint cache)
+ * @param[in]   x           Leftmost x coordinate (horizontal scroll applied)
+ *
+ * @return      Nothing.
+ */
+void AbstractTableView::paintHeader(QPainter & wPainter, int x)
+{
+    if(mHeader.isVisible == false)
+        return;
 
-            mHeaderButtonSytle.style()->drawControl(QStyle::CE_PushButton, &wOpt, &wPainter, &mHeaderButtonSytle);
+    int y = 0;
+    for(int j = 0; j < getColumnCount(); j++)
+    {
+        int i = mColumnOrder[j];
+        if(getColumnHidden(i))
+            continue;
+        int width = getColumnWidth(i);
+        QStyleOptionButton wOpt;
+        if((mColumnList[i].header.isPressed == true) && (mColumnList[i].header.isMouseOver == true)
+                || (mGuiState == AbstractTableView::HeaderButtonReordering && mColumnOrder[mHoveredColumnDisplayIndex] == i))
+            wOpt.state = QStyle::State_Sunken;
+        else
+            wOpt.state = QStyle::State_Enabled;
 
-            wPainter.setPen(mHeaderTextColor);
-            wPainter.drawText(QRect(x + 4, y, width - 8, getHeaderHeight()), Qt::AlignVCenter | Qt::AlignLeft, mColumnList[i].title);
+        wOpt.rect = QRect(x, y, width, getHeaderHeight());
 
-            x += width;
-        }
+        mHeaderButtonSytle.style()->drawControl(QStyle::CE_PushButton, &wOpt, &wPainter, &mHeaderButtonSytle);
+
+        wPainter.setPen(mHeaderTextColor);
+        wPainter.drawText(QRect(x + 4, y, width - 8, getHeaderHeight()), Qt::AlignVCenter | Qt::AlignLeft, mColumnList[i].title);
+
+        x += width;
     }
+}
+
+/**
+ * @brief       Paints a band of viewable rows through paintContent.
+ *
+ * @param[in]   wPainter    Painter to draw with (viewport or paint cache)
+ * @param[in]   x           Leftmost x coordinate (horizontal scroll applied)
+ * @param[in]   firstRow    First row offset (relative to the table offset)
+ * @param[in]   rowCount    Number of rows to paint
+ *
+ * @return      Nothing.
+ */
+void AbstractTableView::paintRows(QPainter & wPainter, int x, int firstRow, int rowCount)
+{
+    int wFirstY = getHeaderHeight() + firstRow * getRowHeight();
 
-    x = scrollValue;
-    y = getHeaderHeight();
+    // Paints background
+    wPainter.fillRect(QRect(0, wFirstY, viewport()->width(), rowCount * getRowHeight()), QBrush(mBackgroundColor));
 
     // Iterate over all columns and cells
     QString wStr;
@@ -284,7 +390,8 @@ void AbstractTableView::paintEvent(QPaintEvent* event)
         int j = mColumnOrder[k];
         if(getColumnHidden(j))
             continue;
-        for(int i = 0; i < wViewableRowsCount; i++)
+        int y = wFirstY;
+        for(int i = firstRow; i < firstRow + rowCount; i++)
         {
             //  Paints cell contents
             if(i < mNbrOfLineToPrint)
@@ -313,10 +420,8 @@ void AbstractTableView::paintEvent(QPaintEvent* event)
             y += getRowHeight();
         }
 
-        y = getHeaderHeight();
         x += getColumnWidth(j);
     }
-    //emit repainted();
 }
 
 /************************************************************************************
@@ -1257,10 +1362,47 @@ void AbstractTableView::updateViewport()
 {
     MethodInvoker::invokeMethod([this]()
     {
+        // An explicit update request means the content may have changed in a
+        // way the cache cannot know about (selection, highlighting, ...)
+        mPaintCacheValid = false;
         viewport()->update();
     });
 }
 
+/**
+ * @brief       Repaints only the given band of table rows (absolute row indices,
+ *              both inclusive). When the paint cache is usable the rows are
+ *              re-rendered in place and only their viewport area is updated;
+ *              otherwise this degrades to a full updateViewport().
+ *
+ * @return      Nothing.
+ */
+void AbstractTableView::updateRows(dsint firstRow, dsint lastRow)
+{
+    MethodInvoker::invokeMethod([this, firstRow, lastRow]()
+    {
+        if(!mPaintCacheValid || mShouldReload || mPaintCacheOffset != mTableOffset || mPaintCacheScrollX != -horizontalScrollBar()->value())
+        {
+            mPaintCacheValid = false;
+            viewport()->update();
+            return;
+        }
+        auto viewableRowsCount = getViewableRowsCount();
+        auto first = firstRow - mTableOffset;
+        auto last = lastRow - mTableOffset + 1; //one guard row, the row graphics may bleed a pixel across cells
+        if(first < 0)
+            first = 0;
+        if(last > viewableRowsCount - 1)
+            last = viewableRowsCount - 1;
+        if(first >= viewableRowsCount || last < first)
+            return; //nothing visible to repaint
+        QPainter cachePainter(&mPaintCache);
+        cachePainter.setFont(font());
+        paintRows(cachePainter, mPaintCacheScrollX, int(first), int(last - first) + 1);
+        viewport()->update(0, getHeaderHeight() + int(first) * getRowHeight(), viewport()->width(), (int(last - first) + 1) * getRowHeight());
+    });
+}
+
 /**
  * @brief       This method is called when data have to be reloaded (e.g. When table offset changes).
  *
@@ -1335,3 +1477,13 @@ void AbstractTableView::hideEvent(QHideEvent* event)
     ShowDisassemblyPopup(0, 0, 0);
     QAbstractScrollArea::hideEvent(event);
 }
+
+void AbstractTableView::showEvent(QShowEvent* event)
+{
+    if(mColumnConfigPending)
+    {
+        mColumnConfigPending = false;
+        applyColumnConfig();
+    }
+    QAbstractScrollArea::showEvent(event);
+}
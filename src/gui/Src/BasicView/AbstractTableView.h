@@ -7,6 +7,7 @@
 #include <QApplication>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPixmap>
 #include <QMenu>
 #include "StringUtil.h"
 #include "Configuration.h"
@@ -68,6 +69,7 @@ public:
     void keyPressEvent(QKeyEvent* event) override;
     void leaveEvent(QEvent* event) override;
     void hideEvent(QHideEvent* event) override;
+    void showEvent(QShowEvent* event) override;
 
     // ScrollBar Management
     virtual dsint sliderMovedHook(int type, dsint value, dsint delta); // can be made protected
@@ -140,6 +142,7 @@ public slots:
     // Update/Reload/Refresh/Repaint
     virtual void reloadData();
     void updateViewport();
+    void updateRows(dsint firstRow, dsint lastRow);
 
     // ScrollBar Management
     void vertSliderActionSlot(int action);
@@ -217,6 +220,19 @@ private:
     static int mMouseWheelScrollDelta;
     ScrollBar64 mScrollBarAttributes;
 
+    // Viewport paint cache: the rendered rows are kept in a pixmap so a paint
+    // event only redraws what changed. Scrolling shifts the pixmap and renders
+    // the rows that came into view, a plain expose just blits it. Everything
+    // that changes the content invalidates the cache through updateViewport()
+    // or reloadData().
+    QPixmap mPaintCache;
+    dsint mPaintCacheOffset;
+    int mPaintCacheScrollX;
+    bool mPaintCacheValid;
+
+    void paintHeader(QPainter & painter, int x);
+    void paintRows(QPainter & painter, int x, int firstRow, int rowCount);
+
     int getColumnDisplayIndexFromX(int x);
     friend class ColumnReorderDialog;
 
@@ -228,6 +244,8 @@ protected:
     QColor mHeaderTextColor;
     QColor mSelectionColor;
     QString mViewName;
+    bool mColumnConfigPending = false; //stored column state not applied yet, done on first show
+    void applyColumnConfig();
 
     // Font metrics
     CachedFontMetrics* mFontMetrics;
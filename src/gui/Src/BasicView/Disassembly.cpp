@@ -181,7 +181,8 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
     dsint wRVA = mInstBuffer.at(rowOffset).rva;
     bool wIsSelected = isSelected(&mInstBuffer, rowOffset);
     dsint cur_addr = rvaToVa(mInstBuffer.at(rowOffset).rva);
-    auto traceCount = DbgFunctions()->GetTraceRecordHitCount(cur_addr);
+    duint traceIndex = duint(cur_addr) - mTraceHitBase;
+    auto traceCount = traceIndex < duint(mTraceHitCounts.size()) ? mTraceHitCounts.at(int(traceIndex)) : DbgFunctions()->GetTraceRecordHitCount(cur_addr);
 
     // Highlight if selected
     if(wIsSelected && traceCount)
@@ -213,7 +214,7 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
         char label[MAX_LABEL_SIZE] = "";
         QString addrText = getAddrText(cur_addr, label);
         BPXTYPE bpxtype = DbgGetBpxTypeAt(cur_addr);
-        bool isbookmark = DbgGetBookmarkAt(cur_addr);
+        bool isbookmark = annotationAt(rowOffset).bookmark;
         if(rvaToVa(mInstBuffer.at(rowOffset).rva) == mCipVa && !Bridge::getBridge()->mIsRunning && DbgMemFindBaseAddr(DbgValFromString("cip"), nullptr)) //cip + not running + valid cip
         {
             painter->fillRect(QRect(x, y, w, h), QBrush(mCipBackgroundColor));
@@ -395,8 +396,8 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
         const Instruction_t & instr = mInstBuffer.at(rowOffset);
         //draw functions
         Function_t funcType;
-        FUNCTYPE funcFirst = DbgGetFunctionTypeAt(cur_addr);
-        FUNCTYPE funcLast = DbgGetFunctionTypeAt(cur_addr + instr.length - 1);
+        FUNCTYPE funcFirst = annotationAt(rowOffset).functionFirst;
+        FUNCTYPE funcLast = annotationAt(rowOffset).functionLast;
         HANDLE_RANGE_TYPE(FUNC, funcFirst, funcLast);
         switch(funcFirst)
         {
@@ -445,7 +446,7 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
 
         //draw jump arrows
         Instruction_t::BranchType branchType = mInstBuffer.at(rowOffset).branchType;
-        int jumpsize = paintJumpsGraphic(painter, x + funcsize, y - 1, wRVA, branchType != Instruction_t::None && branchType != Instruction_t::Call); //jump line
+        int jumpsize = paintJumpsGraphic(painter, x + funcsize, y - 1, wRVA, branchType != Instruction_t::None && branchType != Instruction_t::Call, mInstBuffer.at(rowOffset).branchDestination); //jump line
 
         //draw bytes
         auto richBytes = getRichBytes(instr, wIsSelected);
@@ -506,8 +507,9 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
     {
         //draw arguments
         Function_t funcType;
-        ARGTYPE argFirst = DbgGetArgTypeAt(cur_addr);
-        ARGTYPE argLast = DbgGetArgTypeAt(cur_addr + mInstBuffer.at(rowOffset).length - 1);
+        const DBGANNOTATIONS & annotation = annotationAt(rowOffset);
+        ARGTYPE argFirst = annotation.argumentFirst;
+        ARGTYPE argLast = annotation.argumentLast;
         HANDLE_RANGE_TYPE(ARG, argFirst, argLast);
         switch(argFirst)
         {
@@ -531,8 +533,7 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
 
         QString comment;
         bool autoComment = false;
-        char label[MAX_LABEL_SIZE] = "";
-        if(GetCommentFormat(cur_addr, comment, &autoComment))
+        if(FormatComment(annotation.comment, comment, &autoComment))
         {
             QColor backgroundColor;
             if(autoComment)
@@ -554,9 +555,9 @@ QString Disassembly::paintContent(QPainter* painter, dsint rowBase, int rowOffse
             painter->drawText(QRect(x + argsize, y, width, h), Qt::AlignVCenter | Qt::AlignLeft, comment);
             argsize += width + 3;
         }
-        else if(DbgGetLabelAt(cur_addr, SEG_DEFAULT, label)) // label but no comment
+        else if(*annotation.label) // label but no comment
         {
-            QString labelText(label);
+            QString labelText(annotation.label);
             QColor backgroundColor;
             painter->setPen(mLabelColor);
             backgroundColor = mLabelBackgroundColor;
@@ -993,7 +994,7 @@ dsint Disassembly::sliderMovedHook(int type, dsint value, dsint delta)
  *
  * @return      Nothing.
  */
-int Disassembly::paintJumpsGraphic(QPainter* painter, int x, int y, dsint addr, bool isjmp)
+int Disassembly::paintJumpsGraphic(QPainter* painter, int x, int y, dsint addr, bool isjmp, duint curInstDestination)
 {
     dsint selHeadRVA = mSelection.fromIndex;
     dsint rva = addr;
@@ -1009,7 +1010,7 @@ int Disassembly::paintJumpsGraphic(QPainter* painter, int x, int y, dsint addr,
     if(branchType != Instruction_t::None && branchType != Instruction_t::Call)
     {
         dsint base = mMemPage->getBase();
-        dsint destVA = DbgGetBranchDestination(rvaToVa(selHeadRVA));
+        dsint destVA = instruction.branchDestination; //resolved at decode time
 
         if(destVA >= base && destVA < base + (dsint)mMemPage->getSize())
         {
@@ -1088,7 +1089,6 @@ int Disassembly::paintJumpsGraphic(QPainter* painter, int x, int y, dsint addr,
 
     if(isjmp)
     {
-        duint curInstDestination = DbgGetBranchDestination(curVa);
         if(curInstDestination == 0 || curVa == curInstDestination)
         {
             curInstDir = GJD_Nothing;
@@ -1603,7 +1603,7 @@ bool Disassembly::isSelected(dsint base, dsint offset)
         return false;
 }
 
-bool Disassembly::isSelected(QList<Instruction_t>* buffer, int index) const
+bool Disassembly::isSelected(QVector<Instruction_t>* buffer, int index) const
 {
     if(buffer->size() > 0 && index >= 0 && index < buffer->size())
     {
@@ -1629,15 +1629,12 @@ duint Disassembly::getSelectedVa() const
                          Update/Reload/Refresh/Repaint
 ************************************************************************************/
 
-void Disassembly::prepareDataCount(const QList<dsint> & wRVAs, QList<Instruction_t>* instBuffer)
+void Disassembly::prepareDataCount(const QList<dsint> & wRVAs, QVector<Instruction_t>* instBuffer)
 {
     instBuffer->clear();
-    Instruction_t wInst;
+    instBuffer->reserve(wRVAs.count());
     for(int wI = 0; wI < wRVAs.count(); wI++)
-    {
-        wInst = DisassembleAt(wRVAs.at(wI));
-        instBuffer->append(wInst);
-    }
+        instBuffer->append(DisassembleAt(wRVAs.at(wI)));
 }
 
 void Disassembly::prepareDataRange(dsint startRva, dsint endRva, const std::function<bool(int, const Instruction_t &)> & disassembled)
@@ -1758,11 +1755,47 @@ void Disassembly::prepareData()
         wAddr = getNextInstructionRVA(wAddr, 1);
         if(wAddr == wAddrPrev)
             break;
-        mInstBuffer.append(wInst);
+        mInstBuffer.append(std::move(wInst));
         wCount++;
     }
 
     setNbrOfLineToPrint(wCount);
+
+    // Fetch the trace record hit counts for the whole viewport in one call
+    // instead of one bridge round trip per painted cell
+    if(wCount > 0)
+    {
+        mTraceHitBase = rvaToVa(mInstBuffer.first().rva);
+        duint size = mInstBuffer.last().rva + mInstBuffer.last().length - mInstBuffer.first().rva;
+        mTraceHitCounts.resize(int(size));
+        DbgFunctions()->GetTraceRecordHitCounts(mTraceHitBase, size, mTraceHitCounts.data());
+    }
+    else
+        mTraceHitCounts.clear();
+
+    // Same idea for the row annotations (label/comment/bookmark/function/
+    // argument): one call for the whole viewport instead of several bridge
+    // round trips per painted row
+    mAnnotations.resize(wCount);
+    if(wCount > 0)
+    {
+        std::vector<duint> addresses(wCount);
+        std::vector<int> sizes(wCount);
+        for(int i = 0; i < wCount; i++)
+        {
+            addresses[i] = rvaToVa(mInstBuffer.at(i).rva);
+            sizes[i] = mInstBuffer.at(i).length;
+        }
+        DbgFunctions()->GetAnnotations(addresses.data(), sizes.data(), wCount, mAnnotations.data());
+    }
+}
+
+const DBGANNOTATIONS & Disassembly::annotationAt(int rowOffset) const
+{
+    static const DBGANNOTATIONS empty = {};
+    if(rowOffset < 0 || rowOffset >= mAnnotations.size())
+        return empty;
+    return mAnnotations.at(rowOffset);
 }
 
 void Disassembly::reloadData()
@@ -1911,7 +1944,7 @@ void Disassembly::disassembleAt(dsint parVA, bool history, dsint newTableOffset)
     */
 }
 
-QList<Instruction_t>* Disassembly::instructionsBuffer()
+QVector<Instruction_t>* Disassembly::instructionsBuffer()
 {
     return &mInstBuffer;
 }
@@ -2091,7 +2124,7 @@ void Disassembly::unfold(dsint rva)
     if(mCodeFoldingManager)
     {
         mCodeFoldingManager->expandFoldSegment(rvaToVa(rva));
-        viewport()->update();
+        updateViewport();
     }
 }
 
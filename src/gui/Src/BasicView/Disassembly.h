@@ -49,7 +49,7 @@ public:
     void selectNext(bool expand);
     void selectPrevious(bool expand);
     bool isSelected(dsint base, dsint offset);
-    bool isSelected(QList<Instruction_t>* buffer, int index) const;
+    bool isSelected(QVector<Instruction_t>* buffer, int index) const;
     duint getSelectedVa() const;
 
     // Update/Reload/Refresh/Repaint
@@ -74,11 +74,11 @@ public:
     void gotoAddress(duint addr);
     void disassembleAt(dsint parVA, bool history, dsint newTableOffset);
 
-    QList<Instruction_t>* instructionsBuffer(); // ugly
+    QVector<Instruction_t>* instructionsBuffer(); // ugly
     const dsint baseAddress() const;
 
     QString getAddrText(dsint cur_addr, char label[MAX_LABEL_SIZE], bool getLabel = true);
-    void prepareDataCount(const QList<dsint> & wRVAs, QList<Instruction_t>* instBuffer);
+    void prepareDataCount(const QList<dsint> & wRVAs, QVector<Instruction_t>* instBuffer);
     void prepareDataRange(dsint startRva, dsint endRva, const std::function<bool(int, const Instruction_t &)> & disassembled);
     RichTextPainter::List getRichBytes(const Instruction_t & instr, bool isSelected) const;
 
@@ -142,7 +142,15 @@ private:
 
     duint mCipVa = 0;
 
-    QList<Instruction_t> mInstBuffer;
+    // QVector so instructions can be moved in instead of copied into
+    // QList's per-element heap nodes
+    QVector<Instruction_t> mInstBuffer;
+
+    QVector<unsigned int> mTraceHitCounts; //per-byte trace record hit counts for the viewport
+    duint mTraceHitBase = 0;
+
+    QVector<DBGANNOTATIONS> mAnnotations; //per-row annotations for the viewport, parallel to mInstBuffer
+    const DBGANNOTATIONS & annotationAt(int rowOffset) const;
 
     struct HistoryData
     {
@@ -155,7 +163,7 @@ private:
 
 protected:
     // Jumps Graphic
-    int paintJumpsGraphic(QPainter* painter, int x, int y, dsint addr, bool isjmp);
+    int paintJumpsGraphic(QPainter* painter, int x, int y, dsint addr, bool isjmp, duint curInstDestination);
 
     // Function Graphic
 
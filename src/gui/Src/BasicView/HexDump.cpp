@@ -789,7 +789,8 @@ void HexDump::getColumnRichText(int col, dsint rva, RichTextPainter::List & rich
 
         wBufferByteCount = wBufferByteCount > (dsint)(mMemPage->getSize() - rva) ? mMemPage->getSize() - rva : wBufferByteCount;
 
-        byte_t* wData = new byte_t[wBufferByteCount];
+        mColumnData.resize(wBufferByteCount);
+        byte_t* wData = mColumnData.data();
         mMemPage->read(wData, rva, wBufferByteCount);
 
         if(desc.textCodec) //convert the row bytes to unicode
@@ -805,6 +806,7 @@ void HexDump::getColumnRichText(int col, dsint rva, RichTextPainter::List & rich
         }
         else
         {
+            int maxLen = getStringMaxLength(desc.data);
             for(wI = 0; wI < desc.itemCount && (rva + wI) < (dsint)mMemPage->getSize(); wI++)
             {
                 curData.text.clear();
@@ -812,7 +814,6 @@ void HexDump::getColumnRichText(int col, dsint rva, RichTextPainter::List & rich
                 curData.textBackground = Qt::transparent;
                 curData.flags = RichTextPainter::FlagAll;
 
-                int maxLen = getStringMaxLength(desc.data);
                 if((rva + wI + wByteCount - 1) < (dsint)mMemPage->getSize())
                 {
                     toString(desc.data, rva + wI * wByteCount, wData + wI * wByteCount, curData);
@@ -857,8 +858,6 @@ void HexDump::getColumnRichText(int col, dsint rva, RichTextPainter::List & rich
                 }
             }
         }
-
-        delete[] wData;
     }
 }
 
@@ -909,7 +908,7 @@ void HexDump::toString(DataDescriptor desc, duint rva, byte_t* data, RichTextPai
     dsint start = rvaToVa(rva);
     dsint end = start + getSizeOf(desc.itemSize) - 1;
     if(DbgFunctions()->PatchInRange(start, end))
-        richText.textColor = ConfigColor("HexDumpModifiedBytesColor");
+        richText.textColor = mModifiedBytesColor;
 }
 
 void HexDump::byteToString(duint rva, byte_t byte, ByteViewMode mode, RichTextPainter::CustomRichText_t & richText)
@@ -207,6 +207,7 @@ private:
     } mUpdateCache;
     std::vector<uint8_t> mUpdateCacheData;
     std::vector<uint8_t> mUpdateCacheTemp;
+    std::vector<byte_t> mColumnData; //scratch buffer for getColumnRichText, reused across cells
 
 protected:
     MemoryPage* mMemPage;
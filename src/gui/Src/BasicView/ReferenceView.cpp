@@ -184,6 +184,17 @@ void ReferenceView::setRowCount(dsint count)
     StdSearchListView::setRowCount(count);
 }
 
+void ReferenceView::addRowsRef(const REFROWBATCH* batch)
+{
+    //Append a whole block of rows in one call, the row count is only grown
+    //once for the batch instead of once per result row
+    int first = int(stdList()->getRowCount());
+    setRowCount(first + batch->count);
+    for(int i = 0; i < batch->count; i++)
+        for(int j = 0; j < batch->cols; j++)
+            setCellContent(first + i, j, QString::fromUtf8(batch->cells[i * batch->cols + j]));
+}
+
 void ReferenceView::setSingleSelection(int index, bool scroll)
 {
     clearFilter();
@@ -411,7 +422,7 @@ void ReferenceView::referenceExecCommand()
     if(act != nullptr)
     {
         QString command = act->data().toString();
-        for(int selected : mCurList->getSelection()) //to do: enable multi-selection
+        for(int selected = mCurList->getSelectionStart(); selected <= mCurList->getSelectionEnd(); selected++)
         {
             QString specializedCommand = command;
             for(int i = 0; i < mCurList->getColumnCount(); i++)
@@ -24,6 +24,7 @@ public slots:
     void addColumnAtRef(int width, QString title);
 
     void setRowCount(dsint count) override;
+    void addRowsRef(const REFROWBATCH* batch);
 
     void setSingleSelection(int index, bool scroll);
     void addCommand(QString title, QString command);
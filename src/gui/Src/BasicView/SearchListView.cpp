@@ -3,10 +3,180 @@
 #include <QSplitter>
 #include <QLabel>
 #include <QTimer>
+#include <algorithm>
 #include "SearchListView.h"
 #include "FlickerThread.h"
 #include "MethodInvoker.h"
 
+SearchListFilterThread::SearchListFilterThread(AbstractSearchList* abstractSearchList, QObject* parent)
+    : QThread(parent), mAbstractSearchList(abstractSearchList)
+{
+}
+
+void SearchListFilterThread::start()
+{
+    mStopThread = false;
+    QThread::start();
+}
+
+void SearchListFilterThread::stop()
+{
+    mStopThread = true;
+    mRequestChanged = true;
+}
+
+void SearchListFilterThread::request(const QString & filter, AbstractSearchList::FilterType type, int startColumn)
+{
+    mRequestMutex.lock();
+    mRequestFilter = filter;
+    mRequestType = type;
+    mRequestStartColumn = startColumn;
+    mRequestPending = true;
+    mRequestChanged = true;
+    mRequestMutex.unlock();
+}
+
+void SearchListFilterThread::cancel()
+{
+    mRequestMutex.lock();
+    mRequestPending = false;
+    mRequestChanged = true;
+    // Wait out an in-flight scan so no more results can arrive once this
+    // returns and the caller is free to mutate the source list
+    while(mScanning)
+        mIdleCondition.wait(&mRequestMutex);
+    mPendingClear = false;
+    mPendingRows.clear();
+    mRequestMutex.unlock();
+}
+
+void SearchListFilterThread::takePendingResults(bool & clearList, std::vector<int> & rows)
+{
+    mRequestMutex.lock();
+    clearList = mPendingClear;
+    mPendingClear = false;
+    rows = std::move(mPendingRows);
+    mPendingRows.clear();
+    mRequestMutex.unlock();
+}
+
+void SearchListFilterThread::invalidateBaseList()
+{
+    // The source list was repopulated, previous matches no longer narrow it
+    mBaseChanged = true;
+}
+
+void SearchListFilterThread::run()
+{
+    while(!mStopThread)
+    {
+        mRequestMutex.lock();
+        bool pending = mRequestPending;
+        QString filter = mRequestFilter;
+        auto type = mRequestType;
+        int startColumn = mRequestStartColumn;
+        mRequestPending = false;
+        if(pending)
+        {
+            mRequestChanged = false;
+            mScanning = true;
+            // Anything a superseded scan left behind is stale
+            mPendingClear = true;
+            mPendingRows.clear();
+        }
+        mRequestMutex.unlock();
+
+        if(!pending)
+        {
+            Sleep(10);
+            continue;
+        }
+
+        if(mBaseChanged)
+        {
+            mBaseChanged = false;
+            mLastValid = false;
+        }
+
+        mAbstractSearchList->lock();
+        int rows = int(mAbstractSearchList->list()->getRowCount());
+        mAbstractSearchList->unlock();
+
+        // A filter that contains the previous one can only narrow its result
+        // set, so scan the previous matches instead of every row. Regex
+        // matches are not monotonic in the pattern, no reuse there
+        bool narrow = false;
+        if(mLastValid && type == mLastType && startColumn == mLastStartColumn && rows == mLastRowCount)
+        {
+            switch(type)
+            {
+            case AbstractSearchList::FilterContainsTextCaseSensitive:
+                narrow = filter.contains(mLastFilter, Qt::CaseSensitive);
+                break;
+            case AbstractSearchList::FilterContainsTextCaseInsensitive:
+                narrow = filter.contains(mLastFilter, Qt::CaseInsensitive);
+                break;
+            default:
+                break;
+            }
+        }
+
+        const int chunkSize = 0x4000;
+        int total = narrow ? int(mLastMatches.size()) : rows;
+        std::vector<int> matches;
+        std::vector<int> chunkMatches;
+        bool aborted = false;
+        for(int chunkStart = 0; chunkStart < total; chunkStart += chunkSize)
+        {
+            // A newer filter request supersedes this scan
+            if(mStopThread || mRequestChanged)
+            {
+                aborted = true;
+                break;
+            }
+
+            auto chunkEnd = std::min(chunkStart + chunkSize, total);
+            chunkMatches.clear();
+            mAbstractSearchList->lock();
+            for(int i = chunkStart; i < chunkEnd; i++)
+            {
+                int row = narrow ? mLastMatches[i] : i;
+                if(mAbstractSearchList->rowMatchesFilter(filter, type, row, startColumn))
+                    chunkMatches.push_back(row);
+            }
+            mAbstractSearchList->unlock();
+
+            matches.insert(matches.end(), chunkMatches.begin(), chunkMatches.end());
+
+            // Publish the chunk, the GUI thread applies it to the search list
+            mRequestMutex.lock();
+            mPendingRows.insert(mPendingRows.end(), chunkMatches.begin(), chunkMatches.end());
+            mRequestMutex.unlock();
+            emit filterProgress();
+        }
+
+        if(!aborted)
+        {
+            mLastFilter = filter;
+            mLastType = type;
+            mLastStartColumn = startColumn;
+            mLastRowCount = rows;
+            mLastMatches = std::move(matches);
+            mLastValid = true;
+        }
+        else
+            mLastValid = false;
+
+        mRequestMutex.lock();
+        mScanning = false;
+        mIdleCondition.wakeAll();
+        mRequestMutex.unlock();
+
+        if(!aborted)
+            emit filterCompleted();
+    }
+}
+
 SearchListView::SearchListView(QWidget* parent, AbstractSearchList* abstractSearchList, bool enableRegex, bool enableLock)
     : QWidget(parent), mAbstractSearchList(abstractSearchList)
 {
@@ -107,6 +277,13 @@ SearchListView::SearchListView(QWidget* parent, AbstractSearchList* abstractSear
     mTypingTimer->setSingleShot(true);
     connect(mTypingTimer, SIGNAL(timeout()), this, SLOT(filterEntries()));
 
+    // Background filter worker, results arrive in chunks so big lists stay
+    // responsive while typing
+    mFilterThread = new SearchListFilterThread(abstractSearchList, this);
+    connect(mFilterThread, SIGNAL(filterProgress()), this, SLOT(filterProgressSlot()));
+    connect(mFilterThread, SIGNAL(filterCompleted()), this, SLOT(filterCompletedSlot()));
+    mFilterThread->start();
+
     // Slots
     connect(abstractSearchList->list(), SIGNAL(contextMenuSignal(QPoint)), this, SLOT(listContextMenu(QPoint)));
     connect(abstractSearchList->list(), SIGNAL(doubleClickedSignal()), this, SLOT(doubleClickedSlot()));
@@ -121,6 +298,12 @@ SearchListView::SearchListView(QWidget* parent, AbstractSearchList* abstractSear
     abstractSearchList->list()->setFocusProxy(mSearchBox);
 }
 
+SearchListView::~SearchListView()
+{
+    mFilterThread->stop();
+    mFilterThread->wait();
+}
+
 bool SearchListView::findTextInList(AbstractStdTable* list, QString text, int row, int startcol, bool startswith)
 {
     int count = list->getColumnCount();
@@ -157,13 +340,15 @@ void SearchListView::filterEntries()
     mAbstractSearchList->lock();
 
     // store the first selection value
-    QString mLastFirstColValue;
-    auto selList = mCurList->getSelection();
-    if(!selList.empty() && mCurList->isValidIndex(selList[0], 0))
-        mLastFirstColValue = mCurList->getCellContent(selList[0], 0);
+    mLastFirstColValue.clear();
+    auto firstSel = mCurList->getSelectionStart();
+    if(mCurList->isValidIndex(firstSel, 0))
+        mLastFirstColValue = mCurList->getCellContent(firstSel, 0);
 
     // get the correct previous list instance
-    auto mPrevList = mAbstractSearchList->list()->isVisible() ? mAbstractSearchList->list() : mAbstractSearchList->searchList();
+    mPrevList = mAbstractSearchList->list()->isVisible() ? mAbstractSearchList->list() : mAbstractSearchList->searchList();
+
+    mAbstractSearchList->unlock();
 
     if(mFilterText.length())
     {
@@ -175,7 +360,15 @@ void SearchListView::filterEntries()
 
         mCurList = mAbstractSearchList->searchList();
 
-        // filter the list
+        // Do not highlight with regex
+        // TODO: fully respect highlighting mode
+        if(mRegexCheckbox->checkState() == Qt::Unchecked)
+            mAbstractSearchList->searchList()->setHighlightText(mFilterText, mSearchStartCol);
+        else
+            mAbstractSearchList->searchList()->setHighlightText(QString());
+
+        // filter the list in the background, partial results arrive in
+        // filterProgressSlot and filterCompletedSlot finishes up
         auto filterType = AbstractSearchList::FilterContainsTextCaseInsensitive;
         switch(mRegexCheckbox->checkState())
         {
@@ -186,10 +379,12 @@ void SearchListView::filterEntries()
             filterType = AbstractSearchList::FilterRegexCaseSensitive;
             break;
         }
-        mAbstractSearchList->filter(mFilterText, filterType, mSearchStartCol);
+        mFilterThread->request(mFilterText, filterType, mSearchStartCol);
     }
     else
     {
+        mFilterThread->cancel();
+
         MethodInvoker::invokeMethod([this]()
         {
             mAbstractSearchList->searchList()->hide();
@@ -197,7 +392,46 @@ void SearchListView::filterEntries()
         });
 
         mCurList = mAbstractSearchList->list();
+        finalizeFilter();
     }
+}
+
+void SearchListView::applyPendingFilterResults()
+{
+    // The worker only publishes matched rows, the tables are mutated here on
+    // the GUI thread so a repaint never observes a half-updated row store
+    bool clearList = false;
+    std::vector<int> rows;
+    mFilterThread->takePendingResults(clearList, rows);
+    if(!clearList && rows.empty())
+        return;
+    mAbstractSearchList->lock();
+    if(clearList)
+        mAbstractSearchList->clearSearchList();
+    if(!rows.empty())
+        mAbstractSearchList->appendToSearchList(rows);
+    mAbstractSearchList->unlock();
+}
+
+void SearchListView::filterProgressSlot()
+{
+    // Show the partial result set while the scan is still running
+    applyPendingFilterResults();
+    mAbstractSearchList->searchList()->reloadData();
+}
+
+void SearchListView::filterCompletedSlot()
+{
+    applyPendingFilterResults();
+    // The filter was cleared while the scan was finishing up
+    if(!mFilterText.length())
+        return;
+    finalizeFilter();
+}
+
+void SearchListView::finalizeFilter()
+{
+    mAbstractSearchList->lock();
 
     // attempt to restore previous selection
     bool hasSetSingleSelection = false;
@@ -225,21 +459,13 @@ void SearchListView::filterEntries()
     if(!hasSetSingleSelection)
         mCurList->setSingleSelection(0);
 
-    if(!mCurList->getRowCount())
-        emit emptySearchResult();
-
-    // Do not highlight with regex
-    // TODO: fully respect highlighting mode
-    if(mRegexCheckbox->checkState() == Qt::Unchecked)
-        mAbstractSearchList->searchList()->setHighlightText(mFilterText, mSearchStartCol);
-    else
-        mAbstractSearchList->searchList()->setHighlightText(QString());
+    bool empty = !mCurList->getRowCount();
 
     // Reload the search list data
     mAbstractSearchList->searchList()->reloadData();
 
     // setup the same layout of the previous list control
-    if(mPrevList != mCurList)
+    if(mPrevList && mPrevList != mCurList)
     {
         int cols = mPrevList->getColumnCount();
         for(int i = 0; i < cols; i++)
@@ -251,6 +477,9 @@ void SearchListView::filterEntries()
     }
 
     mAbstractSearchList->unlock();
+
+    if(empty)
+        emit emptySearchResult();
 }
 
 void SearchListView::searchTextEdited(const QString & text)
@@ -274,6 +503,8 @@ void SearchListView::searchTextEdited(const QString & text)
 
 void SearchListView::refreshSearchList()
 {
+    // The source list may have been repopulated
+    mFilterThread->invalidateBaseList();
     filterEntries();
 }
 
@@ -4,16 +4,69 @@
 #include <QWidget>
 #include <QLineEdit>
 #include <QCheckBox>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
 #include "MenuBuilder.h"
 #include "ActionHelpers.h"
 #include "AbstractSearchList.h"
 
+// Scans the source list in chunks off the GUI thread and publishes the
+// matches for the GUI thread to apply, so partial results show up while
+// typing without the worker ever mutating a table the GUI is painting
+class SearchListFilterThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit SearchListFilterThread(AbstractSearchList* abstractSearchList, QObject* parent = nullptr);
+    void start();
+    void stop();
+    void request(const QString & filter, AbstractSearchList::FilterType type, int startColumn);
+    void cancel();
+    void invalidateBaseList();
+    void takePendingResults(bool & clearList, std::vector<int> & rows);
+
+signals:
+    void filterProgress();
+    void filterCompleted();
+
+private:
+    void run() override;
+
+    AbstractSearchList* mAbstractSearchList;
+    QMutex mRequestMutex;
+    QString mRequestFilter;
+    AbstractSearchList::FilterType mRequestType = AbstractSearchList::FilterContainsTextCaseInsensitive;
+    int mRequestStartColumn = 0;
+    bool mRequestPending = false;
+    volatile bool mRequestChanged = false;
+    volatile bool mBaseChanged = false;
+    volatile bool mStopThread = false;
+
+    // Matches found so far, applied to the search list by the GUI thread
+    // (guarded by mRequestMutex)
+    bool mPendingClear = false;
+    std::vector<int> mPendingRows;
+    bool mScanning = false;
+    QWaitCondition mIdleCondition;
+
+    // Last completed scan, used to narrow the next one (worker thread only)
+    QString mLastFilter;
+    AbstractSearchList::FilterType mLastType = AbstractSearchList::FilterContainsTextCaseInsensitive;
+    int mLastStartColumn = 0;
+    int mLastRowCount = -1;
+    std::vector<int> mLastMatches;
+    bool mLastValid = false;
+};
+
 class SearchListView : public QWidget, public ActionHelper<SearchListView>
 {
     Q_OBJECT
 
 public:
     explicit SearchListView(QWidget* parent, AbstractSearchList* abstractSearchList, bool enableRegex, bool enableLock);
+    ~SearchListView() override;
 
     AbstractStdTable* mCurList;
     int mSearchStartCol;
@@ -25,6 +78,8 @@ public:
 
 private slots:
     void filterEntries();
+    void filterProgressSlot();
+    void filterCompletedSlot();
     void searchTextEdited(const QString & text);
     void listContextMenu(const QPoint & pos);
     void doubleClickedSlot();
@@ -40,12 +95,18 @@ protected:
     bool eventFilter(QObject* obj, QEvent* event);
 
 private:
+    void applyPendingFilterResults();
+    void finalizeFilter();
+
     QLineEdit* mSearchBox;
     QCheckBox* mRegexCheckbox;
     QCheckBox* mLockCheckbox;
     QAction* mSearchAction;
     QTimer* mTypingTimer;
     QString mFilterText;
+    QString mLastFirstColValue;
+    AbstractStdTable* mPrevList = nullptr;
+    SearchListFilterThread* mFilterThread;
 
     AbstractSearchList* mAbstractSearchList;
 };
@@ -39,26 +39,18 @@ void StdIconTable::setRowCount(dsint count)
 
 void StdIconTable::sortRows(int column, bool ascending)
 {
-    auto sortFn = mColumnSortFunctions.at(column);
-    std::vector<size_t> index;
-    index.resize(mData.size());
-    size_t i;
-    for(i = 0; i < mData.size(); i++)
+    auto index = sortPermutation(column, ascending);
+    std::vector<std::vector<CellData>> sortedData;
+    std::vector<QIcon> sortedIcons;
+    sortedData.reserve(mData.size());
+    sortedIcons.reserve(mIcon.size());
+    for(auto i : index)
     {
-        index[i] = i;
-    }
-    std::stable_sort(index.begin(), index.end(), [column, ascending, this, &sortFn](const size_t & a, const size_t & b)
-    {
-        auto less = sortFn(mData.at(a).at(column).text, mData.at(b).at(column).text);
-        return ascending ? less : !less;
-    });
-    auto copy1 = mData;
-    auto copy2 = mIcon;
-    for(i = 0; i < mData.size(); i++)
-    {
-        mData[i] = std::move(copy1[index[i]]);
-        mIcon[i] = std::move(copy2[index[i]]);
+        sortedData.push_back(std::move(mData[i]));
+        sortedIcons.push_back(std::move(mIcon[i]));
     }
+    mData = std::move(sortedData);
+    mIcon = std::move(sortedIcons);
 }
 
 QString StdIconTable::paintContent(QPainter* painter, dsint rowBase, int rowOffset, int col, int x, int y, int w, int h)
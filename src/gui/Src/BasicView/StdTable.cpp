@@ -1,5 +1,6 @@
 #include "StdTable.h"
 #include "Bridge.h"
+#include <ppl.h>
 
 StdTable::StdTable(QWidget* parent) : AbstractStdTable(parent)
 {
@@ -114,12 +115,58 @@ bool StdTable::isValidIndex(int r, int c)
     return c < int(mData.at(r).size());
 }
 
-void StdTable::sortRows(int column, bool ascending)
+// Computes the sorted row order without moving any rows. The built-in
+// numeric comparators are recognized and their sort keys pre-parsed once,
+// instead of re-parsing both cell texts on every comparison, and the
+// actual sorting runs on all cores. Ties keep the original row order.
+std::vector<size_t> StdTable::sortPermutation(int column, bool ascending)
 {
-    auto sortFn = mColumnSortFunctions.at(column);
-    std::stable_sort(mData.begin(), mData.end(), [column, ascending, &sortFn](const std::vector<CellData> & a, const std::vector<CellData> & b)
+    const auto & sortFn = mColumnSortFunctions.at(column);
+    std::vector<size_t> index(mData.size());
+    for(size_t i = 0; i < index.size(); i++)
+        index[i] = i;
+
+    typedef bool(*BuiltinFn)(const QString &, const QString &);
+    auto builtin = sortFn.target<BuiltinFn>();
+    auto isInt = builtin && *builtin == &SortBy::AsInt;
+    auto isHex = builtin && *builtin == &SortBy::AsHex;
+    if(isInt || isHex)
+    {
+        std::vector<long long> keys(mData.size());
+        concurrency::parallel_for(size_t(0), keys.size(), [&](size_t i)
+        {
+            const auto & text = mData.at(i).at(column).text;
+            keys[i] = isHex ? text.toLongLong(nullptr, 16) : text.toLongLong();
+        });
+        concurrency::parallel_sort(index.begin(), index.end(), [&keys, ascending](size_t a, size_t b)
+        {
+            if(keys[a] != keys[b])
+                return ascending ? keys[a] < keys[b] : keys[a] > keys[b];
+            return a < b;
+        });
+    }
+    else
     {
-        auto less = sortFn(a.at(column).text, b.at(column).text);
-        return ascending ? less : !less;
-    });
+        concurrency::parallel_sort(index.begin(), index.end(), [this, column, ascending, &sortFn](size_t a, size_t b)
+        {
+            const auto & ta = mData.at(a).at(column).text;
+            const auto & tb = mData.at(b).at(column).text;
+            if(sortFn(ta, tb))
+                return ascending;
+            if(sortFn(tb, ta))
+                return !ascending;
+            return a < b;
+        });
+    }
+    return index;
+}
+
+void StdTable::sortRows(int column, bool ascending)
+{
+    auto index = sortPermutation(column, ascending);
+    std::vector<std::vector<CellData>> sorted;
+    sorted.reserve(mData.size());
+    for(auto i : index)
+        sorted.push_back(std::move(mData[i]));
+    mData = std::move(sorted);
 }
@@ -38,6 +38,8 @@ protected:
 
     std::vector<std::vector<CellData>> mData; //listof(row) where row = (listof(col) where col = CellData)
     std::vector<SortBy::t> mColumnSortFunctions;
+
+    std::vector<size_t> sortPermutation(int column, bool ascending);
 };
 
 #endif // STDTABLE_H
@@ -1,26 +1,27 @@
 #include "StdTableSearchList.h"
 #include "StdIconTable.h"
 
-void StdTableSearchList::filter(const QString & filter, FilterType type, int startColumn)
+void StdTableSearchList::clearSearchList()
+{
+    mSearchList->setRowCount(0);
+}
+
+void StdTableSearchList::appendToSearchList(const std::vector<int> & rows)
 {
     StdIconTable* mSearchIconList = qobject_cast<StdIconTable*>(mSearchList);
     StdIconTable* mIconList = qobject_cast<StdIconTable*>(mList);
-    mSearchList->setRowCount(0);
-    int rows = mList->getRowCount();
     int columns = mList->getColumnCount();
-    for(int i = 0, j = 0; i < rows; i++)
+    int j = int(mSearchList->getRowCount());
+    mSearchList->setRowCount(j + rows.size());
+    for(int row : rows)
     {
-        if(rowMatchesFilter(filter, type, i, startColumn))
+        for(int k = 0; k < columns; k++)
         {
-            mSearchList->setRowCount(j + 1);
-            for(int k = 0; k < columns; k++)
-            {
-                mSearchList->setCellContent(j, k, mList->getCellContent(i, k));
-                mSearchList->setCellUserdata(j, k, mList->getCellUserdata(i, k));
-            }
-            if(mSearchIconList && mIconList)
-                mSearchIconList->setRowIcon(j, mIconList->getRowIcon(i));
-            j++;
+            mSearchList->setCellContent(j, k, mList->getCellContent(row, k));
+            mSearchList->setCellUserdata(j, k, mList->getCellUserdata(row, k));
         }
+        if(mSearchIconList && mIconList)
+            mSearchIconList->setRowIcon(j, mIconList->getRowIcon(row));
+        j++;
     }
 }
@@ -2,6 +2,7 @@
 
 #include "AbstractSearchList.h"
 #include "StdTable.h"
+#include <QMutex>
 
 class StdTableSearchList : public AbstractSearchList
 {
@@ -9,17 +10,19 @@ public:
     friend class StdSearchListView;
 
     StdTableSearchList() : StdTableSearchList(new StdTable(), new StdTable()) { }
-    StdTableSearchList(StdTable* list, StdTable* searchList) : mList(list), mSearchList(searchList) { }
+    StdTableSearchList(StdTable* list, StdTable* searchList) : mList(list), mSearchList(searchList), mMutex(QMutex::Recursive) { }
     ~StdTableSearchList() { delete mList; delete mSearchList; }
 
-    void lock() override { }
-    void unlock() override { }
+    void lock() override { mMutex.lock(); }
+    void unlock() override { mMutex.unlock(); }
     AbstractStdTable* list() const override { return mList; }
     AbstractStdTable* searchList() const override { return mSearchList; }
 
-    void filter(const QString & filter, FilterType type, int startColumn) override;
+    void clearSearchList() override;
+    void appendToSearchList(const std::vector<int> & rows) override;
 
 private:
     StdTable* mList;
     StdTable* mSearchList;
+    QMutex mMutex;
 };
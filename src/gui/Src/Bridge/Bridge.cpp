@@ -1,5 +1,6 @@
 #include "Bridge.h"
 #include <QClipboard>
+#include <QTimer>
 #include "QBeaEngine.h"
 #include "main.h"
 #include "Exports.h"
@@ -88,6 +89,104 @@ void Bridge::setDbgStopped()
     dbgStopped = true;
 }
 
+/************************************************************************************
+                            Update coalescing
+************************************************************************************/
+
+// During animate and trace-into every step funnels a full view update through
+// the bridge, far faster than the views can repaint. The first update in a
+// frame is emitted directly; later ones only mark the view dirty and store the
+// latest parameters, and a single queued flush repaints that state once the
+// frame budget expires. A pause flushes the pending state right away, so the
+// final update on stop is never dropped.
+//
+// This effectively splits the bridge messages into classes: view updates are
+// latest-wins, log lines are batched (see GUI_ADD_MSG_TO_LOG), and dialogs or
+// queries keep their ordered synchronous path through BridgeResult.
+void Bridge::scheduleUpdate(unsigned int update)
+{
+    EnterCriticalSection(&csBridge);
+    mCoalescePending |= update;
+    bool flushNow = !mFlushScheduled && GetTickCount() - mLastUpdateFlush >= CoalesceFrameBudget;
+    if(flushNow)
+        mLastUpdateFlush = GetTickCount();
+    else if(!mFlushScheduled)
+    {
+        mFlushScheduled = true;
+        QMetaObject::invokeMethod(this, "coalescedUpdateFlush", Qt::QueuedConnection);
+    }
+    LeaveCriticalSection(&csBridge);
+    if(flushNow)
+        emitPendingUpdates();
+}
+
+void Bridge::emitPendingUpdates()
+{
+    EnterCriticalSection(&csBridge);
+    auto pending = mCoalescePending;
+    mCoalescePending = 0;
+    auto disasmVa = mCoalesceDisasmVa;
+    auto disasmCip = mCoalesceDisasmCip;
+    auto stackVa = mCoalesceStackVa;
+    auto stackCsp = mCoalesceStackCsp;
+    QByteArray logBuffer;
+    if(pending & CoalesceLog)
+        logBuffer.swap(mCoalesceLogBuffer);
+    LeaveCriticalSection(&csBridge);
+
+    if(!logBuffer.isEmpty())
+    {
+        logBuffer.append('\0'); //consumers expect a terminated buffer
+        emit addMsgToLog(logBuffer);
+    }
+    if(pending & CoalesceDisasmAt)
+        emit disassembleAt(disasmVa, disasmCip);
+    if(pending & CoalesceRegisters)
+        emit updateRegisters();
+    if(pending & CoalesceDisassembly)
+        emit updateDisassembly();
+    if(pending & CoalesceDump)
+        emit updateDump();
+    if(pending & CoalesceStackDump)
+        emit stackDumpAt(stackVa, stackCsp);
+    if(pending & CoalesceThreads)
+        emit updateThreads();
+    if(pending & CoalesceSideBar)
+        emit updateSideBar();
+    if(pending & CoalesceBreakpoints)
+        emit updateBreakpoints();
+    if(pending & CoalesceMemory)
+        emit updateMemory();
+    if(pending & CoalescePatches)
+        emit updatePatches();
+    if(pending & CoalesceCallStack)
+        emit updateCallStack();
+    if(pending & CoalesceSEHChain)
+        emit updateSEHChain();
+    if(pending & CoalesceArgumentView)
+        emit updateArgumentView();
+    if(pending & CoalesceWatch)
+        emit updateWatch();
+    if(pending & CoalesceTraceBrowser)
+        emit updateTraceBrowser();
+}
+
+void Bridge::coalescedUpdateFlush()
+{
+    //runs on the main thread
+    auto elapsed = GetTickCount() - mLastUpdateFlush;
+    if(elapsed < CoalesceFrameBudget)
+    {
+        QTimer::singleShot(CoalesceFrameBudget - elapsed, this, SLOT(coalescedUpdateFlush()));
+        return;
+    }
+    EnterCriticalSection(&csBridge);
+    mFlushScheduled = false;
+    mLastUpdateFlush = GetTickCount();
+    LeaveCriticalSection(&csBridge);
+    emitPendingUpdates();
+}
+
 /************************************************************************************
                             Message processing
 ************************************************************************************/
@@ -100,36 +199,53 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
     {
     case GUI_DISASSEMBLE_AT:
         mLastCip = (duint)param2;
-        emit disassembleAt((dsint)param1, (dsint)param2);
+        EnterCriticalSection(&csBridge);
+        mCoalesceDisasmVa = (dsint)param1;
+        mCoalesceDisasmCip = (dsint)param2;
+        LeaveCriticalSection(&csBridge);
+        scheduleUpdate(CoalesceDisasmAt);
         break;
 
     case GUI_SET_DEBUG_STATE:
+        QBeaEngine::ClearDecodeCache(); //branch destinations depend on the debuggee state
         mIsRunning = DBGSTATE(duint(param1)) == running;
+        if(!mIsRunning)
+            emitPendingUpdates(); //show the final state right away when the debugger pauses or stops
         if(!param2)
             emit dbgStateChanged((DBGSTATE)(dsint)param1);
         break;
 
     case GUI_ADD_MSG_TO_LOG:
     {
+        // The log consumers are append-only, so a storm of log lines is
+        // buffered and flushed as a single batch per frame instead of one
+        // queued event per line and receiver blocking the debug thread
         auto msg = (const char*)param1;
-        emit addMsgToLog(QByteArray(msg, int(strlen(msg)) + 1)); //Speed up performance: don't convert to UCS-2 QString
+        EnterCriticalSection(&csBridge);
+        mCoalesceLogBuffer.append(msg, int(strlen(msg))); //Speed up performance: don't convert to UCS-2 QString
+        LeaveCriticalSection(&csBridge);
+        scheduleUpdate(CoalesceLog);
     }
     break;
 
     case GUI_CLEAR_LOG:
+        EnterCriticalSection(&csBridge);
+        mCoalesceLogBuffer.clear(); //buffered lines would have been wiped by this clear anyway
+        LeaveCriticalSection(&csBridge);
         emit clearLog();
         break;
 
     case GUI_UPDATE_REGISTER_VIEW:
-        emit updateRegisters();
+        scheduleUpdate(CoalesceRegisters);
         break;
 
     case GUI_UPDATE_DISASSEMBLY_VIEW:
-        emit updateDisassembly();
+        QBeaEngine::ClearDecodeCache();
+        scheduleUpdate(CoalesceDisassembly);
         break;
 
     case GUI_UPDATE_BREAKPOINTS_VIEW:
-        emit updateBreakpoints();
+        scheduleUpdate(CoalesceBreakpoints);
         break;
 
     case GUI_UPDATE_WINDOW_TITLE:
@@ -245,6 +361,14 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
     }
     break;
 
+    case GUI_REF_ADDROWS:
+    {
+        REFROWBATCH* batch = (REFROWBATCH*)param1;
+        if(referenceManager->currentReferenceView())
+            referenceManager->currentReferenceView()->addRowsRef(batch);
+    }
+    break;
+
     case GUI_REF_GETCELLCONTENT:
     {
         QString content;
@@ -307,19 +431,23 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
     break;
 
     case GUI_STACK_DUMP_AT:
-        emit stackDumpAt((duint)param1, (duint)param2);
+        EnterCriticalSection(&csBridge);
+        mCoalesceStackVa = (duint)param1;
+        mCoalesceStackCsp = (duint)param2;
+        LeaveCriticalSection(&csBridge);
+        scheduleUpdate(CoalesceStackDump);
         break;
 
     case GUI_UPDATE_DUMP_VIEW:
-        emit updateDump();
+        scheduleUpdate(CoalesceDump);
         break;
 
     case GUI_UPDATE_THREAD_VIEW:
-        emit updateThreads();
+        scheduleUpdate(CoalesceThreads);
         break;
 
     case GUI_UPDATE_MEMORY_VIEW:
-        emit updateMemory();
+        scheduleUpdate(CoalesceMemory);
         break;
 
     case GUI_ADD_RECENT_FILE:
@@ -486,7 +614,7 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
         break;
 
     case GUI_UPDATE_SIDEBAR:
-        emit updateSideBar();
+        scheduleUpdate(CoalesceSideBar);
         break;
 
     case GUI_REPAINT_TABLE_VIEW:
@@ -494,15 +622,16 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
         break;
 
     case GUI_UPDATE_PATCHES:
-        emit updatePatches();
+        QBeaEngine::ClearDecodeCache();
+        scheduleUpdate(CoalescePatches);
         break;
 
     case GUI_UPDATE_CALLSTACK:
-        emit updateCallStack();
+        scheduleUpdate(CoalesceCallStack);
         break;
 
     case GUI_UPDATE_SEHCHAIN:
-        emit updateSEHChain();
+        scheduleUpdate(CoalesceSEHChain);
         break;
 
     case GUI_SYMBOL_REFRESH_CURRENT:
@@ -673,7 +802,7 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
         break;
 
     case GUI_UPDATE_ARGUMENT_VIEW:
-        emit updateArgumentView();
+        scheduleUpdate(CoalesceArgumentView);
         break;
 
     case GUI_FOCUS_VIEW:
@@ -703,7 +832,7 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
     break;
 
     case GUI_UPDATE_WATCH_VIEW:
-        emit updateWatch();
+        scheduleUpdate(CoalesceWatch);
         break;
 
     case GUI_LOAD_GRAPH:
@@ -861,7 +990,7 @@ void* Bridge::processMessage(GUIMSG type, void* param1, void* param2)
     break;
 
     case GUI_UPDATE_TRACE_BROWSER:
-        emit updateTraceBrowser();
+        scheduleUpdate(CoalesceTraceBrowser);
         break;
 
     case GUI_INVALIDATE_SYMBOL_SOURCE:
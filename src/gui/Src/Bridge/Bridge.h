@@ -164,12 +164,50 @@ signals:
     void getCurrentGraph(BridgeCFGraphList* graphList);
     void showReferences();
 
+private slots:
+    void coalescedUpdateFlush();
+
 private:
+    // Repaint-heavy view updates that are coalesced to the frame budget
+    // while the debugger steps faster than the views can paint
+    enum CoalescedUpdate : unsigned int
+    {
+        CoalesceDisasmAt = 1 << 0,
+        CoalesceRegisters = 1 << 1,
+        CoalesceDisassembly = 1 << 2,
+        CoalesceDump = 1 << 3,
+        CoalesceStackDump = 1 << 4,
+        CoalesceThreads = 1 << 5,
+        CoalesceSideBar = 1 << 6,
+        CoalesceLog = 1 << 7,
+        CoalesceBreakpoints = 1 << 8,
+        CoalesceMemory = 1 << 9,
+        CoalescePatches = 1 << 10,
+        CoalesceCallStack = 1 << 11,
+        CoalesceSEHChain = 1 << 12,
+        CoalesceArgumentView = 1 << 13,
+        CoalesceWatch = 1 << 14,
+        CoalesceTraceBrowser = 1 << 15
+    };
+
+    void scheduleUpdate(unsigned int update);
+    void emitPendingUpdates();
+
     CRITICAL_SECTION csBridge;
     HANDLE resultEvents[BridgeResult::Last];
     duint bridgeResults[BridgeResult::Last];
     DWORD dwMainThreadId = 0;
     volatile bool dbgStopped = false;
+
+    static const DWORD CoalesceFrameBudget = 33; //~30Hz
+    unsigned int mCoalescePending = 0;
+    bool mFlushScheduled = false;
+    DWORD mLastUpdateFlush = 0;
+    dsint mCoalesceDisasmVa = 0;
+    dsint mCoalesceDisasmCip = 0;
+    duint mCoalesceStackVa = 0;
+    duint mCoalesceStackCsp = 0;
+    QByteArray mCoalesceLogBuffer;
 };
 
 #endif // BRIDGE_H
@@ -2,6 +2,139 @@
 #include "StringUtil.h"
 #include "EncodeMap.h"
 #include "CodeFolding.h"
+#include <QCache>
+#include <QMutex>
+#include <unordered_map>
+
+// Decoded instruction cache shared between all QBeaEngine instances (CPU
+// view, graph, popup). Re-running the Zydis decode and tokenization for
+// every visible row on every repaint dominates the scrolling cost, while
+// the result only depends on the address and the instruction bytes. The
+// byte hash in the key makes patched bytes miss naturally; the cache is
+// cleared on debug state changes and patch notifications (see Bridge.cpp)
+// because branch destinations can depend on register and memory state.
+struct DecodedInstKey
+{
+    duint va;
+    uint byteHash;
+
+    bool operator==(const DecodedInstKey & other) const
+    {
+        return va == other.va && byteHash == other.byteHash;
+    }
+};
+
+static uint qHash(const DecodedInstKey & key, uint seed = 0)
+{
+    return ::qHash(quint64(key.va), seed ^ key.byteHash);
+}
+
+static QMutex decodeCacheMutex;
+static QCache<DecodedInstKey, Instruction_t> decodeCache(4096);
+
+static bool decodeCacheLookup(const DecodedInstKey & key, duint rva, const byte_t* data, duint size, Instruction_t & out)
+{
+    QMutexLocker lock(&decodeCacheMutex);
+    auto cached = decodeCache.object(key);
+    // Verify the bytes on a hit to defend against hash collisions
+    if(cached && cached->rva == rva && duint(cached->dump.size()) <= size &&
+            memcmp(data, cached->dump.constData(), cached->dump.size()) == 0)
+    {
+        out = *cached;
+        return true;
+    }
+    return false;
+}
+
+static void decodeCacheStore(const DecodedInstKey & key, const Instruction_t & inst)
+{
+    QMutexLocker lock(&decodeCacheMutex);
+    decodeCache.insert(key, new Instruction_t(inst));
+}
+
+// Anchor table of verified instruction starts, shared between all engine
+// instances. Every forward walk (DisassembleNext and the forward
+// resynchronization inside DisassembleBack) records the start and the byte
+// coverage of each decoded instruction in per-page bitmaps. When scrolling
+// back up through bytes that were walked before, DisassembleBack can then
+// binary-search nothing at all: it steps back over recorded starts and skips
+// the far-back re-decode entirely. Invalidation is shared with the decode
+// cache (debug state, patches and encode type changes all clear both).
+struct AnchorPage
+{
+    uint8_t start[4096 / 8] {};
+    uint8_t covered[4096 / 8] {};
+};
+
+static QMutex anchorMutex;
+static std::unordered_map<duint, AnchorPage> anchorPages;
+
+static bool anchorTestBit(const uint8_t* bits, uint index)
+{
+    return (bits[index >> 3] >> (index & 7)) & 1;
+}
+
+static void anchorSetBit(uint8_t* bits, uint index)
+{
+    bits[index >> 3] |= 1 << (index & 7);
+}
+
+static void anchorRecord(duint va, duint size)
+{
+    if(!size || size > MAX_DISASM_BUFFER)
+        return;
+    QMutexLocker lock(&anchorMutex);
+    // Crude memory bound (~4MB of bitmaps), refilled by the next walks
+    if(anchorPages.size() >= 4096 && anchorPages.find(va >> 12) == anchorPages.end())
+        anchorPages.clear();
+    anchorSetBit(anchorPages[va >> 12].start, uint(va & 0xfff));
+    for(duint b = va; b < va + size; b++)
+        anchorSetBit(anchorPages[b >> 12].covered, uint(b & 0xfff));
+}
+
+// Walk n verified instruction starts back from va. Only succeeds when every
+// byte on the way was covered by an earlier forward decode, so the result is
+// exactly what re-decoding forward from a far-back address would produce.
+static bool anchorPrevious(duint va, int n, duint & result)
+{
+    QMutexLocker lock(&anchorMutex);
+    auto pageOf = [](duint address) -> const AnchorPage*
+    {
+        auto found = anchorPages.find(address >> 12);
+        return found == anchorPages.end() ? nullptr : &found->second;
+    };
+    auto page = pageOf(va);
+    if(!page || !anchorTestBit(page->start, uint(va & 0xfff)))
+        return false;
+    duint cur = va;
+    for(int i = 0; i < n; i++)
+    {
+        duint b = cur;
+        do
+        {
+            if(b == 0 || cur - b >= MAX_DISASM_BUFFER)
+                return false;
+            b--;
+            page = pageOf(b);
+            if(!page || !anchorTestBit(page->covered, uint(b & 0xfff)))
+                return false;
+        }
+        while(!anchorTestBit(page->start, uint(b & 0xfff)));
+        cur = b;
+    }
+    result = cur;
+    return true;
+}
+
+void QBeaEngine::ClearDecodeCache()
+{
+    {
+        QMutexLocker lock(&decodeCacheMutex);
+        decodeCache.clear();
+    }
+    QMutexLocker lock(&anchorMutex);
+    anchorPages.clear();
+}
 
 QBeaEngine::QBeaEngine(int maxModuleSize)
     : _tokenizer(maxModuleSize), mCodeFoldingManager(nullptr), _bLongDataInst(false)
@@ -64,6 +197,15 @@ ulong QBeaEngine::DisassembleBack(const byte_t* data, duint base, duint size, du
     if(ip < back)
         back = ip;
 
+    // Serve the query from the anchor table when the backward range was fully
+    // covered by earlier forward decodes (typical when scrolling back up)
+    if(!mCodeFoldingManager || mCodeFoldingManager->getFoldedSize(base + ip - back, base + ip) == 0)
+    {
+        duint prev = 0;
+        if(anchorPrevious(base + ip, n, prev) && prev >= base)
+            return ulong(prev - base);
+    }
+
     addr = ip - back;
     if(mCodeFoldingManager && mCodeFoldingManager->isFolded(addr + base))
     {
@@ -95,7 +237,7 @@ ulong QBeaEngine::DisassembleBack(const byte_t* data, duint base, duint size, du
                 cmdsize = cp.Size();
 
             cmdsize = mEncodeMap->getDataSize(base + addr, cmdsize);
-
+            anchorRecord(base + addr, cmdsize);
         }
 
 
@@ -160,7 +302,7 @@ ulong QBeaEngine::DisassembleNext(const byte_t* data, duint base, duint size, du
                 cmdsize = cp.Size();
 
             cmdsize = mEncodeMap->getDataSize(base + ip, cmdsize);
-
+            anchorRecord(base + ip, cmdsize);
         }
 
         pdata += cmdsize;
@@ -189,6 +331,19 @@ Instruction_t QBeaEngine::DisassembleAt(const byte_t* data, duint size, duint or
         if(!mEncodeMap->isCode(type))
             return DecodeDataAt(data, size, origBase, origInstRVA, type);
     }
+
+    // Folded instructions get a synthetic length, so they bypass the cache
+    bool cacheable = !(mCodeFoldingManager && mCodeFoldingManager->isFolded(origInstRVA));
+    DecodedInstKey cacheKey;
+    if(cacheable)
+    {
+        cacheKey.va = origBase + origInstRVA;
+        cacheKey.byteHash = qHashBits(data, std::min(size, duint(MAX_DISASM_BUFFER)));
+        Instruction_t cachedInst;
+        if(decodeCacheLookup(cacheKey, origInstRVA, data, size, cachedInst))
+            return cachedInst;
+    }
+
     //tokenize
     ZydisTokenizer::InstructionToken cap;
     _tokenizer.Tokenize(origBase + origInstRVA, data, size, cap);
@@ -221,13 +376,17 @@ Instruction_t QBeaEngine::DisassembleAt(const byte_t* data, duint size, duint or
     else
         wInst.length = len;
     wInst.branchType = branchType;
-    wInst.tokens = cap;
+    wInst.tokens = std::move(cap);
     cp.BytesGroup(&wInst.prefixSize, &wInst.opcodeSize, &wInst.group1Size, &wInst.group2Size, &wInst.group3Size);
     for(uint8_t i = 0; i < _countof(wInst.vectorElementType); ++i)
         wInst.vectorElementType[i] = cp.getVectorElementType(i);
 
     if(!success)
+    {
+        if(cacheable)
+            decodeCacheStore(cacheKey, wInst);
         return wInst;
+    }
 
     auto instr = cp.GetInstr();
     cp.RegInfo(reginfo);
@@ -308,6 +467,9 @@ Instruction_t QBeaEngine::DisassembleAt(const byte_t* data, duint size, duint or
 #undef info
     }
 
+    if(cacheable)
+        decodeCacheStore(cacheKey, wInst);
+
     return wInst;
 }
 
@@ -337,7 +499,7 @@ Instruction_t QBeaEngine::DecodeDataAt(const byte_t* data, duint size, duint ori
     wInst.length = len;
     wInst.branchType = Instruction_t::None;
     wInst.branchDestination = 0;
-    wInst.tokens = cap;
+    wInst.tokens = std::move(cap);
     wInst.prefixSize = 0;
     wInst.opcodeSize = len;
     wInst.group1Size = 0;
@@ -380,6 +542,7 @@ void QBeaEngine::UpdateConfig()
 {
     _bLongDataInst = ConfigBool("Disassembler", "LongDataInstruction");
     _tokenizer.UpdateConfig();
+    ClearDecodeCache(); //cached tokens were produced with the old config
 }
 
 void formatOpcodeString(const Instruction_t & inst, RichTextPainter::List & list, std::vector<std::pair<size_t, bool>> & realBytes)
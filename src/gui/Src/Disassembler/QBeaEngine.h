@@ -49,6 +49,7 @@ public:
     Instruction_t DecodeDataAt(const byte_t* data, duint size, duint origBase, duint origInstRVA, ENCODETYPE type);
     void setCodeFoldingManager(CodeFoldingHelper* CodeFoldingManager);
     void UpdateConfig();
+    static void ClearDecodeCache();
 
     EncodeMap* getEncodeMap()
     {
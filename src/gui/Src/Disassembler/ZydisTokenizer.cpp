@@ -15,6 +15,21 @@ ZydisTokenizer::ZydisTokenizer(int maxModuleLength)
 static ZydisTokenizer::TokenColor colorNamesMap[size_t(ZydisTokenizer::TokenType::Last)];
 QHash<QString, int> ZydisTokenizer::stringPoolMap;
 int ZydisTokenizer::poolId = 0;
+QHash<QString, QString> ZydisTokenizer::internedPool;
+
+const QString & ZydisTokenizer::internText(const QString & text)
+{
+    //registers, mnemonics and punctuation form a small fixed set, so hand out one
+    //shared immutable QString per distinct text instead of allocating a copy per token
+    auto found = internedPool.find(text);
+    if(found == internedPool.end())
+    {
+        if(internedPool.size() >= 4096) //data tokens could otherwise grow the pool unboundedly
+            return text;
+        found = internedPool.insert(text, text);
+    }
+    return found.value();
+}
 
 void ZydisTokenizer::addColorName(TokenType type, QString color, QString backgroundColor)
 {
@@ -111,7 +126,10 @@ void ZydisTokenizer::UpdateStringPool()
 
 bool ZydisTokenizer::Tokenize(duint addr, const unsigned char* data, int datasize, InstructionToken & instruction)
 {
-    _inst = InstructionToken();
+    _inst.clear();
+    // The buffer is moved out below, so size it for a typical instruction
+    // up front instead of growing in small steps
+    _inst.tokens.reserve(16);
 
     _success = _cp.DisassembleSafe(addr, data, datasize);
     if(_success)
@@ -149,14 +167,15 @@ bool ZydisTokenizer::Tokenize(duint addr, const unsigned char* data, int datasiz
             token.type = _mnemonicType;
     }
 
-    instruction = _inst;
+    // Hand the token buffer over instead of copying every token
+    instruction = std::move(_inst);
 
     return true;
 }
 
 bool ZydisTokenizer::TokenizeData(const QString & datatype, const QString & data, InstructionToken & instruction)
 {
-    _inst = InstructionToken();
+    _inst.clear();
     isNop = false;
 
     if(!tokenizeMnemonic(TokenType::MnemonicNormal, datatype))
@@ -164,7 +183,7 @@ bool ZydisTokenizer::TokenizeData(const QString & datatype, const QString & data
 
     addToken(TokenType::Value, data);
 
-    instruction = _inst;
+    instruction = std::move(_inst);
 
     return true;
 }
@@ -340,7 +359,8 @@ void ZydisTokenizer::addToken(TokenType type, QString text, const TokenValue & v
     }
     if(_bUppercase && !value.size)
         text = text.toUpper();
-    _inst.tokens.push_back(SingleToken(isNop ? TokenType::MnemonicNop : type, text, value));
+    //tokens without a value come from the fixed instruction vocabulary and can share interned text
+    _inst.tokens.push_back(SingleToken(isNop ? TokenType::MnemonicNop : type, value.size ? text : internText(text), value));
 }
 
 void ZydisTokenizer::addToken(TokenType type, const QString & text)
@@ -117,6 +117,12 @@ public:
             tokens.clear();
             x = 0;
         }
+
+        void clear()
+        {
+            tokens.clear();
+            x = 0;
+        }
     };
 
     struct TokenColor
@@ -199,6 +205,9 @@ private:
 
     static QHash<QString, int> stringPoolMap;
     static int poolId;
+    static QHash<QString, QString> internedPool;
+
+    static const QString & internText(const QString & text);
 
     bool tokenizePrefix();
     bool tokenizeMnemonic();
@@ -5,6 +5,7 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QFileInfo>
+#include <QTimer>
 
 AttachDialog::AttachDialog(QWidget* parent) : QDialog(parent), ui(new Ui::AttachDialog)
 {
@@ -47,6 +48,12 @@ AttachDialog::AttachDialog(QWidget* parent) : QDialog(parent), ui(new Ui::Attach
     // Highlight the search box
     mSearchListView->mCurList->setFocus();
 
+    mRefreshBusy = false;
+    connect(this, SIGNAL(processListReady()), this, SLOT(applyProcessList()), Qt::QueuedConnection);
+    mIconTimer = new QTimer(this);
+    mIconTimer->setInterval(0);
+    connect(mIconTimer, SIGNAL(timeout()), this, SLOT(resolveIconChunk()));
+
     Config()->setupWindowPos(this);
 
     // Populate the process list atleast once
@@ -56,29 +63,119 @@ AttachDialog::AttachDialog(QWidget* parent) : QDialog(parent), ui(new Ui::Attach
 AttachDialog::~AttachDialog()
 {
     Config()->saveWindowPos(this);
+    if(mRefreshThread.joinable())
+        mRefreshThread.join();
     delete ui;
 }
 
 void AttachDialog::refresh()
 {
-    mSearchListView->setRowCount(0);
-    DBGPROCESSINFO* entries;
-    int count;
-    if(!DbgFunctions()->GetProcessList(&entries, &count))
-        return;
-    mSearchListView->setRowCount(count);
-    for(int i = 0; i < count; i++)
+    if(mRefreshBusy.exchange(true))
+        return; //an enumeration is already in flight
+    if(mRefreshThread.joinable())
+        mRefreshThread.join();
+    auto pidTidInHex = ConfigBool("Gui", "PidTidInHex");
+    mRefreshThread = std::thread([this, pidTidInHex]()
+    {
+        mPendingRows.clear();
+        DBGPROCESSINFO* entries;
+        int count;
+        if(DbgFunctions()->GetProcessList(&entries, &count))
+        {
+            mPendingRows.reserve(count);
+            for(int i = 0; i < count; i++)
+            {
+                QFileInfo fi(entries[i].szExeFile);
+                QStringList row;
+                row << QString().sprintf(pidTidInHex ? "%.8X" : "%u", entries[i].dwProcessId);
+                row << fi.baseName();
+                row << QString(entries[i].szExeMainWindowTitle);
+                row << QString(entries[i].szExeFile);
+                row << QString(entries[i].szExeArgs);
+                mPendingRows.append(row);
+            }
+        }
+        emit processListReady();
+    });
+}
+
+void AttachDialog::applyProcessList()
+{
+    QList<QStringList> rows = std::move(mPendingRows);
+    mPendingRows.clear();
+
+    //only touch the rows that differ from what is shown
+    bool changed = mShownRows.size() != rows.size();
+    if(changed)
+        mSearchListView->setRowCount(rows.size());
+    for(int i = 0; i < rows.size(); i++)
+    {
+        if(i < mShownRows.size() && mShownRows.at(i) == rows.at(i))
+            continue;
+        changed = true;
+        for(int j = 0; j < rows.at(i).size(); j++)
+            mSearchListView->setCellContent(i, j, rows.at(i).at(j));
+        auto cached = mIconCache.constFind(rows.at(i).at(ColPath));
+        mSearchListView->setRowIcon(i, cached != mIconCache.constEnd() ? cached.value() : QIcon());
+    }
+    mShownRows = std::move(rows);
+    if(changed)
+    {
+        mSearchListView->reloadData();
+        mSearchListView->refreshSearchList();
+    }
+    mRefreshBusy = false;
+
+    //resolve the icons that are not cached yet, a chunk per event loop turn
+    mIconResolveIndex = 0;
+    mIconTimer->start();
+
+    //finish a pending find-window selection now that the list is fresh
+    if(!mPendingSelectPid.isEmpty())
     {
-        QFileInfo fi(entries[i].szExeFile);
-        mSearchListView->setCellContent(i, ColPid, QString().sprintf(ConfigBool("Gui", "PidTidInHex") ? "%.8X" : "%u", entries[i].dwProcessId));
-        mSearchListView->setCellContent(i, ColName, fi.baseName());
-        mSearchListView->setCellContent(i, ColTitle, QString(entries[i].szExeMainWindowTitle));
-        mSearchListView->setCellContent(i, ColPath, QString(entries[i].szExeFile));
-        mSearchListView->setCellContent(i, ColCommandLine, QString(entries[i].szExeArgs));
-        mSearchListView->setRowIcon(i, getFileIcon(QString(entries[i].szExeFile)));
+        auto pidText = mPendingSelectPid;
+        mPendingSelectPid.clear();
+        for(int i = 0; i < mSearchListView->mCurList->getRowCount(); i++)
+        {
+            if(mSearchListView->mCurList->getCellContent(i, ColPid) == pidText)
+            {
+                mSearchListView->mCurList->setSingleSelection(i);
+                return;
+            }
+        }
+        QMessageBox hiddenProcessDialog(QMessageBox::Question, tr("Find Window"),
+                                        tr("The PID of the window is %1, but it's hidden in the process list. Do you want to attach to it immediately?").arg(pidText),
+                                        QMessageBox::Yes | QMessageBox::No, this);
+        if(hiddenProcessDialog.exec() == QMessageBox::Yes)
+        {
+            DbgCmdExec(QString("attach %1%2").arg(ConfigBool("Gui", "PidTidInHex") ? "" : ".").arg(pidText));
+            accept();
+        }
     }
-    mSearchListView->reloadData();
-    mSearchListView->refreshSearchList();
+}
+
+void AttachDialog::resolveIconChunk()
+{
+    //SHGetFileInfo belongs on the GUI thread, so the icons are filled in
+    //after the rows: a bounded chunk per timer tick keeps the dialog
+    //responsive and the path cache makes refreshes nearly free
+    int resolved = 0;
+    while(mIconResolveIndex < mShownRows.size() && resolved < 64)
+    {
+        auto row = mIconResolveIndex++;
+        const QString & path = mShownRows.at(row).at(ColPath);
+        auto cached = mIconCache.constFind(path);
+        if(cached == mIconCache.constEnd())
+        {
+            cached = mIconCache.insert(path, getFileIcon(path));
+            resolved++;
+        }
+        mSearchListView->setRowIcon(row, cached.value());
+    }
+    if(mIconResolveIndex >= mShownRows.size())
+        mIconTimer->stop();
+    if(resolved)
+        mSearchListView->reloadData();
 }
 
 void AttachDialog::on_btnAttach_clicked()
@@ -109,29 +206,9 @@ retryFindWindow:
         DWORD pid, tid;
         if(tid = GetWindowThreadProcessId(hWndFound, &pid))
         {
+            //the selection happens in applyProcessList once the refreshed list arrives
+            mPendingSelectPid = QString().sprintf(ConfigBool("Gui", "PidTidInHex") ? "%.8X" : "%u", pid);
             refresh();
-            QString pidText = QString().sprintf(ConfigBool("Gui", "PidTidInHex") ? "%.8X" : "%u", pid);
-            bool found = false;
-            for(int i = 0; i < mSearchListView->mCurList->getRowCount(); i++)
-            {
-                if(mSearchListView->mCurList->getCellContent(i, ColPid) == pidText)
-                {
-                    mSearchListView->mCurList->setSingleSelection(i);
-                    found = true;
-                    break;
-                }
-            }
-            if(!found)
-            {
-                QMessageBox hiddenProcessDialog(QMessageBox::Question, tr("Find Window"),
-                                                tr("The PID of the window \"%1\" is %2, but it's hidden in the process list. Do you want to attach to it immediately?").arg(windowText).arg(pidText),
-                                                QMessageBox::Yes | QMessageBox::No, this);
-                if(hiddenProcessDialog.exec() == QMessageBox::Yes)
-                {
-                    DbgCmdExec(QString("attach %1").arg(pid, 0, 16));
-                    accept();
-                }
-            }
         }
         else
             SimpleErrorBox(this, tr("Find Window"), tr("GetWindowThreadProcessId() failed. Cannot get the PID of the window."));
@@ -2,10 +2,15 @@
 #define ATTACHDIALOG_H
 
 #include <QDialog>
+#include <QHash>
+#include <QIcon>
+#include <atomic>
+#include <thread>
 
 class StdIconSearchListView;
 class QMenu;
 class QAction;
+class QTimer;
 
 namespace Ui
 {
@@ -20,10 +25,15 @@ public:
     explicit AttachDialog(QWidget* parent = 0);
     ~AttachDialog();
 
+signals:
+    void processListReady();
+
 private slots:
     void on_btnAttach_clicked();
     void on_btnFindWindow_clicked();
     void refresh();
+    void applyProcessList();
+    void resolveIconChunk();
     void processListContextMenu(QMenu* wMenu);
 
 private:
@@ -32,6 +42,19 @@ private:
     QAction* mAttachAction;
     QAction* mRefreshAction;
 
+    //Process enumeration runs on a background thread (the dbg side queries
+    //window titles for every process, which takes a while with a thousand
+    //processes). The GUI thread applies the result as a diff and resolves
+    //the file icons afterwards in small chunks, cached by exe path.
+    std::thread mRefreshThread;
+    std::atomic<bool> mRefreshBusy;
+    QList<QStringList> mPendingRows;
+    QList<QStringList> mShownRows;
+    QTimer* mIconTimer;
+    int mIconResolveIndex = 0;
+    QHash<QString, QIcon> mIconCache;
+    QString mPendingSelectPid;
+
     enum
     {
         ColPid,
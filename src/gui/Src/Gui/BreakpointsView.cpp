@@ -122,6 +122,7 @@ void BreakpointsView::updateColors()
     mSummaryKeywordColor = ConfigColor("BreakpointSummaryKeywordColor");
     mSummaryStringColor = ConfigColor("BreakpointSummaryStringColor");
     mDisasm->UpdateConfig();
+    mRowCache.clear(); //the colors are baked into the cached rich text
     updateBreakpointsSlot();
 }
 
@@ -208,6 +209,7 @@ void BreakpointsView::updateBreakpointsSlot()
     mBps.reserve(bpmap.count + 5);
     mRich.clear();
     mRich.reserve(bpmap.count + 5);
+    std::map<BpKey, RowCache> newCache; //entries for deleted breakpoints are dropped
     BPXTYPE lasttype = bp_none;
     for(int i = 0, row = 0; i < bpmap.count; i++, row++)
     {
@@ -237,6 +239,29 @@ void BreakpointsView::updateBreakpointsSlot()
 
         mBps.push_back(bp);
 
+        //formatting a row disassembles, resolves labels/comments and builds
+        //rich text, so rows whose breakpoint didn't change since the last
+        //refresh are served from the cache instead
+        BpKey key(bp.type, bp.addr, QString(bp.mod));
+        auto cacheItr = mRowCache.find(key);
+        if(cacheItr != mRowCache.end() && memcmp(&cacheItr->second.bp, &bp, sizeof(BRIDGEBP)) == 0)
+        {
+            auto & cached = cacheItr->second;
+            setCellContent(row, ColType, QString());
+            setCellUserdata(row, ColType, bp.type);
+            setCellContent(row, ColAddr, cached.addr);
+            setCellUserdata(row, ColAddr, row);
+            setCellContent(row, ColModLabel, cached.modLabel);
+            setCellContent(row, ColState, cached.state);
+            setCellContent(row, ColDisasm, cached.disasm);
+            setCellContent(row, ColHits, QString("%1").arg(bp.hitCount));
+            setCellContent(row, ColSummary, cached.summary);
+            mRich.push_back(std::make_pair(cached.richDisasm, cached.richSummary));
+            newCache.insert(std::make_pair(key, std::move(cached)));
+            mRowCache.erase(cacheItr);
+            continue;
+        }
+
         RichTextPainter::List richSummary, richDisasm;
 
         auto addrText = [&]()
@@ -507,18 +532,30 @@ void BreakpointsView::updateBreakpointsSlot()
             return result;
         };
 
+        RowCache cached;
+        cached.bp = bp;
+        cached.addr = addrText();
+        cached.modLabel = modLabelText();
+        cached.state = stateName();
+        cached.disasm = disasmText();
+        cached.summary = summaryText();
+        cached.richDisasm = richDisasm;
+        cached.richSummary = richSummary;
+
         setCellContent(row, ColType, QString());
         setCellUserdata(row, ColType, bp.type);
-        setCellContent(row, ColAddr, addrText());
+        setCellContent(row, ColAddr, cached.addr);
         setCellUserdata(row, ColAddr, row);
-        setCellContent(row, ColModLabel, modLabelText());
-        setCellContent(row, ColState, stateName());
-        setCellContent(row, ColDisasm, disasmText());
+        setCellContent(row, ColModLabel, cached.modLabel);
+        setCellContent(row, ColState, cached.state);
+        setCellContent(row, ColDisasm, cached.disasm);
         setCellContent(row, ColHits, QString("%1").arg(bp.hitCount));
-        setCellContent(row, ColSummary, summaryText());
+        setCellContent(row, ColSummary, cached.summary);
 
+        newCache.insert(std::make_pair(key, std::move(cached)));
         mRich.push_back(std::make_pair(std::move(richDisasm), std::move(richSummary)));
     }
+    mRowCache = std::move(newCache);
     if(bpmap.count)
     {
         BridgeFree(bpmap.bp);
@@ -540,6 +577,7 @@ void BreakpointsView::disassembleAtSlot(dsint addr, dsint cip)
 void BreakpointsView::tokenizerConfigUpdatedSlot()
 {
     mDisasm->UpdateConfig();
+    mRowCache.clear(); //the tokenizer settings are baked into the cached disassembly
     updateBreakpointsSlot();
 }
 
@@ -572,7 +610,7 @@ void BreakpointsView::followBreakpointSlot()
 
 void BreakpointsView::removeBreakpointSlot()
 {
-    for(int i : getSelection())
+    for(int i = getSelectionStart(); i <= getSelectionEnd(); i++)
     {
         if(isValidBp(i))
         {
@@ -584,7 +622,7 @@ void BreakpointsView::removeBreakpointSlot()
 
 void BreakpointsView::toggleBreakpointSlot()
 {
-    for(int i : getSelection())
+    for(int i = getSelectionStart(); i <= getSelectionEnd(); i++)
         if(isValidBp(i) && selectedBp(i).active)
             Breakpoints::toggleBPByDisabling(selectedBp(i));
 }
@@ -659,7 +697,7 @@ void BreakpointsView::editBreakpointSlot()
 
 void BreakpointsView::resetHitCountBreakpointSlot()
 {
-    for(int i : getSelection())
+    for(int i = getSelectionStart(); i <= getSelectionEnd(); i++)
     {
         if(!isValidBp(i))
             continue;
@@ -2,6 +2,8 @@
 #define BREAKPOINTSVIEW_H
 
 #include <QWidget>
+#include <tuple>
+#include <map>
 #include "Bridge.h"
 #include "StdTable.h"
 #include "QBeaEngine.h"
@@ -48,6 +50,20 @@ private:
         ColSummary
     };
 
+    //formatted row reused across refreshes while the breakpoint is unchanged
+    struct RowCache
+    {
+        BRIDGEBP bp;
+        QString addr;
+        QString modLabel;
+        QString state;
+        QString disasm;
+        QString summary;
+        RichTextPainter::List richDisasm;
+        RichTextPainter::List richSummary;
+    };
+    typedef std::tuple<int, duint, QString> BpKey; //type, address, module
+
     std::unordered_map<duint, const char*> mExceptionMap;
     QStringList mExceptionList;
     int mExceptionMaxLength;
@@ -61,6 +77,7 @@ private:
     QColor mSummaryKeywordColor;
     QColor mSummaryStringColor;
     duint mCip = 0;
+    std::map<BpKey, RowCache> mRowCache;
     MenuBuilder* mMenuBuilder;
     QAction* mEnableDisableAction;
     QBeaEngine* mDisasm;
@@ -9,7 +9,9 @@ CPUArgumentWidget::CPUArgumentWidget(QWidget* parent) :
     mTable(nullptr),
     mCurrentCallingConvention(-1),
     mStackOffset(0),
-    mAllowUpdate(true)
+    mAllowUpdate(true),
+    mLastCallingConvention(-1),
+    mLastStackOffset(0)
 {
     ui->setupUi(this);
     mTable = ui->table;
@@ -33,6 +35,7 @@ CPUArgumentWidget::CPUArgumentWidget(QWidget* parent) :
 
     connect(Bridge::getBridge(), SIGNAL(repaintTableView()), this, SLOT(refreshData()));
     connect(Bridge::getBridge(), SIGNAL(disassembleAt(dsint, dsint)), this, SLOT(disassembleAtSlot(dsint, dsint)));
+    connect(Bridge::getBridge(), SIGNAL(dbgStateChanged(DBGSTATE)), this, SLOT(debugStateChangedSlot(DBGSTATE)));
 }
 
 CPUArgumentWidget::~CPUArgumentWidget()
@@ -55,14 +58,33 @@ void CPUArgumentWidget::disassembleAtSlot(dsint addr, dsint cip)
         mTable->reloadData();
         return;
     }
-    BASIC_INSTRUCTION_INFO disasm;
-    DbgDisasmFastAt(cip, &disasm);
-    updateStackOffset(disasm.call);
+    bool isCall;
+    auto found = mIsCallCache.find(cip);
+    if(found != mIsCallCache.end()) //call detection was already done for this address
+        isCall = found.value();
+    else
+    {
+        BASIC_INSTRUCTION_INFO disasm;
+        DbgDisasmFastAt(cip, &disasm);
+        isCall = disasm.call;
+        mIsCallCache.insert(cip, isCall);
+    }
+    updateStackOffset(isCall);
     if(ui->checkBoxLock->checkState() == Qt::PartiallyChecked) //Calls
     {
-        mAllowUpdate = disasm.call;
-        ui->spinArgCount->setEnabled(disasm.call);
-        ui->comboCallingConvention->setEnabled(disasm.call);
+        mAllowUpdate = isCall;
+        ui->spinArgCount->setEnabled(isCall);
+        ui->comboCallingConvention->setEnabled(isCall);
+    }
+}
+
+void CPUArgumentWidget::debugStateChangedSlot(DBGSTATE state)
+{
+    if(state == stopped)
+    {
+        //the next session will disassemble different code and format different rows
+        mIsCallCache.clear();
+        mArgumentInputs.clear();
     }
 }
 
@@ -95,12 +117,36 @@ void CPUArgumentWidget::refreshData()
     mTable->setRowCount(argCount + stackCount);
     mArgumentValues.clear();
 
+    //when the row layout is unchanged, only rows whose raw input (register
+    //value or stack slot content) changed since the last refresh are
+    //re-formatted, because formatting hits the expression evaluator and
+    //reads memory for every row
+    bool layoutChanged = mCurrentCallingConvention != mLastCallingConvention ||
+                         mStackOffset != mLastStackOffset ||
+                         size_t(argCount + stackCount) != mArgumentInputs.size();
+    mLastCallingConvention = mCurrentCallingConvention;
+    mLastStackOffset = mStackOffset;
+
+    //batch the stack argument reads into a single memory read
+    auto stackBase = DbgValFromString(cur.getStackLocation().toUtf8().constData());
+    std::vector<duint> stackSlots(stackCount);
+    bool stackValid = stackCount == 0 ||
+                      DbgMemRead(stackBase + mStackOffset, (unsigned char*)stackSlots.data(), stackCount * sizeof(duint));
+
+    std::vector<duint> inputs(argCount + stackCount);
+    for(int i = 0; i < argCount; i++)
+        inputs[i] = DbgValFromString(cur.arguments[i].getExpression().toUtf8().constData());
+    for(int i = 0; i < stackCount; i++)
+        inputs[argCount + i] = stackSlots[i];
+
     for(int i = 0; i < argCount; i++)
     {
         const auto & curArg = cur.arguments[i];
+        mArgumentValues.push_back(inputs[i]);
+        if(!layoutChanged && inputs[i] == mArgumentInputs[i])
+            continue; //register didn't change, keep the formatted text
         auto data = stringFormatInline(curArg.getFormat());
         auto text = defaultArgFieldFormat(defaultArgName(curArg.name, i + 1), data);
-        mArgumentValues.push_back(DbgValFromString(curArg.getExpression().toUtf8().constData()));
         mTable->setCellContent(i, 0, text);
     }
 
@@ -108,14 +154,17 @@ void CPUArgumentWidget::refreshData()
     for(int i = 0; i < stackCount; i++)
     {
         duint argOffset = mStackOffset + i * sizeof(duint);
+        mArgumentValues.push_back(stackBase + argOffset);
+        if(!layoutChanged && stackValid && inputs[argCount + i] == mArgumentInputs[argCount + i])
+            continue; //stack slot didn't change, keep the formatted text
         QString expr = argOffset ? QString("%1+%2").arg(stackLocation).arg(ToHexString(argOffset)) : stackLocation;
 
         QString format = defaultArgFormat("", QString("[%1]").arg(expr));
         auto data = stringFormatInline(format);
         auto text = defaultArgFieldFormat(defaultArgName("", argCount + i + 1), data);
-        mArgumentValues.push_back(DbgValFromString(expr.toUtf8().constData()));
         mTable->setCellContent(argCount + i, 0, text);
     }
+    mArgumentInputs = stackValid ? std::move(inputs) : std::vector<duint>();
 
     mTable->reloadData();
 }
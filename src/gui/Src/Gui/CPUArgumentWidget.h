@@ -2,6 +2,7 @@
 #define CPUARGUMENTWIDGET_H
 
 #include <QWidget>
+#include <QHash>
 #include <vector>
 #include "StdTable.h"
 #include "StringUtil.h"
@@ -46,6 +47,7 @@ public slots:
 
 private slots:
     void contextMenuSlot(QPoint pos);
+    void debugStateChangedSlot(DBGSTATE state);
     void followDisasmSlot();
     void followDumpSlot();
     void followStackSlot();
@@ -141,6 +143,10 @@ private:
     bool mAllowUpdate;
     std::vector<CallingConvention> mCallingConventions;
     std::vector<duint> mArgumentValues;
+    std::vector<duint> mArgumentInputs; //register value or stack slot content each row's text was formatted from
+    QHash<duint, bool> mIsCallCache; //per-call-site detection results, keyed by instruction address
+    int mLastCallingConvention;
+    duint mLastStackOffset;
     QAction* mFollowDisasm;
     QAction* mFollowAddrDisasm;
     QAction* mFollowDump;
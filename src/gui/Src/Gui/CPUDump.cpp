@@ -26,6 +26,8 @@ CPUDump::CPUDump(CPUDisassembly* disas, CPUMultiDump* multiDump, QWidget* parent
 
     setView((ViewEnum_t)ConfigUint("HexDump", "DefaultView"));
 
+    updateColors();
+
     connect(this, SIGNAL(selectionUpdated()), this, SLOT(selectionUpdatedSlot()));
     connect(this, SIGNAL(headerButtonReleased(int)), this, SLOT(headerButtonReleasedSlot(int)));
 
@@ -335,6 +337,16 @@ void CPUDump::getColumnRichText(int col, dsint rva, RichTextPainter::List & rich
         HexDump::getColumnRichText(col, rva, richText);
 }
 
+void CPUDump::updateColors()
+{
+    HexDump::updateColors();
+
+    mLabelColor = ConfigColor("HexDumpLabelColor");
+    mLabelBackgroundColor = ConfigColor("HexDumpLabelBackgroundColor");
+    mAddressColor = ConfigColor("HexDumpAddressColor");
+    mAddressBackgroundColor = ConfigColor("HexDumpAddressBackgroundColor");
+}
+
 QString CPUDump::paintContent(QPainter* painter, dsint rowBase, int rowOffset, int col, int x, int y, int w, int h)
 {
     // Reset byte offset when base address is reached
@@ -348,13 +360,13 @@ QString CPUDump::paintContent(QPainter* painter, dsint rowBase, int rowOffset, i
         QColor background;
         if(DbgGetLabelAt(cur_addr, SEG_DEFAULT, label)) //label
         {
-            background = ConfigColor("HexDumpLabelBackgroundColor");
-            painter->setPen(ConfigColor("HexDumpLabelColor")); //TODO: config
+            background = mLabelBackgroundColor;
+            painter->setPen(mLabelColor);
         }
         else
         {
-            background = ConfigColor("HexDumpAddressBackgroundColor");
-            painter->setPen(ConfigColor("HexDumpAddressColor")); //TODO: config
+            background = mAddressBackgroundColor;
+            painter->setPen(mAddressColor);
         }
         if(background.alpha())
             painter->fillRect(QRect(x, y, w, h), QBrush(background)); //fill background color
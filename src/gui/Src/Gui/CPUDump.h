@@ -14,6 +14,7 @@ class CPUDump : public HexDump
 public:
     explicit CPUDump(CPUDisassembly* disas, CPUMultiDump* multiDump, QWidget* parent = 0);
     void getColumnRichText(int col, dsint rva, RichTextPainter::List & richText) override;
+    void updateColors() override;
     QString paintContent(QPainter* painter, dsint rowBase, int rowOffset, int col, int x, int y, int w, int h);
     void setupContextMenu();
     void getAttention();
@@ -114,6 +115,11 @@ public slots:
     void headerButtonReleasedSlot(int colIndex);
 
 private:
+    QColor mLabelColor;
+    QColor mLabelBackgroundColor;
+    QColor mAddressColor;
+    QColor mAddressBackgroundColor;
+
     MenuBuilder* mMenuBuilder;
 
     QMenu* mPluginMenu;
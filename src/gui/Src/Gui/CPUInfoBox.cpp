@@ -5,7 +5,7 @@
 #include "Bridge.h"
 #include "QBeaEngine.h"
 
-CPUInfoBox::CPUInfoBox(QWidget* parent) : StdTable(parent)
+CPUInfoBox::CPUInfoBox(QWidget* parent) : StdTable(parent), mResolveBusy(false), mPendingVA(0)
 {
     setWindowTitle("InfoBox");
     enableMultiSelection(false);
@@ -26,6 +26,7 @@ CPUInfoBox::CPUInfoBox(QWidget* parent) : StdTable(parent)
     connect(Bridge::getBridge(), SIGNAL(addInfoLine(QString)), this, SLOT(addInfoLine(QString)));
     connect(this, SIGNAL(contextMenuSignal(QPoint)), this, SLOT(contextMenuSlot(QPoint)));
     connect(this, SIGNAL(doubleClickedSignal()), this, SLOT(doubleClickedSlot()));
+    connect(this, SIGNAL(resolveDataReady()), this, SLOT(applyResolvedInfoSlot()), Qt::QueuedConnection);
     curAddr = 0;
 
     // Deselect any row (visual reasons only)
@@ -39,6 +40,8 @@ CPUInfoBox::CPUInfoBox(QWidget* parent) : StdTable(parent)
 
 CPUInfoBox::~CPUInfoBox()
 {
+    if(mResolveThread.joinable())
+        mResolveThread.join();
     delete mDisasm;
 }
 
@@ -157,11 +160,77 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
     if(!DbgIsDebugging() || !DbgMemIsValidReadPtr(parVA))
         return;
 
-    // Rather than using clear() or setInfoLine(), only reset the first three cells to reduce flicker
+    DbgSelChanged(GUI_DISASSEMBLY, parVA);
+
+    // The resolution dereferences pointers and queries symbols, which can
+    // block on high-latency reads, so it runs on a worker thread. The
+    // previous content stays visible until the fresh lines land and the
+    // worker always resolves the most recent selection.
+    mPendingVA.store(duint(parVA));
+    startResolveThread();
+}
+
+void CPUInfoBox::startResolveThread()
+{
+    if(mResolveBusy.exchange(true))
+        return; //the running worker will pick up the new selection
+    if(mResolveThread.joinable())
+        mResolveThread.join();
+    mResolveThread = std::thread([this]()
+    {
+        resolveThreadProc();
+    });
+}
+
+void CPUInfoBox::resolveThreadProc()
+{
+    for(;;)
+    {
+        duint va = mPendingVA.exchange(0);
+        if(!va)
+        {
+            mResolveBusy.store(false);
+            //a selection may have landed between the check and the busy
+            //reset; reclaim the flag and keep going if so
+            if(mPendingVA.load() == 0 || mResolveBusy.exchange(true))
+                return;
+            continue;
+        }
+        InfoResult result;
+        resolveInfo(va, result);
+        {
+            std::lock_guard<std::mutex> lock(mResultMutex);
+            mResolveResult = result;
+        }
+        emit resolveDataReady();
+    }
+}
+
+void CPUInfoBox::applyResolvedInfoSlot()
+{
+    InfoResult result;
+    {
+        std::lock_guard<std::mutex> lock(mResultMutex);
+        result = mResolveResult;
+    }
+    if(!DbgIsDebugging() || dsint(result.va) != curAddr)
+        return; //stale result, a newer resolve is already in flight
+    curRva = result.rva;
+    curOffset = result.offset;
     setRowCount(4);
-    setCellContent(0, 0, "");
-    setCellContent(1, 0, "");
-    setCellContent(2, 0, "");
+    for(int i = 0; i < 4; i++)
+        setInfoLine(i, result.line[i]);
+}
+
+//Gather the info lines for parVA (runs on the resolve thread)
+void CPUInfoBox::resolveInfo(duint parVA, InfoResult & result)
+{
+    result.va = parVA;
+    auto setLine = [&result](int line, const QString & text)
+    {
+        if(line >= 0 && line < int(_countof(result.line)))
+            result.line[line] = text;
+    };
 
     Instruction_t wInst;
     unsigned char instructiondata[MAX_DISASM_BUFFER];
@@ -178,9 +247,9 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
     {
         bool taken = DbgIsJumpGoingToExecute(parVA);
         if(taken)
-            setInfoLine(0, tr("Jump is taken"));
+            setLine(0, tr("Jump is taken"));
         else
-            setInfoLine(0, tr("Jump is not taken"));
+            setLine(0, tr("Jump is not taken"));
         start = 1;
     }
 
@@ -260,12 +329,12 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
 
             if(!DbgMemIsValidReadPtr(arg.value))
             {
-                setInfoLine(j, sizeName + "[" + argMnemonic + "]=???");
+                setLine(j, sizeName + "[" + argMnemonic + "]=???");
             }
             else if(knownsize && wInst.vectorElementType[i] == Zydis::VETDefault) // MOVSD/MOVSS instruction
             {
                 QString addrText = getSymbolicNameStr(arg.memvalue);
-                setInfoLine(j, sizeName + "[" + argMnemonic + "]=" + addrText);
+                setLine(j, sizeName + "[" + argMnemonic + "]=" + addrText);
             }
             else
             {
@@ -274,11 +343,11 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
                 memset(data.data(), 0, data.size());
                 if(DbgMemRead(arg.value, data.data(), data.size()))
                 {
-                    setInfoLine(j, sizeName + "[" + argMnemonic + "]=" + formatSSEOperand(data, wInst.vectorElementType[i]));
+                    setLine(j, sizeName + "[" + argMnemonic + "]=" + formatSSEOperand(data, wInst.vectorElementType[i]));
                 }
                 else
                 {
-                    setInfoLine(j, sizeName + "[" + argMnemonic + "]=???");
+                    setLine(j, sizeName + "[" + argMnemonic + "]=???");
                 }
             }
 
@@ -299,7 +368,7 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
             {
                 if(ToHexString(arg.value) == symbolicName)
                     continue;
-                setInfoLine(j, symbolicName);
+                setLine(j, symbolicName);
             }
             else if(!mnemonic.startsWith("xmm") &&
                     !mnemonic.startsWith("ymm") &&
@@ -307,7 +376,7 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
                     !mnemonic.startsWith("k") && //TODO: properly handle display of AVX-512 registers
                     !mnemonic.startsWith("st"))
             {
-                setInfoLine(j, mnemonic + "=" + valText);
+                setLine(j, mnemonic + "=" + valText);
                 j++;
             }
             else if(mnemonic.startsWith("xmm") || mnemonic.startsWith("ymm") || mnemonic.startsWith("st"))
@@ -398,13 +467,13 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
                     valText = ToLongDoubleString(&registers.x87FPURegisters[(registers.x87StatusWordFields.TOP + 6) & 7]);
                 else if(mnemonic == "st7")
                     valText = ToLongDoubleString(&registers.x87FPURegisters[(registers.x87StatusWordFields.TOP + 7) & 7]);
-                setInfoLine(j, mnemonic + "=" + valText);
+                setLine(j, mnemonic + "=" + valText);
                 j++;
             }
         }
     }
-    if(getInfoLine(0) == getInfoLine(1)) //check for duplicate info line
-        setInfoLine(1, "");
+    if(result.line[0] == result.line[1]) //check for duplicate info line
+        setLine(1, "");
 
     // check references details
     // code extracted from ExtraInfo plugin by torusrxxx
@@ -472,7 +541,7 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
         if(xrefInfo.refcount > 10)
             output += "...";
 
-        setInfoLine(2, output);
+        setLine(2, output);
     }
 
     // Set last line
@@ -498,13 +567,13 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
         info += " " + QString(mod);
 
         // Module RVA
-        curRva = parVA - modbase;
+        result.rva = parVA - modbase;
         if(modbase)
-            info += QString(":$%1").arg(ToHexString(curRva));
+            info += QString(":$%1").arg(ToHexString(result.rva));
 
         // File offset
-        curOffset = DbgFunctions()->VaToFileOffset(parVA);
-        info += QString(" #%1").arg(ToHexString(curOffset));
+        result.offset = DbgFunctions()->VaToFileOffset(parVA);
+        info += QString(" #%1").arg(ToHexString(result.offset));
     }
 
     // Function/label name
@@ -524,9 +593,7 @@ void CPUInfoBox::disasmSelectionChanged(dsint parVA)
         info += ", " + tr("Accessed %n time(s)", nullptr, tracedCount);
     }
 
-    setInfoLine(3, info);
-
-    DbgSelChanged(GUI_DISASSEMBLY, parVA);
+    setLine(3, info);
 }
 
 void CPUInfoBox::dbgStateChanged(DBGSTATE state)
@@ -2,6 +2,9 @@
 #define INFOBOX_H
 
 #include "StdTable.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 class WordEditDialog;
 class XrefBrowseDialog;
@@ -22,6 +25,9 @@ public:
     void setupWatchMenu(QMenu* menu, duint wVA);
     int followInDump(dsint wVA);
 
+signals:
+    void resolveDataReady();
+
 public slots:
     void disasmSelectionChanged(dsint parVA);
     void dbgStateChanged(DBGSTATE state);
@@ -35,6 +41,9 @@ public slots:
     void doubleClickedSlot();
     void addInfoLine(const QString & infoLine);
 
+private slots:
+    void applyResolvedInfoSlot();
+
 private:
     dsint curAddr;
     dsint curRva;
@@ -47,6 +56,27 @@ private:
     XrefBrowseDialog* mXrefDlg = nullptr;
     QBeaEngine* mDisasm;
 
+    // Asynchronous resolution of the selected instruction's info lines.
+    // The worker always picks up the most recent selection; stale results
+    // are dropped when they arrive on the GUI thread.
+    struct InfoResult
+    {
+        duint va = 0;
+        dsint rva = -1;
+        dsint offset = -1;
+        QString line[4];
+    };
+
+    void startResolveThread();
+    void resolveThreadProc();
+    void resolveInfo(duint parVA, InfoResult & result);
+
+    std::thread mResolveThread;
+    std::atomic<bool> mResolveBusy;
+    std::atomic<duint> mPendingVA;
+    std::mutex mResultMutex;
+    InfoResult mResolveResult;
+
     QAction* mCopyAddressAction;
     QAction* mCopyRvaAction;
     QAction* mCopyOffsetAction;
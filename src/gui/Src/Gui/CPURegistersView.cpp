@@ -301,18 +301,25 @@ void CPURegistersView::debugStateChangedSlot(DBGSTATE state)
     {
         updateRegistersSlot();
         isActive = false;
+        emit refresh(); //full repaint to blank the pane
     }
     else
     {
+        if(!isActive)
+            emit refresh(); //full repaint on the inactive -> active transition
         isActive = true;
     }
 }
 
 void CPURegistersView::updateRegistersSlot()
 {
-    // read registers
+    // read registers; skip the extended x87/SSE/AVX capture while that part
+    // of the view is hidden
     REGDUMP z;
-    DbgGetRegDumpEx(&z, sizeof(REGDUMP));
+    if(mShowFpu)
+        DbgGetRegDumpEx(&z, sizeof(REGDUMP));
+    else
+        DbgGetRegDumpBasic(&z);
     // update gui
     setRegisters(&z);
 }
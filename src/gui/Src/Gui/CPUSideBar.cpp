@@ -107,7 +107,7 @@ void CPUSideBar::reload()
 void CPUSideBar::changeTopmostAddress(dsint i)
 {
     topVA = i;
-    DbgGetRegDumpEx(&regDump, sizeof(REGDUMP));
+    DbgGetRegDumpBasic(&regDump); //only cip and flags are consumed here
     reload();
 }
 
@@ -136,7 +136,8 @@ bool CPUSideBar::isJump(int i) const
     {
         duint start = mDisas->getBase();
         duint end = start + mDisas->getSize();
-        duint addr = DbgGetBranchDestination(start + instr.rva);
+        // Resolved once at decode time, together with the tokens
+        duint addr = instr.branchDestination;
 
         if(!addr)
             return false;
@@ -236,8 +237,7 @@ void CPUSideBar::paintEvent(QPaintEvent* event)
 
         if(isJump(line)) //handle jumps
         {
-            duint baseAddr = mDisas->getBase();
-            duint destVA = DbgGetBranchDestination(baseAddr + instr.rva);
+            duint destVA = instr.branchDestination;
 
             JumpLine jmp;
             jmp.isJumpGoingToExecute = DbgIsJumpGoingToExecute(instrVA);
@@ -68,7 +68,7 @@ private:
     const int mBulletXOffset = 10;
 
     CPUDisassembly* mDisas;
-    QList<Instruction_t>* mInstrBuffer;
+    QVector<Instruction_t>* mInstrBuffer;
     REGDUMP regDump;
 
     struct JumpLine
@@ -8,7 +8,7 @@
 #include "CPUMultiDump.h"
 #include "GotoDialog.h"
 
-CPUStack::CPUStack(CPUMultiDump* multiDump, QWidget* parent) : HexDump(parent)
+CPUStack::CPUStack(CPUMultiDump* multiDump, QWidget* parent) : HexDump(parent), mAnnotationBusy(false)
 {
     setWindowTitle("Stack");
     setShowHeader(false);
@@ -53,10 +53,17 @@ CPUStack::CPUStack(CPUMultiDump* multiDump, QWidget* parent) : HexDump(parent)
     connect(Bridge::getBridge(), SIGNAL(updateDump()), this, SLOT(updateSlot()));
 
     connect(this, SIGNAL(selectionUpdated()), this, SLOT(selectionUpdatedSlot()));
+    connect(this, SIGNAL(stackAnnotationsReady()), this, SLOT(applyStackAnnotationsSlot()), Qt::QueuedConnection);
 
     Initialize();
 }
 
+CPUStack::~CPUStack()
+{
+    if(mAnnotationThread.joinable())
+        mAnnotationThread.join();
+}
+
 void CPUStack::updateColors()
 {
     HexDump::updateColors();
@@ -356,31 +363,48 @@ void CPUStack::getColumnRichText(int col, dsint rva, RichTextPainter::List & ric
             }
         }
     }
-    else if(col && DbgStackCommentGet(wVa, &comment)) //paint stack comments
+    else if(col) //paint stack comments
     {
-        if(wActiveStack)
+        //classification is expensive (it disassembles the return site), so it
+        //runs on the annotation thread; this path only consults the cache and
+        //renders nothing until the batch result for this slot arrives
+        duint value = 0;
+        mMemPage->read(&value, rva, sizeof(duint));
+        auto found = mAnnotationCache.find(wVa);
+        if(found == mAnnotationCache.end() || found->value != value) //no (fresh) annotation for this slot yet
+        {
+            queueAnnotation(wVa);
+            HexDump::getColumnRichText(col, rva, richText);
+        }
+        else if(found->hasComment)
         {
-            if(*comment.color)
+            comment = found->comment;
+            if(wActiveStack)
             {
-                if(comment.color[0] == '!')
+                if(*comment.color)
                 {
-                    if(strcmp(comment.color, "!sehclr") == 0)
-                        curData.textColor = mStackSEHChainColor;
-                    else if(strcmp(comment.color, "!rtnclr") == 0)
-                        curData.textColor = mStackReturnToColor;
+                    if(comment.color[0] == '!')
+                    {
+                        if(strcmp(comment.color, "!sehclr") == 0)
+                            curData.textColor = mStackSEHChainColor;
+                        else if(strcmp(comment.color, "!rtnclr") == 0)
+                            curData.textColor = mStackReturnToColor;
+                        else
+                            curData.textColor = mTextColor;
+                    }
                     else
-                        curData.textColor = mTextColor;
+                        curData.textColor = QColor(QString(comment.color));
                 }
                 else
-                    curData.textColor = QColor(QString(comment.color));
+                    curData.textColor = mTextColor;
             }
             else
-                curData.textColor = mTextColor;
+                curData.textColor = ConfigColor("StackInactiveTextColor");
+            curData.text = comment.comment;
+            richText.push_back(curData);
         }
         else
-            curData.textColor = ConfigColor("StackInactiveTextColor");
-        curData.text = comment.comment;
-        richText.push_back(curData);
+            HexDump::getColumnRichText(col, rva, richText);
     }
     else
         HexDump::getColumnRichText(col, rva, richText);
@@ -1039,6 +1063,80 @@ void CPUStack::dbgStateChangedSlot(DBGSTATE state)
         bStackFrozen = false;
         updateFreezeStackAction();
     }
+    if(state == stopped)
+    {
+        mAnnotationCache.clear();
+        QMutexLocker locker(&mAnnotationMutex);
+        mAnnotationQueue.clear();
+        mAnnotationResults.clear();
+    }
+}
+
+void CPUStack::queueAnnotation(duint va)
+{
+    {
+        QMutexLocker locker(&mAnnotationMutex);
+        mAnnotationQueue.insert(va);
+    }
+    startAnnotationThread();
+}
+
+void CPUStack::startAnnotationThread()
+{
+    if(mAnnotationBusy.exchange(true))
+        return; //a classification batch is already in flight
+    if(mAnnotationThread.joinable())
+        mAnnotationThread.join();
+    mAnnotationThread = std::thread([this]()
+    {
+        annotationThreadProc();
+    });
+}
+
+//Classify a batch of stack slots (runs on the annotation thread)
+void CPUStack::annotationThreadProc()
+{
+    QList<duint> batch;
+    {
+        QMutexLocker locker(&mAnnotationMutex);
+        batch = mAnnotationQueue.toList();
+        mAnnotationQueue.clear();
+    }
+    QHash<duint, StackAnnotation> results;
+    for(duint va : batch)
+    {
+        StackAnnotation annotation;
+        memset(&annotation.comment, 0, sizeof(annotation.comment));
+        //negative results are cached as well, so unreadable or comment-less
+        //slots do not get re-queued on every repaint
+        DbgMemRead(va, &annotation.value, sizeof(duint));
+        annotation.hasComment = DbgStackCommentGet(va, &annotation.comment);
+        results.insert(va, annotation);
+    }
+    {
+        QMutexLocker locker(&mAnnotationMutex);
+        for(auto it = results.begin(); it != results.end(); ++it)
+            mAnnotationResults.insert(it.key(), it.value());
+    }
+    emit stackAnnotationsReady();
+}
+
+void CPUStack::applyStackAnnotationsSlot()
+{
+    bool more;
+    {
+        QMutexLocker locker(&mAnnotationMutex);
+        if(mAnnotationCache.size() > 4096) //bound the per-slot cache
+            mAnnotationCache.clear();
+        for(auto it = mAnnotationResults.begin(); it != mAnnotationResults.end(); ++it)
+            mAnnotationCache.insert(it.key(), it.value());
+        mAnnotationResults.clear();
+        mAnnotationBusy = false;
+        more = !mAnnotationQueue.isEmpty();
+    }
+    if(more)
+        startAnnotationThread();
+    reloadData();
 }
 
 void CPUStack::followInMemoryMapSlot()
@@ -2,6 +2,10 @@
 #define CPUSTACK_H
 
 #include "HexDump.h"
+#include <QMutex>
+#include <QSet>
+#include <atomic>
+#include <thread>
 
 //forward declaration
 class CPUMultiDump;
@@ -12,6 +16,7 @@ class CPUStack : public HexDump
     Q_OBJECT
 public:
     explicit CPUStack(CPUMultiDump* multiDump, QWidget* parent = 0);
+    ~CPUStack();
 
     // Configuration
     virtual void updateColors();
@@ -26,6 +31,7 @@ public:
 
 signals:
     void displayReferencesWidget();
+    void stackAnnotationsReady();
 
 public slots:
     void pushSlot();
@@ -70,6 +76,7 @@ public slots:
     void realignSlot();
     void freezeStackSlot();
     void dbgStateChangedSlot(DBGSTATE state);
+    void applyStackAnnotationsSlot();
     void followInMemoryMapSlot();
     void followInDumpSlot();
     void updateSlot();
@@ -100,6 +107,27 @@ private:
 
     std::vector<CPUCallStack> mCallstack;
     static int CPUStack::getCurrentFrame(const std::vector<CPUStack::CPUCallStack> & mCallstack, duint wVA);
+
+    //Asynchronous stack cell classification. The comment column renders raw
+    //values immediately; a background pass produces the return-to/string
+    //annotations in batches and the result is cached per (address, value).
+    struct StackAnnotation
+    {
+        duint value = 0;
+        bool hasComment = false;
+        STACK_COMMENT comment;
+    };
+
+    void queueAnnotation(duint va);
+    void startAnnotationThread();
+    void annotationThreadProc();
+
+    QHash<duint, StackAnnotation> mAnnotationCache; //GUI thread only
+    QSet<duint> mAnnotationQueue; //mAnnotationMutex
+    QHash<duint, StackAnnotation> mAnnotationResults; //mAnnotationMutex
+    QMutex mAnnotationMutex;
+    std::thread mAnnotationThread;
+    std::atomic<bool> mAnnotationBusy;
 };
 
 #endif // CPUSTACK_H
@@ -1,6 +1,7 @@
 #include "CommandLineEdit.h"
 #include "Bridge.h"
 #include "Configuration.h"
+#include <algorithm>
 
 CommandLineEdit::CommandLineEdit(QWidget* parent)
     : HistoryLineEdit(parent),
@@ -14,6 +15,9 @@ CommandLineEdit::CommandLineEdit(QWidget* parent)
     mCompleter = new QCompleter(QStringList(), this);
     mCompleter->setCaseSensitivity(Qt::CaseInsensitive);
     mCompleter->setCompletionMode(QCompleter::PopupCompletion);
+    //The completion list is kept sorted, so the completer can binary search
+    //the prefix range instead of scanning every candidate per keystroke
+    mCompleter->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
     mCompleterModel = (QStringListModel*)mCompleter->model();
     this->setCompleter(mCompleter);
 
@@ -143,6 +147,7 @@ void CommandLineEdit::autoCompleteUpdate(const QString text)
     if(text.length() <= 0)
     {
         mCompleterModel->setStringList(QStringList());
+        mCompleterShowsDefault = false;
     }
     else
     {
@@ -178,17 +183,18 @@ void CommandLineEdit::autoCompleteUpdate(const QString text)
                 // Otherwise set the completer to nothing
                 mCompleterModel->setStringList(QStringList());
             }
+            mCompleterShowsDefault = false;
         }
         else
         {
-            // Native auto-completion
-            if(mCurrentScriptIndex == 0)
+            // Native auto-completion. The registered commands are already
+            // sorted and unique, so the model is only reset when the list
+            // changed; on a plain keystroke the completer just narrows the
+            // prefix range on the model it already has.
+            if(mCurrentScriptIndex == 0 && (!mCompleterShowsDefault || mDefaultCompletionsUpdated))
             {
-                if(mDefaultCompletionsUpdated)
-                {
-                    mDefaultCompletions.removeDuplicates();
-                    mDefaultCompletionsUpdated = false;
-                }
+                mDefaultCompletionsUpdated = false;
+                mCompleterShowsDefault = true;
                 mCompleterModel->setStringList(mDefaultCompletions);
             }
         }
@@ -199,26 +205,48 @@ void CommandLineEdit::autoCompleteUpdate(const QString text)
     }
 }
 
+//Sorted insertion position of cmd in the completion list
+static QStringList::iterator completionLowerBound(QStringList & completions, const QString & cmd)
+{
+    return std::lower_bound(completions.begin(), completions.end(), cmd, [](const QString & a, const QString & b)
+    {
+        return QString::compare(a, b, Qt::CaseInsensitive) < 0;
+    });
+}
+
 void CommandLineEdit::autoCompleteAddCmd(const QString cmd)
 {
-    mDefaultCompletions << cmd.split(QChar(','), QString::SkipEmptyParts);
-    mDefaultCompletionsUpdated = true;
+    // Incremental sorted insertion keeps registration O(log n) per command
+    // and spares a sort + dedup of the whole list when the popup opens
+    for(const QString & add : cmd.split(QChar(','), QString::SkipEmptyParts))
+    {
+        auto insert = completionLowerBound(mDefaultCompletions, add);
+        if(insert == mDefaultCompletions.end() || QString::compare(*insert, add, Qt::CaseInsensitive) != 0)
+        {
+            mDefaultCompletions.insert(insert, add);
+            mDefaultCompletionsUpdated = true;
+        }
+    }
 }
 
 void CommandLineEdit::autoCompleteDelCmd(const QString cmd)
 {
-    QStringList deleteList = cmd.split(QChar(','), QString::SkipEmptyParts);
-
-    for(int i = 0; i < deleteList.size(); i++)
-        mDefaultCompletions.removeAll(deleteList.at(i));
-    mDefaultCompletionsUpdated = true;
+    for(const QString & del : cmd.split(QChar(','), QString::SkipEmptyParts))
+    {
+        auto found = completionLowerBound(mDefaultCompletions, del);
+        if(found != mDefaultCompletions.end() && QString::compare(*found, del, Qt::CaseInsensitive) == 0)
+        {
+            mDefaultCompletions.erase(found);
+            mDefaultCompletionsUpdated = true;
+        }
+    }
 }
 
 void CommandLineEdit::autoCompleteClearAll()
 {
     // Update internal list only
     mDefaultCompletions.clear();
-    mDefaultCompletionsUpdated = false;
+    mDefaultCompletionsUpdated = true;
 }
 
 void CommandLineEdit::registerScriptType(SCRIPTTYPEINFO* info)
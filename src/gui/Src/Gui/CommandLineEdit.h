@@ -38,8 +38,9 @@ private:
     QCompleter* mCompleter;
     QStringListModel* mCompleterModel;
     QList<SCRIPTTYPEINFO> mScriptInfo;
-    QStringList mDefaultCompletions;
+    QStringList mDefaultCompletions; //kept sorted (case-insensitively) and unique
     bool mDefaultCompletionsUpdated = false;
+    bool mCompleterShowsDefault = false;
     int mCurrentScriptIndex;
 };
 
@@ -17,6 +17,7 @@
 #include "StringUtil.h"
 #include "MiscUtil.h"
 #include <QMainWindow>
+#include <QtMath>
 
 DisassemblerGraphView::DisassemblerGraphView(QWidget* parent)
     : QAbstractScrollArea(parent),
@@ -302,10 +303,85 @@ void DisassemblerGraphView::zoomOut(QPoint mousePosition)
     this->viewport()->update();
 }
 
+DisassemblerGraphView::BlockTraceCounts DisassemblerGraphView::blockTraceCounts(const DisassemblerBlock & block)
+{
+    BlockTraceCounts result;
+    result.base = block.block.entry;
+    auto & instrs = block.block.instrs;
+    duint size = 1;
+    if(!instrs.empty())
+        size = instrs.back().addr + instrs.back().opcode.size() - result.base;
+    result.counts.resize(size ? size : 1);
+    DbgFunctions()->GetTraceRecordHitCounts(result.base, result.counts.size(), result.counts.data());
+    return result;
+}
+
+//Rasterize the node text (header and instruction lines) into a pixmap at the
+//given scale, so panning only blits cached pixmaps instead of re-running
+//RichTextPainter on every frame. Only the text is cached: selection and trace
+//fills and the breakpoint/CIP markers are painted live underneath the blit.
+//renderFunction() rebuilds the blocks map whenever the graph is reloaded
+//(comment, label or patch edits, font changes), which discards the cache, and
+//a zoom step changes the scale key.
+QPixmap & DisassemblerGraphView::cachedBlockPixmap(DisassemblerBlock & block, qreal scale)
+{
+    if(block.textPixmap.isNull() || block.textPixmapScale != scale)
+    {
+        QPixmap pixmap(qMax(1, qCeil(block.width * scale)), qMax(1, qCeil(block.height * scale)));
+        pixmap.fill(Qt::transparent);
+        QPainter painter(&pixmap);
+        painter.setFont(this->font());
+        painter.scale(scale, scale);
+
+        auto x = 2 * this->charWidth;
+        auto y = 2 * this->charWidth;
+        for(auto & line : block.block.header_text.lines)
+        {
+            RichTextPainter::paintRichText(&painter, x, y, block.width, this->charHeight, 0, line, mFontMetrics);
+            y += this->charHeight;
+        }
+        for(Instr & instr : block.block.instrs)
+        {
+            for(auto & line : instr.text.lines)
+            {
+                RichTextPainter::paintRichText(&painter, x + this->charWidth, y, block.width - this->charWidth, this->charHeight, 0, line, mFontMetrics);
+                y += this->charHeight;
+            }
+        }
+
+        block.textPixmap = pixmap;
+        block.textPixmapScale = scale;
+    }
+    block.textPixmapFrame = mPaintFrame;
+    return block.textPixmap;
+}
+
+//Bound the pixmap cache on huge graphs: once more than mBlockPixmapCacheMax
+//nodes hold a pixmap, drop the ones that were not blitted this frame.
+void DisassemblerGraphView::evictBlockPixmaps()
+{
+    size_t cached = 0;
+    for(const auto & blockIt : this->blocks)
+    {
+        if(!blockIt.second.textPixmap.isNull())
+            cached++;
+    }
+    if(cached <= mBlockPixmapCacheMax)
+        return;
+    for(auto & blockIt : this->blocks)
+    {
+        DisassemblerBlock & block = blockIt.second;
+        if(!block.textPixmap.isNull() && block.textPixmapFrame != mPaintFrame)
+        {
+            block.textPixmap = QPixmap();
+            block.textPixmapScale = 0.0;
+        }
+    }
+}
+
 void DisassemblerGraphView::paintNormal(QPainter & p, QRect & viewportRect, int xofs, int yofs)
 {
     //Translate the painter
-    auto dbgfunctions = DbgFunctions();
     QPoint translation(this->renderXOfs - xofs, this->renderYOfs - yofs);
     p.translate(translation);
     viewportRect.translate(-translation.x(), -translation.y());
@@ -347,13 +423,14 @@ void DisassemblerGraphView::paintNormal(QPainter & p, QRect & viewportRect, int
             //Print current instruction background
             if(this->cur_instr != 0)
             {
+                auto blockCounts = blockTraceCounts(block);
                 int y = block.y + (2 * this->charWidth) + (int(block.block.header_text.lines.size()) * this->charHeight);
                 for(Instr & instr : block.block.instrs)
                 {
                     if(y > viewportRect.y() - int(instr.text.lines.size()) * this->charHeight && y < viewportRect.bottom())
                     {
                         auto selected = instr.addr == this->cur_instr;
-                        auto traceCount = dbgfunctions->GetTraceRecordHitCount(instr.addr);
+                        auto traceCount = blockCounts.at(instr.addr);
 
                         if(selected && traceCount)
                         {
@@ -387,21 +464,12 @@ void DisassemblerGraphView::paintNormal(QPainter & p, QRect & viewportRect, int
                 }
             }
 
-            //Render node text
+            //Render breakpoint/bookmark/CIP markers (live data, kept out of the cached text pixmap)
             auto x = block.x + (2 * this->charWidth);
-            auto y = block.y + (2 * this->charWidth);
-            for(auto & line : block.block.header_text.lines)
-            {
-                if(y > viewportRect.y() - this->charHeight && y < viewportRect.bottom())
-                {
-                    RichTextPainter::paintRichText(&p, x, y, block.width, this->charHeight, 0, line, mFontMetrics);
-                }
-                y += this->charHeight;
-            }
-
+            auto y = block.y + (2 * this->charWidth) + (int(block.block.header_text.lines.size()) * this->charHeight);
             for(Instr & instr : block.block.instrs)
             {
-                for(auto & line : instr.text.lines)
+                for(size_t i = 0; i < instr.text.lines.size(); i++)
                 {
                     if(y > viewportRect.y() - this->charHeight && y < viewportRect.bottom())
                     {
@@ -447,12 +515,13 @@ void DisassemblerGraphView::paintNormal(QPainter & p, QRect & viewportRect, int
                         }
                         else if(iscip)
                             p.fillRect(bpRect, mCipColor);
-
-                        RichTextPainter::paintRichText(&p, x + this->charWidth, y, block.width - this->charWidth, this->charHeight, 0, line, mFontMetrics);
                     }
                     y += this->charHeight;
                 }
             }
+
+            //Blit the cached node text (markers live in the gutter left of the text)
+            p.drawPixmap(QPointF(block.x, block.y), cachedBlockPixmap(block, 1.0));
         }
 
         // Render edges
@@ -654,13 +723,14 @@ void DisassemblerGraphView::paintZoom(QPainter & p, QRect & viewportRect, int xo
                 //Print current instruction background
                 if(this->cur_instr != 0)
                 {
+                    auto blockCounts = blockTraceCounts(block);
                     int y = block.y + (2 * this->charWidth) + (int(block.block.header_text.lines.size()) * this->charHeight);
                     for(Instr & instr : block.block.instrs)
                     {
                         if(y > viewportRect.y() - int(instr.text.lines.size()) * this->charHeight && y < viewportRect.bottom())
                         {
                             auto selected = instr.addr == this->cur_instr;
-                            auto traceCount = dbgfunctions->GetTraceRecordHitCount(instr.addr);
+                            auto traceCount = blockCounts.at(instr.addr);
 
                             if(selected && traceCount)
                             {
@@ -694,21 +764,12 @@ void DisassemblerGraphView::paintZoom(QPainter & p, QRect & viewportRect, int xo
                     }
                 }
 
-                //Render node text
+                //Render breakpoint/CIP markers (live data, kept out of the cached text pixmap)
                 auto x = block.x + (2 * this->charWidth);
-                auto y = block.y + (2 * this->charWidth);
-                for(auto & line : block.block.header_text.lines)
-                {
-                    if(y > viewportRect.y() - this->charHeight && y < viewportRect.bottom())
-                    {
-                        RichTextPainter::paintRichText(&p, x, y, block.width, this->charHeight, 0, line, mFontMetrics);
-                    }
-                    y += this->charHeight;
-                }
-
+                auto y = block.y + (2 * this->charWidth) + (int(block.block.header_text.lines.size()) * this->charHeight);
                 for(Instr & instr : block.block.instrs)
                 {
-                    for(auto & line : instr.text.lines)
+                    for(size_t i = 0; i < instr.text.lines.size(); i++)
                     {
                         if(y > viewportRect.y() - this->charHeight && y < viewportRect.bottom())
                         {
@@ -739,13 +800,15 @@ void DisassemblerGraphView::paintZoom(QPainter & p, QRect & viewportRect, int xo
                             }
                             else if(iscip)
                                 p.fillRect(bpRect, mCipColor);
-
-                            RichTextPainter::paintRichText(&p, x + this->charWidth, y, block.width - this->charWidth, this->charHeight, 0, line, mFontMetrics);
                         }
                         y += this->charHeight;
                     }
                 }
 
+                //Blit the cached node text, rasterized at device resolution for the current zoom
+                QPixmap & pixmap = cachedBlockPixmap(block, zoomLevel);
+                p.drawPixmap(QRectF(block.x, block.y, block.width, block.height), pixmap, QRectF(pixmap.rect()));
+
             }
             else //Overview mode
             {
@@ -832,6 +895,9 @@ void DisassemblerGraphView::paintEvent(QPaintEvent* event)
         paintZoom(p, viewportRect, xofs, yofs);
     }
 
+    evictBlockPixmaps();
+    mPaintFrame++;
+
     if(saveGraph)
     {
         //TODO: speed up large graph saving or show gif loader so it won't look like it has crashed
@@ -906,29 +972,61 @@ void DisassemblerGraphView::wheelEvent(QWheelEvent* event)
     }
 }
 
-bool DisassemblerGraphView::isMouseEventInBlock(QMouseEvent* event)
+static inline unsigned long long blockGridKey(int cx, int cy)
 {
-    //Convert coordinates to system used in blocks
-    int xofs = this->horizontalScrollBar()->value();
-    int yofs = this->verticalScrollBar()->value();
-    int x = (event->x() + xofs - this->renderXOfs) / zoomLevel;
-    int y = (event->y() + yofs - this->renderYOfs) / zoomLevel;
+    return (unsigned long long)(unsigned int)cx << 32 | (unsigned int)cy;
+}
 
-    // Check each block for hits
+void DisassemblerGraphView::buildBlockIndex()
+{
+    mBlockGrid.clear();
     for(auto & blockIt : this->blocks)
     {
         DisassemblerBlock & block = blockIt.second;
+        int left = int(block.x) >> mBlockGridShift;
+        int right = int(block.x + block.width) >> mBlockGridShift;
+        int top = int(block.y) >> mBlockGridShift;
+        int bottom = int(block.y + block.height) >> mBlockGridShift;
+        for(int cy = top; cy <= bottom; cy++)
+            for(int cx = left; cx <= right; cx++)
+                mBlockGrid[blockGridKey(cx, cy)].push_back(blockIt.first);
+    }
+}
+
+DisassemblerGraphView::DisassemblerBlock* DisassemblerGraphView::blockAtPos(int x, int y)
+{
+    //Only the blocks overlapping this grid cell can contain the point
+    auto cell = mBlockGrid.find(blockGridKey(x >> mBlockGridShift, y >> mBlockGridShift));
+    if(cell == mBlockGrid.end())
+        return nullptr;
+    for(duint entry : cell->second)
+    {
+        auto blockIt = this->blocks.find(entry);
+        if(blockIt == this->blocks.end())
+            continue;
+        DisassemblerBlock & block = blockIt->second;
         //Compute coordinate relative to text area in block
         int blockx = x - (block.x + (2 * this->charWidth));
         int blocky = y - (block.y + (2 * this->charWidth));
-        //Check to see if click is within bounds of block
+        //Check to see if the point is within bounds of block
         if((blockx < 0) || (blockx > (block.width - 4 * this->charWidth)))
             continue;
         if((blocky < 0) || (blocky > (block.height - 4 * this->charWidth)))
             continue;
-        return true;
+        return &block;
     }
-    return false;
+    return nullptr;
+}
+
+bool DisassemblerGraphView::isMouseEventInBlock(QMouseEvent* event)
+{
+    //Convert coordinates to system used in blocks
+    int xofs = this->horizontalScrollBar()->value();
+    int yofs = this->verticalScrollBar()->value();
+    int x = (event->x() + xofs - this->renderXOfs) / zoomLevel;
+    int y = (event->y() + yofs - this->renderYOfs) / zoomLevel;
+
+    return blockAtPos(x, y) != nullptr;
 }
 
 duint DisassemblerGraphView::getInstrForMouseEvent(QMouseEvent* event)
@@ -939,18 +1037,11 @@ duint DisassemblerGraphView::getInstrForMouseEvent(QMouseEvent* event)
     int x = (event->x() + xofs - this->renderXOfs) / zoomLevel;
     int y = (event->y() + yofs - this->renderYOfs) / zoomLevel;
 
-    //Check each block for hits
-    for(auto & blockIt : this->blocks)
+    auto blockPtr = blockAtPos(x, y);
+    if(blockPtr)
     {
-        DisassemblerBlock & block = blockIt.second;
-        //Compute coordinate relative to text area in block
-        int blockx = x - (block.x + (2 * this->charWidth));
+        DisassemblerBlock & block = *blockPtr;
         int blocky = y - (block.y + (2 * this->charWidth));
-        //Check to see if click is within bounds of block
-        if((blockx < 0) || (blockx > (block.width - 4 * this->charWidth)))
-            continue;
-        if((blocky < 0) || (blocky > (block.height - 4 * this->charWidth)))
-            continue;
         //Compute row within text
         int row = int(blocky / this->charHeight);
         //Determine instruction for this row
@@ -1511,6 +1602,7 @@ void DisassemblerGraphView::renderFunction(Function & func)
 
     //Create render nodes
     this->blocks.clear();
+    this->mBlockGrid.clear();
     if(func.entry == 0)
     {
         this->ready = false;
@@ -1523,92 +1615,141 @@ void DisassemblerGraphView::renderFunction(Function & func)
     }
     //puts("Create render nodes");
 
-    //Populate incoming lists
-    for(auto & blockIt : this->blocks)
+    //Check if the cached topology layout is still usable for this function
+    std::vector<duint> blockOrder;
+    bool cacheValid = this->layoutCacheEntry == func.entry && this->layoutCache.size() == this->blocks.size();
+    if(cacheValid)
     {
-        DisassemblerBlock & block = blockIt.second;
-        for(auto & edge : block.block.exits)
-            this->blocks[edge].incoming.push_back(block.block.entry);
+        for(auto & blockIt : this->blocks)
+        {
+            if(!this->layoutCache.count(blockIt.first))
+            {
+                cacheValid = false;
+                break;
+            }
+        }
     }
-    //puts("Populate incoming lists");
-
-    //Construct acyclic graph where each node is used as an edge exactly once
-    std::unordered_set<duint> visited;
-    visited.insert(func.entry);
-    std::queue<duint> queue;
-    queue.push(this->blocks[func.entry].block.entry);
-    std::vector<duint> blockOrder;
-    bool changed = true;
 
-    while(changed)
+    if(cacheValid)
     {
-        changed = false;
+        //Reuse the cached topology: the block order, rows and columns only
+        //depend on the entries and exits, which did not change
+        for(auto & blockIt : this->blocks)
+        {
+            DisassemblerBlock & block = blockIt.second;
+            const CachedLayoutBlock & cached = this->layoutCache[blockIt.first];
+            block.new_exits = cached.new_exits;
+            block.col = cached.col;
+            block.col_count = cached.col_count;
+            block.row = cached.row;
+            block.row_count = cached.row_count;
+        }
+        blockOrder = this->layoutCacheOrder;
+    }
+    else
+    {
+        //Populate incoming lists
+        for(auto & blockIt : this->blocks)
+        {
+            DisassemblerBlock & block = blockIt.second;
+            for(auto & edge : block.block.exits)
+                this->blocks[edge].incoming.push_back(block.block.entry);
+        }
+        //puts("Populate incoming lists");
+
+        //Construct acyclic graph where each node is used as an edge exactly once
+        std::unordered_set<duint> visited;
+        visited.insert(func.entry);
+        std::queue<duint> queue;
+        queue.push(this->blocks[func.entry].block.entry);
+        bool changed = true;
 
-        //First pick nodes that have single entry points
-        while(!queue.empty())
+        while(changed)
         {
-            DisassemblerBlock & block = this->blocks[queue.front()];
-            queue.pop();
-            blockOrder.push_back(block.block.entry);
+            changed = false;
 
-            for(duint edge : block.block.exits)
+            //First pick nodes that have single entry points
+            while(!queue.empty())
             {
-                if(visited.count(edge))
-                    continue;
+                DisassemblerBlock & block = this->blocks[queue.front()];
+                queue.pop();
+                blockOrder.push_back(block.block.entry);
 
-                //If node has no more unseen incoming edges, add it to the graph layout now
-                if(int(this->blocks[edge].incoming.size()) == 1)
+                for(duint edge : block.block.exits)
                 {
-                    removeFromVec(this->blocks[edge].incoming, block.block.entry);
-                    block.new_exits.push_back(edge);
-                    queue.push(this->blocks[edge].block.entry);
-                    visited.insert(edge);
-                    changed = true;
-                }
-                else
-                {
-                    removeFromVec(this->blocks[edge].incoming, block.block.entry);
+                    if(visited.count(edge))
+                        continue;
+
+                    //If node has no more unseen incoming edges, add it to the graph layout now
+                    if(int(this->blocks[edge].incoming.size()) == 1)
+                    {
+                        removeFromVec(this->blocks[edge].incoming, block.block.entry);
+                        block.new_exits.push_back(edge);
+                        queue.push(this->blocks[edge].block.entry);
+                        visited.insert(edge);
+                        changed = true;
+                    }
+                    else
+                    {
+                        removeFromVec(this->blocks[edge].incoming, block.block.entry);
+                    }
                 }
             }
-        }
 
-        //No more nodes satisfy constraints, pick a node to continue constructing the graph
-        duint best = 0;
-        int best_edges;
-        duint best_parent;
-        for(auto & blockIt : this->blocks)
-        {
-            DisassemblerBlock & block = blockIt.second;
-            if(!visited.count(block.block.entry))
-                continue;
-            for(duint edge : block.block.exits)
+            //No more nodes satisfy constraints, pick a node to continue constructing the graph
+            duint best = 0;
+            int best_edges;
+            duint best_parent;
+            for(auto & blockIt : this->blocks)
             {
-                if(visited.count(edge))
+                DisassemblerBlock & block = blockIt.second;
+                if(!visited.count(block.block.entry))
                     continue;
-                if((best == 0) || (int(this->blocks[edge].incoming.size()) < best_edges) || (
-                            (int(this->blocks[edge].incoming.size()) == best_edges) && (edge < best)))
+                for(duint edge : block.block.exits)
                 {
-                    best = edge;
-                    best_edges = int(this->blocks[edge].incoming.size());
-                    best_parent = block.block.entry;
+                    if(visited.count(edge))
+                        continue;
+                    if((best == 0) || (int(this->blocks[edge].incoming.size()) < best_edges) || (
+                                (int(this->blocks[edge].incoming.size()) == best_edges) && (edge < best)))
+                    {
+                        best = edge;
+                        best_edges = int(this->blocks[edge].incoming.size());
+                        best_parent = block.block.entry;
+                    }
                 }
             }
+
+            if(best != 0)
+            {
+                DisassemblerBlock & best_parentb = this->blocks[best_parent];
+                removeFromVec(this->blocks[best].incoming, best_parentb.block.entry);
+                best_parentb.new_exits.push_back(best);
+                visited.insert(best);
+                queue.push(best);
+                changed = true;
+            }
         }
+        //puts("Construct acyclic graph where each node is used as an edge exactly once");
 
-        if(best != 0)
+        //Compute graph layout from bottom up
+        this->computeGraphLayout(this->blocks[func.entry]);
+
+        //Cache the topology layout for re-renders of the same function
+        this->layoutCache.clear();
+        for(auto & blockIt : this->blocks)
         {
-            DisassemblerBlock & best_parentb = this->blocks[best_parent];
-            removeFromVec(this->blocks[best].incoming, best_parentb.block.entry);
-            best_parentb.new_exits.push_back(best);
-            visited.insert(best);
-            queue.push(best);
-            changed = true;
+            const DisassemblerBlock & block = blockIt.second;
+            CachedLayoutBlock cached;
+            cached.new_exits = block.new_exits;
+            cached.col = block.col;
+            cached.col_count = block.col_count;
+            cached.row = block.row;
+            cached.row_count = block.row_count;
+            this->layoutCache[blockIt.first] = cached;
         }
+        this->layoutCacheOrder = blockOrder;
+        this->layoutCacheEntry = func.entry;
     }
-    //puts("Construct acyclic graph where each node is used as an edge exactly once");
-
-    //Compute graph layout from bottom up
-    this->computeGraphLayout(this->blocks[func.entry]);
 
     //Optimize layout to be more compact
     /*std::vector<DisassemblerBlock> rowBlocks;
@@ -1858,6 +1999,9 @@ void DisassemblerGraphView::renderFunction(Function & func)
         this->verticalScrollBar()->setValue(0);
     }
 
+    //Index the final block rectangles for mouse hit-testing
+    this->buildBlockIndex();
+
     this->ready = true;
     this->viewport()->update(0, 0, areaSize.width(), areaSize.height());
     //puts("Finished");
@@ -1965,6 +2109,7 @@ void DisassemblerGraphView::fontChanged()
 void DisassemblerGraphView::setGraphLayout(DisassemblerGraphView::LayoutType layout)
 {
     this->layoutType = layout;
+    this->layoutCacheEntry = 0; //the cached columns depend on the layout type
     if(this->ready)
     {
         this->renderFunction(this->analysis.functions[this->function]);
@@ -2115,6 +2260,7 @@ void DisassemblerGraphView::loadGraphSlot(BridgeCFGraphList* graphList, duint ad
 
     currentGraph = BridgeCFGraph(graphList, true);
     currentBlockMap.clear();
+    this->layoutCacheEntry = 0; //the topology may have changed
     this->cur_instr = addr ? addr : this->function;
     this->forceCenter = true;
     loadCurrentGraph();
@@ -2542,7 +2688,10 @@ void DisassemblerGraphView::setCommentSlot()
     if(!DbgSetCommentAt(wVA, mLineEdit.editText.replace('\r', "").replace('\n', "").toUtf8().constData()))
         SimpleErrorBox(this, tr("Error!"), tr("DbgSetCommentAt failed!"));
 
-    this->refreshSlot();
+    //A comment doesn't change the control flow, so rebuild the graph text
+    //locally instead of re-analyzing the function
+    this->loadCurrentGraph();
+    GuiUpdateAllViews();
 }
 
 void DisassemblerGraphView::setLabelSlot()
@@ -2580,7 +2729,10 @@ restart:
     if(!DbgSetLabelAt(wVA, utf8data.constData()))
         SimpleErrorBox(this, tr("Error!"), tr("DbgSetLabelAt failed!"));
 
-    this->refreshSlot();
+    //A label doesn't change the control flow, so rebuild the graph text
+    //locally instead of re-analyzing the function
+    this->loadCurrentGraph();
+    GuiUpdateAllViews();
 }
 
 void DisassemblerGraphView::setBookmarkSlot()
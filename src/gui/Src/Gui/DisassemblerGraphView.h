@@ -8,6 +8,7 @@
 #include <QTimer>
 #include <QSize>
 #include <QResizeEvent>
+#include <QPixmap>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
@@ -165,6 +166,12 @@ public:
         int col_count = 0;
         int row = 0;
         int row_count = 0;
+
+        //Node text rasterized once at textPixmapScale and blitted on paint;
+        //discarded when the blocks map is rebuilt or by evictBlockPixmaps()
+        QPixmap textPixmap;
+        qreal textPixmapScale = 0.0;
+        int textPixmapFrame = 0;
     };
 
     struct Function
@@ -174,6 +181,20 @@ public:
         std::vector<Block> blocks;
     };
 
+    // Per-byte trace record hit counts for one block, fetched with a single
+    // bridge call instead of one GetTraceRecordHitCount per instruction
+    struct BlockTraceCounts
+    {
+        duint base = 0;
+        std::vector<unsigned int> counts;
+
+        unsigned int at(duint addr) const
+        {
+            duint index = addr - base;
+            return index < counts.size() ? counts[index] : 0;
+        }
+    };
+
     struct Analysis
     {
         duint entry = 0;
@@ -221,6 +242,11 @@ public:
     //void closeRequest();
     void paintNormal(QPainter & p, QRect & viewportRect, int xofs, int yofs);
     void paintOverview(QPainter & p, QRect & viewportRect, int xofs, int yofs);
+    BlockTraceCounts blockTraceCounts(const DisassemblerBlock & block);
+    QPixmap & cachedBlockPixmap(DisassemblerBlock & block, qreal scale);
+    void evictBlockPixmaps();
+    void buildBlockIndex();
+    DisassemblerBlock* blockAtPos(int x, int y);
     void paintEvent(QPaintEvent* event);
     bool isMouseEventInBlock(QMouseEvent* event);
     duint getInstrForMouseEvent(QMouseEvent* event);
@@ -329,6 +355,29 @@ private:
     bool viewportReady;
     int* desired_pos;
     std::unordered_map<duint, DisassemblerBlock> blocks;
+    //Uniform-grid spatial index over the laid-out block rectangles, rebuilt
+    //after every layout, so mouse hit-testing only inspects the blocks
+    //overlapping one grid cell instead of scanning the whole graph
+    std::unordered_map<unsigned long long, std::vector<duint>> mBlockGrid;
+    static const int mBlockGridShift = 9; //512-pixel cells in layout space
+    int mPaintFrame = 0; //frame counter stamped on blitted pixmaps, for eviction
+    static const size_t mBlockPixmapCacheMax = 512; //cached node pixmaps kept across frames
+    //Cached topology layout: the block order, rows and columns only depend on
+    //the block entries and exits, so they are reused when the same function is
+    //re-rendered because only its text changed (comments, labels, tokenizer
+    //or color config). Invalidated when a new graph is loaded or the layout
+    //type changes.
+    struct CachedLayoutBlock
+    {
+        std::vector<duint> new_exits;
+        int col = 0;
+        int col_count = 0;
+        int row = 0;
+        int row_count = 0;
+    };
+    duint layoutCacheEntry = 0; //function entry the cached layout belongs to
+    std::unordered_map<duint, CachedLayoutBlock> layoutCache;
+    std::vector<duint> layoutCacheOrder;
     HighlightToken* highlight_token;
     std::vector<int> col_edge_x;
     std::vector<int> row_edge_y;
@@ -3,23 +3,180 @@
 #include "Configuration.h"
 #include "StringUtil.h"
 #include "MiscUtil.h"
+#include "Bridge.h"
 #include <QPainter>
 
+DisassemblyPopupBuilderThread::DisassemblyPopupBuilderThread(QObject* parent) : QThread(parent),
+    mRequestAddr(0),
+    mMaxInstructions(20),
+    mRequestChanged(false),
+    mConfigChanged(false),
+    mHasResult(false),
+    mStopThread(false),
+    mDisasm(ConfigUint("Disassembler", "MaxModuleSize"))
+{
+}
+
+DisassemblyPopupBuilderThread::~DisassemblyPopupBuilderThread()
+{
+    stop();
+    wait();
+}
+
+void DisassemblyPopupBuilderThread::start()
+{
+    mStopThread = false;
+    QThread::start();
+}
+
+void DisassemblyPopupBuilderThread::stop()
+{
+    mStopThread = true;
+}
+
+void DisassemblyPopupBuilderThread::request(duint addr, unsigned int maxInstructions)
+{
+    mRequestMutex.lock();
+    mRequestAddr = addr;
+    mMaxInstructions = maxInstructions;
+    mRequestChanged = true;
+    mRequestMutex.unlock();
+}
+
+bool DisassemblyPopupBuilderThread::takeResult(DisassemblyPopupContent & content)
+{
+    mRequestMutex.lock();
+    bool hasResult = mHasResult;
+    if(hasResult)
+        content = std::move(mResult);
+    mHasResult = false;
+    mRequestMutex.unlock();
+    return hasResult;
+}
+
+void DisassemblyPopupBuilderThread::tokenizerConfigUpdated()
+{
+    // mDisasm is only touched from the builder thread, reload it there
+    mRequestMutex.lock();
+    mConfigChanged = true;
+    mRequestMutex.unlock();
+}
+
+void DisassemblyPopupBuilderThread::disassembleContent(duint addr, unsigned int maxInstructions, DisassemblyPopupContent & content)
+{
+    content.addr = addr;
+    QVector<Instruction_t> instBuffer;
+    duint size;
+    duint base = DbgMemFindBaseAddr(addr, &size);
+    // Prepare RVA of every instruction
+    unsigned int i = 0;
+    auto nextAddr = addr;
+    bool hadBranch = false;
+    duint bestBranch = 0;
+    byte data[64];
+    do
+    {
+        if(nextAddr >= base + size)
+            break;
+        if(!DbgMemRead(nextAddr, data, sizeof(data)))
+            break;
+        auto instruction = mDisasm.DisassembleAt(data, sizeof(data), 0, nextAddr);
+        if(!instruction.length)
+            break;
+        bool lastInstruction = false;
+        if(!hadBranch || bestBranch <= nextAddr)
+        {
+            if(instruction.instStr.contains("ret"))
+                lastInstruction = true;
+            else if(instruction.instStr.contains("jmp") && instruction.instStr.contains("["))
+                lastInstruction = true;
+        }
+        if(instruction.branchDestination && !instruction.instStr.contains("call") && !instruction.instStr.contains("ret"))
+        {
+            hadBranch = true;
+            if(instruction.branchDestination > bestBranch)
+                bestBranch = instruction.branchDestination;
+        }
+        auto length = instruction.length;
+        instBuffer.append(std::move(instruction));
+        if(lastInstruction)
+            break;
+        auto nextAddr2 = nextAddr + length;
+        if(nextAddr2 == nextAddr)
+            break;
+        else
+            nextAddr = nextAddr2;
+        if(DbgGetFunctionTypeAt(nextAddr - 1) == FUNC_END)
+            break;
+        i++;
+    }
+    while(i < maxInstructions);
+    // Disassemble
+    for(auto & instruction : instBuffer)
+    {
+        RichTextPainter::List richText;
+        ZydisTokenizer::TokenToRichText(instruction.tokens, richText, nullptr);
+        content.tokens.push_back(std::make_pair(std::move(richText), DbgFunctions()->GetTraceRecordHitCount(instruction.rva) != 0));
+    }
+    // Address
+    content.addrText = getSymbolicName(addr);
+    // Comments
+    GetCommentFormat(addr, content.addrComment, &content.addrCommentAuto);
+}
+
+void DisassemblyPopupBuilderThread::run()
+{
+    while(!mStopThread)
+    {
+        mRequestMutex.lock();
+        duint addr = mRequestAddr;
+        unsigned int maxInstructions = mMaxInstructions;
+        bool changed = mRequestChanged;
+        bool configChanged = mConfigChanged;
+        mRequestChanged = false;
+        mConfigChanged = false;
+        mRequestMutex.unlock();
+        if(configChanged)
+            mDisasm.UpdateConfig();
+        if(changed && addr != 0)
+        {
+            DisassemblyPopupContent content;
+            disassembleContent(addr, maxInstructions, content);
+            mRequestMutex.lock();
+            bool publish = !mRequestChanged; //a newer request supersedes this result
+            if(publish)
+            {
+                mResult = std::move(content);
+                mHasResult = true;
+            }
+            mRequestMutex.unlock();
+            if(publish)
+                emit contentReady();
+        }
+        Sleep(10);
+    }
+}
+
 DisassemblyPopup::DisassemblyPopup(QWidget* parent) :
     QFrame(parent, Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::WindowDoesNotAcceptFocus),
-    mFontMetrics(nullptr),
-    mDisasm(ConfigUint("Disassembler", "MaxModuleSize"))
+    mFontMetrics(nullptr)
 {
     addr = 0;
     addrText = nullptr;
+    mBuilder = new DisassemblyPopupBuilderThread(this);
+    connect(mBuilder, SIGNAL(contentReady()), this, SLOT(contentReadySlot()));
     connect(Config(), SIGNAL(fontsUpdated()), this, SLOT(updateFont()));
     connect(Config(), SIGNAL(colorsUpdated()), this, SLOT(updateColors()));
     connect(Config(), SIGNAL(tokenizerConfigUpdated()), this, SLOT(tokenizerConfigUpdated()));
+    connect(Bridge::getBridge(), SIGNAL(updatePatches()), this, SLOT(invalidateCache()));
+    connect(Bridge::getBridge(), SIGNAL(dbgStateChanged(DBGSTATE)), this, SLOT(invalidateCache()));
     updateFont();
     updateColors();
     setFrameStyle(QFrame::Panel);
     setLineWidth(2);
     mMaxInstructions = 20;
+    mMaxCachedContent = 256;
+    mBuilder->start();
 }
 
 void DisassemblyPopup::updateColors()
@@ -35,11 +192,18 @@ void DisassemblyPopup::updateColors()
     QPalette palette;
     palette.setColor(QPalette::Foreground, ConfigColor("AbstractTableViewSeparatorColor"));
     setPalette(palette);
+    invalidateCache(); //cached rich text carries the old colors
 }
 
 void DisassemblyPopup::tokenizerConfigUpdated()
 {
-    mDisasm.UpdateConfig();
+    mBuilder->tokenizerConfigUpdated();
+    invalidateCache();
+}
+
+void DisassemblyPopup::invalidateCache()
+{
+    mCache.clear();
 }
 
 void DisassemblyPopup::updateFont()
@@ -87,85 +251,69 @@ void DisassemblyPopup::paintEvent(QPaintEvent* event)
     QFrame::paintEvent(event);
 }
 
+void DisassemblyPopup::applyContent(const DisassemblyPopupContent & content)
+{
+    mDisassemblyToken = content.tokens;
+    addrText = content.addrText;
+    addrComment = content.addrComment;
+    addrCommentAuto = content.addrCommentAuto;
+    if(addrComment.length())
+        addrText.append(' ');
+    mWidth = 1;
+    // Calculate width (font metrics are owned by the GUI thread)
+    for(auto & instruction : mDisassemblyToken)
+    {
+        int currentInstructionWidth = 0;
+        for(auto & token : instruction.first)
+            currentInstructionWidth += mFontMetrics->width(token.text);
+        mWidth = std::max(mWidth, currentInstructionWidth);
+    }
+    mWidth = std::max(mWidth, mFontMetrics->width(addrText) + mFontMetrics->width(addrComment));
+    mWidth += charWidth * 6;
+    // Resize popup
+    resize(mWidth + 2, charHeight * int(mDisassemblyToken.size() + 1) + 2);
+}
+
 void DisassemblyPopup::setAddress(duint Address)
 {
     addr = Address;
-    QList<Instruction_t> instBuffer;
     mDisassemblyToken.clear();
+    addrText.clear();
+    addrComment.clear();
+    addrCommentAuto = false;
     if(addr != 0)
     {
-        mWidth = 1;
-        // Get RVA
-        auto addr = Address;
-        duint size;
-        duint base = DbgMemFindBaseAddr(addr, &size);
-        // Prepare RVA of every instruction
-        unsigned int i = 0;
-        instBuffer.clear();
-        auto nextAddr = addr;
-        bool hadBranch = false;
-        duint bestBranch = 0;
-        byte data[64];
-        do
+        auto cached = mCache.find(addr);
+        if(cached != mCache.end())
+            applyContent(cached.value());
+        else
         {
-            if(nextAddr >= base + size)
-                break;
-            if(!DbgMemRead(nextAddr, data, sizeof(data)))
-                break;
-            auto instruction = mDisasm.DisassembleAt(data, sizeof(data), 0, nextAddr);
-            if(!instruction.length)
-                break;
-            instBuffer.append(std::move(instruction));
-            if(!hadBranch || bestBranch <= nextAddr)
-            {
-                if(instruction.instStr.contains("ret"))
-                    break;
-                if(instruction.instStr.contains("jmp") && instruction.instStr.contains("["))
-                    break;
-            }
-            if(instruction.branchDestination && !instruction.instStr.contains("call") && !instruction.instStr.contains("ret"))
-            {
-                hadBranch = true;
-                if(instruction.branchDestination > bestBranch)
-                    bestBranch = instruction.branchDestination;
-            }
-            auto nextAddr2 = nextAddr + instruction.length;
-            if(nextAddr2 == nextAddr)
-                break;
-            else
-                nextAddr = nextAddr2;
-            if(DbgGetFunctionTypeAt(nextAddr - 1) == FUNC_END)
-                break;
-            i++;
+            // First hover: show the bare address right away, the builder
+            // thread delivers the disassembly through contentReadySlot
+            addrText = ToPtrString(addr);
+            mWidth = mFontMetrics->width(addrText) + charWidth * 6;
+            resize(mWidth + 2, charHeight + 2);
+            mBuilder->request(addr, mMaxInstructions);
         }
-        while(i < mMaxInstructions);
-        // Disassemble
-        for(auto & instruction : instBuffer)
-        {
-            RichTextPainter::List richText;
-            ZydisTokenizer::TokenToRichText(instruction.tokens, richText, nullptr);
-            // Calculate width
-            int currentInstructionWidth = 0;
-            for(auto & token : richText)
-                currentInstructionWidth += mFontMetrics->width(token.text);
-            mWidth = std::max(mWidth, currentInstructionWidth);
-            mDisassemblyToken.push_back(std::make_pair(std::move(richText), DbgFunctions()->GetTraceRecordHitCount(instruction.rva) != 0));
-        }
-        // Address
-        addrText = getSymbolicName(addr);
-        // Comments
-        GetCommentFormat(addr, addrComment, &addrCommentAuto);
-        if(addrComment.length())
-            addrText.append(' ');
-        // Calculate width of address
-        mWidth = std::max(mWidth, mFontMetrics->width(addrText) + mFontMetrics->width(addrComment));
-        mWidth += charWidth * 6;
-        // Resize popup
-        resize(mWidth + 2, charHeight * int(mDisassemblyToken.size() + 1) + 2);
     }
     update();
 }
 
+void DisassemblyPopup::contentReadySlot()
+{
+    DisassemblyPopupContent content;
+    if(!mBuilder->takeResult(content))
+        return;
+    if(mCache.size() >= mMaxCachedContent)
+        mCache.clear();
+    mCache.insert(content.addr, content);
+    if(content.addr == addr)
+    {
+        applyContent(content);
+        update();
+    }
+}
+
 duint DisassemblyPopup::getAddress()
 {
     return addr;
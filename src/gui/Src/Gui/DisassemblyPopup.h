@@ -2,11 +2,56 @@
 #define DISASSEMBLYPOPUP_H
 
 #include <QFrame>
+#include <QThread>
+#include <QMutex>
+#include <QMap>
 #include "Imports.h"
 #include "QBeaEngine.h"
 
 class CachedFontMetrics;
 
+// Preview content for one destination address, built off the GUI thread
+struct DisassemblyPopupContent
+{
+    duint addr = 0;
+    QString addrText;
+    QString addrComment;
+    bool addrCommentAuto = false;
+    std::vector<std::pair<RichTextPainter::List, bool>> tokens; //rich text + traced flag per instruction
+};
+
+class DisassemblyPopupBuilderThread : public QThread
+{
+    Q_OBJECT
+public:
+    DisassemblyPopupBuilderThread(QObject* parent = 0);
+    ~DisassemblyPopupBuilderThread();
+    void start();
+    void stop();
+    void request(duint addr, unsigned int maxInstructions);
+    bool takeResult(DisassemblyPopupContent & content);
+
+public slots:
+    void tokenizerConfigUpdated();
+
+signals:
+    void contentReady();
+
+private:
+    QMutex mRequestMutex;
+    duint mRequestAddr;
+    unsigned int mMaxInstructions;
+    bool mRequestChanged;
+    bool mConfigChanged;
+    bool mHasResult;
+    DisassemblyPopupContent mResult;
+    volatile bool mStopThread;
+    QBeaEngine mDisasm;
+
+    void disassembleContent(duint addr, unsigned int maxInstructions, DisassemblyPopupContent & content);
+    void run();
+};
+
 class DisassemblyPopup : public QFrame
 {
     Q_OBJECT
@@ -21,8 +66,12 @@ public slots:
     void updateFont();
     void updateColors();
     void tokenizerConfigUpdated();
+    void invalidateCache();
+    void contentReadySlot();
 
 protected:
+    void applyContent(const DisassemblyPopupContent & content);
+
     CachedFontMetrics* mFontMetrics;
     duint addr;
     QString addrText;
@@ -32,6 +81,7 @@ protected:
     int charHeight;
     int mWidth;
     unsigned int mMaxInstructions;
+    int mMaxCachedContent;
 
     QColor disassemblyBackgroundColor;
     QColor disassemblyTracedColor;
@@ -41,7 +91,9 @@ protected:
     QColor commentBackgroundColor;
     QColor commentAutoColor;
     QColor commentAutoBackgroundColor;
-    QBeaEngine mDisasm;
+    DisassemblyPopupBuilderThread* mBuilder;
+    // content cache keyed by destination address so repeat hovers are instant
+    QMap<duint, DisassemblyPopupContent> mCache;
 
     std::vector<std::pair<RichTextPainter::List, bool>> mDisassemblyToken;
 };
@@ -12,7 +12,7 @@
 #include "MessagesBreakpoints.h"
 #include <QVBoxLayout>
 
-HandlesView::HandlesView(QWidget* parent) : QWidget(parent)
+HandlesView::HandlesView(QWidget* parent) : QWidget(parent), mEnumBusy(false)
 {
     // Setup handles list
     mHandlesTable = new StdSearchListView(this, true, true);
@@ -128,6 +128,7 @@ HandlesView::HandlesView(QWidget* parent) : QWidget(parent)
     connect(mPrivilegesTable, SIGNAL(contextMenuSignal(const QPoint &)), this, SLOT(privilegesTableContextMenuSlot(const QPoint &)));
     connect(Config(), SIGNAL(shortcutsUpdated()), this, SLOT(refreshShortcuts()));
     connect(Bridge::getBridge(), SIGNAL(dbgStateChanged(DBGSTATE)), this, SLOT(dbgStateChanged(DBGSTATE)));
+    connect(this, SIGNAL(enumDataReady()), this, SLOT(applyEnumDataSlot()), Qt::QueuedConnection);
 
     if(!IsWindowsVistaOrGreater())
     {
@@ -140,13 +141,18 @@ HandlesView::HandlesView(QWidget* parent) : QWidget(parent)
     refreshShortcuts();
 }
 
+HandlesView::~HandlesView()
+{
+    if(mEnumThread.joinable())
+        mEnumThread.join();
+}
+
 void HandlesView::reloadData()
 {
     if(DbgIsDebugging())
     {
-        enumHandles();
+        startEnumThread();
         enumWindows();
-        enumTcpConnections();
         //enumHeaps();
         enumPrivileges();
     }
@@ -154,10 +160,12 @@ void HandlesView::reloadData()
     {
         mHandlesTable->setRowCount(0);
         mHandlesTable->reloadData();
+        mHandleRowCache.clear();
         mWindowsTable->setRowCount(0);
         mWindowsTable->reloadData();
         mTcpConnectionsTable->setRowCount(0);
         mTcpConnectionsTable->reloadData();
+        mTcpRowCache.clear();
 
         //mHeapsTable->setRowCount(0);
         //mHeapsTable->reloadData();
@@ -292,7 +300,7 @@ void HandlesView::privilegesTableContextMenuSlot(const QPoint & pos)
 void HandlesView::closeHandleSlot()
 {
     DbgCmdExecDirect(QString("handleclose %1").arg(mHandlesTable->mCurList->getCellContent(mHandlesTable->mCurList->getInitialSelection(), 2)));
-    enumHandles();
+    startEnumThread();
 }
 
 void HandlesView::enablePrivilegeSlot()
@@ -389,32 +397,94 @@ void HandlesView::messagesBPSlot()
 }
 
 //Enum functions
-//Enumerate handles and update handles table
-void HandlesView::enumHandles()
+//Start the background enumeration of handles and TCP connections. Querying
+//the name of every handle can stall for seconds on handle-heavy targets, so
+//it must not run on the GUI thread.
+void HandlesView::startEnumThread()
+{
+    if(mEnumBusy.exchange(true))
+        return; //an enumeration is already in flight
+    if(mEnumThread.joinable())
+        mEnumThread.join();
+    mEnumThread = std::thread([this]()
+    {
+        enumThreadProc();
+    });
+}
+
+//Gather the handle and TCP connection rows (runs on the enumeration thread)
+void HandlesView::enumThreadProc()
 {
+    mPendingHandleRows.clear();
     BridgeList<HANDLEINFO> handles;
     if(DbgFunctions()->EnumHandles(&handles))
     {
         auto count = handles.Count();
-        mHandlesTable->setRowCount(count);
+        mPendingHandleRows.reserve(count);
         for(auto i = 0; i < count; i++)
         {
             const HANDLEINFO & handle = handles[i];
             char name[MAX_STRING_SIZE] = "";
             char typeName[MAX_STRING_SIZE] = "";
             DbgFunctions()->GetHandleName(handle.Handle, name, sizeof(name), typeName, sizeof(typeName));
-            mHandlesTable->setCellContent(i, 0, typeName);
-            mHandlesTable->setCellContent(i, 1, ToHexString(handle.TypeNumber));
-            mHandlesTable->setCellContent(i, 2, ToHexString(handle.Handle));
-            mHandlesTable->setCellContent(i, 3, ToHexString(handle.GrantedAccess));
-            mHandlesTable->setCellContent(i, 4, name);
+            QStringList row;
+            row << typeName << ToHexString(handle.TypeNumber) << ToHexString(handle.Handle) << ToHexString(handle.GrantedAccess) << name;
+            mPendingHandleRows.append(row);
         }
     }
-    else
-        mHandlesTable->setRowCount(0);
-    mHandlesTable->reloadData();
+
+    mPendingTcpRows.clear();
+    BridgeList<TCPCONNECTIONINFO> connections;
+    if(DbgFunctions()->EnumTcpConnections(&connections))
+    {
+        auto count = connections.Count();
+        mPendingTcpRows.reserve(count);
+        for(auto i = 0; i < count; i++)
+        {
+            const TCPCONNECTIONINFO & connection = connections[i];
+            QStringList row;
+            row << QString("%1:%2").arg(connection.RemoteAddress).arg(connection.RemotePort);
+            row << QString("%1:%2").arg(connection.LocalAddress).arg(connection.LocalPort);
+            row << connection.StateText;
+            mPendingTcpRows.append(row);
+        }
+    }
+
+    emit enumDataReady();
+}
+
+//Update only the rows that differ from what the table currently shows
+template<typename TableType>
+static void applyRowDiff(TableType* table, QList<QStringList> & shown, const QList<QStringList> & rows)
+{
+    bool changed = shown.size() != rows.size();
+    if(changed)
+        table->setRowCount(rows.size());
+    for(int i = 0; i < rows.size(); i++)
+    {
+        if(i < shown.size() && shown.at(i) == rows.at(i))
+            continue;
+        changed = true;
+        for(int j = 0; j < rows.at(i).size(); j++)
+            table->setCellContent(i, j, rows.at(i).at(j));
+    }
+    shown = rows;
+    if(!changed)
+        return;
+    table->reloadData();
     // refresh values also when in mSearchList
-    mHandlesTable->refreshSearchList();
+    table->refreshSearchList();
+}
+
+//Apply the rows produced by the enumeration thread to the tables
+void HandlesView::applyEnumDataSlot()
+{
+    if(DbgIsDebugging())
+    {
+        applyRowDiff(mHandlesTable, mHandleRowCache, mPendingHandleRows);
+        applyRowDiff(mTcpConnectionsTable, mTcpRowCache, mPendingTcpRows);
+    }
+    mEnumBusy = false;
 }
 
 static QIcon getWindowIcon(HWND hWnd)
@@ -522,31 +592,6 @@ void HandlesView::enumPrivileges()
     mPrivilegesTable->reloadData();
 }
 
-//Enumerate TCP connections and update TCP connections table
-void HandlesView::enumTcpConnections()
-{
-    BridgeList<TCPCONNECTIONINFO> connections;
-    if(DbgFunctions()->EnumTcpConnections(&connections))
-    {
-        auto count = connections.Count();
-        mTcpConnectionsTable->setRowCount(count);
-        for(auto i = 0; i < count; i++)
-        {
-            const TCPCONNECTIONINFO & connection = connections[i];
-            auto remoteText = QString("%1:%2").arg(connection.RemoteAddress).arg(connection.RemotePort);
-            mTcpConnectionsTable->setCellContent(i, 0, remoteText);
-            auto localText = QString("%1:%2").arg(connection.LocalAddress).arg(connection.LocalPort);
-            mTcpConnectionsTable->setCellContent(i, 1, localText);
-            mTcpConnectionsTable->setCellContent(i, 2, connection.StateText);
-        }
-    }
-    else
-        mTcpConnectionsTable->setRowCount(0);
-    mTcpConnectionsTable->reloadData();
-    // refresh values also when in mSearchList
-    mTcpConnectionsTable->refreshSearchList();
-}
-
 /*
 //Enumerate Heaps and update Heaps table
 void HandlesView::enumHeaps()
@@ -2,6 +2,9 @@
 #define HANDLESVIEW_H
 
 #include <QWidget>
+#include <QStringList>
+#include <thread>
+#include <atomic>
 #include "Imports.h"
 
 class StdTable;
@@ -17,6 +20,10 @@ class HandlesView : public QWidget
     Q_OBJECT
 public:
     explicit HandlesView(QWidget* parent = nullptr);
+    ~HandlesView();
+
+signals:
+    void enumDataReady();
 
 public slots:
     void reloadData();
@@ -38,6 +45,7 @@ public slots:
     void followInDisasmSlot();
     void toggleBPSlot();
     void messagesBPSlot();
+    void applyEnumDataSlot();
 
 private:
     QVBoxLayout* mVertLayout;
@@ -60,11 +68,22 @@ private:
     QAction* mActionToggleProcBP;
     QAction* mActionMessageProcBP;
 
-    void enumHandles();
     void enumWindows();
-    void enumTcpConnections();
     //void enumHeaps();
     void enumPrivileges();
+
+    //Handle and TCP connection enumeration runs on a background thread,
+    //querying the name of every handle can stall for seconds on
+    //handle-heavy targets. The thread produces formatted rows and the
+    //GUI thread applies them as a diff against what is shown.
+    void startEnumThread();
+    void enumThreadProc();
+    std::thread mEnumThread;
+    std::atomic<bool> mEnumBusy;
+    QList<QStringList> mPendingHandleRows;
+    QList<QStringList> mPendingTcpRows;
+    QList<QStringList> mHandleRowCache;
+    QList<QStringList> mTcpRowCache;
 };
 
 #endif // HANDLESVIEW_H
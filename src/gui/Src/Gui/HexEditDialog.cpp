@@ -1,5 +1,6 @@
 #include <QTextCodec>
 #include <QCryptographicHash>
+#include <QTimer>
 #include "Configuration.h"
 #include "HexEditDialog.h"
 #include "QHexEdit/QHexEdit.h"
@@ -41,6 +42,14 @@ HexEditDialog::HexEditDialog(QWidget* parent) : QDialog(parent), ui(new Ui::HexE
     mHexEdit->widget()->setFocus();
     connect(mHexEdit, SIGNAL(dataChanged()), this, SLOT(dataChangedSlot()));
     connect(mHexEdit, SIGNAL(dataEdited()), this, SLOT(dataEditedSlot()));
+
+    // Re-encoding every representation (ASCII/Unicode/codepage/string
+    // editor/data copy preview) is linear in the buffer size, so edits only
+    // schedule a sync and the work runs once per burst of changes
+    mDataSyncTimer = new QTimer(this);
+    mDataSyncTimer->setSingleShot(true);
+    mDataSyncTimer->setInterval(200);
+    connect(mDataSyncTimer, SIGNAL(timeout()), this, SLOT(dataSyncTimerSlot()));
     connect(ui->btnCodePage2, SIGNAL(clicked()), this, SLOT(on_btnCodepage_clicked()));
     connect(ui->chkCRLF, SIGNAL(clicked()), this, SLOT(on_stringEditor_textChanged()));
 
@@ -187,6 +196,11 @@ void HexEditDialog::dataChangedSlot()
 }
 
 void HexEditDialog::dataEditedSlot()
+{
+    mDataSyncTimer->start(); //restarts the timer on every edit
+}
+
+void HexEditDialog::dataSyncTimerSlot()
 {
     QByteArray data = mHexEdit->data();
     ui->lineEditAscii->setData(data);
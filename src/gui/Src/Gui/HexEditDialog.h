@@ -4,6 +4,8 @@
 #include <QDialog>
 #include "QHexEdit/QHexEdit.h"
 
+class QTimer;
+
 namespace Ui
 {
     class HexEditDialog;
@@ -31,6 +33,7 @@ private slots:
     void on_chkKeepSize_toggled(bool checked);
     void dataChangedSlot();
     void dataEditedSlot();
+    void dataSyncTimerSlot();
     void on_lineEditAscii_dataEdited();
     void on_lineEditUnicode_dataEdited();
     void on_lineEditCodepage_dataEdited();
@@ -45,6 +48,7 @@ private:
     bool stringEditorLock;
 
     bool mDataInitialized;
+    QTimer* mDataSyncTimer;
 
     QByteArray resizeData(QByteArray & data);
     bool checkDataRepresentable(int mode); //1=ASCII, 2=Unicode, 3=User-selected codepage, 4=String editor, others(0)=All modes
@@ -149,7 +149,7 @@ void LocalVarsView::updateSlot()
         return;
     }
     REGDUMP z;
-    DbgGetRegDumpEx(&z, sizeof(REGDUMP));
+    DbgGetRegDumpBasic(&z); //only cip and the GP frame registers are consumed here
     duint start, end;
 
     if(DbgFunctionGet(z.regcontext.cip, &start, &end))
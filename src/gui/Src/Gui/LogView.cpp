@@ -53,11 +53,83 @@ LogView::LogView(QWidget* parent) : QTextBrowser(parent), logRedirection(NULL)
  */
 LogView::~LogView()
 {
+    stopRedirectWriter();
+}
+
+void LogView::startRedirectWriter()
+{
+    mRedirectStop = false;
+    mRedirectFailed = false;
+    mRedirectWriter = std::thread([this]()
+    {
+        redirectWriterLoop();
+    });
+}
+
+/**
+ * @brief LogView::stopRedirectWriter Stop the writer thread after draining the pending data and close the redirection file.
+ */
+void LogView::stopRedirectWriter()
+{
+    if(mRedirectWriter.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mRedirectMutex);
+            mRedirectStop = true;
+        }
+        mRedirectWake.notify_one();
+        mRedirectWriter.join();
+    }
     if(logRedirection != NULL)
         fclose(logRedirection);
     logRedirection = NULL;
 }
 
+void LogView::redirectAppend(const char* data, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(mRedirectMutex);
+        mRedirectBuffer.append(data, int(size));
+    }
+    mRedirectWake.notify_one();
+}
+
+/**
+ * @brief LogView::redirectWriterLoop Double-buffered writer loop: swaps the pending buffer out under the lock and
+ * performs the fwrite outside of it, flushing to disk at most once a second, so producers only pay for a memory append.
+ */
+void LogView::redirectWriterLoop()
+{
+    QByteArray pending;
+    auto lastFlush = GetTickCount();
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mRedirectMutex);
+            mRedirectWake.wait(lock, [this]()
+            {
+                return mRedirectStop || !mRedirectBuffer.isEmpty();
+            });
+            pending.swap(mRedirectBuffer);
+            if(pending.isEmpty() && mRedirectStop)
+                break;
+        }
+        if(!pending.isEmpty() && !mRedirectFailed)
+        {
+            if(fwrite(pending.constData(), pending.size(), 1, logRedirection) != 1)
+                mRedirectFailed = true;
+            auto now = GetTickCount();
+            if(now - lastFlush >= 1000)
+            {
+                fflush(logRedirection);
+                lastFlush = now;
+            }
+        }
+        pending.clear();
+    }
+    fflush(logRedirection);
+}
+
 void LogView::updateStyle()
 {
     setFont(ConfigFont("Log"));
@@ -202,12 +274,7 @@ void LogView::addMsgToLogSlot(QByteArray msg)
         {
             msgUtf16 = QString::fromUtf8(msg);
             msgUtf16.replace("\n", "\r\n");
-            if(!fwrite(msgUtf16.utf16(), msgUtf16.length(), 2, logRedirection))
-            {
-                fclose(logRedirection);
-                logRedirection = NULL;
-                redirectError = true;
-            }
+            redirectAppend((const char*)msgUtf16.utf16(), msgUtf16.length() * 2);
         }
         else
         {
@@ -234,15 +301,15 @@ void LogView::addMsgToLogSlot(QByteArray msg)
                 data = msg.constData();
                 buffersize = strlen(msg);
             }
-            if(!fwrite(data, buffersize, 1, logRedirection))
-            {
-                fclose(logRedirection);
-                logRedirection = NULL;
-                redirectError = true;
-            }
+            redirectAppend(data, buffersize);
             if(loggingEnabled)
                 msgUtf16 = QString::fromUtf8(data, int(buffersize));
         }
+        if(mRedirectFailed)
+        {
+            stopRedirectWriter();
+            redirectError = true;
+        }
     }
     else
         msgUtf16 = QString::fromUtf8(msg);
@@ -267,7 +334,12 @@ void LogView::addMsgToLogSlot(QByteArray msg)
         msgUtf16.append(tr("fwrite() failed (GetLastError()= %1 ). Log redirection stopped.\n").arg(GetLastError()));
 
     if(logBuffer.length() >= MAX_LOG_BUFFER_SIZE)
-        logBuffer.clear();
+    {
+        // The flush cannot keep up: drop the oldest half of the pending
+        // lines instead of throwing away the whole buffer
+        auto cut = logBuffer.indexOf("<br/>\n", logBuffer.length() / 2);
+        logBuffer.remove(0, cut < 0 ? logBuffer.length() / 2 : cut + 6);
+    }
 
     logBuffer.append(msgUtf16);
     if(flushLog)
@@ -321,8 +393,7 @@ void LogView::redirectLogSlot()
 {
     if(logRedirection != NULL)
     {
-        fclose(logRedirection);
-        logRedirection = NULL;
+        stopRedirectWriter();
     }
     else
     {
@@ -340,6 +411,7 @@ void LogView::redirectLogSlot()
                     fwrite(&BOM, 2, 1, logRedirection);
                 }
                 GuiAddLogMessage(tr("Log will be redirected to %1.\n").arg(browse.path).toUtf8().constData());
+                startRedirectWriter();
             }
         }
     }
@@ -430,14 +502,6 @@ void LogView::flushTimerSlot()
     if(logBuffer.isEmpty())
         return;
     setUpdatesEnabled(false);
-    static unsigned char counter = 100;
-    counter--;
-    if(counter == 0)
-    {
-        if(document()->characterCount() > MAX_LOG_BUFFER_SIZE)
-            clear();
-        counter = 100;
-    }
     QTextCursor cursor(document());
     cursor.movePosition(QTextCursor::End);
     cursor.beginEditBlock();
@@ -446,6 +510,21 @@ void LogView::flushTimerSlot()
     cursor.deletePreviousChar();
     cursor.insertHtml(logBuffer);
     cursor.endEditBlock();
+    // Keep the document bounded by rolling out the oldest lines, so
+    // sustained logging stays at a constant cost instead of growing the
+    // document until it has to be wiped entirely
+    int excess = document()->characterCount() - MAX_LOG_BUFFER_SIZE;
+    if(excess > 0)
+    {
+        QTextCursor trimCursor(document());
+        trimCursor.setPosition(0);
+        auto lineEnd = document()->find(QString(QChar::LineSeparator), excess);
+        if(lineEnd.isNull())
+            trimCursor.setPosition(excess, QTextCursor::KeepAnchor);
+        else
+            trimCursor.setPosition(lineEnd.selectionEnd(), QTextCursor::KeepAnchor);
+        trimCursor.removeSelectedText();
+    }
     if(autoScroll)
         moveCursor(QTextCursor::End);
     setUpdatesEnabled(true);
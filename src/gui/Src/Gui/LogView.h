@@ -3,6 +3,10 @@
 
 #include <QTextBrowser>
 #include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 class LogView : public QTextBrowser
 {
@@ -57,6 +61,21 @@ private:
     QString logBuffer;
     QTimer* flushTimer;
     bool flushLog;
+
+    // Background log file writer: messages are appended to mRedirectBuffer
+    // and written out by mRedirectWriter in large sequential chunks with
+    // periodic flushes to disk, so heavy logging never blocks the GUI
+    // thread on per-line file I/O
+    void startRedirectWriter();
+    void stopRedirectWriter();
+    void redirectWriterLoop();
+    void redirectAppend(const char* data, size_t size);
+    std::thread mRedirectWriter;
+    std::mutex mRedirectMutex;
+    std::condition_variable mRedirectWake;
+    QByteArray mRedirectBuffer;
+    bool mRedirectStop = false;
+    std::atomic<bool> mRedirectFailed {false};
 };
 
 #endif // LOGVIEW_H
@@ -1,6 +1,8 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
 #include <QMessageBox>
+#include <QElapsedTimer>
+#include <QDataStream>
 #include <QIcon>
 #include <QUrl>
 #include <QFileDialog>
@@ -58,6 +60,11 @@ MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent),
       ui(new Ui::MainWindow)
 {
+    // Startup phase report, so construction time regressions show up in the log
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+    qint64 setupMs = 0, viewsMs = 0, tabsMs = 0;
+
     ui->setupUi(this);
 
     // Build information
@@ -138,6 +145,8 @@ MainWindow::MainWindow(QWidget* parent)
     // Accept drops
     setAcceptDrops(true);
 
+    setupMs = startupTimer.elapsed();
+
     // Log view
     mLogView = new LogView();
     mLogView->setWindowTitle(tr("Log"));
@@ -225,6 +234,8 @@ MainWindow::MainWindow(QWidget* parent)
     connect(mTraceWidget->getTraceBrowser(), SIGNAL(displayReferencesWidget()), this, SLOT(displayReferencesWidget()));
     connect(mTraceWidget->getTraceBrowser(), SIGNAL(displayLogWidget()), this, SLOT(displayLogWidget()));
 
+    viewsMs = startupTimer.elapsed() - setupMs;
+
     mTabWidget = new MHTabWidget(this, true, true);
 
     // Add all widgets to the list
@@ -255,9 +266,12 @@ MainWindow::MainWindow(QWidget* parent)
     setupCommandBar();
     setupStatusBar();
 
-    // Patch dialog
-    mPatchDialog = new PatchDialog(this);
-    mCalculatorDialog = new CalculatorDialog(this);
+    tabsMs = startupTimer.elapsed() - setupMs - viewsMs;
+
+    // The patch, calculator and trace dialogs are constructed on first use
+    mPatchDialog = nullptr;
+    mCalculatorDialog = nullptr;
+    mSimpleTraceDialog = nullptr;
 
     // Setup signals/slots
     connect(mCmdLineEdit, SIGNAL(returnPressed()), this, SLOT(executeCommand()));
@@ -375,8 +389,6 @@ MainWindow::MainWindow(QWidget* parent)
     defaultSettings.SaveSettings();
     // Don't need to set shortcuts because the code above will signal refreshShortcuts()
 
-    mSimpleTraceDialog = new SimpleTraceDialog(this);
-
     // Update checker
     mUpdateChecker = new UpdateChecker(this);
 
@@ -388,6 +400,10 @@ MainWindow::MainWindow(QWidget* parent)
 
     mCpuWidget->setDisasmFocus();
 
+    auto totalMs = startupTimer.elapsed();
+    GuiAddLogMessage(tr("MainWindow constructed in %1ms (setup: %2ms, views: %3ms, tabs: %4ms, actions+settings: %5ms)\n")
+                     .arg(totalMs).arg(setupMs).arg(viewsMs).arg(tabsMs).arg(totalMs - setupMs - viewsMs - tabsMs).toUtf8().constData());
+
     QTimer::singleShot(0, this, SLOT(loadWindowSettings()));
 }
 
@@ -727,37 +743,108 @@ void MainWindow::clearTabWidget()
 
 void MainWindow::saveWindowSettings()
 {
-    // Main Window settings
-    BridgeSettingSet("Main Window Settings", "Geometry", saveGeometry().toBase64().data());
-    BridgeSettingSet("Main Window Settings", "State", saveState().toBase64().data());
+    // One versioned blob for the whole layout so loadWindowSettings needs a
+    // single settings read instead of several per tab (see layoutVersion there)
+    QByteArray layout;
+    QDataStream stream(&layout, QIODevice::WriteOnly);
+    stream << (quint32)1;
+    stream << saveGeometry();
+    stream << saveState();
 
     // Set of currently detached tabs
     QSet<QWidget*> detachedTabWindows = mTabWidget->windows().toSet();
 
     // For all tabs, save detached status.  If detached, save geometry.
+    stream << (quint32)mWidgetList.size();
     for(int i = 0; i < mWidgetList.size(); i++)
     {
         bool isDetached = detachedTabWindows.contains(mWidgetList[i].widget);
         bool isDeleted = !isDetached && mTabWidget->indexOf(mWidgetList[i].widget) == -1;
-        BridgeSettingSetUint("Detached Windows", mWidgetList[i].nativeName.toUtf8().constData(), isDetached);
-        BridgeSettingSetUint("Deleted Tabs", mWidgetList[i].nativeName.toUtf8().constData(), isDeleted);
-        if(isDetached)
-            BridgeSettingSet("Tab Window Settings", mWidgetList[i].nativeName.toUtf8().constData(),
-                             mWidgetList[i].widget->parentWidget()->saveGeometry().toBase64().data());
+        stream << mWidgetList[i].nativeName;
+        stream << isDetached;
+        stream << isDeleted;
+        stream << (isDetached ? mWidgetList[i].widget->parentWidget()->saveGeometry() : QByteArray());
     }
 
     // Save favourite toolbar
-    BridgeSettingSetUint("Main Window Settings", "FavToolbarPositionX", mFavouriteToolbar->x());
-    BridgeSettingSetUint("Main Window Settings", "FavToolbarPositionY", mFavouriteToolbar->y());
-    BridgeSettingSetUint("Main Window Settings", "FavToolbarVisible", mFavouriteToolbar->isVisible() ? 1 : 0);
+    stream << (qint32)mFavouriteToolbar->x();
+    stream << (qint32)mFavouriteToolbar->y();
+    stream << mFavouriteToolbar->isVisible();
+
+    BridgeSettingSet("Main Window Settings", "Layout", layout.toBase64().data());
 
     mCpuWidget->saveWindowSettings();
     mSymbolView->saveWindowSettings();
 }
 
+// Apply a layout blob produced by saveWindowSettings, returns false when the
+// blob is missing or from an incompatible version
+bool MainWindow::loadWindowLayout()
+{
+    char setting[MAX_SETTING_SIZE] = "";
+    if(!BridgeSettingGet("Main Window Settings", "Layout", setting))
+        return false;
+    QByteArray layout = QByteArray::fromBase64(QByteArray(setting));
+    QDataStream stream(&layout, QIODevice::ReadOnly);
+    quint32 layoutVersion = 0;
+    stream >> layoutVersion;
+    if(layoutVersion != 1)
+        return false;
+
+    QByteArray geometry, state;
+    stream >> geometry;
+    stream >> state;
+    restoreGeometry(geometry);
+    restoreState(state);
+
+    quint32 tabCount = 0;
+    stream >> tabCount;
+    for(quint32 i = 0; i < tabCount; i++)
+    {
+        QString nativeName;
+        bool isDetached = false, isDeleted = false;
+        QByteArray tabGeometry;
+        stream >> nativeName;
+        stream >> isDetached;
+        stream >> isDeleted;
+        stream >> tabGeometry;
+        for(int j = 0; j < mWidgetList.size(); j++)
+        {
+            if(mWidgetList[j].nativeName != nativeName)
+                continue;
+            if(isDetached)
+            {
+                mTabWidget->DetachTab(mTabWidget->indexOf(mWidgetList[j].widget), QPoint());
+                mWidgetList[j].widget->parentWidget()->restoreGeometry(tabGeometry);
+            }
+            else if(isDeleted)
+                mTabWidget->DeleteTab(mTabWidget->indexOf(mWidgetList[j].widget));
+            break;
+        }
+    }
+
+    qint32 posx = 0, posy = 0;
+    bool toolbarVisible = false;
+    stream >> posx;
+    stream >> posy;
+    stream >> toolbarVisible;
+    if(stream.status() != QDataStream::Ok)
+        return false;
+    mFavouriteToolbar->move(posx, posy);
+    mFavouriteToolbar->setVisible(toolbarVisible);
+    return true;
+}
+
 void MainWindow::loadWindowSettings()
 {
-    // Main Window settings
+    if(loadWindowLayout())
+    {
+        mCpuWidget->loadWindowSettings();
+        mSymbolView->loadWindowSettings();
+        return;
+    }
+
+    // Legacy format: every piece of state is a separate setting
     char setting[MAX_SETTING_SIZE] = "";
     if(BridgeSettingGet("Main Window Settings", "Geometry", setting))
         restoreGeometry(QByteArray::fromBase64(QByteArray(setting)));
@@ -966,6 +1053,8 @@ void MainWindow::execTicnd()
 {
     if(!DbgIsDebugging())
         return;
+    if(!mSimpleTraceDialog)
+        mSimpleTraceDialog = new SimpleTraceDialog(this);
     mSimpleTraceDialog->setTraceCommand("TraceIntoConditional");
     mSimpleTraceDialog->setWindowTitle(tr("Trace into..."));
     mSimpleTraceDialog->setWindowIcon(DIcon("traceinto.png"));
@@ -976,6 +1065,8 @@ void MainWindow::execTocnd()
 {
     if(!DbgIsDebugging())
         return;
+    if(!mSimpleTraceDialog)
+        mSimpleTraceDialog = new SimpleTraceDialog(this);
     mSimpleTraceDialog->setTraceCommand("TraceOverConditional");
     mSimpleTraceDialog->setWindowTitle(tr("Trace over..."));
     mSimpleTraceDialog->setWindowIcon(DIcon("traceover.png"));
@@ -1164,6 +1255,8 @@ void MainWindow::openAppearance()
 
 void MainWindow::openCalculator()
 {
+    if(!mCalculatorDialog)
+        mCalculatorDialog = new CalculatorDialog(this);
     mCalculatorDialog->showNormal();
     mCalculatorDialog->setFocus();
     mCalculatorDialog->setExpressionFocus();
@@ -1583,6 +1676,8 @@ void MainWindow::patchWindow()
         SimpleErrorBox(this, tr("Error!"), tr("Patches cannot be shown when not debugging..."));
         return;
     }
+    if(!mPatchDialog)
+        mPatchDialog = new PatchDialog(this);
     GuiUpdatePatches();
     mPatchDialog->showNormal();
     mPatchDialog->setFocus();
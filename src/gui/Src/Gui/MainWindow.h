@@ -51,6 +51,7 @@ public:
     void setupStatusBar();
     void closeEvent(QCloseEvent* event);
     void setTab(QWidget* widget);
+    bool loadWindowLayout();
     void loadTabDefaultOrder();
     void loadTabSavedOrder();
     void clearTabWidget();
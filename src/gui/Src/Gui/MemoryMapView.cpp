@@ -39,9 +39,23 @@ MemoryMapView::MemoryMapView(StdTable* parent)
     connect(Bridge::getBridge(), SIGNAL(focusMemmap()), this, SLOT(setFocus()));
     connect(this, SIGNAL(contextMenuSignal(QPoint)), this, SLOT(contextMenuSlot(QPoint)));
 
+    updateColors();
     setupContextMenu();
 }
 
+void MemoryMapView::updateColors()
+{
+    StdTable::updateColors();
+
+    mBreakpointColor = ConfigColor("MemoryMapBreakpointColor");
+    mBreakpointBackgroundColor = ConfigColor("MemoryMapBreakpointBackgroundColor");
+    mCipColor = ConfigColor("MemoryMapCipColor");
+    mCipBackgroundColor = ConfigColor("MemoryMapCipBackgroundColor");
+    mSectionTextColor = ConfigColor("MemoryMapSectionTextColor");
+    mUserModuleColor = ConfigColor("SymbolUserTextColor");
+    mSystemModuleColor = ConfigColor("SymbolSystemTextColor");
+}
+
 void MemoryMapView::setupContextMenu()
 {
     //Follow in Dump
@@ -254,13 +268,21 @@ void MemoryMapView::contextMenuSlot(const QPoint & pos)
 
 QString MemoryMapView::getProtectionString(DWORD Protect)
 {
+    // The same handful of protection values covers the whole map
+    auto found = mProtectionCache.find(Protect);
+    if(found != mProtectionCache.end())
+        return found.value();
+
 #define RIGHTS_STRING (sizeof("ERWCG") + 1)
     char rights[RIGHTS_STRING];
 
+    QString result;
     if(!DbgFunctions()->PageRightsToString(Protect, rights))
-        return "bad";
-
-    return QString(rights);
+        result = "bad";
+    else
+        result = QString(rights);
+    mProtectionCache.insert(Protect, result);
+    return result;
 }
 
 QString MemoryMapView::paintContent(QPainter* painter, dsint rowBase, int rowOffset, int col, int x, int y, int w, int h)
@@ -279,18 +301,18 @@ QString MemoryMapView::paintContent(QPainter* painter, dsint rowBase, int rowOff
         bool isCip = addr == mCipBase;
         if(isCip && isBp)
         {
-            color = ConfigColor("MemoryMapBreakpointBackgroundColor");
-            backgroundColor = ConfigColor("MemoryMapCipBackgroundColor");
+            color = mBreakpointBackgroundColor;
+            backgroundColor = mCipBackgroundColor;
         }
         else if(isBp)
         {
-            color = ConfigColor("MemoryMapBreakpointColor");
-            backgroundColor = ConfigColor("MemoryMapBreakpointBackgroundColor");
+            color = mBreakpointColor;
+            backgroundColor = mBreakpointBackgroundColor;
         }
         else if(isCip)
         {
-            color = ConfigColor("MemoryMapCipColor");
-            backgroundColor = ConfigColor("MemoryMapCipBackgroundColor");
+            color = mCipColor;
+            backgroundColor = mCipBackgroundColor;
         }
         else if(isSelected(rowBase, rowOffset) == true)
             painter->fillRect(QRect(x, y, w, h), QBrush(mSelectionColor));
@@ -307,14 +329,14 @@ QString MemoryMapView::paintContent(QPainter* painter, dsint rowBase, int rowOff
         auto addr = getCellUserdata(rowBase + rowOffset, 0);
         if(wStr.startsWith(" \""))
         {
-            painter->setPen(ConfigColor("MemoryMapSectionTextColor"));
+            painter->setPen(mSectionTextColor);
             painter->drawText(QRect(x + 4, y, getColumnWidth(col) - 4, getRowHeight()), Qt::AlignVCenter | Qt::AlignLeft, wStr);
             return QString();
         }
         else if(DbgFunctions()->ModBaseFromAddr(addr) == addr) // module header page
         {
             auto party = DbgFunctions()->ModGetParty(addr);
-            painter->setPen(ConfigColor(party == mod_user ? "SymbolUserTextColor" : "SymbolSystemTextColor"));
+            painter->setPen(party == mod_user ? mUserModuleColor : mSystemModuleColor);
             painter->drawText(QRect(x + 4, y, getColumnWidth(col) - 4, getRowHeight()), Qt::AlignVCenter | Qt::AlignLeft, wStr);
             return QString();
         }
@@ -324,7 +346,7 @@ QString MemoryMapView::paintContent(QPainter* painter, dsint rowBase, int rowOff
         QString wStr = StdTable::paintContent(painter, rowBase, rowOffset, col, x, y, w, h);;
         if(!ConfigBool("Engine", "ListAllPages"))
         {
-            painter->setPen(ConfigColor("MemoryMapSectionTextColor"));
+            painter->setPen(mSectionTextColor);
             painter->drawText(QRect(x + 4, y, getColumnWidth(col) - 4, getRowHeight()), Qt::AlignVCenter | Qt::AlignLeft, wStr);
             return QString();
         }
@@ -350,7 +372,7 @@ void MemoryMapView::ExecCommand()
         QString command = action->data().toString();
         if(command.contains('$'))
         {
-            for(int i : getSelection())
+            for(int i = getSelectionStart(); i <= getSelectionEnd(); i++)
             {
                 QString specializedCommand = command;
                 specializedCommand.replace(QChar('$'), ToHexString(getCellUserdata(i, 0))); // $ -> Base address
@@ -362,6 +384,73 @@ void MemoryMapView::ExecCommand()
     }
 }
 
+void MemoryMapView::formatRegionCells(duint base, RegionCacheEntry & entry)
+{
+    // Base address
+    entry.cells[0] = ToPtrString(base);
+
+    // Size
+    entry.cells[1] = ToPtrString(entry.size);
+
+    // Information
+    entry.cells[2] = entry.info;
+
+    // Content, TODO: proper section content analysis in dbg/memory.cpp:MemUpdateMap
+    QString wS;
+    if(!entry.comment.isEmpty()) // user comment present
+        wS = entry.comment;
+    else if(entry.info.contains(".bss"))
+        wS = tr("Uninitialized data");
+    else if(entry.info.contains(".data"))
+        wS = tr("Initialized data");
+    else if(entry.info.contains(".edata"))
+        wS = tr("Export tables");
+    else if(entry.info.contains(".idata"))
+        wS = tr("Import tables");
+    else if(entry.info.contains(".pdata"))
+        wS = tr("Exception information");
+    else if(entry.info.contains(".rdata"))
+        wS = tr("Read-only initialized data");
+    else if(entry.info.contains(".reloc"))
+        wS = tr("Base relocations");
+    else if(entry.info.contains(".rsrc"))
+        wS = tr("Resources");
+    else if(entry.info.contains(".text"))
+        wS = tr("Executable code");
+    else if(entry.info.contains(".tls"))
+        wS = tr("Thread-local storage");
+    else if(entry.info.contains(".xdata"))
+        wS = tr("Exception information");
+    else
+        wS = QString("");
+    entry.cells[3] = std::move(wS);
+
+    // Type
+    const char* type = "";
+    switch(entry.type)
+    {
+    case MEM_IMAGE:
+        type = "IMG";
+        break;
+    case MEM_MAPPED:
+        type = "MAP";
+        break;
+    case MEM_PRIVATE:
+        type = "PRV";
+        break;
+    default:
+        type = "N/A";
+        break;
+    }
+    entry.cells[4] = type;
+
+    // current access protection
+    entry.cells[5] = getProtectionString(entry.protect);
+
+    // allocation protection
+    entry.cells[6] = getProtectionString(entry.allocProtect);
+}
+
 void MemoryMapView::refreshMap()
 {
     MEMMAP wMemMapStruct;
@@ -371,84 +460,56 @@ void MemoryMapView::refreshMap()
 
     DbgMemMap(&wMemMapStruct);
 
+    // Remember the selected region so the selection tracks its allocation
+    // base instead of its row number when regions appear or disappear
+    duint selectedBase = getRowCount() > 0 ? getCellUserdata(getInitialSelection(), 0) : 0;
+    int selectedRow = -1;
+
     setRowCount(wMemMapStruct.count);
 
-    QString wS;
-    MEMORY_BASIC_INFORMATION wMbi;
+    // Diff the incoming map against the cached regions: rows whose region is
+    // unchanged reuse their previously formatted cells, only new or changed
+    // regions pay the string formatting
+    QHash<duint, RegionCacheEntry> newCache;
+    newCache.reserve(wMemMapStruct.count);
     for(wI = 0; wI < wMemMapStruct.count; wI++)
     {
-        wMbi = (wMemMapStruct.page)[wI].mbi;
-
-        // Base address
-        setCellContent(wI, 0, ToPtrString((duint)wMbi.BaseAddress));
-        setCellUserdata(wI, 0, (duint)wMbi.BaseAddress);
-
-        // Size
-        setCellContent(wI, 1, ToPtrString((duint)wMbi.RegionSize));
-        setCellUserdata(wI, 1, (duint)wMbi.RegionSize);
-
-        // Information
-        wS = QString((wMemMapStruct.page)[wI].info);
-        setCellContent(wI, 2, wS);
-
-        // Content, TODO: proper section content analysis in dbg/memory.cpp:MemUpdateMap
+        const MEMORY_BASIC_INFORMATION & wMbi = (wMemMapStruct.page)[wI].mbi;
+        auto base = (duint)wMbi.BaseAddress;
+
+        RegionCacheEntry entry;
+        entry.size = (duint)wMbi.RegionSize;
+        entry.type = wMbi.Type;
+        entry.protect = wMbi.Protect;
+        entry.allocProtect = wMbi.AllocationProtect;
+        entry.info = QString((wMemMapStruct.page)[wI].info);
         char comment_text[MAX_COMMENT_SIZE];
-        if(DbgFunctions()->GetUserComment((duint)wMbi.BaseAddress, comment_text)) // user comment present
-            wS = comment_text;
-        else if(wS.contains(".bss"))
-            wS = tr("Uninitialized data");
-        else if(wS.contains(".data"))
-            wS = tr("Initialized data");
-        else if(wS.contains(".edata"))
-            wS = tr("Export tables");
-        else if(wS.contains(".idata"))
-            wS = tr("Import tables");
-        else if(wS.contains(".pdata"))
-            wS = tr("Exception information");
-        else if(wS.contains(".rdata"))
-            wS = tr("Read-only initialized data");
-        else if(wS.contains(".reloc"))
-            wS = tr("Base relocations");
-        else if(wS.contains(".rsrc"))
-            wS = tr("Resources");
-        else if(wS.contains(".text"))
-            wS = tr("Executable code");
-        else if(wS.contains(".tls"))
-            wS = tr("Thread-local storage");
-        else if(wS.contains(".xdata"))
-            wS = tr("Exception information");
-        else
-            wS = QString("");
-        setCellContent(wI, 3, std::move(wS));
+        if(DbgFunctions()->GetUserComment(base, comment_text))
+            entry.comment = comment_text;
 
-        // Type
-        const char* type = "";
-        switch(wMbi.Type)
-        {
-        case MEM_IMAGE:
-            type = "IMG";
-            break;
-        case MEM_MAPPED:
-            type = "MAP";
-            break;
-        case MEM_PRIVATE:
-            type = "PRV";
-            break;
-        default:
-            type = "N/A";
-            break;
-        }
-        setCellContent(wI, 4, type);
+        auto cached = mRegionCache.find(base);
+        if(cached != mRegionCache.end() && cached.value().sameRegion(entry))
+            for(int col = 0; col < _countof(entry.cells); col++)
+                entry.cells[col] = cached.value().cells[col];
+        else
+            formatRegionCells(base, entry);
 
-        // current access protection
-        setCellContent(wI, 5, getProtectionString(wMbi.Protect));
+        for(int col = 0; col < _countof(entry.cells); col++)
+            setCellContent(wI, col, entry.cells[col]);
+        setCellUserdata(wI, 0, base);
+        setCellUserdata(wI, 1, entry.size);
 
-        // allocation protection
-        setCellContent(wI, 6, getProtectionString(wMbi.AllocationProtect));
+        if(base == selectedBase)
+            selectedRow = wI;
 
+        newCache.insert(base, std::move(entry));
     }
+    mRegionCache = std::move(newCache);
+
     if(wMemMapStruct.page != 0)
         BridgeFree(wMemMapStruct.page);
+    if(selectedRow != -1)
+        setSingleSelection(selectedRow);
     reloadData(); //refresh memory map
 }
 
@@ -484,7 +545,7 @@ void MemoryMapView::doubleClickedSlot()
 
 void MemoryMapView::memoryExecuteSingleshootToggleSlot()
 {
-    for(int i : getSelection())
+    for(int i = getSelectionStart(); i <= getSelectionEnd(); i++)
     {
         QString addr_text = getCellContent(i, 0);
 #ifdef _WIN64
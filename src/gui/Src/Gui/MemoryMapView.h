@@ -2,6 +2,7 @@
 #define MEMORYMAPVIEW_H
 
 #include "StdTable.h"
+#include <QHash>
 
 class GotoDialog;
 
@@ -11,6 +12,7 @@ class MemoryMapView : public StdTable
 public:
     explicit MemoryMapView(StdTable* parent = 0);
     QString paintContent(QPainter* painter, dsint rowBase, int rowOffset, int col, int x, int y, int w, int h);
+    void updateColors() override;
     void setupContextMenu();
 
 signals:
@@ -41,8 +43,38 @@ public slots:
     void disassembleAtSlot(dsint va, dsint cip);
 
 private:
+    // Cached per-region state so refreshMap() only re-formats rows whose
+    // region actually changed, keyed by allocation base
+    struct RegionCacheEntry
+    {
+        duint size = 0;
+        DWORD type = 0;
+        DWORD protect = 0;
+        DWORD allocProtect = 0;
+        QString info;
+        QString comment;
+        QString cells[7]; //formatted column contents
+
+        bool sameRegion(const RegionCacheEntry & b) const
+        {
+            return size == b.size && type == b.type && protect == b.protect &&
+                   allocProtect == b.allocProtect && info == b.info && comment == b.comment;
+        }
+    };
+
+    QColor mBreakpointColor;
+    QColor mBreakpointBackgroundColor;
+    QColor mCipColor;
+    QColor mCipBackgroundColor;
+    QColor mSectionTextColor;
+    QColor mUserModuleColor;
+    QColor mSystemModuleColor;
+
     QString getProtectionString(DWORD Protect);
+    void formatRegionCells(duint base, RegionCacheEntry & entry);
     QAction* makeCommandAction(QAction* action, const QString & command);
+    QHash<duint, RegionCacheEntry> mRegionCache;
+    QHash<DWORD, QString> mProtectionCache;
 
     GotoDialog* mGoto = nullptr;
 
@@ -1459,8 +1459,6 @@ void RegistersView::mouseDoubleClickEvent(QMouseEvent* event)
 
 void RegistersView::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event);
-
     if(mChangeViewButton != NULL)
     {
         if(mShowFpu)
@@ -1480,6 +1478,10 @@ void RegistersView::paintEvent(QPaintEvent* event)
     // Iterate all registers
     for(auto itr = mRegisterMapping.begin(); itr != mRegisterMapping.end(); itr++)
     {
+        // Skip rows outside the update region (differential updates only
+        // invalidate the rows that changed)
+        if(!event->rect().intersects(registerRowRect(itr.key())))
+            continue;
         // Paint register at given position
         drawRegister(&wPainter, itr.key(), registerValue(&wRegDumpStruct, itr.key()));
     }
@@ -2628,9 +2630,19 @@ char* RegistersView::registerValue(const REGDUMP* regd, const REGISTER_NAME reg)
     return (char*) &null_value;
 }
 
+QRect RegistersView::registerRowRect(REGISTER_NAME reg)
+{
+    int ySpace = yTopSpacing;
+    if(mVScrollOffset != 0)
+        ySpace = 0;
+    int y = mRowHeight * (mRegisterPlaces.value(reg).line + mVScrollOffset) + ySpace;
+    return QRect(0, y, this->viewport()->width(), mRowHeight);
+}
+
 void RegistersView::setRegisters(REGDUMP* reg)
 {
     // tests if new-register-value == old-register-value holds
+    auto previousUpdates = mRegisterUpdates;
     if(mCip != reg->regcontext.cip) //CIP changed
     {
         wCipRegDumpStruct = wRegDumpStruct;
@@ -2638,13 +2650,18 @@ void RegistersView::setRegisters(REGDUMP* reg)
         mCip = reg->regcontext.cip;
     }
 
-    // iterate all ids (CAX, CBX, ...)
+    // iterate all ids (CAX, CBX, ...), collecting the rows whose displayed
+    // value or changed-highlight state differs from what is on screen
+    QRegion changedRegion;
     for(auto itr = mRegisterMapping.begin(); itr != mRegisterMapping.end(); itr++)
     {
-        if(CompareRegisters(itr.key(), reg, &wCipRegDumpStruct) != 0)
+        auto nowUpdated = CompareRegisters(itr.key(), reg, &wCipRegDumpStruct) != 0;
+        if(nowUpdated)
             mRegisterUpdates.insert(itr.key());
         else if(mRegisterUpdates.contains(itr.key())) //registers are equal
             mRegisterUpdates.remove(itr.key());
+        if(nowUpdated != previousUpdates.contains(itr.key()) || CompareRegisters(itr.key(), reg, &wRegDumpStruct) != 0)
+            changedRegion += registerRowRect(itr.key());
     }
 
     // now we can save the values
@@ -2653,8 +2670,9 @@ void RegistersView::setRegisters(REGDUMP* reg)
     if(mCip != reg->regcontext.cip)
         wCipRegDumpStruct = wRegDumpStruct;
 
-    // force repaint
-    emit refresh();
+    // repaint only the rows that actually changed instead of the whole pane
+    if(!changedRegion.isEmpty())
+        this->viewport()->update(changedRegion);
 }
 
 void RegistersView::ensureRegisterVisible(REGISTER_NAME reg)
@@ -35,30 +35,45 @@ void SEHChainView::updateSEHChain()
     if(!DbgFunctions()->GetSEHChain)
         return;
     DbgFunctions()->GetSEHChain(&sehchain);
-    setRowCount(sehchain.total);
+
+    QList<QStringList> rows;
+    rows.reserve(int(sehchain.total));
     for(duint i = 0; i < sehchain.total; i++)
     {
-        QString cellText = ToPtrString(sehchain.records[i].addr);
-        setCellContent(i, 0, cellText);
-        cellText = ToPtrString(sehchain.records[i].handler);
-        setCellContent(i, 1, cellText);
+        QStringList row;
+        row << ToPtrString(sehchain.records[i].addr);
+        row << ToPtrString(sehchain.records[i].handler);
 
         char label[MAX_LABEL_SIZE] = "";
         char module[MAX_MODULE_SIZE] = "";
         DbgGetModuleAt(sehchain.records[i].handler, module);
-        QString label_text;
         if(DbgGetLabelAt(sehchain.records[i].handler, SEG_DEFAULT, label))
-            label_text = "<" + QString(module) + "." + QString(label) + ">";
+            row << "<" + QString(module) + "." + QString(label) + ">";
         else
-            label_text = QString(module);
-        setCellContent(i, 2, label_text);
+            row << QString(module);
         QString comment;
-        if(GetCommentFormat(sehchain.records[i].handler, comment))
-            setCellContent(i, 3, comment);
+        GetCommentFormat(sehchain.records[i].handler, comment);
+        row << comment;
+        rows.append(row);
     }
     if(sehchain.total)
         BridgeFree(sehchain.records);
-    reloadData();
+
+    //only touch the rows that differ from what is shown
+    bool changed = mRowCache.size() != rows.size();
+    if(changed)
+        setRowCount(rows.size());
+    for(int i = 0; i < rows.size(); i++)
+    {
+        if(i < mRowCache.size() && mRowCache.at(i) == rows.at(i))
+            continue;
+        changed = true;
+        for(int j = 0; j < rows.at(i).size(); j++)
+            setCellContent(i, j, rows.at(i).at(j));
+    }
+    mRowCache = std::move(rows);
+    if(changed)
+        reloadData();
 }
 
 void SEHChainView::contextMenuSlot(const QPoint pos)
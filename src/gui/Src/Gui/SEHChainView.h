@@ -20,6 +20,7 @@ protected slots:
 private:
     QAction* mFollowAddress;
     QAction* mFollowHandler;
+    QList<QStringList> mRowCache; //rows currently shown, used to apply updates as a diff
 };
 
 #endif // SEHCHAINVIEW_H
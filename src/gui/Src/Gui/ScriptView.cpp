@@ -66,6 +66,205 @@ void ScriptView::updateColors()
 
     mSelectionColor = ConfigColor("DisassemblySelectionColor");
     mBackgroundColor = ConfigColor("DisassemblyBackgroundColor");
+    invalidateLineCache(); //the cached rich text embeds the colors
+}
+
+ScriptView::LineInfo & ScriptView::lineInfo(int line)
+{
+    if(int(mLineCache.size()) < getRowCount())
+        mLineCache.resize(getRowCount());
+    auto & info = mLineCache[line - 1];
+    if(!info.valid)
+        buildLineInfo(line, info);
+    return info;
+}
+
+void ScriptView::invalidateLineCache()
+{
+    mLineCache.clear();
+}
+
+void ScriptView::buildLineInfo(int line, LineInfo & info)
+{
+    info.valid = true;
+    info.linetype = DbgScriptGetLineType(line);
+    info.richText.clear();
+
+    RichTextPainter::CustomRichText_t newRichText;
+    newRichText.underline = false;
+    QString command = getCellContent(line - 1, 1);
+
+    //handle comments
+    int comment_idx = command.indexOf("\1"); //find the index of the comment
+    QString comment = "";
+    if(comment_idx != -1 && command.at(0) != QChar('/')) //there is a comment
+    {
+        comment = command.right(command.length() - comment_idx - 1);
+        if(command.at(comment_idx - 1) == QChar(' '))
+            command.truncate(comment_idx - 1);
+        else
+            command.truncate(comment_idx);
+    }
+
+    QString mnemonic, argument;
+
+    //setup the richText list
+    switch(info.linetype)
+    {
+    case linecommand:
+    {
+        if(isScriptCommand(command, "ret", mnemonic, argument))
+        {
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionRetColor");
+            newRichText.textBackground = ConfigColor("InstructionRetBackgroundColor");
+            newRichText.text = mnemonic;
+            info.richText.push_back(newRichText);
+            if(argument.length())
+            {
+                newRichText.flags = RichTextPainter::FlagAll;
+                newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
+                newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
+                newRichText.text = argument;
+                info.richText.push_back(newRichText);
+            }
+        }
+        else if(isScriptCommand(command, "invalid", mnemonic, argument) || isScriptCommand(command, "error", mnemonic, argument))
+        {
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionUnusualColor");
+            newRichText.textBackground = ConfigColor("InstructionUnusualBackgroundColor");
+            newRichText.text = mnemonic;
+            info.richText.push_back(newRichText);
+            if(argument.length())
+            {
+                newRichText.flags = RichTextPainter::FlagAll;
+                newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
+                newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
+                newRichText.text = argument;
+                info.richText.push_back(newRichText);
+            }
+        }
+        else if(isScriptCommand(command, "nop", mnemonic, argument))
+        {
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionNopColor");
+            newRichText.textBackground = ConfigColor("InstructionNopBackgroundColor");
+            newRichText.text = mnemonic;
+            info.richText.push_back(newRichText);
+        }
+        else
+        {
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
+            newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
+            newRichText.text = command;
+            info.richText.push_back(newRichText);
+        }
+    }
+    break;
+
+    case linebranch:
+    {
+        SCRIPTBRANCH branchinfo;
+        DbgScriptGetBranchInfo(line, &branchinfo);
+        //jumps
+        int i = command.indexOf(" "); //find the index of the space
+        switch(branchinfo.type)
+        {
+        case scriptjmp: //unconditional jumps
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionUnconditionalJumpColor");
+            newRichText.textBackground = ConfigColor("InstructionUnconditionalJumpBackgroundColor");
+            break;
+
+        case scriptjnejnz: //conditional jumps
+        case scriptjejz:
+        case scriptjbjl:
+        case scriptjajg:
+        case scriptjbejle:
+        case scriptjaejge:
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionConditionalJumpColor");
+            newRichText.textBackground = ConfigColor("InstructionConditionalJumpBackgroundColor");
+            break;
+
+        case scriptcall: //calls
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionCallColor");
+            newRichText.textBackground = ConfigColor("InstructionCallBackgroundColor");
+            break;
+
+        default:
+            newRichText.flags = RichTextPainter::FlagAll;
+            newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
+            newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
+            break;
+        }
+        newRichText.text = command.left(i);
+        info.richText.push_back(newRichText);
+        //space
+        newRichText.flags = RichTextPainter::FlagNone;
+        newRichText.text = " ";
+        info.richText.push_back(newRichText);
+        //label
+        QString label = branchinfo.branchlabel;
+        newRichText.flags = RichTextPainter::FlagAll;
+        newRichText.textColor = ConfigColor("InstructionAddressColor");
+        newRichText.textBackground = ConfigColor("InstructionAddressBackgroundColor");
+        newRichText.text = label;
+        info.richText.push_back(newRichText);
+        //remainder
+        QString remainder = command.right(command.length() - command.indexOf(label) - label.length());
+        if(remainder.length())
+        {
+            newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
+            newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
+            newRichText.text = remainder;
+            info.richText.push_back(newRichText);
+        }
+    }
+    break;
+
+    case linelabel: //the label underline is drawn in paintContent, it needs the cell geometry
+    {
+        newRichText.flags = RichTextPainter::FlagAll;
+        newRichText.textColor = ConfigColor("DisassemblyAddressColor");
+        newRichText.textBackground = ConfigColor("DisassemblyAddressBackgroundColor");
+        newRichText.text = command;
+        info.richText.push_back(newRichText);
+    }
+    break;
+
+    case linecomment:
+    {
+        newRichText.flags = RichTextPainter::FlagAll;
+        newRichText.textColor = ConfigColor("DisassemblyAddressColor");
+        newRichText.textBackground = ConfigColor("DisassemblyAddressBackgroundColor");
+        newRichText.text = command;
+        info.richText.push_back(newRichText);
+    }
+    break;
+
+    case lineempty:
+    {
+    }
+    break;
+    }
+
+    //append the comment (when present)
+    if(comment.length())
+    {
+        newRichText.underline = false;
+        newRichText.flags = RichTextPainter::FlagNone;
+        newRichText.text = " ";
+        info.richText.push_back(newRichText); //space
+        newRichText.flags = RichTextPainter::FlagAll;
+        newRichText.textColor = ConfigColor("DisassemblyAddressColor");
+        newRichText.textBackground = ConfigColor("DisassemblyAddressBackgroundColor");
+        newRichText.text = comment;
+        info.richText.push_back(newRichText); //comment
+    }
 }
 
 QString ScriptView::paintContent(QPainter* painter, dsint rowBase, int rowOffset, int col, int x, int y, int w, int h)
@@ -76,7 +275,7 @@ QString ScriptView::paintContent(QPainter* painter, dsint rowBase, int rowOffset
         painter->fillRect(QRect(x, y, w, h), QBrush(mSelectionColor)); //ScriptViewSelectionColor
     QString returnString;
     int line = rowBase + rowOffset + 1;
-    SCRIPTLINETYPE linetype = DbgScriptGetLineType(line);
+    SCRIPTLINETYPE linetype = lineInfo(line).linetype;
     switch(col)
     {
     case 0: //line number
@@ -125,190 +324,11 @@ QString ScriptView::paintContent(QPainter* painter, dsint rowBase, int rowOffset
     {
         if(mEnableSyntaxHighlighting)
         {
-            //initialize
-            int charwidth = getCharWidth();
-            int xadd = charwidth; //for testing
-            RichTextPainter::List richText;
-            RichTextPainter::CustomRichText_t newRichText;
-            newRichText.underline = false;
-            QString command = getCellContent(rowBase + rowOffset, col);
-
-            //handle comments
-            int comment_idx = command.indexOf("\1"); //find the index of the comment
-            QString comment = "";
-            if(comment_idx != -1 && command.at(0) != QChar('/')) //there is a comment
-            {
-                comment = command.right(command.length() - comment_idx - 1);
-                if(command.at(comment_idx - 1) == QChar(' '))
-                    command.truncate(comment_idx - 1);
-                else
-                    command.truncate(comment_idx);
-            }
-
-            QString mnemonic, argument;
-
-            //setup the richText list
-            switch(linetype)
-            {
-            case linecommand:
-            {
-                if(isScriptCommand(command, "ret", mnemonic, argument))
-                {
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionRetColor");
-                    newRichText.textBackground = ConfigColor("InstructionRetBackgroundColor");
-                    newRichText.text = mnemonic;
-                    richText.push_back(newRichText);
-                    if(argument.length())
-                    {
-                        newRichText.flags = RichTextPainter::FlagAll;
-                        newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
-                        newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
-                        newRichText.text = argument;
-                        richText.push_back(newRichText);
-                    }
-                }
-                else if(isScriptCommand(command, "invalid", mnemonic, argument) || isScriptCommand(command, "error", mnemonic, argument))
-                {
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionUnusualColor");
-                    newRichText.textBackground = ConfigColor("InstructionUnusualBackgroundColor");
-                    newRichText.text = mnemonic;
-                    richText.push_back(newRichText);
-                    if(argument.length())
-                    {
-                        newRichText.flags = RichTextPainter::FlagAll;
-                        newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
-                        newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
-                        newRichText.text = argument;
-                        richText.push_back(newRichText);
-                    }
-                }
-                else if(isScriptCommand(command, "nop", mnemonic, argument))
-                {
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionNopColor");
-                    newRichText.textBackground = ConfigColor("InstructionNopBackgroundColor");
-                    newRichText.text = mnemonic;
-                    richText.push_back(newRichText);
-                }
-                else
-                {
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
-                    newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
-                    newRichText.text = command;
-                    richText.push_back(newRichText);
-                }
-            }
-            break;
-
-            case linebranch:
-            {
-                SCRIPTBRANCH branchinfo;
-                DbgScriptGetBranchInfo(line, &branchinfo);
-                //jumps
-                int i = command.indexOf(" "); //find the index of the space
-                switch(branchinfo.type)
-                {
-                case scriptjmp: //unconditional jumps
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionUnconditionalJumpColor");
-                    newRichText.textBackground = ConfigColor("InstructionUnconditionalJumpBackgroundColor");
-                    break;
-
-                case scriptjnejnz: //conditional jumps
-                case scriptjejz:
-                case scriptjbjl:
-                case scriptjajg:
-                case scriptjbejle:
-                case scriptjaejge:
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionConditionalJumpColor");
-                    newRichText.textBackground = ConfigColor("InstructionConditionalJumpBackgroundColor");
-                    break;
-
-                case scriptcall: //calls
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionCallColor");
-                    newRichText.textBackground = ConfigColor("InstructionCallBackgroundColor");
-                    break;
-
-                default:
-                    newRichText.flags = RichTextPainter::FlagAll;
-                    newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
-                    newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
-                    break;
-                }
-                newRichText.text = command.left(i);
-                richText.push_back(newRichText);
-                //space
-                newRichText.flags = RichTextPainter::FlagNone;
-                newRichText.text = " ";
-                richText.push_back(newRichText);
-                //label
-                QString label = branchinfo.branchlabel;
-                newRichText.flags = RichTextPainter::FlagAll;
-                newRichText.textColor = ConfigColor("InstructionAddressColor");
-                newRichText.textBackground = ConfigColor("InstructionAddressBackgroundColor");
-                newRichText.text = label;
-                richText.push_back(newRichText);
-                //remainder
-                QString remainder = command.right(command.length() - command.indexOf(label) - label.length());
-                if(remainder.length())
-                {
-                    newRichText.textColor = ConfigColor("InstructionUncategorizedColor");
-                    newRichText.textBackground = ConfigColor("InstructionUncategorizedBackgroundColor");
-                    newRichText.text = remainder;
-                    richText.push_back(newRichText);
-                }
-            }
-            break;
-
-            case linelabel:
-            {
-                newRichText.flags = RichTextPainter::FlagAll;
-                newRichText.textColor = ConfigColor("DisassemblyAddressColor");
-                newRichText.textBackground = ConfigColor("DisassemblyAddressBackgroundColor");
-                newRichText.text = command;
-                richText.push_back(newRichText);
+            int xadd = getCharWidth();
+            const LineInfo & info = lineInfo(line);
+            if(info.linetype == linelabel)
                 painter->drawLine(QPoint(x + xadd + 2, y + h - 2), QPoint(x + w - 4, y + h - 2));
-            }
-            break;
-
-            case linecomment:
-            {
-                newRichText.flags = RichTextPainter::FlagAll;
-                newRichText.textColor = ConfigColor("DisassemblyAddressColor");
-                newRichText.textBackground = ConfigColor("DisassemblyAddressBackgroundColor");
-                newRichText.text = command;
-                richText.push_back(newRichText);
-            }
-            break;
-
-            case lineempty:
-            {
-            }
-            break;
-            }
-
-            //append the comment (when present)
-            if(comment.length())
-            {
-                RichTextPainter::CustomRichText_t newRichText;
-                newRichText.underline = false;
-                newRichText.flags = RichTextPainter::FlagNone;
-                newRichText.text = " ";
-                richText.push_back(newRichText); //space
-                newRichText.flags = RichTextPainter::FlagAll;
-                newRichText.textColor = ConfigColor("DisassemblyAddressColor");
-                newRichText.textBackground = ConfigColor("DisassemblyAddressBackgroundColor");
-                newRichText.text = comment;
-                richText.push_back(newRichText); //comment
-            }
-
-            //paint the rich text
-            RichTextPainter::paintRichText(painter, x + 1, y, w, h, xadd, richText, mFontMetrics);
+            RichTextPainter::paintRichText(painter, x + 1, y, w, h, xadd, info.richText, mFontMetrics);
             returnString = "";
         }
         else //no syntax highlighting
@@ -437,6 +457,7 @@ bool ScriptView::isScriptCommand(QString text, QString cmd, QString & mnemonic,
 //slots
 void ScriptView::add(int count, const char** lines)
 {
+    invalidateLineCache();
     setRowCount(count);
     for(int i = 0; i < count; i++)
         setCellContent(i, 1, QString(lines[i]));
@@ -447,6 +468,7 @@ void ScriptView::add(int count, const char** lines)
 
 void ScriptView::clear()
 {
+    invalidateLineCache();
     setRowCount(0);
     mIpLine = 0;
     reloadData(); //repaint
@@ -454,8 +476,22 @@ void ScriptView::clear()
 
 void ScriptView::setIp(int line)
 {
+    int oldIp = mIpLine;
+    int oldSelection = getInitialSelection();
+    auto oldOffset = getTableOffset();
     mIpLine = scrollSelect(line - 1) ? line : 0;
-    reloadData(); //repaint
+    if(getTableOffset() != oldOffset)
+    {
+        reloadData(); //the view scrolled, repaint everything
+        return;
+    }
+    //only the rows that lost and gained the IP/selection marker changed
+    if(oldIp)
+        updateRows(oldIp - 1, oldIp - 1);
+    if(oldSelection != oldIp - 1)
+        updateRows(oldSelection, oldSelection);
+    if(mIpLine && mIpLine != oldIp)
+        updateRows(mIpLine - 1, mIpLine - 1);
 }
 
 void ScriptView::setSelection(int line)
@@ -2,6 +2,7 @@
 #define SCRIPTVIEW_H
 
 #include "StdTable.h"
+#include "RichTextPainter.h"
 
 class QMessageBox;
 class MRUList;
@@ -49,12 +50,26 @@ public slots:
     void closeSlot();
 
 private:
+    //Lazily built per-line classification: the line type and the highlighted
+    //rich text only depend on the script content, so they are computed once
+    //per line instead of on every repaint. Rebuilt on load and color changes.
+    struct LineInfo
+    {
+        bool valid = false;
+        SCRIPTLINETYPE linetype = lineempty;
+        RichTextPainter::List richText;
+    };
+
     //private functions
     void setupContextMenu();
     void setSelection(int line);
     bool isScriptCommand(QString text, QString cmd, QString & mnemonic, QString & argument);
+    LineInfo & lineInfo(int line);
+    void buildLineInfo(int line, LineInfo & info);
+    void invalidateLineCache();
 
     //private variables
+    std::vector<LineInfo> mLineCache;
     int mIpLine;
     bool mEnableSyntaxHighlighting;
     QString filename;
@@ -28,6 +28,7 @@ StructWidget::StructWidget(QWidget* parent) :
     connect(Config(), SIGNAL(colorsUpdated()), this, SLOT(colorsUpdatedSlot()));
     connect(Config(), SIGNAL(fontsUpdated()), this, SLOT(fontsUpdatedSlot()));
     connect(Config(), SIGNAL(shortcutsUpdated()), this, SLOT(shortcutsUpdatedSlot()));
+    connect(ui->treeWidget, SIGNAL(itemExpanded(QTreeWidgetItem*)), this, SLOT(itemExpandedSlot(QTreeWidgetItem*)));
     colorsUpdatedSlot();
     fontsUpdatedSlot();
     setupContextMenu();
@@ -82,16 +83,52 @@ void StructWidget::typeClear()
     Bridge::getBridge()->setResult(BridgeResult::TypeClear);
 }
 
-void StructWidget::typeUpdateWidget()
+// Only the expanded part of the tree is worth refreshing: collapsed
+// children are materialized by itemExpandedSlot when they first come
+// into view, which keeps a step through a huge array from touching
+// every element.
+void StructWidget::collectExpandedItems(QTreeWidgetItem* item, QList<QTreeWidgetItem*> & items)
+{
+    items.append(item);
+    if(!item->isExpanded())
+        return;
+    for(int i = 0; i < item->childCount(); i++)
+        collectExpandedItems(item->child(i), items);
+}
+
+void StructWidget::updateItemValues(const QList<QTreeWidgetItem*> & items)
 {
-    for(QTreeWidgetItemIterator it(ui->treeWidget); *it; ++it)
+    // Fetch the memory behind all small leaf values in one scatter read
+    QList<QTreeWidgetItem*> leafItems;
+    for(QTreeWidgetItem* item : items)
+    {
+        auto type = item->data(0, Qt::UserRole).value<TypeDescriptor>();
+        if(!type.type.callback && !item->childCount() && type.type.size > 0 && type.type.size <= sizeof(uint64_t))
+            leafItems.append(item);
+    }
+    std::vector<uint64_t> leafData(leafItems.size());
+    std::vector<MEMREADRANGE> leafRanges(leafItems.size());
+    for(int i = 0; i < leafItems.size(); i++)
+    {
+        auto type = leafItems[i]->data(0, Qt::UserRole).value<TypeDescriptor>();
+        leafRanges[i].addr = type.type.addr + type.type.offset;
+        leafRanges[i].dest = (unsigned char*)&leafData[i];
+        leafRanges[i].size = type.type.size;
+        leafRanges[i].success = false;
+    }
+    if(!leafRanges.empty())
+        DbgMemReadScatter(leafRanges.data(), leafRanges.size());
+
+    int leafIdx = 0;
+    for(QTreeWidgetItem* item : items)
     {
-        QTreeWidgetItem* item = *it;
         auto type = item->data(0, Qt::UserRole).value<TypeDescriptor>();
         auto name = type.name.toUtf8();
         type.type.name = name.constData();
         auto addr = type.type.addr + type.type.offset;
-        item->setText(1, ToPtrString(addr));
+        auto addrStr = ToPtrString(addr);
+        if(item->text(1) != addrStr)
+            item->setText(1, addrStr);
         QString valueStr;
         if(type.type.callback) //use the provided callback
         {
@@ -111,8 +148,8 @@ void StructWidget::typeUpdateWidget()
         }
         else if(!item->childCount() && type.type.size > 0 && type.type.size <= sizeof(uint64_t)) //attempt to display small, non-parent values
         {
-            uint64_t data;
-            if(DbgMemRead(addr, &data, type.type.size))
+            uint64_t data = leafData[leafIdx];
+            if(leafRanges[leafIdx].success)
             {
                 if(type.type.reverse)
                     std::reverse((char*)data, (char*)data + type.type.size);
@@ -120,11 +157,21 @@ void StructWidget::typeUpdateWidget()
             }
             else if(type.type.addr)
                 valueStr = "???";
+            leafIdx++;
         }
-        item->setText(3, valueStr);
+        if(item->text(3) != valueStr) //avoid repainting unchanged values
+            item->setText(3, valueStr);
     }
 }
 
+void StructWidget::typeUpdateWidget()
+{
+    QList<QTreeWidgetItem*> items;
+    for(int i = 0; i < ui->treeWidget->topLevelItemCount(); i++)
+        collectExpandedItems(ui->treeWidget->topLevelItem(i), items);
+    updateItemValues(items);
+}
+
 void StructWidget::dbgStateChangedSlot(DBGSTATE state)
 {
     if(state == stopped)
@@ -166,6 +213,14 @@ void StructWidget::setupContextMenu()
     mMenuBuilder->loadFromConfig();
 }
 
+void StructWidget::itemExpandedSlot(QTreeWidgetItem* item)
+{
+    QList<QTreeWidgetItem*> items;
+    for(int i = 0; i < item->childCount(); i++)
+        collectExpandedItems(item->child(i), items);
+    updateItemValues(items);
+}
+
 void StructWidget::on_treeWidget_customContextMenuRequested(const QPoint & pos)
 {
     QMenu wMenu;
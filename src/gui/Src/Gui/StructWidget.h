@@ -7,6 +7,7 @@
 
 class MenuBuilder;
 class GotoDialog;
+class QTreeWidgetItem;
 
 namespace Ui
 {
@@ -38,9 +39,12 @@ private:
 
     void setupColumns();
     void setupContextMenu();
+    void collectExpandedItems(QTreeWidgetItem* item, QList<QTreeWidgetItem*> & items);
+    void updateItemValues(const QList<QTreeWidgetItem*> & items);
 
 private slots:
     void on_treeWidget_customContextMenuRequested(const QPoint & pos);
+    void itemExpandedSlot(QTreeWidgetItem* item);
 
     void followDumpSlot();
     void clearSlot();
@@ -127,23 +127,19 @@ public:
         return mSearchList;
     }
 
-    void filter(const QString & filter, FilterType type, int startColumn) override
+    void clearSearchList() override
     {
         mSearchList->setRowCount(0);
-        int newRowCount = 0;
         mSearchList->mData.clear();
-        mSearchList->mData.reserve(mList->mData.size());
         mSearchList->mModules = mList->mModules;
-        int rows = mList->getRowCount();
-        for(int i = 0; i < rows; i++)
-        {
-            if(rowMatchesFilter(filter, type, i, startColumn))
-            {
-                newRowCount++;
-                mSearchList->mData.push_back(mList->mData.at(i));
-            }
-        }
-        mSearchList->setRowCount(newRowCount);
+    }
+
+    void appendToSearchList(const std::vector<int> & rows) override
+    {
+        mSearchList->mData.reserve(mSearchList->mData.size() + rows.size());
+        for(int row : rows)
+            mSearchList->mData.push_back(mList->mData.at(row));
+        mSearchList->setRowCount(mSearchList->mData.size());
     }
 
     void addAction(QAction* action)
@@ -157,7 +153,7 @@ private:
     ZehSymbolTable* mSearchList;
 };
 
-SymbolView::SymbolView(QWidget* parent) : QWidget(parent), ui(new Ui::SymbolView)
+SymbolView::SymbolView(QWidget* parent) : QWidget(parent), ui(new Ui::SymbolView), mEnumBusy(false), mEnumGeneration(0)
 {
     ui->setupUi(this);
     setAutoFillBackground(false);
@@ -232,10 +228,15 @@ SymbolView::SymbolView(QWidget* parent) : QWidget(parent), ui(new Ui::SymbolView
     connect(mSymbolList, SIGNAL(enterPressedSignal()), this, SLOT(enterPressedSlot()));
     connect(Config(), SIGNAL(colorsUpdated()), this, SLOT(updateStyle()));
     connect(Config(), SIGNAL(fontsUpdated()), this, SLOT(updateStyle()));
+    connect(this, SIGNAL(enumSymbolsReady()), this, SLOT(applyEnumeratedSymbolsSlot()), Qt::QueuedConnection);
 }
 
 SymbolView::~SymbolView()
 {
+    //abort a running enumeration and wait for the worker to exit
+    mEnumGeneration.fetch_add(1);
+    if(mEnumThread.joinable())
+        mEnumThread.join();
     delete ui;
     delete mSymbolSearchList;
 }
@@ -427,10 +428,8 @@ void SymbolView::clearSymbolLogSlot()
 void SymbolView::moduleSelectionChanged(int index)
 {
     Q_UNUSED(index);
-    setUpdatesEnabled(false);
-
     std::vector<duint> selectedModules;
-    for(auto index : mModuleList->mCurList->getSelection())
+    for(auto index = mModuleList->mCurList->getSelectionStart(); index <= mModuleList->mCurList->getSelectionEnd(); index++)
     {
         QString modBase = mModuleList->mCurList->getCellContent(index, ColBase);
         duint wVA;
@@ -438,18 +437,91 @@ void SymbolView::moduleSelectionChanged(int index)
             selectedModules.push_back(wVA);
     }
 
-    std::vector<SYMBOLPTR> data;
-    for(auto base : selectedModules)
+    //enumerating a large module can take a while, so it happens on a worker
+    //thread and module switches stay constant-cost for the GUI
+    {
+        std::lock_guard<std::mutex> lock(mEnumMutex);
+        mEnumPendingModules = std::move(selectedModules);
+    }
+    mEnumGeneration.fetch_add(1); //abort an enumeration still running
+    startSymbolEnumThread();
+}
+
+void SymbolView::startSymbolEnumThread()
+{
+    if(mEnumBusy.exchange(true)) //the running worker picks up the new selection
+        return;
+    if(mEnumThread.joinable())
+        mEnumThread.join();
+    mEnumThread = std::thread([this]()
+    {
+        symbolEnumThreadProc();
+    });
+}
+
+void SymbolView::symbolEnumThreadProc()
+{
+    for(;;)
     {
-        DbgSymbolEnum(base, [](const SYMBOLPTR * info, void* userdata)
+        auto generation = mEnumGeneration.load();
+        std::vector<duint> modules;
         {
-            ((std::vector<SYMBOLPTR>*)userdata)->push_back(*info);
-            return true; // TODO: allow aborting (enumeration in a separate thread)
-        }, &data);
+            std::lock_guard<std::mutex> lock(mEnumMutex);
+            modules = mEnumPendingModules;
+        }
+
+        struct EnumContext
+        {
+            SymbolView* self;
+            unsigned int generation;
+            std::vector<SYMBOLPTR>* data;
+        };
+        std::vector<SYMBOLPTR> data;
+        for(auto base : modules)
+        {
+            EnumContext context = { this, generation, &data };
+            DbgSymbolEnum(base, [](const SYMBOLPTR * info, void* userdata)
+            {
+                auto context = (EnumContext*)userdata;
+                if(context->self->mEnumGeneration.load() != context->generation)
+                    return false; //a newer selection arrived, abort
+                context->data->push_back(*info);
+                return true;
+            }, &context);
+        }
+
+        if(mEnumGeneration.load() == generation)
+        {
+            std::lock_guard<std::mutex> lock(mEnumMutex);
+            mEnumResultModules = std::move(modules);
+            mEnumResultData = std::move(data);
+            emit enumSymbolsReady();
+        }
+
+        if(mEnumGeneration.load() != generation)
+            continue; //process the newer selection on this thread
+        mEnumBusy.store(false);
+        if(mEnumGeneration.load() == generation || mEnumBusy.exchange(true))
+            return;
+        //a selection arrived during the hand-off, keep going
+    }
+}
+
+void SymbolView::applyEnumeratedSymbolsSlot()
+{
+    std::vector<duint> modules;
+    std::vector<SYMBOLPTR> data;
+    {
+        std::lock_guard<std::mutex> lock(mEnumMutex);
+        modules.swap(mEnumResultModules);
+        data.swap(mEnumResultData);
     }
+    if(modules.empty() && data.empty()) //results were already applied
+        return;
 
+    setUpdatesEnabled(false);
     mSymbolSearchList->lock();
-    mSymbolSearchList->mList->mModules = std::move(selectedModules);
+    mSymbolSearchList->mList->mModules = std::move(modules);
     mSymbolSearchList->mList->mData = std::move(data);
     mSymbolSearchList->mList->setRowCount(mSymbolSearchList->mList->mData.size());
     mSymbolSearchList->unlock();
@@ -703,9 +775,7 @@ void SymbolView::toggleBreakpoint()
     if(!mSymbolList->mCurList->getRowCount())
         return;
 
-    auto selection = mSymbolList->mCurList->getSelection();
-
-    for(auto selectedIdx : selection)
+    for(auto selectedIdx = mSymbolList->mCurList->getSelectionStart(); selectedIdx <= mSymbolList->mCurList->getSelectionEnd(); selectedIdx++)
     {
         QString addrText = mSymbolList->mCurList->getCellContent(selectedIdx, 0);
         duint wVA;
@@ -2,6 +2,9 @@
 #define SYMBOLVIEW_H
 
 #include <QWidget>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include "Bridge.h"
 
 class QMenu;
@@ -59,9 +62,11 @@ private slots:
     void selectionGetSlot(SELECTIONDATA* selection);
     void moduleLoad();
     void moduleFree();
+    void applyEnumeratedSymbolsSlot();
 
 signals:
     void showReferences();
+    void enumSymbolsReady();
 
 private:
     Ui::SymbolView* ui;
@@ -91,6 +96,18 @@ private:
     QAction* mFreeLib;
     QMenu* mPluginMenu;
 
+    //symbol enumeration runs on a worker thread; the latest module
+    //selection wins and older enumerations abort through the generation
+    void startSymbolEnumThread();
+    void symbolEnumThreadProc();
+    std::thread mEnumThread;
+    std::atomic<bool> mEnumBusy;
+    std::atomic<unsigned int> mEnumGeneration;
+    std::mutex mEnumMutex;
+    std::vector<duint> mEnumPendingModules; //guarded by mEnumMutex
+    std::vector<duint> mEnumResultModules; //guarded by mEnumMutex
+    std::vector<SYMBOLPTR> mEnumResultData; //guarded by mEnumMutex
+
     static void cbSymbolEnum(SYMBOLINFO* symbol, void* user);
 };
 
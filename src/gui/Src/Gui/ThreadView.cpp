@@ -3,6 +3,7 @@
 #include "Bridge.h"
 #include "StringUtil.h"
 #include "LineEditDialog.h"
+#include <QTimer>
 
 void ThreadView::contextMenuSlot(const QPoint & pos)
 {
@@ -140,7 +141,7 @@ void ThreadView::ExecCommand()
         QString command = action->data().toString();
         if(command.contains('$'))
         {
-            for(int i : getSelection())
+            for(int i = getSelectionStart(); i <= getSelectionEnd(); i++)
             {
                 QString specializedCommand = command;
                 specializedCommand.replace(QChar('$'), ToHexString(getCellUserdata(i, 1))); // $ -> Thread Id
@@ -169,12 +170,20 @@ ThreadView::ThreadView(StdTable* parent) : StdTable(parent)
     addColumnAt(8 + charwidth * 16, tr("Kernel Time"), true);
     addColumnAt(8 + charwidth * 16, tr("Creation Time"), true);
     addColumnAt(8 + charwidth * 10, tr("CPU Cycles"), true, "", SortBy::AsHex);
-    addColumnAt(8, tr("Name"), true);
+    addColumnAt(8 + charwidth * 16, tr("Name"), true);
+    addColumnAt(8, tr("CPU Usage"), false);
     loadColumnFromConfig("Thread");
 
     //setCopyMenuOnly(true);
 
     connect(Bridge::getBridge(), SIGNAL(updateThreads()), this, SLOT(updateThreadList()));
+
+    // The debugger samples the cycle counters while the target runs, so the
+    // sparkline column refreshes on a timer instead of waiting for a pause
+    mCycleTimer = new QTimer(this);
+    mCycleTimer->setInterval(1000);
+    connect(mCycleTimer, SIGNAL(timeout()), this, SLOT(updateCycleHistorySlot()));
+    mCycleTimer->start();
     connect(this, SIGNAL(doubleClickedSignal()), this, SLOT(doubleClickedSlot()));
     connect(this, SIGNAL(contextMenuSignal(QPoint)), this, SLOT(contextMenuSlot(QPoint)));
 
@@ -355,6 +364,7 @@ void ThreadView::updateThreadList()
         setCellContent(i, 12, ToLongLongHexString(threadList.list[i].Cycles));
         setCellContent(i, 13, threadList.list[i].BasicInfo.threadName);
     }
+    fetchCycleHistory();
     mCurrentThreadId = -1;
     if(threadList.count)
     {
@@ -377,9 +387,56 @@ QString ThreadView::paintContent(QPainter* painter, dsint rowBase, int rowOffset
         painter->drawText(QRect(x + 4, y, w - 4, h), Qt::AlignVCenter | Qt::AlignLeft, ret);
         ret = "";
     }
+    else if(col == 14 && mCycleHistoryMax) //CPU usage sparkline
+    {
+        auto found = mCycleHistory.find(threadId);
+        if(found != mCycleHistory.end())
+        {
+            const auto & deltas = found->second;
+            // All sparklines share one scale, so the tallest bars mark the
+            // hottest thread at a glance
+            int barWidth = qMax(1, (w - 4) / 32);
+            QBrush barBrush(ConfigColor("AbstractTableViewTextColor"));
+            for(size_t n = 0; n < deltas.size(); n++)
+            {
+                int barHeight = int((unsigned long long)(h - 4) * deltas[n] / mCycleHistoryMax);
+                if(!barHeight && deltas[n])
+                    barHeight = 1;
+                if(barHeight)
+                    painter->fillRect(QRect(x + 2 + int(n) * barWidth, y + h - 2 - barHeight, barWidth, barHeight), barBrush);
+            }
+        }
+    }
     return ret;
 }
 
+void ThreadView::fetchCycleHistory()
+{
+    mCycleHistory.clear();
+    mCycleHistoryMax = 0;
+    unsigned long long deltas[32];
+    auto rowCount = getRowCount();
+    for(dsint i = 0; i < rowCount; i++)
+    {
+        duint threadId = getCellUserdata(i, 1);
+        int count = DbgFunctions()->GetThreadCycleHistory(DWORD(threadId), deltas, 32);
+        if(count <= 0)
+            continue;
+        auto & history = mCycleHistory[threadId];
+        history.assign(deltas, deltas + count);
+        for(auto delta : history)
+            mCycleHistoryMax = qMax(mCycleHistoryMax, delta);
+    }
+}
+
+void ThreadView::updateCycleHistorySlot()
+{
+    if(!DbgIsDebugging() || !isVisible())
+        return;
+    fetchCycleHistory();
+    reloadData();
+}
+
 void ThreadView::doubleClickedSlot()
 {
     duint threadId = getCellUserdata(getInitialSelection(), 1);
@@ -3,6 +3,10 @@
 
 #include "StdTable.h"
 #include <QMenu>
+#include <unordered_map>
+#include <vector>
+
+class QTimer;
 
 class ThreadView : public StdTable
 {
@@ -14,6 +18,7 @@ public:
 
 public slots:
     void updateThreadList();
+    void updateCycleHistorySlot();
     void doubleClickedSlot();
     void ExecCommand();
     void GoToThreadEntry();
@@ -22,8 +27,12 @@ public slots:
 
 private:
     QAction* makeCommandAction(QAction* action, const QString & command);
+    void fetchCycleHistory();
     duint mCurrentThreadId;
     MenuBuilder* mMenuBuilder;
+    QTimer* mCycleTimer;
+    std::unordered_map<duint, std::vector<unsigned long long>> mCycleHistory;
+    unsigned long long mCycleHistoryMax = 0;
 };
 
 #endif // THREADVIEW_H
@@ -3,6 +3,7 @@
 #include "StringUtil.h"
 #include "MiscUtil.h"
 #include "MenuBuilder.h"
+#include <QScrollBar>
 
 XrefBrowseDialog::XrefBrowseDialog(QWidget* parent) :
     QDialog(parent),
@@ -15,6 +16,7 @@ XrefBrowseDialog::XrefBrowseDialog(QWidget* parent) :
     mXrefInfo.refcount = 0;
     ui->listWidget->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(Bridge::getBridge(), SIGNAL(dbgStateChanged(DBGSTATE)), this, SLOT(onDebuggerClose(DBGSTATE)));
+    connect(ui->listWidget->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(fillVisibleRowsSlot()));
 
     setupContextMenu();
 }
@@ -68,20 +70,53 @@ void XrefBrowseDialog::setup(duint address, GotoFunction gotoFunction)
             mXrefInfo.references[i] = data[i];
 
         data.clear();
-        char disasm[GUI_MAX_DISASSEMBLY_SIZE] = "";
         setWindowTitle(QString(tr("xrefs at <%1>")).arg(GetFunctionSymbol(address)));
+        // Populate with address placeholders only; disassembling 50k
+        // referencing instructions up front takes seconds, so the text is
+        // decoded lazily for the rows that actually become visible
+        QStringList placeholders;
+        placeholders.reserve(int(mXrefInfo.refcount));
         for(duint i = 0; i < mXrefInfo.refcount; i++)
-        {
-            if(GuiGetDisassembly(mXrefInfo.references[i].addr, disasm))
-                ui->listWidget->addItem(disasm);
-            else
-                ui->listWidget->addItem("???");
-        }
+            placeholders.append(ToPtrString(mXrefInfo.references[i].addr));
+        ui->listWidget->addItems(placeholders);
+        mDisasmFilled.assign(size_t(mXrefInfo.refcount), false);
         ui->listWidget->setCurrentRow(0);
+        fillVisibleRows();
     }
     ui->listWidget->setFocus();
 }
 
+void XrefBrowseDialog::fillVisibleRows()
+{
+    auto count = ui->listWidget->count();
+    if(!count)
+        return;
+    auto first = ui->listWidget->indexAt(QPoint(4, 4)).row();
+    auto last = ui->listWidget->indexAt(QPoint(4, ui->listWidget->viewport()->height() - 4)).row();
+    if(first < 0)
+        first = 0;
+    if(last < 0 || last >= count)
+        last = count - 1;
+    //decode one extra screenful below so small scroll steps hit filled rows
+    last = qMin(last + (last - first) + 1, count - 1);
+    char disasm[GUI_MAX_DISASSEMBLY_SIZE] = "";
+    for(auto i = first; i <= last; i++)
+    {
+        if(mDisasmFilled[i])
+            continue;
+        mDisasmFilled[i] = true;
+        if(GuiGetDisassembly(mXrefInfo.references[i].addr, disasm))
+            ui->listWidget->item(i)->setText(disasm);
+        else
+            ui->listWidget->item(i)->setText("???");
+    }
+}
+
+void XrefBrowseDialog::fillVisibleRowsSlot()
+{
+    fillVisibleRows();
+}
+
 void XrefBrowseDialog::setupContextMenu()
 {
     mMenu = new MenuBuilder(this);
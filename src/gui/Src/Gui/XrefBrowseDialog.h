@@ -5,6 +5,7 @@
 #include "ActionHelpers.h"
 #include <QDialog>
 #include <QListWidgetItem>
+#include <vector>
 
 namespace Ui
 {
@@ -30,6 +31,7 @@ private slots:
     void on_listWidget_customContextMenuRequested(const QPoint & pos);
 
     void onDebuggerClose(DBGSTATE state);
+    void fillVisibleRowsSlot();
     void memoryAccessSingleshootSlot();
     void memoryAccessRestoreSlot();
     void memoryWriteSingleshootSlot();
@@ -54,9 +56,11 @@ private:
 
     void changeAddress(duint address);
     void setupContextMenu();
+    void fillVisibleRows();
     QString GetFunctionSymbol(duint addr);
 
     XREF_INFO mXrefInfo;
+    std::vector<bool> mDisasmFilled; //rows already holding disassembly text instead of the address placeholder
     duint mAddress;
     int mPrevSelectionSize;
     MenuBuilder* mMenu;
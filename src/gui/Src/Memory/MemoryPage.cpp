@@ -1,23 +1,242 @@
 #include "MemoryPage.h"
+#include "Bridge.h"
+#include <unordered_map>
+
+// Process-wide store of fetched 4KB pages shared by every MemoryPage
+// instance (dump tabs, stack, hex dialogs). The per-instance prefetchers
+// consult it before going through the bridge, so N views of the same
+// region cost one fetch per page instead of N. All instances receive the
+// same invalidation signals and each clears the store; the repeated
+// clears are harmless.
+namespace
+{
+struct SharedPageStore
+{
+    std::mutex mutex;
+    std::unordered_map<duint, std::vector<unsigned char>> pages;
+};
+
+SharedPageStore & sharedPages()
+{
+    static SharedPageStore store;
+    return store;
+}
+} //namespace
 
 MemoryPage::MemoryPage(duint parBase, duint parSize, QObject* parent) : QObject(parent), mBase(0), mSize(0)
 {
     Q_UNUSED(parBase);
     Q_UNUSED(parSize);
+    mCacheBase = 0;
+    mPrefetchBase = 0;
+    mPrefetchRequested = false;
+    mStopPrefetch = false;
+    mPrefetchThread = std::thread([this]()
+    {
+        prefetchLoop();
+    });
+    connect(Bridge::getBridge(), SIGNAL(dbgStateChanged(DBGSTATE)), this, SLOT(invalidateCacheSlot()));
+    connect(Bridge::getBridge(), SIGNAL(updateDump()), this, SLOT(invalidateCacheSlot()));
+    connect(Bridge::getBridge(), SIGNAL(updateDisassembly()), this, SLOT(invalidateCacheSlot()));
+    connect(Bridge::getBridge(), SIGNAL(updatePatches()), this, SLOT(invalidateCacheSlot()));
+}
+
+MemoryPage::~MemoryPage()
+{
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        mStopPrefetch = true;
+    }
+    mCacheCv.notify_one();
+    mPrefetchThread.join();
 }
 
 bool MemoryPage::read(void* parDest, dsint parRVA, duint parSize) const
 {
-    return DbgMemRead(mBase + parRVA, reinterpret_cast<unsigned char*>(parDest), parSize);
+    duint wVa = mBase + parRVA;
+    bool wNearEdge = false;
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        if(!mCacheData.empty() && wVa >= mCacheBase && parSize <= mCacheData.size() && wVa - mCacheBase <= mCacheData.size() - parSize)
+        {
+            memcpy(parDest, mCacheData.data() + (wVa - mCacheBase), parSize);
+            // Re-center the window when the access gets close to its edge so
+            // the next scroll tick stays inside it
+            wNearEdge = wVa - mCacheBase < PrefetchWindowSize / 4 || (mCacheBase + mCacheData.size()) - (wVa + parSize) < PrefetchWindowSize / 4;
+            if(!wNearEdge)
+                return true;
+        }
+    }
+    if(wNearEdge)
+    {
+        requestPrefetch(wVa);
+        return true;
+    }
+    // Cache miss: read directly and prefetch the surrounding window so the
+    // following repaints are served locally
+    bool ret = DbgMemRead(wVa, reinterpret_cast<unsigned char*>(parDest), parSize);
+    if(ret)
+        requestPrefetch(wVa);
+    return ret;
 }
 
 bool MemoryPage::write(const void* parDest, dsint parRVA, duint parSize)
 {
     bool ret = DbgFunctions()->MemPatch(mBase + parRVA, reinterpret_cast<const unsigned char*>(parDest), parSize);
+    {
+        auto & store = sharedPages();
+        std::lock_guard<std::mutex> storeLock(store.mutex);
+        store.pages.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        mCacheData.clear();
+    }
     GuiUpdatePatches();
     return ret;
 }
 
+void MemoryPage::requestPrefetch(duint wVa) const
+{
+    {
+        std::lock_guard<std::mutex> lock(mCacheMutex);
+        duint wBase = wVa > PrefetchWindowSize / 2 ? wVa - PrefetchWindowSize / 2 : 0;
+        if(wBase < mBase)
+            wBase = mBase;
+        if(mPrefetchRequested && mPrefetchBase == wBase)
+            return;
+        mPrefetchBase = wBase;
+        mPrefetchRequested = true;
+    }
+    mCacheCv.notify_one();
+}
+
+void MemoryPage::prefetchLoop()
+{
+    std::unique_lock<std::mutex> lock(mCacheMutex);
+    while(true)
+    {
+        mCacheCv.wait(lock, [this]()
+        {
+            return mStopPrefetch || mPrefetchRequested;
+        });
+        if(mStopPrefetch)
+            return;
+        mPrefetchRequested = false;
+        duint wBase = mPrefetchBase;
+        duint wRegionEnd = mBase + mSize;
+        if(wBase >= wRegionEnd)
+            continue; //attributes changed since the request
+        duint wSize = PrefetchWindowSize;
+        if(wSize > wRegionEnd - wBase)
+            wSize = wRegionEnd - wBase;
+        std::vector<unsigned char> wData(wSize);
+        lock.unlock();
+        // Split the window into page-sized chunks, serve what the shared
+        // store already has and fetch only the missing chunks in a single
+        // bridge call, so a partially unreadable window still caches its
+        // readable start
+        struct Chunk
+        {
+            duint addr;
+            duint size;
+            unsigned char* dest;
+            bool cached;
+            bool success;
+        };
+        std::vector<Chunk> wChunks;
+        duint wOffset = 0;
+        while(wOffset < wSize)
+        {
+            duint wChunkSize = 0x1000 - ((wBase + wOffset) & (0x1000 - 1));
+            if(wChunkSize > wSize - wOffset)
+                wChunkSize = wSize - wOffset;
+            Chunk wChunk;
+            wChunk.addr = wBase + wOffset;
+            wChunk.size = wChunkSize;
+            wChunk.dest = wData.data() + wOffset;
+            wChunk.cached = false;
+            wChunk.success = false;
+            wChunks.push_back(wChunk);
+            wOffset += wChunkSize;
+        }
+        auto & wStore = sharedPages();
+        {
+            std::lock_guard<std::mutex> storeLock(wStore.mutex);
+            for(auto & wChunk : wChunks)
+            {
+                if(wChunk.size != 0x1000)
+                    continue; //only whole pages are shared
+                auto found = wStore.pages.find(wChunk.addr);
+                if(found != wStore.pages.end())
+                {
+                    memcpy(wChunk.dest, found->second.data(), wChunk.size);
+                    wChunk.cached = wChunk.success = true;
+                }
+            }
+        }
+        std::vector<MEMREADRANGE> wRanges;
+        for(auto & wChunk : wChunks)
+        {
+            if(wChunk.cached)
+                continue;
+            MEMREADRANGE wRange;
+            wRange.addr = wChunk.addr;
+            wRange.dest = wChunk.dest;
+            wRange.size = wChunk.size;
+            wRange.success = false;
+            wRanges.push_back(wRange);
+        }
+        if(!wRanges.empty())
+            DbgMemReadScatter(wRanges.data(), wRanges.size());
+        {
+            std::lock_guard<std::mutex> storeLock(wStore.mutex);
+            size_t wRangeIdx = 0;
+            for(auto & wChunk : wChunks)
+            {
+                if(wChunk.cached)
+                    continue;
+                wChunk.success = wRanges[wRangeIdx++].success;
+                if(wChunk.success && wChunk.size == 0x1000)
+                {
+                    // Crude memory bound (16MB), usually cleared much earlier
+                    // by the per-debug-event invalidation
+                    if(wStore.pages.size() >= 4096)
+                        wStore.pages.clear();
+                    wStore.pages[wChunk.addr] = std::vector<unsigned char>(wChunk.dest, wChunk.dest + wChunk.size);
+                }
+            }
+        }
+        duint wValid = 0;
+        for(auto & wChunk : wChunks)
+        {
+            if(!wChunk.success)
+                break;
+            wValid += wChunk.size;
+        }
+        lock.lock();
+        // Only install the window if the region didn't change while reading
+        if(wValid && !mStopPrefetch && wBase >= mBase && wValid <= mSize && wBase - mBase <= mSize - wValid)
+        {
+            wData.resize(wValid);
+            mCacheBase = wBase;
+            mCacheData = std::move(wData);
+        }
+    }
+}
+
+void MemoryPage::invalidateCacheSlot()
+{
+    {
+        auto & store = sharedPages();
+        std::lock_guard<std::mutex> storeLock(store.mutex);
+        store.pages.clear();
+    }
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    mCacheData.clear();
+    mPrefetchRequested = false;
+}
+
 duint MemoryPage::getSize() const
 {
     return mSize;
@@ -35,8 +254,10 @@ duint MemoryPage::va(dsint rva) const
 
 void MemoryPage::setAttributes(duint base, duint size)
 {
+    std::lock_guard<std::mutex> lock(mCacheMutex);
     mBase = base;
     mSize = size;
+    mCacheData.clear();
 }
 
 bool MemoryPage::inRange(duint va) const
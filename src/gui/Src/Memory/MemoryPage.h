@@ -2,6 +2,10 @@
 #define MEMORYPAGE_H
 
 #include <QObject>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "Imports.h"
 
 class MemoryPage : public QObject
@@ -9,6 +13,7 @@ class MemoryPage : public QObject
     Q_OBJECT
 public:
     explicit MemoryPage(duint parBase, duint parSize, QObject* parent = 0);
+    ~MemoryPage() override;
 
     bool read(void* parDest, dsint parRVA, duint parSize) const;
     bool write(const void* parDest, dsint parRVA, duint parSize);
@@ -18,9 +23,31 @@ public:
     void setAttributes(duint base, duint size);
     bool inRange(duint va) const;
 
+private slots:
+    void invalidateCacheSlot();
+
 private:
     duint mBase;
     duint mSize;
+
+    // Readahead cache: the dump and disassembly views call read() for every
+    // repaint and each call is a synchronous bridge round trip into the
+    // debuggee memory path. A background thread prefetches a window around
+    // the last accessed address so repaints are served from a local buffer;
+    // debugger events and writes invalidate it.
+    void requestPrefetch(duint va) const;
+    void prefetchLoop();
+
+    static const duint PrefetchWindowSize = 0x8000;
+
+    mutable std::mutex mCacheMutex;
+    mutable std::condition_variable mCacheCv;
+    mutable std::vector<unsigned char> mCacheData;
+    mutable duint mCacheBase;
+    mutable duint mPrefetchBase;
+    mutable bool mPrefetchRequested;
+    bool mStopPrefetch;
+    std::thread mPrefetchThread;
 };
 
 #endif // MEMORYPAGE_H
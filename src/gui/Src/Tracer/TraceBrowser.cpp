@@ -1,5 +1,6 @@
 #include "TraceBrowser.h"
 #include "TraceFileReader.h"
+#include "TraceFileMemoryIndex.h"
 #include "TraceFileSearch.h"
 #include "RichTextPainter.h"
 #include "main.h"
@@ -12,10 +13,12 @@
 #include "BreakpointMenu.h"
 #include "MRUList.h"
 #include <QFileDialog>
+#include <QTimer>
 
 TraceBrowser::TraceBrowser(QWidget* parent) : AbstractTableView(parent)
 {
     mTraceFile = nullptr;
+    mMemoryIndex = new TraceFileMemoryIndex(this);
     addColumnAt(getCharWidth() * 2 * 2 + 8, "", false); //index
     addColumnAt(getCharWidth() * 2 * sizeof(dsint) + 8, "", false); //address
     addColumnAt(getCharWidth() * 2 * 12 + 8, "", false); //bytes
@@ -40,6 +43,11 @@ TraceBrowser::TraceBrowser(QWidget* parent) : AbstractTableView(parent)
     mPermanentHighlightingMode = false;
     mShowMnemonicBrief = false;
 
+    mPlaybackSpeed = 1;
+    mPlaybackTimer = new QTimer(this);
+    mPlaybackTimer->setInterval(40); //bounds playback repaints to 25 FPS however fast the cursor moves
+    connect(mPlaybackTimer, SIGNAL(timeout()), this, SLOT(playbackFrameSlot()));
+
     mMRUList = new MRUList(this, "Recent Trace Files");
     connect(mMRUList, SIGNAL(openFile(QString)), this, SLOT(openSlot(QString)));
     mMRUList->load();
@@ -55,6 +63,7 @@ TraceBrowser::TraceBrowser(QWidget* parent) : AbstractTableView(parent)
 
 TraceBrowser::~TraceBrowser()
 {
+    mMemoryIndex->invalidate();
     if(mTraceFile)
     {
         mTraceFile->Close();
@@ -255,6 +264,7 @@ QString TraceBrowser::paintContent(QPainter* painter, dsint rowBase, int rowOffs
     if(mTraceFile->isError())
     {
         GuiAddLogMessage(tr("An error occured when reading trace file.\r\n").toUtf8().constData());
+        mMemoryIndex->invalidate();
         mTraceFile->Close();
         delete mTraceFile;
         mTraceFile = nullptr;
@@ -888,6 +898,12 @@ void TraceBrowser::setupRightClickContextMenu()
     {
         return mHistory.historyHasNext();
     });
+    auto hasIndexedMemoryAccess = [this](QMenu*)
+    {
+        return mMemoryIndex->isReady() && mTraceFile != nullptr && mTraceFile->Progress() == 100 && mTraceFile->MemoryAccessCount(getInitialSelection()) > 0;
+    };
+    gotoMenu->addAction(makeAction(DIcon("previous.png"), tr("Previous access of memory"), SLOT(gotoPreviousMemoryAccessSlot())), hasIndexedMemoryAccess);
+    gotoMenu->addAction(makeAction(DIcon("next.png"), tr("Next access of memory"), SLOT(gotoNextMemoryAccessSlot())), hasIndexedMemoryAccess);
     mMenuBuilder->addMenu(makeMenu(DIcon("goto.png"), tr("Go to")), gotoMenu);
 
     MenuBuilder* searchMenu = new MenuBuilder(this, isValid);
@@ -895,6 +911,30 @@ void TraceBrowser::setupRightClickContextMenu()
     searchMenu->addAction(makeAction(DIcon("memory-map.png"), tr("Memory Reference"), SLOT(searchMemRefSlot())));
     mMenuBuilder->addMenu(makeMenu(DIcon("search.png"), tr("&Search")), searchMenu);
 
+    MenuBuilder* playbackMenu = new MenuBuilder(this, isValid);
+    QAction* togglePlayback = makeAction(tr("Start playback"), SLOT(togglePlaybackSlot()));
+    playbackMenu->addAction(togglePlayback, [this, togglePlayback](QMenu*)
+    {
+        if(mPlaybackTimer->isActive())
+            togglePlayback->setText(tr("Pause playback"));
+        else
+            togglePlayback->setText(tr("Start playback"));
+        return true;
+    });
+    playbackMenu->addSeparator();
+    for(duint speed : {1, 10, 100, 1000, 10000})
+    {
+        QAction* speedAction = makeAction(tr("%1 instructions per frame").arg(speed), SLOT(setPlaybackSpeedSlot()));
+        speedAction->setData((qulonglong)speed);
+        speedAction->setCheckable(true);
+        playbackMenu->addAction(speedAction, [this, speedAction, speed](QMenu*)
+        {
+            speedAction->setChecked(mPlaybackSpeed == speed);
+            return true;
+        });
+    }
+    mMenuBuilder->addMenu(makeMenu(tr("Playback")), playbackMenu);
+
     // The following code adds a menu to view the information about currently selected instruction. When info box is completed, remove me.
     MenuBuilder* infoMenu = new MenuBuilder(this, [this, isValid](QMenu * menu)
     {
@@ -1092,6 +1132,11 @@ void TraceBrowser::keyPressEvent(QKeyEvent* event)
     int key = event->key();
     auto curindex = getInitialSelection();
     auto visibleindex = curindex;
+    if(key == Qt::Key_Space && event->modifiers() == Qt::NoModifier && mTraceFile && mTraceFile->Progress() == 100)
+    {
+        togglePlaybackSlot();
+        return;
+    }
     if((key == Qt::Key_Up || key == Qt::Key_Down) && mTraceFile && mTraceFile->Progress() == 100)
     {
         if(key == Qt::Key_Up)
@@ -1268,6 +1313,7 @@ void TraceBrowser::openSlot(const QString & fileName)
 {
     if(mTraceFile != nullptr)
     {
+        mMemoryIndex->invalidate();
         mTraceFile->Close();
         delete mTraceFile;
     }
@@ -1310,6 +1356,7 @@ void TraceBrowser::closeFileSlot()
 {
     if(DbgValFromString("tr.runtraceenabled()") == 1)
         DbgCmdExec("StopRunTrace");
+    mMemoryIndex->invalidate();
     mTraceFile->Close();
     delete mTraceFile;
     mTraceFile = nullptr;
@@ -1323,6 +1370,7 @@ void TraceBrowser::closeDeleteSlot()
     {
         if(DbgValFromString("tr.runtraceenabled()") == 1)
             DbgCmdExecDirect("StopRunTrace");
+        mMemoryIndex->invalidate();
         mTraceFile->Delete();
         delete mTraceFile;
         mTraceFile = nullptr;
@@ -1350,6 +1398,7 @@ void TraceBrowser::parseFinishedSlot()
         setRowCount(mTraceFile->Length());
         mMRUList->addEntry(mFileName);
         mMRUList->save();
+        mMemoryIndex->buildAsync(mTraceFile);
     }
     setSingleSelection(0);
     makeVisible(0);
@@ -1392,6 +1441,41 @@ void TraceBrowser::gotoSlot()
     }
 }
 
+// Jump to the previous/next instruction accessing the memory cell the
+// selected instruction accesses, using the inverted memory-access index
+void TraceBrowser::gotoMemoryAccess(bool next)
+{
+    if(mTraceFile == nullptr || mTraceFile->Progress() < 100 || !mMemoryIndex->isReady())
+        return;
+    auto selection = getInitialSelection();
+    if(mTraceFile->MemoryAccessCount(selection) < 1)
+        return;
+    duint memAddr[MAX_MEMORY_OPERANDS];
+    duint memOldContent[MAX_MEMORY_OPERANDS];
+    duint memNewContent[MAX_MEMORY_OPERANDS];
+    bool isValid[MAX_MEMORY_OPERANDS];
+    mTraceFile->MemoryAccessInfo(selection, memAddr, memOldContent, memNewContent, isValid);
+    unsigned long long index;
+    if(next ? mMemoryIndex->nextAccess(memAddr[0], selection, index) : mMemoryIndex->previousAccess(memAddr[0], selection, index))
+    {
+        setSingleSelection(index);
+        makeVisible(index);
+        mHistory.addVaToHistory(index);
+        updateViewport();
+        emit selectionChanged(getInitialSelection());
+    }
+}
+
+void TraceBrowser::gotoPreviousMemoryAccessSlot()
+{
+    gotoMemoryAccess(false);
+}
+
+void TraceBrowser::gotoNextMemoryAccessSlot()
+{
+    gotoMemoryAccess(true);
+}
+
 void TraceBrowser::gotoNextSlot()
 {
     if(mHistory.historyHasNext())
@@ -1924,3 +2008,47 @@ void TraceBrowser::toggleAutoDisassemblyFollowSelectionSlot()
 {
     mAutoDisassemblyFollowSelection = !mAutoDisassemblyFollowSelection;
 }
+
+// Trace playback: the timer advances the cursor a configurable number of
+// instructions per frame, so scrubbing through a big trace repaints at most
+// once per tick however fast it moves. The register and info panes follow
+// through selectionChanged, which reads from the trace file itself, and the
+// reader's prefetch worker stages the upcoming pages off the GUI thread.
+void TraceBrowser::togglePlaybackSlot()
+{
+    if(mPlaybackTimer->isActive())
+    {
+        mPlaybackTimer->stop();
+        mHistory.addVaToHistory(getInitialSelection()); //one history entry for the whole run
+    }
+    else if(isFileOpened())
+        mPlaybackTimer->start();
+}
+
+void TraceBrowser::setPlaybackSpeedSlot()
+{
+    QAction* action = qobject_cast<QAction*>(sender());
+    if(action)
+        mPlaybackSpeed = action->data().toULongLong();
+}
+
+void TraceBrowser::playbackFrameSlot()
+{
+    if(!isFileOpened())
+    {
+        mPlaybackTimer->stop();
+        return;
+    }
+    auto index = getInitialSelection();
+    if(index + 1 >= mTraceFile->Length())
+    {
+        togglePlaybackSlot(); //reached the end of the trace
+        return;
+    }
+    index = std::min(index + mPlaybackSpeed, duint(mTraceFile->Length() - 1));
+    setSingleSelection(index);
+    makeVisible(index);
+    mTraceFile->prefetchNext(index, 4);
+    updateViewport();
+    emit selectionChanged(index);
+}
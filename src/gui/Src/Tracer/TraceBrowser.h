@@ -5,7 +5,9 @@
 #include "VaHistory.h"
 #include "QBeaEngine.h"
 
+class QTimer;
 class TraceFileReader;
+class TraceFileMemoryIndex;
 class BreakpointMenu;
 class MRUList;
 
@@ -44,6 +46,7 @@ private:
     };
     void setupRightClickContextMenu();
     void makeVisible(duint index);
+    void gotoMemoryAccess(bool next);
     QString getAddrText(dsint cur_addr, char label[MAX_LABEL_SIZE], bool getLabel);
     RichTextPainter::List getRichBytes(const Instruction_t & instr) const;
     void pushSelectionInto(bool copyBytes, QTextStream & stream, QTextStream* htmlStream = nullptr);
@@ -78,6 +81,9 @@ private:
     bool mShowMnemonicBrief;
 
     TraceFileReader* mTraceFile;
+    TraceFileMemoryIndex* mMemoryIndex;
+    QTimer* mPlaybackTimer; //frame clock of the playback mode
+    duint mPlaybackSpeed; //instructions the cursor advances per frame
     BreakpointMenu* mBreakpointMenu;
     MRUList* mMRUList;
     QString mFileName;
@@ -160,6 +166,8 @@ public slots:
     void gotoSlot();
     void gotoPreviousSlot();
     void gotoNextSlot();
+    void gotoPreviousMemoryAccessSlot();
+    void gotoNextMemoryAccessSlot();
     void followDisassemblySlot();
     void enableHighlightingModeSlot();
     void setLabelSlot();
@@ -184,6 +192,10 @@ public slots:
     void updateSlot();
 
     void toggleAutoDisassemblyFollowSelectionSlot();
+
+    void togglePlaybackSlot();
+    void setPlaybackSpeedSlot();
+    void playbackFrameSlot();
 };
 
 #endif //TRACEBROWSER_H
@@ -0,0 +1,201 @@
+#include "TraceFileMemoryIndex.h"
+#include "TraceFileReader.h"
+#include "TraceFileReaderInternal.h"
+#include <QFileInfo>
+#include <algorithm>
+
+TraceFileMemoryIndex::TraceFileMemoryIndex(QObject* parent) : QThread(parent)
+{
+    mFile = nullptr;
+    mLength = 0;
+    mReady = false;
+}
+
+TraceFileMemoryIndex::~TraceFileMemoryIndex()
+{
+    invalidate();
+}
+
+void TraceFileMemoryIndex::buildAsync(TraceFileReader* file)
+{
+    invalidate();
+    mFile = file;
+    start();
+}
+
+void TraceFileMemoryIndex::invalidate()
+{
+    if(isRunning())
+    {
+        requestInterruption();
+        wait();
+    }
+    mReady = false;
+    mEntries.clear();
+    mLength = 0;
+    mFile = nullptr;
+}
+
+bool TraceFileMemoryIndex::isReady() const
+{
+    return mReady.load();
+}
+
+// Return the entry range of instructions accessing the duint-sized cell at
+// address. The writer records one duint-aligned word per accessed operand, so
+// matching entries start within [address, address + sizeof(duint) - 1].
+std::pair<size_t, size_t> TraceFileMemoryIndex::cellRange(duint address) const
+{
+    const auto addressLess = [](const Entry & entry, unsigned long long value)
+    {
+        return entry.address < value;
+    };
+    const auto first = std::lower_bound(mEntries.begin(), mEntries.end(), (unsigned long long)address, addressLess);
+    const auto last = std::lower_bound(first, mEntries.end(), (unsigned long long)address + sizeof(duint), addressLess);
+    return std::make_pair(size_t(first - mEntries.begin()), size_t(last - mEntries.begin()));
+}
+
+// Return the index of the first instruction after "from" accessing the cell
+bool TraceFileMemoryIndex::nextAccess(duint address, unsigned long long from, unsigned long long & index) const
+{
+    if(!isReady())
+        return false;
+    const auto range = cellRange(address);
+    bool found = false;
+    for(size_t i = range.first; i < range.second; i++)
+    {
+        //entries are only index-sorted per address, the cell may span several addresses
+        if(mEntries[i].index > from && (!found || mEntries[i].index < index))
+        {
+            index = mEntries[i].index;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// Return the index of the last instruction before "from" accessing the cell
+bool TraceFileMemoryIndex::previousAccess(duint address, unsigned long long from, unsigned long long & index) const
+{
+    if(!isReady())
+        return false;
+    const auto range = cellRange(address);
+    bool found = false;
+    for(size_t i = range.first; i < range.second; i++)
+    {
+        if(mEntries[i].index < from && (!found || mEntries[i].index > index))
+        {
+            index = mEntries[i].index;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// Return all instruction indices accessing the cell, in index order
+std::vector<unsigned long long> TraceFileMemoryIndex::accesses(duint address) const
+{
+    std::vector<unsigned long long> result;
+    if(!isReady())
+        return result;
+    const auto range = cellRange(address);
+    result.reserve(range.second - range.first);
+    for(size_t i = range.first; i < range.second; i++)
+        result.push_back(mEntries[i].index);
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void TraceFileMemoryIndex::run()
+{
+    const QString sidecarName = mFile->FileName() + ".memidx";
+    if(loadSidecar(sidecarName))
+    {
+        mReady = true;
+        return;
+    }
+    //Walk every page through a private file handle, TraceFileReader and its
+    //page cache stay untouched
+    QFile traceFile(mFile->FileName());
+    if(!traceFile.open(QFile::ReadOnly))
+        return;
+    const unsigned long long traceLength = mFile->Length();
+    std::vector<Entry> entries;
+    for(size_t page = 0; page < mFile->PageCount(); page++)
+    {
+        if(isInterruptionRequested())
+            return;
+        unsigned long long indexBase, fileOffset, length;
+        mFile->PageInfo(page, indexBase, fileOffset, length);
+        TraceFilePage cursor(mFile, traceFile, fileOffset, length);
+        duint memAddr[MAX_MEMORY_OPERANDS];
+        duint memOldContent[MAX_MEMORY_OPERANDS];
+        duint memNewContent[MAX_MEMORY_OPERANDS];
+        bool isValid[MAX_MEMORY_OPERANDS];
+        for(unsigned long long i = 0; i < cursor.Length(); i++)
+        {
+            int memAccessCount = cursor.MemoryAccessCount(i);
+            if(memAccessCount > 0)
+            {
+                cursor.MemoryAccessInfo(i, memAddr, memOldContent, memNewContent, isValid);
+                for(int j = 0; j < memAccessCount; j++)
+                    entries.push_back(Entry { memAddr[j], indexBase + i });
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b)
+    {
+        return a.address < b.address || (a.address == b.address && a.index < b.index);
+    });
+    mEntries = std::move(entries);
+    mLength = traceLength;
+    mReady = true;
+    saveSidecar(sidecarName);
+}
+
+//Sidecar layout: 4byte:'MIDX', 4byte:version, 8byte:trace instruction count,
+//8byte:entry count, 16byte[]:address + instruction index
+bool TraceFileMemoryIndex::loadSidecar(const QString & fileName)
+{
+    QFile sidecar(fileName);
+    if(!sidecar.open(QFile::ReadOnly))
+        return false;
+    //A sidecar older than the trace belongs to a previous recording
+    if(QFileInfo(sidecar).lastModified() < QFileInfo(mFile->FileName()).lastModified())
+        return false;
+    unsigned int magic = 0;
+    unsigned int version = 0;
+    unsigned long long traceLength = 0;
+    unsigned long long count = 0;
+    bool ok = sidecar.read((char*)&magic, 4) == 4 && magic == MAKEFOURCC('M', 'I', 'D', 'X');
+    ok = ok && sidecar.read((char*)&version, 4) == 4 && version == 1;
+    ok = ok && sidecar.read((char*)&traceLength, 8) == 8 && traceLength == mFile->Length();
+    ok = ok && sidecar.read((char*)&count, 8) == 8;
+    ok = ok && sidecar.size() == qint64(8 + 16 + count * sizeof(Entry));
+    if(!ok)
+        return false;
+    std::vector<Entry> entries(size_t(count));
+    const qint64 bytes = qint64(count * sizeof(Entry));
+    if(count && sidecar.read((char*)entries.data(), bytes) != bytes)
+        return false;
+    mEntries = std::move(entries);
+    mLength = traceLength;
+    return true;
+}
+
+void TraceFileMemoryIndex::saveSidecar(const QString & fileName) const
+{
+    QFile sidecar(fileName);
+    if(!sidecar.open(QFile::WriteOnly | QFile::Truncate))
+        return; //the trace directory may be read-only, the index is rebuilt next time
+    const unsigned int magic = MAKEFOURCC('M', 'I', 'D', 'X');
+    const unsigned int version = 1;
+    const unsigned long long count = mEntries.size();
+    sidecar.write((const char*)&magic, 4);
+    sidecar.write((const char*)&version, 4);
+    sidecar.write((const char*)&mLength, 8);
+    sidecar.write((const char*)&count, 8);
+    if(count)
+        sidecar.write((const char*)mEntries.data(), qint64(count * sizeof(Entry)));
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <QThread>
+#include <atomic>
+#include <vector>
+#include "Bridge.h"
+
+class TraceFileReader;
+
+//Inverted memory-access index for run traces: address -> sorted instruction
+//indices. It is loaded from a ".memidx" sidecar next to the trace file, or
+//built once on a background thread after the trace opens and saved for the
+//next time, so "who touched this memory cell" queries behave like hardware
+//watchpoints over the recorded trace instead of requiring a linear scan.
+//The index covers the instructions present when the build started; records
+//appended by a live trace afterwards are not indexed.
+class TraceFileMemoryIndex : public QThread
+{
+    Q_OBJECT
+public:
+    explicit TraceFileMemoryIndex(QObject* parent = nullptr);
+    ~TraceFileMemoryIndex() override;
+
+    void buildAsync(TraceFileReader* file); //load the sidecar or build in the background
+    void invalidate(); //stop building and discard the index (trace closed)
+    bool isReady() const;
+
+    //Queries, only meaningful when isReady(). An instruction matches when it
+    //accesses the duint-sized cell starting at address, mirroring the memory
+    //reference search semantics.
+    bool nextAccess(duint address, unsigned long long from, unsigned long long & index) const;
+    bool previousAccess(duint address, unsigned long long from, unsigned long long & index) const;
+    std::vector<unsigned long long> accesses(duint address) const;
+
+protected:
+    void run() override;
+
+private:
+    struct Entry
+    {
+        unsigned long long address;
+        unsigned long long index;
+    };
+
+    bool loadSidecar(const QString & fileName);
+    void saveSidecar(const QString & fileName) const;
+    std::pair<size_t, size_t> cellRange(duint address) const; //entries accessing the cell at address
+
+    TraceFileReader* mFile;
+    std::vector<Entry> mEntries; //sorted by (address, index)
+    unsigned long long mLength;
+    std::atomic<bool> mReady;
+};
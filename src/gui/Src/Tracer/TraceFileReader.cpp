@@ -4,6 +4,7 @@
 #include <QThread>
 #include "MiscUtil.h"
 #include "StringUtil.h"
+#include <algorithm>
 
 TraceFileReader::TraceFileReader(QObject* parent) : QObject(parent)
 {
@@ -11,6 +12,7 @@ TraceFileReader::TraceFileReader(QObject* parent) : QObject(parent)
     progress = 0;
     error = true;
     parser = nullptr;
+    prefetcher = nullptr;
     lastAccessedPage = nullptr;
     lastAccessedIndexOffset = 0;
     hashValue = 0;
@@ -24,6 +26,7 @@ TraceFileReader::TraceFileReader(QObject* parent) : QObject(parent)
 
 TraceFileReader::~TraceFileReader()
 {
+    stopPrefetcher();
     delete mDisasm;
 }
 
@@ -62,10 +65,12 @@ void TraceFileReader::Close()
         parser->requestInterruption();
         parser->wait();
     }
+    stopPrefetcher();
     traceFile.close();
     progress.store(0);
     length = 0;
     fileIndex.clear();
+    instructionCache.clear();
     hashValue = 0;
     EXEPath.clear();
     error = false;
@@ -78,10 +83,12 @@ bool TraceFileReader::Delete()
         parser->requestInterruption();
         parser->wait();
     }
+    stopPrefetcher();
     bool value = traceFile.remove();
     progress.store(0);
     length = 0;
     fileIndex.clear();
+    instructionCache.clear();
     hashValue = 0;
     EXEPath.clear();
     error = false;
@@ -221,6 +228,112 @@ void TraceFileReader::MemoryAccessInfo(unsigned long long index, duint* address,
         return page->MemoryAccessInfo(index - base, address, oldMemory, newMemory, isValid);
 }
 
+// Return the count of on-disk pages
+size_t TraceFileReader::PageCount() const
+{
+    return fileIndex.size();
+}
+
+// Return the first index, file offset and instruction count of an on-disk page
+void TraceFileReader::PageInfo(size_t page, unsigned long long & indexBase, unsigned long long & fileOffset, unsigned long long & length) const
+{
+    const auto & entry = fileIndex.at(page);
+    indexBase = entry.first;
+    fileOffset = entry.second.first;
+    length = entry.second.second;
+}
+
+// Return the name of the trace file
+QString TraceFileReader::FileName() const
+{
+    return traceFile.fileName();
+}
+
+void TraceFilePrefetcher::run()
+{
+    auto that = (TraceFileReader*)parent();
+    //Own file handle, the GUI thread keeps using its own read cursor
+    QFile file(that->traceFile.fileName());
+    if(!file.open(QFile::ReadOnly))
+        return;
+    QMutexLocker locker(&lock);
+    while(!stop)
+    {
+        if(requests.empty())
+        {
+            wake.wait(&lock);
+            continue;
+        }
+        auto request = requests.back(); //the back holds the page closest to the cursor
+        requests.pop_back();
+        locker.unlock();
+        TraceFilePage page(that, file, request.fileOffset, request.length);
+        {
+            QMutexLocker stagingLocker(&that->prefetchLock);
+            if(that->prefetchedPages.size() < 64) //bound the staged memory
+                that->prefetchedPages.emplace(request.indexBase, std::move(page));
+        }
+        locker.relock();
+    }
+}
+
+void TraceFileReader::stopPrefetcher()
+{
+    if(!prefetcher)
+        return;
+    {
+        QMutexLocker locker(&prefetcher->lock);
+        prefetcher->stop = true;
+        prefetcher->requests.clear();
+        prefetcher->wake.wakeAll();
+    }
+    prefetcher->wait();
+    delete prefetcher;
+    prefetcher = nullptr;
+    prefetchedPages.clear();
+}
+
+void TraceFileReader::prefetchNext(unsigned long long index, int count)
+{
+    if(Progress() != 100 || fileIndex.empty())
+        return;
+    if(!prefetcher)
+    {
+        prefetcher = new TraceFilePrefetcher(this);
+        prefetcher->start();
+    }
+
+    //Collect the pages after the one containing index that are neither
+    //resident nor already staged
+    auto it = std::upper_bound(fileIndex.begin(), fileIndex.end(), index,
+                               [](unsigned long long value, const std::pair<unsigned long long, Range> & entry)
+    {
+        return value < entry.first;
+    });
+    std::vector<TraceFilePrefetcher::Request> wanted;
+    for(; it != fileIndex.end() && int(wanted.size()) < count; ++it)
+    {
+        if(pages.find(Range(it->first, it->first)) != pages.cend())
+            continue;
+        {
+            QMutexLocker locker(&prefetchLock);
+            if(prefetchedPages.count(it->first))
+                continue;
+        }
+        wanted.push_back({ it->first, it->second.first, it->second.second });
+    }
+    if(wanted.empty())
+        return;
+
+    //Replace any stale requests, pushing in reverse so the worker pops the
+    //nearest page first
+    QMutexLocker locker(&prefetcher->lock);
+    prefetcher->requests.clear();
+    for(auto request = wanted.rbegin(); request != wanted.rend(); ++request)
+        prefetcher->requests.push_back(*request);
+    prefetcher->wake.wakeAll();
+}
+
 // Used internally to get the page for the given index and read from disk if necessary
 TraceFilePage* TraceFileReader::getPage(unsigned long long index, unsigned long long* base)
 {
@@ -251,7 +364,9 @@ TraceFilePage* TraceFileReader::getPage(unsigned long long index, unsigned long
     else if(index >= Length()) //Out of bound
         return nullptr;
     // Remove an oldest page from system memory to make room for a new one.
-    if(pages.size() >= 2048) //TODO: trim resident pages based on system memory usage, instead of a hard limit.
+    // The delta-encoded register storage makes pages roughly an order of
+    // magnitude smaller than full REGDUMPs, so more of them can stay resident.
+    if(pages.size() >= 4096) //TODO: trim resident pages based on system memory usage, instead of a hard limit.
     {
         FILETIME pageOutTime = pages.begin()->second.lastAccessed;
         Range pageOutIndex = pages.begin()->first;
@@ -263,8 +378,48 @@ TraceFilePage* TraceFileReader::getPage(unsigned long long index, unsigned long
                 pageOutIndex = i.first;
             }
         }
+        //Keep the decoded instructions of the evicted page so scrolling back
+        //does not disassemble it again
+        const auto pageOut = pages.find(pageOutIndex);
+        if(pageOut != pages.end() && !pageOut->second.instructions.empty())
+        {
+            if(instructionCache.size() >= 128) //bound the prerender memory
+                instructionCache.erase(instructionCache.begin());
+            instructionCache[pageOut->first.first] = std::move(pageOut->second.instructions);
+        }
         pages.erase(pageOutIndex);
     }
+    //Adopt a page the playback prefetcher staged, skipping the disk read
+    {
+        QMutexLocker locker(&prefetchLock);
+        auto staged = prefetchedPages.upper_bound(index);
+        if(staged != prefetchedPages.begin())
+        {
+            --staged;
+            if(index >= staged->first && index < staged->first + staged->second.Length())
+            {
+                auto stagedBase = staged->first;
+                auto inserted = pages.insert(std::make_pair(Range(stagedBase, stagedBase + staged->second.Length() - 1), std::move(staged->second)));
+                prefetchedPages.erase(staged);
+                const auto newPage = inserted.first;
+                //Restore the instructions decoded before this page was evicted
+                const auto cached = instructionCache.find(stagedBase);
+                if(cached != instructionCache.end())
+                {
+                    if(cached->second.size() == newPage->second.Length())
+                        newPage->second.instructions = std::move(cached->second);
+                    instructionCache.erase(cached);
+                }
+                if(lastAccessedPage)
+                    GetSystemTimes(nullptr, nullptr, &lastAccessedPage->lastAccessed);
+                lastAccessedPage = &newPage->second;
+                lastAccessedIndexOffset = stagedBase;
+                GetSystemTimes(nullptr, nullptr, &lastAccessedPage->lastAccessed);
+                *base = lastAccessedIndexOffset;
+                return lastAccessedPage;
+            }
+        }
+    }
     //binary search fileIndex to get file offset, push a TraceFilePage into cache and return it.
     size_t start = 0;
     size_t end = fileIndex.size() - 1;
@@ -294,10 +449,18 @@ TraceFilePage* TraceFileReader::getPage(unsigned long long index, unsigned long
     // Read the requested page from disk and return
     if(fileOffset->second.second + fileOffset->first >= index && fileOffset->first <= index)
     {
-        pages.insert(std::make_pair(Range(fileOffset->first, fileOffset->first + fileOffset->second.second - 1), TraceFilePage(this, fileOffset->second.first, fileOffset->second.second)));
+        pages.insert(std::make_pair(Range(fileOffset->first, fileOffset->first + fileOffset->second.second - 1), TraceFilePage(this, traceFile, fileOffset->second.first, fileOffset->second.second)));
         const auto newPage = pages.find(Range(index, index));
         if(newPage != pages.cend())
         {
+            //Restore the instructions decoded before this page was evicted
+            const auto cached = instructionCache.find(newPage->first.first);
+            if(cached != instructionCache.end())
+            {
+                if(cached->second.size() == newPage->second.Length())
+                    newPage->second.instructions = std::move(cached->second);
+                instructionCache.erase(cached);
+            }
             if(lastAccessedPage)
                 GetSystemTimes(nullptr, nullptr, &lastAccessedPage->lastAccessed);
             lastAccessedPage = &newPage->second;
@@ -323,6 +486,7 @@ TraceFilePage* TraceFileReader::getPage(unsigned long long index, unsigned long
 void TraceFileReader::tokenizerUpdatedSlot()
 {
     mDisasm->UpdateConfig();
+    instructionCache.clear(); //cached token streams use the old configuration
     for(auto & i : pages)
         i.second.updateInstructions();
 }
@@ -363,8 +527,10 @@ void TraceFileParser::readFileHeader(TraceFileReader* that)
     if(ver == jsonRoot.constEnd())
         throw std::wstring(L"Version not supported");
     QJsonValue verVal = ver.value();
-    if(verVal.toInt(0) != 1)
+    const auto verInt = verVal.toInt(0);
+    if(verInt < 1 || verInt > 3) //ver 2: optional footer page index, ver 3: XOR register deltas
         throw std::wstring(L"Version not supported");
+    that->mVer = verInt;
     checkKey(jsonRoot, "arch", ArchValue("x86", "x64"));
     checkKey(jsonRoot, "compression", "");
     const auto hashAlgorithmObj = jsonRoot.find("hashAlgorithm");
@@ -400,7 +566,7 @@ void TraceFileParser::readFileHeader(TraceFileReader* that)
     }
 }
 
-static bool readBlock(QFile & traceFile)
+static bool readBlock(QFile & traceFile, int ver, bool & endOfRecords)
 {
     if(!traceFile.isReadable())
         throw std::wstring(L"File is not readable");
@@ -408,13 +574,33 @@ static bool readBlock(QFile & traceFile)
     unsigned char changedCountFlags[3]; //reg changed count, mem accessed count, flags
     if(traceFile.read((char*)&blockType, 1) != 1)
         throw std::wstring(L"Read block type failed");
+    if(blockType == 1) //footer index block, no instruction records after it
+    {
+        traceFile.seek(traceFile.size());
+        endOfRecords = true;
+        return false;
+    }
     if(blockType == 0)
     {
 
         if(traceFile.read((char*)&changedCountFlags, 3) != 3)
             throw std::wstring(L"Read flags failed");
-        //skipping: thread id, registers
-        if(traceFile.seek(traceFile.pos() + ((changedCountFlags[2] & 0x80) ? 4 : 0) + (changedCountFlags[2] & 0x0F) + changedCountFlags[0] * (1 + sizeof(duint))) == false)
+        //skipping: thread id, opcode, register positions
+        if(traceFile.seek(traceFile.pos() + ((changedCountFlags[2] & 0x80) ? 4 : 0) + (changedCountFlags[2] & 0x0F) + changedCountFlags[0]) == false)
+            throw std::wstring(L"Unspecified");
+        if(ver >= 3) //register values are variable-length XOR deltas, their total size is in the length nibbles
+        {
+            const int lengthBytes = (changedCountFlags[0] + 1) / 2;
+            QByteArray lengths = traceFile.read(lengthBytes);
+            if(lengths.length() < lengthBytes)
+                throw std::wstring(L"Read delta lengths failed");
+            unsigned int deltaBytes = 0;
+            for(int i = 0; i < changedCountFlags[0]; i++)
+                deltaBytes += ((unsigned char)lengths[i / 2] >> ((i % 2) * 4)) & 0xF;
+            if(traceFile.seek(traceFile.pos() + deltaBytes) == false)
+                throw std::wstring(L"Unspecified");
+        }
+        else if(traceFile.seek(traceFile.pos() + changedCountFlags[0] * sizeof(duint)) == false)
             throw std::wstring(L"Unspecified");
         QByteArray memflags;
         memflags = traceFile.read(changedCountFlags[1]);
@@ -436,6 +622,64 @@ static bool readBlock(QFile & traceFile)
     return false;
 }
 
+// Build fileIndex from the footer page index of a ver 2 trace so opening is
+// O(index size) instead of a walk over every record. Returns false (with the
+// read position restored) when there is no valid footer, e.g. the trace is
+// still being recorded.
+bool TraceFileParser::readFooterIndex(TraceFileReader* that)
+{
+    const qint64 headerEnd = that->traceFile.pos();
+    const qint64 fileSize = that->traceFile.size();
+    unsigned long long footerStart = 0;
+    unsigned int magic = 0;
+    unsigned char blockType = 0;
+    unsigned long long count = 0;
+    unsigned long long total = 0;
+    bool ok = fileSize >= headerEnd + 1 + 16 + 12; //empty footer and trailer
+    ok = ok && that->traceFile.seek(fileSize - 12);
+    ok = ok && that->traceFile.read((char*)&footerStart, 8) == 8;
+    ok = ok && that->traceFile.read((char*)&magic, 4) == 4;
+    ok = ok && magic == MAKEFOURCC('I', 'D', 'X', '1');
+    ok = ok && footerStart >= (unsigned long long)headerEnd && footerStart < (unsigned long long)(fileSize - 12);
+    ok = ok && that->traceFile.seek(footerStart);
+    ok = ok && that->traceFile.read((char*)&blockType, 1) == 1 && blockType == 1;
+    ok = ok && that->traceFile.read((char*)&count, 8) == 8;
+    ok = ok && that->traceFile.read((char*)&total, 8) == 8;
+    ok = ok && footerStart + 1 + 16 + count * 16 + 12 == (unsigned long long)fileSize;
+    if(ok)
+    {
+        unsigned long long lastIndex = 0;
+        unsigned long long lastOffset = 0;
+        that->fileIndex.reserve(size_t(count));
+        for(unsigned long long i = 0; i < count && ok; i++)
+        {
+            unsigned long long entry[2]; //instruction index, file offset
+            ok = that->traceFile.read((char*)entry, 16) == 16;
+            ok = ok && entry[0] < total && entry[1] >= (unsigned long long)headerEnd && entry[1] < footerStart;
+            ok = ok && (i == 0 ? entry[0] == 0 : entry[0] > lastIndex && entry[1] > lastOffset);
+            if(ok)
+            {
+                if(i != 0)
+                    that->fileIndex.back().second.second = entry[0] - lastIndex;
+                that->fileIndex.push_back(std::make_pair(entry[0], TraceFileReader::Range(entry[1], 0)));
+                lastIndex = entry[0];
+                lastOffset = entry[1];
+            }
+        }
+        ok = ok && (count > 0 || total == 0);
+        if(ok && count > 0)
+            that->fileIndex.back().second.second = total - lastIndex;
+    }
+    if(!ok)
+    {
+        that->fileIndex.clear();
+        that->traceFile.seek(headerEnd);
+        return false;
+    }
+    that->length = total;
+    return true;
+}
+
 void TraceFileParser::run()
 {
     TraceFileReader* that = dynamic_cast<TraceFileReader*>(parent());
@@ -453,30 +697,36 @@ void TraceFileParser::run()
         readFileHeader(that);
         //Update progress
         that->progress.store(that->traceFile.pos() * 100 / that->traceFile.size());
-        //Process file content
-        while(!that->traceFile.atEnd())
+        if(!readFooterIndex(that))
         {
-            quint64 blockStart = that->traceFile.pos();
-            bool isPageBoundary = readBlock(that->traceFile);
-            if(isPageBoundary)
+            //No footer index: walk every record to build the page index
+            while(!that->traceFile.atEnd())
             {
-                if(lastIndex != 0)
-                    that->fileIndex.back().second.second = index - (lastIndex - 1);
-                that->fileIndex.push_back(std::make_pair(index, TraceFileReader::Range(blockStart, 0)));
-                lastIndex = index + 1;
-                //Update progress
-                that->progress.store(that->traceFile.pos() * 100 / that->traceFile.size());
-                if(that->progress == 100)
-                    that->progress = 99;
-                if(this->isInterruptionRequested() && !that->traceFile.atEnd()) //Cancel loading
-                    throw std::wstring(L"Canceled");
+                quint64 blockStart = that->traceFile.pos();
+                bool endOfRecords = false;
+                bool isPageBoundary = readBlock(that->traceFile, that->mVer, endOfRecords);
+                if(endOfRecords)
+                    break;
+                if(isPageBoundary)
+                {
+                    if(lastIndex != 0)
+                        that->fileIndex.back().second.second = index - (lastIndex - 1);
+                    that->fileIndex.push_back(std::make_pair(index, TraceFileReader::Range(blockStart, 0)));
+                    lastIndex = index + 1;
+                    //Update progress
+                    that->progress.store(that->traceFile.pos() * 100 / that->traceFile.size());
+                    if(that->progress == 100)
+                        that->progress = 99;
+                    if(this->isInterruptionRequested() && !that->traceFile.atEnd()) //Cancel loading
+                        throw std::wstring(L"Canceled");
+                }
+                index++;
             }
-            index++;
+            if(index > 0)
+                that->fileIndex.back().second.second = index - (lastIndex - 1);
+            that->length = index;
         }
-        if(index > 0)
-            that->fileIndex.back().second.second = index - (lastIndex - 1);
         that->error = false;
-        that->length = index;
         that->progress = 100;
     }
     catch(const std::wstring & errReason)
@@ -520,7 +770,10 @@ void TraceFileReader::purgeLastPage()
         while(!traceFile.atEnd())
         {
             quint64 blockStart = traceFile.pos();
-            bool isPageBoundary = readBlock(traceFile);
+            bool endOfRecords = false;
+            bool isPageBoundary = readBlock(traceFile, mVer, endOfRecords);
+            if(endOfRecords)
+                break;
             if(isPageBoundary)
             {
                 if(lastIndex != 0)
@@ -543,16 +796,21 @@ void TraceFileReader::purgeLastPage()
 }
 
 //TraceFilePage
-TraceFilePage::TraceFilePage(TraceFileReader* parent, unsigned long long fileOffset, unsigned long long maxLength)
+//The file to read from is passed in explicitly: the page cache reads from
+//the reader's own file object, the parallel search reads through private
+//file objects on worker threads.
+TraceFilePage::TraceFilePage(TraceFileReader* parent, QFile & traceFile, unsigned long long fileOffset, unsigned long long maxLength)
 {
     DWORD lastThreadId = 0;
-    union
-    {
-        REGDUMP registers;
-        duint regwords[(FIELD_OFFSET(REGDUMP, lastError) + sizeof(DWORD)) / sizeof(duint)];
-    };
-    unsigned char changed[_countof(regwords)];
-    duint regContent[_countof(regwords)];
+    //Number of duint-sized fields in the register dump covered by the trace format
+    const size_t regwordCount = (FIELD_OFFSET(REGDUMP, lastError) + sizeof(DWORD)) / sizeof(duint);
+    unsigned char changed[(FIELD_OFFSET(REGDUMP, lastError) + sizeof(DWORD)) / sizeof(duint)];
+    duint regContent[_countof(changed)];
+    //ver 3: register values are XOR deltas against the last stored value, the
+    //running state starts at zero because pages open with a full dump record
+    const bool xorDelta = parent->mVer >= 3;
+    duint runningRegs[_countof(changed)];
+    memset(runningRegs, 0, sizeof(runningRegs));
     duint memAddress[MAX_MEMORY_OPERANDS];
     duint memOldContent[MAX_MEMORY_OPERANDS];
     duint memNewContent[MAX_MEMORY_OPERANDS];
@@ -560,29 +818,30 @@ TraceFilePage::TraceFilePage(TraceFileReader* parent, unsigned long long fileOff
     mParent = parent;
     length = 0;
     GetSystemTimes(nullptr, nullptr, &lastAccessed); //system user time, no GetTickCount64() for XP compatibility.
-    memset(&registers, 0, sizeof(registers));
+    memset(&mMaterialized, 0, sizeof(mMaterialized));
+    mMaterializedIndex = ~0ull;
     try
     {
-        if(mParent->traceFile.seek(fileOffset) == false)
+        if(traceFile.seek(fileOffset) == false)
             throw std::exception();
         //Process file content
-        while(!mParent->traceFile.atEnd() && length < maxLength)
+        while(!traceFile.atEnd() && length < maxLength)
         {
-            if(!mParent->traceFile.isReadable())
+            if(!traceFile.isReadable())
                 throw std::exception();
             unsigned char blockType;
             unsigned char changedCountFlags[3]; //reg changed count, mem accessed count, flags
-            mParent->traceFile.read((char*)&blockType, 1);
+            traceFile.read((char*)&blockType, 1);
             if(blockType == 0)
             {
-                if(mParent->traceFile.read((char*)&changedCountFlags, 3) != 3)
+                if(traceFile.read((char*)&changedCountFlags, 3) != 3)
                     throw std::exception();
                 if(changedCountFlags[2] & 0x80) //Thread Id
-                    mParent->traceFile.read((char*)&lastThreadId, 4);
+                    traceFile.read((char*)&lastThreadId, 4);
                 threadId.push_back(lastThreadId);
                 if((changedCountFlags[2] & 0x0F) > 0) //Opcode
                 {
-                    QByteArray opcode = mParent->traceFile.read(changedCountFlags[2] & 0x0F);
+                    QByteArray opcode = traceFile.read(changedCountFlags[2] & 0x0F);
                     if(opcode.isEmpty())
                         throw std::exception();
                     opcodeOffset.push_back(opcodes.size());
@@ -591,48 +850,84 @@ TraceFilePage::TraceFilePage(TraceFileReader* parent, unsigned long long fileOff
                 }
                 else
                     throw std::exception();
+                mRegChangeOffset.push_back(mRegChangePosition.size());
                 if(changedCountFlags[0] > 0) //registers
                 {
                     int lastPosition = -1;
-                    if(changedCountFlags[0] > _countof(regwords)) //Bad count?
+                    if(changedCountFlags[0] > regwordCount) //Bad count?
                         throw std::exception();
-                    if(mParent->traceFile.read((char*)changed, changedCountFlags[0]) != changedCountFlags[0])
+                    if(traceFile.read((char*)changed, changedCountFlags[0]) != changedCountFlags[0])
                         throw std::exception();
-                    if(mParent->traceFile.read((char*)regContent, changedCountFlags[0] * sizeof(duint)) != changedCountFlags[0] * sizeof(duint))
+                    if(xorDelta) //4bit lengths plus the significant bytes of each delta
+                    {
+                        const int lengthBytes = (changedCountFlags[0] + 1) / 2;
+                        QByteArray lengths = traceFile.read(lengthBytes);
+                        if(lengths.length() < lengthBytes)
+                            throw std::exception();
+                        int deltaBytes = 0;
+                        for(int i = 0; i < changedCountFlags[0]; i++)
+                        {
+                            int length = ((unsigned char)lengths[i / 2] >> ((i % 2) * 4)) & 0xF;
+                            if(length > int(sizeof(duint)))
+                                throw std::exception();
+                            deltaBytes += length;
+                        }
+                        QByteArray deltas = traceFile.read(deltaBytes);
+                        if(deltas.length() < deltaBytes)
+                            throw std::exception();
+                        int deltaOffset = 0;
+                        for(int i = 0; i < changedCountFlags[0]; i++)
+                        {
+                            int length = ((unsigned char)lengths[i / 2] >> ((i % 2) * 4)) & 0xF;
+                            duint delta = 0;
+                            memcpy(&delta, deltas.constData() + deltaOffset, length);
+                            deltaOffset += length;
+                            regContent[i] = delta; //resolved against the running state below
+                        }
+                    }
+                    else if(traceFile.read((char*)regContent, changedCountFlags[0] * sizeof(duint)) != changedCountFlags[0] * sizeof(duint))
                     {
                         throw std::exception();
                     }
                     for(int i = 0; i < changedCountFlags[0]; i++)
                     {
                         lastPosition = lastPosition + changed[i] + 1;
-                        if(lastPosition < _countof(regwords) && lastPosition >= 0)
-                            regwords[lastPosition] = regContent[i];
+                        if(lastPosition < int(regwordCount) && lastPosition >= 0)
+                        {
+                            if(xorDelta)
+                            {
+                                regContent[i] ^= runningRegs[lastPosition];
+                                runningRegs[lastPosition] = regContent[i];
+                            }
+                            //Store the change stream instead of a full REGDUMP per instruction
+                            mRegChangePosition.push_back((unsigned short)lastPosition);
+                            mRegChangeValue.push_back(regContent[i]);
+                        }
                         else //out of bounds?
                         {
                             throw std::exception();
                         }
                     }
-                    mRegisters.push_back(registers);
                 }
                 if(changedCountFlags[1] > 0) //memory
                 {
                     QByteArray memflags;
                     if(changedCountFlags[1] > _countof(memAddress)) //too many memory operands?
                         throw std::exception();
-                    memflags = mParent->traceFile.read(changedCountFlags[1]);
+                    memflags = traceFile.read(changedCountFlags[1]);
                     if(memflags.length() < changedCountFlags[1])
                         throw std::exception();
                     memoryOperandOffset.push_back(memOperandOffset);
                     memOperandOffset += changedCountFlags[1];
-                    if(mParent->traceFile.read((char*)memAddress, sizeof(duint) * changedCountFlags[1]) != sizeof(duint) * changedCountFlags[1])
+                    if(traceFile.read((char*)memAddress, sizeof(duint) * changedCountFlags[1]) != sizeof(duint) * changedCountFlags[1])
                         throw std::exception();
-                    if(mParent->traceFile.read((char*)memOldContent, sizeof(duint) * changedCountFlags[1]) != sizeof(duint) * changedCountFlags[1])
+                    if(traceFile.read((char*)memOldContent, sizeof(duint) * changedCountFlags[1]) != sizeof(duint) * changedCountFlags[1])
                         throw std::exception();
                     for(unsigned char i = 0; i < changedCountFlags[1]; i++)
                     {
                         if((memflags[i] & 1) == 0)
                         {
-                            if(mParent->traceFile.read((char*)&memNewContent[i], sizeof(duint)) != sizeof(duint))
+                            if(traceFile.read((char*)&memNewContent[i], sizeof(duint)) != sizeof(duint))
                                 throw std::exception();
                         }
                         else
@@ -666,9 +961,30 @@ unsigned long long TraceFilePage::Length() const
     return length;
 }
 
+//Materialize the register dump at the given index by replaying the change
+//streams. The last materialized state is cached so the common sequential
+//access only applies the deltas in between; seeking backwards restarts at
+//the top of the page, which is a full register dump record.
 const REGDUMP & TraceFilePage::Registers(unsigned long long index) const
 {
-    return mRegisters.at(index);
+    unsigned long long start;
+    if(mMaterializedIndex == ~0ull || index < mMaterializedIndex)
+    {
+        memset(&mMaterialized, 0, sizeof(mMaterialized));
+        start = 0;
+    }
+    else
+        start = mMaterializedIndex + 1;
+    auto regwords = (duint*)&mMaterialized;
+    for(auto i = start; i <= index; i++)
+    {
+        auto changesBegin = mRegChangeOffset.at(size_t(i));
+        auto changesEnd = i + 1 < mRegChangeOffset.size() ? mRegChangeOffset.at(size_t(i + 1)) : mRegChangePosition.size();
+        for(auto j = changesBegin; j < changesEnd; j++)
+            regwords[mRegChangePosition[j]] = mRegChangeValue[j];
+    }
+    mMaterializedIndex = index;
+    return mMaterialized;
 }
 
 void TraceFilePage::OpCode(unsigned long long index, unsigned char* buffer, int* opcodeSize) const
@@ -3,9 +3,11 @@
 
 #include "Bridge.h"
 #include <QFile>
+#include <QMutex>
 #include <atomic>
 
 class TraceFileParser;
+class TraceFilePrefetcher;
 class TraceFilePage;
 class QBeaEngine;
 struct Instruction_t;
@@ -37,6 +39,16 @@ public:
     duint HashValue() const;
     const QString & ExePath() const;
 
+    //On-disk page enumeration, used by the parallel trace search to give
+    //every worker its own read cursor instead of sharing the page cache
+    size_t PageCount() const;
+    void PageInfo(size_t page, unsigned long long & indexBase, unsigned long long & fileOffset, unsigned long long & length) const;
+    QString FileName() const;
+
+    //Stage the pages following index on a worker thread, so trace playback
+    //does not stall the GUI thread on disk reads
+    void prefetchNext(unsigned long long index, int count);
+
     void purgeLastPage();
 
 signals:
@@ -60,6 +72,7 @@ private:
 
     QFile traceFile;
     unsigned long long length;
+    int mVer = 1; //trace format version from the JSON header
     duint hashValue;
     QString EXEPath;
     std::vector<std::pair<unsigned long long, Range>> fileIndex; //index;<file offset;length>
@@ -69,9 +82,18 @@ private:
     unsigned long long lastAccessedIndexOffset;
     friend class TraceFileParser;
     friend class TraceFilePage;
+    friend class TraceFilePrefetcher;
 
     TraceFileParser* parser;
+    TraceFilePrefetcher* prefetcher;
+    QMutex prefetchLock;
+    std::map<unsigned long long, TraceFilePage> prefetchedPages; //staged pages, adopted in getPage
+    void stopPrefetcher();
     std::map<Range, TraceFilePage, RangeCompare> pages;
+    //Decoded instructions of evicted pages, keyed by page start index. The
+    //opcodes in a trace are immutable, so revisiting a page after eviction
+    //restores the token streams instead of disassembling everything again.
+    std::map<unsigned long long, std::vector<Instruction_t>> instructionCache;
     TraceFilePage* getPage(unsigned long long index, unsigned long long* base);
 
     QBeaEngine* mDisasm;
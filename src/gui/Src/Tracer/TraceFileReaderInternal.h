@@ -1,5 +1,6 @@
 #pragma once
 #include <QThread>
+#include <QWaitCondition>
 #include "TraceFileReader.h"
 #include "QBeaEngine.h"
 
@@ -9,13 +10,37 @@ class TraceFileParser : public QThread
     friend class TraceFileReader;
     TraceFileParser(TraceFileReader* parent) : QThread(parent) {}
     static void readFileHeader(TraceFileReader* that);
+    static bool readFooterIndex(TraceFileReader* that);
+    void run();
+};
+
+//Worker staging upcoming trace pages for the playback mode. It parses pages
+//from its own file handle and hands them to the reader through
+//prefetchedPages, so the GUI thread adopts them in getPage without a read.
+class TraceFilePrefetcher : public QThread
+{
+    Q_OBJECT
+    friend class TraceFileReader;
+    TraceFilePrefetcher(TraceFileReader* parent) : QThread(parent) {}
+
+    struct Request
+    {
+        unsigned long long indexBase;
+        unsigned long long fileOffset;
+        unsigned long long length;
+    };
+
+    QMutex lock;
+    QWaitCondition wake;
+    std::vector<Request> requests; //guarded by lock, popped from the back
+    bool stop = false; //guarded by lock
     void run();
 };
 
 class TraceFilePage
 {
 public:
-    TraceFilePage(TraceFileReader* parent, unsigned long long fileOffset, unsigned long long maxLength);
+    TraceFilePage(TraceFileReader* parent, QFile & traceFile, unsigned long long fileOffset, unsigned long long maxLength);
     unsigned long long Length() const;
     const REGDUMP & Registers(unsigned long long index) const;
     void OpCode(unsigned long long index, unsigned char* buffer, int* opcodeSize) const;
@@ -31,7 +56,16 @@ public:
 private:
     friend class TraceFileReader;
     TraceFileReader* mParent;
-    std::vector<REGDUMP> mRegisters;
+    //Columnar delta storage for the registers: per instruction a slice of
+    //(regword position, value) changes instead of a full REGDUMP, since
+    //consecutive dumps differ in only a few fields. Registers(index)
+    //materializes the state on demand and caches the last materialized
+    //index, so sequential access only replays the deltas in between.
+    std::vector<size_t> mRegChangeOffset; //per instruction, start offset into the change streams
+    std::vector<unsigned short> mRegChangePosition; //regword index of the change
+    std::vector<duint> mRegChangeValue;
+    mutable REGDUMP mMaterialized;
+    mutable unsigned long long mMaterializedIndex;
     QByteArray opcodes;
     std::vector<size_t> opcodeOffset;
     std::vector<unsigned char> opcodeSize;
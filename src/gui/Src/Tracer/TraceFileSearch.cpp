@@ -1,18 +1,109 @@
 #include "TraceFileReader.h"
+#include "TraceFileReaderInternal.h"
 #include "TraceFileSearch.h"
 #include "zydis_wrapper.h"
 #include "StringUtil.h"
 #include <QCoreApplication>
+#include <thread>
 
 static bool inRange(duint value, duint start, duint end)
 {
     return value >= start && value <= end;
 }
 
-int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end)
+struct TraceSearchHit
+{
+    unsigned long long index;
+    duint cip;
+    std::string disasm;
+};
+
+// Run the predicate over every instruction of the trace, partitioned by page
+// ranges across worker threads. Each worker opens its own handle to the trace
+// file so the readers do not evict each other from TraceFileReader's page
+// cache, and collects hits into a per-worker vector; because the partitioning
+// is contiguous, concatenating those vectors keeps the result in index order.
+// The predicate gets the page and the index of the instruction within it.
+template<typename Predicate>
+static std::vector<TraceSearchHit> TraceSearchParallel(TraceFileReader* file, const std::atomic<bool>* cancel, const Predicate & predicate)
+{
+    const size_t pageCount = file->PageCount();
+    std::vector<TraceSearchHit> result;
+    if(pageCount == 0)
+        return result;
+    size_t workerCount = std::thread::hardware_concurrency();
+    if(workerCount < 1)
+        workerCount = 1;
+    if(workerCount > pageCount)
+        workerCount = pageCount;
+    std::vector<std::vector<TraceSearchHit>> workerHits(workerCount);
+    std::atomic<size_t> pagesDone(0);
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for(size_t worker = 0; worker < workerCount; worker++)
+    {
+        const size_t firstPage = pageCount * worker / workerCount;
+        const size_t lastPage = pageCount * (worker + 1) / workerCount;
+        workers.emplace_back([ = , &workerHits, &pagesDone]()
+        {
+            QFile traceFile(file->FileName());
+            if(!traceFile.open(QFile::ReadOnly))
+                return;
+            Zydis cp;
+            auto & hits = workerHits[worker];
+            for(size_t page = firstPage; page < lastPage; page++)
+            {
+                if(cancel && cancel->load())
+                    break;
+                unsigned long long indexBase, fileOffset, length;
+                file->PageInfo(page, indexBase, fileOffset, length);
+                TraceFilePage cursor(file, traceFile, fileOffset, length);
+                for(unsigned long long i = 0; i < cursor.Length(); i++)
+                {
+                    if(predicate(cursor, i))
+                    {
+                        TraceSearchHit hit;
+                        hit.index = indexBase + i;
+                        hit.cip = cursor.Registers(i).regcontext.cip;
+                        unsigned char opcode[16];
+                        int opcodeSize = 0;
+                        cursor.OpCode(i, opcode, &opcodeSize);
+                        cp.Disassemble(hit.cip, opcode, opcodeSize);
+                        hit.disasm = cp.InstructionText(true);
+                        hits.push_back(std::move(hit));
+                    }
+                }
+                GuiReferenceSetProgress(int(++pagesDone * 100 / pageCount));
+            }
+        });
+    }
+    for(auto & worker : workers)
+        worker.join();
+    size_t total = 0;
+    for(const auto & hits : workerHits)
+        total += hits.size();
+    result.reserve(total);
+    for(auto & hits : workerHits)
+        for(auto & hit : hits)
+            result.push_back(std::move(hit));
+    return result;
+}
+
+// Fill the (already initialized) reference view with the search hits
+static void TraceSearchPopulateReferences(TraceFileReader* file, const std::vector<TraceSearchHit> & hits)
+{
+    GuiReferenceSetRowCount(int(hits.size()));
+    for(size_t row = 0; row < hits.size(); row++)
+    {
+        GuiReferenceSetCellContent(int(row), 0, ToPtrString(hits[row].cip).toUtf8().constData());
+        GuiReferenceSetCellContent(int(row), 1, file->getIndexText(hits[row].index).toUtf8().constData());
+        GuiReferenceSetCellContent(int(row), 2, hits[row].disasm.c_str());
+    }
+    GuiReferenceSetProgress(100);
+}
+
+int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end, const std::atomic<bool>* cancel)
 {
-    int count = 0;
-    Zydis cp;
     QString title;
     if(start == end)
         title = QCoreApplication::translate("TraceFileSearch", "Constant: %1").arg(ToPtrString(start));
@@ -24,10 +115,9 @@ int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end)
     GuiReferenceAddColumn(100, QCoreApplication::translate("TraceFileSearch", "Disassembly").toUtf8().constData());
     GuiReferenceSetRowCount(0);
 
-    REGISTERCONTEXT regcontext;
-    for(unsigned long long index = 0; index < file->Length(); index++)
+    const auto hits = TraceSearchParallel(file, cancel, [start, end](TraceFilePage & page, unsigned long long index)
     {
-        regcontext = file->Registers(index).regcontext;
+        const REGISTERCONTEXT & regcontext = page.Registers(index).regcontext;
         bool found = false;
         //Registers
 #define FINDREG(fieldName) found |= inRange(regcontext.##fieldName, start, end)
@@ -56,11 +146,11 @@ int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end)
         duint memOldContent[MAX_MEMORY_OPERANDS];
         duint memNewContent[MAX_MEMORY_OPERANDS];
         bool isValid[MAX_MEMORY_OPERANDS];
-        int memAccessCount = file->MemoryAccessCount(index);
+        int memAccessCount = page.MemoryAccessCount(index);
         if(memAccessCount > 0)
         {
-            file->MemoryAccessInfo(index, memAddr, memOldContent, memNewContent, isValid);
-            for(size_t i = 0; i < memAccessCount; i++)
+            page.MemoryAccessInfo(index, memAddr, memOldContent, memNewContent, isValid);
+            for(int i = 0; i < memAccessCount; i++)
             {
                 found |= inRange(memAddr[i], start, end);
                 found |= inRange(memOldContent[i], start, end);
@@ -68,35 +158,21 @@ int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end)
             }
         }
         //Constants: TO DO
-        //Populate reference view
-        if(found)
-        {
-            GuiReferenceSetRowCount(count + 1);
-            GuiReferenceSetCellContent(count, 0, ToPtrString(file->Registers(index).regcontext.cip).toUtf8().constData());
-            GuiReferenceSetCellContent(count, 1, file->getIndexText(index).toUtf8().constData());
-            unsigned char opcode[16];
-            int opcodeSize = 0;
-            file->OpCode(index, opcode, &opcodeSize);
-            cp.Disassemble(file->Registers(index).regcontext.cip, opcode, opcodeSize);
-            GuiReferenceSetCellContent(count, 2, cp.InstructionText(true).c_str());
-            //GuiReferenceSetCurrentTaskProgress; GuiReferenceSetProgress
-            count++;
-        }
-    }
-    return count;
+        return found;
+    });
+    TraceSearchPopulateReferences(file, hits);
+    return int(hits.size());
 }
 
-int TraceFileSearchMemReference(TraceFileReader* file, duint address)
+int TraceFileSearchMemReference(TraceFileReader* file, duint address, const std::atomic<bool>* cancel)
 {
-    int count = 0;
-    Zydis cp;
     GuiReferenceInitialize(QCoreApplication::translate("TraceFileSearch", "Reference").toUtf8().constData());
     GuiReferenceAddColumn(sizeof(duint) * 2, QCoreApplication::translate("TraceFileSearch", "Address").toUtf8().constData());
     GuiReferenceAddColumn(sizeof(duint) * 2, QCoreApplication::translate("TraceFileSearch", "Index").toUtf8().constData());
     GuiReferenceAddColumn(100, QCoreApplication::translate("TraceFileSearch", "Disassembly").toUtf8().constData());
     GuiReferenceSetRowCount(0);
 
-    for(unsigned long long index = 0; index < file->Length(); index++)
+    const auto hits = TraceSearchParallel(file, cancel, [address](TraceFilePage & page, unsigned long long index)
     {
         bool found = false;
         //Memory
@@ -104,30 +180,18 @@ int TraceFileSearchMemReference(TraceFileReader* file, duint address)
         duint memOldContent[MAX_MEMORY_OPERANDS];
         duint memNewContent[MAX_MEMORY_OPERANDS];
         bool isValid[MAX_MEMORY_OPERANDS];
-        int memAccessCount = file->MemoryAccessCount(index);
+        int memAccessCount = page.MemoryAccessCount(index);
         if(memAccessCount > 0)
         {
-            file->MemoryAccessInfo(index, memAddr, memOldContent, memNewContent, isValid);
-            for(size_t i = 0; i < memAccessCount; i++)
+            page.MemoryAccessInfo(index, memAddr, memOldContent, memNewContent, isValid);
+            for(int i = 0; i < memAccessCount; i++)
             {
                 found |= inRange(memAddr[i], address, address + sizeof(duint) - 1);
             }
             //Constants: TO DO
-            //Populate reference view
-            if(found)
-            {
-                GuiReferenceSetRowCount(count + 1);
-                GuiReferenceSetCellContent(count, 0, ToPtrString(file->Registers(index).regcontext.cip).toUtf8().constData());
-                GuiReferenceSetCellContent(count, 1, file->getIndexText(index).toUtf8().constData());
-                unsigned char opcode[16];
-                int opcodeSize = 0;
-                file->OpCode(index, opcode, &opcodeSize);
-                cp.Disassemble(file->Registers(index).regcontext.cip, opcode, opcodeSize);
-                GuiReferenceSetCellContent(count, 2, cp.InstructionText(true).c_str());
-                //GuiReferenceSetCurrentTaskProgress; GuiReferenceSetProgress
-                count++;
-            }
         }
-    }
-    return count;
+        return found;
+    });
+    TraceSearchPopulateReferences(file, hits);
+    return int(hits.size());
 }
@@ -1,8 +1,10 @@
 #ifndef TRACEFILESEARCH_H
 #define TRACEFILESEARCH_H
 #include "Bridge.h"
+#include <atomic>
 class TraceFileReader;
 
-int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end);
-int TraceFileSearchMemReference(TraceFileReader* file, duint address);
+//cancel (optional) is polled by the search workers, set it to true to stop early
+int TraceFileSearchConstantRange(TraceFileReader* file, duint start, duint end, const std::atomic<bool>* cancel = nullptr);
+int TraceFileSearchMemReference(TraceFileReader* file, duint address, const std::atomic<bool>* cancel = nullptr);
 #endif //TRACEFILESEARCH_H
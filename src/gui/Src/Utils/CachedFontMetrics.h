@@ -4,6 +4,8 @@
 #include <QObject>
 #include <QFont>
 #include <QFontMetrics>
+#include <QHash>
+#include <QStaticText>
 
 class CachedFontMetrics : public QObject
 {
@@ -54,8 +56,26 @@ public:
         return mHeight;
     }
 
+    //Pre-shaped glyph run for the given text, reused across repaints. The
+    //pen color is applied at draw time, so the text alone is the key.
+    const QStaticText & staticText(const QString & text)
+    {
+        auto found = mStaticTexts.find(text);
+        if(found == mStaticTexts.end())
+        {
+            if(mStaticTexts.size() >= 4096) //the visible working set is much smaller
+                mStaticTexts.clear();
+            QStaticText staticText(text);
+            staticText.setTextFormat(Qt::PlainText);
+            staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+            found = mStaticTexts.insert(text, staticText);
+        }
+        return found.value();
+    }
+
 private:
     QFontMetrics mFontMetrics;
+    QHash<QString, QStaticText> mStaticTexts;
     uchar mWidths[0x10000 - 0xE000 + 0xD800];
     int mHeight;
 };
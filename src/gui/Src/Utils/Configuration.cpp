@@ -25,6 +25,8 @@ inline static void addWindowPosConfig(QMap<QString, duint> & guiUint, const char
 Configuration::Configuration() : QObject(), noMoreMsgbox(false)
 {
     mPtr = this;
+    //connected first, so the cache is dropped before any view repaints
+    connect(this, SIGNAL(colorsUpdated()), this, SLOT(invalidateColorCacheSlot()));
     //setup default color map
     defaultColors.clear();
     defaultColors.insert("AbstractTableViewSeparatorColor", QColor("#808080"));
@@ -672,6 +674,7 @@ void Configuration::readColors()
     //read config
     for(auto it = Colors.begin(); it != Colors.end(); ++it)
         it.value() = colorFromConfig(it.key());
+    mColorCache.clear();
 }
 
 void Configuration::writeColors()
@@ -804,8 +807,15 @@ void Configuration::writeShortcuts()
 
 const QColor Configuration::getColor(const QString & id) const
 {
+    auto cached = mColorCache.constFind(id);
+    if(cached != mColorCache.constEnd())
+        return cached.value();
     if(Colors.contains(id))
-        return Colors.constFind(id).value();
+    {
+        const auto & color = Colors.constFind(id).value();
+        mColorCache.insert(id, color);
+        return color;
+    }
     if(noMoreMsgbox)
         return Qt::black;
     QMessageBox msg(QMessageBox::Warning, tr("NOT FOUND IN CONFIG!"), id, QMessageBox::Retry | QMessageBox::Cancel);
@@ -841,6 +851,11 @@ const bool Configuration::getBool(const QString & category, const QString & id)
     return false;
 }
 
+void Configuration::invalidateColorCacheSlot()
+{
+    mColorCache.clear();
+}
+
 void Configuration::setBool(const QString & category, const QString & id, const bool b)
 {
     if(Bools.contains(category))
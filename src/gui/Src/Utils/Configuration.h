@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QKeySequence>
 #include <QMap>
+#include <QHash>
 #include <QColor>
 #include <QFont>
 #include "Imports.h"
@@ -113,6 +114,9 @@ signals:
     void tokenizerConfigUpdated();
     void disableAutoCompleteUpdated();
 
+private slots:
+    void invalidateColorCacheSlot();
+
 private:
     QColor colorFromConfig(const QString & id);
     bool colorToConfig(const QString & id, const QColor color);
@@ -126,6 +130,11 @@ private:
     bool shortcutToConfig(const QString & id, const QKeySequence shortcut);
 
     mutable bool noMoreMsgbox;
+
+    // Flat O(1) lookup over Colors for the paint paths, which resolve colors
+    // by name per row. Filled lazily by getColor and cleared whenever the
+    // colors change (colorsUpdated is emitted after every mutation).
+    mutable QHash<QString, QColor> mColorCache;
 };
 
 #endif // CONFIGURATION_H
@@ -21,9 +21,13 @@ void EncodeMap::setMemoryRegion(duint addr)
     if(!mBase)
         return;
 
-    if(mBuffer)
-        DbgReleaseEncodeTypeBuffer(mBuffer);
+    //acquire the new buffer before releasing the previous one, so revisiting
+    //the same region keeps the expanded buffer alive instead of letting the
+    //debugger recompress it between paints
+    auto prevBuffer = mBuffer;
     mBuffer = (byte*)DbgGetEncodeTypeBuffer(addr, &mBufferSize);
+    if(prevBuffer)
+        DbgReleaseEncodeTypeBuffer(prevBuffer);
 }
 
 void EncodeMap::setDataType(duint va, ENCODETYPE type)
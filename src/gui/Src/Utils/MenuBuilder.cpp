@@ -32,6 +32,23 @@ QMenu* MenuBuilder::addMenu(QMenu* submenu, MenuBuilder* builder)
     return submenu;
 }
 
+/**
+ * @brief MenuBuilder::addLazyMenu Add a submenu whose contents are only built when
+ * the submenu is about to show, instead of on every right-click like addMenu. Use
+ * this for submenus that are expensive to populate (instruction decoding, label
+ * enumeration) and that should stay visible even when they end up empty.
+ */
+QMenu* MenuBuilder::addLazyMenu(QMenu* submenu, BuildCallback callback)
+{
+    connect(submenu, &QMenu::aboutToShow, [submenu, callback]()
+    {
+        submenu->clear();
+        callback(submenu);
+    });
+    addMenu(submenu);
+    return submenu;
+}
+
 /**
  * @brief MenuBuilder::getText Get the title of id-th element. This function is called by CustomizeMenuDialog to initialize the dialog.
  * @param id The index of the element in "_containers"
@@ -49,6 +49,8 @@ public:
 
     QMenu* addMenu(QMenu* submenu, MenuBuilder* builder);
 
+    QMenu* addLazyMenu(QMenu* submenu, BuildCallback callback);
+
     inline MenuBuilder* addBuilder(MenuBuilder* builder)
     {
         _containers.push_back(Container(builder));
@@ -2,6 +2,7 @@
 #include <QtWin>
 #include <QApplication>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QDir>
 #include "LineEditDialog.h"
 #include "ComboBoxDialog.h"
@@ -288,6 +289,65 @@ bool ExportCSV(dsint rows, dsint columns, std::vector<QString> headers, std::fun
         return false;
 }
 
+bool ExportTableText(dsint rows, std::function<QString(dsint)> getRowText)
+{
+    BrowseDialog browse(nullptr, QApplication::translate("ExportTableText", "Export table"), QApplication::translate("ExportTableText", "Enter the file name to export"), QApplication::translate("ExportTableText", "Text files (*.txt);;All files (*.*)"), QApplication::applicationDirPath() + QDir::separator() + "db", true);
+    browse.setWindowIcon(DIcon("database-export.png"));
+    if(browse.exec() != QDialog::Accepted)
+        return false;
+    FILE* file = _wfopen(browse.path.toStdWString().c_str(), L"wb");
+    if(file == NULL)
+    {
+        GuiAddLogMessage(QApplication::translate("ExportTableText", "Table export error\n").toUtf8().constData());
+        return false;
+    }
+    duint setting;
+    bool utf16 = BridgeSettingGetUint("Misc", "Utf16LogRedirect", &setting) && !!setting;
+    if(utf16)
+    {
+        unsigned short BOM = 0xfeff;
+        fwrite(&BOM, 2, 1, file);
+    }
+    //rows are written out one at a time so the full table never has to fit in memory
+    QProgressDialog progress(QApplication::translate("ExportTableText", "Exporting table..."), QApplication::translate("ExportTableText", "&Cancel"), 0, 100, nullptr);
+    progress.setWindowModality(Qt::ApplicationModal);
+    progress.setMinimumDuration(300);
+    bool ok = true;
+    for(dsint row = 0; row < rows && ok; row++)
+    {
+        if((row & 0xfff) == 0)
+        {
+            progress.setValue(int(row * 100ll / rows));
+            if(progress.wasCanceled())
+                break;
+        }
+        QString text = getRowText(row);
+        if(text.isNull()) //skipped row
+            continue;
+        if(utf16)
+        {
+            text += "\r\n";
+            ok = fwrite(text.utf16(), text.length(), 2, file) != 0;
+        }
+        else
+        {
+            text += "\n";
+            QByteArray utf8 = text.toUtf8();
+            ok = fwrite(utf8.constData(), utf8.size(), 1, file) != 0;
+        }
+    }
+    fclose(file);
+    if(!ok)
+    {
+        GuiAddLogMessage(QApplication::translate("ExportTableText", "Table export error\n").toUtf8().constData());
+        return false;
+    }
+    if(progress.wasCanceled())
+        return false;
+    GuiAddLogMessage(QApplication::translate("ExportTableText", "Saved table data at %1\n").arg(browse.path).toUtf8().constData());
+    return true;
+}
+
 static bool allowSeasons()
 {
     srand(GetTickCount());
@@ -19,6 +19,7 @@ void SimpleInfoBox(QWidget* parent, const QString & title, const QString & text)
 QString getSymbolicName(duint addr);
 QString getSymbolicNameStr(duint addr);
 bool ExportCSV(dsint rows, dsint columns, std::vector<QString> headers, std::function<QString(dsint, dsint)> getCellContent);
+bool ExportTableText(dsint rows, std::function<QString(dsint)> getRowText);
 bool isEaster();
 QString couldItBeSeasonal(QString icon);
 QIcon getFileIcon(QString file);
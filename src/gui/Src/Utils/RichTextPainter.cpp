@@ -41,7 +41,10 @@ void RichTextPainter::paintRichText(QPainter* painter, int x, int y, int w, int
             painter->setPen(pen);
             break;
         }
-        painter->drawText(QRect(x + xinc, y, w - xinc, h), Qt::TextBypassShaping, curRichText.text);
+        if(xinc + textWidth <= w) //fully visible, blit the cached glyph run
+            painter->drawStaticText(x + xinc, y, fontMetrics->staticText(curRichText.text));
+        else //partially visible, let drawText clip to the cell
+            painter->drawText(QRect(x + xinc, y, w - xinc, h), Qt::TextBypassShaping, curRichText.text);
         if(curRichText.underline && curRichText.underlineColor.alpha())
         {
             highlightPen.setColor(curRichText.underlineColor);
@@ -256,11 +256,10 @@ QString FILETIMEToDate(const FILETIME & date)
         return FILETIMEToTime(localdate);
 }
 
-bool GetCommentFormat(duint addr, QString & comment, bool* autoComment)
+bool FormatComment(const char* commentData, QString & comment, bool* autoComment)
 {
     comment.clear();
-    char commentData[MAX_COMMENT_SIZE] = "";
-    if(!DbgGetCommentAt(addr, commentData))
+    if(!commentData || !*commentData)
         return false;
     auto a = *commentData == '\1';
     if(autoComment)
@@ -277,3 +276,14 @@ bool GetCommentFormat(duint addr, QString & comment, bool* autoComment)
         comment = commentData + a;
     return true;
 }
+
+bool GetCommentFormat(duint addr, QString & comment, bool* autoComment)
+{
+    char commentData[MAX_COMMENT_SIZE] = "";
+    if(!DbgGetCommentAt(addr, commentData))
+    {
+        comment.clear();
+        return false;
+    }
+    return FormatComment(commentData, comment, autoComment);
+}
@@ -17,32 +17,38 @@ inline QString ToPtrString(duint Address)
     // QString::arg():
     // ((int32)0xFFFF0000) == 0xFFFFFFFFFFFF0000 with sign extension
     //
-
-    char temp[32];
-#ifdef _WIN64
-    sprintf_s(temp, "%016llX", Address);
-#else
-    sprintf_s(temp, "%08X", Address);
-#endif // _WIN64
-    return QString(temp);
+    // The digits are produced with a nibble lookup straight into UTF-16:
+    // every address cell in every table goes through here, and sprintf plus
+    // the 8 bit to QString conversion showed up in profiles.
+    //
+    static const char hexDigits[] = "0123456789ABCDEF";
+    ushort temp[sizeof(duint) * 2];
+    int shift = sizeof(duint) * 8;
+    for(size_t i = 0; i < _countof(temp); i++)
+    {
+        shift -= 4;
+        temp[i] = hexDigits[(Address >> shift) & 0xF];
+    }
+    return QString(reinterpret_cast<const QChar*>(temp), _countof(temp));
 }
 
 inline QString ToLongLongHexString(unsigned long long Value)
 {
-    char temp[32];
-    sprintf_s(temp, "%llX", Value);
-    return QString(temp);
+    static const char hexDigits[] = "0123456789ABCDEF";
+    ushort temp[sizeof(Value) * 2];
+    size_t i = _countof(temp);
+    do
+    {
+        temp[--i] = hexDigits[Value & 0xF];
+        Value >>= 4;
+    }
+    while(Value);
+    return QString(reinterpret_cast<const QChar*>(temp + i), int(_countof(temp) - i));
 }
 
 inline QString ToHexString(duint Value)
 {
-    char temp[32];
-#ifdef _WIN64
-    sprintf_s(temp, "%llX", Value);
-#else
-    sprintf_s(temp, "%X", Value);
-#endif // _WIN64
-    return QString(temp);
+    return ToLongLongHexString(Value);
 }
 
 inline QString ToDecString(dsint Value)
@@ -58,15 +64,32 @@ inline QString ToDecString(dsint Value)
 
 inline QString ToByteString(unsigned char Value)
 {
-    char temp[4];
-    sprintf_s(temp, "%02X", Value);
-    return QString(temp);
+    //Shared table of all 256 possible strings: QString is implicitly shared,
+    //so returning a copy is a reference count bump instead of a sprintf and a
+    //heap allocation per byte (HexDump formats thousands of these per repaint).
+    static const QString* table = []
+    {
+        static QString t[256];
+        for(int i = 0; i < 256; i++)
+        {
+            char temp[4];
+            sprintf_s(temp, "%02X", i);
+            t[i] = QString(temp);
+        }
+        return t;
+    }();
+    return table[Value];
 }
 
 inline QString ToWordString(unsigned short Value)
 {
-    char temp[8];
-    sprintf_s(temp, "%04X", Value);
+    static const char hexdigits[] = "0123456789ABCDEF";
+    char temp[5];
+    temp[0] = hexdigits[(Value >> 12) & 0xF];
+    temp[1] = hexdigits[(Value >> 8) & 0xF];
+    temp[2] = hexdigits[(Value >> 4) & 0xF];
+    temp[3] = hexdigits[Value & 0xF];
+    temp[4] = '\0';
     return QString(temp);
 }
 
@@ -133,6 +156,7 @@ inline QString FILETIMEToTime(const FILETIME & time)
 
 QString FILETIMEToDate(const FILETIME & date);
 
+bool FormatComment(const char* commentData, QString & comment, bool* autoComment = nullptr);
 bool GetCommentFormat(duint addr, QString & comment, bool* autoComment = nullptr);
 
 QString EscapeCh(QChar ch);
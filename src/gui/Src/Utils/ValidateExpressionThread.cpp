@@ -1,6 +1,6 @@
 #include "ValidateExpressionThread.h"
 
-ValidateExpressionThread::ValidateExpressionThread(QObject* parent) : QThread(parent), mExpressionChanged(false), mStopThread(false)
+ValidateExpressionThread::ValidateExpressionThread(QObject* parent) : QThread(parent), mExpressionChanged(false), mGeneration(0), mValidatingGeneration(0), mStopThread(false)
 {
     this->mOnExpressionChangedCallback = nullptr;
 }
@@ -18,11 +18,21 @@ void ValidateExpressionThread::stop()
 
 void ValidateExpressionThread::emitExpressionChanged(bool validExpression, bool validPointer, dsint value)
 {
+    mExpressionMutex.lock();
+    auto stale = mGeneration != mValidatingGeneration;
+    mExpressionMutex.unlock();
+    if(stale) //newer input arrived while validating, a fresh result will follow
+        return;
     emit expressionChanged(validExpression, validPointer, value);
 }
 
 void ValidateExpressionThread::emitInstructionChanged(dsint sizeDifference, QString error)
 {
+    mExpressionMutex.lock();
+    auto stale = mGeneration != mValidatingGeneration;
+    mExpressionMutex.unlock();
+    if(stale)
+        return;
     emit instructionChanged(sizeDifference, error);
 }
 
@@ -33,6 +43,7 @@ void ValidateExpressionThread::textChanged(QString text)
     {
         mExpressionChanged = true;
         mExpressionText = text;
+        mGeneration++;
     }
     mExpressionMutex.unlock();
 }
@@ -41,6 +52,7 @@ void ValidateExpressionThread::additionalStateChanged()
 {
     mExpressionMutex.lock();
     mExpressionChanged = true;
+    mGeneration++;
     mExpressionMutex.unlock();
 }
 
@@ -57,6 +69,7 @@ void ValidateExpressionThread::run()
         QString expression = mExpressionText;
         bool changed = mExpressionChanged;
         mExpressionChanged = false;
+        mValidatingGeneration = mGeneration;
         mExpressionMutex.unlock();
         if(changed && mOnExpressionChangedCallback != nullptr)
         {
@@ -31,6 +31,12 @@ private:
     QMutex mExpressionMutex;
     QString mExpressionText;
     bool mExpressionChanged;
+    //Every text/state change bumps the generation and the thread remembers
+    //which generation it is validating. A result is only emitted when its
+    //generation is still current, so a slow bridge call (dbg thread busy
+    //with analysis) can never publish a stale result over newer input.
+    unsigned int mGeneration;
+    unsigned int mValidatingGeneration;
     volatile bool mStopThread;
     EXPRESSIONCHANGEDCB mOnExpressionChangedCallback;
 
@@ -185,6 +185,7 @@ SOURCES += \
     Src/Utils/SymbolAutoCompleteModel.cpp \
     Src/Tracer/TraceBrowser.cpp \
     Src/Tracer/TraceFileReader.cpp \
+    Src/Tracer/TraceFileMemoryIndex.cpp \
     Src/Tracer/TraceFileSearch.cpp \
     Src/Gui/MultiItemsSelectWindow.cpp \
     Src/BasicView/AbstractStdTable.cpp \
@@ -311,6 +312,7 @@ HEADERS += \
     Src/Tracer/TraceBrowser.h \
     Src/Tracer/TraceFileReader.h \
     Src/Tracer/TraceFileReaderInternal.h \
+    Src/Tracer/TraceFileMemoryIndex.h \
     Src/Tracer/TraceFileSearch.h \
     Src/Gui/MultiItemsSelectWindow.h \
     Src/BasicView/AbstractStdTable.h \
@@ -383,6 +383,34 @@ static bool parseId(const wchar_t* str, unsigned long & result)
     return convertNumber(str, result, radix);
 }
 
+//Remember the probe result for recently launched targets in the launcher INI,
+//keyed by the full path and validated with the file size and last write time,
+//so relaunching the same binary skips reading the file entirely.
+static PeArch GetPeArchCached(const TCHAR* szPath, const TCHAR* szIniPath)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attrib;
+    if(!GetFileAttributesEx(szPath, GetFileExInfoStandard, &attrib))
+        return GetPeArch(szPath);
+
+    TCHAR szStamp[64] = TEXT("");
+    _stprintf_s(szStamp, TEXT("%08X%08X%08X%08X"), attrib.nFileSizeHigh, attrib.nFileSizeLow, attrib.ftLastWriteTime.dwHighDateTime, attrib.ftLastWriteTime.dwLowDateTime);
+
+    TCHAR szCached[64] = TEXT("");
+    if(GetPrivateProfileString(TEXT("ArchCache"), szPath, TEXT(""), szCached, _countof(szCached), szIniPath))
+    {
+        TCHAR* end = nullptr;
+        auto arch = _tcstoul(szCached, &end, 10);
+        if(end && *end == TEXT('@') && !_tcscmp(end + 1, szStamp) && arch <= (unsigned long)PeArch::DotnetAnyCpuPrefer32)
+            return PeArch(arch);
+    }
+
+    auto result = GetPeArch(szPath);
+    TCHAR szValue[80] = TEXT("");
+    _stprintf_s(szValue, TEXT("%u@%s"), (unsigned int)result, szStamp);
+    WritePrivateProfileString(TEXT("ArchCache"), szPath, szValue, szIniPath);
+    return result;
+}
+
 const wchar_t* SHELLEXT_EXE_KEY = L"exefile\\shell\\Debug with x64dbg\\Command";
 const wchar_t* SHELLEXT_ICON_EXE_KEY = L"exefile\\shell\\Debug with x64dbg";
 const wchar_t* SHELLEXT_DLL_KEY = L"dllfile\\shell\\Debug with x64dbg\\Command";
@@ -674,7 +702,7 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLi
         //MessageBoxW(0, GetCommandLineW(), L"GetCommandLineW", MB_SYSTEMMODAL);
         //MessageBoxW(0, szCurDir, L"GetCurrentDirectory", MB_SYSTEMMODAL);
 
-        switch(GetPeArch(szPath))
+        switch(GetPeArchCached(szPath, szIniPath))
         {
         case PeArch::Native86:
         case PeArch::Dotnet86:
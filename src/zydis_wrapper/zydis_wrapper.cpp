@@ -104,7 +104,8 @@ void Zydis::GlobalFinalize()
 }
 
 Zydis::Zydis()
-    : mSuccess(false),
+    : mFormatted(false),
+      mSuccess(false),
       mVisibleOpCount(0)
 {
     GlobalInitialize();
@@ -115,6 +116,12 @@ Zydis::~Zydis()
 {
 }
 
+Zydis & Zydis::ThreadLocal()
+{
+    static thread_local Zydis instance;
+    return instance;
+}
+
 bool Zydis::Disassemble(size_t addr, const unsigned char data[MAX_DISASM_BUFFER])
 {
     return Disassemble(addr, data, MAX_DISASM_BUFFER);
@@ -131,13 +138,10 @@ bool Zydis::Disassemble(size_t addr, const unsigned char* data, int size)
     if(!ZYDIS_SUCCESS(ZydisDecoderDecodeBuffer(&mDecoder, data, size, addr, &mInstr)))
         return false;
 
-    // Format it to human readable representation.
-    if(!ZYDIS_SUCCESS(ZydisFormatterFormatInstruction(
-                          &mFormatter,
-                          const_cast<ZydisDecodedInstruction*>(&mInstr),
-                          mInstrText,
-                          sizeof(mInstrText))))
-        return false;
+    // The human readable representation is formatted lazily in InstructionText().
+    // Bulk consumers (analysis passes, reference scans) never ask for it and the
+    // formatter is the most expensive part of a decode.
+    mFormatted = false;
 
     // Count explicit operands.
     mVisibleOpCount = 0;
@@ -181,6 +185,45 @@ bool Zydis::DisassembleSafe(size_t addr, const unsigned char* data, int size)
     return Disassemble(addr, dataSafe);
 }
 
+size_t Zydis::DisassembleRange(size_t addr, const unsigned char* data, size_t size, InstrInfo* info, size_t maxCount)
+{
+    if(!data || !info)
+        return 0;
+
+    size_t count = 0;
+    size_t offset = 0;
+    while(offset < size && count < maxCount)
+    {
+        auto & record = info[count];
+        record.address = addr + offset;
+
+        if(Disassemble(addr + offset, data + offset, int(min(size - offset, size_t(MAX_DISASM_BUFFER)))))
+        {
+            record.mnemonic = mInstr.mnemonic;
+            record.branchType = BranchTypeValue();
+            record.branchDestination = mVisibleOpCount > 0 ? BranchDestination() : 0;
+            record.length = mInstr.length;
+            record.visibleOpCount = mVisibleOpCount;
+            record.op0Type = mVisibleOpCount > 0 ? uint8_t(mInstr.operands[0].type) : uint8_t(ZYDIS_OPERAND_TYPE_UNUSED);
+            offset += mInstr.length;
+        }
+        else
+        {
+            // Record undecodable bytes so the caller can keep a single pass going
+            record.mnemonic = ZYDIS_MNEMONIC_INVALID;
+            record.branchType = 0;
+            record.branchDestination = 0;
+            record.length = 1;
+            record.visibleOpCount = 0;
+            record.op0Type = uint8_t(ZYDIS_OPERAND_TYPE_UNUSED);
+            offset++;
+        }
+
+        count++;
+    }
+    return count;
+}
+
 const ZydisDecodedInstruction* Zydis::GetInstr() const
 {
     if(!Success())
@@ -317,8 +360,12 @@ bool Zydis::IsBranchType(std::underlying_type_t<BranchType> bt) const
     if(!Success())
         return false;
 
+    return (bt & BranchTypeValue()) != 0;
+}
+
+std::underlying_type_t<Zydis::BranchType> Zydis::BranchTypeValue() const
+{
     std::underlying_type_t<BranchType> ref = 0;
-    const auto & op0 = mInstr.operands[0];
 
     switch(mInstr.mnemonic)
     {
@@ -393,7 +440,7 @@ bool Zydis::IsBranchType(std::underlying_type_t<BranchType> bt) const
         ;
     }
 
-    return (bt & ref) != 0;
+    return ref;
 }
 
 ZydisMnemonic Zydis::GetId() const
@@ -408,6 +455,17 @@ std::string Zydis::InstructionText(bool replaceRipRelative) const
     if(!Success())
         return "???";
 
+    if(!mFormatted)
+    {
+        if(!ZYDIS_SUCCESS(ZydisFormatterFormatInstruction(
+                              &mFormatter,
+                              const_cast<ZydisDecodedInstruction*>(&mInstr),
+                              mInstrText,
+                              sizeof(mInstrText))))
+            strcpy_s(mInstrText, "???");
+        mFormatted = true;
+    }
+
     std::string result = mInstrText;
 #ifdef _WIN64
     // TODO (ath): We can do that a whole lot sexier using formatter hooks
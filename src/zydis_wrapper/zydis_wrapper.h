@@ -15,6 +15,11 @@ public:
     Zydis();
     Zydis(const Zydis & zydis) = delete;
     ~Zydis();
+    // Pre-warmed decoder for the calling thread. Hot paths that decode one
+    // instruction per call should prefer this over a fresh instance, which
+    // clears the whole decode record on construction. The decoded state is
+    // only valid until the next ThreadLocal() decode on the same thread.
+    static Zydis & ThreadLocal();
     bool Disassemble(size_t addr, const unsigned char data[MAX_DISASM_BUFFER]);
     bool Disassemble(size_t addr, const unsigned char* data, int size);
     bool DisassembleSafe(size_t addr, const unsigned char* data, int size);
@@ -91,6 +96,22 @@ public:
 
     bool IsBranchType(std::underlying_type_t<BranchType> bt) const;
 
+    // Compact decode record produced by DisassembleRange. Holds what bulk
+    // consumers (analysis passes, reference scans) need without materializing
+    // the formatted text.
+    struct InstrInfo
+    {
+        size_t address;
+        size_t branchDestination; //absolute target for immediate branches, 0 otherwise
+        ZydisMnemonic mnemonic; //ZYDIS_MNEMONIC_INVALID for undecodable bytes
+        uint32_t branchType; //BranchType flags, 0 for non-branches
+        uint8_t length; //1 for undecodable bytes
+        uint8_t visibleOpCount;
+        uint8_t op0Type; //ZydisOperandType of the first operand
+    };
+
+    size_t DisassembleRange(size_t addr, const unsigned char* data, size_t size, InstrInfo* info, size_t maxCount);
+
     enum VectorElementType : uint8_t
     {
         VETDefault,
@@ -109,11 +130,14 @@ public:
     bool IsInt3() const { return IsBranchType(BTInt3); }
 
 private:
+    std::underlying_type_t<BranchType> BranchTypeValue() const;
+
     static ZydisDecoder mDecoder;
     static ZydisFormatter mFormatter;
     static bool mInitialized;
     ZydisDecodedInstruction mInstr;
-    char mInstrText[200];
+    mutable char mInstrText[200];
+    mutable bool mFormatted; //mInstrText is formatted lazily in InstructionText()
     bool mSuccess;
     uint8_t mVisibleOpCount;
 };